@@ -1162,6 +1162,16 @@ public static class bgfx
 		/// </summary>
 		DrawIndirectCount      = 0x0000000040000000,
 	
+		/// <summary>
+		/// Draw can be predicated on occlusion query result on GPU.
+		/// </summary>
+		ConditionalRender      = 0x0000000080000000,
+	
+		/// <summary>
+		/// Instance data described by vertex layout is supported.
+		/// </summary>
+		InstancingLayout       = 0x0000000100000000,
+	
 		/// <summary>
 		/// All texture compare modes are supported.
 		/// </summary>
@@ -2003,6 +2013,11 @@ public static class bgfx
 		/// </summary>
 		DepthDescending,
 	
+		/// <summary>
+		/// Default sort order, draws sharing program and blend are grouped by bindings.
+		/// </summary>
+		Bindings,
+	
 		Count
 	}
 	
@@ -2233,6 +2248,46 @@ public static class bgfx
 		public uint16 num;
 	}
 	
+	[CRepr]
+	public struct DrawUniform
+	{
+		public void* value;
+		public UniformHandle handle;
+		public uint16 num;
+	}
+	
+	[CRepr]
+	public struct DrawTexture
+	{
+		public uint32 flags;
+		public UniformHandle sampler;
+		public TextureHandle handle;
+		public uint8 stage;
+	}
+	
+	[CRepr]
+	public struct DrawDesc
+	{
+		public uint64 state;
+		public uint32 rgba;
+		public uint32 depth;
+		public uint32 transform;
+		public uint32 startVertex;
+		public uint32 numVertices;
+		public uint32 startIndex;
+		public uint32 numIndices;
+		public uint32 firstUniform;
+		public uint32 firstTexture;
+		public ProgramHandle program;
+		public VertexBufferHandle vertexBuffer;
+		public VertexLayoutHandle layout;
+		public IndexBufferHandle indexBuffer;
+		public uint16 numTransforms;
+		public uint16 scissor;
+		public uint16 numUniforms;
+		public uint8 numTextures;
+	}
+	
 	[CRepr]
 	public struct ViewStats
 	{
@@ -2245,11 +2300,38 @@ public static class bgfx
 		public uint32 gpuFrameNum;
 	}
 	
+	[CRepr]
+	public struct GpuTimerStats
+	{
+		public char8[64] name;
+		public ViewId view;
+		public uint16 depth;
+		public uint32 numForeign;
+		public int64 gpuTimeBegin;
+		public int64 gpuTimeEnd;
+		public uint32 gpuFrameNum;
+	}
+	
+	[CRepr]
+	public struct GpuMemoryHeapStats
+	{
+		public uint32 memoryType;
+		public uint32 numBlocks;
+		public uint32 numAllocations;
+		public uint32 numDedicated;
+		public int64 reserved;
+		public int64 used;
+		public int64 largestFree;
+		public int64 dedicated;
+	}
+	
 	[CRepr]
 	public struct EncoderStats
 	{
 		public int64 cpuTimeBegin;
 		public int64 cpuTimeEnd;
+		public uint32 numSubmitted;
+		public uint32 numDropped;
 	}
 	
 	[CRepr]
@@ -2269,6 +2351,10 @@ public static class bgfx
 		public uint32 numBlit;
 		public uint32 maxGpuLatency;
 		public uint32 gpuFrameNum;
+		public uint32 numBindChanges;
+		public uint32 numBindChangesSaved;
+		public uint32 numUniformsSkipped;
+		public uint32 numConditionFallbacks;
 		public uint16 numDynamicIndexBuffers;
 		public uint16 numDynamicVertexBuffers;
 		public uint16 numFrameBuffers;
@@ -2282,8 +2368,12 @@ public static class bgfx
 		public uint16 numVertexLayouts;
 		public int64 textureMemoryUsed;
 		public int64 rtMemoryUsed;
+		public int64 textureUploadStaged;
+		public int64 textureUploadDirect;
 		public int transientVbUsed;
 		public int transientIbUsed;
+		public uint32 frameMemoryUsed;
+		public uint32 frameMemoryMax;
 		public uint32[5] numPrims;
 		public int64 gpuMemoryMax;
 		public int64 gpuMemoryUsed;
@@ -2295,6 +2385,11 @@ public static class bgfx
 		public ViewStats* viewStats;
 		public uint8 numEncoders;
 		public EncoderStats* encoderStats;
+		public uint16 numGpuTimers;
+		public GpuTimerStats* gpuTimerStats;
+		public uint16 numGpuMemoryHeaps;
+		public GpuMemoryHeapStats* gpuMemoryHeapStats;
+		public float resolutionScale;
 	}
 	
 	[CRepr]
@@ -2659,6 +2754,28 @@ public static class bgfx
 	[LinkName("bgfx_copy")]
 	public static extern Memory* copy(void* _data, uint32 _size);
 	
+	/// <summary>
+	/// Allocate buffer from per-frame memory arena to pass to bgfx calls. Memory
+	/// is reclaimed at once after render thread is done with the frame, and it
+	/// must be passed to bgfx before next `bgfx::frame` call. When arena is
+	/// exhausted allocation falls back to `bgfx::alloc`.
+	/// </summary>
+	///
+	/// <param name="_size">Size to allocate.</param>
+	///
+	[LinkName("bgfx_alloc_frame")]
+	public static extern Memory* alloc_frame(uint32 _size);
+	
+	/// <summary>
+	/// Allocate buffer from per-frame memory arena and copy data into it.
+	/// </summary>
+	///
+	/// <param name="_data">Pointer to data to be copied.</param>
+	/// <param name="_size">Size of data to be copied.</param>
+	///
+	[LinkName("bgfx_copy_frame")]
+	public static extern Memory* copy_frame(void* _data, uint32 _size);
+	
 	/// <summary>
 	/// Make reference to data to pass to bgfx. Unlike `bgfx::alloc`, this call
 	/// doesn't allocate memory for data. It just copies the _data pointer. You
@@ -3611,6 +3728,39 @@ public static class bgfx
 	[LinkName("bgfx_set_view_transform")]
 	public static extern void set_view_transform(ViewId _id, void* _view, void* _proj);
 	
+	/// <summary>
+	/// Set view dynamic resolution. Rect and scissor of scalable views, and
+	/// scissors of draw calls submitted to them, are scaled by current dynamic
+	/// resolution scale.
+	/// @remarks
+	///   Scale used for the frame is reported in `Stats::resolutionScale`.
+	///   Scaled image starts at texture coordinate 0, with bottom-left
+	///   origin (`Caps::originBottomLeft`) rect is scaled toward bottom of
+	///   frame buffer.
+	/// </summary>
+	///
+	/// <param name="_id">View id.</param>
+	/// <param name="_enabled">Enable dynamic resolution scaling for view.</param>
+	///
+	[LinkName("bgfx_set_view_dynamic_resolution")]
+	public static extern void set_view_dynamic_resolution(ViewId _id, bool _enabled);
+	
+	/// <summary>
+	/// Set dynamic resolution controller parameters. Controller picks render
+	/// scale for views marked with `bgfx::setViewDynamicResolution` from
+	/// recent GPU frame times, trying to keep them within frame time budget.
+	/// @remarks
+	///   Passing 0 for target frame time disables controller and resets scale
+	///   to 1.
+	/// </summary>
+	///
+	/// <param name="_targetMs">Target GPU frame time in milliseconds.</param>
+	/// <param name="_minScale">Minimum render scale.</param>
+	/// <param name="_maxScale">Maximum render scale.</param>
+	///
+	[LinkName("bgfx_set_dynamic_resolution")]
+	public static extern void set_dynamic_resolution(float _targetMs, float _minScale, float _maxScale);
+	
 	/// <summary>
 	/// Post submit view reordering.
 	/// </summary>
@@ -3658,6 +3808,32 @@ public static class bgfx
 	[LinkName("bgfx_encoder_set_marker")]
 	public static extern void encoder_set_marker(Encoder* _this, char8* _name, int _len);
 	
+	/// <summary>
+	/// Begin GPU timer scope. Render items submitted by this encoder until matching
+	/// `endGpuTimer` call are measured with GPU timestamp queries. Results are
+	/// resolved asynchronously, and available a few frames later in `Stats::gpuTimerStats`.
+	/// @remarks
+	///   Scopes can be nested, and must be closed before the end of the frame.
+	///   Timestamps are taken around sorted render items, scope measures everything
+	///   from its first to its last render item in sort order. In views that are
+	///   not `ViewMode::Sequential`, or when scope spans multiple views, that
+	///   includes render items submitted outside of scope, and they are counted
+	///   in `GpuTimerStats::numForeign`.
+	/// </summary>
+	///
+	/// <param name="_name">Scope name.</param>
+	/// <param name="_len">Scope name length (if length is INT32_MAX, it's expected that _name is zero terminated string.</param>
+	///
+	[LinkName("bgfx_encoder_begin_gpu_timer")]
+	public static extern void encoder_begin_gpu_timer(Encoder* _this, char8* _name, int _len);
+	
+	/// <summary>
+	/// End GPU timer scope.
+	/// </summary>
+	///
+	[LinkName("bgfx_encoder_end_gpu_timer")]
+	public static extern void encoder_end_gpu_timer(Encoder* _this);
+	
 	/// <summary>
 	/// Set render states for draw primitive.
 	/// @remarks
@@ -3684,9 +3860,10 @@ public static class bgfx
 	///
 	/// <param name="_handle">Occlusion query handle.</param>
 	/// <param name="_visible">Render if occlusion query is visible.</param>
+	/// <param name="_gpu">Predicate draw on GPU with query result from current frame, when `BGFX_CAPS_CONDITIONAL_RENDER` is supported.</param>
 	///
 	[LinkName("bgfx_encoder_set_condition")]
-	public static extern void encoder_set_condition(Encoder* _this, OcclusionQueryHandle _handle, bool _visible);
+	public static extern void encoder_set_condition(Encoder* _this, OcclusionQueryHandle _handle, bool _visible, bool _gpu);
 	
 	/// <summary>
 	/// Set stencil test state.
@@ -3908,6 +4085,48 @@ public static class bgfx
 	[LinkName("bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer")]
 	public static extern void encoder_set_instance_data_from_dynamic_vertex_buffer(Encoder* _this, DynamicVertexBufferHandle _handle, uint32 _startVertex, uint32 _num);
 	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_handle">Vertex buffer.</param>
+	/// <param name="_startVertex">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+	///
+	[LinkName("bgfx_encoder_set_instance_data_from_vertex_buffer_with_layout")]
+	public static extern void encoder_set_instance_data_from_vertex_buffer_with_layout(Encoder* _this, VertexBufferHandle _handle, uint32 _startVertex, uint32 _num, VertexLayoutHandle _layoutHandle);
+	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_handle">Dynamic vertex buffer.</param>
+	/// <param name="_startVertex">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+	///
+	[LinkName("bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout")]
+	public static extern void encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout(Encoder* _this, DynamicVertexBufferHandle _handle, uint32 _startVertex, uint32 _num, VertexLayoutHandle _layoutHandle);
+	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_tvb">Transient vertex buffer.</param>
+	/// <param name="_start">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of transient vertex buffer will be used.</param>
+	///
+	[LinkName("bgfx_encoder_set_instance_data_from_transient_vertex_buffer")]
+	public static extern void encoder_set_instance_data_from_transient_vertex_buffer(Encoder* _this, TransientVertexBuffer* _tvb, uint32 _start, uint32 _num, VertexLayoutHandle _layoutHandle);
+	
 	/// <summary>
 	/// Set number of instances for auto generated instances use in conjunction
 	/// with gl_InstanceID.
@@ -3968,6 +4187,23 @@ public static class bgfx
 	[LinkName("bgfx_encoder_submit_occlusion_query")]
 	public static extern void encoder_submit_occlusion_query(Encoder* _this, ViewId _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint32 _depth, uint8 _flags);
 	
+	/// <summary>
+	/// Submit array of fully specified draw calls for rendering.
+	/// @remarks
+	///   Draws reference ranges in shared uniform and texture arrays. Consecutive
+	///   draws referencing the same ranges share uniform data. State set on encoder
+	///   prior to this call is discarded.
+	/// </summary>
+	///
+	/// <param name="_id">View id.</param>
+	/// <param name="_draws">Draw descriptors.</param>
+	/// <param name="_num">Number of draw descriptors.</param>
+	/// <param name="_uniforms">Uniforms referenced by draw descriptors.</param>
+	/// <param name="_textures">Textures referenced by draw descriptors.</param>
+	///
+	[LinkName("bgfx_encoder_submit_draws")]
+	public static extern void encoder_submit_draws(Encoder* _this, ViewId _id, DrawDesc* _draws, uint32 _num, DrawUniform* _uniforms, DrawTexture* _textures);
+	
 	/// <summary>
 	/// Submit primitive for rendering with index and instance data info from
 	/// indirect buffer.
@@ -4137,6 +4373,9 @@ public static class bgfx
 	/// Request screen shot of window back buffer.
 	/// @remarks
 	///   `bgfx::CallbackI::screenShot` must be implemented.
+	///   Noop renderer calls `bgfx::CallbackI::screenShot` with black BGRA8 image, with the same frame
+	///   latency other renderers have. `BGFX_RESET_CAPTURE` is emulated the same way. This is done only
+	///   when callback is passed to `bgfx::init`, default callback would write black image to disk.
 	/// @attention Frame buffer handle must be created with OS' target native window handle.
 	/// </summary>
 	///
@@ -4227,6 +4466,32 @@ public static class bgfx
 	[LinkName("bgfx_set_marker")]
 	public static extern void set_marker(char8* _name, int _len);
 	
+	/// <summary>
+	/// Begin GPU timer scope. Render items submitted until matching `endGpuTimer`
+	/// call are measured with GPU timestamp queries. Results are resolved
+	/// asynchronously, and available a few frames later in `Stats::gpuTimerStats`.
+	/// @remarks
+	///   Scopes can be nested, and must be closed before the end of the frame.
+	///   Timestamps are taken around sorted render items, scope measures everything
+	///   from its first to its last render item in sort order. In views that are
+	///   not `ViewMode::Sequential`, or when scope spans multiple views, that
+	///   includes render items submitted outside of scope, and they are counted
+	///   in `GpuTimerStats::numForeign`.
+	/// </summary>
+	///
+	/// <param name="_name">Scope name.</param>
+	/// <param name="_len">Scope name length (if length is INT32_MAX, it's expected that _name is zero terminated string.</param>
+	///
+	[LinkName("bgfx_begin_gpu_timer")]
+	public static extern void begin_gpu_timer(char8* _name, int _len);
+	
+	/// <summary>
+	/// End GPU timer scope.
+	/// </summary>
+	///
+	[LinkName("bgfx_end_gpu_timer")]
+	public static extern void end_gpu_timer();
+	
 	/// <summary>
 	/// Set render states for draw primitive.
 	/// @remarks
@@ -4253,9 +4518,10 @@ public static class bgfx
 	///
 	/// <param name="_handle">Occlusion query handle.</param>
 	/// <param name="_visible">Render if occlusion query is visible.</param>
+	/// <param name="_gpu">Predicate draw on GPU with query result from current frame, when `BGFX_CAPS_CONDITIONAL_RENDER` is supported.</param>
 	///
 	[LinkName("bgfx_set_condition")]
-	public static extern void set_condition(OcclusionQueryHandle _handle, bool _visible);
+	public static extern void set_condition(OcclusionQueryHandle _handle, bool _visible, bool _gpu);
 	
 	/// <summary>
 	/// Set stencil test state.
@@ -4487,6 +4753,48 @@ public static class bgfx
 	[LinkName("bgfx_set_instance_data_from_dynamic_vertex_buffer")]
 	public static extern void set_instance_data_from_dynamic_vertex_buffer(DynamicVertexBufferHandle _handle, uint32 _startVertex, uint32 _num);
 	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_handle">Vertex buffer.</param>
+	/// <param name="_startVertex">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+	///
+	[LinkName("bgfx_set_instance_data_from_vertex_buffer_with_layout")]
+	public static extern void set_instance_data_from_vertex_buffer_with_layout(VertexBufferHandle _handle, uint32 _startVertex, uint32 _num, VertexLayoutHandle _layoutHandle);
+	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_handle">Dynamic vertex buffer.</param>
+	/// <param name="_startVertex">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+	///
+	[LinkName("bgfx_set_instance_data_from_dynamic_vertex_buffer_with_layout")]
+	public static extern void set_instance_data_from_dynamic_vertex_buffer_with_layout(DynamicVertexBufferHandle _handle, uint32 _startVertex, uint32 _num, VertexLayoutHandle _layoutHandle);
+	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_tvb">Transient vertex buffer.</param>
+	/// <param name="_start">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of transient vertex buffer will be used.</param>
+	///
+	[LinkName("bgfx_set_instance_data_from_transient_vertex_buffer")]
+	public static extern void set_instance_data_from_transient_vertex_buffer(TransientVertexBuffer* _tvb, uint32 _start, uint32 _num, VertexLayoutHandle _layoutHandle);
+	
 	/// <summary>
 	/// Set number of instances for auto generated instances use in conjunction
 	/// with gl_InstanceID.
@@ -4545,6 +4853,23 @@ public static class bgfx
 	[LinkName("bgfx_submit_occlusion_query")]
 	public static extern void submit_occlusion_query(ViewId _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint32 _depth, uint8 _flags);
 	
+	/// <summary>
+	/// Submit array of fully specified draw calls for rendering.
+	/// @remarks
+	///   Draws reference ranges in shared uniform and texture arrays. Consecutive
+	///   draws referencing the same ranges share uniform data. State set on encoder
+	///   prior to this call is discarded.
+	/// </summary>
+	///
+	/// <param name="_id">View id.</param>
+	/// <param name="_draws">Draw descriptors.</param>
+	/// <param name="_num">Number of draw descriptors.</param>
+	/// <param name="_uniforms">Uniforms referenced by draw descriptors.</param>
+	/// <param name="_textures">Textures referenced by draw descriptors.</param>
+	///
+	[LinkName("bgfx_submit_draws")]
+	public static extern void submit_draws(ViewId _id, DrawDesc* _draws, uint32 _num, DrawUniform* _uniforms, DrawTexture* _textures);
+	
 	/// <summary>
 	/// Submit primitive for rendering with index and instance data info from
 	/// indirect buffer.
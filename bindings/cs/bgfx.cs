@@ -1161,6 +1161,16 @@ public static partial class bgfx
 		/// </summary>
 		DrawIndirectCount      = 0x0000000040000000,
 	
+		/// <summary>
+		/// Draw can be predicated on occlusion query result on GPU.
+		/// </summary>
+		ConditionalRender      = 0x0000000080000000,
+	
+		/// <summary>
+		/// Instance data described by vertex layout is supported.
+		/// </summary>
+		InstancingLayout       = 0x0000000100000000,
+	
 		/// <summary>
 		/// All texture compare modes are supported.
 		/// </summary>
@@ -1989,6 +1999,11 @@ public static partial class bgfx
 		/// </summary>
 		DepthDescending,
 	
+		/// <summary>
+		/// Default sort order, draws sharing program and blend are grouped by bindings.
+		/// </summary>
+		Bindings,
+	
 		Count
 	}
 	
@@ -2201,6 +2216,43 @@ public static partial class bgfx
 		public ushort num;
 	}
 	
+	public unsafe struct DrawUniform
+	{
+		public void* value;
+		public UniformHandle handle;
+		public ushort num;
+	}
+	
+	public unsafe struct DrawTexture
+	{
+		public uint flags;
+		public UniformHandle sampler;
+		public TextureHandle handle;
+		public byte stage;
+	}
+	
+	public unsafe struct DrawDesc
+	{
+		public ulong state;
+		public uint rgba;
+		public uint depth;
+		public uint transform;
+		public uint startVertex;
+		public uint numVertices;
+		public uint startIndex;
+		public uint numIndices;
+		public uint firstUniform;
+		public uint firstTexture;
+		public ProgramHandle program;
+		public VertexBufferHandle vertexBuffer;
+		public VertexLayoutHandle layout;
+		public IndexBufferHandle indexBuffer;
+		public ushort numTransforms;
+		public ushort scissor;
+		public ushort numUniforms;
+		public byte numTextures;
+	}
+	
 	public unsafe struct ViewStats
 	{
 		public fixed byte name[256];
@@ -2212,10 +2264,35 @@ public static partial class bgfx
 		public uint gpuFrameNum;
 	}
 	
+	public unsafe struct GpuTimerStats
+	{
+		public fixed byte name[64];
+		public ushort view;
+		public ushort depth;
+		public uint numForeign;
+		public long gpuTimeBegin;
+		public long gpuTimeEnd;
+		public uint gpuFrameNum;
+	}
+	
+	public unsafe struct GpuMemoryHeapStats
+	{
+		public uint memoryType;
+		public uint numBlocks;
+		public uint numAllocations;
+		public uint numDedicated;
+		public long reserved;
+		public long used;
+		public long largestFree;
+		public long dedicated;
+	}
+	
 	public unsafe struct EncoderStats
 	{
 		public long cpuTimeBegin;
 		public long cpuTimeEnd;
+		public uint numSubmitted;
+		public uint numDropped;
 	}
 	
 	public unsafe struct Stats
@@ -2234,6 +2311,10 @@ public static partial class bgfx
 		public uint numBlit;
 		public uint maxGpuLatency;
 		public uint gpuFrameNum;
+		public uint numBindChanges;
+		public uint numBindChangesSaved;
+		public uint numUniformsSkipped;
+		public uint numConditionFallbacks;
 		public ushort numDynamicIndexBuffers;
 		public ushort numDynamicVertexBuffers;
 		public ushort numFrameBuffers;
@@ -2247,8 +2328,12 @@ public static partial class bgfx
 		public ushort numVertexLayouts;
 		public long textureMemoryUsed;
 		public long rtMemoryUsed;
+		public long textureUploadStaged;
+		public long textureUploadDirect;
 		public int transientVbUsed;
 		public int transientIbUsed;
+		public uint frameMemoryUsed;
+		public uint frameMemoryMax;
 		public fixed uint numPrims[5];
 		public long gpuMemoryMax;
 		public long gpuMemoryUsed;
@@ -2260,6 +2345,11 @@ public static partial class bgfx
 		public ViewStats* viewStats;
 		public byte numEncoders;
 		public EncoderStats* encoderStats;
+		public ushort numGpuTimers;
+		public GpuTimerStats* gpuTimerStats;
+		public ushort numGpuMemoryHeaps;
+		public GpuMemoryHeapStats* gpuMemoryHeapStats;
+		public float resolutionScale;
 	}
 	
 	public unsafe struct VertexLayout
@@ -2612,6 +2702,28 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_copy", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe Memory* copy(void* _data, uint _size);
 	
+	/// <summary>
+	/// Allocate buffer from per-frame memory arena to pass to bgfx calls. Memory
+	/// is reclaimed at once after render thread is done with the frame, and it
+	/// must be passed to bgfx before next `bgfx::frame` call. When arena is
+	/// exhausted allocation falls back to `bgfx::alloc`.
+	/// </summary>
+	///
+	/// <param name="_size">Size to allocate.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_alloc_frame", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe Memory* alloc_frame(uint _size);
+	
+	/// <summary>
+	/// Allocate buffer from per-frame memory arena and copy data into it.
+	/// </summary>
+	///
+	/// <param name="_data">Pointer to data to be copied.</param>
+	/// <param name="_size">Size of data to be copied.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_copy_frame", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe Memory* copy_frame(void* _data, uint _size);
+	
 	/// <summary>
 	/// Make reference to data to pass to bgfx. Unlike `bgfx::alloc`, this call
 	/// doesn't allocate memory for data. It just copies the _data pointer. You
@@ -3567,6 +3679,39 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_set_view_transform", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void set_view_transform(ushort _id, void* _view, void* _proj);
 	
+	/// <summary>
+	/// Set view dynamic resolution. Rect and scissor of scalable views, and
+	/// scissors of draw calls submitted to them, are scaled by current dynamic
+	/// resolution scale.
+	/// @remarks
+	///   Scale used for the frame is reported in `Stats::resolutionScale`.
+	///   Scaled image starts at texture coordinate 0, with bottom-left
+	///   origin (`Caps::originBottomLeft`) rect is scaled toward bottom of
+	///   frame buffer.
+	/// </summary>
+	///
+	/// <param name="_id">View id.</param>
+	/// <param name="_enabled">Enable dynamic resolution scaling for view.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_set_view_dynamic_resolution", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void set_view_dynamic_resolution(ushort _id, bool _enabled);
+	
+	/// <summary>
+	/// Set dynamic resolution controller parameters. Controller picks render
+	/// scale for views marked with `bgfx::setViewDynamicResolution` from
+	/// recent GPU frame times, trying to keep them within frame time budget.
+	/// @remarks
+	///   Passing 0 for target frame time disables controller and resets scale
+	///   to 1.
+	/// </summary>
+	///
+	/// <param name="_targetMs">Target GPU frame time in milliseconds.</param>
+	/// <param name="_minScale">Minimum render scale.</param>
+	/// <param name="_maxScale">Maximum render scale.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_set_dynamic_resolution", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void set_dynamic_resolution(float _targetMs, float _minScale, float _maxScale);
+	
 	/// <summary>
 	/// Post submit view reordering.
 	/// </summary>
@@ -3614,6 +3759,32 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_encoder_set_marker", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void encoder_set_marker(Encoder* _this, [MarshalAs(UnmanagedType.LPStr)] string _name, int _len);
 	
+	/// <summary>
+	/// Begin GPU timer scope. Render items submitted by this encoder until matching
+	/// `endGpuTimer` call are measured with GPU timestamp queries. Results are
+	/// resolved asynchronously, and available a few frames later in `Stats::gpuTimerStats`.
+	/// @remarks
+	///   Scopes can be nested, and must be closed before the end of the frame.
+	///   Timestamps are taken around sorted render items, scope measures everything
+	///   from its first to its last render item in sort order. In views that are
+	///   not `ViewMode::Sequential`, or when scope spans multiple views, that
+	///   includes render items submitted outside of scope, and they are counted
+	///   in `GpuTimerStats::numForeign`.
+	/// </summary>
+	///
+	/// <param name="_name">Scope name.</param>
+	/// <param name="_len">Scope name length (if length is INT32_MAX, it's expected that _name is zero terminated string.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_begin_gpu_timer", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_begin_gpu_timer(Encoder* _this, [MarshalAs(UnmanagedType.LPStr)] string _name, int _len);
+	
+	/// <summary>
+	/// End GPU timer scope.
+	/// </summary>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_end_gpu_timer", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_end_gpu_timer(Encoder* _this);
+	
 	/// <summary>
 	/// Set render states for draw primitive.
 	/// @remarks
@@ -3640,9 +3811,10 @@ public static partial class bgfx
 	///
 	/// <param name="_handle">Occlusion query handle.</param>
 	/// <param name="_visible">Render if occlusion query is visible.</param>
+	/// <param name="_gpu">Predicate draw on GPU with query result from current frame, when `BGFX_CAPS_CONDITIONAL_RENDER` is supported.</param>
 	///
 	[DllImport(DllName, EntryPoint="bgfx_encoder_set_condition", CallingConvention = CallingConvention.Cdecl)]
-	public static extern unsafe void encoder_set_condition(Encoder* _this, OcclusionQueryHandle _handle, bool _visible);
+	public static extern unsafe void encoder_set_condition(Encoder* _this, OcclusionQueryHandle _handle, bool _visible, bool _gpu);
 	
 	/// <summary>
 	/// Set stencil test state.
@@ -3864,6 +4036,48 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void encoder_set_instance_data_from_dynamic_vertex_buffer(Encoder* _this, DynamicVertexBufferHandle _handle, uint _startVertex, uint _num);
 	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_handle">Vertex buffer.</param>
+	/// <param name="_startVertex">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_set_instance_data_from_vertex_buffer_with_layout", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_set_instance_data_from_vertex_buffer_with_layout(Encoder* _this, VertexBufferHandle _handle, uint _startVertex, uint _num, VertexLayoutHandle _layoutHandle);
+	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_handle">Dynamic vertex buffer.</param>
+	/// <param name="_startVertex">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout(Encoder* _this, DynamicVertexBufferHandle _handle, uint _startVertex, uint _num, VertexLayoutHandle _layoutHandle);
+	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_tvb">Transient vertex buffer.</param>
+	/// <param name="_start">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of transient vertex buffer will be used.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_set_instance_data_from_transient_vertex_buffer", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_set_instance_data_from_transient_vertex_buffer(Encoder* _this, TransientVertexBuffer* _tvb, uint _start, uint _num, VertexLayoutHandle _layoutHandle);
+	
 	/// <summary>
 	/// Set number of instances for auto generated instances use in conjunction
 	/// with gl_InstanceID.
@@ -3924,6 +4138,23 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_encoder_submit_occlusion_query", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void encoder_submit_occlusion_query(Encoder* _this, ushort _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint _depth, byte _flags);
 	
+	/// <summary>
+	/// Submit array of fully specified draw calls for rendering.
+	/// @remarks
+	///   Draws reference ranges in shared uniform and texture arrays. Consecutive
+	///   draws referencing the same ranges share uniform data. State set on encoder
+	///   prior to this call is discarded.
+	/// </summary>
+	///
+	/// <param name="_id">View id.</param>
+	/// <param name="_draws">Draw descriptors.</param>
+	/// <param name="_num">Number of draw descriptors.</param>
+	/// <param name="_uniforms">Uniforms referenced by draw descriptors.</param>
+	/// <param name="_textures">Textures referenced by draw descriptors.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_submit_draws", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_submit_draws(Encoder* _this, ushort _id, DrawDesc* _draws, uint _num, DrawUniform* _uniforms, DrawTexture* _textures);
+	
 	/// <summary>
 	/// Submit primitive for rendering with index and instance data info from
 	/// indirect buffer.
@@ -4093,6 +4324,9 @@ public static partial class bgfx
 	/// Request screen shot of window back buffer.
 	/// @remarks
 	///   `bgfx::CallbackI::screenShot` must be implemented.
+	///   Noop renderer calls `bgfx::CallbackI::screenShot` with black BGRA8 image, with the same frame
+	///   latency other renderers have. `BGFX_RESET_CAPTURE` is emulated the same way. This is done only
+	///   when callback is passed to `bgfx::init`, default callback would write black image to disk.
 	/// @attention Frame buffer handle must be created with OS' target native window handle.
 	/// </summary>
 	///
@@ -4183,6 +4417,32 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_set_marker", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void set_marker([MarshalAs(UnmanagedType.LPStr)] string _name, int _len);
 	
+	/// <summary>
+	/// Begin GPU timer scope. Render items submitted until matching `endGpuTimer`
+	/// call are measured with GPU timestamp queries. Results are resolved
+	/// asynchronously, and available a few frames later in `Stats::gpuTimerStats`.
+	/// @remarks
+	///   Scopes can be nested, and must be closed before the end of the frame.
+	///   Timestamps are taken around sorted render items, scope measures everything
+	///   from its first to its last render item in sort order. In views that are
+	///   not `ViewMode::Sequential`, or when scope spans multiple views, that
+	///   includes render items submitted outside of scope, and they are counted
+	///   in `GpuTimerStats::numForeign`.
+	/// </summary>
+	///
+	/// <param name="_name">Scope name.</param>
+	/// <param name="_len">Scope name length (if length is INT32_MAX, it's expected that _name is zero terminated string.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_begin_gpu_timer", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void begin_gpu_timer([MarshalAs(UnmanagedType.LPStr)] string _name, int _len);
+	
+	/// <summary>
+	/// End GPU timer scope.
+	/// </summary>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_end_gpu_timer", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void end_gpu_timer();
+	
 	/// <summary>
 	/// Set render states for draw primitive.
 	/// @remarks
@@ -4209,9 +4469,10 @@ public static partial class bgfx
 	///
 	/// <param name="_handle">Occlusion query handle.</param>
 	/// <param name="_visible">Render if occlusion query is visible.</param>
+	/// <param name="_gpu">Predicate draw on GPU with query result from current frame, when `BGFX_CAPS_CONDITIONAL_RENDER` is supported.</param>
 	///
 	[DllImport(DllName, EntryPoint="bgfx_set_condition", CallingConvention = CallingConvention.Cdecl)]
-	public static extern unsafe void set_condition(OcclusionQueryHandle _handle, bool _visible);
+	public static extern unsafe void set_condition(OcclusionQueryHandle _handle, bool _visible, bool _gpu);
 	
 	/// <summary>
 	/// Set stencil test state.
@@ -4443,6 +4704,48 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_set_instance_data_from_dynamic_vertex_buffer", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void set_instance_data_from_dynamic_vertex_buffer(DynamicVertexBufferHandle _handle, uint _startVertex, uint _num);
 	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_handle">Vertex buffer.</param>
+	/// <param name="_startVertex">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_set_instance_data_from_vertex_buffer_with_layout", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void set_instance_data_from_vertex_buffer_with_layout(VertexBufferHandle _handle, uint _startVertex, uint _num, VertexLayoutHandle _layoutHandle);
+	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_handle">Dynamic vertex buffer.</param>
+	/// <param name="_startVertex">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_set_instance_data_from_dynamic_vertex_buffer_with_layout", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void set_instance_data_from_dynamic_vertex_buffer_with_layout(DynamicVertexBufferHandle _handle, uint _startVertex, uint _num, VertexLayoutHandle _layoutHandle);
+	
+	/// <summary>
+	/// Set instance data buffer for draw primitive. Instance data is described by
+	/// vertex layout and bound as instance rate stream.
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// </summary>
+	///
+	/// <param name="_tvb">Transient vertex buffer.</param>
+	/// <param name="_start">First instance data.</param>
+	/// <param name="_num">Number of data instances.</param>
+	/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of transient vertex buffer will be used.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_set_instance_data_from_transient_vertex_buffer", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void set_instance_data_from_transient_vertex_buffer(TransientVertexBuffer* _tvb, uint _start, uint _num, VertexLayoutHandle _layoutHandle);
+	
 	/// <summary>
 	/// Set number of instances for auto generated instances use in conjunction
 	/// with gl_InstanceID.
@@ -4501,6 +4804,23 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_submit_occlusion_query", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void submit_occlusion_query(ushort _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint _depth, byte _flags);
 	
+	/// <summary>
+	/// Submit array of fully specified draw calls for rendering.
+	/// @remarks
+	///   Draws reference ranges in shared uniform and texture arrays. Consecutive
+	///   draws referencing the same ranges share uniform data. State set on encoder
+	///   prior to this call is discarded.
+	/// </summary>
+	///
+	/// <param name="_id">View id.</param>
+	/// <param name="_draws">Draw descriptors.</param>
+	/// <param name="_num">Number of draw descriptors.</param>
+	/// <param name="_uniforms">Uniforms referenced by draw descriptors.</param>
+	/// <param name="_textures">Textures referenced by draw descriptors.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_submit_draws", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void submit_draws(ushort _id, DrawDesc* _draws, uint _num, DrawUniform* _uniforms, DrawTexture* _textures);
+	
 	/// <summary>
 	/// Submit primitive for rendering with index and instance data info from
 	/// indirect buffer.
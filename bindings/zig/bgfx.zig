@@ -717,6 +717,12 @@ pub const CapsFlags_ViewportLayerArray: CapsFlags     = 0x0000000020000000;
 /// Draw indirect with indirect count is supported.
 pub const CapsFlags_DrawIndirectCount: CapsFlags      = 0x0000000040000000;
 
+/// Draw can be predicated on occlusion query result on GPU.
+pub const CapsFlags_ConditionalRender: CapsFlags      = 0x0000000080000000;
+
+/// Instance data described by vertex layout is supported.
+pub const CapsFlags_InstancingLayout: CapsFlags       = 0x0000000100000000;
+
 /// All texture compare modes are supported.
 pub const CapsFlags_TextureCompareAll: CapsFlags      = 0x0000000000300000;
 
@@ -1251,6 +1257,9 @@ pub const ViewMode = enum(c_int) {
     /// Sort draw call depth in descending order.
     DepthDescending,
 
+    /// Default sort order, draws sharing program and blend are grouped by bindings.
+    Bindings,
+
     Count
 };
 
@@ -1443,6 +1452,40 @@ pub const Init = extern struct {
         num: u16,
     };
 
+    pub const DrawUniform = extern struct {
+        value: ?*const anyopaque,
+        handle: UniformHandle,
+        num: u16,
+    };
+
+    pub const DrawTexture = extern struct {
+        flags: u32,
+        sampler: UniformHandle,
+        handle: TextureHandle,
+        stage: u8,
+    };
+
+    pub const DrawDesc = extern struct {
+        state: u64,
+        rgba: u32,
+        depth: u32,
+        transform: u32,
+        startVertex: u32,
+        numVertices: u32,
+        startIndex: u32,
+        numIndices: u32,
+        firstUniform: u32,
+        firstTexture: u32,
+        program: ProgramHandle,
+        vertexBuffer: VertexBufferHandle,
+        layout: VertexLayoutHandle,
+        indexBuffer: IndexBufferHandle,
+        numTransforms: u16,
+        scissor: u16,
+        numUniforms: u16,
+        numTextures: u8,
+    };
+
     pub const ViewStats = extern struct {
         name: [256]u8,
         view: ViewId,
@@ -1453,9 +1496,32 @@ pub const Init = extern struct {
         gpuFrameNum: u32,
     };
 
+    pub const GpuTimerStats = extern struct {
+        name: [64]u8,
+        view: ViewId,
+        depth: u16,
+        numForeign: u32,
+        gpuTimeBegin: i64,
+        gpuTimeEnd: i64,
+        gpuFrameNum: u32,
+    };
+
+    pub const GpuMemoryHeapStats = extern struct {
+        memoryType: u32,
+        numBlocks: u32,
+        numAllocations: u32,
+        numDedicated: u32,
+        reserved: i64,
+        used: i64,
+        largestFree: i64,
+        dedicated: i64,
+    };
+
     pub const EncoderStats = extern struct {
         cpuTimeBegin: i64,
         cpuTimeEnd: i64,
+        numSubmitted: u32,
+        numDropped: u32,
     };
 
     pub const Stats = extern struct {
@@ -1473,6 +1539,10 @@ pub const Init = extern struct {
         numBlit: u32,
         maxGpuLatency: u32,
         gpuFrameNum: u32,
+        numBindChanges: u32,
+        numBindChangesSaved: u32,
+        numUniformsSkipped: u32,
+        numConditionFallbacks: u32,
         numDynamicIndexBuffers: u16,
         numDynamicVertexBuffers: u16,
         numFrameBuffers: u16,
@@ -1486,8 +1556,12 @@ pub const Init = extern struct {
         numVertexLayouts: u16,
         textureMemoryUsed: i64,
         rtMemoryUsed: i64,
+        textureUploadStaged: i64,
+        textureUploadDirect: i64,
         transientVbUsed: i32,
         transientIbUsed: i32,
+        frameMemoryUsed: u32,
+        frameMemoryMax: u32,
         numPrims: [5]u32,
         gpuMemoryMax: i64,
         gpuMemoryUsed: i64,
@@ -1499,6 +1573,11 @@ pub const Init = extern struct {
         viewStats: [*c]ViewStats,
         numEncoders: u8,
         encoderStats: [*c]EncoderStats,
+        numGpuTimers: u16,
+        gpuTimerStats: [*c]GpuTimerStats,
+        numGpuMemoryHeaps: u16,
+        gpuMemoryHeapStats: [*c]GpuMemoryHeapStats,
+        resolutionScale: f32,
     };
 
     pub const VertexLayout = extern struct {
@@ -1554,6 +1633,25 @@ pub const Init = extern struct {
         pub inline fn setMarker(self: ?*Encoder, _name: [*c]const u8, _len: i32) void {
             return bgfx_encoder_set_marker(self, _name, _len);
         }
+        /// Begin GPU timer scope. Render items submitted by this encoder until matching
+        /// `endGpuTimer` call are measured with GPU timestamp queries. Results are
+        /// resolved asynchronously, and available a few frames later in `Stats::gpuTimerStats`.
+        /// @remarks
+        ///   Scopes can be nested, and must be closed before the end of the frame.
+        ///   Timestamps are taken around sorted render items, scope measures everything
+        ///   from its first to its last render item in sort order. In views that are
+        ///   not `ViewMode::Sequential`, or when scope spans multiple views, that
+        ///   includes render items submitted outside of scope, and they are counted
+        ///   in `GpuTimerStats::numForeign`.
+        /// <param name="_name">Scope name.</param>
+        /// <param name="_len">Scope name length (if length is INT32_MAX, it's expected that _name is zero terminated string.</param>
+        pub inline fn beginGpuTimer(self: ?*Encoder, _name: [*c]const u8, _len: i32) void {
+            return bgfx_encoder_begin_gpu_timer(self, _name, _len);
+        }
+        /// End GPU timer scope.
+        pub inline fn endGpuTimer(self: ?*Encoder) void {
+            return bgfx_encoder_end_gpu_timer(self);
+        }
         /// Set render states for draw primitive.
         /// @remarks
         ///   1. To set up more complex states use:
@@ -1573,8 +1671,9 @@ pub const Init = extern struct {
         /// Set condition for rendering.
         /// <param name="_handle">Occlusion query handle.</param>
         /// <param name="_visible">Render if occlusion query is visible.</param>
-        pub inline fn setCondition(self: ?*Encoder, _handle: OcclusionQueryHandle, _visible: bool) void {
-            return bgfx_encoder_set_condition(self, _handle, _visible);
+        /// <param name="_gpu">Predicate draw on GPU with query result from current frame, when `BGFX_CAPS_CONDITIONAL_RENDER` is supported.</param>
+        pub inline fn setCondition(self: ?*Encoder, _handle: OcclusionQueryHandle, _visible: bool, _gpu: bool) void {
+            return bgfx_encoder_set_condition(self, _handle, _visible, _gpu);
         }
         /// Set stencil test state.
         /// <param name="_fstencil">Front stencil state.</param>
@@ -1720,6 +1819,36 @@ pub const Init = extern struct {
         pub inline fn setInstanceDataFromDynamicVertexBuffer(self: ?*Encoder, _handle: DynamicVertexBufferHandle, _startVertex: u32, _num: u32) void {
             return bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer(self, _handle, _startVertex, _num);
         }
+        /// Set instance data buffer for draw primitive. Instance data is described by
+        /// vertex layout and bound as instance rate stream.
+        /// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+        /// <param name="_handle">Vertex buffer.</param>
+        /// <param name="_startVertex">First instance data.</param>
+        /// <param name="_num">Number of data instances.</param>
+        /// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+        pub inline fn setInstanceDataFromVertexBufferWithLayout(self: ?*Encoder, _handle: VertexBufferHandle, _startVertex: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void {
+            return bgfx_encoder_set_instance_data_from_vertex_buffer_with_layout(self, _handle, _startVertex, _num, _layoutHandle);
+        }
+        /// Set instance data buffer for draw primitive. Instance data is described by
+        /// vertex layout and bound as instance rate stream.
+        /// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+        /// <param name="_handle">Dynamic vertex buffer.</param>
+        /// <param name="_startVertex">First instance data.</param>
+        /// <param name="_num">Number of data instances.</param>
+        /// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+        pub inline fn setInstanceDataFromDynamicVertexBufferWithLayout(self: ?*Encoder, _handle: DynamicVertexBufferHandle, _startVertex: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void {
+            return bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout(self, _handle, _startVertex, _num, _layoutHandle);
+        }
+        /// Set instance data buffer for draw primitive. Instance data is described by
+        /// vertex layout and bound as instance rate stream.
+        /// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+        /// <param name="_tvb">Transient vertex buffer.</param>
+        /// <param name="_start">First instance data.</param>
+        /// <param name="_num">Number of data instances.</param>
+        /// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of transient vertex buffer will be used.</param>
+        pub inline fn setInstanceDataFromTransientVertexBuffer(self: ?*Encoder, _tvb: [*c]const TransientVertexBuffer, _start: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void {
+            return bgfx_encoder_set_instance_data_from_transient_vertex_buffer(self, _tvb, _start, _num, _layoutHandle);
+        }
         /// Set number of instances for auto generated instances use in conjunction
         /// with gl_InstanceID.
         /// @attention Availability depends on: `BGFX_CAPS_VERTEX_ID`.
@@ -1761,6 +1890,19 @@ pub const Init = extern struct {
         pub inline fn submitOcclusionQuery(self: ?*Encoder, _id: ViewId, _program: ProgramHandle, _occlusionQuery: OcclusionQueryHandle, _depth: u32, _flags: u8) void {
             return bgfx_encoder_submit_occlusion_query(self, _id, _program, _occlusionQuery, _depth, _flags);
         }
+        /// Submit array of fully specified draw calls for rendering.
+        /// @remarks
+        ///   Draws reference ranges in shared uniform and texture arrays. Consecutive
+        ///   draws referencing the same ranges share uniform data. State set on encoder
+        ///   prior to this call is discarded.
+        /// <param name="_id">View id.</param>
+        /// <param name="_draws">Draw descriptors.</param>
+        /// <param name="_num">Number of draw descriptors.</param>
+        /// <param name="_uniforms">Uniforms referenced by draw descriptors.</param>
+        /// <param name="_textures">Textures referenced by draw descriptors.</param>
+        pub inline fn submitDraws(self: ?*Encoder, _id: ViewId, _draws: [*c]const DrawDesc, _num: u32, _uniforms: [*c]const DrawUniform, _textures: [*c]const DrawTexture) void {
+            return bgfx_encoder_submit_draws(self, _id, _draws, _num, _uniforms, _textures);
+        }
         /// Submit primitive for rendering with index and instance data info from
         /// indirect buffer.
         /// @attention Availability depends on: `BGFX_CAPS_DRAW_INDIRECT`.
@@ -2138,6 +2280,24 @@ pub inline fn copy(_data: ?*const anyopaque, _size: u32) [*c]const Memory {
 }
 extern fn bgfx_copy(_data: ?*const anyopaque, _size: u32) [*c]const Memory;
 
+/// Allocate buffer from per-frame memory arena to pass to bgfx calls. Memory
+/// is reclaimed at once after render thread is done with the frame, and it
+/// must be passed to bgfx before next `bgfx::frame` call. When arena is
+/// exhausted allocation falls back to `bgfx::alloc`.
+/// <param name="_size">Size to allocate.</param>
+pub inline fn allocFrame(_size: u32) [*c]const Memory {
+    return bgfx_alloc_frame(_size);
+}
+extern fn bgfx_alloc_frame(_size: u32) [*c]const Memory;
+
+/// Allocate buffer from per-frame memory arena and copy data into it.
+/// <param name="_data">Pointer to data to be copied.</param>
+/// <param name="_size">Size of data to be copied.</param>
+pub inline fn copyFrame(_data: ?*const anyopaque, _size: u32) [*c]const Memory {
+    return bgfx_copy_frame(_data, _size);
+}
+extern fn bgfx_copy_frame(_data: ?*const anyopaque, _size: u32) [*c]const Memory;
+
 /// Make reference to data to pass to bgfx. Unlike `bgfx::alloc`, this call
 /// doesn't allocate memory for data. It just copies the _data pointer. You
 /// can pass `ReleaseFn` function pointer to release this memory after it's
@@ -2912,6 +3072,35 @@ pub inline fn setViewTransform(_id: ViewId, _view: ?*const anyopaque, _proj: ?*c
 }
 extern fn bgfx_set_view_transform(_id: ViewId, _view: ?*const anyopaque, _proj: ?*const anyopaque) void;
 
+/// Set view dynamic resolution. Rect and scissor of scalable views, and
+/// scissors of draw calls submitted to them, are scaled by current dynamic
+/// resolution scale.
+/// @remarks
+///   Scale used for the frame is reported in `Stats::resolutionScale`.
+///   Scaled image starts at texture coordinate 0, with bottom-left
+///   origin (`Caps::originBottomLeft`) rect is scaled toward bottom of
+///   frame buffer.
+/// <param name="_id">View id.</param>
+/// <param name="_enabled">Enable dynamic resolution scaling for view.</param>
+pub inline fn setViewDynamicResolution(_id: ViewId, _enabled: bool) void {
+    return bgfx_set_view_dynamic_resolution(_id, _enabled);
+}
+extern fn bgfx_set_view_dynamic_resolution(_id: ViewId, _enabled: bool) void;
+
+/// Set dynamic resolution controller parameters. Controller picks render
+/// scale for views marked with `bgfx::setViewDynamicResolution` from
+/// recent GPU frame times, trying to keep them within frame time budget.
+/// @remarks
+///   Passing 0 for target frame time disables controller and resets scale
+///   to 1.
+/// <param name="_targetMs">Target GPU frame time in milliseconds.</param>
+/// <param name="_minScale">Minimum render scale.</param>
+/// <param name="_maxScale">Maximum render scale.</param>
+pub inline fn setDynamicResolution(_targetMs: f32, _minScale: f32, _maxScale: f32) void {
+    return bgfx_set_dynamic_resolution(_targetMs, _minScale, _maxScale);
+}
+extern fn bgfx_set_dynamic_resolution(_targetMs: f32, _minScale: f32, _maxScale: f32) void;
+
 /// Post submit view reordering.
 /// <param name="_id">First view id.</param>
 /// <param name="_num">Number of views to remap.</param>
@@ -2947,6 +3136,23 @@ extern fn bgfx_encoder_end(_encoder: ?*Encoder) void;
 /// <param name="_len">Marker name length (if length is INT32_MAX, it's expected that _name is zero terminated string.</param>
 extern fn bgfx_encoder_set_marker(self: ?*Encoder, _name: [*c]const u8, _len: i32) void;
 
+/// Begin GPU timer scope. Render items submitted by this encoder until matching
+/// `endGpuTimer` call are measured with GPU timestamp queries. Results are
+/// resolved asynchronously, and available a few frames later in `Stats::gpuTimerStats`.
+/// @remarks
+///   Scopes can be nested, and must be closed before the end of the frame.
+///   Timestamps are taken around sorted render items, scope measures everything
+///   from its first to its last render item in sort order. In views that are
+///   not `ViewMode::Sequential`, or when scope spans multiple views, that
+///   includes render items submitted outside of scope, and they are counted
+///   in `GpuTimerStats::numForeign`.
+/// <param name="_name">Scope name.</param>
+/// <param name="_len">Scope name length (if length is INT32_MAX, it's expected that _name is zero terminated string.</param>
+extern fn bgfx_encoder_begin_gpu_timer(self: ?*Encoder, _name: [*c]const u8, _len: i32) void;
+
+/// End GPU timer scope.
+extern fn bgfx_encoder_end_gpu_timer(self: ?*Encoder) void;
+
 /// Set render states for draw primitive.
 /// @remarks
 ///   1. To set up more complex states use:
@@ -2965,7 +3171,8 @@ extern fn bgfx_encoder_set_state(self: ?*Encoder, _state: u64, _rgba: u32) void;
 /// Set condition for rendering.
 /// <param name="_handle">Occlusion query handle.</param>
 /// <param name="_visible">Render if occlusion query is visible.</param>
-extern fn bgfx_encoder_set_condition(self: ?*Encoder, _handle: OcclusionQueryHandle, _visible: bool) void;
+/// <param name="_gpu">Predicate draw on GPU with query result from current frame, when `BGFX_CAPS_CONDITIONAL_RENDER` is supported.</param>
+extern fn bgfx_encoder_set_condition(self: ?*Encoder, _handle: OcclusionQueryHandle, _visible: bool, _gpu: bool) void;
 
 /// Set stencil test state.
 /// <param name="_fstencil">Front stencil state.</param>
@@ -3091,6 +3298,33 @@ extern fn bgfx_encoder_set_instance_data_from_vertex_buffer(self: ?*Encoder, _ha
 /// <param name="_num">Number of data instances.</param>
 extern fn bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer(self: ?*Encoder, _handle: DynamicVertexBufferHandle, _startVertex: u32, _num: u32) void;
 
+/// Set instance data buffer for draw primitive. Instance data is described by
+/// vertex layout and bound as instance rate stream.
+/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+/// <param name="_handle">Vertex buffer.</param>
+/// <param name="_startVertex">First instance data.</param>
+/// <param name="_num">Number of data instances.</param>
+/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+extern fn bgfx_encoder_set_instance_data_from_vertex_buffer_with_layout(self: ?*Encoder, _handle: VertexBufferHandle, _startVertex: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void;
+
+/// Set instance data buffer for draw primitive. Instance data is described by
+/// vertex layout and bound as instance rate stream.
+/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+/// <param name="_handle">Dynamic vertex buffer.</param>
+/// <param name="_startVertex">First instance data.</param>
+/// <param name="_num">Number of data instances.</param>
+/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+extern fn bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout(self: ?*Encoder, _handle: DynamicVertexBufferHandle, _startVertex: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void;
+
+/// Set instance data buffer for draw primitive. Instance data is described by
+/// vertex layout and bound as instance rate stream.
+/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+/// <param name="_tvb">Transient vertex buffer.</param>
+/// <param name="_start">First instance data.</param>
+/// <param name="_num">Number of data instances.</param>
+/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of transient vertex buffer will be used.</param>
+extern fn bgfx_encoder_set_instance_data_from_transient_vertex_buffer(self: ?*Encoder, _tvb: [*c]const TransientVertexBuffer, _start: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void;
+
 /// Set number of instances for auto generated instances use in conjunction
 /// with gl_InstanceID.
 /// @attention Availability depends on: `BGFX_CAPS_VERTEX_ID`.
@@ -3127,6 +3361,18 @@ extern fn bgfx_encoder_submit(self: ?*Encoder, _id: ViewId, _program: ProgramHan
 /// <param name="_flags">Discard or preserve states. See `BGFX_DISCARD_*`.</param>
 extern fn bgfx_encoder_submit_occlusion_query(self: ?*Encoder, _id: ViewId, _program: ProgramHandle, _occlusionQuery: OcclusionQueryHandle, _depth: u32, _flags: u8) void;
 
+/// Submit array of fully specified draw calls for rendering.
+/// @remarks
+///   Draws reference ranges in shared uniform and texture arrays. Consecutive
+///   draws referencing the same ranges share uniform data. State set on encoder
+///   prior to this call is discarded.
+/// <param name="_id">View id.</param>
+/// <param name="_draws">Draw descriptors.</param>
+/// <param name="_num">Number of draw descriptors.</param>
+/// <param name="_uniforms">Uniforms referenced by draw descriptors.</param>
+/// <param name="_textures">Textures referenced by draw descriptors.</param>
+extern fn bgfx_encoder_submit_draws(self: ?*Encoder, _id: ViewId, _draws: [*c]const DrawDesc, _num: u32, _uniforms: [*c]const DrawUniform, _textures: [*c]const DrawTexture) void;
+
 /// Submit primitive for rendering with index and instance data info from
 /// indirect buffer.
 /// @attention Availability depends on: `BGFX_CAPS_DRAW_INDIRECT`.
@@ -3235,6 +3481,9 @@ extern fn bgfx_encoder_blit(self: ?*Encoder, _id: ViewId, _dst: TextureHandle, _
 /// Request screen shot of window back buffer.
 /// @remarks
 ///   `bgfx::CallbackI::screenShot` must be implemented.
+///   Noop renderer calls `bgfx::CallbackI::screenShot` with black BGRA8 image, with the same frame
+///   latency other renderers have. `BGFX_RESET_CAPTURE` is emulated the same way. This is done only
+///   when callback is passed to `bgfx::init`, default callback would write black image to disk.
 /// @attention Frame buffer handle must be created with OS' target native window handle.
 /// <param name="_handle">Frame buffer handle. If handle is `BGFX_INVALID_HANDLE` request will be made for main window back buffer.</param>
 /// <param name="_filePath">Will be passed to `bgfx::CallbackI::screenShot` callback.</param>
@@ -3313,6 +3562,29 @@ pub inline fn setMarker(_name: [*c]const u8, _len: i32) void {
 }
 extern fn bgfx_set_marker(_name: [*c]const u8, _len: i32) void;
 
+/// Begin GPU timer scope. Render items submitted until matching `endGpuTimer`
+/// call are measured with GPU timestamp queries. Results are resolved
+/// asynchronously, and available a few frames later in `Stats::gpuTimerStats`.
+/// @remarks
+///   Scopes can be nested, and must be closed before the end of the frame.
+///   Timestamps are taken around sorted render items, scope measures everything
+///   from its first to its last render item in sort order. In views that are
+///   not `ViewMode::Sequential`, or when scope spans multiple views, that
+///   includes render items submitted outside of scope, and they are counted
+///   in `GpuTimerStats::numForeign`.
+/// <param name="_name">Scope name.</param>
+/// <param name="_len">Scope name length (if length is INT32_MAX, it's expected that _name is zero terminated string.</param>
+pub inline fn beginGpuTimer(_name: [*c]const u8, _len: i32) void {
+    return bgfx_begin_gpu_timer(_name, _len);
+}
+extern fn bgfx_begin_gpu_timer(_name: [*c]const u8, _len: i32) void;
+
+/// End GPU timer scope.
+pub inline fn endGpuTimer() void {
+    return bgfx_end_gpu_timer();
+}
+extern fn bgfx_end_gpu_timer() void;
+
 /// Set render states for draw primitive.
 /// @remarks
 ///   1. To set up more complex states use:
@@ -3334,10 +3606,11 @@ extern fn bgfx_set_state(_state: u64, _rgba: u32) void;
 /// Set condition for rendering.
 /// <param name="_handle">Occlusion query handle.</param>
 /// <param name="_visible">Render if occlusion query is visible.</param>
-pub inline fn setCondition(_handle: OcclusionQueryHandle, _visible: bool) void {
-    return bgfx_set_condition(_handle, _visible);
+/// <param name="_gpu">Predicate draw on GPU with query result from current frame, when `BGFX_CAPS_CONDITIONAL_RENDER` is supported.</param>
+pub inline fn setCondition(_handle: OcclusionQueryHandle, _visible: bool, _gpu: bool) void {
+    return bgfx_set_condition(_handle, _visible, _gpu);
 }
-extern fn bgfx_set_condition(_handle: OcclusionQueryHandle, _visible: bool) void;
+extern fn bgfx_set_condition(_handle: OcclusionQueryHandle, _visible: bool, _gpu: bool) void;
 
 /// Set stencil test state.
 /// <param name="_fstencil">Front stencil state.</param>
@@ -3529,6 +3802,42 @@ pub inline fn setInstanceDataFromDynamicVertexBuffer(_handle: DynamicVertexBuffe
 }
 extern fn bgfx_set_instance_data_from_dynamic_vertex_buffer(_handle: DynamicVertexBufferHandle, _startVertex: u32, _num: u32) void;
 
+/// Set instance data buffer for draw primitive. Instance data is described by
+/// vertex layout and bound as instance rate stream.
+/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+/// <param name="_handle">Vertex buffer.</param>
+/// <param name="_startVertex">First instance data.</param>
+/// <param name="_num">Number of data instances.</param>
+/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+pub inline fn setInstanceDataFromVertexBufferWithLayout(_handle: VertexBufferHandle, _startVertex: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void {
+    return bgfx_set_instance_data_from_vertex_buffer_with_layout(_handle, _startVertex, _num, _layoutHandle);
+}
+extern fn bgfx_set_instance_data_from_vertex_buffer_with_layout(_handle: VertexBufferHandle, _startVertex: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void;
+
+/// Set instance data buffer for draw primitive. Instance data is described by
+/// vertex layout and bound as instance rate stream.
+/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+/// <param name="_handle">Dynamic vertex buffer.</param>
+/// <param name="_startVertex">First instance data.</param>
+/// <param name="_num">Number of data instances.</param>
+/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of vertex buffer will be used.</param>
+pub inline fn setInstanceDataFromDynamicVertexBufferWithLayout(_handle: DynamicVertexBufferHandle, _startVertex: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void {
+    return bgfx_set_instance_data_from_dynamic_vertex_buffer_with_layout(_handle, _startVertex, _num, _layoutHandle);
+}
+extern fn bgfx_set_instance_data_from_dynamic_vertex_buffer_with_layout(_handle: DynamicVertexBufferHandle, _startVertex: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void;
+
+/// Set instance data buffer for draw primitive. Instance data is described by
+/// vertex layout and bound as instance rate stream.
+/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+/// <param name="_tvb">Transient vertex buffer.</param>
+/// <param name="_start">First instance data.</param>
+/// <param name="_num">Number of data instances.</param>
+/// <param name="_layoutHandle">Vertex layout describing instance data. If invalid handle is used, vertex layout used for creation of transient vertex buffer will be used.</param>
+pub inline fn setInstanceDataFromTransientVertexBuffer(_tvb: [*c]const TransientVertexBuffer, _start: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void {
+    return bgfx_set_instance_data_from_transient_vertex_buffer(_tvb, _start, _num, _layoutHandle);
+}
+extern fn bgfx_set_instance_data_from_transient_vertex_buffer(_tvb: [*c]const TransientVertexBuffer, _start: u32, _num: u32, _layoutHandle: VertexLayoutHandle) void;
+
 /// Set number of instances for auto generated instances use in conjunction
 /// with gl_InstanceID.
 /// @attention Availability depends on: `BGFX_CAPS_VERTEX_ID`.
@@ -3578,6 +3887,21 @@ pub inline fn submitOcclusionQuery(_id: ViewId, _program: ProgramHandle, _occlus
 }
 extern fn bgfx_submit_occlusion_query(_id: ViewId, _program: ProgramHandle, _occlusionQuery: OcclusionQueryHandle, _depth: u32, _flags: u8) void;
 
+/// Submit array of fully specified draw calls for rendering.
+/// @remarks
+///   Draws reference ranges in shared uniform and texture arrays. Consecutive
+///   draws referencing the same ranges share uniform data. State set on encoder
+///   prior to this call is discarded.
+/// <param name="_id">View id.</param>
+/// <param name="_draws">Draw descriptors.</param>
+/// <param name="_num">Number of draw descriptors.</param>
+/// <param name="_uniforms">Uniforms referenced by draw descriptors.</param>
+/// <param name="_textures">Textures referenced by draw descriptors.</param>
+pub inline fn submitDraws(_id: ViewId, _draws: [*c]const DrawDesc, _num: u32, _uniforms: [*c]const DrawUniform, _textures: [*c]const DrawTexture) void {
+    return bgfx_submit_draws(_id, _draws, _num, _uniforms, _textures);
+}
+extern fn bgfx_submit_draws(_id: ViewId, _draws: [*c]const DrawDesc, _num: u32, _uniforms: [*c]const DrawUniform, _textures: [*c]const DrawTexture) void;
+
 /// Submit primitive for rendering with index and instance data info from
 /// indirect buffer.
 /// @attention Availability depends on: `BGFX_CAPS_DRAW_INDIRECT`.
@@ -11,7 +11,7 @@
 #include <bx/file.h>
 #include <bx/string.h>
 
-#include "aviwriter.h"
+#include "capturewriter.h"
 
 #include <inttypes.h>
 
@@ -69,32 +69,20 @@ static const uint16_t s_cubeIndices[36] =
 	6, 3, 7,
 };
 
-void savePng(const char* _filePath, uint32_t _width, uint32_t _height, uint32_t _srcPitch, const void* _src, bimg::TextureFormat::Enum _format, bool _yflip)
-{
-	bx::FileWriter writer;
-	bx::Error err;
-	if (bx::open(&writer, _filePath, false, &err) )
-	{
-		bimg::imageWritePng(&writer, _width, _height, _srcPitch, _src, _format, _yflip, &err);
-		bx::close(&writer);
-	}
-}
-
-void saveTga(const char* _filePath, uint32_t _width, uint32_t _height, uint32_t _srcPitch, const void* _src, bool _grayscale, bool _yflip)
+struct BgfxCallback : public bgfx::CallbackI
 {
-	bx::FileWriter writer;
-	bx::Error err;
-	if (bx::open(&writer, _filePath, false, &err) )
+	BgfxCallback()
+		: m_writer(NULL)
 	{
-		bimg::imageWriteTga(&writer, _width, _height, _srcPitch, _src, _grayscale, _yflip, &err);
-		bx::close(&writer);
 	}
-}
 
-struct BgfxCallback : public bgfx::CallbackI
-{
 	virtual ~BgfxCallback()
 	{
+		if (NULL != m_writer)
+		{
+			bx::deleteObject(entry::getAllocator(), m_writer);
+			m_writer = NULL;
+		}
 	}
 
 	virtual void fatal(const char* _filePath, uint16_t _line, bgfx::Fatal::Enum _code, const char* _str) override
@@ -184,48 +172,43 @@ struct BgfxCallback : public bgfx::CallbackI
 		}
 	}
 
+	CaptureWriter* getWriter()
+	{
+		// Encoding and file I/O happen on capture writer worker thread, callbacks
+		// invoked from render thread only copy data.
+		if (NULL == m_writer)
+		{
+			m_writer = BX_NEW(entry::getAllocator(), CaptureWriter)(entry::getAllocator() );
+		}
+
+		return m_writer;
+	}
+
 	virtual void screenShot(const char* _filePath, uint32_t _width, uint32_t _height, uint32_t _pitch, const void* _data, uint32_t /*_size*/, bool _yflip) override
 	{
 		char temp[1024];
 
 		// Save screen shot as PNG.
 		bx::snprintf(temp, BX_COUNTOF(temp), "%s.png", _filePath);
-		savePng(temp, _width, _height, _pitch, _data, bimg::TextureFormat::BGRA8, _yflip);
-
-		// Save screen shot as TGA.
-		bx::snprintf(temp, BX_COUNTOF(temp), "%s.tga", _filePath);
-		saveTga(temp, _width, _height, _pitch, _data, false, _yflip);
+		getWriter()->screenShot(temp, _width, _height, _pitch, _data, _yflip);
 	}
 
-	virtual void captureBegin(uint32_t _width, uint32_t _height, uint32_t /*_pitch*/, bgfx::TextureFormat::Enum /*_format*/, bool _yflip) override
+	virtual void captureBegin(uint32_t _width, uint32_t _height, uint32_t _pitch, bgfx::TextureFormat::Enum /*_format*/, bool _yflip) override
 	{
-		m_writer = BX_NEW(entry::getAllocator(), AviWriter)(entry::getFileWriter() );
-		if (!m_writer->open("temp/capture.avi", _width, _height, 60, _yflip) )
-		{
-			bx::deleteObject(entry::getAllocator(), m_writer);
-			m_writer = NULL;
-		}
+		getWriter()->captureBegin("temp/capture.avi", _width, _height, _pitch, _yflip);
 	}
 
 	virtual void captureEnd() override
 	{
-		if (NULL != m_writer)
-		{
-			m_writer->close();
-			bx::deleteObject(entry::getAllocator(), m_writer);
-			m_writer = NULL;
-		}
+		getWriter()->captureEnd();
 	}
 
-	virtual void captureFrame(const void* _data, uint32_t /*_size*/) override
+	virtual void captureFrame(const void* _data, uint32_t _size) override
 	{
-		if (NULL != m_writer)
-		{
-			m_writer->frame(_data);
-		}
+		getWriter()->captureFrame(_data, _size);
 	}
 
-	AviWriter* m_writer;
+	CaptureWriter* m_writer;
 };
 
 const size_t kNaturalAlignment = 8;
@@ -3,12 +3,7 @@
  * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
  */
 
-#include <string>
 #include <vector>
-#include <map>
-#include <tinystl/allocator.h>
-#include <tinystl/unordered_map.h>
-namespace stl = tinystl;
 
 #include "common.h"
 #include "bgfx_utils.h"
@@ -16,13 +11,12 @@ namespace stl = tinystl;
 #include <bgfx/bgfx.h>
 #include <bx/timer.h>
 #include <bx/allocator.h>
-#include <bx/hash.h>
-#include <bx/simd_t.h>
 #include <bx/math.h>
 #include <bx/file.h>
 #include "entry/entry.h"
 #include "camera.h"
 #include "imgui/imgui.h"
+#include "shadowvolume/shadowvolume.h"
 
 namespace bgfx
 {
@@ -32,7 +26,6 @@ namespace bgfx
 namespace
 {
 
-#define SV_USE_SIMD 1
 #define MAX_INSTANCE_COUNT 25
 #define MAX_LIGHTS_COUNT 5
 
@@ -157,25 +150,6 @@ void mtxBillboard(
 	_result[15] = 1.0f;
 }
 
-void planeNormal(
-	  float* _result
-	, const float* _v0
-	, const float* _v1
-	, const float* _v2
-	)
-{
-	const bx::Vec3 v0    = bx::load<bx::Vec3>(_v0);
-	const bx::Vec3 v1    = bx::load<bx::Vec3>(_v1);
-	const bx::Vec3 v2    = bx::load<bx::Vec3>(_v2);
-	const bx::Vec3 vec0  = bx::sub(v1, v0);
-	const bx::Vec3 vec1  = bx::sub(v2, v1);
-	const bx::Vec3 cross = bx::cross(vec0, vec1);
-
-	bx::store(_result, bx::normalize(cross) );
-
-	_result[3] = -bx::dot(bx::load<bx::Vec3>(_result), bx::load<bx::Vec3>(_v0) );
-}
-
 struct Uniforms
 {
 	void init()
@@ -557,194 +531,6 @@ void touch(bgfx::ViewId _id)
 	::submit(_id, handle);
 }
 
-struct Face
-{
-	uint16_t m_i[3];
-	float m_plane[4];
-};
-typedef std::vector<Face> FaceArray;
-
-struct Edge
-{
-	bool m_faceReverseOrder[2];
-	uint8_t m_faceIndex;
-	uint16_t m_i0, m_i1;
-};
-
-struct Plane
-{
-	float m_plane[4];
-};
-
-struct HalfEdge
-{
-#define INVALID_EDGE_INDEX UINT16_MAX
-	uint16_t m_secondIndex;
-	bool m_marked;
-};
-
-struct HalfEdges
-{
-	HalfEdges()
-		: m_data()
-		, m_offsets()
-		, m_endPtr()
-	{
-	}
-
-	void init(uint16_t* _indices, uint32_t _numIndices)
-	{
-		m_data = (HalfEdge*)malloc(2 * _numIndices * sizeof(HalfEdge) );
-
-		stl::unordered_map<uint16_t, std::vector<uint16_t> > edges;
-		for (uint32_t ii = 0; ii < _numIndices; ii+=3)
-		{
-			uint16_t idx0 = _indices[ii];
-			uint16_t idx1 = _indices[ii+1];
-			uint16_t idx2 = _indices[ii+2];
-
-			edges[idx0].push_back(idx1);
-			edges[idx1].push_back(idx2);
-			edges[idx2].push_back(idx0);
-		}
-
-		uint32_t numRows = (uint32_t)edges.size();
-		m_offsets = (uint32_t*)malloc(numRows * sizeof(uint32_t) );
-
-		HalfEdge* he = m_data;
-		for (uint16_t ii = 0; ii < numRows; ++ii)
-		{
-			m_offsets[ii] = uint32_t(he - m_data);
-
-			std::vector<uint16_t>& row = edges[ii];
-			for (uint32_t jj = 0, size = (uint32_t)row.size(); jj < size; ++jj)
-			{
-				he->m_secondIndex = row[jj];
-				he->m_marked = false;
-				++he;
-			}
-			he->m_secondIndex = INVALID_EDGE_INDEX;
-			++he;
-		}
-		he->m_secondIndex = 0;
-		m_endPtr = he;
-	}
-
-	void destroy()
-	{
-		free(m_data);
-		m_data = NULL;
-		free(m_offsets);
-		m_offsets = NULL;
-	}
-
-	void mark(uint16_t _firstIndex, uint16_t _secondIndex)
-	{
-		HalfEdge* ptr = &m_data[m_offsets[_firstIndex]];
-		while (INVALID_EDGE_INDEX != ptr->m_secondIndex)
-		{
-			if (ptr->m_secondIndex == _secondIndex)
-			{
-				ptr->m_marked = true;
-				break;
-			}
-			++ptr;
-		}
-	}
-
-	bool unmark(uint16_t _firstIndex, uint16_t _secondIndex)
-	{
-		bool ret = false;
-		HalfEdge* ptr = &m_data[m_offsets[_firstIndex]];
-		while (INVALID_EDGE_INDEX != ptr->m_secondIndex)
-		{
-			if (ptr->m_secondIndex == _secondIndex && ptr->m_marked)
-			{
-				ptr->m_marked = false;
-				ret = true;
-				break;
-			}
-			++ptr;
-		}
-		return ret;
-	}
-
-	inline HalfEdge* begin() const
-	{
-		return m_data;
-	}
-
-	inline HalfEdge* end() const
-	{
-		return m_endPtr;
-	}
-
-	HalfEdge* m_data;
-	uint32_t* m_offsets;
-	HalfEdge* m_endPtr;
-};
-
-struct WeldedVertex
-{
-	uint16_t m_v;
-	bool m_welded;
-};
-
-inline float sqLength(const float _a[3], const float _b[3])
-{
-	const float xx = _a[0] - _b[0];
-	const float yy = _a[1] - _b[1];
-	const float zz = _a[2] - _b[2];
-	return xx*xx + yy*yy + zz*zz;
-}
-
-uint16_t weldVertices(WeldedVertex* _output, const bgfx::VertexLayout& _layout, const void* _data, uint16_t _num, float _epsilon)
-{
-	const uint32_t hashSize = bx::uint32_nextpow2(_num);
-	const uint32_t hashMask = hashSize-1;
-	const float epsilonSq = _epsilon*_epsilon;
-
-	uint16_t numVertices = 0;
-
-	const uint32_t size = sizeof(uint16_t)*(hashSize + _num);
-	uint16_t* hashTable = (uint16_t*)alloca(size);
-	bx::memSet(hashTable, 0xff, size);
-
-	uint16_t* next = hashTable + hashSize;
-
-	for (uint16_t ii = 0; ii < _num; ++ii)
-	{
-		float pos[4];
-		vertexUnpack(pos, bgfx::Attrib::Position, _layout, _data, ii);
-		uint32_t hashValue = bx::hash<bx::HashMurmur2A>(pos, 3*sizeof(float) ) & hashMask;
-
-		uint16_t offset = hashTable[hashValue];
-		for (; UINT16_MAX != offset; offset = next[offset])
-		{
-			float test[4];
-			vertexUnpack(test, bgfx::Attrib::Position, _layout, _data, _output[offset].m_v);
-
-			if (sqLength(test, pos) < epsilonSq)
-			{
-				_output[ii].m_v = _output[offset].m_v;
-				_output[ii].m_welded = true;
-				break;
-			}
-		}
-
-		if (UINT16_MAX == offset)
-		{
-			_output[ii].m_v = ii;
-			_output[ii].m_welded = false;
-			next[ii] = hashTable[hashValue];
-			hashTable[hashValue] = ii;
-			numVertices++;
-		}
-	}
-
-	return numVertices;
-}
-
 struct Group
 {
 	Group()
@@ -760,142 +546,17 @@ struct Group
 		m_vertices = NULL;
 		m_numIndices = 0;
 		m_indices = NULL;
-		m_numEdges = 0;
-		m_edges = NULL;
-		m_edgePlanesUnalignedPtr = NULL;
-		m_edgePlanes = NULL;
+		m_shadowVolume = NULL;
 		m_aabb={};
 		m_sphere={};
 		m_obb={};
 		m_prims.clear();
 	}
 
-	typedef struct { float f[6]; } f6_t;
-
-	struct EdgeAndPlane
-	{
-		EdgeAndPlane(uint16_t _i0, uint16_t _i1)
-			: m_faceIndex(0)
-			, m_i0(_i0)
-			, m_i1(_i1)
-		{
-		}
-
-		bool m_faceReverseOrder[2];
-		uint8_t m_faceIndex;
-		uint16_t m_i0, m_i1;
-		Plane m_plane[2];
-	};
-
 	void fillStructures(const bgfx::VertexLayout& _layout)
 	{
-		uint16_t stride = _layout.getStride();
-		m_faces.clear();
-		m_halfEdges.destroy();
-
-		//Init halfedges.
-		m_halfEdges.init(m_indices, m_numIndices);
-
-		//Init faces and edges.
-		m_faces.reserve(m_numIndices/3); //1 face = 3 indices
-		m_edges = (Edge*)malloc(m_numIndices * sizeof(Edge) ); //1 triangle = 3 indices = 3 edges.
-		m_edgePlanesUnalignedPtr = (Plane*)malloc(m_numIndices * sizeof(Plane) + 15);
-		m_edgePlanes = (Plane*)bx::alignPtr(m_edgePlanesUnalignedPtr, 0, 16);
-
-		typedef std::map<std::pair<uint16_t, uint16_t>, EdgeAndPlane> EdgeMap;
-		EdgeMap edgeMap;
-
-		//Get unique indices.
-		WeldedVertex* uniqueVertices = (WeldedVertex*)malloc(m_numVertices*sizeof(WeldedVertex) );
-		::weldVertices(uniqueVertices, _layout, m_vertices, m_numVertices, 0.0001f);
-		uint16_t* uniqueIndices = (uint16_t*)malloc(m_numIndices*sizeof(uint16_t) );
-		for (uint32_t ii = 0; ii < m_numIndices; ++ii)
-		{
-			uint16_t index = m_indices[ii];
-			if (uniqueVertices[index].m_welded)
-			{
-				uniqueIndices[ii] = uniqueVertices[index].m_v;
-			}
-			else
-			{
-				uniqueIndices[ii] = index;
-			}
-		}
-		free(uniqueVertices);
-
-		for (uint32_t ii = 0, size = m_numIndices/3; ii < size; ++ii)
-		{
-			const uint16_t* indices = &m_indices[ii*3];
-			uint16_t i0 = indices[0];
-			uint16_t i1 = indices[1];
-			uint16_t i2 = indices[2];
-			const float* v0 = (float*)&m_vertices[i0*stride];
-			const float* v1 = (float*)&m_vertices[i1*stride];
-			const float* v2 = (float*)&m_vertices[i2*stride];
-
-			float plane[4];
-			planeNormal(plane, v0, v2, v1);
-
-			Face face;
-			face.m_i[0] = i0;
-			face.m_i[1] = i1;
-			face.m_i[2] = i2;
-			bx::memCopy(face.m_plane, plane, 4*sizeof(float) );
-			m_faces.push_back(face);
-
-			//Use unique indices for EdgeMap.
-			const uint16_t* uindices = &uniqueIndices[ii*3];
-			i0 = uindices[0];
-			i1 = uindices[1];
-			i2 = uindices[2];
-
-			const uint16_t triangleEdge[3][2] =
-			{
-				{ i0, i1 },
-				{ i1, i2 },
-				{ i2, i0 },
-			};
-
-			for (uint8_t jj = 0; jj < 3; ++jj)
-			{
-				const uint16_t ui0 = triangleEdge[jj][0];
-				const uint16_t ui1 = triangleEdge[jj][1];
-
-				std::pair<uint16_t, uint16_t> key    = std::make_pair(ui0, ui1);
-				std::pair<uint16_t, uint16_t> keyInv = std::make_pair(ui1, ui0);
-
-				EdgeMap::iterator iter = edgeMap.find(keyInv);
-				if (iter != edgeMap.end() )
-				{
-					EdgeAndPlane& ep = iter->second;
-					bx::memCopy(ep.m_plane[ep.m_faceIndex].m_plane, plane, 4*sizeof(float) );
-					ep.m_faceReverseOrder[ep.m_faceIndex] = true;
-				}
-				else
-				{
-					std::pair<EdgeMap::iterator, bool> result = edgeMap.insert(std::make_pair(key, EdgeAndPlane(ui0, ui1) ) );
-					EdgeAndPlane& ep = result.first->second;
-					bx::memCopy(ep.m_plane[ep.m_faceIndex].m_plane, plane, 4*sizeof(float) );
-					ep.m_faceReverseOrder[ep.m_faceIndex] = false;
-					ep.m_faceIndex++;
-				}
-			}
-		}
-
-		free(uniqueIndices);
-
-		uint32_t index = 0;
-		for (EdgeMap::const_iterator iter = edgeMap.begin(), end = edgeMap.end(); iter != end; ++iter)
-		{
-			Edge* edge = &m_edges[m_numEdges];
-			Plane* plane = &m_edgePlanes[index];
-
-			bx::memCopy(edge, iter->second.m_faceReverseOrder, sizeof(Edge) );
-			bx::memCopy(plane, iter->second.m_plane, 2 * sizeof(Plane) );
-
-			m_numEdges++;
-			index += 2;
-		}
+		m_shadowVolume = new ShadowVolumeMesh;
+		m_shadowVolume->init(m_vertices, m_numVertices, _layout.getStride(), m_indices, m_numIndices);
 	}
 
 	void unload()
@@ -909,11 +570,8 @@ struct Group
 		m_vertices = NULL;
 		free(m_indices);
 		m_indices = NULL;
-		free(m_edges);
-		m_edges = NULL;
-		free(m_edgePlanesUnalignedPtr);
-		m_edgePlanesUnalignedPtr = NULL;
-		m_halfEdges.destroy();
+		delete m_shadowVolume;
+		m_shadowVolume = NULL;
 	}
 
 	bgfx::VertexBufferHandle m_vbh;
@@ -926,12 +584,7 @@ struct Group
 	bx::Aabb   m_aabb;
 	bx::Obb    m_obb;
 	PrimitiveArray m_prims;
-	uint32_t m_numEdges;
-	Edge* m_edges;
-	Plane* m_edgePlanesUnalignedPtr;
-	Plane* m_edgePlanes;
-	FaceArray m_faces;
-	HalfEdges m_halfEdges;
+	ShadowVolumeMesh* m_shadowVolume;
 };
 
 typedef std::vector<Group> GroupArray;
@@ -1120,44 +773,6 @@ struct Instance
 	Model* m_model;
 };
 
-#define SV_INSTANCE_MEM_SIZE (1500 << 10)
-#define SV_INSTANCE_COUNT ( (25 > MAX_INSTANCE_COUNT) ? 25 : MAX_INSTANCE_COUNT)
-#define SV_PAGE_SIZE (SV_INSTANCE_MEM_SIZE * SV_INSTANCE_COUNT * MAX_LIGHTS_COUNT)
-
-struct ShadowVolumeAllocator
-{
-	ShadowVolumeAllocator()
-	{
-		m_mem = (uint8_t*)malloc(SV_PAGE_SIZE*2);
-		m_ptr = m_mem;
-		m_firstPage = true;
-	}
-
-	~ShadowVolumeAllocator()
-	{
-		free(m_mem);
-	}
-
-	void* alloc(uint32_t _size)
-	{
-		void* ret = (void*)m_ptr;
-		m_ptr += _size;
-		BX_ASSERT(m_ptr - m_mem < (m_firstPage ? SV_PAGE_SIZE : 2 * SV_PAGE_SIZE), "Buffer overflow!");
-		return ret;
-	}
-
-	void swap()
-	{
-		m_ptr = m_firstPage ? m_mem + SV_PAGE_SIZE : m_mem;
-		m_firstPage = !m_firstPage;
-	}
-
-	uint8_t* m_mem;
-	uint8_t* m_ptr;
-	bool m_firstPage;
-};
-static ShadowVolumeAllocator s_svAllocator;
-
 struct ShadowVolumeImpl
 {
 	enum Enum
@@ -1167,24 +782,12 @@ struct ShadowVolumeImpl
 	};
 };
 
-struct ShadowVolumeAlgorithm
-{
-	enum Enum
-	{
-		FaceBased,
-		EdgeBased,
-	};
-};
-
 struct ShadowVolume
 {
-	bgfx::VertexBufferHandle m_vbSides;
-	bgfx::IndexBufferHandle m_ibSides;
-	bgfx::IndexBufferHandle m_ibFrontCap;
-	bgfx::IndexBufferHandle m_ibBackCap;
+	bgfx::TransientVertexBuffer m_tvb;
+	bgfx::TransientIndexBuffer  m_tib; // Sides, front cap, back cap.
 
-	uint32_t m_numVertices;
-	uint32_t m_numIndices;
+	ShadowVolumeSize m_size;
 
 	const float* m_mtx;
 	const float* m_lightPos;
@@ -1192,6 +795,15 @@ struct ShadowVolume
 	bool m_cap;
 };
 
+struct ShadowCasterState
+{
+	ShadowVolumeImpl::Enum m_impl;
+	float m_lightPos[3]; // in model space
+	float m_mtx[16];
+};
+
+static bgfx::VertexLayout s_svLayout;
+
 void shadowVolumeLightTransform(
 	  float* _outLightPos
 	, const float* _scale
@@ -1236,364 +848,56 @@ void shadowVolumeLightTransform(
 	bx::store(_outLightPos, bx::mul({ 0.0f, 0.0f, 0.0f }, mtx) );
 }
 
-void shadowVolumeCreate(
+void shadowVolumeAlloc(
 	  ShadowVolume& _shadowVolume
-	, Group& _group
-	, uint16_t _stride
+	, ShadowVolumeJob& _job
 	, const float* _mtx
-	, const float* _light // in model space
-	, ShadowVolumeImpl::Enum _impl = ShadowVolumeImpl::DepthPass
-	, ShadowVolumeAlgorithm::Enum _algo = ShadowVolumeAlgorithm::FaceBased
-	, bool _textureAsStencil = false
 	)
 {
-	const uint8_t*    vertices   = _group.m_vertices;
-	const FaceArray&  faces      = _group.m_faces;
-	const Edge*       edges      = _group.m_edges;
-	const Plane*      edgePlanes = _group.m_edgePlanes;
-	const uint32_t    numEdges   = _group.m_numEdges;
-	HalfEdges&        halfEdges  = _group.m_halfEdges;
-
-	struct VertexData
-	{
-		VertexData()
-		{
-		}
-
-		VertexData(const float* _v3, float _extrude = 0.0f, float _k = 1.0f)
-		{
-			bx::memCopy(m_v, _v3, 3*sizeof(float) );
-			m_extrude = _extrude;
-			m_k = _k;
-		}
+	_shadowVolume.m_mtx      = _mtx;
+	_shadowVolume.m_lightPos = _job.m_light;
+	_shadowVolume.m_cap      = _job.m_cap;
+	_shadowVolume.m_size     = _job.m_size;
 
-		float m_v[3];
-		float m_extrude;
-		float m_k;
-	};
+	_job.m_sideVertices    = NULL;
+	_job.m_sideIndices     = NULL;
+	_job.m_frontCapIndices = NULL;
+	_job.m_backCapIndices  = NULL;
 
-	bool cap = (ShadowVolumeImpl::DepthFail == _impl);
+	ShadowVolumeSize& size = _shadowVolume.m_size;
 
-	VertexData* verticesSide    = (VertexData*) s_svAllocator.alloc(20000 * sizeof(VertexData) );
-	uint16_t*   indicesSide     = (uint16_t*)   s_svAllocator.alloc(20000 * 3*sizeof(uint16_t) );
-	uint16_t*   indicesFrontCap = 0;
-	uint16_t*   indicesBackCap  = 0;
+	const uint32_t numIndices = size.m_numSideIndices + size.m_numFrontCapIndices + size.m_numBackCapIndices;
 
-	if (cap)
+	if (UINT16_MAX < size.m_numSideVertices
+	||  size.m_numSideVertices != bgfx::getAvailTransientVertexBuffer(size.m_numSideVertices, s_svLayout)
+	||  numIndices != bgfx::getAvailTransientIndexBuffer(numIndices) )
 	{
-		indicesFrontCap = (uint16_t*)s_svAllocator.alloc(80000 * 3*sizeof(uint16_t) );
-		indicesBackCap  = (uint16_t*)s_svAllocator.alloc(80000 * 3*sizeof(uint16_t) );
+		// Sides don't fit 16-bit indices, or out of transient memory, skip shadow volume.
+		bx::memSet(&size, 0, sizeof(ShadowVolumeSize) );
+		return;
 	}
 
-	uint32_t vsideI    = 0;
-	uint32_t sideI     = 0;
-	uint32_t frontCapI = 0;
-	uint32_t backCapI  = 0;
-
-	uint16_t indexSide = 0;
-
-	if (ShadowVolumeAlgorithm::FaceBased == _algo)
+	if (0 == numIndices)
 	{
-		for (FaceArray::const_iterator iter = faces.begin(), end = faces.end(); iter != end; ++iter)
-		{
-			const Face& face = *iter;
-
-			bool frontFacing = false;
-			const float f = bx::dot(bx::load<bx::Vec3>(face.m_plane), bx::load<bx::Vec3>(_light) ) + face.m_plane[3];
-			if (f > 0.0f)
-			{
-				frontFacing = true;
-				uint16_t triangleEdges[3][2] =
-				{
-					{ face.m_i[0], face.m_i[1] },
-					{ face.m_i[1], face.m_i[2] },
-					{ face.m_i[2], face.m_i[0] },
-				};
-
-				for (uint8_t ii = 0; ii < 3; ++ii)
-				{
-					uint16_t first  = triangleEdges[ii][0];
-					uint16_t second = triangleEdges[ii][1];
-
-					if (!halfEdges.unmark(second, first) )
-					{
-						halfEdges.mark(first, second);
-					}
-				}
-			}
-
-			if (cap)
-			{
-				if (frontFacing)
-				{
-					indicesFrontCap[frontCapI++] = face.m_i[0];
-					indicesFrontCap[frontCapI++] = face.m_i[1];
-					indicesFrontCap[frontCapI++] = face.m_i[2];
-				}
-				else
-				{
-					indicesBackCap[backCapI++] = face.m_i[0];
-					indicesBackCap[backCapI++] = face.m_i[1];
-					indicesBackCap[backCapI++] = face.m_i[2];
-				}
-
-				/**
-				 * if '_useFrontFacingFacesAsBackCap' is needed, implement it as such:
-				 *
-				 * bool condition0 = frontFacing && _useFrontFacingFacesAsBackCap;
-				 * bool condition1 = !frontFacing && !_useFrontFacingFacesAsBackCap;
-				 * if (condition0 || condition1)
-				 * {
-				 *      indicesBackCap[backCapI++] = face.m_i[0];
-				 *      indicesBackCap[backCapI++] = face.m_i[1+condition0];
-				 *      indicesBackCap[backCapI++] = face.m_i[2-condition0];
-				 * }
-				 */
-			}
-		}
-
-		// Fill side arrays.
-		uint16_t firstIndex = 0;
-		HalfEdge* he = halfEdges.begin();
-		while (halfEdges.end() != he)
-		{
-			if (he->m_marked)
-			{
-				he->m_marked = false;
-
-				const float* v0 = (float*)&vertices[firstIndex*_stride];
-				const float* v1 = (float*)&vertices[he->m_secondIndex*_stride];
-
-				verticesSide[vsideI++] = VertexData(v0, 0.0f);
-				verticesSide[vsideI++] = VertexData(v0, 1.0f);
-				verticesSide[vsideI++] = VertexData(v1, 0.0f);
-				verticesSide[vsideI++] = VertexData(v1, 1.0f);
-
-				indicesSide[sideI++] = indexSide+0;
-				indicesSide[sideI++] = indexSide+1;
-				indicesSide[sideI++] = indexSide+2;
-
-				indicesSide[sideI++] = indexSide+2;
-				indicesSide[sideI++] = indexSide+1;
-				indicesSide[sideI++] = indexSide+3;
-
-				indexSide += 4;
-			}
-
-			++he;
-			if (INVALID_EDGE_INDEX == he->m_secondIndex)
-			{
-				++he;
-				++firstIndex;
-			}
-		}
+		return;
 	}
-	else // ShadowVolumeAlgorithm::EdgeBased:
-	{
-		{
-			uint32_t ii = 0;
-
-#if SV_USE_SIMD
-			uint32_t numEdgesRounded = numEdges & (~0x1);
-
-			using namespace bx;
-
-			const simd128_t lx = simd_splat(_light[0]);
-			const simd128_t ly = simd_splat(_light[1]);
-			const simd128_t lz = simd_splat(_light[2]);
-
-			for (; ii < numEdgesRounded; ii+=2)
-			{
-				const Edge& edge0 = edges[ii];
-				const Edge& edge1 = edges[ii+1];
-				const Plane* edgePlane0 = &edgePlanes[ii*2];
-				const Plane* edgePlane1 = &edgePlanes[ii*2 + 2];
-
-				const simd128_t reverse =
-					simd_ild(edge0.m_faceReverseOrder[0]
-							, edge1.m_faceReverseOrder[0]
-							, edge0.m_faceReverseOrder[1]
-							, edge1.m_faceReverseOrder[1]
-							);
-
-				const simd128_t p00 = simd_ld(edgePlane0[0].m_plane);
-				const simd128_t p10 = simd_ld(edgePlane1[0].m_plane);
-				const simd128_t p01 = simd_ld(edgePlane0[1].m_plane);
-				const simd128_t p11 = simd_ld(edgePlane1[1].m_plane);
-
-				const simd128_t xxyy0 = simd_shuf_xAyB(p00, p01);
-				const simd128_t zzww0 = simd_shuf_zCwD(p00, p01);
-				const simd128_t xxyy1 = simd_shuf_xAyB(p10, p11);
-				const simd128_t zzww1 = simd_shuf_zCwD(p10, p11);
-
-				const simd128_t vX = simd_shuf_xAyB(xxyy0, xxyy1);
-				const simd128_t vY = simd_shuf_zCwD(xxyy0, xxyy1);
-				const simd128_t vZ = simd_shuf_xAyB(zzww0, zzww1);
-				const simd128_t vW = simd_shuf_zCwD(zzww0, zzww1);
-
-				const simd128_t r0 = simd_mul(vX, lx);
-				const simd128_t r1 = simd_mul(vY, ly);
-				const simd128_t r2 = simd_mul(vZ, lz);
-
-				const simd128_t dot = simd_add(r0, simd_add(r1, r2) );
-				const simd128_t f = simd_add(dot, vW);
-
-				const simd128_t zero = simd_zero();
-				const simd128_t mask = simd_cmpgt(f, zero);
-				const simd128_t onef = simd_splat(1.0f);
-				const simd128_t tmp0 = simd_and(mask, onef);
-				const simd128_t tmp1 = simd_ftoi(tmp0);
-				const simd128_t tmp2 = simd_xor(tmp1, reverse);
-				const simd128_t tmp3 = simd_sll(tmp2, 1);
-				const simd128_t onei = simd_isplat(1);
-				const simd128_t tmp4 = simd_isub(tmp3, onei);
-
-				BX_ALIGN_DECL_16(int32_t res[4]);
-				simd_st(&res, tmp4);
-
-				for (uint16_t jj = 0; jj < 2; ++jj)
-				{
-					int32_t kk = res[jj] + res[jj+2];
-					if (kk != 0)
-					{
-						float* v0 = (float*)&vertices[edges[ii+jj].m_i0*_stride];
-						float* v1 = (float*)&vertices[edges[ii+jj].m_i1*_stride];
-						verticesSide[vsideI++] = VertexData(v0, 0.0f, float(kk) );
-						verticesSide[vsideI++] = VertexData(v0, 1.0f, float(kk) );
-						verticesSide[vsideI++] = VertexData(v1, 0.0f, float(kk) );
-						verticesSide[vsideI++] = VertexData(v1, 1.0f, float(kk) );
-
-						kk = _textureAsStencil ? 1 : kk;
-						uint16_t winding = uint16_t(kk > 0);
-						for (int32_t ll = 0, end = abs(kk); ll < end; ++ll)
-						{
-							indicesSide[sideI++] = indexSide;
-							indicesSide[sideI++] = indexSide + 2 - winding;
-							indicesSide[sideI++] = indexSide + 1 + winding;
-
-							indicesSide[sideI++] = indexSide + 2;
-							indicesSide[sideI++] = indexSide + 3 - winding*2;
-							indicesSide[sideI++] = indexSide + 1 + winding*2;
-						}
-
-						indexSide += 4;
-					}
-				}
-			}
-#endif
-
-			for (; ii < numEdges; ++ii)
-			{
-				const Edge& edge = edges[ii];
-				const Plane* edgePlane = &edgePlanes[ii*2];
-
-				int16_t s0 = ( (bx::dot(bx::load<bx::Vec3>(edgePlane[0].m_plane), bx::load<bx::Vec3>(_light) ) + edgePlane[0].m_plane[3]) > 0.0f) ^ edge.m_faceReverseOrder[0];
-				int16_t s1 = ( (bx::dot(bx::load<bx::Vec3>(edgePlane[1].m_plane), bx::load<bx::Vec3>(_light) ) + edgePlane[1].m_plane[3]) > 0.0f) ^ edge.m_faceReverseOrder[1];
-				int16_t kk = ( (s0 + s1) << 1) - 2;
-
-				if (kk != 0)
-				{
-					float* v0 = (float*)&vertices[edge.m_i0*_stride];
-					float* v1 = (float*)&vertices[edge.m_i1*_stride];
-					verticesSide[vsideI++] = VertexData(v0, 0.0f, kk);
-					verticesSide[vsideI++] = VertexData(v0, 1.0f, kk);
-					verticesSide[vsideI++] = VertexData(v1, 0.0f, kk);
-					verticesSide[vsideI++] = VertexData(v1, 1.0f, kk);
-
-					kk = _textureAsStencil ? 1 : kk;
-					uint16_t winding = uint16_t(kk > 0);
-					for (int32_t jj = 0, end = abs(kk); jj < end; ++jj)
-					{
-						indicesSide[sideI++] = indexSide;
-						indicesSide[sideI++] = indexSide + 2 - winding;
-						indicesSide[sideI++] = indexSide + 1 + winding;
-
-						indicesSide[sideI++] = indexSide + 2;
-						indicesSide[sideI++] = indexSide + 3 - winding*2;
-						indicesSide[sideI++] = indexSide + 1 + winding*2;
-					}
-
-					indexSide += 4;
-				}
-			}
-		}
-
-		if (cap)
-		{
-			// This could/should be done on GPU!
-			for (FaceArray::const_iterator iter = faces.begin(), end = faces.end(); iter != end; ++iter)
-			{
-				const Face& face = *iter;
 
-				const float f = bx::dot(bx::load<bx::Vec3>(face.m_plane), bx::load<bx::Vec3>(_light) ) + face.m_plane[3];
-				bool frontFacing = (f > 0.0f);
-
-				for (uint8_t ii = 0, num = 1 + uint8_t(!_textureAsStencil); ii < num; ++ii)
-				{
-					if (frontFacing)
-					{
-						indicesFrontCap[frontCapI++] = face.m_i[0];
-						indicesFrontCap[frontCapI++] = face.m_i[1];
-						indicesFrontCap[frontCapI++] = face.m_i[2];
-					}
-					else
-					{
-						indicesBackCap[backCapI++] = face.m_i[0];
-						indicesBackCap[backCapI++] = face.m_i[1];
-						indicesBackCap[backCapI++] = face.m_i[2];
-					}
-				}
-			}
-		}
+	if (0 != size.m_numSideVertices)
+	{
+		bgfx::allocTransientVertexBuffer(&_shadowVolume.m_tvb, size.m_numSideVertices, s_svLayout);
+		_job.m_sideVertices = (ShadowVolumeVertex*)_shadowVolume.m_tvb.data;
 	}
 
-	bgfx::VertexLayout layout;
-	layout.begin()
-		.add(bgfx::Attrib::Position,  3, bgfx::AttribType::Float)
-		.add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
-		.end();
+	bgfx::allocTransientIndexBuffer(&_shadowVolume.m_tib, numIndices);
 
-	//fill the structure
-	_shadowVolume.m_numVertices = vsideI;
-	_shadowVolume.m_numIndices  = sideI + frontCapI + backCapI;
-	_shadowVolume.m_mtx         = _mtx;
-	_shadowVolume.m_lightPos    = _light;
-	_shadowVolume.m_cap         = cap;
+	uint16_t* indices = (uint16_t*)_shadowVolume.m_tib.data;
 
-	const bgfx::Memory* mem;
+	_job.m_sideIndices = indices;
 
-	//sides
-	uint32_t vsize = vsideI * 5*sizeof(float);
-	uint32_t isize = sideI * sizeof(uint16_t);
-
-	mem = bgfx::makeRef(verticesSide, vsize);
-	_shadowVolume.m_vbSides = bgfx::createVertexBuffer(mem, layout);
-
-	mem = bgfx::makeRef(indicesSide, isize);
-	_shadowVolume.m_ibSides = bgfx::createIndexBuffer(mem);
-
-	// bgfx::destroy*Buffer doesn't actually destroy buffers now.
-	// Instead, these bgfx::destroy*Buffer commands get queued to be executed after the end of the next frame.
-	bgfx::destroy(_shadowVolume.m_vbSides);
-	bgfx::destroy(_shadowVolume.m_ibSides);
-
-	if (cap)
+	if (_job.m_cap)
 	{
-		//front cap
-		isize = frontCapI * sizeof(uint16_t);
-		mem = bgfx::makeRef(indicesFrontCap, isize);
-		_shadowVolume.m_ibFrontCap = bgfx::createIndexBuffer(mem);
-
-		//gets destroyed after the end of the next frame
-		bgfx::destroy(_shadowVolume.m_ibFrontCap);
-
-		//back cap
-		isize = backCapI * sizeof(uint16_t);
-		mem = bgfx::makeRef(indicesBackCap, isize);
-		_shadowVolume.m_ibBackCap = bgfx::createIndexBuffer(mem);
-
-		//gets destroyed after the end of the next frame
-		bgfx::destroy(_shadowVolume.m_ibBackCap);
+		_job.m_frontCapIndices = indices + size.m_numSideIndices;
+		_job.m_backCapIndices  = indices + size.m_numSideIndices + size.m_numFrontCapIndices;
 	}
 }
 
@@ -1742,6 +1046,50 @@ struct ShadowVolumePart
 	};
 };
 
+void shadowVolumeSubmit(
+	  bgfx::ViewId _viewId
+	, const ShadowVolume& _shadowVolume
+	, const Group& _group
+	, const RenderState& _renderState
+	, const bgfx::ProgramHandle* _programs // indexed by ShadowVolumePart
+	)
+{
+	const ShadowVolumeSize& size = _shadowVolume.m_size;
+
+	if (0 != size.m_numSideIndices)
+	{
+		s_uniforms.submitPerDrawUniforms();
+		bgfx::setTransform(_shadowVolume.m_mtx);
+		bgfx::setVertexBuffer(0, &_shadowVolume.m_tvb);
+		bgfx::setIndexBuffer(&_shadowVolume.m_tib, 0, size.m_numSideIndices);
+		::setRenderState(_renderState);
+		::submit(_viewId, _programs[ShadowVolumePart::Side]);
+	}
+
+	if (_shadowVolume.m_cap)
+	{
+		if (0 != size.m_numFrontCapIndices)
+		{
+			s_uniforms.submitPerDrawUniforms();
+			bgfx::setTransform(_shadowVolume.m_mtx);
+			bgfx::setVertexBuffer(0, _group.m_vbh);
+			bgfx::setIndexBuffer(&_shadowVolume.m_tib, size.m_numSideIndices, size.m_numFrontCapIndices);
+			::setRenderState(_renderState);
+			::submit(_viewId, _programs[ShadowVolumePart::Front]);
+		}
+
+		if (0 != size.m_numBackCapIndices)
+		{
+			s_uniforms.submitPerDrawUniforms();
+			bgfx::setTransform(_shadowVolume.m_mtx);
+			bgfx::setVertexBuffer(0, _group.m_vbh);
+			bgfx::setIndexBuffer(&_shadowVolume.m_tib, size.m_numSideIndices + size.m_numFrontCapIndices, size.m_numBackCapIndices);
+			::setRenderState(_renderState);
+			::submit(_viewId, _programs[ShadowVolumePart::Back]);
+		}
+	}
+}
+
 enum LightPattern
 {
 	LightPattern0 = 0,
@@ -1789,6 +1137,9 @@ public:
 		init.resolution.width  = m_viewState.m_width;
 		init.resolution.height = m_viewState.m_height;
 		init.resolution.reset  = m_reset;
+		// Shadow volumes of all casters and lights are written into transient buffers every frame.
+		init.limits.transientVbSize = 32<<20;
+		init.limits.transientIbSize = 32<<20;
 		bgfx::init(init);
 
 		// Enable debug text.
@@ -1802,6 +1153,12 @@ public:
 
 		PosNormalTexcoordVertex::init();
 
+		s_svLayout
+			.begin()
+			.add(bgfx::Attrib::Position,  3, bgfx::AttribType::Float)
+			.add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
+			.end();
+
 		s_uniforms.init();
 
 		m_figureTex     = loadTexture("textures/figure-rgba.dds");
@@ -1916,6 +1273,8 @@ public:
 		m_numShadowVolumeVertices = 0;
 		m_numShadowVolumeIndices  = 0;
 
+		m_svExtractor.init(3);
+
 		m_oldWidth = 0;
 		m_oldHeight = 0;
 
@@ -1929,7 +1288,7 @@ public:
 		m_numLights         = 1;
 		m_instanceCount     = 9;
 		m_shadowVolumeImpl      = ShadowVolumeImpl::DepthFail;
-		m_shadowVolumeAlgorithm = ShadowVolumeAlgorithm::EdgeBased;
+		m_shadowVolumeAlgorithm = ShadowVolumeType::EdgeBased;
 
 		m_lightPattern = LightPattern0;
 		m_currentMesh  = BunnyLowPoly;
@@ -1945,6 +1304,8 @@ public:
 	virtual int shutdown() override
 	{
 		// Cleanup
+		m_svExtractor.shutdown();
+
 		m_bunnyLowPolyModel.unload();
 		m_bunnyHighPolyModel.unload();
 		m_columnModel.unload();
@@ -2113,8 +1474,8 @@ public:
 			}
 
 			ImGui::Text("Shadow volume implementation:");
-			m_shadowVolumeAlgorithm = (ImGui::RadioButton("Face based impl.", ShadowVolumeAlgorithm::FaceBased == m_shadowVolumeAlgorithm) ? ShadowVolumeAlgorithm::FaceBased : m_shadowVolumeAlgorithm);
-			m_shadowVolumeAlgorithm = (ImGui::RadioButton("Edge based impl.", ShadowVolumeAlgorithm::EdgeBased == m_shadowVolumeAlgorithm) ? ShadowVolumeAlgorithm::EdgeBased : m_shadowVolumeAlgorithm);
+			m_shadowVolumeAlgorithm = (ImGui::RadioButton("Face based impl.", ShadowVolumeType::FaceBased == m_shadowVolumeAlgorithm) ? ShadowVolumeType::FaceBased : m_shadowVolumeAlgorithm);
+			m_shadowVolumeAlgorithm = (ImGui::RadioButton("Edge based impl.", ShadowVolumeType::EdgeBased == m_shadowVolumeAlgorithm) ? ShadowVolumeType::EdgeBased : m_shadowVolumeAlgorithm);
 
 			ImGui::Text("Stencil:");
 			if (ImGui::RadioButton("Use stencil buffer", !m_useStencilTexture) )
@@ -2565,36 +1926,36 @@ public:
 					createNearClipVolume(nearClipVolume, pointLight, m_viewState.m_view, fov, aspect, nearPlane);
 				}
 
+				// Shadow volumes of all casters for current light are
+				// extracted on worker threads, into transient buffers
+				// allocated between size calculation and write.
+				ShadowCasterState casterState[BX_COUNTOF(shadowCasters[0])];
+				m_svJobs.clear();
+				m_shadowVolumes.clear();
+
 				for (uint8_t jj = 0; jj < shadowCastersCount[m_currentScene]; ++jj)
 				{
 					const Instance& instance = shadowCasters[m_currentScene][jj];
-					Model* model = instance.m_model;
+					ShadowCasterState& state = casterState[jj];
 
-					ShadowVolumeImpl::Enum shadowVolumeImpl = m_shadowVolumeImpl;
+					state.m_impl = m_shadowVolumeImpl;
 					if (m_mixedSvImpl)
 					{
 						// If instance is inside near clip volume, depth fail must be used, else depth pass is fine.
-						bool isInsideVolume = clipTest(nearClipVolume, 6, model->m_mesh, instance.m_scale, instance.m_pos);
-						shadowVolumeImpl = (isInsideVolume ? ShadowVolumeImpl::DepthFail : ShadowVolumeImpl::DepthPass);
+						bool isInsideVolume = clipTest(nearClipVolume, 6, instance.m_model->m_mesh, instance.m_scale, instance.m_pos);
+						state.m_impl = (isInsideVolume ? ShadowVolumeImpl::DepthFail : ShadowVolumeImpl::DepthPass);
 					}
-					s_uniforms.m_svparams.m_dfail = float(ShadowVolumeImpl::DepthFail == shadowVolumeImpl);
 
 					// Compute virtual light position for shadow volume generation.
-					float transformedLightPos[3];
-					shadowVolumeLightTransform(transformedLightPos
+					shadowVolumeLightTransform(state.m_lightPos
 						, instance.m_scale
 						, instance.m_rotation
 						, instance.m_pos
 						, lightPos
 						);
 
-					// Set virtual light pos.
-					bx::memCopy(s_uniforms.m_virtualLightPos_extrusionDist, transformedLightPos, 3*sizeof(float) );
-					s_uniforms.m_virtualLightPos_extrusionDist[3] = instance.m_svExtrusionDistance;
-
 					// Compute transform for shadow volume.
-					float shadowVolumeMtx[16];
-					bx::mtxSRT(shadowVolumeMtx
+					bx::mtxSRT(state.m_mtx
 						, instance.m_scale[0]
 						, instance.m_scale[1]
 						, instance.m_scale[2]
@@ -2606,26 +1967,59 @@ public:
 						, instance.m_pos[2]
 						);
 
+					const GroupArray& groups = instance.m_model->m_mesh.m_groups;
+					for (GroupArray::const_iterator it = groups.begin(), itEnd = groups.end(); it != itEnd; ++it)
+					{
+						ShadowVolumeJob job;
+						job.m_mesh             = it->m_shadowVolume;
+						job.m_type             = m_shadowVolumeAlgorithm;
+						job.m_cap              = ShadowVolumeImpl::DepthFail == state.m_impl;
+						job.m_textureAsStencil = m_useStencilTexture;
+						bx::memCopy(job.m_light, state.m_lightPos, 3*sizeof(float) );
+
+						m_svJobs.push_back(job);
+					}
+				}
+
+				const uint32_t numJobs = uint32_t(m_svJobs.size() );
+				m_svExtractor.calcSize(m_svJobs.data(), numJobs);
+
+				m_shadowVolumes.resize(numJobs);
+
+				for (uint32_t jj = 0, job = 0; jj < shadowCastersCount[m_currentScene]; ++jj)
+				{
+					const GroupArray& groups = shadowCasters[m_currentScene][jj].m_model->m_mesh.m_groups;
+					for (uint32_t kk = 0, num = uint32_t(groups.size() ); kk < num; ++kk, ++job)
+					{
+						shadowVolumeAlloc(m_shadowVolumes[job], m_svJobs[job], casterState[jj].m_mtx);
+					}
+				}
+
+				m_svExtractor.write(m_svJobs.data(), numJobs);
+
+				for (uint32_t jj = 0, job = 0; jj < shadowCastersCount[m_currentScene]; ++jj)
+				{
+					const Instance& instance = shadowCasters[m_currentScene][jj];
+					const ShadowCasterState& state = casterState[jj];
+					Model* model = instance.m_model;
+
+					const ShadowVolumeImpl::Enum shadowVolumeImpl = state.m_impl;
+					s_uniforms.m_svparams.m_dfail = float(ShadowVolumeImpl::DepthFail == shadowVolumeImpl);
+
+					// Set virtual light pos.
+					bx::memCopy(s_uniforms.m_virtualLightPos_extrusionDist, state.m_lightPos, 3*sizeof(float) );
+					s_uniforms.m_virtualLightPos_extrusionDist[3] = instance.m_svExtrusionDistance;
+
 					GroupArray& groups = model->m_mesh.m_groups;
-					const uint16_t stride = model->m_mesh.m_layout.getStride();
-					for (GroupArray::iterator it = groups.begin(), itEnd = groups.end(); it != itEnd; ++it)
+					for (GroupArray::iterator it = groups.begin(), itEnd = groups.end(); it != itEnd; ++it, ++job)
 					{
 						Group& group = *it;
 
-						// Create shadow volume.
-						ShadowVolume shadowVolume;
-						shadowVolumeCreate(shadowVolume
-							, group
-							, stride
-							, shadowVolumeMtx
-							, transformedLightPos
-							, shadowVolumeImpl
-							, m_shadowVolumeAlgorithm
-							, m_useStencilTexture
-							);
-
-						m_numShadowVolumeVertices += shadowVolume.m_numVertices;
-						m_numShadowVolumeIndices += shadowVolume.m_numIndices;
+						const ShadowVolume& shadowVolume = m_shadowVolumes[job];
+
+						const ShadowVolumeSize& size = shadowVolume.m_size;
+						m_numShadowVolumeVertices += size.m_numSideVertices;
+						m_numShadowVolumeIndices  += size.m_numSideIndices + size.m_numFrontCapIndices + size.m_numBackCapIndices;
 
 						ShadowVolumeProgramType::Enum programIndex = ShadowVolumeProgramType::Blank;
 						RenderState::Enum renderStateIndex;
@@ -2636,7 +2030,7 @@ public:
 								: RenderState::ShadowVolume_UsingStencilTexture_CraftStencil_DepthPass
 								;
 
-							programIndex = ShadowVolumeAlgorithm::FaceBased == m_shadowVolumeAlgorithm
+							programIndex = ShadowVolumeType::FaceBased == m_shadowVolumeAlgorithm
 								? ShadowVolumeProgramType::Tex1
 								: ShadowVolumeProgramType::Tex2
 								;
@@ -2650,57 +2044,16 @@ public:
 						}
 						const RenderState& renderStateCraftStencil = s_renderStates[renderStateIndex];
 
-						s_uniforms.submitPerDrawUniforms();
-						bgfx::setTransform(shadowVolumeMtx);
-						bgfx::setVertexBuffer(0, shadowVolume.m_vbSides);
-						bgfx::setIndexBuffer(shadowVolume.m_ibSides);
-						setRenderState(renderStateCraftStencil);
-						::submit(viewId, m_svProgs[programIndex][ShadowVolumePart::Side]);
-
-						if (shadowVolume.m_cap)
-						{
-							s_uniforms.submitPerDrawUniforms();
-							bgfx::setTransform(shadowVolumeMtx);
-							bgfx::setVertexBuffer(0, group.m_vbh);
-							bgfx::setIndexBuffer(shadowVolume.m_ibFrontCap);
-							setRenderState(renderStateCraftStencil);
-							::submit(viewId, m_svProgs[programIndex][ShadowVolumePart::Front]);
-
-							s_uniforms.submitPerDrawUniforms();
-							bgfx::setTransform(shadowVolumeMtx);
-							bgfx::setVertexBuffer(0, group.m_vbh);
-							bgfx::setIndexBuffer(shadowVolume.m_ibBackCap);
-							::setRenderState(renderStateCraftStencil);
-							::submit(viewId, m_svProgs[programIndex][ShadowVolumePart::Back]);
-						}
+						shadowVolumeSubmit(viewId, shadowVolume, group, renderStateCraftStencil, m_svProgs[programIndex]);
 
 						if (m_drawShadowVolumes)
 						{
-							const RenderState& renderState = s_renderStates[RenderState::Custom_DrawShadowVolume_Lines];
-
-							s_uniforms.submitPerDrawUniforms();
-							bgfx::setTransform(shadowVolumeMtx);
-							bgfx::setVertexBuffer(0, shadowVolume.m_vbSides);
-							bgfx::setIndexBuffer(shadowVolume.m_ibSides);
-							::setRenderState(renderState);
-							::submit(VIEWID_RANGE1_PASS3, m_svProgs[ShadowVolumeProgramType::Color][ShadowVolumePart::Side]);
-
-							if (shadowVolume.m_cap)
-							{
-								s_uniforms.submitPerDrawUniforms();
-								bgfx::setTransform(shadowVolumeMtx);
-								bgfx::setVertexBuffer(0, group.m_vbh);
-								bgfx::setIndexBuffer(shadowVolume.m_ibFrontCap);
-								::setRenderState(renderState);
-								::submit(VIEWID_RANGE1_PASS3, m_svProgs[ShadowVolumeProgramType::Color][ShadowVolumePart::Front]);
-
-								s_uniforms.submitPerDrawUniforms();
-								bgfx::setTransform(shadowVolumeMtx);
-								bgfx::setVertexBuffer(0, group.m_vbh);
-								bgfx::setIndexBuffer(shadowVolume.m_ibBackCap);
-								::setRenderState(renderState);
-								::submit(VIEWID_RANGE1_PASS3, m_svProgs[ShadowVolumeProgramType::Color][ShadowVolumePart::Back]);
-							}
+							shadowVolumeSubmit(VIEWID_RANGE1_PASS3
+								, shadowVolume
+								, group
+								, s_renderStates[RenderState::Custom_DrawShadowVolume_Lines]
+								, m_svProgs[ShadowVolumeProgramType::Color]
+								);
 						}
 					}
 				}
@@ -2753,9 +2106,6 @@ public:
 			// process submitted rendering primitives.
 			bgfx::frame();
 
-			// Swap memory pages.
-			s_svAllocator.swap();
-
 			// Reset clear values.
 			setViewClearMask(UINT32_MAX
 				, BGFX_CLEAR_NONE
@@ -2818,6 +2168,10 @@ public:
 	uint32_t m_numShadowVolumeVertices;
 	uint32_t m_numShadowVolumeIndices;
 
+	ShadowVolumeExtractor m_svExtractor;
+	std::vector<ShadowVolumeJob> m_svJobs;
+	std::vector<ShadowVolume> m_shadowVolumes;
+
 	uint32_t m_oldWidth;
 	uint32_t m_oldHeight;
 
@@ -2830,7 +2184,7 @@ public:
 	bool m_useStencilTexture;
 	bool m_drawShadowVolumes;
 	ShadowVolumeImpl::Enum      m_shadowVolumeImpl;
-	ShadowVolumeAlgorithm::Enum m_shadowVolumeAlgorithm;
+	ShadowVolumeType::Enum m_shadowVolumeAlgorithm;
 
 	LightPattern m_lightPattern;
 	MeshChoice   m_currentMesh;
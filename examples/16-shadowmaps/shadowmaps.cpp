@@ -13,11 +13,13 @@
 #include <bgfx/bgfx.h>
 #include <bx/timer.h>
 #include <bx/math.h>
+#include <bx/hash.h>
 #include <bx/file.h>
 #include "entry/entry.h"
 #include "camera.h"
 #include "bgfx_utils.h"
 #include "imgui/imgui.h"
+#include "cascadedshadowmap/cascadedshadowmap.h"
 
 namespace bgfx
 {
@@ -785,6 +787,8 @@ struct Mesh : public ::Mesh
 		mem = bgfx::makeRef(_indices, size);
 		group.m_ibh = bgfx::createIndexBuffer(mem);
 
+		bx::toAabb(group.m_aabb, _vertices, _numVertices, _layout.getStride() );
+
 		m_groups.push_back(group);
 	}
 
@@ -830,6 +834,41 @@ struct Mesh : public ::Mesh
 			bgfx::submit(_viewId, _program);
 		}
 	}
+
+	void getCaster(CascadedShadowMapCaster& _outCaster, const float* _mtx) const
+	{
+		bx::Vec3 min = {  bx::kFloatLargest,  bx::kFloatLargest,  bx::kFloatLargest };
+		bx::Vec3 max = { -bx::kFloatLargest, -bx::kFloatLargest, -bx::kFloatLargest };
+
+		for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		{
+			const bx::Aabb& aabb = it->m_aabb;
+
+			// Transform corners of group bounding box to world space.
+			for (uint8_t ii = 0; ii < 8; ++ii)
+			{
+				const bx::Vec3 corner =
+				{
+					ii&1 ? aabb.max.x : aabb.min.x,
+					ii&2 ? aabb.max.y : aabb.min.y,
+					ii&4 ? aabb.max.z : aabb.min.z,
+				};
+
+				const bx::Vec3 xyz = bx::mul(corner, _mtx);
+				min = bx::min(min, xyz);
+				max = bx::max(max, xyz);
+			}
+		}
+
+		bx::store(_outCaster.m_min, min);
+		bx::store(_outCaster.m_max, max);
+
+		// Rotation inside the same bounds must dirty cascade too.
+		bx::HashMurmur2A murmur;
+		murmur.begin();
+		murmur.add(_mtx, 16*sizeof(float) );
+		_outCaster.m_version = murmur.end();
+	}
 };
 
 
@@ -910,69 +949,6 @@ void screenSpaceQuad(bool _originBottomLeft = true, float _width = 1.0f, float _
 	}
 }
 
-void worldSpaceFrustumCorners(
-	  float* _corners24f
-	, float _near
-	, float _far
-	, float _projWidth
-	, float _projHeight
-	, const float* _invViewMtx
-	)
-{
-	// Define frustum corners in view space.
-	const float nw = _near * _projWidth;
-	const float nh = _near * _projHeight;
-	const float fw = _far  * _projWidth;
-	const float fh = _far  * _projHeight;
-
-	const uint8_t numCorners = 8;
-	const bx::Vec3 corners[numCorners] =
-	{
-		{ -nw,  nh, _near },
-		{  nw,  nh, _near },
-		{  nw, -nh, _near },
-		{ -nw, -nh, _near },
-		{ -fw,  fh, _far  },
-		{  fw,  fh, _far  },
-		{  fw, -fh, _far  },
-		{ -fw, -fh, _far  },
-	};
-
-	// Convert them to world space.
-	float (*out)[3] = (float(*)[3])_corners24f;
-	for (uint8_t ii = 0; ii < numCorners; ++ii)
-	{
-		bx::store(&out[ii], bx::mul(corners[ii], _invViewMtx) );
-	}
-}
-
-/**
- * _splits = { near0, far0, near1, far1... nearN, farN }
- * N = _numSplits
- */
-void splitFrustum(float* _splits, uint8_t _numSplits, float _near, float _far, float _splitWeight = 0.75f)
-{
-	const float l = _splitWeight;
-	const float ratio = _far/_near;
-	const int8_t numSlices = _numSplits*2;
-	const float numSlicesf = float(numSlices);
-
-	// First slice.
-	_splits[0] = _near;
-
-	for (uint8_t nn = 2, ff = 1; nn < numSlices; nn+=2, ff+=2)
-	{
-		float si = float(int8_t(ff) ) / numSlicesf;
-
-		const float nearp = l*(_near*bx::pow(ratio, si) ) + (1 - l)*(_near + (_far - _near)*si);
-		_splits[nn] = nearp;          //near
-		_splits[ff] = nearp * 1.005f; //far from previous split
-	}
-
-	// Last slice.
-	_splits[numSlices-1] = _far;
-}
-
 struct Programs
 {
 	void init()
@@ -1745,10 +1721,16 @@ public:
 
 		m_timeAccumulatorLight = 0.0f;
 		m_timeAccumulatorScene = 0.0f;
+
+		// Floor, bunny, hollow cube, cube, and trees.
+		m_csm.init(16);
+		m_csmSettingsHash = 0;
 	}
 
 	virtual int shutdown() override
 	{
+		m_csm.shutdown();
+
 		m_bunnyMesh.unload();
 		m_treeMesh.unload();
 		m_cubeMesh.unload();
@@ -1799,8 +1781,6 @@ public:
 			const float camAspect  = float(int32_t(m_viewState.m_width) ) / float(int32_t(m_viewState.m_height) );
 			const float camNear    = 0.1f;
 			const float camFar     = 2000.0f;
-			const float projHeight = bx::tan(bx::toRad(camFovy)*0.5f);
-			const float projWidth  = projHeight * camAspect;
 			bx::mtxProj(m_viewState.m_proj, camFovy, camAspect, camNear, camFar, caps->homogeneousDepth);
 			cameraGetViewMtx(m_viewState.m_view);
 
@@ -2128,6 +2108,29 @@ public:
 						   );
 			}
 
+			// Shadow casters, for culling against shadow map cascades.
+			enum
+			{
+				CasterFloor,
+				CasterBunny,
+				CasterHollowcube,
+				CasterCube,
+				CasterTree,
+
+				CasterCount = CasterTree + numTrees
+			};
+
+			const uint32_t numCasters = CasterCount;
+			CascadedShadowMapCaster casters[CasterCount];
+			m_hplaneMesh.getCaster(casters[CasterFloor], mtxFloor);
+			m_bunnyMesh.getCaster(casters[CasterBunny], mtxBunny);
+			m_hollowcubeMesh.getCaster(casters[CasterHollowcube], mtxHollowcube);
+			m_cubeMesh.getCaster(casters[CasterCube], mtxCube);
+			for (uint8_t ii = 0; ii < numTrees; ++ii)
+			{
+				m_treeMesh.getCaster(casters[CasterTree+ii], mtxTrees[ii]);
+			}
+
 			// Compute transform matrices.
 			const uint8_t shadowMapPasses = ShadowMapRenderTargets::Count;
 			float lightView[shadowMapPasses][16];
@@ -2156,6 +2159,7 @@ public:
 			{
 				m_currentShadowMapSize = shadowMapSize;
 				s_uniforms.m_shadowMapTexelSize = 1.0f / currentShadowMapSizef;
+				m_csm.invalidate();
 
 				{
 					bgfx::destroy(s_rtShadowMap[0]);
@@ -2189,6 +2193,12 @@ public:
 				s_rtBlur = bgfx::createFrameBuffer(m_currentShadowMapSize, m_currentShadowMapSize, bgfx::TextureFormat::BGRA8);
 			}
 
+			if (LightType::DirectionalLight != m_settings.m_lightType)
+			{
+				// Other lights render into the same render targets.
+				m_csm.invalidate();
+			}
+
 			if (LightType::SpotLight == m_settings.m_lightType)
 			{
 				const float fovy = m_settings.m_coverageSpotL;
@@ -2295,103 +2305,55 @@ public:
 			}
 			else // LightType::DirectionalLight == settings.m_lightType
 			{
-				// Setup light view mtx.
-				const bx::Vec3 at = { 0.0f, 0.0f, 0.0f };
-				const bx::Vec3 eye =
-				{
-					-m_directionalLight.m_position.m_x,
-					-m_directionalLight.m_position.m_y,
-					-m_directionalLight.m_position.m_z,
-				};
-				bx::mtxLookAt(lightView[0], eye, at);
-
-				// Compute camera inverse view mtx.
-				float mtxViewInv[16];
-				bx::mtxInverse(mtxViewInv, m_viewState.m_view);
-
-				// Compute split distances.
-				const uint8_t maxNumSplits = 4;
-				BX_ASSERT(maxNumSplits >= m_settings.m_numSplits, "Error! Max num splits.");
-
-				float splitSlices[maxNumSplits*2];
-				splitFrustum(splitSlices
-					, uint8_t(m_settings.m_numSplits)
-					, currentSmSettings->m_near
-					, currentSmSettings->m_far
-					, m_settings.m_splitDistribution
-					);
-
-				// Update uniforms.
-				for (uint8_t ii = 0, ff = 1; ii < m_settings.m_numSplits; ++ii, ff+=2)
+				// Shadow map contents depend on these too, cached cascades are
+				// invalidated when any of them changes.
+				bx::HashMurmur2A murmur;
+				murmur.begin();
+				murmur.add(m_settings.m_depthImpl);
+				murmur.add(m_settings.m_smImpl);
+				murmur.add(currentSmSettings->m_depthValuePow);
+				murmur.add(currentSmSettings->m_xNum);
+				murmur.add(currentSmSettings->m_yNum);
+				murmur.add(currentSmSettings->m_xOffset);
+				murmur.add(currentSmSettings->m_yOffset);
+				murmur.add(currentSmSettings->m_doBlur);
+				const uint32_t csmSettingsHash = murmur.end();
+
+				if (m_csmSettingsHash != csmSettingsHash)
 				{
-					// This lags for 1 frame, but it's not a problem.
-					s_uniforms.m_csmFarDistances[ii] = splitSlices[ff];
+					m_csmSettingsHash = csmSettingsHash;
+					m_csm.invalidate();
 				}
 
-				float mtxProj[16];
-				bx::mtxOrtho(
-					  mtxProj
-					, 1.0f
-					, -1.0f
-					, 1.0f
-					, -1.0f
-					, -currentSmSettings->m_far
-					, currentSmSettings->m_far
-					, 0.0f
-					, caps->homogeneousDepth
+				CascadedShadowMapSettings csmSettings;
+				csmSettings.m_near             = currentSmSettings->m_near;
+				csmSettings.m_far              = currentSmSettings->m_far;
+				csmSettings.m_splitWeight      = m_settings.m_splitDistribution;
+				csmSettings.m_depthRange       = currentSmSettings->m_far;
+				csmSettings.m_shadowMapSize    = m_currentShadowMapSize;
+				csmSettings.m_numCascades      = uint8_t(m_settings.m_numSplits);
+				csmSettings.m_stabilize        = m_settings.m_stabilize;
+				csmSettings.m_homogeneousDepth = caps->homogeneousDepth;
+
+				m_csm.update(
+					  csmSettings
+					, m_viewState.m_view
+					, camFovy
+					, camAspect
+					, m_directionalLight.m_position.m_v
+					, casters
+					, numCasters
 					);
 
-				const uint8_t numCorners = 8;
-				float frustumCorners[maxNumSplits][numCorners][3];
-				for (uint8_t ii = 0, nn = 0, ff = 1; ii < m_settings.m_numSplits; ++ii, nn+=2, ff+=2)
-				{
-					// Compute frustum corners for one split in world space.
-					worldSpaceFrustumCorners( (float*)frustumCorners[ii], splitSlices[nn], splitSlices[ff], projWidth, projHeight, mtxViewInv);
-
-					bx::Vec3 min = {  9000.0f,  9000.0f,  9000.0f };
-					bx::Vec3 max = { -9000.0f, -9000.0f, -9000.0f };
-
-					for (uint8_t jj = 0; jj < numCorners; ++jj)
-					{
-						// Transform to light space.
-						const bx::Vec3 xyz = bx::mul(bx::load<bx::Vec3>(frustumCorners[ii][jj]), lightView[0]);
-
-						// Update bounding box.
-						min = bx::min(min, xyz);
-						max = bx::max(max, xyz);
-					}
-
-					const bx::Vec3 minproj = bx::mulH(min, mtxProj);
-					const bx::Vec3 maxproj = bx::mulH(max, mtxProj);
+				bx::memCopy(lightView[0], m_csm.getView(), 16*sizeof(float) );
 
-					float scalex = 2.0f / (maxproj.x - minproj.x);
-					float scaley = 2.0f / (maxproj.y - minproj.y);
-
-					if (m_settings.m_stabilize)
-					{
-						const float quantizer = 64.0f;
-						scalex = quantizer / bx::ceil(quantizer / scalex);
-						scaley = quantizer / bx::ceil(quantizer / scaley);
-					}
-
-					float offsetx = 0.5f * (maxproj.x + minproj.x) * scalex;
-					float offsety = 0.5f * (maxproj.y + minproj.y) * scaley;
-
-					if (m_settings.m_stabilize)
-					{
-						const float halfSize = currentShadowMapSizef * 0.5f;
-						offsetx = bx::ceil(offsetx * halfSize) / halfSize;
-						offsety = bx::ceil(offsety * halfSize) / halfSize;
-					}
-
-					float mtxCrop[16];
-					bx::mtxIdentity(mtxCrop);
-					mtxCrop[ 0] = scalex;
-					mtxCrop[ 5] = scaley;
-					mtxCrop[12] = offsetx;
-					mtxCrop[13] = offsety;
+				for (uint8_t ii = 0; ii < m_csm.getNumCascades(); ++ii)
+				{
+					const CascadedShadowMapCascade& cascade = m_csm.getCascade(ii);
+					bx::memCopy(lightProj[ii], cascade.m_proj, 16*sizeof(float) );
 
-					bx::mtxMul(lightProj[ii], mtxCrop, mtxProj);
+					// This lags for 1 frame, but it's not a problem.
+					s_uniforms.m_csmFarDistances[ii] = cascade.m_far;
 				}
 			}
 
@@ -2623,8 +2585,13 @@ public:
 
 			for (uint8_t ii = 0; ii < 4; ++ii)
 			{
+				// Cached cascade keeps contents from previous frame.
+				const bool dirty = LightType::DirectionalLight != m_settings.m_lightType
+					|| m_csm.getCascade(ii).m_dirty
+					;
+
 				bgfx::setViewClear(RENDERVIEW_SHADOWMAP_1_ID+ii
-								   , flags1
+								   , dirty ? flags1 : 0
 								   , 0xfefefefe //blur fails on completely white regions
 								   , m_clearValues.m_clearDepth
 								   , m_clearValues.m_clearStencil
@@ -2711,6 +2678,12 @@ public:
 				{
 					const uint8_t viewId = RENDERVIEW_SHADOWMAP_1_ID + ii;
 
+					if (LightType::DirectionalLight == m_settings.m_lightType
+					&&  !m_csm.getCascade(ii).m_dirty)
+					{
+						continue;
+					}
+
 					uint8_t renderStateIndex = RenderState::ShadowMap_PackDepth;
 					if(LightType::PointLight == m_settings.m_lightType && m_settings.m_stencilPack)
 					{
@@ -2718,66 +2691,90 @@ public:
 					}
 
 					// Floor.
-					m_hplaneMesh.submit(viewId
-										, mtxFloor
-										, *currentSmSettings->m_progPack
-										, s_renderStates[renderStateIndex]
-										);
+					if (isShadowCaster(CasterFloor, ii) )
+					{
+						m_hplaneMesh.submit(viewId
+											, mtxFloor
+											, *currentSmSettings->m_progPack
+											, s_renderStates[renderStateIndex]
+											);
+					}
 
 					// Bunny.
-					m_bunnyMesh.submit(viewId
-									   , mtxBunny
-									   , *currentSmSettings->m_progPack
-									   , s_renderStates[renderStateIndex]
-									   );
+					if (isShadowCaster(CasterBunny, ii) )
+					{
+						m_bunnyMesh.submit(viewId
+										   , mtxBunny
+										   , *currentSmSettings->m_progPack
+										   , s_renderStates[renderStateIndex]
+										   );
+					}
 
 					// Hollow cube.
-					m_hollowcubeMesh.submit(viewId
-											, mtxHollowcube
-											, *currentSmSettings->m_progPack
-											, s_renderStates[renderStateIndex]
-											);
+					if (isShadowCaster(CasterHollowcube, ii) )
+					{
+						m_hollowcubeMesh.submit(viewId
+												, mtxHollowcube
+												, *currentSmSettings->m_progPack
+												, s_renderStates[renderStateIndex]
+												);
+					}
 
 					// Cube.
-					m_cubeMesh.submit(viewId
-									  , mtxCube
-									  , *currentSmSettings->m_progPack
-									  , s_renderStates[renderStateIndex]
-									  );
-
-					// Trees.
-					for (uint8_t jj = 0; jj < numTrees; ++jj)
+					if (isShadowCaster(CasterCube, ii) )
 					{
-						m_treeMesh.submit(viewId
-										  , mtxTrees[jj]
+						m_cubeMesh.submit(viewId
+										  , mtxCube
 										  , *currentSmSettings->m_progPack
 										  , s_renderStates[renderStateIndex]
 										  );
 					}
+
+					// Trees.
+					for (uint8_t jj = 0; jj < numTrees; ++jj)
+					{
+						if (isShadowCaster(CasterTree+jj, ii) )
+						{
+							m_treeMesh.submit(viewId
+											  , mtxTrees[jj]
+											  , *currentSmSettings->m_progPack
+											  , s_renderStates[renderStateIndex]
+											  );
+						}
+					}
 				}
 			}
 
 			PackDepth::Enum depthType = (SmImpl::VSM == m_settings.m_smImpl) ? PackDepth::VSM : PackDepth::RGBA;
 			bool bVsmOrEsm = (SmImpl::VSM == m_settings.m_smImpl) || (SmImpl::ESM == m_settings.m_smImpl);
 
-			// Blur shadow map.
+			// Blur shadow map. Cached cascade is already blurred.
 			if (bVsmOrEsm
 				&&  currentSmSettings->m_doBlur)
 			{
-				bgfx::setTexture(4, s_shadowMap[0], bgfx::getTexture(s_rtShadowMap[0]) );
-				bgfx::setState(BGFX_STATE_WRITE_RGB|BGFX_STATE_WRITE_A);
-				screenSpaceQuad(s_originBottomLeft);
-				bgfx::submit(RENDERVIEW_VBLUR_0_ID, s_programs.m_vBlur[depthType]);
-
-				bgfx::setTexture(4, s_shadowMap[0], bgfx::getTexture(s_rtBlur) );
-				bgfx::setState(BGFX_STATE_WRITE_RGB|BGFX_STATE_WRITE_A);
-				screenSpaceQuad(s_originBottomLeft);
-				bgfx::submit(RENDERVIEW_HBLUR_0_ID, s_programs.m_hBlur[depthType]);
+				if (LightType::DirectionalLight != m_settings.m_lightType
+				||  m_csm.getCascade(0).m_dirty)
+				{
+					bgfx::setTexture(4, s_shadowMap[0], bgfx::getTexture(s_rtShadowMap[0]) );
+					bgfx::setState(BGFX_STATE_WRITE_RGB|BGFX_STATE_WRITE_A);
+					screenSpaceQuad(s_originBottomLeft);
+					bgfx::submit(RENDERVIEW_VBLUR_0_ID, s_programs.m_vBlur[depthType]);
+
+					bgfx::setTexture(4, s_shadowMap[0], bgfx::getTexture(s_rtBlur) );
+					bgfx::setState(BGFX_STATE_WRITE_RGB|BGFX_STATE_WRITE_A);
+					screenSpaceQuad(s_originBottomLeft);
+					bgfx::submit(RENDERVIEW_HBLUR_0_ID, s_programs.m_hBlur[depthType]);
+				}
 
 				if (LightType::DirectionalLight == m_settings.m_lightType)
 				{
 					for (uint8_t ii = 1, jj = 2; ii < m_settings.m_numSplits; ++ii, jj+=2)
 					{
+						if (!m_csm.getCascade(ii).m_dirty)
+						{
+							continue;
+						}
+
 						const uint8_t viewId = RENDERVIEW_VBLUR_0_ID + jj;
 
 						bgfx::setTexture(4, s_shadowMap[0], bgfx::getTexture(s_rtShadowMap[ii]) );
@@ -2793,6 +2790,19 @@ public:
 				}
 			}
 
+			// Dirty cascades were rendered and blurred, their contents are
+			// reused until they change.
+			if (LightType::DirectionalLight == m_settings.m_lightType)
+			{
+				for (uint8_t ii = 0; ii < m_csm.getNumCascades(); ++ii)
+				{
+					if (m_csm.getCascade(ii).m_dirty)
+					{
+						m_csm.markRendered(ii);
+					}
+				}
+			}
+
 			// Draw scene.
 			{
 				// Setup shadow mtx.
@@ -3048,6 +3058,13 @@ public:
 		return false;
 	}
 
+	bool isShadowCaster(uint32_t _caster, uint8_t _shadowMap) const
+	{
+		return LightType::DirectionalLight != m_settings.m_lightType
+			|| 0 != (m_csm.getCascadeMask(_caster) & (1<<_shadowMap) )
+			;
+	}
+
 	entry::MouseState m_mouseState;
 	uint32_t m_width;
 	uint32_t m_height;
@@ -3083,6 +3100,9 @@ public:
 
 	uint16_t m_currentShadowMapSize;
 
+	CascadedShadowMap m_csm;
+	uint32_t m_csmSettingsHash;
+
 	float m_timeAccumulatorLight;
 	float m_timeAccumulatorScene;
 };
@@ -119,6 +119,7 @@ public:
 		m_dim        = 16;
 		m_maxDim     = 40;
 		m_transform  = 0;
+		m_bulkSubmit = false;
 
 		m_timeOffset = bx::getHPCounter();
 
@@ -248,6 +249,28 @@ public:
 
 			const float* mod = s_mod[_tid%BX_COUNTOF(s_mod)];
 
+			bgfx::DrawDesc draws[256];
+			uint32_t numDraws = 0;
+
+			if (m_bulkSubmit)
+			{
+				bx::memSet(draws, 0, sizeof(draws) );
+
+				for (uint32_t ii = 0; ii < BX_COUNTOF(draws); ++ii)
+				{
+					bgfx::DrawDesc& draw = draws[ii];
+					draw.state         = BGFX_STATE_DEFAULT;
+					draw.numTransforms = 1;
+					draw.numVertices   = UINT32_MAX;
+					draw.numIndices    = UINT32_MAX;
+					draw.program       = m_program;
+					draw.vertexBuffer  = m_vbh;
+					draw.layout        = BGFX_INVALID_HANDLE;
+					draw.indexBuffer   = m_ibh;
+					draw.scissor       = UINT16_MAX;
+				}
+			}
+
 			float mtxS[16];
 			const float scale = 0 == m_transform ? 0.25f : 0.0f;
 			bx::mtxScale(mtxS, scale, scale, scale);
@@ -278,15 +301,34 @@ public:
 						mtx[13] = pos[1] + float(yy)*step;
 						mtx[14] = pos[2] + float(zz)*step;
 
-						encoder->setTransform(mtx);
-						encoder->setVertexBuffer(0, m_vbh);
-						encoder->setIndexBuffer(m_ibh);
-						encoder->setState(BGFX_STATE_DEFAULT);
-						encoder->submit(0, m_program);
+						if (m_bulkSubmit)
+						{
+							draws[numDraws].transform = encoder->setTransform(mtx);
+							++numDraws;
+
+							if (BX_COUNTOF(draws) == numDraws)
+							{
+								encoder->submit(0, draws, numDraws, NULL, NULL);
+								numDraws = 0;
+							}
+						}
+						else
+						{
+							encoder->setTransform(mtx);
+							encoder->setVertexBuffer(0, m_vbh);
+							encoder->setIndexBuffer(m_ibh);
+							encoder->setState(BGFX_STATE_DEFAULT);
+							encoder->submit(0, m_program);
+						}
 					}
 				}
 			}
 
+			if (0 != numDraws)
+			{
+				encoder->submit(0, draws, numDraws, NULL, NULL);
+			}
+
 			bgfx::end(encoder);
 		}
 	}
@@ -359,6 +401,7 @@ public:
 			ImGui::Separator();
 
 			ImGui::Checkbox("Auto adjust", &m_autoAdjust);
+			ImGui::Checkbox("Bulk submit", &m_bulkSubmit);
 
 			ImGui::SliderInt("Num threads", &m_numThreads, 1, m_maxThreads);
 			const uint32_t numThreads = m_numThreads;
@@ -433,6 +476,7 @@ public:
 	uint32_t m_reset;
 
 	bool     m_autoAdjust;
+	bool     m_bulkSubmit;
 	int32_t  m_scrollArea;
 	int32_t  m_dim;
 	int32_t  m_maxDim;
@@ -3,11 +3,11 @@
  * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
  */
 
-#include <bx/bounds.h>
 #include "common.h"
 #include "bgfx_utils.h"
 #include "imgui/imgui.h"
 #include "camera.h"
+#include "lightcull/lightcull.h"
 
 namespace
 {
@@ -275,6 +275,7 @@ public:
 		u_lightPosRadius = bgfx::createUniform("u_lightPosRadius", bgfx::UniformType::Vec4);
 		u_lightRgbInnerR = bgfx::createUniform("u_lightRgbInnerR", bgfx::UniformType::Vec4);
 		u_layer          = bgfx::createUniform("u_layer",          bgfx::UniformType::Vec4);
+		u_cameraView     = bgfx::createUniform("u_cameraView",     bgfx::UniformType::Mat4);
 
 		// Create program from shaders.
 		m_geomProgram    = loadProgram("vs_deferred_geom",       "fs_deferred_geom");
@@ -285,6 +286,17 @@ public:
 
 		m_useTArray = false;
 		m_useUav = false;
+		m_useClustered = false;
+
+		// Clustered shading draws all lights in single pass. Shader binary is
+		// not present until example shaders are rebuilt, in that case lights
+		// are drawn one by one.
+		m_lightClusteredProgram = BGFX_INVALID_HANDLE;
+
+		if (LightCull::isSupported() )
+		{
+			m_lightClusteredProgram = loadProgram("vs_deferred_light", "fs_deferred_light_clustered");
+		}
 
 		if (0 != (BGFX_CAPS_TEXTURE_2D_ARRAY & bgfx::getCaps()->supported) )
 		{
@@ -345,6 +357,22 @@ public:
 		m_showScissorRects = false;
 		m_showGBuffer = true;
 
+		// CPU side of light culling is also used to find scissor rect of each
+		// light when lights are drawn one by one.
+		if (!bgfx::isValid(m_lightClusteredProgram)
+		||  !m_lightCull.init(32, 32, 16, BX_COUNTOF(m_lights), 256*1024, true) )
+		{
+			if (bgfx::isValid(m_lightClusteredProgram) )
+			{
+				bgfx::destroy(m_lightClusteredProgram);
+				m_lightClusteredProgram = BGFX_INVALID_HANDLE;
+			}
+
+			m_lightCull.init(32, 32, 1, BX_COUNTOF(m_lights), 64*1024, false);
+		}
+
+		m_useClustered = bgfx::isValid(m_lightClusteredProgram);
+
 		cameraCreate();
 
 		cameraSetPosition({ 0.0f, 0.0f, -15.0f });
@@ -354,6 +382,7 @@ public:
 	virtual int shutdown() override
 	{
 		// Cleanup.
+		m_lightCull.shutdown();
 		cameraDestroy();
 		imguiDestroy();
 
@@ -389,6 +418,11 @@ public:
 			bgfx::destroy(m_clearUavProgram);
 		}
 
+		if (bgfx::isValid(m_lightClusteredProgram) )
+		{
+			bgfx::destroy(m_lightClusteredProgram);
+		}
+
 		bgfx::destroy(m_combineProgram);
 
 		if (bgfx::isValid(m_combineTaProgram) )
@@ -416,6 +450,7 @@ public:
 		bgfx::destroy(s_light);
 
 		bgfx::destroy(u_layer);
+		bgfx::destroy(u_cameraView);
 		bgfx::destroy(u_lightPosRadius);
 		bgfx::destroy(u_lightRgbInnerR);
 		bgfx::destroy(u_mtx);
@@ -483,6 +518,15 @@ public:
 				ImGui::Text("UAV is not supported.");
 			}
 
+			if (bgfx::isValid(m_lightClusteredProgram) )
+			{
+				ImGui::Checkbox("Use clustered shading.", &m_useClustered);
+			}
+			else
+			{
+				ImGui::Text("Clustered shading is not supported.");
+			}
+
 			ImGui::Checkbox("Animate mesh.", &m_animateMesh);
 			ImGui::SliderFloat("Anim.speed", &m_lightAnimationSpeed, 0.0f, 0.4f);
 
@@ -591,6 +635,7 @@ public:
 				cameraGetViewMtx(view);
 
 				// Setup views
+				float proj[16];
 				float vp[16];
 				float invMvp[16];
 				{
@@ -610,7 +655,6 @@ public:
 						bgfx::setViewFrameBuffer(kRenderPassLight, BGFX_INVALID_HANDLE);
 					}
 
-					float proj[16];
 					bx::mtxProj(proj, 60.0f, float(m_width)/float(m_height), 0.1f, 100.0f, m_caps->homogeneousDepth);
 
 					bgfx::setViewFrameBuffer(kRenderPassGeometry, m_gbuffer);
@@ -621,18 +665,19 @@ public:
 
 					const bgfx::Caps* caps = bgfx::getCaps();
 
-					bx::mtxOrtho(proj, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 100.0f, 0.0f, caps->homogeneousDepth);
-					bgfx::setViewTransform(kRenderPassClearUav, NULL, proj);
-					bgfx::setViewTransform(kRenderPassLight,    NULL, proj);
-					bgfx::setViewTransform(kRenderPassCombine,  NULL, proj);
+					float ortho[16];
+					bx::mtxOrtho(ortho, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 100.0f, 0.0f, caps->homogeneousDepth);
+					bgfx::setViewTransform(kRenderPassClearUav, NULL, ortho);
+					bgfx::setViewTransform(kRenderPassLight,    NULL, ortho);
+					bgfx::setViewTransform(kRenderPassCombine,  NULL, ortho);
 
 					const float aspectRatio = float(m_height)/float(m_width);
 					const float size = 10.0f;
-					bx::mtxOrtho(proj, -size, size, size*aspectRatio, -size*aspectRatio, 0.0f, 1000.0f, 0.0f, caps->homogeneousDepth);
-					bgfx::setViewTransform(kRenderPassDebugGBuffer, NULL, proj);
+					bx::mtxOrtho(ortho, -size, size, size*aspectRatio, -size*aspectRatio, 0.0f, 1000.0f, 0.0f, caps->homogeneousDepth);
+					bgfx::setViewTransform(kRenderPassDebugGBuffer, NULL, ortho);
 
-					bx::mtxOrtho(proj, 0.0f, (float)m_width, 0.0f, (float)m_height, 0.0f, 1000.0f, 0.0f, caps->homogeneousDepth);
-					bgfx::setViewTransform(kRenderPassDebugLights, NULL, proj);
+					bx::mtxOrtho(ortho, 0.0f, (float)m_width, 0.0f, (float)m_height, 0.0f, 1000.0f, 0.0f, caps->homogeneousDepth);
+					bgfx::setViewTransform(kRenderPassDebugLights, NULL, ortho);
 				}
 
 				const uint32_t dim = 11;
@@ -691,146 +736,160 @@ public:
 					bgfx::submit(kRenderPassClearUav, m_clearUavProgram);
 				}
 
-				// Draw lights into light buffer.
+				// Animate lights.
 				for (int32_t light = 0; light < m_numLights; ++light)
 				{
-					bx::Sphere lightPosRadius;
-
 					float lightTime = time * m_lightAnimationSpeed * (bx::sin(light/float(m_numLights) * bx::kPiHalf ) * 0.5f + 0.5f);
-					lightPosRadius.center.x = bx::sin( ( (lightTime + light*0.47f) + bx::kPiHalf*1.37f ) )*offset;
-					lightPosRadius.center.y = bx::cos( ( (lightTime + light*0.69f) + bx::kPiHalf*1.49f ) )*offset;
-					lightPosRadius.center.z = bx::sin( ( (lightTime + light*0.37f) + bx::kPiHalf*1.57f ) )*2.0f;
-					lightPosRadius.radius   = 2.0f;
 
-					bx::Aabb aabb;
-					toAabb(aabb, lightPosRadius);
+					LightCullLight& lcl = m_lights[light];
+					lcl.m_posRadius[0] = bx::sin( ( (lightTime + light*0.47f) + bx::kPiHalf*1.37f ) )*offset;
+					lcl.m_posRadius[1] = bx::cos( ( (lightTime + light*0.69f) + bx::kPiHalf*1.49f ) )*offset;
+					lcl.m_posRadius[2] = bx::sin( ( (lightTime + light*0.37f) + bx::kPiHalf*1.57f ) )*2.0f;
+					lcl.m_posRadius[3] = 2.0f;
+
+					uint8_t val = light&7;
+					lcl.m_rgbInner[0] = val & 0x1 ? 1.0f : 0.25f;
+					lcl.m_rgbInner[1] = val & 0x2 ? 1.0f : 0.25f;
+					lcl.m_rgbInner[2] = val & 0x4 ? 1.0f : 0.25f;
+					lcl.m_rgbInner[3] = 0.8f;
+				}
 
-					const bx::Vec3 box[8] =
-					{
-						{ aabb.min.x, aabb.min.y, aabb.min.z },
-						{ aabb.min.x, aabb.min.y, aabb.max.z },
-						{ aabb.min.x, aabb.max.y, aabb.min.z },
-						{ aabb.min.x, aabb.max.y, aabb.max.z },
-						{ aabb.max.x, aabb.min.y, aabb.min.z },
-						{ aabb.max.x, aabb.min.y, aabb.max.z },
-						{ aabb.max.x, aabb.max.y, aabb.min.z },
-						{ aabb.max.x, aabb.max.y, aabb.max.z },
-					};
-
-					bx::Vec3 xyz = bx::mulH(box[0], vp);
-					bx::Vec3 min = xyz;
-					bx::Vec3 max = xyz;
-
-					for (uint32_t ii = 1; ii < 8; ++ii)
-					{
-						xyz = bx::mulH(box[ii], vp);
-						min = bx::min(min, xyz);
-						max = bx::max(max, xyz);
-					}
+				// Cull lights against screen tiles, lights outside of view
+				// frustum are not visible.
+				m_lightCull.bin(view, proj, 0.1f, 100.0f, m_lights, uint32_t(m_numLights) );
 
-					// Cull light if it's fully behind camera.
-					if (max.z >= 0.0f)
-					{
-						const float x0 = bx::clamp( (min.x * 0.5f + 0.5f) * m_width,  0.0f, (float)m_width);
-						const float y0 = bx::clamp( (min.y * 0.5f + 0.5f) * m_height, 0.0f, (float)m_height);
-						const float x1 = bx::clamp( (max.x * 0.5f + 0.5f) * m_width,  0.0f, (float)m_width);
-						const float y1 = bx::clamp( (max.y * 0.5f + 0.5f) * m_height, 0.0f, (float)m_height);
+				// Clustered shading samples G-buffer as 2D textures, and writes
+				// into light buffer frame buffer.
+				const bool clustered = bgfx::isValid(m_lightClusteredProgram)
+					&& m_useClustered
+					&& !m_useTArray
+					&& !m_useUav
+					;
 
-						if (m_showScissorRects)
-						{
-							bgfx::TransientVertexBuffer tvb;
-							bgfx::TransientIndexBuffer tib;
-							if (bgfx::allocTransientBuffers(&tvb, DebugVertex::ms_layout, 4, &tib, 8) )
-							{
-								uint32_t abgr = 0x8000ff00;
-
-								DebugVertex* vertex = (DebugVertex*)tvb.data;
-								vertex->m_x = x0;
-								vertex->m_y = y0;
-								vertex->m_z = 0.0f;
-								vertex->m_abgr = abgr;
-								++vertex;
-
-								vertex->m_x = x1;
-								vertex->m_y = y0;
-								vertex->m_z = 0.0f;
-								vertex->m_abgr = abgr;
-								++vertex;
-
-								vertex->m_x = x1;
-								vertex->m_y = y1;
-								vertex->m_z = 0.0f;
-								vertex->m_abgr = abgr;
-								++vertex;
-
-								vertex->m_x = x0;
-								vertex->m_y = y1;
-								vertex->m_z = 0.0f;
-								vertex->m_abgr = abgr;
-
-								uint16_t* indices = (uint16_t*)tib.data;
-								*indices++ = 0;
-								*indices++ = 1;
-								*indices++ = 1;
-								*indices++ = 2;
-								*indices++ = 2;
-								*indices++ = 3;
-								*indices++ = 3;
-								*indices++ = 0;
-
-								bgfx::setVertexBuffer(0, &tvb);
-								bgfx::setIndexBuffer(&tib);
-								bgfx::setState(0
-									| BGFX_STATE_WRITE_RGB
-									| BGFX_STATE_PT_LINES
-									| BGFX_STATE_BLEND_ALPHA
-									);
-								bgfx::submit(kRenderPassDebugLights, m_lineProgram);
-							}
-						}
+				if (clustered)
+				{
+					m_lightCull.upload();
+
+					bgfx::setUniform(u_mtx, invMvp);
+					bgfx::setUniform(u_cameraView, view);
+					bgfx::setTexture(0, s_normal, bgfx::getTexture(m_gbuffer, 1) );
+					bgfx::setTexture(1, s_depth,  bgfx::getTexture(m_gbuffer, 2) );
+					m_lightCull.setBindings(2, 3, 4);
+					bgfx::setState(0
+						| BGFX_STATE_WRITE_RGB
+						| BGFX_STATE_WRITE_A
+						);
+					screenSpaceQuad(m_caps->originBottomLeft);
+					bgfx::submit(kRenderPassLight, m_lightClusteredProgram);
+				}
 
-						uint8_t val = light&7;
-						float lightRgbInnerR[4] =
-						{
-							val & 0x1 ? 1.0f : 0.25f,
-							val & 0x2 ? 1.0f : 0.25f,
-							val & 0x4 ? 1.0f : 0.25f,
-							0.8f,
-						};
-
-						// Draw light.
-						bgfx::setUniform(u_lightPosRadius, &lightPosRadius);
-						bgfx::setUniform(u_lightRgbInnerR, lightRgbInnerR);
-						bgfx::setUniform(u_mtx, invMvp);
-						const uint16_t scissorHeight = uint16_t(y1-y0);
-						bgfx::setScissor(uint16_t(x0), uint16_t(m_height-scissorHeight-y0), uint16_t(x1-x0), uint16_t(scissorHeight) );
-						bgfx::setTexture(0, s_normal, bgfx::getTexture(m_gbuffer, 1) );
-						bgfx::setTexture(1, s_depth,  bgfx::getTexture(m_gbuffer, 2) );
-						bgfx::setState(0
-							| BGFX_STATE_WRITE_RGB
-							| BGFX_STATE_WRITE_A
-							| BGFX_STATE_BLEND_ADD
-							);
-						screenSpaceQuad(m_caps->originBottomLeft);
+				const float tileWidth  = float(m_width) /float(m_lightCull.getTilesX() );
+				const float tileHeight = float(m_height)/float(m_lightCull.getTilesY() );
 
-						if (bgfx::isValid(m_lightTaProgram)
-						&&  m_useTArray)
-						{
-							bgfx::submit(kRenderPassLight, m_lightTaProgram);
-						}
-						else if (bgfx::isValid(m_lightUavProgram)
-							 &&  m_useUav)
-						{
-							bgfx::setViewFrameBuffer(kRenderPassLight, BGFX_INVALID_HANDLE);
-							bgfx::setState(0);
-							bgfx::setImage(3, m_lightBufferTex, 0, bgfx::Access::ReadWrite, bgfx::TextureFormat::RGBA8);
-							bgfx::submit(kRenderPassLight, m_lightUavProgram);
-						}
-						else
+				// Draw lights into light buffer.
+				for (uint32_t ii = 0, num = m_lightCull.getNumVisibleLights(); ii < num; ++ii)
+				{
+					const LightCullLight& light = m_lights[m_lightCull.getVisibleLight(ii)];
+
+					// Scissor rect around screen tiles overlapped by light.
+					uint16_t tiles[4];
+					m_lightCull.getVisibleLightTiles(ii, tiles);
+
+					const float x0 = float(tiles[0])*tileWidth;
+					const float y0 = float(tiles[1])*tileHeight;
+					const float x1 = bx::min(float(tiles[2]+1)*tileWidth,  float(m_width) );
+					const float y1 = bx::min(float(tiles[3]+1)*tileHeight, float(m_height) );
+
+					if (m_showScissorRects)
+					{
+						bgfx::TransientVertexBuffer tvb;
+						bgfx::TransientIndexBuffer tib;
+						if (bgfx::allocTransientBuffers(&tvb, DebugVertex::ms_layout, 4, &tib, 8) )
 						{
-							bgfx::submit(kRenderPassLight, m_lightProgram);
+							uint32_t abgr = 0x8000ff00;
+
+							DebugVertex* vertex = (DebugVertex*)tvb.data;
+							vertex->m_x = x0;
+							vertex->m_y = y0;
+							vertex->m_z = 0.0f;
+							vertex->m_abgr = abgr;
+							++vertex;
+
+							vertex->m_x = x1;
+							vertex->m_y = y0;
+							vertex->m_z = 0.0f;
+							vertex->m_abgr = abgr;
+							++vertex;
+
+							vertex->m_x = x1;
+							vertex->m_y = y1;
+							vertex->m_z = 0.0f;
+							vertex->m_abgr = abgr;
+							++vertex;
+
+							vertex->m_x = x0;
+							vertex->m_y = y1;
+							vertex->m_z = 0.0f;
+							vertex->m_abgr = abgr;
+
+							uint16_t* indices = (uint16_t*)tib.data;
+							*indices++ = 0;
+							*indices++ = 1;
+							*indices++ = 1;
+							*indices++ = 2;
+							*indices++ = 2;
+							*indices++ = 3;
+							*indices++ = 3;
+							*indices++ = 0;
+
+							bgfx::setVertexBuffer(0, &tvb);
+							bgfx::setIndexBuffer(&tib);
+							bgfx::setState(0
+								| BGFX_STATE_WRITE_RGB
+								| BGFX_STATE_PT_LINES
+								| BGFX_STATE_BLEND_ALPHA
+								);
+							bgfx::submit(kRenderPassDebugLights, m_lineProgram);
 						}
 					}
+
+					if (clustered)
+					{
+						continue;
+					}
+
+					// Draw light.
+					bgfx::setUniform(u_lightPosRadius, light.m_posRadius);
+					bgfx::setUniform(u_lightRgbInnerR, light.m_rgbInner);
+					bgfx::setUniform(u_mtx, invMvp);
+					const uint16_t scissorHeight = uint16_t(y1-y0);
+					bgfx::setScissor(uint16_t(x0), uint16_t(m_height-scissorHeight-y0), uint16_t(x1-x0), uint16_t(scissorHeight) );
+					bgfx::setTexture(0, s_normal, bgfx::getTexture(m_gbuffer, 1) );
+					bgfx::setTexture(1, s_depth,  bgfx::getTexture(m_gbuffer, 2) );
+					bgfx::setState(0
+						| BGFX_STATE_WRITE_RGB
+						| BGFX_STATE_WRITE_A
+						| BGFX_STATE_BLEND_ADD
+						);
+					screenSpaceQuad(m_caps->originBottomLeft);
+
+					if (bgfx::isValid(m_lightTaProgram)
+					&&  m_useTArray)
+					{
+						bgfx::submit(kRenderPassLight, m_lightTaProgram);
+					}
+					else if (bgfx::isValid(m_lightUavProgram)
+						 &&  m_useUav)
+					{
+						bgfx::setViewFrameBuffer(kRenderPassLight, BGFX_INVALID_HANDLE);
+						bgfx::setState(0);
+						bgfx::setImage(3, m_lightBufferTex, 0, bgfx::Access::ReadWrite, bgfx::TextureFormat::RGBA8);
+						bgfx::submit(kRenderPassLight, m_lightUavProgram);
+					}
+					else
+					{
+						bgfx::submit(kRenderPassLight, m_lightProgram);
+					}
 				}
 
 				// Combine color and light buffers.
@@ -914,12 +973,14 @@ public:
 	bgfx::UniformHandle u_lightPosRadius;
 	bgfx::UniformHandle u_lightRgbInnerR;
 	bgfx::UniformHandle u_layer;
+	bgfx::UniformHandle u_cameraView;
 
 	bgfx::ProgramHandle m_geomProgram;
 	bgfx::ProgramHandle m_lightProgram;
 	bgfx::ProgramHandle m_lightTaProgram;
 	bgfx::ProgramHandle m_lightUavProgram;
 	bgfx::ProgramHandle m_clearUavProgram;
+	bgfx::ProgramHandle m_lightClusteredProgram;
 	bgfx::ProgramHandle m_combineProgram;
 	bgfx::ProgramHandle m_combineTaProgram;
 	bgfx::ProgramHandle m_debugProgram;
@@ -948,6 +1009,8 @@ public:
 	bool m_useUav;
 	bool m_oldUseUav;
 
+	bool m_useClustered;
+
 	int32_t m_scrollArea;
 	int32_t m_numLights;
 	float m_lightAnimationSpeed;
@@ -955,6 +1018,9 @@ public:
 	bool m_showScissorRects;
 	bool m_showGBuffer;
 
+	LightCull m_lightCull;
+	LightCullLight m_lights[2048];
+
 	entry::MouseState m_mouseState;
 
 	const bgfx::Caps* m_caps;
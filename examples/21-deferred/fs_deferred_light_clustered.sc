@@ -0,0 +1,53 @@
+$input v_texcoord0
+
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "common.sh"
+
+#define LIGHTCULL_GRID_STAGE  2
+#define LIGHTCULL_INDEX_STAGE 3
+#define LIGHTCULL_LIGHT_STAGE 4
+#include "../common/lightcull/lightcull.sh"
+
+SAMPLER2D(s_normal, 0);
+SAMPLER2D(s_depth,  1);
+
+uniform mat4 u_mtx;
+uniform mat4 u_cameraView;
+
+void main()
+{
+	vec3  normal      = decodeNormalUint(texture2D(s_normal, v_texcoord0).xyz);
+	float deviceDepth = texture2D(s_depth, v_texcoord0).x;
+	float depth       = toClipSpaceDepth(deviceDepth);
+
+	vec3 clip = vec3(v_texcoord0 * 2.0 - 1.0, depth);
+#if !BGFX_SHADER_LANGUAGE_GLSL
+	clip.y = -clip.y;
+#endif // !BGFX_SHADER_LANGUAGE_GLSL
+	vec3 wpos = clipToWorld(u_mtx, clip);
+
+	vec3 view = mul(u_view, vec4(wpos, 0.0) ).xyz;
+	view = -normalize(view);
+
+	float viewZ   = mul(u_cameraView, vec4(wpos, 1.0) ).z;
+	vec2  cluster = lightCullGetCluster(clip.xy, viewZ);
+
+	// Same as blending each light into light buffer with fs_deferred_light.
+	vec3 lightColor = vec3_splat(0.0);
+
+	for (int ii = 0; ii < int(cluster.y); ++ii)
+	{
+		uint light     = lightCullGetLightIndex(cluster, ii);
+		vec4 posRadius = lightCullGetLightPosRadius(light);
+		vec4 rgbInner  = lightCullGetLightRgbInner(light);
+
+		lightColor += toGamma(calcLight(wpos, normal, view, posRadius.xyz, posRadius.w, rgbInner.xyz, rgbInner.w) );
+	}
+
+	gl_FragColor.xyz = lightColor;
+	gl_FragColor.w = 1.0;
+}
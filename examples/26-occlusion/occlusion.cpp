@@ -128,7 +128,9 @@ public:
 		m_program = loadProgram("vs_cubes", "fs_cubes");
 
 		const bgfx::Caps* caps = bgfx::getCaps();
-		m_occlusionQuerySupported = !!(caps->supported & BGFX_CAPS_OCCLUSION_QUERY);
+		m_occlusionQuerySupported    = !!(caps->supported & BGFX_CAPS_OCCLUSION_QUERY);
+		m_conditionalRenderSupported = !!(caps->supported & BGFX_CAPS_CONDITIONAL_RENDER);
+		m_gpuCondition = m_conditionalRenderSupported;
 
 		if (m_occlusionQuerySupported)
 		{
@@ -193,6 +195,33 @@ public:
 				: NULL
 				);
 
+			if (m_occlusionQuerySupported)
+			{
+				ImGui::SetNextWindowPos(
+					  ImVec2(m_width - m_width / 5.0f - 10.0f, 10.0f)
+					, ImGuiCond_FirstUseEver
+					);
+				ImGui::SetNextWindowSize(
+					  ImVec2(m_width / 5.0f, m_height / 6.0f)
+					, ImGuiCond_FirstUseEver
+					);
+				ImGui::Begin("Settings"
+					, NULL
+					, 0
+					);
+
+				if (m_conditionalRenderSupported)
+				{
+					ImGui::Checkbox("GPU condition", &m_gpuCondition);
+				}
+				else
+				{
+					ImGui::Text("Conditional render is not supported.");
+				}
+
+				ImGui::End();
+			}
+
 			imguiEndFrame();
 
 			if (m_occlusionQuerySupported)
@@ -263,10 +292,12 @@ public:
 							);
 						bgfx::submit(1, m_program, occlusionQuery);
 
+						// Query is issued in view 1, so only draws in later
+						// views can be predicated with this frame's result.
 						bgfx::setTransform(mtx);
 						bgfx::setVertexBuffer(0, m_vbh);
 						bgfx::setIndexBuffer(m_ibh);
-						bgfx::setCondition(occlusionQuery, true);
+						bgfx::setCondition(occlusionQuery, true, m_gpuCondition);
 						bgfx::setState(BGFX_STATE_DEFAULT);
 						bgfx::submit(2, m_program);
 
@@ -307,6 +338,8 @@ public:
 	bgfx::ProgramHandle m_program;
 	int64_t m_timeOffset;
 	bool m_occlusionQuerySupported;
+	bool m_conditionalRenderSupported;
+	bool m_gpuCondition;
 
 	bgfx::OcclusionQueryHandle m_occlusionQueries[CUBES_DIM*CUBES_DIM];
 
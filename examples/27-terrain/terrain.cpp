@@ -10,11 +10,14 @@
 #include "bgfx_utils.h"
 #include "imgui/imgui.h"
 #include "camera.h"
+#include "terrainlod/terrainlod.h"
 
 namespace
 {
 
-static const uint16_t s_terrainSize = 256;
+// Height map is power of two plus one samples, as required by TerrainLod.
+static const uint16_t s_terrainSize = 257;
+static const uint16_t s_terrainLeafSize = 16;
 
 struct PosTexCoord0Vertex
 {
@@ -47,8 +50,9 @@ struct TerrainData
 
 	PosTexCoord0Vertex*  m_vertices;
 	uint32_t             m_vertexCount;
-	uint16_t*            m_indices;
 	uint32_t             m_indexCount;
+	float                m_lodRange;
+	bool                 m_wireframe;
 };
 
 struct BrushData
@@ -110,9 +114,7 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 		m_timeOffset = bx::getHPCounter();
 
 		m_vbh.idx = bgfx::kInvalidHandle;
-		m_ibh.idx = bgfx::kInvalidHandle;
 		m_dvbh.idx = bgfx::kInvalidHandle;
-		m_dibh.idx = bgfx::kInvalidHandle;
 		m_heightTexture.idx = bgfx::kInvalidHandle;
 		s_heightTexture = bgfx::createUniform("s_heightTexture", bgfx::UniformType::Sampler);
 
@@ -129,12 +131,17 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 		m_terrain.m_mode      = 0;
 		m_terrain.m_dirty     = true;
 		m_terrain.m_vertices  = (PosTexCoord0Vertex*)bx::alloc(entry::getAllocator(), num * sizeof(PosTexCoord0Vertex) );
-		m_terrain.m_indices   = (uint16_t*)bx::alloc(entry::getAllocator(), num * sizeof(uint16_t) * 6);
 		m_terrain.m_heightMap = (uint8_t*)bx::alloc(entry::getAllocator(), num);
+		m_terrain.m_vertexCount = num;
+		m_terrain.m_indexCount  = 0;
+		m_terrain.m_lodRange    = 32.0f;
+		m_terrain.m_wireframe   = false;
 
 		bx::mtxSRT(m_terrain.m_transform, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
 		bx::memSet(m_terrain.m_heightMap, 0, sizeof(uint8_t) * s_terrainSize * s_terrainSize);
 
+		m_lod.init(s_terrainSize, s_terrainLeafSize, 1.0f, m_terrain.m_heightMap, entry::getAllocator() );
+
 		cameraCreate();
 
 		cameraSetPosition({ s_terrainSize/2.0f, 100.0f, 0.0f });
@@ -144,24 +151,16 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 	virtual int shutdown() override
 	{
 		// Cleanup.
+		m_lod.shutdown();
+
 		cameraDestroy();
 		imguiDestroy();
 
-		if (bgfx::isValid(m_ibh) )
-		{
-			bgfx::destroy(m_ibh);
-		}
-
 		if (bgfx::isValid(m_vbh) )
 		{
 			bgfx::destroy(m_vbh);
 		}
 
-		if (bgfx::isValid(m_dibh) )
-		{
-			bgfx::destroy(m_dibh);
-		}
-
 		if (bgfx::isValid(m_dvbh) )
 		{
 			bgfx::destroy(m_dvbh);
@@ -183,7 +182,6 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 
 		bx::AllocatorI* allocator = entry::getAllocator();
 		bx::free(allocator, m_terrain.m_vertices);
-		bx::free(allocator, m_terrain.m_indices);
 		bx::free(allocator, m_terrain.m_heightMap);
 
 		// Shutdown bgfx.
@@ -192,97 +190,68 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 		return 0;
 	}
 
-	void updateTerrainMesh()
+	void updateTerrainMesh(const TerrainRect& _rect)
 	{
-		m_terrain.m_vertexCount = 0;
-		for (uint32_t y = 0; y < s_terrainSize; y++)
+		for (uint32_t y = _rect.m_y, ey = y + _rect.m_height; y < ey; y++)
 		{
-			for (uint32_t x = 0; x < s_terrainSize; x++)
+			for (uint32_t x = _rect.m_x, ex = x + _rect.m_width; x < ex; x++)
 			{
-				PosTexCoord0Vertex* vert = &m_terrain.m_vertices[m_terrain.m_vertexCount];
+				PosTexCoord0Vertex* vert = &m_terrain.m_vertices[(y * s_terrainSize) + x];
 				vert->m_x = (float)x;
 				vert->m_y = m_terrain.m_heightMap[(y * s_terrainSize) + x];
 				vert->m_z = (float)y;
 				vert->m_u = (x + 0.5f) / s_terrainSize;
 				vert->m_v = (y + 0.5f) / s_terrainSize;
-
-				m_terrain.m_vertexCount++;
-			}
-		}
-
-		m_terrain.m_indexCount = 0;
-		for (uint16_t y = 0; y < (s_terrainSize - 1); y++)
-		{
-			uint16_t y_offset = (y * s_terrainSize);
-			for (uint16_t x = 0; x < (s_terrainSize - 1); x++)
-			{
-				m_terrain.m_indices[m_terrain.m_indexCount + 0] = y_offset + x + 1;
-				m_terrain.m_indices[m_terrain.m_indexCount + 1] = y_offset + x + s_terrainSize;
-				m_terrain.m_indices[m_terrain.m_indexCount + 2] = y_offset + x;
-				m_terrain.m_indices[m_terrain.m_indexCount + 3] = y_offset + x + s_terrainSize + 1;
-				m_terrain.m_indices[m_terrain.m_indexCount + 4] = y_offset + x + s_terrainSize;
-				m_terrain.m_indices[m_terrain.m_indexCount + 5] = y_offset + x + 1;
-
-				m_terrain.m_indexCount += 6;
 			}
 		}
 	}
 
-	void updateTerrain()
+	void updateTerrain(const TerrainRect& _rect)
 	{
 		const bgfx::Memory* mem;
 
+		m_lod.updateHeights(m_terrain.m_heightMap, _rect);
+
 		switch (m_terrain.m_mode)
 		{
 		default: // Vertex Buffer : Destroy and recreate a regular vertex buffer to update terrain.
-			updateTerrainMesh();
+			updateTerrainMesh(_rect);
 
 			if (bgfx::isValid(m_vbh) )
 			{
 				bgfx::destroy(m_vbh);
 			}
 
-			mem = bgfx::makeRef(&m_terrain.m_vertices[0], sizeof(PosTexCoord0Vertex) * m_terrain.m_vertexCount);
+			mem = bgfx::copy(&m_terrain.m_vertices[0], sizeof(PosTexCoord0Vertex) * m_terrain.m_vertexCount);
 			m_vbh = bgfx::createVertexBuffer(mem, PosTexCoord0Vertex::ms_layout);
-			if (bgfx::isValid(m_ibh) )
-			{
-				bgfx::destroy(m_ibh);
-			}
-
-			mem = bgfx::makeRef(&m_terrain.m_indices[0], sizeof(uint16_t) * m_terrain.m_indexCount);
-			m_ibh = bgfx::createIndexBuffer(mem);
 			break;
 
 		case 1: // Dynamic Vertex Buffer : Utilize dynamic vertex buffer to update terrain.
-			updateTerrainMesh();
-
-			if (!bgfx::isValid(m_dvbh) )
 			{
-				m_dvbh = bgfx::createDynamicVertexBuffer(m_terrain.m_vertexCount, PosTexCoord0Vertex::ms_layout);
-			}
+				updateTerrainMesh(_rect);
 
-			mem = bgfx::makeRef(&m_terrain.m_vertices[0], sizeof(PosTexCoord0Vertex) * m_terrain.m_vertexCount);
-			bgfx::update(m_dvbh, 0, mem);
+				if (!bgfx::isValid(m_dvbh) )
+				{
+					m_dvbh = bgfx::createDynamicVertexBuffer(m_terrain.m_vertexCount, PosTexCoord0Vertex::ms_layout);
+				}
 
-			if (!bgfx::isValid(m_dibh) )
-			{
-				m_dibh = bgfx::createDynamicIndexBuffer(m_terrain.m_indexCount);
-			}
+				// Upload only vertices from first to last modified one.
+				const uint32_t first = _rect.m_y * s_terrainSize + _rect.m_x;
+				const uint32_t last  = (_rect.m_y + _rect.m_height - 1) * s_terrainSize + _rect.m_x + _rect.m_width;
 
-			mem = bgfx::makeRef(&m_terrain.m_indices[0], sizeof(uint16_t) * m_terrain.m_indexCount);
-			bgfx::update(m_dibh, 0, mem);
+				mem = bgfx::copy(&m_terrain.m_vertices[first], sizeof(PosTexCoord0Vertex) * (last - first) );
+				bgfx::update(m_dvbh, first, mem);
+			}
 			break;
 
 		case 2: // Height Texture: Update a height texture that is sampled in the terrain vertex shader.
-			if (!bgfx::isValid(m_vbh) || !bgfx::isValid(m_ibh) )
+			if (!bgfx::isValid(m_vbh) )
 			{
-				updateTerrainMesh();
+				const TerrainRect rect = { 0, 0, s_terrainSize, s_terrainSize };
+				updateTerrainMesh(rect);
 
-				mem = bgfx::makeRef(&m_terrain.m_vertices[0], sizeof(PosTexCoord0Vertex) * m_terrain.m_vertexCount);
+				mem = bgfx::copy(&m_terrain.m_vertices[0], sizeof(PosTexCoord0Vertex) * m_terrain.m_vertexCount);
 				m_vbh = bgfx::createVertexBuffer(mem, PosTexCoord0Vertex::ms_layout);
-
-				mem = bgfx::makeRef(&m_terrain.m_indices[0], sizeof(uint16_t) * m_terrain.m_indexCount);
-				m_ibh = bgfx::createIndexBuffer(mem);
 			}
 
 			if (!bgfx::isValid(m_heightTexture) )
@@ -290,14 +259,71 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 				m_heightTexture = bgfx::createTexture2D(s_terrainSize, s_terrainSize, false, 1, bgfx::TextureFormat::R8);
 			}
 
-			mem = bgfx::makeRef(&m_terrain.m_heightMap[0], sizeof(uint8_t) * s_terrainSize * s_terrainSize);
-			bgfx::updateTexture2D(m_heightTexture, 0, 0, 0, 0, s_terrainSize, s_terrainSize, mem);
+			// Upload only modified texels.
+			mem = bgfx::alloc(_rect.m_width * _rect.m_height);
+			bx::memCopy(
+				  mem->data
+				, _rect.m_width
+				, &m_terrain.m_heightMap[_rect.m_y * s_terrainSize + _rect.m_x]
+				, s_terrainSize
+				, _rect.m_width
+				, _rect.m_height
+				);
+			bgfx::updateTexture2D(m_heightTexture, 0, 0, _rect.m_x, _rect.m_y, _rect.m_width, _rect.m_height, mem);
 			break;
 		}
 	}
 
+	void submitTerrain(bgfx::ProgramHandle _program)
+	{
+		float viewProj[16];
+		bx::mtxMul(viewProj, m_viewMtx, m_projMtx);
+
+		const bx::Vec3 eye = cameraGetPosition();
+		const float eyePos[3] = { eye.x, eye.y, eye.z };
+
+		const uint32_t numPatches = m_lod.select(viewProj, eyePos, m_terrain.m_lodRange);
+
+		m_terrain.m_indexCount = 0;
+		for (uint32_t ii = 0; ii < numPatches; ++ii)
+		{
+			m_terrain.m_indexCount += m_lod.getNumIndices(m_lod.getPatch(ii) );
+		}
+
+		// Terrain has more than 64K vertices, 32-bit indices are required.
+		if (0 == m_terrain.m_indexCount
+		||  m_terrain.m_indexCount != bgfx::getAvailTransientIndexBuffer(m_terrain.m_indexCount, true) )
+		{
+			bgfx::discard();
+			return;
+		}
+
+		bgfx::TransientIndexBuffer tib;
+		bgfx::allocTransientIndexBuffer(&tib, m_terrain.m_indexCount, true);
+
+		uint32_t* indices = (uint32_t*)tib.data;
+		for (uint32_t ii = 0; ii < numPatches; ++ii)
+		{
+			indices += m_lod.writeIndices(indices, m_lod.getPatch(ii) );
+		}
+
+		bgfx::setIndexBuffer(&tib);
+		bgfx::submit(0, _program);
+	}
+
 	void paintTerrainHeight(uint32_t _x, uint32_t _y)
 	{
+		const int32_t x0 = bx::max(int32_t(_x) - m_brush.m_size, 0);
+		const int32_t y0 = bx::max(int32_t(_y) - m_brush.m_size, 0);
+		const int32_t x1 = bx::min(int32_t(_x) + m_brush.m_size, int32_t(s_terrainSize) );
+		const int32_t y1 = bx::min(int32_t(_y) + m_brush.m_size, int32_t(s_terrainSize) );
+
+		if (x0 < x1
+		&&  y0 < y1)
+		{
+			m_dirtyRects.add(uint16_t(x0), uint16_t(y0), uint16_t(x1 - x0), uint16_t(y1 - y0) );
+		}
+
 		for (int32_t area_y = -m_brush.m_size; area_y < m_brush.m_size; ++area_y)
 		{
 			for (int32_t area_x = -m_brush.m_size; area_x < m_brush.m_size; ++area_x)
@@ -331,7 +357,6 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 					;
 
 				m_terrain.m_heightMap[heightMapPos] = (uint8_t)bx::clamp(height, 0.0f, 255.0f);
-				m_terrain.m_dirty = true;
 			}
 		}
 	}
@@ -431,6 +456,26 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 			ImGui::SliderInt("Brush Size", &m_brush.m_size, 1, 50);
 			ImGui::SliderFloat("Brush Power", &m_brush.m_power, 0.0f, 1.0f);
 
+			ImGui::Separator();
+
+			ImGui::SliderFloat("LOD Range", &m_terrain.m_lodRange, 8.0f, 128.0f);
+
+			// Wireframe can be toggled by entry input bindings too, debug
+			// flags are source of truth.
+			m_terrain.m_wireframe = 0 != (m_debug & BGFX_DEBUG_WIREFRAME);
+
+			if (ImGui::Checkbox("Wireframe", &m_terrain.m_wireframe) )
+			{
+				m_debug = m_terrain.m_wireframe
+					? m_debug |  BGFX_DEBUG_WIREFRAME
+					: m_debug & ~BGFX_DEBUG_WIREFRAME
+					;
+				bgfx::setDebug(m_debug);
+			}
+
+			ImGui::Text("Patches: %d", m_lod.getNumPatches() );
+			ImGui::Text("Triangles: %d", m_terrain.m_indexCount/3);
+
 			ImGui::End();
 			imguiEndFrame();
 
@@ -445,12 +490,23 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 				}
 			}
 
-			// Update terrain.
+			// Update terrain. Whole terrain is uploaded only when mode changes,
+			// otherwise only rectangles modified by brush.
 			if (m_terrain.m_dirty)
 			{
-				updateTerrain();
+				const TerrainRect rect = { 0, 0, s_terrainSize, s_terrainSize };
+				updateTerrain(rect);
 				m_terrain.m_dirty = false;
 			}
+			else
+			{
+				for (uint8_t ii = 0, num = m_dirtyRects.getNum(); ii < num; ++ii)
+				{
+					updateTerrain(m_dirtyRects.get(ii) );
+				}
+			}
+
+			m_dirtyRects.reset();
 
 			// Set view 0 default viewport.
 			bgfx::setViewRect(0, 0, 0, uint16_t(m_width), uint16_t(m_height) );
@@ -465,21 +521,18 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 			{
 			default:
 				bgfx::setVertexBuffer(0, m_vbh);
-				bgfx::setIndexBuffer(m_ibh);
-				bgfx::submit(0, m_terrainProgram);
+				submitTerrain(m_terrainProgram);
 				break;
 
 			case 1:
 				bgfx::setVertexBuffer(0, m_dvbh);
-				bgfx::setIndexBuffer(m_dibh);
-				bgfx::submit(0, m_terrainProgram);
+				submitTerrain(m_terrainProgram);
 				break;
 
 			case 2:
 				bgfx::setVertexBuffer(0, m_vbh);
-				bgfx::setIndexBuffer(m_ibh);
 				bgfx::setTexture(0, s_heightTexture, m_heightTexture);
-				bgfx::submit(0, m_terrainHeightTextureProgram);
+				submitTerrain(m_terrainHeightTextureProgram);
 				break;
 			}
 
@@ -494,9 +547,7 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 	}
 
 	bgfx::VertexBufferHandle m_vbh;
-	bgfx::IndexBufferHandle m_ibh;
 	bgfx::DynamicVertexBufferHandle m_dvbh;
-	bgfx::DynamicIndexBufferHandle m_dibh;
 	bgfx::ProgramHandle m_terrainProgram;
 	bgfx::ProgramHandle m_terrainHeightTextureProgram;
 	bgfx::UniformHandle s_heightTexture;
@@ -517,6 +568,9 @@ ExampleTerrain(const char* _name, const char* _description, const char* _url)
 	TerrainData m_terrain;
 	BrushData m_brush;
 
+	TerrainLod m_lod;
+	TerrainDirtyRects m_dirtyRects;
+
 	entry::MouseState m_mouseState;
 
 	int64_t m_timeOffset;
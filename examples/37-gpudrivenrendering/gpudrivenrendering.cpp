@@ -14,15 +14,14 @@
 #include "common.h"
 #include "bgfx_utils.h"
 #include "imgui/imgui.h"
+#include "hizcull/hizcull.h"
 
 namespace
 {
 
-#define RENDER_PASS_HIZ_ID            0
-#define RENDER_PASS_HIZ_DOWNSCALE_ID  1
-#define RENDER_PASS_OCCLUDE_PROPS_ID  2
-#define RENDER_PASS_COMPACT_STREAM_ID 3
-#define RENDER_PASS_MAIN_ID           4
+#define RENDER_PASS_HIZ_ID  0
+#define RENDER_PASS_CULL_ID 1
+#define RENDER_PASS_MAIN_ID 2
 
 struct Camera
 {
@@ -318,10 +317,6 @@ public:
 		m_width  = _width;
 		m_height = _height;
 
-		//find largest pow of two dims less than backbuffer size
-		m_hiZwidth  = (uint32_t)bx::pow(2.0f, bx::floor(bx::log2(float(m_width ) ) ) );
-		m_hiZheight = (uint32_t)bx::pow(2.0f, bx::floor(bx::log2(float(m_height) ) ) );
-
 		m_debug  = BGFX_DEBUG_TEXT;
 		m_reset  = BGFX_RESET_VSYNC;
 
@@ -339,11 +334,8 @@ public:
 		// Enable debug text.
 		bgfx::setDebug(m_debug);
 
-		// Create uniforms and samplers.
-		u_inputRTSize       = bgfx::createUniform("u_inputRTSize",       bgfx::UniformType::Vec4);
-		u_cullingConfig     = bgfx::createUniform("u_cullingConfig",     bgfx::UniformType::Vec4);
-		u_color             = bgfx::createUniform("u_color",             bgfx::UniformType::Vec4, 32);
-		s_texOcclusionDepth = bgfx::createUniform("s_texOcclusionDepth", bgfx::UniformType::Sampler);
+		// Create uniforms.
+		u_color = bgfx::createUniform("u_color", bgfx::UniformType::Vec4, 32);
 
 		//create props
 		{
@@ -503,114 +495,13 @@ public:
 
 		//Setup Occlusion pass
 		{
-			const uint64_t tsFlags = 0
-				| BGFX_TEXTURE_RT
-				| BGFX_SAMPLER_MIN_POINT
-				| BGFX_SAMPLER_MAG_POINT
-				| BGFX_SAMPLER_MIP_POINT
-				| BGFX_SAMPLER_U_CLAMP
-				| BGFX_SAMPLER_V_CLAMP
-				;
-
-			// Create buffers for the HiZ pass
-			m_hiZDepthBuffer = bgfx::createFrameBuffer(uint16_t(m_hiZwidth), uint16_t(m_hiZheight), bgfx::TextureFormat::D32F, tsFlags);
-
-			bgfx::TextureHandle buffer = bgfx::createTexture2D(uint16_t(m_hiZwidth), uint16_t(m_hiZheight), true, 1, bgfx::TextureFormat::R32F, BGFX_TEXTURE_COMPUTE_WRITE | tsFlags);
-			m_hiZBuffer = bgfx::createFrameBuffer(1, &buffer, true);
-
-			//how many mip will the Hi Z buffer have?
-			m_noofHiZMips = (uint8_t)(1 + bx::floor(bx::log2(float(bx::max(m_hiZwidth, m_hiZheight) ) ) ) );
-
-			// Setup compute shader buffers
-
-			//The compute shader will write how many unoccluded instances per drawcall there are here
-			m_drawcallInstanceCounts = bgfx::createDynamicIndexBuffer(s_maxNoofProps, BGFX_BUFFER_INDEX32 | BGFX_BUFFER_COMPUTE_READ_WRITE);
-
-			//the compute shader will write the result of the occlusion test for each instance here
-			m_instancePredicates = bgfx::createDynamicIndexBuffer(s_maxNoofInstances, BGFX_BUFFER_COMPUTE_READ_WRITE);
-
-			//bounding box for each instance, will be fed to the compute shader to calculate occlusion
-			{
-				bgfx::VertexLayout computeVertexLayout;
-				computeVertexLayout.begin()
-					.add(bgfx::Attrib::TexCoord0, 4, bgfx::AttribType::Float)
-					.end();
-
-				//initialise the buffer with the bounding boxes of all instances
-				const int sizeOfBuffer = 2 * 4 * m_totalInstancesCount;
-				float* boundingBoxes = new float[sizeOfBuffer];
-
-				float* data = boundingBoxes;
-				for (uint16_t i = 0; i < m_noofProps; i++)
-				{
-					Prop& prop = m_props[i];
-
-					const uint32_t numInstances = prop.m_noofInstances;
-
-					for (uint32_t j = 0; j < numInstances; j++)
-					{
-						bx::memCopy(data, prop.m_instances[j].m_bboxMin, 3 * sizeof(float));
-						data[3] = (float)i; // store the drawcall ID here to avoid creating a separate buffer
-						data += 4;
-
-						bx::memCopy(data, prop.m_instances[j].m_bboxMax, 3 * sizeof(float));
-						data += 4;
-					}
-				}
-
-				const bgfx::Memory* mem = bgfx::makeRef(boundingBoxes, sizeof(float) * sizeOfBuffer);
-
-				m_instanceBoundingBoxes = bgfx::createDynamicVertexBuffer(mem, computeVertexLayout, BGFX_BUFFER_COMPUTE_READ);
-			}
-
-			//pre and post occlusion culling instance data buffers
-			{
-				bgfx::VertexLayout instanceBufferVertexLayout;
-				instanceBufferVertexLayout.begin()
-					.add(bgfx::Attrib::TexCoord0, 4, bgfx::AttribType::Float)
-					.add(bgfx::Attrib::TexCoord1, 4, bgfx::AttribType::Float)
-					.add(bgfx::Attrib::TexCoord2, 4, bgfx::AttribType::Float)
-					.add(bgfx::Attrib::TexCoord3, 4, bgfx::AttribType::Float)
-					.end();
-
-				//initialise the buffer with data for all instances
-				//Currently we only store a world matrix (16 floats)
-				const int sizeOfBuffer = 16 * m_totalInstancesCount;
-				float* instanceData = new float[sizeOfBuffer];
-
-				float* data = instanceData;
-				for (uint16_t ii = 0; ii < m_noofProps; ++ii)
-				{
-					Prop& prop = m_props[ii];
-
-					const uint32_t numInstances = prop.m_noofInstances;
-
-					for (uint32_t jj = 0; jj < numInstances; ++jj)
-					{
-						bx::memCopy(data, prop.m_instances[jj].m_world, 16 * sizeof(float) );
-						data[3] = float(ii); // store the drawcall ID here to avoid creating a separate buffer
-						data += 16;
-					}
-				}
-
-				const bgfx::Memory* mem = bgfx::makeRef(instanceData, sizeof(float) * sizeOfBuffer);
-
-				//pre occlusion buffer
-				m_instanceBuffer = bgfx::createVertexBuffer(mem, instanceBufferVertexLayout, BGFX_BUFFER_COMPUTE_READ);
-
-				//post occlusion buffer
-				m_culledInstanceBuffer = bgfx::createDynamicVertexBuffer(4 * m_totalInstancesCount, instanceBufferVertexLayout, BGFX_BUFFER_COMPUTE_WRITE);
-			}
-
-			//we use one "drawcall" per prop to render all its instances
-			m_indirectBuffer = bgfx::createIndirectBuffer(m_noofProps);
+			// Hi-Z culling, builds Hi-Z mip chain from occluder depth, culls
+			// instances against it, and writes indirect draws of visible ones.
+			m_hiZCull.init(m_totalInstancesCount, s_maxNoofProps);
+			m_hiZCull.resize(uint16_t(m_width), uint16_t(m_height) );
 
 			// Create programs from shaders for occlusion pass.
-			m_programOcclusionPass    = loadProgram("vs_gdr_render_occlusion", NULL);
-			m_programCopyZ            = loadProgram("cs_gdr_copy_z", NULL);
-			m_programDownscaleHiZ     = loadProgram("cs_gdr_downscale_hi_z", NULL);
-			m_programOccludeProps     = loadProgram("cs_gdr_occlude_props", NULL);
-			m_programStreamCompaction = loadProgram("cs_gdr_stream_compaction", NULL);
+			m_programOcclusionPass = loadProgram("vs_gdr_render_occlusion", NULL);
 
 			// Set view RENDER_PASS_HIZ_ID clear state.
 			bgfx::setViewClear(RENDER_PASS_HIZ_ID
@@ -651,7 +542,9 @@ public:
 		// CPU data to fill the master buffers
 		m_allPropVerticesDataCPU = new PosVertex[totalNoofVertices];
 		m_allPropIndicesDataCPU = new uint16_t[totalNoofIndices];
-		m_indirectBufferDataCPU = new uint32_t[m_noofProps * 3];
+
+		// One group, drawn with single indirect draw call, per prop.
+		HiZCullGroup groups[s_maxNoofProps];
 
 		// Copy data over to the master buffers
 		PosVertex* propVerticesData = m_allPropVerticesDataCPU;
@@ -670,9 +563,9 @@ public:
 			propVerticesData += prop.m_noofVertices;
 			propIndicesData += prop.m_noofIndices;
 
-			m_indirectBufferDataCPU[ i * 3 ] = prop.m_noofIndices;
-			m_indirectBufferDataCPU[ i * 3 + 1] = indexBufferOffset;
-			m_indirectBufferDataCPU[ i * 3 + 2] = vertexBufferOffset;
+			groups[i].m_numIndices = prop.m_noofIndices;
+			groups[i].m_startIndex = indexBufferOffset;
+			groups[i].m_baseVertex = vertexBufferOffset;
 
 			indexBufferOffset += prop.m_noofIndices;
 			vertexBufferOffset += prop.m_noofVertices;
@@ -689,16 +582,38 @@ public:
 					bgfx::makeRef(m_allPropIndicesDataCPU, totalNoofIndices * sizeof(uint16_t) )
 					);
 
-		// Create buffer with const drawcall data which will be copied to the indirect buffer later.
-		m_indirectBufferData = bgfx::createIndexBuffer(
-			bgfx::makeRef(m_indirectBufferDataCPU, m_noofProps * 3 * sizeof(uint32_t)),
-			BGFX_BUFFER_COMPUTE_READ | BGFX_BUFFER_INDEX32
-		);
+		m_hiZCull.setGroups(groups, m_noofProps);
+
+		// Bounding box and instance data of all instances.
+		{
+			HiZCullInstance* instances = new HiZCullInstance[m_totalInstancesCount];
+
+			HiZCullInstance* instance = instances;
+			for (uint16_t ii = 0; ii < m_noofProps; ++ii)
+			{
+				Prop& prop = m_props[ii];
+
+				for (uint32_t jj = 0; jj < prop.m_noofInstances; ++jj)
+				{
+					bx::memCopy(instance->m_min, prop.m_instances[jj].m_bboxMin, 3 * sizeof(float) );
+					bx::memCopy(instance->m_max, prop.m_instances[jj].m_bboxMax, 3 * sizeof(float) );
+					instance->m_group = ii;
+
+					//Currently we only store a world matrix (16 floats)
+					bx::memCopy(instance->m_data, prop.m_instances[jj].m_world, 16 * sizeof(float) );
+					instance->m_data[3] = float(prop.m_materialID); // store the material ID here to avoid creating a separate buffer
+					++instance;
+				}
+			}
+
+			m_hiZCull.setInstances(instances, m_totalInstancesCount);
+
+			delete[] instances;
+		}
 
 		m_timeOffset = bx::getHPCounter();
 
 		m_useIndirect = true;
-		m_firstFrame = true;
 
 		imguiCreate();
 	}
@@ -711,10 +626,8 @@ public:
 
 		bgfx::destroy(m_programMainPass);
 		bgfx::destroy(m_programOcclusionPass);
-		bgfx::destroy(m_programCopyZ);
-		bgfx::destroy(m_programDownscaleHiZ);
-		bgfx::destroy(m_programOccludeProps);
-		bgfx::destroy(m_programStreamCompaction);
+
+		m_hiZCull.shutdown();
 
 		for (uint16_t i = 0; i < m_noofProps; i++)
 		{
@@ -730,27 +643,13 @@ public:
 
 		delete[] m_props;
 
-		bgfx::destroy(m_hiZDepthBuffer);
-		bgfx::destroy(m_hiZBuffer);
-		bgfx::destroy(m_indirectBuffer);
-		bgfx::destroy(m_indirectBufferData);
-		bgfx::destroy(m_instanceBoundingBoxes);
-		bgfx::destroy(m_drawcallInstanceCounts);
-		bgfx::destroy(m_instancePredicates);
-		bgfx::destroy(m_instanceBuffer);
-		bgfx::destroy(m_culledInstanceBuffer);
-
 		bgfx::destroy(m_allPropsVertexbufferHandle);
 		bgfx::destroy(m_allPropsIndexbufferHandle);
 
-		bgfx::destroy(s_texOcclusionDepth);
-		bgfx::destroy(u_inputRTSize);
-		bgfx::destroy(u_cullingConfig);
 		bgfx::destroy(u_color);
 
 		delete[] m_allPropVerticesDataCPU;
 		delete[] m_allPropIndicesDataCPU;
-		delete[] m_indirectBufferDataCPU;
 
 		// Shutdown bgfx.
 		bgfx::shutdown();
@@ -762,12 +661,15 @@ public:
 	void renderOcclusionBufferPass()
 	{
 		// Setup the occlusion pass projection
-		bx::mtxProj(m_occlusionProj, 60.0f, float(m_hiZwidth) / float(m_hiZheight), 0.1f, 500.0f, bgfx::getCaps()->homogeneousDepth);
+		const uint16_t width  = m_hiZCull.getWidth();
+		const uint16_t height = m_hiZCull.getHeight();
+
+		bx::mtxProj(m_occlusionProj, 60.0f, float(width) / float(height), 0.1f, 500.0f, bgfx::getCaps()->homogeneousDepth);
 
 		bgfx::setViewTransform(RENDER_PASS_HIZ_ID, m_mainView, m_occlusionProj);
 
-		bgfx::setViewFrameBuffer(RENDER_PASS_HIZ_ID, m_hiZDepthBuffer);
-		bgfx::setViewRect(RENDER_PASS_HIZ_ID, 0, 0, uint16_t(m_hiZwidth), uint16_t(m_hiZheight));
+		bgfx::setViewFrameBuffer(RENDER_PASS_HIZ_ID, m_hiZCull.getOcclusionFrameBuffer() );
+		bgfx::setViewRect(RENDER_PASS_HIZ_ID, 0, 0, width, height);
 
 		const uint16_t instanceStride = sizeof(InstanceData);
 
@@ -813,94 +715,6 @@ public:
 		}
 	}
 
-	// downscale the occluder depth buffer to create a mipmap chain
-	void renderDownscalePass()
-	{
-		uint32_t width = m_hiZwidth;
-		uint32_t height = m_hiZheight;
-
-		// copy mip zero over to the hi Z buffer.
-		// We can't currently use blit as it requires same format and CopyResource is not exposed.
-		{
-			float inputRendertargetSize[4] = { (float)width, (float)height, 0.0f, 0.0f };
-			bgfx::setUniform(u_inputRTSize, inputRendertargetSize);
-
-			bgfx::setTexture(0, s_texOcclusionDepth, getTexture(m_hiZDepthBuffer, 0));
-			bgfx::setImage(1, getTexture(m_hiZBuffer,      0), 0, bgfx::Access::Write);
-
-			bgfx::dispatch(RENDER_PASS_HIZ_DOWNSCALE_ID, m_programCopyZ, width/16, height/16);
-		}
-
-		for (uint8_t lod = 1; lod < m_noofHiZMips; ++lod)
-		{
-			float inputRendertargetSize[4] = { (float)width, (float)height, 2.0f, 2.0f };
-			bgfx::setUniform(u_inputRTSize, inputRendertargetSize);
-
-			// down scale mip 1 onwards
-			width /= 2;
-			height /= 2;
-
-			bgfx::setImage(0, getTexture(m_hiZBuffer, 0), lod - 1, bgfx::Access::Read);
-			bgfx::setImage(1, getTexture(m_hiZBuffer, 0), lod,     bgfx::Access::Write);
-
-			bgfx::dispatch(RENDER_PASS_HIZ_DOWNSCALE_ID, m_programDownscaleHiZ, width/16, height/16);
-		}
-	}
-
-	// perform the occlusion using the mip chain
-	void renderOccludePropsPass()
-	{
-		// run the computer shader to determine visibility of each instance
-		bgfx::setTexture(0, s_texOcclusionDepth, bgfx::getTexture(m_hiZBuffer, 0) );
-
-		bgfx::setBuffer(1, m_instanceBoundingBoxes,  bgfx::Access::Read);
-		bgfx::setBuffer(2, m_drawcallInstanceCounts, bgfx::Access::ReadWrite);
-		bgfx::setBuffer(3, m_instancePredicates,     bgfx::Access::Write);
-
-		float inputRendertargetSize[4] = { (float)m_hiZwidth, (float)m_hiZheight, 1.0f/ m_hiZwidth, 1.0f/ m_hiZheight };
-		bgfx::setUniform(u_inputRTSize, inputRendertargetSize);
-
-		// store a rounded-up, power of two instance count for the stream compaction step
-		float noofInstancesPowOf2 = bx::pow(2.0f, bx::floor(bx::log(m_totalInstancesCount) / bx::log(2.0f) ) + 1.0f);
-
-		float cullingConfig[4] =
-		{
-			(float)m_totalInstancesCount,
-			noofInstancesPowOf2,
-			(float)m_noofHiZMips,
-			(float)m_noofProps
-		};
-		bgfx::setUniform(u_cullingConfig, cullingConfig);
-
-		//set the view/projection transforms so that the compute shader can receive the viewProjection matrix automagically
-		bgfx::setViewTransform(RENDER_PASS_OCCLUDE_PROPS_ID, m_mainView, m_occlusionProj);
-
-		uint16_t groupX = bx::max<uint16_t>(m_totalInstancesCount / 64 + 1, 1);
-
-		bgfx::dispatch(RENDER_PASS_OCCLUDE_PROPS_ID, m_programOccludeProps, groupX, 1, 1);
-
-		// perform stream compaction to remove occluded instances
-
-		// the per drawcall data that is constant (noof indices/vertices and offsets to vertex/index buffers)
-	 	bgfx::setBuffer(0, m_indirectBufferData, bgfx::Access::Read);
-		// instance data for all instances (pre culling)
-		bgfx::setBuffer(1, m_instanceBuffer, bgfx::Access::Read);
-		// per instance visibility (output of culling pass)
-		bgfx::setBuffer(2, m_instancePredicates, bgfx::Access::Read);
-
-		// how many instances per drawcall
-		bgfx::setBuffer(3, m_drawcallInstanceCounts, bgfx::Access::ReadWrite);
-		// drawcall data that will drive drawIndirect
-		bgfx::setBuffer(4, m_indirectBuffer, bgfx::Access::ReadWrite);
-		// culled instance data
-		bgfx::setBuffer(5, m_culledInstanceBuffer, bgfx::Access::Write);
-
-		bgfx::setUniform(u_cullingConfig, cullingConfig);
-
-		bgfx::dispatch(RENDER_PASS_COMPACT_STREAM_ID, m_programStreamCompaction, 1, 1, 1);
-
-	}
-
 	// render the unoccluded props to the screen
 	void renderMainPass()
 	{
@@ -920,18 +734,20 @@ public:
 		// Set "material" data (currently a color only)
 		bgfx::setUniform(u_color, &m_materials[0].m_color, m_noofMaterials);
 
-		// We can't use indirect drawing for the first frame because the content of m_drawcallInstanceCounts
-		// is initially undefined.
-		if (m_useIndirect && !m_firstFrame)
+		if (m_useIndirect)
 		{
-			// Set vertex and index buffer.
-			bgfx::setVertexBuffer(0, m_allPropsVertexbufferHandle);
-			bgfx::setIndexBuffer( m_allPropsIndexbufferHandle);
+			// Each batch of culled instances has its own indirect draws.
+			for (uint16_t ii = 0, num = m_hiZCull.getNumBatches(); ii < num; ++ii)
+			{
+				// Set vertex and index buffer.
+				bgfx::setVertexBuffer(0, m_allPropsVertexbufferHandle);
+				bgfx::setIndexBuffer( m_allPropsIndexbufferHandle);
 
-			// Set instance data buffer.
-			bgfx::setInstanceDataBuffer(m_culledInstanceBuffer,  0,  m_totalInstancesCount );
+				// Set instance data buffer.
+				bgfx::setInstanceDataBuffer(m_hiZCull.getInstanceBuffer(ii), 0, m_hiZCull.getNumInstances(ii) );
 
-			bgfx::submit(RENDER_PASS_MAIN_ID, m_programMainPass, m_indirectBuffer, 0, m_noofProps);
+				bgfx::submit(RENDER_PASS_MAIN_ID, m_programMainPass, m_hiZCull.getIndirectBuffer(ii), 0, m_hiZCull.getNumGroups() );
+			}
 		}
 		else
 		{
@@ -973,7 +789,6 @@ public:
 				}
 			}
 		}
-		m_firstFrame = false;
 	}
 
 	bool update() override
@@ -1054,18 +869,25 @@ public:
 				bool blink = uint32_t(time*3.0f)&1;
 				bgfx::dbgTextPrintf(0, 0, blink ? 0x1f : 0x01, " Instancing is not supported by GPU. ");
 			}
+			else if (!HiZCull::isSupported() )
+			{
+				float time = (float)((bx::getHPCounter() - m_timeOffset) / double(bx::getHPFrequency()));
+				bool blink = uint32_t(time*3.0f)&1;
+				bgfx::dbgTextPrintf(0, 0, blink ? 0x1f : 0x01, " Hi-Z culling is not supported by GPU. ");
+			}
 			else
 			{
 				// calculate main view and project matrices as they are typically reused between passes.
 				m_camera.mtxLookAt(m_mainView);
 				bx::mtxProj(m_mainProj, 60.0f, float(m_width) / float(m_height), 0.1f, 500.0f, bgfx::getCaps()->homogeneousDepth);
 
+				// Hi-Z follows back buffer size.
+				m_hiZCull.resize(uint16_t(m_width), uint16_t(m_height) );
+
 				//submit drawcalls for all passes
 				renderOcclusionBufferPass();
 
-				renderDownscalePass();
-
-				renderOccludePropsPass();
+				m_hiZCull.cull(RENDER_PASS_CULL_ID, m_mainView, m_occlusionProj);
 
 				renderMainPass();
 			}
@@ -1084,8 +906,6 @@ public:
 
 	uint32_t m_width;
 	uint32_t m_height;
-	uint32_t m_hiZwidth;
-	uint32_t m_hiZheight;
 	uint32_t m_debug;
 	uint32_t m_reset;
 
@@ -1095,32 +915,15 @@ public:
 
 	bgfx::ProgramHandle m_programMainPass;
 	bgfx::ProgramHandle m_programOcclusionPass;
-	bgfx::ProgramHandle m_programCopyZ;
-	bgfx::ProgramHandle m_programDownscaleHiZ;
-	bgfx::ProgramHandle m_programOccludeProps;
-	bgfx::ProgramHandle m_programStreamCompaction;
 
-	bgfx::FrameBufferHandle m_hiZDepthBuffer;
-	bgfx::FrameBufferHandle m_hiZBuffer;
-	bgfx::IndirectBufferHandle m_indirectBuffer;
+	HiZCull m_hiZCull;
 
 	bgfx::VertexBufferHandle m_allPropsVertexbufferHandle;
 	bgfx::IndexBufferHandle  m_allPropsIndexbufferHandle;
-	bgfx::IndexBufferHandle m_indirectBufferData;
 
 	PosVertex* m_allPropVerticesDataCPU;
 	uint16_t* m_allPropIndicesDataCPU;
-	uint32_t* m_indirectBufferDataCPU;
 
-	bgfx::DynamicVertexBufferHandle m_instanceBoundingBoxes;
-	bgfx::DynamicIndexBufferHandle m_drawcallInstanceCounts;
-	bgfx::DynamicIndexBufferHandle m_instancePredicates;
-	bgfx::VertexBufferHandle m_instanceBuffer;
-	bgfx::DynamicVertexBufferHandle m_culledInstanceBuffer;
-
-	bgfx::UniformHandle s_texOcclusionDepth;
-	bgfx::UniformHandle u_inputRTSize;
-	bgfx::UniformHandle u_cullingConfig;
 	bgfx::UniformHandle u_color;
 
 	Prop*	m_props;
@@ -1131,14 +934,9 @@ public:
 
 	static const uint16_t s_maxNoofProps = 10;
 
-	static const uint16_t s_maxNoofInstances = 2048;
-
 	int64_t m_timeOffset;
 
-	uint8_t m_noofHiZMips;
-
 	bool m_useIndirect;
-	bool m_firstFrame;
 
 	Camera m_camera;
 	Mouse m_mouse;
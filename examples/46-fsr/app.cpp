@@ -201,6 +201,8 @@ struct AppState
 	// UI parameters
 	bool m_renderNativeResolution = false;
 	bool m_animateScene = false;
+	bool m_dynamicResolution = false;
+	float m_targetGpuMs = 8.0f;
 	int32_t m_antiAliasingSetting = 2;
 
 	Fsr m_fsr;
@@ -536,6 +538,14 @@ public:
 				++view;
 			}
 
+			// Scale picked by dynamic resolution controller for this frame. Scene
+			// view rect is scaled by bgfx, and FSR source size is scaled here.
+			const float resolutionScale = m_state.m_dynamicResolution && !m_state.m_renderNativeResolution
+				? bgfx::getStats()->resolutionScale
+				: 1.0f
+				;
+			m_state.m_fsr.m_config.m_resolutionScale = resolutionScale;
+
 			// Draw models into scene
 			{
 				bgfx::setViewName(view, "forward scene");
@@ -552,6 +562,7 @@ public:
 				bgfx::setViewRect(view, 0, viewRectY, viewRectWidth, viewRectHeight);
 				bgfx::setViewTransform(view, m_state.m_view, m_state.m_proj);
 				bgfx::setViewFrameBuffer(view, m_state.m_frameBuffer);
+				bgfx::setViewDynamicResolution(view, m_state.m_dynamicResolution && !m_state.m_renderNativeResolution);
 
 				bgfx::setState(0
 					| BGFX_STATE_WRITE_RGB
@@ -613,6 +624,8 @@ public:
 
 			const ImVec2 itemSize = ImGui::GetItemRectSize();
 
+			bool dynamicResolutionChanged = false;
+
 			{
 				ImGui::Checkbox("Animate scene", &m_state.m_animateScene);
 
@@ -621,7 +634,7 @@ public:
 					resize();
 				}
 
-				ImGui::Checkbox("Render native resolution", &m_state.m_renderNativeResolution);
+				dynamicResolutionChanged |= ImGui::Checkbox("Render native resolution", &m_state.m_renderNativeResolution);
 
 				if (ImGui::IsItemHovered() )
 				{
@@ -642,6 +655,19 @@ public:
 						ImGui::EndTooltip();
 					}
 
+					dynamicResolutionChanged |= ImGui::Checkbox("Dynamic resolution", &m_state.m_dynamicResolution);
+
+					if (ImGui::IsItemHovered() )
+					{
+						ImGui::SetTooltip("Scale scene resolution further to keep GPU frame time at target.");
+					}
+
+					if (m_state.m_dynamicResolution)
+					{
+						dynamicResolutionChanged |= ImGui::SliderFloat("Target GPU time", &m_state.m_targetGpuMs, 1.0f, 33.0f, "%.1f ms");
+						ImGui::Text("Resolution scale: %.3f", resolutionScale);
+					}
+
 					ImGui::Separator();
 
 					if (m_state.m_fsr.supports16BitPrecision() )
@@ -691,6 +717,13 @@ public:
 
 			imguiEndFrame();
 
+			if (dynamicResolutionChanged)
+			{
+				// Target of 0 disables controller.
+				const bool enabled = m_state.m_dynamicResolution && !m_state.m_renderNativeResolution;
+				bgfx::setDynamicResolution(enabled ? m_state.m_targetGpuMs : 0.0f, 0.5f, 1.0f);
+			}
+
 			// Advance to next frame. Rendering thread will be kicked to
 			// process submitted rendering primitives.
 			m_state.m_currFrame = bgfx::frame();
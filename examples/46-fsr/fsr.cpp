@@ -333,8 +333,9 @@ bool Fsr::supports16BitPrecision() const
 
 void Fsr::updateUniforms()
 {
-	const float srcWidth = float(m_resources->m_width) / m_config.m_superSamplingFactor;
-	const float srcHeight = float(m_resources->m_height) / m_config.m_superSamplingFactor;
+	const float srcScale = m_config.m_resolutionScale / m_config.m_superSamplingFactor;
+	const float srcWidth = float(m_resources->m_width) * srcScale;
+	const float srcHeight = float(m_resources->m_height) * srcScale;
 
 	m_resources->m_uniforms.ViewportSizeRcasAttenuation.x = srcWidth;
 	m_resources->m_uniforms.ViewportSizeRcasAttenuation.y = srcHeight;
@@ -18,6 +18,7 @@ public:
 	struct Config
 	{
 		float m_superSamplingFactor = 2.0f;
+		float m_resolutionScale     = 1.0f; // Dynamic resolution scale of source image, see bgfx::Stats::resolutionScale.
 		float m_rcasAttenuation     = 0.2f;
 		bool  m_applyFsr            = true;
 		bool  m_applyFsrRcas        = true;
@@ -124,7 +124,13 @@ static bgfx::ShaderHandle loadShader(bx::FileReaderI* _reader, const bx::StringV
 
 	filePath.join(fileName);
 
-	bgfx::ShaderHandle handle = bgfx::createShader(loadMem(_reader, filePath.getCPtr() ) );
+	const bgfx::Memory* mem = loadMem(_reader, filePath.getCPtr() );
+	if (NULL == mem)
+	{
+		return BGFX_INVALID_HANDLE;
+	}
+
+	bgfx::ShaderHandle handle = bgfx::createShader(mem);
 	bgfx::setName(handle, _name.getPtr(), _name.getLength() );
 
 	return handle;
@@ -142,6 +148,22 @@ bgfx::ProgramHandle loadProgram(bx::FileReaderI* _reader, const bx::StringView&
 	if (!_fsName.isEmpty() )
 	{
 		fsh = loadShader(_reader, _fsName);
+
+		if (!bgfx::isValid(vsh)
+		||  !bgfx::isValid(fsh) )
+		{
+			if (bgfx::isValid(vsh) )
+			{
+				bgfx::destroy(vsh);
+			}
+
+			if (bgfx::isValid(fsh) )
+			{
+				bgfx::destroy(fsh);
+			}
+
+			return BGFX_INVALID_HANDLE;
+		}
 	}
 
 	return bgfx::createProgram(vsh, fsh, true /* destroy shaders when program is destroyed */);
@@ -23,10 +23,10 @@ void* load(const bx::FilePath& _filePath, uint32_t* _size = NULL);
 ///
 void unload(void* _ptr);
 
-///
+/// Returns invalid handle if shader binary is not found.
 bgfx::ShaderHandle loadShader(const bx::StringView& _name);
 
-///
+/// Returns invalid handle if any of shader binaries is not found.
 bgfx::ProgramHandle loadProgram(const bx::StringView& _vsName, const bx::StringView& _fsName);
 
 ///
@@ -0,0 +1,290 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef CAPTUREWRITER_H_HEADER_GUARD
+#define CAPTUREWRITER_H_HEADER_GUARD
+
+#include <bx/allocator.h>
+#include <bx/file.h>
+#include <bx/mutex.h>
+#include <bx/os.h>
+#include <bx/semaphore.h>
+#include <bx/string.h>
+#include <bx/thread.h>
+#include <bimg/bimg.h>
+
+#include "aviwriter.h"
+
+// Encodes screen shots and video capture frames on worker thread. Callback
+// only copies frame data into queue and returns, so render thread is never
+// blocked by PNG encoding or file I/O. When worker falls behind, video frames
+// are dropped instead of stalling rendering.
+class CaptureWriter
+{
+public:
+	CaptureWriter(bx::AllocatorI* _allocator)
+		: m_allocator(_allocator)
+		, m_aviWriter(NULL)
+		, m_read(0)
+		, m_write(0)
+		, m_numDropped(0)
+		, m_exit(false)
+	{
+		bx::memSet(m_job, 0, sizeof(m_job) );
+		m_thread.init(workerFunc, this, 0, "CaptureWriter");
+	}
+
+	~CaptureWriter()
+	{
+		{
+			bx::MutexScope lock(m_mutex);
+			m_exit = true;
+		}
+
+		m_sem.post();
+		m_thread.shutdown();
+
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_job); ++ii)
+		{
+			bx::free(m_allocator, m_job[ii].data);
+		}
+
+		closeVideo();
+	}
+
+	// Queue screen shot to be saved as PNG.
+	void screenShot(const char* _filePath, uint32_t _width, uint32_t _height, uint32_t _pitch, const void* _data, bool _yflip)
+	{
+		Job* job = alloc(_height*_pitch, true);
+		if (NULL != job)
+		{
+			job->type   = Job::ScreenShot;
+			job->width  = _width;
+			job->height = _height;
+			job->pitch  = _pitch;
+			job->yflip  = _yflip;
+			bx::strCopy(job->filePath, BX_COUNTOF(job->filePath), _filePath);
+			bx::memCopy(job->data, _data, _height*_pitch);
+			commit();
+		}
+	}
+
+	// Queue start of video capture.
+	void captureBegin(const char* _filePath, uint32_t _width, uint32_t _height, uint32_t _pitch, bool _yflip)
+	{
+		Job* job = alloc(0, true);
+		if (NULL != job)
+		{
+			job->type   = Job::CaptureBegin;
+			job->width  = _width;
+			job->height = _height;
+			job->pitch  = _pitch;
+			job->yflip  = _yflip;
+			bx::strCopy(job->filePath, BX_COUNTOF(job->filePath), _filePath);
+			commit();
+		}
+	}
+
+	// Queue video frame. Frame is dropped if queue is full.
+	void captureFrame(const void* _data, uint32_t _size)
+	{
+		Job* job = alloc(_size, false);
+		if (NULL != job)
+		{
+			job->type = Job::CaptureFrame;
+			bx::memCopy(job->data, _data, _size);
+			commit();
+		}
+	}
+
+	// Queue end of video capture.
+	void captureEnd()
+	{
+		Job* job = alloc(0, true);
+		if (NULL != job)
+		{
+			job->type = Job::CaptureEnd;
+			commit();
+		}
+	}
+
+	// Number of video frames dropped because worker fell behind.
+	uint32_t getNumDropped() const
+	{
+		return m_numDropped;
+	}
+
+private:
+	struct Job
+	{
+		enum Enum
+		{
+			ScreenShot,
+			CaptureBegin,
+			CaptureFrame,
+			CaptureEnd,
+		};
+
+		char     filePath[1024];
+		void*    data;
+		uint32_t size;
+		uint32_t capacity;
+		uint32_t width;
+		uint32_t height;
+		uint32_t pitch;
+		Enum     type;
+		bool     yflip;
+	};
+
+	Job* alloc(uint32_t _size, bool _wait)
+	{
+		for (;;)
+		{
+			{
+				bx::MutexScope lock(m_mutex);
+				if (m_write - m_read < BX_COUNTOF(m_job) )
+				{
+					break;
+				}
+			}
+
+			if (!_wait)
+			{
+				++m_numDropped;
+				return NULL;
+			}
+
+			// Screen shots and capture begin/end are rare, and must not be lost.
+			bx::yield();
+		}
+
+		Job& job = m_job[m_write % BX_COUNTOF(m_job)];
+		if (_size > job.capacity)
+		{
+			job.data     = bx::realloc(m_allocator, job.data, _size);
+			job.capacity = _size;
+		}
+
+		job.size = _size;
+
+		return &job;
+	}
+
+	void commit()
+	{
+		{
+			bx::MutexScope lock(m_mutex);
+			++m_write;
+		}
+
+		m_sem.post();
+	}
+
+	static int32_t workerFunc(bx::Thread* /*_thread*/, void* _userData)
+	{
+		return static_cast<CaptureWriter*>(_userData)->worker();
+	}
+
+	int32_t worker()
+	{
+		for (;;)
+		{
+			m_sem.wait();
+
+			uint32_t read;
+			uint32_t write;
+			bool exit;
+
+			{
+				bx::MutexScope lock(m_mutex);
+				read  = m_read;
+				write = m_write;
+				exit  = m_exit;
+			}
+
+			for (; read != write; ++read)
+			{
+				process(m_job[read % BX_COUNTOF(m_job)]);
+
+				bx::MutexScope lock(m_mutex);
+				m_read = read + 1;
+			}
+
+			if (exit)
+			{
+				break;
+			}
+		}
+
+		return bx::kExitSuccess;
+	}
+
+	void process(const Job& _job)
+	{
+		switch (_job.type)
+		{
+		case Job::ScreenShot:
+			{
+				bx::FileWriter writer;
+				bx::Error err;
+				if (bx::open(&writer, _job.filePath, false, &err) )
+				{
+					bimg::imageWritePng(&writer, _job.width, _job.height, _job.pitch, _job.data, bimg::TextureFormat::BGRA8, _job.yflip, &err);
+					bx::close(&writer);
+				}
+			}
+			break;
+
+		case Job::CaptureBegin:
+			closeVideo();
+
+			m_aviWriter = BX_NEW(m_allocator, AviWriter)(&m_fileWriter);
+			if (!m_aviWriter->open(_job.filePath, _job.width, _job.height, 60, _job.yflip) )
+			{
+				bx::deleteObject(m_allocator, m_aviWriter);
+				m_aviWriter = NULL;
+			}
+			break;
+
+		case Job::CaptureFrame:
+			if (NULL != m_aviWriter)
+			{
+				m_aviWriter->frame(_job.data);
+			}
+			break;
+
+		case Job::CaptureEnd:
+			closeVideo();
+			break;
+		}
+	}
+
+	void closeVideo()
+	{
+		if (NULL != m_aviWriter)
+		{
+			m_aviWriter->close();
+			bx::deleteObject(m_allocator, m_aviWriter);
+			m_aviWriter = NULL;
+		}
+	}
+
+	bx::AllocatorI*  m_allocator;
+	bx::FileWriter   m_fileWriter;
+	AviWriter*       m_aviWriter;
+
+	Job m_job[8];
+
+	bx::Thread    m_thread;
+	bx::Mutex     m_mutex;
+	bx::Semaphore m_sem;
+
+	uint32_t m_read;
+	uint32_t m_write;
+	uint32_t m_numDropped;
+	bool     m_exit;
+};
+
+#endif // CAPTUREWRITER_H_HEADER_GUARD
@@ -0,0 +1,317 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/debug.h>
+#include <bx/hash.h>
+#include <bx/math.h>
+
+#include "cascadedshadowmap.h"
+
+CascadedShadowMap::CascadedShadowMap()
+	: m_allocator(NULL)
+	, m_mask(NULL)
+	, m_maxCasters(0)
+	, m_numCasters(0)
+	, m_numCascades(0)
+{
+	bx::memSet(m_cascade, 0, sizeof(m_cascade) );
+	bx::memSet(m_renderedHash, 0, sizeof(m_renderedHash) );
+	bx::memSet(m_rendered, 0, sizeof(m_rendered) );
+	bx::mtxIdentity(m_view);
+}
+
+CascadedShadowMap::~CascadedShadowMap()
+{
+	shutdown();
+}
+
+bool CascadedShadowMap::init(uint32_t _maxCasters, bx::AllocatorI* _allocator)
+{
+	BX_ASSERT(NULL == m_mask, "CascadedShadowMap is already initialized.");
+
+	if (NULL == _allocator)
+	{
+		static bx::DefaultAllocator allocator;
+		_allocator = &allocator;
+	}
+
+	m_allocator  = _allocator;
+	m_maxCasters = bx::max<uint32_t>(_maxCasters, 1);
+	m_numCasters = 0;
+	m_mask       = (uint8_t*)bx::alloc(m_allocator, m_maxCasters);
+	bx::memSet(m_mask, 0, m_maxCasters);
+
+	invalidate();
+
+	return true;
+}
+
+void CascadedShadowMap::shutdown()
+{
+	if (NULL == m_mask)
+	{
+		return;
+	}
+
+	bx::free(m_allocator, m_mask);
+	m_mask = NULL;
+	m_maxCasters = 0;
+	m_numCasters = 0;
+}
+
+void CascadedShadowMap::invalidate()
+{
+	for (uint8_t ii = 0; ii < kMaxCascades; ++ii)
+	{
+		m_cascade[ii].m_dirty = true;
+		m_rendered[ii]        = false;
+	}
+}
+
+void CascadedShadowMap::markRendered(uint8_t _cascade)
+{
+	BX_ASSERT(_cascade < m_numCascades, "Invalid cascade %d (num cascades %d).", _cascade, m_numCascades);
+
+	CascadedShadowMapCascade& cascade = m_cascade[_cascade];
+	m_renderedHash[_cascade] = cascade.m_hash;
+	m_rendered[_cascade]     = true;
+	cascade.m_dirty          = false;
+}
+
+bool CascadedShadowMap::isDirty() const
+{
+	for (uint8_t ii = 0; ii < m_numCascades; ++ii)
+	{
+		if (m_cascade[ii].m_dirty)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void splitFrustum(float* _near, float* _far, uint8_t _numSplits, float _nearDist, float _farDist, float _splitWeight)
+{
+	const float ratio = _farDist/_nearDist;
+	const float numSlicesf = float(_numSplits*2);
+
+	_near[0] = _nearDist;
+
+	for (uint8_t ii = 1; ii < _numSplits; ++ii)
+	{
+		const float si = float(ii*2-1) / numSlicesf;
+		const float dist = _splitWeight*(_nearDist*bx::pow(ratio, si) ) + (1.0f - _splitWeight)*(_nearDist + (_farDist - _nearDist)*si);
+
+		// Overlap splits slightly, to hide seams.
+		_near[ii]  = dist;
+		_far[ii-1] = dist * 1.005f;
+	}
+
+	_far[_numSplits-1] = _farDist;
+}
+
+void CascadedShadowMap::update(
+	  const CascadedShadowMapSettings& _settings
+	, const float* _view
+	, float _fovy
+	, float _aspect
+	, const float* _lightDir
+	, const CascadedShadowMapCaster* _casters
+	, uint32_t _numCasters
+	)
+{
+	BX_ASSERT(NULL != m_mask, "CascadedShadowMap is not initialized.");
+
+	m_numCascades = bx::clamp<uint8_t>(_settings.m_numCascades, 1, kMaxCascades);
+	m_numCasters  = bx::min(_numCasters, m_maxCasters);
+
+	const bx::Vec3 at  = { 0.0f, 0.0f, 0.0f };
+	const bx::Vec3 eye = bx::neg(bx::load<bx::Vec3>(_lightDir) );
+	bx::mtxLookAt(m_view, eye, at);
+
+	float viewInv[16];
+	bx::mtxInverse(viewInv, _view);
+
+	float viewToLight[16];
+	bx::mtxMul(viewToLight, viewInv, m_view);
+
+	const float projHeight = bx::tan(bx::toRad(_fovy)*0.5f);
+	const float projWidth  = projHeight * _aspect;
+
+	float splitNear[kMaxCascades];
+	float splitFar[kMaxCascades];
+	splitFrustum(splitNear, splitFar, m_numCascades, _settings.m_near, _settings.m_far, _settings.m_splitWeight);
+
+	const float shadowMapSize = float(_settings.m_shadowMapSize);
+
+	for (uint8_t ii = 0; ii < m_numCascades; ++ii)
+	{
+		CascadedShadowMapCascade& cascade = m_cascade[ii];
+		cascade.m_near = splitNear[ii];
+		cascade.m_far  = splitFar[ii];
+
+		const float nw = cascade.m_near * projWidth;
+		const float nh = cascade.m_near * projHeight;
+		const float fw = cascade.m_far  * projWidth;
+		const float fh = cascade.m_far  * projHeight;
+
+		const bx::Vec3 corners[8] =
+		{
+			{ -nw,  nh, cascade.m_near },
+			{  nw,  nh, cascade.m_near },
+			{  nw, -nh, cascade.m_near },
+			{ -nw, -nh, cascade.m_near },
+			{ -fw,  fh, cascade.m_far  },
+			{  fw,  fh, cascade.m_far  },
+			{  fw, -fh, cascade.m_far  },
+			{ -fw, -fh, cascade.m_far  },
+		};
+
+		const bx::Vec3 lightCorners[8] =
+		{
+			bx::mul(corners[0], viewToLight),
+			bx::mul(corners[1], viewToLight),
+			bx::mul(corners[2], viewToLight),
+			bx::mul(corners[3], viewToLight),
+			bx::mul(corners[4], viewToLight),
+			bx::mul(corners[5], viewToLight),
+			bx::mul(corners[6], viewToLight),
+			bx::mul(corners[7], viewToLight),
+		};
+
+		bx::Vec3 center = { 0.0f, 0.0f, 0.0f };
+
+		for (uint8_t jj = 0; jj < 8; ++jj)
+		{
+			center = bx::add(center, lightCorners[jj]);
+		}
+
+		bx::Vec3 min = lightCorners[0];
+		bx::Vec3 max = lightCorners[0];
+
+		for (uint8_t jj = 1; jj < 8; ++jj)
+		{
+			min = bx::min(min, lightCorners[jj]);
+			max = bx::max(max, lightCorners[jj]);
+		}
+
+		if (_settings.m_stabilize)
+		{
+			// Bounding sphere of split has the same size for any camera
+			// orientation, radius is rounded up to hide float noise.
+			center = bx::mul(center, 1.0f/8.0f);
+
+			float radius = 0.0f;
+			for (uint8_t jj = 0; jj < 8; ++jj)
+			{
+				radius = bx::max(radius, bx::length(bx::sub(lightCorners[jj], center) ) );
+			}
+			radius = bx::ceil(radius*16.0f)/16.0f;
+
+			// Move cascade only by whole texels.
+			const float texelSize = 2.0f*radius/shadowMapSize;
+			const float cx = bx::floor(center.x/texelSize)*texelSize;
+			const float cy = bx::floor(center.y/texelSize)*texelSize;
+
+			min.x = cx - radius;
+			min.y = cy - radius;
+			max.x = cx + radius;
+			max.y = cy + radius;
+		}
+
+		bx::mtxOrtho(
+			  cascade.m_proj
+			, min.x
+			, max.x
+			, min.y
+			, max.y
+			, -_settings.m_depthRange
+			, _settings.m_depthRange
+			, 0.0f
+			, _settings.m_homogeneousDepth
+			);
+
+		bx::store(cascade.m_min, min);
+		bx::store(cascade.m_max, max);
+		cascade.m_numCasters = 0;
+	}
+
+	for (uint8_t ii = m_numCascades; ii < kMaxCascades; ++ii)
+	{
+		m_cascade[ii].m_hash  = 0;
+		m_cascade[ii].m_dirty = true;
+		m_rendered[ii]        = false;
+	}
+
+	// Cascade is hashed with everything that affects its shadow map, if hash
+	// is the same as when cascade was marked rendered, its shadow map already
+	// has the same contents.
+	bx::HashMurmur2A murmur[kMaxCascades];
+
+	for (uint8_t ii = 0; ii < m_numCascades; ++ii)
+	{
+		murmur[ii].begin();
+		murmur[ii].add(_settings.m_depthRange);
+		murmur[ii].add(_settings.m_shadowMapSize);
+		murmur[ii].add(_settings.m_homogeneousDepth);
+		murmur[ii].add(m_view, sizeof(m_view) );
+		murmur[ii].add(m_cascade[ii].m_proj, sizeof(m_cascade[ii].m_proj) );
+	}
+
+	for (uint32_t ii = 0; ii < m_numCasters; ++ii)
+	{
+		const CascadedShadowMapCaster& caster = _casters[ii];
+
+		// Light space bounding box of caster.
+		const bx::Vec3 wmin   = bx::load<bx::Vec3>(caster.m_min);
+		const bx::Vec3 wmax   = bx::load<bx::Vec3>(caster.m_max);
+		const bx::Vec3 center = bx::mul(bx::mul(bx::add(wmin, wmax), 0.5f), m_view);
+		const bx::Vec3 wext   = bx::mul(bx::sub(wmax, wmin), 0.5f);
+		const bx::Vec3 extent =
+		{
+			bx::abs(m_view[0])*wext.x + bx::abs(m_view[4])*wext.y + bx::abs(m_view[ 8])*wext.z,
+			bx::abs(m_view[1])*wext.x + bx::abs(m_view[5])*wext.y + bx::abs(m_view[ 9])*wext.z,
+			bx::abs(m_view[2])*wext.x + bx::abs(m_view[6])*wext.y + bx::abs(m_view[10])*wext.z,
+		};
+		const bx::Vec3 min = bx::sub(center, extent);
+		const bx::Vec3 max = bx::add(center, extent);
+
+		uint8_t mask = 0;
+
+		if (max.z >= -_settings.m_depthRange
+		&&  min.z <=  _settings.m_depthRange)
+		{
+			for (uint8_t jj = 0; jj < m_numCascades; ++jj)
+			{
+				CascadedShadowMapCascade& cascade = m_cascade[jj];
+
+				// Caster completely behind split can't cast shadow on it.
+				if (max.x >= cascade.m_min[0] && min.x <= cascade.m_max[0]
+				&&  max.y >= cascade.m_min[1] && min.y <= cascade.m_max[1]
+				&&  min.z <= cascade.m_max[2])
+				{
+					mask |= uint8_t(1<<jj);
+					cascade.m_numCasters++;
+
+					murmur[jj].add(ii);
+					murmur[jj].add(caster.m_min, sizeof(caster.m_min) );
+					murmur[jj].add(caster.m_max, sizeof(caster.m_max) );
+					murmur[jj].add(caster.m_version);
+				}
+			}
+		}
+
+		m_mask[ii] = mask;
+	}
+
+	for (uint8_t ii = 0; ii < m_numCascades; ++ii)
+	{
+		CascadedShadowMapCascade& cascade = m_cascade[ii];
+
+		cascade.m_hash  = murmur[ii].end();
+		cascade.m_dirty = !m_rendered[ii] || cascade.m_hash != m_renderedHash[ii];
+	}
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef CASCADEDSHADOWMAP_H_HEADER_GUARD
+#define CASCADEDSHADOWMAP_H_HEADER_GUARD
+
+#include <bx/allocator.h>
+
+/// Shadow caster.
+struct CascadedShadowMapCaster
+{
+	float    m_min[3];  //!< World space bounding box min.
+	float    m_max[3];  //!< World space bounding box max.
+	uint32_t m_version; //!< Must be changed when caster changes in a way not visible in its
+	                    //!  bounding box (animation, rotation inside the same bounds, etc.).
+};
+
+///
+struct CascadedShadowMapSettings
+{
+	float    m_near;             //!< Camera distance where first cascade starts.
+	float    m_far;              //!< Camera distance where last cascade ends.
+	float    m_splitWeight;      //!< Split distribution, 0 is uniform, 1 is logarithmic.
+	float    m_depthRange;       //!< Light projection covers -depthRange to depthRange along light
+	                             //!  direction, around world origin.
+	uint16_t m_shadowMapSize;    //!< Shadow map resolution.
+	uint8_t  m_numCascades;      //!< Number of cascades, up to `CascadedShadowMap::kMaxCascades`.
+	bool     m_stabilize;        //!< Fit cascade to bounding sphere of split, and snap it to texels,
+	                             //!  so that it doesn't shimmer and doesn't change when camera rotates.
+	bool     m_homogeneousDepth; //!< `bgfx::Caps::homogeneousDepth`.
+};
+
+/// Cascade.
+struct CascadedShadowMapCascade
+{
+	float    m_near;     //!< Camera distance where cascade starts.
+	float    m_far;      //!< Camera distance where cascade ends.
+	float    m_proj[16]; //!< Light projection.
+	float    m_min[3];   //!< Light space bounds of cascade.
+	float    m_max[3];   //!< Light space bounds of cascade.
+	uint32_t m_numCasters; //!< Number of casters inside cascade.
+	uint32_t m_hash;     //!< Hash of everything that affects shadow map contents.
+	bool     m_dirty;    //!< Shadow map must be rendered, contents changed since `markRendered`.
+};
+
+/// Cascaded shadow maps for directional light.
+///
+/// Every update:
+///  - Camera frustum is split, and projection of each cascade is fitted to
+///    its split.
+///  - Casters are culled against light space bounds of every cascade.
+///  - Cascade is marked dirty only if settings, light, projection, or any
+///    caster inside it changed since it was last rendered.
+///
+/// Library doesn't render anything, caller renders dirty cascades with
+/// casters from `getCascadeMask`, calls `markRendered` for them, and skips
+/// clearing and rendering of the rest. Cascade that is not marked rendered
+/// stays dirty.
+///
+class CascadedShadowMap
+{
+public:
+	static constexpr uint8_t kMaxCascades = 4;
+
+	///
+	CascadedShadowMap();
+
+	///
+	~CascadedShadowMap();
+
+	/// Initialize.
+	///
+	/// @param[in] _maxCasters Maximum number of casters.
+	/// @param[in] _allocator Allocator.
+	///
+	bool init(uint32_t _maxCasters, bx::AllocatorI* _allocator = NULL);
+
+	///
+	void shutdown();
+
+	/// Update cascades.
+	///
+	/// @param[in] _settings Settings.
+	/// @param[in] _view Camera view matrix.
+	/// @param[in] _fovy Camera vertical field of view in degrees.
+	/// @param[in] _aspect Camera aspect ratio.
+	/// @param[in] _lightDir World space direction light is travelling in.
+	/// @param[in] _casters Casters.
+	/// @param[in] _numCasters Number of casters, clamped to maximum number of casters.
+	///
+	void update(
+		  const CascadedShadowMapSettings& _settings
+		, const float* _view
+		, float _fovy
+		, float _aspect
+		, const float* _lightDir
+		, const CascadedShadowMapCaster* _casters
+		, uint32_t _numCasters
+		);
+
+	/// Mark all cascades dirty, must be called when shadow map contents are
+	/// lost, or when something that library doesn't know about affects them
+	/// (shader, render target used for other purpose, etc.).
+	void invalidate();
+
+	/// Mark cascade as rendered with contents of last `update`, it stays
+	/// clean until its contents change.
+	///
+	/// @param[in] _cascade Cascade.
+	///
+	void markRendered(uint8_t _cascade);
+
+	/// Light view matrix, shared by all cascades.
+	const float* getView() const { return m_view; }
+
+	///
+	uint8_t getNumCascades() const { return m_numCascades; }
+
+	///
+	const CascadedShadowMapCascade& getCascade(uint8_t _cascade) const { return m_cascade[_cascade]; }
+
+	/// Returns mask of cascades caster is inside, bit N is set if caster must
+	/// be rendered into cascade N.
+	uint8_t getCascadeMask(uint32_t _caster) const { return m_mask[_caster]; }
+
+	/// Returns true if any cascade is dirty.
+	bool isDirty() const;
+
+private:
+	bx::AllocatorI* m_allocator;
+
+	uint8_t* m_mask;
+
+	CascadedShadowMapCascade m_cascade[kMaxCascades];
+	uint32_t m_renderedHash[kMaxCascades];
+	bool     m_rendered[kMaxCascades];
+	float m_view[16];
+
+	uint32_t m_maxCasters;
+	uint32_t m_numCasters;
+	uint8_t  m_numCascades;
+};
+
+#endif // CASCADEDSHADOWMAP_H_HEADER_GUARD
@@ -0,0 +1,393 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/debug.h>
+#include <bx/math.h>
+#include <bx/uint32_t.h>
+
+#include "hizcull.h"
+#include "../bgfx_utils.h"
+
+static bx::AllocatorI* getDefaultAllocator()
+{
+	static bx::DefaultAllocator allocator;
+	return &allocator;
+}
+
+static uint16_t floorPow2(uint16_t _value)
+{
+	return uint16_t(UINT32_C(1) << (31 - bx::uint32_cntlz(bx::max<uint32_t>(_value, 1) ) ) );
+}
+
+static uint8_t calcNumMips(uint16_t _width, uint16_t _height)
+{
+	return uint8_t(32 - bx::uint32_cntlz(bx::max<uint32_t>(_width, _height) ) );
+}
+
+HiZCull::HiZCull()
+	: m_allocator(NULL)
+	, m_batch(NULL)
+	, m_bounds(NULL)
+	, m_data(NULL)
+	, m_maxInstances(0)
+	, m_numInstances(0)
+	, m_maxBatches(0)
+	, m_numBatches(0)
+	, m_maxGroups(0)
+	, m_numGroups(0)
+	, m_width(0)
+	, m_height(0)
+	, m_numMips(0)
+{
+	m_programCopyZ.idx            = bgfx::kInvalidHandle;
+	m_programDownscaleHiZ.idx     = bgfx::kInvalidHandle;
+	m_programOccludeProps.idx     = bgfx::kInvalidHandle;
+	m_programStreamCompaction.idx = bgfx::kInvalidHandle;
+	m_depthBuffer.idx             = bgfx::kInvalidHandle;
+	m_hiZTexture.idx              = bgfx::kInvalidHandle;
+}
+
+HiZCull::~HiZCull()
+{
+	shutdown();
+}
+
+bool HiZCull::isSupported()
+{
+	const bgfx::Caps* caps = bgfx::getCaps();
+
+	const uint64_t required = 0
+		| BGFX_CAPS_COMPUTE
+		| BGFX_CAPS_DRAW_INDIRECT
+		| BGFX_CAPS_INSTANCING
+		;
+
+	return required == (caps->supported & required)
+		&& 0 != (caps->formats[bgfx::TextureFormat::R32F] & BGFX_CAPS_FORMAT_TEXTURE_IMAGE_WRITE)
+		&& 0 != (caps->formats[bgfx::TextureFormat::D32F] & BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER)
+		;
+}
+
+bool HiZCull::init(uint32_t _maxInstances, uint16_t _maxGroups, bx::AllocatorI* _allocator)
+{
+	BX_ASSERT(NULL == m_bounds, "HiZCull is already initialized.");
+
+	const uint32_t maxBatches = (_maxInstances + kBatchSize - 1)/kBatchSize;
+
+	if (0 == _maxInstances
+	||  0 == _maxGroups
+	||  UINT16_MAX < maxBatches)
+	{
+		return false;
+	}
+
+	m_allocator    = NULL == _allocator ? getDefaultAllocator() : _allocator;
+	m_maxInstances = _maxInstances;
+	m_maxBatches   = uint16_t(maxBatches);
+	m_maxGroups    = _maxGroups;
+	m_numInstances = 0;
+	m_numBatches   = 0;
+	m_numGroups    = 0;
+
+	m_batch  = (Batch*)bx::alloc(m_allocator, m_maxBatches*sizeof(Batch) );
+	m_bounds = (float*)bx::alloc(m_allocator, m_maxInstances*8*sizeof(float) );
+	m_data   = (float*)bx::alloc(m_allocator, m_maxInstances*16*sizeof(float) );
+
+	m_programCopyZ            = loadProgram("cs_gdr_copy_z", NULL);
+	m_programDownscaleHiZ     = loadProgram("cs_gdr_downscale_hi_z", NULL);
+	m_programOccludeProps     = loadProgram("cs_gdr_occlude_props", NULL);
+	m_programStreamCompaction = loadProgram("cs_gdr_stream_compaction", NULL);
+
+	s_texOcclusionDepth = bgfx::createUniform("s_texOcclusionDepth", bgfx::UniformType::Sampler);
+	u_inputRTSize       = bgfx::createUniform("u_inputRTSize",       bgfx::UniformType::Vec4);
+	u_cullingConfig     = bgfx::createUniform("u_cullingConfig",     bgfx::UniformType::Vec4);
+
+	// Per group number of indices, start index and base vertex.
+	m_groupBuffer = bgfx::createDynamicIndexBuffer(m_maxGroups*3, BGFX_BUFFER_INDEX32 | BGFX_BUFFER_COMPUTE_READ);
+
+	bgfx::VertexLayout boundsLayout;
+	boundsLayout.begin()
+		.add(bgfx::Attrib::TexCoord0, 4, bgfx::AttribType::Float)
+		.end();
+
+	bgfx::VertexLayout instanceLayout;
+	instanceLayout.begin()
+		.add(bgfx::Attrib::TexCoord0, 4, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::TexCoord1, 4, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::TexCoord2, 4, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::TexCoord3, 4, bgfx::AttribType::Float)
+		.end();
+
+	for (uint16_t ii = 0; ii < m_maxBatches; ++ii)
+	{
+		Batch& batch = m_batch[ii];
+		const uint32_t num = bx::min(m_maxInstances - uint32_t(ii)*kBatchSize, kBatchSize);
+
+		// Visible instance counts are accumulated by culling, and reset by
+		// stream compaction, so they must start at zero.
+		const bgfx::Memory* counts = bgfx::alloc(m_maxGroups*sizeof(uint32_t) );
+		bx::memSet(counts->data, 0, counts->size);
+		batch.m_instanceCounts = bgfx::createDynamicIndexBuffer(counts, BGFX_BUFFER_INDEX32 | BGFX_BUFFER_COMPUTE_READ_WRITE);
+
+		// Stream compaction always reads kBatchSize predicates.
+		batch.m_instancePredicates = bgfx::createDynamicIndexBuffer(kBatchSize, BGFX_BUFFER_COMPUTE_READ_WRITE);
+
+		batch.m_boundsBuffer         = bgfx::createDynamicVertexBuffer(num*2, boundsLayout, BGFX_BUFFER_COMPUTE_READ);
+		batch.m_instanceBuffer       = bgfx::createDynamicVertexBuffer(num, instanceLayout, BGFX_BUFFER_COMPUTE_READ);
+		batch.m_culledInstanceBuffer = bgfx::createDynamicVertexBuffer(num, instanceLayout, BGFX_BUFFER_COMPUTE_WRITE);
+		batch.m_indirectBuffer       = bgfx::createIndirectBuffer(m_maxGroups);
+	}
+
+	return true;
+}
+
+void HiZCull::shutdown()
+{
+	if (NULL == m_bounds)
+	{
+		return;
+	}
+
+	destroyTextures();
+
+	bgfx::destroy(m_programCopyZ);
+	bgfx::destroy(m_programDownscaleHiZ);
+	bgfx::destroy(m_programOccludeProps);
+	bgfx::destroy(m_programStreamCompaction);
+
+	bgfx::destroy(s_texOcclusionDepth);
+	bgfx::destroy(u_inputRTSize);
+	bgfx::destroy(u_cullingConfig);
+
+	bgfx::destroy(m_groupBuffer);
+
+	for (uint16_t ii = 0; ii < m_maxBatches; ++ii)
+	{
+		const Batch& batch = m_batch[ii];
+		bgfx::destroy(batch.m_instanceCounts);
+		bgfx::destroy(batch.m_instancePredicates);
+		bgfx::destroy(batch.m_boundsBuffer);
+		bgfx::destroy(batch.m_instanceBuffer);
+		bgfx::destroy(batch.m_culledInstanceBuffer);
+		bgfx::destroy(batch.m_indirectBuffer);
+	}
+
+	bx::free(m_allocator, m_batch);
+	bx::free(m_allocator, m_bounds);
+	bx::free(m_allocator, m_data);
+
+	m_batch  = NULL;
+	m_bounds = NULL;
+	m_data   = NULL;
+}
+
+void HiZCull::destroyTextures()
+{
+	if (bgfx::isValid(m_depthBuffer) )
+	{
+		bgfx::destroy(m_depthBuffer);
+		bgfx::destroy(m_hiZTexture);
+
+		m_depthBuffer.idx = bgfx::kInvalidHandle;
+		m_hiZTexture.idx  = bgfx::kInvalidHandle;
+	}
+}
+
+void HiZCull::resize(uint16_t _width, uint16_t _height)
+{
+	const uint16_t width  = floorPow2(_width);
+	const uint16_t height = floorPow2(_height);
+
+	if (width  == m_width
+	&&  height == m_height
+	&&  bgfx::isValid(m_depthBuffer) )
+	{
+		return;
+	}
+
+	destroyTextures();
+
+	m_width   = width;
+	m_height  = height;
+	m_numMips = calcNumMips(width, height);
+
+	const uint64_t tsFlags = 0
+		| BGFX_TEXTURE_RT
+		| BGFX_SAMPLER_MIN_POINT
+		| BGFX_SAMPLER_MAG_POINT
+		| BGFX_SAMPLER_MIP_POINT
+		| BGFX_SAMPLER_U_CLAMP
+		| BGFX_SAMPLER_V_CLAMP
+		;
+
+	m_depthBuffer = bgfx::createFrameBuffer(m_width, m_height, bgfx::TextureFormat::D32F, tsFlags);
+	m_hiZTexture  = bgfx::createTexture2D(m_width, m_height, true, 1, bgfx::TextureFormat::R32F, BGFX_TEXTURE_COMPUTE_WRITE | tsFlags);
+}
+
+void HiZCull::setGroups(const HiZCullGroup* _groups, uint16_t _num)
+{
+	BX_WARN(_num <= m_maxGroups, "Too many groups %d (max: %d).", _num, m_maxGroups);
+	m_numGroups = bx::min(_num, m_maxGroups);
+
+	const bgfx::Memory* mem = bgfx::alloc(m_numGroups*3*sizeof(uint32_t) );
+	uint32_t* data = (uint32_t*)mem->data;
+
+	for (uint16_t ii = 0; ii < m_numGroups; ++ii)
+	{
+		data[ii*3+0] = _groups[ii].m_numIndices;
+		data[ii*3+1] = _groups[ii].m_startIndex;
+		data[ii*3+2] = _groups[ii].m_baseVertex;
+	}
+
+	bgfx::update(m_groupBuffer, 0, mem);
+}
+
+void HiZCull::setInstances(const HiZCullInstance* _instances, uint32_t _num)
+{
+	BX_WARN(_num <= m_maxInstances, "Too many instances %d (max: %d).", _num, m_maxInstances);
+	_num = bx::min(_num, m_maxInstances);
+
+	// Indirect draws take instances of each group from consecutive range of
+	// compacted instance buffer, so instances are sorted by group. Batches
+	// are consecutive ranges of sorted instances, so they stay sorted.
+	uint32_t* offset = (uint32_t*)bx::alloc(m_allocator, (m_numGroups+1)*sizeof(uint32_t) );
+	bx::memSet(offset, 0, (m_numGroups+1)*sizeof(uint32_t) );
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		const uint16_t group = _instances[ii].m_group;
+		BX_WARN(group < m_numGroups, "Instance %d has invalid group %d, it won't be drawn.", ii, group);
+
+		if (group < m_numGroups)
+		{
+			++offset[group+1];
+		}
+	}
+
+	for (uint16_t ii = 0; ii < m_numGroups; ++ii)
+	{
+		offset[ii+1] += offset[ii];
+	}
+
+	m_numInstances = offset[m_numGroups];
+	m_numBatches   = uint16_t( (m_numInstances + kBatchSize - 1)/kBatchSize);
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		const HiZCullInstance& instance = _instances[ii];
+
+		if (instance.m_group < m_numGroups)
+		{
+			const uint32_t idx = offset[instance.m_group]++;
+
+			float* bounds = &m_bounds[idx*8];
+			bounds[0] = instance.m_min[0];
+			bounds[1] = instance.m_min[1];
+			bounds[2] = instance.m_min[2];
+			bounds[3] = float(instance.m_group);
+			bounds[4] = instance.m_max[0];
+			bounds[5] = instance.m_max[1];
+			bounds[6] = instance.m_max[2];
+			bounds[7] = 0.0f;
+
+			bx::memCopy(&m_data[idx*16], instance.m_data, sizeof(instance.m_data) );
+		}
+	}
+
+	bx::free(m_allocator, offset);
+
+	for (uint16_t ii = 0; ii < m_numBatches; ++ii)
+	{
+		const Batch& batch = m_batch[ii];
+		const uint32_t first = uint32_t(ii)*kBatchSize;
+		const uint32_t num   = getNumInstances(ii);
+
+		bgfx::update(batch.m_boundsBuffer,   0, bgfx::copy(&m_bounds[first*8], num*8*sizeof(float) ) );
+		bgfx::update(batch.m_instanceBuffer, 0, bgfx::copy(&m_data[first*16],  num*16*sizeof(float) ) );
+	}
+}
+
+void HiZCull::cull(bgfx::ViewId _viewId, const float* _view, const float* _proj)
+{
+	BX_ASSERT(bgfx::isValid(m_depthBuffer), "HiZCull::resize must be called before HiZCull::cull.");
+
+	uint32_t width  = m_width;
+	uint32_t height = m_height;
+
+	// Copy occluder depth into Hi-Z mip 0. Blit can't be used since formats
+	// differ.
+	{
+		const float inputRTSize[4] = { float(width), float(height), 0.0f, 0.0f };
+		bgfx::setUniform(u_inputRTSize, inputRTSize);
+
+		bgfx::setTexture(0, s_texOcclusionDepth, bgfx::getTexture(m_depthBuffer, 0) );
+		bgfx::setImage(1, m_hiZTexture, 0, bgfx::Access::Write);
+
+		bgfx::dispatch(_viewId, m_programCopyZ, (width+15)/16, (height+15)/16);
+	}
+
+	// Downscale, each texel takes max depth of 2x2 texels of level below.
+	for (uint8_t lod = 1; lod < m_numMips; ++lod)
+	{
+		const float inputRTSize[4] = { float(width), float(height), 2.0f, 2.0f };
+		bgfx::setUniform(u_inputRTSize, inputRTSize);
+
+		width  = bx::max<uint32_t>(width /2, 1);
+		height = bx::max<uint32_t>(height/2, 1);
+
+		bgfx::setImage(0, m_hiZTexture, lod - 1, bgfx::Access::Read);
+		bgfx::setImage(1, m_hiZTexture, lod,     bgfx::Access::Write);
+
+		bgfx::dispatch(_viewId, m_programDownscaleHiZ, (width+15)/16, (height+15)/16);
+	}
+
+	const float inputRTSize[4] = { float(m_width), float(m_height), 1.0f/float(m_width), 1.0f/float(m_height) };
+
+	// Culling shader gets u_viewProj from view transform.
+	bgfx::setViewTransform(_viewId, _view, _proj);
+
+	for (uint16_t ii = 0; ii < m_numBatches; ++ii)
+	{
+		const Batch& batch = m_batch[ii];
+		const uint32_t num = getNumInstances(ii);
+
+		const float cullingConfig[4] =
+		{
+			float(num),
+			float(bx::uint32_nextpow2(num) ),
+			float(m_numMips - 1),
+			float(m_numGroups),
+		};
+
+		// Test instance bounds against Hi-Z. Predicates are written for all
+		// kBatchSize instances, since stream compaction reads all of them.
+		{
+			bgfx::setTexture(0, s_texOcclusionDepth, m_hiZTexture);
+
+			bgfx::setBuffer(1, batch.m_boundsBuffer,       bgfx::Access::Read);
+			bgfx::setBuffer(2, batch.m_instanceCounts,     bgfx::Access::ReadWrite);
+			bgfx::setBuffer(3, batch.m_instancePredicates, bgfx::Access::Write);
+
+			bgfx::setUniform(u_inputRTSize, inputRTSize);
+			bgfx::setUniform(u_cullingConfig, cullingConfig);
+
+			bgfx::dispatch(_viewId, m_programOccludeProps, kBatchSize/64, 1, 1);
+		}
+
+		// Compact visible instances, and write indirect draws.
+		{
+			bgfx::setBuffer(0, m_groupBuffer,                bgfx::Access::Read);
+			bgfx::setBuffer(1, batch.m_instanceBuffer,       bgfx::Access::Read);
+			bgfx::setBuffer(2, batch.m_instancePredicates,   bgfx::Access::Read);
+			bgfx::setBuffer(3, batch.m_instanceCounts,       bgfx::Access::ReadWrite);
+			bgfx::setBuffer(4, batch.m_indirectBuffer,       bgfx::Access::ReadWrite);
+			bgfx::setBuffer(5, batch.m_culledInstanceBuffer, bgfx::Access::Write);
+
+			bgfx::setUniform(u_cullingConfig, cullingConfig);
+
+			bgfx::dispatch(_viewId, m_programStreamCompaction, 1, 1, 1);
+		}
+	}
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef HIZCULL_H_HEADER_GUARD
+#define HIZCULL_H_HEADER_GUARD
+
+#include <bx/allocator.h>
+#include <bx/math.h>
+#include <bgfx/bgfx.h>
+
+/// Mesh group, every group is drawn with single indirect draw call per batch.
+struct HiZCullGroup
+{
+	uint32_t m_numIndices; //!< Number of indices.
+	uint32_t m_startIndex; //!< Offset into index buffer.
+	uint32_t m_baseVertex; //!< Offset into vertex buffer.
+};
+
+/// Instance to be culled.
+struct HiZCullInstance
+{
+	float    m_min[3];   //!< World space bounding box min.
+	float    m_max[3];   //!< World space bounding box max.
+	uint16_t m_group;    //!< Mesh group index.
+	float    m_data[16]; //!< Instance data passed to draw as i_data0-3, usually world matrix.
+};
+
+/// GPU occlusion culling against hierarchical Z buffer.
+///
+/// Usage:
+///  - Render occluders into `getOcclusionFrameBuffer()`.
+///  - Call `cull`, it builds Hi-Z mip chain from occluder depth, tests each
+///    instance bounding box against it, and compacts visible instances.
+///  - For each batch, draw with `getIndirectBuffer(batch)` (one draw per
+///    group, in group order) and `getInstanceBuffer(batch)` as instance data
+///    buffer.
+///
+/// Compute shaders are the ones from 37-gpudrivenrendering. Stream compaction
+/// runs as single work group, which limits it to `kBatchSize` instances.
+/// Instances are split into batches of `kBatchSize`, each batch is culled and
+/// compacted by its own dispatches into its own instance and indirect buffer,
+/// so number of indirect draws is number of groups times number of batches.
+///
+class HiZCull
+{
+public:
+	static constexpr uint32_t kBatchSize = 2048;
+
+	///
+	HiZCull();
+
+	///
+	~HiZCull();
+
+	/// Returns true if renderer supports everything required.
+	static bool isSupported();
+
+	/// Initialize.
+	///
+	/// @param[in] _maxInstances Maximum number of instances.
+	/// @param[in] _maxGroups Maximum number of mesh groups.
+	/// @param[in] _allocator Allocator.
+	///
+	bool init(uint32_t _maxInstances, uint16_t _maxGroups, bx::AllocatorI* _allocator = NULL);
+
+	///
+	void shutdown();
+
+	/// Set occlusion buffer resolution. Each dimension is rounded down to
+	/// power of 2, so every Hi-Z texel covers exactly 2x2 texels of level
+	/// below it.
+	///
+	/// @param[in] _width Width, usually back buffer width.
+	/// @param[in] _height Height, usually back buffer height.
+	///
+	void resize(uint16_t _width, uint16_t _height);
+
+	/// Set mesh groups.
+	void setGroups(const HiZCullGroup* _groups, uint16_t _num);
+
+	/// Set instances. Instances can be in any order, they are sorted by group.
+	void setInstances(const HiZCullInstance* _instances, uint32_t _num);
+
+	/// Build Hi-Z from occluder depth, and cull instances.
+	///
+	/// @param[in] _viewId View used for compute dispatches.
+	/// @param[in] _view View matrix used when rendering occluders.
+	/// @param[in] _proj Projection matrix used when rendering occluders.
+	///
+	void cull(bgfx::ViewId _viewId, const float* _view, const float* _proj);
+
+	/// Frame buffer occluders must be rendered into.
+	bgfx::FrameBufferHandle getOcclusionFrameBuffer() const { return m_depthBuffer; }
+
+	/// Hi-Z texture, R32F with full mip chain.
+	bgfx::TextureHandle getHiZTexture() const { return m_hiZTexture; }
+
+	///
+	uint16_t getWidth() const { return m_width; }
+
+	///
+	uint16_t getHeight() const { return m_height; }
+
+	/// Returns number of batches used by instances set with `setInstances`.
+	uint16_t getNumBatches() const { return m_numBatches; }
+
+	/// Indirect buffer of batch, with one draw per group.
+	bgfx::IndirectBufferHandle getIndirectBuffer(uint16_t _batch) const { return m_batch[_batch].m_indirectBuffer; }
+
+	/// Instance data of visible instances of batch.
+	bgfx::DynamicVertexBufferHandle getInstanceBuffer(uint16_t _batch) const { return m_batch[_batch].m_culledInstanceBuffer; }
+
+	/// Returns number of instances in batch, before culling.
+	uint32_t getNumInstances(uint16_t _batch) const
+	{
+		return bx::min(m_numInstances - uint32_t(_batch)*kBatchSize, kBatchSize);
+	}
+
+	///
+	uint32_t getNumInstances() const { return m_numInstances; }
+
+	///
+	uint16_t getNumGroups() const { return m_numGroups; }
+
+private:
+	void destroyTextures();
+
+	struct Batch
+	{
+		bgfx::IndirectBufferHandle      m_indirectBuffer;
+		bgfx::DynamicIndexBufferHandle  m_instanceCounts;
+		bgfx::DynamicIndexBufferHandle  m_instancePredicates;
+		bgfx::DynamicVertexBufferHandle m_boundsBuffer;
+		bgfx::DynamicVertexBufferHandle m_instanceBuffer;
+		bgfx::DynamicVertexBufferHandle m_culledInstanceBuffer;
+	};
+
+	bx::AllocatorI* m_allocator;
+
+	Batch* m_batch;
+
+	float* m_bounds;
+	float* m_data;
+
+	bgfx::ProgramHandle m_programCopyZ;
+	bgfx::ProgramHandle m_programDownscaleHiZ;
+	bgfx::ProgramHandle m_programOccludeProps;
+	bgfx::ProgramHandle m_programStreamCompaction;
+
+	bgfx::FrameBufferHandle        m_depthBuffer;
+	bgfx::TextureHandle            m_hiZTexture;
+	bgfx::DynamicIndexBufferHandle m_groupBuffer;
+
+	bgfx::UniformHandle s_texOcclusionDepth;
+	bgfx::UniformHandle u_inputRTSize;
+	bgfx::UniformHandle u_cullingConfig;
+
+	uint32_t m_maxInstances;
+	uint32_t m_numInstances;
+	uint16_t m_maxBatches;
+	uint16_t m_numBatches;
+	uint16_t m_maxGroups;
+	uint16_t m_numGroups;
+	uint16_t m_width;
+	uint16_t m_height;
+	uint8_t  m_numMips;
+};
+
+/// CPU reference of Hi-Z build and cull test done by `HiZCull` compute
+/// shaders, for verifying GPU results without GPU. Cull test is not fully
+/// conservative, box that touches more than 2x2 Hi-Z texels at mip selected
+/// by shader is tested only against its corner texels.
+///
+class HiZCullReference
+{
+public:
+	///
+	HiZCullReference();
+
+	///
+	~HiZCullReference();
+
+	/// Build Hi-Z mip chain.
+	///
+	/// @param[in] _depth Occluder depth in texture memory order (row 0 is
+	///   first row in memory).
+	/// @param[in] _width Width, must be power of 2.
+	/// @param[in] _height Height, must be power of 2.
+	/// @param[in] _allocator Allocator.
+	///
+	void build(const float* _depth, uint16_t _width, uint16_t _height, bx::AllocatorI* _allocator = NULL);
+
+	/// Returns true if bounding box is not occluded.
+	///
+	/// @param[in] _min World space bounding box min.
+	/// @param[in] _max World space bounding box max.
+	/// @param[in] _viewProj View projection matrix.
+	/// @param[in] _homogeneousDepth `bgfx::Caps::homogeneousDepth`.
+	/// @param[in] _originBottomLeft `bgfx::Caps::originBottomLeft`.
+	///
+	bool isVisible(const float* _min, const float* _max, const float* _viewProj, bool _homogeneousDepth, bool _originBottomLeft) const;
+
+	/// Cull instances, and calculate number of visible instances per group.
+	///
+	/// @returns Number of visible instances.
+	///
+	uint32_t cull(
+		  const HiZCullInstance* _instances
+		, uint32_t _num
+		, const float* _viewProj
+		, bool _homogeneousDepth
+		, bool _originBottomLeft
+		, bool* _outVisible
+		, uint32_t* _outGroupCount
+		, uint16_t _numGroups
+		) const;
+
+	///
+	uint8_t getNumMips() const { return m_numMips; }
+
+	/// Returns Hi-Z depth at mip level, texel coordinates are clamped.
+	float getDepth(uint8_t _mip, int32_t _x, int32_t _y) const;
+
+private:
+	void release();
+
+	bx::AllocatorI* m_allocator;
+	float*   m_mip[16];
+	uint16_t m_width;
+	uint16_t m_height;
+	uint8_t  m_numMips;
+};
+
+#endif // HIZCULL_H_HEADER_GUARD
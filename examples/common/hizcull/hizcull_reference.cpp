@@ -0,0 +1,242 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/debug.h>
+#include <bx/math.h>
+#include <bx/uint32_t.h>
+
+#include "hizcull.h"
+
+// CPU reference doesn't depend on bgfx_utils, so it can be built without
+// example entry.
+
+static bx::AllocatorI* getDefaultAllocator()
+{
+	static bx::DefaultAllocator allocator;
+	return &allocator;
+}
+
+static uint8_t calcNumMips(uint16_t _width, uint16_t _height)
+{
+	return uint8_t(32 - bx::uint32_cntlz(bx::max<uint32_t>(_width, _height) ) );
+}
+
+HiZCullReference::HiZCullReference()
+	: m_allocator(NULL)
+	, m_width(0)
+	, m_height(0)
+	, m_numMips(0)
+{
+	bx::memSet(m_mip, 0, sizeof(m_mip) );
+}
+
+HiZCullReference::~HiZCullReference()
+{
+	release();
+}
+
+void HiZCullReference::release()
+{
+	for (uint8_t ii = 0; ii < m_numMips; ++ii)
+	{
+		bx::free(m_allocator, m_mip[ii]);
+		m_mip[ii] = NULL;
+	}
+
+	m_numMips = 0;
+}
+
+void HiZCullReference::build(const float* _depth, uint16_t _width, uint16_t _height, bx::AllocatorI* _allocator)
+{
+	BX_ASSERT(bx::isPowerOf2(_width) && bx::isPowerOf2(_height), "Hi-Z size must be power of 2 (%dx%d).", _width, _height);
+
+	release();
+
+	m_allocator = NULL == _allocator ? getDefaultAllocator() : _allocator;
+	m_width     = _width;
+	m_height    = _height;
+	m_numMips   = calcNumMips(_width, _height);
+
+	m_mip[0] = (float*)bx::alloc(m_allocator, _width*_height*sizeof(float) );
+	bx::memCopy(m_mip[0], _depth, _width*_height*sizeof(float) );
+
+	uint32_t width  = _width;
+	uint32_t height = _height;
+
+	for (uint8_t lod = 1; lod < m_numMips; ++lod)
+	{
+		const float* src = m_mip[lod-1];
+		const uint32_t srcWidth  = width;
+		const uint32_t srcHeight = height;
+
+		width  = bx::max<uint32_t>(width /2, 1);
+		height = bx::max<uint32_t>(height/2, 1);
+
+		float* dst = (float*)bx::alloc(m_allocator, width*height*sizeof(float) );
+		m_mip[lod] = dst;
+
+		for (uint32_t yy = 0; yy < height; ++yy)
+		{
+			for (uint32_t xx = 0; xx < width; ++xx)
+			{
+				// Out of bounds image loads return 0 on GPU.
+				float maxDepth = 0.0f;
+
+				for (uint32_t ii = 0; ii < 4; ++ii)
+				{
+					const uint32_t sx = xx*2 + (ii&1);
+					const uint32_t sy = yy*2 + (ii>>1);
+
+					if (sx < srcWidth
+					&&  sy < srcHeight)
+					{
+						maxDepth = bx::max(maxDepth, src[sy*srcWidth + sx]);
+					}
+				}
+
+				dst[yy*width + xx] = maxDepth;
+			}
+		}
+	}
+}
+
+float HiZCullReference::getDepth(uint8_t _mip, int32_t _x, int32_t _y) const
+{
+	const int32_t width  = bx::max(m_width  >> _mip, 1);
+	const int32_t height = bx::max(m_height >> _mip, 1);
+
+	const int32_t xx = bx::clamp(_x, 0, width  - 1);
+	const int32_t yy = bx::clamp(_y, 0, height - 1);
+
+	return m_mip[_mip][yy*width + xx];
+}
+
+bool HiZCullReference::isVisible(const float* _min, const float* _max, const float* _viewProj, bool _homogeneousDepth, bool _originBottomLeft) const
+{
+	BX_ASSERT(0 < m_numMips, "HiZCullReference::build must be called before HiZCullReference::isVisible.");
+
+	float minZ = 1.0f;
+	float minXY[2] = { 1.0f, 1.0f };
+	float maxXY[2] = { 0.0f, 0.0f };
+
+	// Same steps as cs_gdr_occlude_props.
+	for (uint32_t ii = 0; ii < 8; ++ii)
+	{
+		const float corner[4] =
+		{
+			ii&1 ? _max[0] : _min[0],
+			ii&2 ? _max[1] : _min[1],
+			ii&4 ? _max[2] : _min[2],
+			1.0f,
+		};
+
+		float clip[4];
+		bx::vec4MulMtx(clip, corner, _viewProj);
+
+		if (_homogeneousDepth)
+		{
+			clip[2] = 0.5f * (clip[2] + clip[3]);
+		}
+
+		clip[2] = bx::max(clip[2], 0.0f);
+
+		const float xx = bx::clamp(clip[0]/clip[3], -1.0f, 1.0f) *  0.5f + 0.5f;
+		const float yy = bx::clamp(clip[1]/clip[3], -1.0f, 1.0f) * -0.5f + 0.5f;
+		const float zz = clip[2]/clip[3];
+
+		minXY[0] = bx::min(minXY[0], xx);
+		minXY[1] = bx::min(minXY[1], yy);
+		maxXY[0] = bx::max(maxXY[0], xx);
+		maxXY[1] = bx::max(maxXY[1], yy);
+
+		minZ = bx::clamp(bx::min(minZ, zz), 0.0f, 1.0f);
+	}
+
+	float boxUVs[4] = { minXY[0], minXY[1], maxXY[0], maxXY[1] };
+
+	// Mip selection matches shader exactly, including its shortcomings.
+	// Extent in texels is truncated, and lower level footprint is measured
+	// in UV units, so lower level is always selected. Box that touches more
+	// than 2 texels at selected mip is tested only against corner texels.
+	const int32_t sizeX = int32_t( (maxXY[0] - minXY[0]) * float(m_width) );
+	const int32_t sizeY = int32_t( (maxXY[1] - minXY[1]) * float(m_height) );
+	const int32_t size  = bx::max(sizeX, sizeY);
+
+	// log2(0) is -inf on GPU, and it's clamped to mip 0.
+	float mip = 0 < size ? bx::ceil(bx::log2(float(size) ) ) : 0.0f;
+	mip = bx::clamp(mip, 0.0f, float(m_numMips - 1) );
+
+	const float levelLower = bx::max(mip - 1.0f, 0.0f);
+	const float scale = bx::exp2(-levelLower);
+	const float dimsX = bx::ceil(boxUVs[2]*scale) - bx::floor(boxUVs[0]*scale);
+	const float dimsY = bx::ceil(boxUVs[3]*scale) - bx::floor(boxUVs[1]*scale);
+
+	if (dimsX <= 2.0f
+	&&  dimsY <= 2.0f)
+	{
+		mip = levelLower;
+	}
+
+	if (_originBottomLeft)
+	{
+		boxUVs[1] = 1.0f - boxUVs[1];
+		boxUVs[3] = 1.0f - boxUVs[3];
+	}
+
+	const uint8_t lod = uint8_t(mip);
+	const float width  = float(bx::max(m_width  >> lod, 1) );
+	const float height = float(bx::max(m_height >> lod, 1) );
+
+	const int32_t x0 = int32_t(bx::floor(boxUVs[0]*width) );
+	const int32_t y0 = int32_t(bx::floor(boxUVs[1]*height) );
+	const int32_t x1 = int32_t(bx::floor(boxUVs[2]*width) );
+	const int32_t y1 = int32_t(bx::floor(boxUVs[3]*height) );
+
+	const float maxDepth = bx::max(
+		  bx::max(getDepth(lod, x0, y0), getDepth(lod, x1, y0) )
+		, bx::max(getDepth(lod, x0, y1), getDepth(lod, x1, y1) )
+		);
+
+	return minZ <= maxDepth;
+}
+
+uint32_t HiZCullReference::cull(
+	  const HiZCullInstance* _instances
+	, uint32_t _num
+	, const float* _viewProj
+	, bool _homogeneousDepth
+	, bool _originBottomLeft
+	, bool* _outVisible
+	, uint32_t* _outGroupCount
+	, uint16_t _numGroups
+	) const
+{
+	bx::memSet(_outGroupCount, 0, _numGroups*sizeof(uint32_t) );
+
+	uint32_t numVisible = 0;
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		const HiZCullInstance& instance = _instances[ii];
+
+		const bool visible = true
+			&& instance.m_group < _numGroups
+			&& isVisible(instance.m_min, instance.m_max, _viewProj, _homogeneousDepth, _originBottomLeft)
+			;
+
+		if (NULL != _outVisible)
+		{
+			_outVisible[ii] = visible;
+		}
+
+		if (visible)
+		{
+			++_outGroupCount[instance.m_group];
+			++numVisible;
+		}
+	}
+
+	return numVisible;
+}
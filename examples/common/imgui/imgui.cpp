@@ -90,38 +90,91 @@ struct OcornutImguiContext
 		const ImVec2 clipPos   = _drawData->DisplayPos;       // (0,0) unless using multi-viewports
 		const ImVec2 clipScale = _drawData->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
 
-		// Render command lists
+		// All command lists are packed into single transient vertex and index buffer.
+		uint32_t totalVertices = 0;
+		uint32_t totalIndices  = 0;
+
 		for (int32_t ii = 0, num = _drawData->CmdListsCount; ii < num; ++ii)
 		{
-			bgfx::TransientVertexBuffer tvb;
-			bgfx::TransientIndexBuffer tib;
-
 			const ImDrawList* drawList = _drawData->CmdLists[ii];
-			uint32_t numVertices = (uint32_t)drawList->VtxBuffer.size();
-			uint32_t numIndices  = (uint32_t)drawList->IdxBuffer.size();
+			totalVertices += (uint32_t)drawList->VtxBuffer.size();
+			totalIndices  += (uint32_t)drawList->IdxBuffer.size();
+		}
+
+		// Indices are rebased into shared vertex buffer. With 16-bit indices
+		// vertex buffer is split into segments of up to 64K vertices, and
+		// commands are drawn with segment as base vertex.
+		const bool index32 = sizeof(ImDrawIdx) == 4
+			|| (65535 < totalVertices && 0 != (caps->supported & BGFX_CAPS_INDEX32) )
+			;
+
+		const uint32_t availVertices = bgfx::getAvailTransientVertexBuffer(totalVertices, m_layout);
+		const uint32_t availIndices  = bgfx::getAvailTransientIndexBuffer(totalIndices, index32);
+
+		int32_t  numLists    = 0;
+		uint32_t numVertices = 0;
+		uint32_t numIndices  = 0;
+
+		for (int32_t num = _drawData->CmdListsCount; numLists < num; ++numLists)
+		{
+			const ImDrawList* drawList = _drawData->CmdLists[numLists];
+			const uint32_t listVertices = (uint32_t)drawList->VtxBuffer.size();
+			const uint32_t listIndices  = (uint32_t)drawList->IdxBuffer.size();
 
-			if (!checkAvailTransientBuffers(numVertices, m_layout, numIndices) )
+			if (numVertices + listVertices > availVertices
+			||  numIndices  + listIndices  > availIndices)
 			{
 				// not enough space in transient buffer just quit drawing the rest...
 				break;
 			}
 
-			bgfx::allocTransientVertexBuffer(&tvb, numVertices, m_layout);
-			bgfx::allocTransientIndexBuffer(&tib, numIndices, sizeof(ImDrawIdx) == 4);
+			numVertices += listVertices;
+			numIndices  += listIndices;
+		}
+
+		if (0 == numVertices
+		||  0 == numIndices)
+		{
+			return;
+		}
+
+		bgfx::TransientVertexBuffer tvb;
+		bgfx::TransientIndexBuffer tib;
+		bgfx::allocTransientVertexBuffer(&tvb, numVertices, m_layout);
+		bgfx::allocTransientIndexBuffer(&tib, numIndices, index32);
+
+		ImDrawVert* verts = (ImDrawVert*)tvb.data;
+
+		m_batches.resize(0);
+		m_numCommands = 0;
+		m_numSubmits  = 0;
 
-			ImDrawVert* verts = (ImDrawVert*)tvb.data;
-			bx::memCopy(verts, drawList->VtxBuffer.begin(), numVertices * sizeof(ImDrawVert) );
+		uint32_t vertexStart = 0;
+		uint32_t indexStart  = 0;
+		uint32_t baseVertex  = 0;
 
-			ImDrawIdx* indices = (ImDrawIdx*)tib.data;
-			bx::memCopy(indices, drawList->IdxBuffer.begin(), numIndices * sizeof(ImDrawIdx) );
+		// Render command lists
+		for (int32_t ii = 0; ii < numLists; ++ii)
+		{
+			const ImDrawList* drawList = _drawData->CmdLists[ii];
+			const uint32_t listVertices = (uint32_t)drawList->VtxBuffer.size();
+			const ImDrawIdx* listIndices = drawList->IdxBuffer.begin();
 
-			bgfx::Encoder* encoder = bgfx::begin();
+			bx::memCopy(&verts[vertexStart], drawList->VtxBuffer.begin(), listVertices * sizeof(ImDrawVert) );
 
 			for (const ImDrawCmd* cmd = drawList->CmdBuffer.begin(), *cmdEnd = drawList->CmdBuffer.end(); cmd != cmdEnd; ++cmd)
 			{
+				++m_numCommands;
+
 				if (cmd->UserCallback)
 				{
-					cmd->UserCallback(drawList, cmd);
+					// Everything recorded before callback must be submitted before it.
+					submitBatches(tvb, tib, numVertices);
+
+					if (ImDrawCallback_ResetRenderState != cmd->UserCallback)
+					{
+						cmd->UserCallback(drawList, cmd);
+					}
 				}
 				else if (0 != cmd->ElemCount)
 				{
@@ -133,6 +186,7 @@ struct OcornutImguiContext
 
 					bgfx::TextureHandle th = m_texture;
 					bgfx::ProgramHandle program = m_program;
+					uint8_t mip = 0;
 
 					if (NULL != cmd->TextureId)
 					{
@@ -144,8 +198,7 @@ struct OcornutImguiContext
 						th = texture.s.handle;
 						if (0 != texture.s.mip)
 						{
-							const float lodEnabled[4] = { float(texture.s.mip), 1.0f, 0.0f, 0.0f };
-							bgfx::setUniform(u_imageLodEnabled, lodEnabled);
+							mip = texture.s.mip;
 							program = m_imageProgram;
 						}
 					}
@@ -168,22 +221,134 @@ struct OcornutImguiContext
 					{
 						const uint16_t xx = uint16_t(bx::max(clipRect.x, 0.0f) );
 						const uint16_t yy = uint16_t(bx::max(clipRect.y, 0.0f) );
-						encoder->setScissor(xx, yy
-								, uint16_t(bx::min(clipRect.z, 65535.0f)-xx)
-								, uint16_t(bx::min(clipRect.w, 65535.0f)-yy)
-								);
-
-						encoder->setState(state);
-						encoder->setTexture(0, s_tex, th);
-						encoder->setVertexBuffer(0, &tvb, cmd->VtxOffset, numVertices);
-						encoder->setIndexBuffer(&tib, cmd->IdxOffset, cmd->ElemCount);
-						encoder->submit(m_viewId, program);
+						const uint16_t scissor[4] =
+						{
+							xx,
+							yy,
+							uint16_t(bx::min(clipRect.z, 65535.0f)-xx),
+							uint16_t(bx::min(clipRect.w, 65535.0f)-yy),
+						};
+
+						const uint32_t cmdVertex = vertexStart + cmd->VtxOffset;
+
+						if (!index32)
+						{
+							// Command can reference up to 64K vertices starting from its vertex offset.
+							const uint32_t range = bx::min<uint32_t>(vertexStart + listVertices - cmdVertex, 65536);
+							if (cmdVertex + range - baseVertex > 65536)
+							{
+								baseVertex = cmdVertex;
+							}
+						}
+
+						const uint32_t offset = cmdVertex - baseVertex;
+						const ImDrawIdx* src = &listIndices[cmd->IdxOffset];
+
+						if (index32)
+						{
+							uint32_t* dst = &( (uint32_t*)tib.data)[indexStart];
+							for (uint32_t kk = 0; kk < cmd->ElemCount; ++kk)
+							{
+								dst[kk] = uint32_t(src[kk]) + offset;
+							}
+						}
+						else
+						{
+							uint16_t* dst = &( (uint16_t*)tib.data)[indexStart];
+							for (uint32_t kk = 0; kk < cmd->ElemCount; ++kk)
+							{
+								dst[kk] = uint16_t(src[kk] + offset);
+							}
+						}
+
+						// Consecutive commands with the same state are merged into
+						// single draw call, their indices are already contiguous.
+						Batch* last = m_batches.empty() ? NULL : &m_batches.back();
+
+						if (NULL != last
+						&&  last->state       == state
+						&&  last->texture.idx == th.idx
+						&&  last->program.idx == program.idx
+						&&  last->mip         == mip
+						&&  last->baseVertex  == baseVertex
+						&&  0 == bx::memCmp(last->scissor, scissor, sizeof(scissor) ) )
+						{
+							last->numIndices += cmd->ElemCount;
+						}
+						else
+						{
+							Batch batch;
+							batch.state      = state;
+							batch.texture    = th;
+							batch.program    = program;
+							batch.mip        = mip;
+							batch.baseVertex = baseVertex;
+							batch.startIndex = indexStart;
+							batch.numIndices = cmd->ElemCount;
+							bx::memCopy(batch.scissor, scissor, sizeof(scissor) );
+							m_batches.push_back(batch);
+						}
+
+						indexStart += cmd->ElemCount;
 					}
 				}
 			}
 
-			bgfx::end(encoder);
+			vertexStart += listVertices;
+		}
+
+		submitBatches(tvb, tib, numVertices);
+	}
+
+	void submitBatches(const bgfx::TransientVertexBuffer& _tvb, const bgfx::TransientIndexBuffer& _tib, uint32_t _numVertices)
+	{
+		if (m_batches.empty() )
+		{
+			return;
+		}
+
+		bgfx::Encoder* encoder = bgfx::begin();
+
+		// Vertex stream and texture binding are preserved between submits,
+		// and set only when they change. Last submit discards everything,
+		// encoder is left clean for callbacks and the rest of the frame.
+		const Batch* prev = NULL;
+
+		for (const Batch* batch = m_batches.begin(), *end = m_batches.end(); batch != end; ++batch)
+		{
+			if (NULL == prev
+			||  prev->baseVertex != batch->baseVertex)
+			{
+				encoder->setVertexBuffer(0, &_tvb, batch->baseVertex, _numVertices - batch->baseVertex);
+			}
+
+			if (NULL == prev
+			||  prev->texture.idx != batch->texture.idx)
+			{
+				encoder->setTexture(0, s_tex, batch->texture);
+			}
+
+			if (0 != batch->mip)
+			{
+				const float lodEnabled[4] = { float(batch->mip), 1.0f, 0.0f, 0.0f };
+				encoder->setUniform(u_imageLodEnabled, lodEnabled);
+			}
+
+			encoder->setScissor(batch->scissor[0], batch->scissor[1], batch->scissor[2], batch->scissor[3]);
+			encoder->setState(batch->state);
+			encoder->setIndexBuffer(&_tib, batch->startIndex, batch->numIndices);
+			encoder->submit(m_viewId, batch->program, 0, batch + 1 == end
+				? BGFX_DISCARD_ALL
+				: BGFX_DISCARD_INDEX_BUFFER|BGFX_DISCARD_STATE
+				);
+
+			prev = batch;
 		}
+
+		bgfx::end(encoder);
+
+		m_numSubmits += uint32_t(m_batches.size() );
+		m_batches.resize(0);
 	}
 
 	void create(float _fontSize, bx::AllocatorI* _allocator)
@@ -200,6 +365,8 @@ struct OcornutImguiContext
 
 		m_viewId = 255;
 		m_lastScroll = 0;
+		m_numCommands = 0;
+		m_numSubmits  = 0;
 		m_last = bx::getHPCounter();
 
 		ImGui::SetAllocatorFunctions(memAlloc, memFree, NULL);
@@ -408,6 +575,8 @@ struct OcornutImguiContext
 		bgfx::destroy(m_imageProgram);
 		bgfx::destroy(m_program);
 
+		m_batches.clear();
+
 		m_allocator = NULL;
 	}
 
@@ -487,6 +656,18 @@ struct OcornutImguiContext
 		render(ImGui::GetDrawData() );
 	}
 
+	struct Batch
+	{
+		uint64_t            state;
+		bgfx::TextureHandle texture;
+		bgfx::ProgramHandle program;
+		uint8_t             mip;
+		uint16_t            scissor[4];
+		uint32_t            baseVertex;
+		uint32_t            startIndex;
+		uint32_t            numIndices;
+	};
+
 	ImGuiContext*       m_imgui;
 	bx::AllocatorI*     m_allocator;
 	bgfx::VertexLayout  m_layout;
@@ -499,6 +680,9 @@ struct OcornutImguiContext
 	int64_t m_last;
 	int32_t m_lastScroll;
 	bgfx::ViewId m_viewId;
+	ImVector<Batch> m_batches;
+	uint32_t m_numCommands;
+	uint32_t m_numSubmits;
 #if USE_ENTRY
 	ImGuiKey m_keyMap[(int)entry::Key::Count];
 #endif // USE_ENTRY
@@ -538,6 +722,12 @@ void imguiEndFrame()
 	s_ctx.endFrame();
 }
 
+void imguiGetStats(uint32_t& _numCommands, uint32_t& _numSubmits)
+{
+	_numCommands = s_ctx.m_numCommands;
+	_numSubmits  = s_ctx.m_numSubmits;
+}
+
 namespace ImGui
 {
 	void PushFont(Font::Enum _font)
@@ -33,6 +33,9 @@ void imguiDestroy();
 void imguiBeginFrame(int32_t _mx, int32_t _my, uint8_t _button, int32_t _scroll, uint16_t _width, uint16_t _height, int _inputChar = -1, bgfx::ViewId _view = 255);
 void imguiEndFrame();
 
+// Number of ImDrawCmd in last frame, and number of draw calls they were merged into.
+void imguiGetStats(uint32_t& _numCommands, uint32_t& _numSubmits);
+
 namespace entry { class AppI; }
 void showExampleDialog(entry::AppI* _app, const char* _errorText = NULL);
 
@@ -0,0 +1,784 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/debug.h>
+#include <bx/math.h>
+#include <bx/simd_t.h>
+
+#include "isosurface.h"
+
+// Reference(s):
+// - Polygonising a scalar field
+//   https://web.archive.org/web/20181127124338/http://paulbourke.net/geometry/polygonise/
+
+static const uint16_t s_edges[256] =
+{
+	0x000, 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
+	0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
+	0x190, 0x099, 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
+	0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
+	0x230, 0x339, 0x033, 0x13a, 0x636, 0x73f, 0x435, 0x53c,
+	0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
+	0x3a0, 0x2a9, 0x1a3, 0x0aa, 0x7a6, 0x6af, 0x5a5, 0x4ac,
+	0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
+	0x460, 0x569, 0x663, 0x76a, 0x66 , 0x16f, 0x265, 0x36c,
+	0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
+	0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0x0ff, 0x3f5, 0x2fc,
+	0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
+	0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x055, 0x15c,
+	0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
+	0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0x0cc,
+	0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
+	0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
+	0x0cc, 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
+	0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
+	0x15c, 0x55 , 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
+	0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
+	0x2fc, 0x3f5, 0x0ff, 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
+	0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
+	0x36c, 0x265, 0x16f, 0x066, 0x76a, 0x663, 0x569, 0x460,
+	0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
+	0x4ac, 0x5a5, 0x6af, 0x7a6, 0x0aa, 0x1a3, 0x2a9, 0x3a0,
+	0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
+	0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x033, 0x339, 0x230,
+	0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
+	0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x099, 0x190,
+	0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
+	0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x000,
+};
+
+static const int8_t s_indices[256][16] =
+{
+	{  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  1,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  8,  3,  9,  8,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3,  1,  2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  2, 10,  0,  2,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  8,  3,  2, 10,  8, 10,  9,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   3, 11,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0, 11,  2,  8, 11,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  9,  0,  2,  3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1, 11,  2,  1,  9, 11,  9,  8, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   3, 10,  1, 11, 10,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0, 10,  1,  0,  8, 10,  8, 11, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  9,  0,  3, 11,  9, 11, 10,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  8, 10, 10,  8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  7,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  3,  0,  7,  3,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  1,  9,  8,  4,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  1,  9,  4,  7,  1,  7,  3,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10,  8,  4,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  4,  7,  3,  0,  4,  1,  2, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  2, 10,  9,  0,  2,  8,  4,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   2, 10,  9,  2,  9,  7,  2,  7,  3,  7,  9,  4, -1, -1, -1, -1 },
+	{   8,  4,  7,  3, 11,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  4,  7, 11,  2,  4,  2,  0,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  0,  1,  8,  4,  7,  2,  3, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  7, 11,  9,  4, 11,  9, 11,  2,  9,  2,  1, -1, -1, -1, -1 },
+	{   3, 10,  1,  3, 11, 10,  7,  8,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   1, 11, 10,  1,  4, 11,  1,  0,  4,  7, 11,  4, -1, -1, -1, -1 },
+	{   4,  7,  8,  9,  0, 11,  9, 11, 10, 11,  0,  3, -1, -1, -1, -1 },
+	{   4,  7, 11,  4, 11,  9,  9, 11, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  5,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  5,  4,  0,  8,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  5,  4,  1,  5,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  5,  4,  8,  3,  5,  3,  1,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10,  9,  5,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  0,  8,  1,  2, 10,  4,  9,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   5,  2, 10,  5,  4,  2,  4,  0,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{   2, 10,  5,  3,  2,  5,  3,  5,  4,  3,  4,  8, -1, -1, -1, -1 },
+	{   9,  5,  4,  2,  3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0, 11,  2,  0,  8, 11,  4,  9,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  5,  4,  0,  1,  5,  2,  3, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  1,  5,  2,  5,  8,  2,  8, 11,  4,  8,  5, -1, -1, -1, -1 },
+	{  10,  3, 11, 10,  1,  3,  9,  5,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  9,  5,  0,  8,  1,  8, 10,  1,  8, 11, 10, -1, -1, -1, -1 },
+	{   5,  4,  0,  5,  0, 11,  5, 11, 10, 11,  0,  3, -1, -1, -1, -1 },
+	{   5,  4,  8,  5,  8, 10, 10,  8, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  7,  8,  5,  7,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  3,  0,  9,  5,  3,  5,  7,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  7,  8,  0,  1,  7,  1,  5,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  5,  3,  3,  5,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  7,  8,  9,  5,  7, 10,  1,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  1,  2,  9,  5,  0,  5,  3,  0,  5,  7,  3, -1, -1, -1, -1 },
+	{   8,  0,  2,  8,  2,  5,  8,  5,  7, 10,  5,  2, -1, -1, -1, -1 },
+	{   2, 10,  5,  2,  5,  3,  3,  5,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   7,  9,  5,  7,  8,  9,  3, 11,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  5,  7,  9,  7,  2,  9,  2,  0,  2,  7, 11, -1, -1, -1, -1 },
+	{   2,  3, 11,  0,  1,  8,  1,  7,  8,  1,  5,  7, -1, -1, -1, -1 },
+	{  11,  2,  1, 11,  1,  7,  7,  1,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  5,  8,  8,  5,  7, 10,  1,  3, 10,  3, 11, -1, -1, -1, -1 },
+	{   5,  7,  0,  5,  0,  9,  7, 11,  0,  1,  0, 10, 11, 10,  0, -1 },
+	{  11, 10,  0, 11,  0,  3, 10,  5,  0,  8,  0,  7,  5,  7,  0, -1 },
+	{  11, 10,  5,  7, 11,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  6,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3,  5, 10,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  0,  1,  5, 10,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  8,  3,  1,  9,  8,  5, 10,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  6,  5,  2,  6,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  6,  5,  1,  2,  6,  3,  0,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  6,  5,  9,  0,  6,  0,  2,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   5,  9,  8,  5,  8,  2,  5,  2,  6,  3,  2,  8, -1, -1, -1, -1 },
+	{   2,  3, 11, 10,  6,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  0,  8, 11,  2,  0, 10,  6,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  1,  9,  2,  3, 11,  5, 10,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   5, 10,  6,  1,  9,  2,  9, 11,  2,  9,  8, 11, -1, -1, -1, -1 },
+	{   6,  3, 11,  6,  5,  3,  5,  1,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8, 11,  0, 11,  5,  0,  5,  1,  5, 11,  6, -1, -1, -1, -1 },
+	{   3, 11,  6,  0,  3,  6,  0,  6,  5,  0,  5,  9, -1, -1, -1, -1 },
+	{   6,  5,  9,  6,  9, 11, 11,  9,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   5, 10,  6,  4,  7,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  3,  0,  4,  7,  3,  6,  5, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  9,  0,  5, 10,  6,  8,  4,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  6,  5,  1,  9,  7,  1,  7,  3,  7,  9,  4, -1, -1, -1, -1 },
+	{   6,  1,  2,  6,  5,  1,  4,  7,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2,  5,  5,  2,  6,  3,  0,  4,  3,  4,  7, -1, -1, -1, -1 },
+	{   8,  4,  7,  9,  0,  5,  0,  6,  5,  0,  2,  6, -1, -1, -1, -1 },
+	{   7,  3,  9,  7,  9,  4,  3,  2,  9,  5,  9,  6,  2,  6,  9, -1 },
+	{   3, 11,  2,  7,  8,  4, 10,  6,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   5, 10,  6,  4,  7,  2,  4,  2,  0,  2,  7, 11, -1, -1, -1, -1 },
+	{   0,  1,  9,  4,  7,  8,  2,  3, 11,  5, 10,  6, -1, -1, -1, -1 },
+	{   9,  2,  1,  9, 11,  2,  9,  4, 11,  7, 11,  4,  5, 10,  6, -1 },
+	{   8,  4,  7,  3, 11,  5,  3,  5,  1,  5, 11,  6, -1, -1, -1, -1 },
+	{   5,  1, 11,  5, 11,  6,  1,  0, 11,  7, 11,  4,  0,  4, 11, -1 },
+	{   0,  5,  9,  0,  6,  5,  0,  3,  6, 11,  6,  3,  8,  4,  7, -1 },
+	{   6,  5,  9,  6,  9, 11,  4,  7,  9,  7, 11,  9, -1, -1, -1, -1 },
+	{  10,  4,  9,  6,  4, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4, 10,  6,  4,  9, 10,  0,  8,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  0,  1, 10,  6,  0,  6,  4,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  3,  1,  8,  1,  6,  8,  6,  4,  6,  1, 10, -1, -1, -1, -1 },
+	{   1,  4,  9,  1,  2,  4,  2,  6,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  0,  8,  1,  2,  9,  2,  4,  9,  2,  6,  4, -1, -1, -1, -1 },
+	{   0,  2,  4,  4,  2,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  3,  2,  8,  2,  4,  4,  2,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  4,  9, 10,  6,  4, 11,  2,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  2,  2,  8, 11,  4,  9, 10,  4, 10,  6, -1, -1, -1, -1 },
+	{   3, 11,  2,  0,  1,  6,  0,  6,  4,  6,  1, 10, -1, -1, -1, -1 },
+	{   6,  4,  1,  6,  1, 10,  4,  8,  1,  2,  1, 11,  8, 11,  1, -1 },
+	{   9,  6,  4,  9,  3,  6,  9,  1,  3, 11,  6,  3, -1, -1, -1, -1 },
+	{   8, 11,  1,  8,  1,  0, 11,  6,  1,  9,  1,  4,  6,  4,  1, -1 },
+	{   3, 11,  6,  3,  6,  0,  0,  6,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   6,  4,  8, 11,  6,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   7, 10,  6,  7,  8, 10,  8,  9, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  7,  3,  0, 10,  7,  0,  9, 10,  6,  7, 10, -1, -1, -1, -1 },
+	{  10,  6,  7,  1, 10,  7,  1,  7,  8,  1,  8,  0, -1, -1, -1, -1 },
+	{  10,  6,  7, 10,  7,  1,  1,  7,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2,  6,  1,  6,  8,  1,  8,  9,  8,  6,  7, -1, -1, -1, -1 },
+	{   2,  6,  9,  2,  9,  1,  6,  7,  9,  0,  9,  3,  7,  3,  9, -1 },
+	{   7,  8,  0,  7,  0,  6,  6,  0,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{   7,  3,  2,  6,  7,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  3, 11, 10,  6,  8, 10,  8,  9,  8,  6,  7, -1, -1, -1, -1 },
+	{   2,  0,  7,  2,  7, 11,  0,  9,  7,  6,  7, 10,  9, 10,  7, -1 },
+	{   1,  8,  0,  1,  7,  8,  1, 10,  7,  6,  7, 10,  2,  3, 11, -1 },
+	{  11,  2,  1, 11,  1,  7, 10,  6,  1,  6,  7,  1, -1, -1, -1, -1 },
+	{   8,  9,  6,  8,  6,  7,  9,  1,  6, 11,  6,  3,  1,  3,  6, -1 },
+	{   0,  9,  1, 11,  6,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   7,  8,  0,  7,  0,  6,  3, 11,  0, 11,  6,  0, -1, -1, -1, -1 },
+	{   7, 11,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   7,  6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  0,  8, 11,  7,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  1,  9, 11,  7,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  1,  9,  8,  3,  1, 11,  7,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  1,  2,  6, 11,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10,  3,  0,  8,  6, 11,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  9,  0,  2, 10,  9,  6, 11,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   6, 11,  7,  2, 10,  3, 10,  8,  3, 10,  9,  8, -1, -1, -1, -1 },
+	{   7,  2,  3,  6,  2,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   7,  0,  8,  7,  6,  0,  6,  2,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  7,  6,  2,  3,  7,  0,  1,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  6,  2,  1,  8,  6,  1,  9,  8,  8,  7,  6, -1, -1, -1, -1 },
+	{  10,  7,  6, 10,  1,  7,  1,  3,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  7,  6,  1,  7, 10,  1,  8,  7,  1,  0,  8, -1, -1, -1, -1 },
+	{   0,  3,  7,  0,  7, 10,  0, 10,  9,  6, 10,  7, -1, -1, -1, -1 },
+	{   7,  6, 10,  7, 10,  8,  8, 10,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   6,  8,  4, 11,  8,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  6, 11,  3,  0,  6,  0,  4,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  6, 11,  8,  4,  6,  9,  0,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  4,  6,  9,  6,  3,  9,  3,  1, 11,  3,  6, -1, -1, -1, -1 },
+	{   6,  8,  4,  6, 11,  8,  2, 10,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10,  3,  0, 11,  0,  6, 11,  0,  4,  6, -1, -1, -1, -1 },
+	{   4, 11,  8,  4,  6, 11,  0,  2,  9,  2, 10,  9, -1, -1, -1, -1 },
+	{  10,  9,  3, 10,  3,  2,  9,  4,  3, 11,  3,  6,  4,  6,  3, -1 },
+	{   8,  2,  3,  8,  4,  2,  4,  6,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  4,  2,  4,  6,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  9,  0,  2,  3,  4,  2,  4,  6,  4,  3,  8, -1, -1, -1, -1 },
+	{   1,  9,  4,  1,  4,  2,  2,  4,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  1,  3,  8,  6,  1,  8,  4,  6,  6, 10,  1, -1, -1, -1, -1 },
+	{  10,  1,  0, 10,  0,  6,  6,  0,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  6,  3,  4,  3,  8,  6, 10,  3,  0,  3,  9, 10,  9,  3, -1 },
+	{  10,  9,  4,  6, 10,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  9,  5,  7,  6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3,  4,  9,  5, 11,  7,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   5,  0,  1,  5,  4,  0,  7,  6, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  7,  6,  8,  3,  4,  3,  5,  4,  3,  1,  5, -1, -1, -1, -1 },
+	{   9,  5,  4, 10,  1,  2,  7,  6, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   6, 11,  7,  1,  2, 10,  0,  8,  3,  4,  9,  5, -1, -1, -1, -1 },
+	{   7,  6, 11,  5,  4, 10,  4,  2, 10,  4,  0,  2, -1, -1, -1, -1 },
+	{   3,  4,  8,  3,  5,  4,  3,  2,  5, 10,  5,  2, 11,  7,  6, -1 },
+	{   7,  2,  3,  7,  6,  2,  5,  4,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  5,  4,  0,  8,  6,  0,  6,  2,  6,  8,  7, -1, -1, -1, -1 },
+	{   3,  6,  2,  3,  7,  6,  1,  5,  0,  5,  4,  0, -1, -1, -1, -1 },
+	{   6,  2,  8,  6,  8,  7,  2,  1,  8,  4,  8,  5,  1,  5,  8, -1 },
+	{   9,  5,  4, 10,  1,  6,  1,  7,  6,  1,  3,  7, -1, -1, -1, -1 },
+	{   1,  6, 10,  1,  7,  6,  1,  0,  7,  8,  7,  0,  9,  5,  4, -1 },
+	{   4,  0, 10,  4, 10,  5,  0,  3, 10,  6, 10,  7,  3,  7, 10, -1 },
+	{   7,  6, 10,  7, 10,  8,  5,  4, 10,  4,  8, 10, -1, -1, -1, -1 },
+	{   6,  9,  5,  6, 11,  9, 11,  8,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  6, 11,  0,  6,  3,  0,  5,  6,  0,  9,  5, -1, -1, -1, -1 },
+	{   0, 11,  8,  0,  5, 11,  0,  1,  5,  5,  6, 11, -1, -1, -1, -1 },
+	{   6, 11,  3,  6,  3,  5,  5,  3,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10,  9,  5, 11,  9, 11,  8, 11,  5,  6, -1, -1, -1, -1 },
+	{   0, 11,  3,  0,  6, 11,  0,  9,  6,  5,  6,  9,  1,  2, 10, -1 },
+	{  11,  8,  5, 11,  5,  6,  8,  0,  5, 10,  5,  2,  0,  2,  5, -1 },
+	{   6, 11,  3,  6,  3,  5,  2, 10,  3, 10,  5,  3, -1, -1, -1, -1 },
+	{   5,  8,  9,  5,  2,  8,  5,  6,  2,  3,  8,  2, -1, -1, -1, -1 },
+	{   9,  5,  6,  9,  6,  0,  0,  6,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  5,  8,  1,  8,  0,  5,  6,  8,  3,  8,  2,  6,  2,  8, -1 },
+	{   1,  5,  6,  2,  1,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  3,  6,  1,  6, 10,  3,  8,  6,  5,  6,  9,  8,  9,  6, -1 },
+	{  10,  1,  0, 10,  0,  6,  9,  5,  0,  5,  6,  0, -1, -1, -1, -1 },
+	{   0,  3,  8,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  5,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  5, 10,  7,  5, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  5, 10, 11,  7,  5,  8,  3,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{   5, 11,  7,  5, 10, 11,  1,  9,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  7,  5, 10, 11,  7,  9,  8,  1,  8,  3,  1, -1, -1, -1, -1 },
+	{  11,  1,  2, 11,  7,  1,  7,  5,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3,  1,  2,  7,  1,  7,  5,  7,  2, 11, -1, -1, -1, -1 },
+	{   9,  7,  5,  9,  2,  7,  9,  0,  2,  2, 11,  7, -1, -1, -1, -1 },
+	{   7,  5,  2,  7,  2, 11,  5,  9,  2,  3,  2,  8,  9,  8,  2, -1 },
+	{   2,  5, 10,  2,  3,  5,  3,  7,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  2,  0,  8,  5,  2,  8,  7,  5, 10,  2,  5, -1, -1, -1, -1 },
+	{   9,  0,  1,  5, 10,  3,  5,  3,  7,  3, 10,  2, -1, -1, -1, -1 },
+	{   9,  8,  2,  9,  2,  1,  8,  7,  2, 10,  2,  5,  7,  5,  2, -1 },
+	{   1,  3,  5,  3,  7,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  7,  0,  7,  1,  1,  7,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  0,  3,  9,  3,  5,  5,  3,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  8,  7,  5,  9,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   5,  8,  4,  5, 10,  8, 10, 11,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   5,  0,  4,  5, 11,  0,  5, 10, 11, 11,  3,  0, -1, -1, -1, -1 },
+	{   0,  1,  9,  8,  4, 10,  8, 10, 11, 10,  4,  5, -1, -1, -1, -1 },
+	{  10, 11,  4, 10,  4,  5, 11,  3,  4,  9,  4,  1,  3,  1,  4, -1 },
+	{   2,  5,  1,  2,  8,  5,  2, 11,  8,  4,  5,  8, -1, -1, -1, -1 },
+	{   0,  4, 11,  0, 11,  3,  4,  5, 11,  2, 11,  1,  5,  1, 11, -1 },
+	{   0,  2,  5,  0,  5,  9,  2, 11,  5,  4,  5,  8, 11,  8,  5, -1 },
+	{   9,  4,  5,  2, 11,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  5, 10,  3,  5,  2,  3,  4,  5,  3,  8,  4, -1, -1, -1, -1 },
+	{   5, 10,  2,  5,  2,  4,  4,  2,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{   3, 10,  2,  3,  5, 10,  3,  8,  5,  4,  5,  8,  0,  1,  9, -1 },
+	{   5, 10,  2,  5,  2,  4,  1,  9,  2,  9,  4,  2, -1, -1, -1, -1 },
+	{   8,  4,  5,  8,  5,  3,  3,  5,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  4,  5,  1,  0,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  4,  5,  8,  5,  3,  9,  0,  5,  0,  3,  5, -1, -1, -1, -1 },
+	{   9,  4,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4, 11,  7,  4,  9, 11,  9, 10, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3,  4,  9,  7,  9, 11,  7,  9, 10, 11, -1, -1, -1, -1 },
+	{   1, 10, 11,  1, 11,  4,  1,  4,  0,  7,  4, 11, -1, -1, -1, -1 },
+	{   3,  1,  4,  3,  4,  8,  1, 10,  4,  7,  4, 11, 10, 11,  4, -1 },
+	{   4, 11,  7,  9, 11,  4,  9,  2, 11,  9,  1,  2, -1, -1, -1, -1 },
+	{   9,  7,  4,  9, 11,  7,  9,  1, 11,  2, 11,  1,  0,  8,  3, -1 },
+	{  11,  7,  4, 11,  4,  2,  2,  4,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  7,  4, 11,  4,  2,  8,  3,  4,  3,  2,  4, -1, -1, -1, -1 },
+	{   2,  9, 10,  2,  7,  9,  2,  3,  7,  7,  4,  9, -1, -1, -1, -1 },
+	{   9, 10,  7,  9,  7,  4, 10,  2,  7,  8,  7,  0,  2,  0,  7, -1 },
+	{   3,  7, 10,  3, 10,  2,  7,  4, 10,  1, 10,  0,  4,  0, 10, -1 },
+	{   1, 10,  2,  8,  7,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  9,  1,  4,  1,  7,  7,  1,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  9,  1,  4,  1,  7,  0,  8,  1,  8,  7,  1, -1, -1, -1, -1 },
+	{   4,  0,  3,  7,  4,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  8,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9, 10,  8, 10, 11,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  0,  9,  3,  9, 11, 11,  9, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  1, 10,  0, 10,  8,  8, 10, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  1, 10, 11,  3, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 11,  1, 11,  9,  9, 11,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  0,  9,  3,  9, 11,  1,  2,  9,  2, 11,  9, -1, -1, -1, -1 },
+	{   0,  2, 11,  8,  0, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  3,  8,  2,  8, 10, 10,  8,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   9, 10,  2,  0,  9,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  3,  8,  2,  8, 10,  0,  1,  8,  1, 10,  8, -1, -1, -1, -1 },
+	{   1, 10,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  3,  8,  9,  1,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  9,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  3,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+};
+
+// Cube corners, in order expected by tables above.
+static const uint8_t s_corner[8][3] =
+{
+	{ 0, 1, 1 }, // 0
+	{ 1, 1, 1 }, // 1
+	{ 1, 1, 0 }, // 2
+	{ 0, 1, 0 }, // 3
+	{ 0, 0, 1 }, // 4
+	{ 1, 0, 1 }, // 5
+	{ 1, 0, 0 }, // 6
+	{ 0, 0, 0 }, // 7
+};
+
+// Cube edges, as grid point at lower end of edge relative to cell, and edge
+// axis. Edge is shared by all cells around it, and is identified by its lower
+// grid point and axis.
+static const uint8_t s_edge[12][4] =
+{
+	{ 0, 1, 1, 0 }, // 0: 0-1
+	{ 1, 1, 0, 2 }, // 1: 1-2
+	{ 0, 1, 0, 0 }, // 2: 2-3
+	{ 0, 1, 0, 2 }, // 3: 3-0
+	{ 0, 0, 1, 0 }, // 4: 4-5
+	{ 1, 0, 0, 2 }, // 5: 5-6
+	{ 0, 0, 0, 0 }, // 6: 6-7
+	{ 0, 0, 0, 2 }, // 7: 7-4
+	{ 0, 0, 1, 1 }, // 8: 0-4
+	{ 1, 0, 1, 1 }, // 9: 1-5
+	{ 1, 0, 0, 1 }, // 10: 2-6
+	{ 0, 0, 0, 1 }, // 11: 3-7
+};
+
+static constexpr uint16_t kInvalidVertex = UINT16_MAX;
+
+IsoSurface::IsoSurface()
+	: m_allocator(NULL)
+	, m_field(NULL)
+	, m_slab(NULL)
+	, m_maxDims(0)
+	, m_maxSlabs(0)
+	, m_dims(0)
+	, m_numSlabs(0)
+	, m_cellSize(1.0f)
+	, m_balls(NULL)
+	, m_vertices(NULL)
+	, m_indices(NULL)
+	, m_numBalls(0)
+	, m_maxSlabVertices(0)
+	, m_maxSlabIndices(0)
+	, m_iso(0.0f)
+	, m_phase(Phase::Evaluate)
+	, m_nextSlab(0)
+{
+	m_origin[0] = 0.0f;
+	m_origin[1] = 0.0f;
+	m_origin[2] = 0.0f;
+}
+
+IsoSurface::~IsoSurface()
+{
+	shutdown();
+}
+
+bool IsoSurface::init(uint32_t _maxDims, uint32_t _maxSlabs, uint8_t _numThreads, bx::AllocatorI* _allocator)
+{
+	BX_ASSERT(NULL == m_field, "IsoSurface is already initialized.");
+
+	if (2 > _maxDims
+	||  0 == _maxSlabs)
+	{
+		return false;
+	}
+
+	m_allocator = _allocator;
+	if (NULL == m_allocator)
+	{
+		static bx::DefaultAllocator allocator;
+		m_allocator = &allocator;
+	}
+
+	m_maxDims  = _maxDims;
+	m_maxSlabs = _maxSlabs;
+
+	const uint32_t numPoints = _maxDims*_maxDims*_maxDims;
+	m_field = (float*)bx::alloc(m_allocator, numPoints*sizeof(float) );
+	bx::memSet(m_field, 0, numPoints*sizeof(float) );
+
+	m_slab = (Slab*)bx::alloc(m_allocator, _maxSlabs*sizeof(Slab) );
+	for (uint32_t ii = 0; ii < _maxSlabs; ++ii)
+	{
+		Slab& slab = m_slab[ii];
+		slab.m_edges       = (uint16_t*)bx::alloc(m_allocator, 2*_maxDims*_maxDims*3*sizeof(uint16_t) );
+		slab.m_begin       = 0;
+		slab.m_end         = 0;
+		slab.m_numVertices = 0;
+		slab.m_numIndices  = 0;
+		slab.m_truncated   = false;
+	}
+
+	const float origin[3] = { 0.0f, 0.0f, 0.0f };
+	setGrid(_maxDims, _maxSlabs, origin, 1.0f);
+
+	m_pool.init(_numThreads, workFn, this, "IsoSurface");
+
+	return true;
+}
+
+void IsoSurface::shutdown()
+{
+	if (NULL == m_field)
+	{
+		return;
+	}
+
+	m_pool.shutdown();
+
+	for (uint32_t ii = 0; ii < m_maxSlabs; ++ii)
+	{
+		bx::free(m_allocator, m_slab[ii].m_edges);
+	}
+
+	bx::free(m_allocator, m_slab);
+	bx::free(m_allocator, m_field);
+
+	m_slab  = NULL;
+	m_field = NULL;
+}
+
+void IsoSurface::setGrid(uint32_t _dims, uint32_t _numSlabs, const float* _origin, float _cellSize)
+{
+	m_dims     = bx::clamp<uint32_t>(_dims, 2, m_maxDims);
+	m_numSlabs = bx::clamp<uint32_t>(_numSlabs, 1, bx::min(m_maxSlabs, m_dims-1) );
+
+	m_origin[0] = _origin[0];
+	m_origin[1] = _origin[1];
+	m_origin[2] = _origin[2];
+	m_cellSize  = _cellSize;
+
+	const uint32_t numLayers = m_dims-1;
+	const uint32_t perSlab   = (numLayers + m_numSlabs - 1) / m_numSlabs;
+
+	for (uint32_t ii = 0; ii < m_numSlabs; ++ii)
+	{
+		Slab& slab = m_slab[ii];
+		slab.m_begin       = bx::min(ii*perSlab,     numLayers);
+		slab.m_end         = bx::min(ii*perSlab+perSlab, numLayers);
+		slab.m_numVertices = 0;
+		slab.m_numIndices  = 0;
+		slab.m_truncated   = false;
+	}
+}
+
+void IsoSurface::evaluate(uint32_t _slab, const IsoSurfaceMetaball* _balls, uint32_t _num)
+{
+	using namespace bx;
+
+	BX_ASSERT(_slab < m_numSlabs, "Invalid slab %d (num slabs %d).", _slab, m_numSlabs);
+
+	const Slab& slab = m_slab[_slab];
+	const uint32_t dims = m_dims;
+
+	// Slab evaluates grid points at its cell layers, last slab also
+	// evaluates top grid point layer.
+	const uint32_t zbegin = slab.m_begin;
+	const uint32_t zend   = _slab+1 == m_numSlabs ? dims : slab.m_end;
+
+	BX_ALIGN_DECL_16(float lane[4]) = { 0.0f, 1.0f, 2.0f, 3.0f };
+	BX_ALIGN_DECL_16(float result[4]);
+
+	const simd128_t one      = simd_splat(1.0f);
+	const simd128_t cellSize = simd_splat(m_cellSize);
+	const simd128_t originX  = simd_splat(m_origin[0]);
+	const simd128_t laneX    = simd_mul(simd_ld(lane), cellSize);
+
+	for (uint32_t zz = zbegin; zz < zend; ++zz)
+	{
+		const float pz = m_origin[2] + float(zz)*m_cellSize;
+
+		for (uint32_t yy = 0; yy < dims; ++yy)
+		{
+			const float py = m_origin[1] + float(yy)*m_cellSize;
+			float* field = &m_field[(zz*dims + yy)*dims];
+
+			for (uint32_t xx = 0; xx < dims; xx += 4)
+			{
+				const simd128_t px = simd_add(simd_add(originX, simd_mul(simd_splat(float(xx) ), cellSize) ), laneX);
+
+				simd128_t dist = simd_zero();
+				simd128_t prod = one;
+
+				for (uint32_t ii = 0; ii < _num; ++ii)
+				{
+					const IsoSurfaceMetaball& ball = _balls[ii];
+
+					// Y and Z distance are the same for all points in row.
+					const float dy   = ball.m_pos[1] - py;
+					const float dz   = ball.m_pos[2] - pz;
+					const float invR = ball.m_invRadius;
+
+					const simd128_t dx  = simd_sub(simd_splat(ball.m_pos[0]), px);
+					const simd128_t dyz = simd_splat(dy*dy + dz*dz);
+					const simd128_t dot = simd_mul(simd_add(simd_mul(dx, dx), dyz), simd_splat(invR*invR) );
+
+					dist = simd_add(simd_mul(dist, dot), prod);
+					prod = simd_mul(prod, dot);
+				}
+
+				simd_st(result, simd_sub(simd_div(dist, prod), one) );
+
+				const uint32_t num = bx::min<uint32_t>(4, dims-xx);
+				bx::memCopy(&field[xx], result, num*sizeof(float) );
+			}
+		}
+	}
+}
+
+void IsoSurface::calcNormal(float* _result, uint32_t _x, uint32_t _y, uint32_t _z) const
+{
+	const uint32_t dims = m_dims;
+	const uint32_t last = dims-1;
+
+	const float* field = m_field;
+	const uint32_t x0 = _x > 0 ? _x-1 : 0, x1 = bx::min(_x+1, last);
+	const uint32_t y0 = _y > 0 ? _y-1 : 0, y1 = bx::min(_y+1, last);
+	const uint32_t z0 = _z > 0 ? _z-1 : 0, z1 = bx::min(_z+1, last);
+
+	// Field decreases away from surface interior, negative gradient points
+	// outward.
+	const bx::Vec3 normal =
+	{
+		field[(_z*dims + _y)*dims + x0] - field[(_z*dims + _y)*dims + x1],
+		field[(_z*dims + y0)*dims + _x] - field[(_z*dims + y1)*dims + _x],
+		field[(z0*dims + _y)*dims + _x] - field[(z1*dims + _y)*dims + _x],
+	};
+
+	const float len = bx::length(normal);
+	bx::store(_result, len > 0.0f ? bx::mul(normal, 1.0f/len) : normal);
+}
+
+void IsoSurface::extract(
+	  uint32_t _slab
+	, float _iso
+	, IsoSurfaceVertex* _vertices
+	, uint32_t _maxVertices
+	, uint16_t* _indices
+	, uint32_t _maxIndices
+	)
+{
+	BX_ASSERT(_slab < m_numSlabs, "Invalid slab %d (num slabs %d).", _slab, m_numSlabs);
+
+	Slab& slab = m_slab[_slab];
+	slab.m_numVertices = 0;
+	slab.m_numIndices  = 0;
+	slab.m_truncated   = false;
+
+	const uint32_t dims   = m_dims;
+	const uint32_t ypitch = dims;
+	const uint32_t zpitch = dims*dims;
+	const float    invDim = 1.0f/float(dims-1);
+
+	const uint32_t maxVertices = bx::min<uint32_t>(_maxVertices, kInvalidVertex);
+	const uint32_t layerSize   = dims*dims*3;
+
+	const float* field = m_field;
+	uint16_t* edges = slab.m_edges;
+
+	uint32_t numVertices = 0;
+	uint32_t numIndices  = 0;
+
+	// Edges are cached for two grid point layers, layer of current cells
+	// and one above it. Edges at upper layer are reused by next cell layer.
+	bx::memSet(edges, 0xff, 2*layerSize*sizeof(uint16_t) );
+
+	for (uint32_t zz = slab.m_begin; zz < slab.m_end; ++zz)
+	{
+		if (zz != slab.m_begin)
+		{
+			bx::memSet(&edges[( (zz+1)&1)*layerSize], 0xff, layerSize*sizeof(uint16_t) );
+		}
+
+		for (uint32_t yy = 0; yy < dims-1; ++yy)
+		{
+			for (uint32_t xx = 0; xx < dims-1; ++xx)
+			{
+				const uint32_t offset = zz*zpitch + yy*ypitch + xx;
+
+				uint8_t cubeindex = 0;
+				for (uint32_t ii = 0; ii < 8; ++ii)
+				{
+					const uint8_t* corner = s_corner[ii];
+					const float val = field[offset + corner[2]*zpitch + corner[1]*ypitch + corner[0] ];
+					cubeindex |= (val < _iso) ? (1<<ii) : 0;
+				}
+
+				if (0 == s_edges[cubeindex])
+				{
+					continue;
+				}
+
+				// Cell generates at most 12 new vertices, and 15 indices.
+				if (numVertices + 12 > maxVertices
+				||  numIndices  + 15 > _maxIndices)
+				{
+					slab.m_truncated = true;
+					break;
+				}
+
+				const int8_t* indices = s_indices[cubeindex];
+				for (uint32_t ii = 0; indices[ii] != -1; ++ii)
+				{
+					const uint8_t* edge = s_edge[uint8_t(indices[ii])];
+					const uint32_t ex   = xx + edge[0];
+					const uint32_t ey   = yy + edge[1];
+					const uint32_t ez   = zz + edge[2];
+					const uint32_t axis = edge[3];
+
+					uint16_t& vertexIndex = edges[( (ez&1)*dims*dims + ey*dims + ex)*3 + axis];
+
+					if (kInvalidVertex == vertexIndex)
+					{
+						const uint32_t ex1 = ex + (0 == axis);
+						const uint32_t ey1 = ey + (1 == axis);
+						const uint32_t ez1 = ez + (2 == axis);
+
+						const float v0 = field[ez *zpitch + ey *ypitch + ex ];
+						const float v1 = field[ez1*zpitch + ey1*ypitch + ex1];
+
+						float lerp;
+						if (bx::abs(_iso-v1) < 0.00001f)
+						{
+							lerp = 1.0f;
+						}
+						else if (bx::abs(_iso-v0) < 0.00001f
+							 ||  bx::abs(v0-v1) < 0.00001f)
+						{
+							lerp = 0.0f;
+						}
+						else if (bx::isInfinite(v0) )
+						{
+							// Metaballs field is infinite at grid point that
+							// coincides with metaball center.
+							lerp = 1.0f;
+						}
+						else
+						{
+							lerp = (_iso - v0) / (v1 - v0);
+						}
+
+						float na[3];
+						float nb[3];
+						calcNormal(na, ex,  ey,  ez);
+						calcNormal(nb, ex1, ey1, ez1);
+
+						const float gx = float(ex) + (0 == axis ? lerp : 0.0f);
+						const float gy = float(ey) + (1 == axis ? lerp : 0.0f);
+						const float gz = float(ez) + (2 == axis ? lerp : 0.0f);
+
+						IsoSurfaceVertex& vertex = _vertices[numVertices];
+						vertex.m_pos[0] = m_origin[0] + gx*m_cellSize;
+						vertex.m_pos[1] = m_origin[1] + gy*m_cellSize;
+						vertex.m_pos[2] = m_origin[2] + gz*m_cellSize;
+
+						vertex.m_normal[0] = na[0] + lerp * (nb[0] - na[0]);
+						vertex.m_normal[1] = na[1] + lerp * (nb[1] - na[1]);
+						vertex.m_normal[2] = na[2] + lerp * (nb[2] - na[2]);
+
+						const uint32_t rr = uint8_t(gx*invDim*255.0f);
+						const uint32_t gg = uint8_t(gy*invDim*255.0f);
+						const uint32_t bb = uint8_t(gz*invDim*255.0f);
+
+						vertex.m_abgr = 0xff000000
+							| (bb<<16)
+							| (gg<<8)
+							| rr
+							;
+
+						vertexIndex = uint16_t(numVertices);
+						++numVertices;
+					}
+
+					_indices[numIndices++] = vertexIndex;
+				}
+			}
+
+			if (slab.m_truncated)
+			{
+				break;
+			}
+		}
+
+		if (slab.m_truncated)
+		{
+			break;
+		}
+	}
+
+	slab.m_numVertices = numVertices;
+	slab.m_numIndices  = numIndices;
+}
+
+void IsoSurface::update(
+	  const IsoSurfaceMetaball* _balls
+	, uint32_t _num
+	, float _iso
+	, IsoSurfaceVertex* _vertices
+	, uint32_t _maxSlabVertices
+	, uint16_t* _indices
+	, uint32_t _maxSlabIndices
+	)
+{
+	m_balls           = _balls;
+	m_numBalls        = _num;
+	m_iso             = _iso;
+	m_vertices        = _vertices;
+	m_maxSlabVertices = _maxSlabVertices;
+	m_indices         = _indices;
+	m_maxSlabIndices  = _maxSlabIndices;
+
+	// Normals are central differences reading grid point layers of
+	// neighbouring slabs, whole field must be evaluated before any slab is
+	// extracted.
+	dispatch(Phase::Evaluate);
+	dispatch(Phase::Extract);
+}
+
+void IsoSurface::dispatch(Phase::Enum _phase)
+{
+	m_phase    = _phase;
+	m_nextSlab = 0;
+
+	m_pool.dispatch();
+}
+
+void IsoSurface::runSlabs()
+{
+	for (;;)
+	{
+		uint32_t slab;
+
+		{
+			bx::MutexScope lock(m_mutex);
+
+			if (m_nextSlab >= m_numSlabs)
+			{
+				break;
+			}
+
+			slab = m_nextSlab++;
+		}
+
+		if (Phase::Evaluate == m_phase)
+		{
+			evaluate(slab, m_balls, m_numBalls);
+		}
+		else
+		{
+			extract(
+				  slab
+				, m_iso
+				, &m_vertices[slab*m_maxSlabVertices]
+				, m_maxSlabVertices
+				, &m_indices[slab*m_maxSlabIndices]
+				, m_maxSlabIndices
+				);
+		}
+	}
+}
+
+void IsoSurface::workFn(void* _userData)
+{
+	IsoSurface* isoSurface = static_cast<IsoSurface*>(_userData);
+	isoSurface->runSlabs();
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef ISOSURFACE_H_HEADER_GUARD
+#define ISOSURFACE_H_HEADER_GUARD
+
+#include <bx/allocator.h>
+#include <bx/mutex.h>
+
+#include "../workerpool/workerpool.h"
+
+/// Isosurface vertex.
+struct IsoSurfaceVertex
+{
+	float    m_pos[3];    //!< Position.
+	float    m_normal[3]; //!< Normal, interpolated field gradient.
+	uint32_t m_abgr;      //!< Position inside grid normalized to 0-1 range, as color.
+};
+
+/// Metaball. Contribution to field is 1/(d*invRadius)^2 where d is distance
+/// from center.
+struct IsoSurfaceMetaball
+{
+	float m_pos[3];    //!< Center.
+	float m_invRadius; //!< Inverse radius.
+};
+
+/// Extracts isosurface of scalar field sampled at points of regular grid,
+/// with marching cubes.
+///
+/// Grid is split into slabs of cell layers along Z axis. Slabs are
+/// independent of each other, so they can be processed from different
+/// threads, as long as all slabs are evaluated before any of them is
+/// extracted. Vertices are shared between cells of the same slab, and every
+/// slab is written into its own vertex and index range, with indices relative
+/// to the first vertex of the range.
+///
+/// Usage:
+///  - `setGrid`.
+///  - `evaluate` for every slab, or write field directly into `getField()`.
+///  - `extract` for every slab, draw slab range with
+///    `getNumVertices(slab)` and `getNumIndices(slab)`.
+///
+/// Or `update`, which evaluates and extracts all slabs spread over worker
+/// threads and calling thread.
+///
+class IsoSurface
+{
+public:
+	///
+	IsoSurface();
+
+	///
+	~IsoSurface();
+
+	/// Initialize.
+	///
+	/// @param[in] _maxDims Maximum number of grid points along each axis.
+	/// @param[in] _maxSlabs Maximum number of slabs.
+	/// @param[in] _numThreads Number of worker threads used by `update`,
+	///   clamped to `WorkerPool::kMaxThreads`. With zero, `update` runs on calling thread.
+	/// @param[in] _allocator Allocator.
+	///
+	bool init(uint32_t _maxDims, uint32_t _maxSlabs, uint8_t _numThreads = 0, bx::AllocatorI* _allocator = NULL);
+
+	///
+	void shutdown();
+
+	/// Set grid.
+	///
+	/// @param[in] _dims Number of grid points along each axis, clamped to
+	///   2 and maximum number of grid points.
+	/// @param[in] _numSlabs Number of slabs, clamped to maximum number of
+	///   slabs, and number of cell layers.
+	/// @param[in] _origin Position of first grid point.
+	/// @param[in] _cellSize Distance between neighbouring grid points.
+	///
+	void setGrid(uint32_t _dims, uint32_t _numSlabs, const float* _origin, float _cellSize);
+
+	/// Evaluate metaballs field at grid points of slab, four points at a time.
+	/// Field value is sum of all metaballs minus one.
+	///
+	/// @param[in] _slab Slab.
+	/// @param[in] _balls Metaballs.
+	/// @param[in] _num Number of metaballs.
+	///
+	void evaluate(uint32_t _slab, const IsoSurfaceMetaball* _balls, uint32_t _num);
+
+	/// Extract isosurface from cells of slab. Cells are processed in order,
+	/// processing stops at first cell whose geometry doesn't fit anymore.
+	///
+	/// @param[in] _slab Slab.
+	/// @param[in] _iso Iso value, surface is between points with field value
+	///   below and above it.
+	/// @param[out] _vertices Vertices.
+	/// @param[in] _maxVertices Maximum number of vertices, clamped to 64K.
+	/// @param[out] _indices Indices, relative to `_vertices`.
+	/// @param[in] _maxIndices Maximum number of indices.
+	///
+	void extract(
+		  uint32_t _slab
+		, float _iso
+		, IsoSurfaceVertex* _vertices
+		, uint32_t _maxVertices
+		, uint16_t* _indices
+		, uint32_t _maxIndices
+		);
+
+	/// Evaluate metaballs field and extract isosurface of all slabs. Slabs
+	/// are processed by worker threads and calling thread, function returns
+	/// when all of them are done. Slab is written at `_vertices[slab*_maxSlabVertices]`
+	/// and `_indices[slab*_maxSlabIndices]`.
+	///
+	/// @param[in] _balls Metaballs.
+	/// @param[in] _num Number of metaballs.
+	/// @param[in] _iso Iso value.
+	/// @param[out] _vertices Vertices of all slabs.
+	/// @param[in] _maxSlabVertices Maximum number of vertices per slab.
+	/// @param[out] _indices Indices of all slabs.
+	/// @param[in] _maxSlabIndices Maximum number of indices per slab.
+	///
+	void update(
+		  const IsoSurfaceMetaball* _balls
+		, uint32_t _num
+		, float _iso
+		, IsoSurfaceVertex* _vertices
+		, uint32_t _maxSlabVertices
+		, uint16_t* _indices
+		, uint32_t _maxSlabIndices
+		);
+
+	/// Returns field values, X is fastest changing, pitch of row is number
+	/// of grid points.
+	float* getField() { return m_field; }
+
+	///
+	uint32_t getDims() const { return m_dims; }
+
+	///
+	uint32_t getNumSlabs() const { return m_numSlabs; }
+
+	/// Returns number of vertices written by last `extract` of slab.
+	uint32_t getNumVertices(uint32_t _slab) const { return m_slab[_slab].m_numVertices; }
+
+	/// Returns number of indices written by last `extract` of slab.
+	uint32_t getNumIndices(uint32_t _slab) const { return m_slab[_slab].m_numIndices; }
+
+	/// Returns true if last `extract` of slab stopped because output was full.
+	bool isTruncated(uint32_t _slab) const { return m_slab[_slab].m_truncated; }
+
+private:
+	struct Slab
+	{
+		uint16_t* m_edges; //!< Vertex index of edges at two grid point layers.
+		uint32_t  m_begin; //!< First cell layer.
+		uint32_t  m_end;   //!< One past last cell layer.
+		uint32_t  m_numVertices;
+		uint32_t  m_numIndices;
+		bool      m_truncated;
+	};
+
+	struct Phase
+	{
+		enum Enum
+		{
+			Evaluate,
+			Extract,
+		};
+	};
+
+	void calcNormal(float* _result, uint32_t _x, uint32_t _y, uint32_t _z) const;
+
+	void dispatch(Phase::Enum _phase);
+	void runSlabs();
+
+	static void workFn(void* _userData);
+
+	bx::AllocatorI* m_allocator;
+
+	WorkerPool m_pool;
+	bx::Mutex  m_mutex;
+
+	// Work shared with worker threads, written before workers are woken up.
+	const IsoSurfaceMetaball* m_balls;
+	IsoSurfaceVertex* m_vertices;
+	uint16_t*   m_indices;
+	uint32_t    m_numBalls;
+	uint32_t    m_maxSlabVertices;
+	uint32_t    m_maxSlabIndices;
+	float       m_iso;
+	Phase::Enum m_phase;
+	uint32_t    m_nextSlab;
+
+	float* m_field;
+	Slab*  m_slab;
+
+	uint32_t m_maxDims;
+	uint32_t m_maxSlabs;
+	uint32_t m_dims;
+	uint32_t m_numSlabs;
+
+	float m_origin[3];
+	float m_cellSize;
+};
+
+#endif // ISOSURFACE_H_HEADER_GUARD
@@ -0,0 +1,490 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/debug.h>
+#include <bx/math.h>
+#include <bx/simd_t.h>
+
+#include "lightcull.h"
+
+static constexpr uint16_t kMaxTiles = 63;
+
+LightCull::LightCull()
+	: m_allocator(NULL)
+	, m_grid(NULL)
+	, m_indices(NULL)
+	, m_count(NULL)
+	, m_range(NULL)
+	, m_visible(NULL)
+	, m_maxLights(0)
+	, m_maxIndices(0)
+	, m_numClusters(0)
+	, m_numLights(0)
+	, m_numVisible(0)
+	, m_numIndices(0)
+	, m_numDropped(0)
+	, m_tilesX(0)
+	, m_tilesY(0)
+	, m_slices(0)
+	, m_gridHeight(0)
+	, m_sliceScale(0.0f)
+	, m_sliceBias(0.0f)
+	, m_lights(NULL)
+{
+	m_gridTexture.idx = bgfx::kInvalidHandle;
+	m_indexBuffer.idx = bgfx::kInvalidHandle;
+	m_lightBuffer.idx = bgfx::kInvalidHandle;
+	s_grid.idx        = bgfx::kInvalidHandle;
+	u_params.idx      = bgfx::kInvalidHandle;
+}
+
+LightCull::~LightCull()
+{
+	shutdown();
+}
+
+bool LightCull::isSupported()
+{
+	const bgfx::Caps* caps = bgfx::getCaps();
+
+	return 0 != (caps->supported & BGFX_CAPS_COMPUTE)
+		&& 0 != (caps->formats[bgfx::TextureFormat::RG32F] & BGFX_CAPS_FORMAT_TEXTURE_2D)
+		;
+}
+
+bool LightCull::init(
+	  uint16_t _tilesX
+	, uint16_t _tilesY
+	, uint16_t _slices
+	, uint32_t _maxLights
+	, uint32_t _maxIndices
+	, bool _createGpuResources
+	, bx::AllocatorI* _allocator
+	)
+{
+	BX_ASSERT(NULL == m_grid, "LightCull is already initialized.");
+
+	// Depth slices are stacked vertically in grid texture.
+	const uint32_t gridHeight = uint32_t(_tilesY)*_slices;
+
+	if (0 == _tilesX || kMaxTiles < _tilesX
+	||  0 == _tilesY || kMaxTiles < _tilesY
+	||  0 == _slices
+	||  0 == _maxLights
+	||  0 == _maxIndices
+	||  UINT16_MAX < gridHeight)
+	{
+		return false;
+	}
+
+	if (_createGpuResources
+	&&  bgfx::getCaps()->limits.maxTextureSize < gridHeight)
+	{
+		BX_TRACE("LightCull grid texture height %d exceeds maximum texture size %d."
+			, gridHeight
+			, bgfx::getCaps()->limits.maxTextureSize
+			);
+		return false;
+	}
+
+	m_allocator = _allocator;
+	if (NULL == m_allocator)
+	{
+		static bx::DefaultAllocator allocator;
+		m_allocator = &allocator;
+	}
+
+	m_tilesX      = _tilesX;
+	m_tilesY      = _tilesY;
+	m_slices      = _slices;
+	m_gridHeight  = uint16_t(gridHeight);
+	m_maxLights   = _maxLights;
+	m_maxIndices  = _maxIndices;
+	m_numClusters = uint32_t(_tilesX)*_tilesY*_slices;
+
+	m_grid    = (float*)bx::alloc(m_allocator, m_numClusters*2*sizeof(float) );
+	m_count   = (uint32_t*)bx::alloc(m_allocator, m_numClusters*sizeof(uint32_t) );
+	m_indices = (uint32_t*)bx::alloc(m_allocator, m_maxIndices*sizeof(uint32_t) );
+	m_range   = (LightRange*)bx::alloc(m_allocator, m_maxLights*sizeof(LightRange) );
+	m_visible = (uint32_t*)bx::alloc(m_allocator, m_maxLights*sizeof(uint32_t) );
+
+	bx::memSet(m_grid, 0, m_numClusters*2*sizeof(float) );
+
+	m_numLights  = 0;
+	m_numVisible = 0;
+	m_numIndices = 0;
+	m_numDropped = 0;
+
+	if (_createGpuResources)
+	{
+		m_gridTexture = bgfx::createTexture2D(
+			  m_tilesX
+			, m_gridHeight
+			, false
+			, 1
+			, bgfx::TextureFormat::RG32F
+			, BGFX_SAMPLER_POINT | BGFX_SAMPLER_UVW_CLAMP
+			);
+
+		m_indexBuffer = bgfx::createDynamicIndexBuffer(
+			  m_maxIndices
+			, BGFX_BUFFER_INDEX32 | BGFX_BUFFER_COMPUTE_READ
+			);
+
+		bgfx::VertexLayout layout;
+		layout.begin()
+			.add(bgfx::Attrib::TexCoord0, 4, bgfx::AttribType::Float)
+			.end();
+
+		m_lightBuffer = bgfx::createDynamicVertexBuffer(
+			  m_maxLights*2
+			, layout
+			, BGFX_BUFFER_COMPUTE_READ
+			);
+
+		s_grid   = bgfx::createUniform("s_lightCullGrid",   bgfx::UniformType::Sampler);
+		u_params = bgfx::createUniform("u_lightCullParams", bgfx::UniformType::Vec4, 2);
+	}
+
+	return true;
+}
+
+void LightCull::shutdown()
+{
+	if (NULL == m_grid)
+	{
+		return;
+	}
+
+	if (bgfx::isValid(m_gridTexture) )
+	{
+		bgfx::destroy(m_gridTexture);
+		bgfx::destroy(m_indexBuffer);
+		bgfx::destroy(m_lightBuffer);
+		bgfx::destroy(s_grid);
+		bgfx::destroy(u_params);
+
+		m_gridTexture.idx = bgfx::kInvalidHandle;
+		m_indexBuffer.idx = bgfx::kInvalidHandle;
+		m_lightBuffer.idx = bgfx::kInvalidHandle;
+		s_grid.idx        = bgfx::kInvalidHandle;
+		u_params.idx      = bgfx::kInvalidHandle;
+	}
+
+	bx::free(m_allocator, m_grid);
+	bx::free(m_allocator, m_count);
+	bx::free(m_allocator, m_indices);
+	bx::free(m_allocator, m_range);
+	bx::free(m_allocator, m_visible);
+
+	m_grid    = NULL;
+	m_count   = NULL;
+	m_indices = NULL;
+	m_range   = NULL;
+	m_visible = NULL;
+	m_lights  = NULL;
+}
+
+// Calculates view space tile edge planes, as SoA with 4 wide padding. Left
+// (bottom) edge planes are followed by right (top) edge planes.
+static void calcEdgePlanes(float* _planes, uint16_t _stride, uint16_t _num, const float* _proj, uint32_t _axis)
+{
+	float* left  = _planes;
+	float* right = &_planes[_stride*4];
+
+	for (uint16_t ii = 0; ii < _stride; ++ii)
+	{
+		// Padding planes are never touched by any light.
+		left [_stride*0 + ii] = 0.0f;
+		left [_stride*1 + ii] = 0.0f;
+		left [_stride*2 + ii] = 0.0f;
+		left [_stride*3 + ii] = -bx::kFloatLargest;
+		right[_stride*0 + ii] = 0.0f;
+		right[_stride*1 + ii] = 0.0f;
+		right[_stride*2 + ii] = 0.0f;
+		right[_stride*3 + ii] = -bx::kFloatLargest;
+	}
+
+	// Plane of points where NDC coordinate equals t is: row(axis) - t*row(w).
+	for (uint16_t ii = 0; ii <= _num; ++ii)
+	{
+		const float t = float(ii)/float(_num)*2.0f - 1.0f;
+
+		const float xx = _proj[ 0+_axis] - t*_proj[ 3];
+		const float yy = _proj[ 4+_axis] - t*_proj[ 7];
+		const float zz = _proj[ 8+_axis] - t*_proj[11];
+		const float ww = _proj[12+_axis] - t*_proj[15];
+
+		const float invLen = 1.0f/bx::sqrt(xx*xx + yy*yy + zz*zz);
+
+		if (ii < _num)
+		{
+			left[_stride*0 + ii] = xx*invLen;
+			left[_stride*1 + ii] = yy*invLen;
+			left[_stride*2 + ii] = zz*invLen;
+			left[_stride*3 + ii] = ww*invLen;
+		}
+
+		if (0 < ii)
+		{
+			right[_stride*0 + ii-1] = xx*invLen;
+			right[_stride*1 + ii-1] = yy*invLen;
+			right[_stride*2 + ii-1] = zz*invLen;
+			right[_stride*3 + ii-1] = ww*invLen;
+		}
+	}
+}
+
+// Calculates range of tiles overlapped by sphere, returns false if sphere is
+// outside of all tiles. Signed distance to edge planes decreases monotonically
+// from first to last edge, so tiles before sphere are counted against right
+// edges, and tiles not after sphere are counted against left edges. Four
+// edges are tested at once.
+static bool calcTileRange(
+	  uint8_t& _outMin
+	, uint8_t& _outMax
+	, const float* _planes
+	, uint16_t _stride
+	, const bx::Vec3& _center
+	, float _radius
+	)
+{
+	using namespace bx;
+
+	const simd128_t cx   = simd_splat(_center.x);
+	const simd128_t cy   = simd_splat(_center.y);
+	const simd128_t cz   = simd_splat(_center.z);
+	const simd128_t rad  = simd_splat(_radius);
+	const simd128_t nrad = simd_splat(-_radius);
+	const simd128_t onei = simd_isplat(1);
+
+	simd128_t numBefore = simd_zero();
+	simd128_t numUntil  = simd_zero();
+
+	const float* left  = _planes;
+	const float* right = &_planes[_stride*4];
+
+	for (uint16_t ii = 0; ii < _stride; ii += 4)
+	{
+		const simd128_t lx = simd_ld(&left[_stride*0 + ii]);
+		const simd128_t ly = simd_ld(&left[_stride*1 + ii]);
+		const simd128_t lz = simd_ld(&left[_stride*2 + ii]);
+		const simd128_t lw = simd_ld(&left[_stride*3 + ii]);
+		const simd128_t ld = simd_add(simd_add(simd_mul(lx, cx), simd_mul(ly, cy) ), simd_add(simd_mul(lz, cz), lw) );
+
+		const simd128_t rx = simd_ld(&right[_stride*0 + ii]);
+		const simd128_t ry = simd_ld(&right[_stride*1 + ii]);
+		const simd128_t rz = simd_ld(&right[_stride*2 + ii]);
+		const simd128_t rw = simd_ld(&right[_stride*3 + ii]);
+		const simd128_t rd = simd_add(simd_add(simd_mul(rx, cx), simd_mul(ry, cy) ), simd_add(simd_mul(rz, cz), rw) );
+
+		numUntil  = simd_iadd(numUntil,  simd_and(simd_cmpgt(ld, nrad), onei) );
+		numBefore = simd_iadd(numBefore, simd_and(simd_cmpge(rd, rad),  onei) );
+	}
+
+	BX_ALIGN_DECL_16(int32_t before[4]);
+	BX_ALIGN_DECL_16(int32_t until[4]);
+	simd_st(before, numBefore);
+	simd_st(until,  numUntil);
+
+	const int32_t first = before[0] + before[1] + before[2] + before[3];
+	const int32_t last  = until[0]  + until[1]  + until[2]  + until[3] - 1;
+
+	if (first > last)
+	{
+		return false;
+	}
+
+	_outMin = uint8_t(first);
+	_outMax = uint8_t(last);
+
+	return true;
+}
+
+void LightCull::bin(
+	  const float* _view
+	, const float* _proj
+	, float _near
+	, float _far
+	, const LightCullLight* _lights
+	, uint32_t _numLights
+	)
+{
+	BX_ASSERT(0.0f < _near && _near < _far, "Invalid near/far planes (near: %f, far: %f).", _near, _far);
+
+	const uint16_t strideX = uint16_t(bx::alignUp(m_tilesX, 4) );
+	const uint16_t strideY = uint16_t(bx::alignUp(m_tilesY, 4) );
+
+	BX_ALIGN_DECL_16(float planeX[(kMaxTiles+1)*8]);
+	BX_ALIGN_DECL_16(float planeY[(kMaxTiles+1)*8]);
+	calcEdgePlanes(planeX, strideX, m_tilesX, _proj, 0);
+	calcEdgePlanes(planeY, strideY, m_tilesY, _proj, 1);
+
+	const float logRange = bx::log(_far/_near);
+	m_sliceScale = float(m_slices)/logRange;
+	m_sliceBias  = -float(m_slices)*bx::log(_near)/logRange;
+
+	m_lights     = _lights;
+	m_numLights  = bx::min(_numLights, m_maxLights);
+	m_numVisible = 0;
+	m_numIndices = 0;
+	m_numDropped = 0;
+
+	bx::memSet(m_count, 0, m_numClusters*sizeof(uint32_t) );
+
+	const float maxSlice = float(m_slices - 1);
+
+	// Find cluster range of each light, and count lights per cluster.
+	for (uint32_t ii = 0; ii < m_numLights; ++ii)
+	{
+		const LightCullLight& light = _lights[ii];
+		const bx::Vec3 pos    = { light.m_posRadius[0], light.m_posRadius[1], light.m_posRadius[2] };
+		const float    radius = light.m_posRadius[3];
+		const bx::Vec3 center = bx::mul(pos, _view);
+
+		if (center.z + radius < _near
+		||  center.z - radius > _far)
+		{
+			continue;
+		}
+
+		LightRange range;
+
+		if (center.z < radius)
+		{
+			// Sphere crosses plane of the eye, where edge planes don't order
+			// points monotonically anymore.
+			range.m_x0 = 0;
+			range.m_x1 = uint8_t(m_tilesX - 1);
+			range.m_y0 = 0;
+			range.m_y1 = uint8_t(m_tilesY - 1);
+		}
+		else
+		{
+			const bool visible = true
+				&& calcTileRange(range.m_x0, range.m_x1, planeX, strideX, center, radius)
+				&& calcTileRange(range.m_y0, range.m_y1, planeY, strideY, center, radius)
+				;
+
+			if (!visible)
+			{
+				continue;
+			}
+		}
+
+		const float zmin = bx::max(center.z - radius, _near);
+		const float zmax = bx::min(center.z + radius, _far);
+		range.m_z0 = uint16_t(bx::clamp(bx::floor(bx::log(zmin)*m_sliceScale + m_sliceBias), 0.0f, maxSlice) );
+		range.m_z1 = uint16_t(bx::clamp(bx::floor(bx::log(zmax)*m_sliceScale + m_sliceBias), 0.0f, maxSlice) );
+
+		m_range[m_numVisible]   = range;
+		m_visible[m_numVisible] = ii;
+		++m_numVisible;
+
+		for (uint32_t zz = range.m_z0; zz <= range.m_z1; ++zz)
+		{
+			for (uint32_t yy = range.m_y0; yy <= range.m_y1; ++yy)
+			{
+				uint32_t* count = &m_count[getClusterIndex(0, uint16_t(yy), uint16_t(zz) )];
+				for (uint32_t xx = range.m_x0; xx <= range.m_x1; ++xx)
+				{
+					++count[xx];
+				}
+			}
+		}
+	}
+
+	// Prefix sum, clusters that don't fit into index list are truncated.
+	uint32_t offset = 0;
+	for (uint32_t ii = 0; ii < m_numClusters; ++ii)
+	{
+		const uint32_t count = bx::min(m_count[ii], m_maxIndices - offset);
+		m_numDropped += m_count[ii] - count;
+
+		m_grid[ii*2+0] = float(offset);
+		m_grid[ii*2+1] = 0.0f;
+		m_count[ii]    = count;
+
+		offset += count;
+	}
+
+	m_numIndices = offset;
+
+	// Fill light lists, in light order inside each cluster.
+	for (uint32_t ii = 0; ii < m_numVisible; ++ii)
+	{
+		const LightRange& range = m_range[ii];
+		const uint32_t    light = m_visible[ii];
+
+		for (uint32_t zz = range.m_z0; zz <= range.m_z1; ++zz)
+		{
+			for (uint32_t yy = range.m_y0; yy <= range.m_y1; ++yy)
+			{
+				const uint32_t row = getClusterIndex(0, uint16_t(yy), uint16_t(zz) );
+				for (uint32_t xx = range.m_x0; xx <= range.m_x1; ++xx)
+				{
+					const uint32_t cluster = row + xx;
+					float* grid = &m_grid[cluster*2];
+					const uint32_t num = uint32_t(grid[1]);
+
+					if (num < m_count[cluster])
+					{
+						m_indices[uint32_t(grid[0]) + num] = light;
+						grid[1] = float(num + 1);
+					}
+				}
+			}
+		}
+	}
+}
+
+void LightCull::upload()
+{
+	if (!bgfx::isValid(m_gridTexture) )
+	{
+		return;
+	}
+
+	bgfx::updateTexture2D(
+		  m_gridTexture
+		, 0
+		, 0
+		, 0
+		, 0
+		, m_tilesX
+		, m_gridHeight
+		, bgfx::copy(m_grid, m_numClusters*2*sizeof(float) )
+		);
+
+	if (0 < m_numIndices)
+	{
+		bgfx::update(m_indexBuffer, 0, bgfx::copy(m_indices, m_numIndices*sizeof(uint32_t) ) );
+	}
+
+	if (0 < m_numLights)
+	{
+		bgfx::update(m_lightBuffer, 0, bgfx::copy(m_lights, m_numLights*sizeof(LightCullLight) ) );
+	}
+}
+
+void LightCull::setBindings(uint8_t _gridStage, uint8_t _indexStage, uint8_t _lightStage) const
+{
+	const float params[8] =
+	{
+		float(m_tilesX),
+		float(m_tilesY),
+		float(m_slices),
+		float(m_numLights),
+		m_sliceScale,
+		m_sliceBias,
+		0.0f,
+		0.0f,
+	};
+
+	bgfx::setUniform(u_params, params, 2);
+	bgfx::setTexture(_gridStage, s_grid, m_gridTexture);
+	bgfx::setBuffer(_indexStage, m_indexBuffer, bgfx::Access::Read);
+	bgfx::setBuffer(_lightStage, m_lightBuffer, bgfx::Access::Read);
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef LIGHTCULL_H_HEADER_GUARD
+#define LIGHTCULL_H_HEADER_GUARD
+
+#include <bx/allocator.h>
+#include <bgfx/bgfx.h>
+
+/// Point light, laid out as two vec4 as it's stored in GPU light buffer.
+struct LightCullLight
+{
+	float m_posRadius[4]; //!< World space position, and radius.
+	float m_rgbInner[4];  //!< Color, and inner radius as fraction of radius.
+};
+
+/// Bins point lights into clusters (screen tiles x depth slices) on CPU, and
+/// uploads per cluster light lists so that all lights can be shaded in single
+/// pass. Shader side is in `lightcull.sh`.
+///
+/// GPU data:
+///  - Grid texture (RG32F, tilesX x tilesY*slices), each texel is offset into
+///    light index buffer and number of lights in cluster.
+///  - Light index buffer (dynamic index buffer, 32-bit).
+///  - Light buffer (dynamic vertex buffer, two vec4 per light).
+///
+/// Depth slices are distributed exponentially between near and far plane, so
+/// projection is expected to be perspective.
+///
+class LightCull
+{
+public:
+	///
+	LightCull();
+
+	///
+	~LightCull();
+
+	/// Returns true if renderer supports everything required to shade from
+	/// cluster data on GPU.
+	static bool isSupported();
+
+	/// Initialize.
+	///
+	/// @param[in] _tilesX Number of horizontal screen tiles (max 63).
+	/// @param[in] _tilesY Number of vertical screen tiles (max 63).
+	/// @param[in] _slices Number of depth slices. `_tilesY*_slices` must not exceed
+	///   maximum texture size, grid texture stacks slices vertically.
+	/// @param[in] _maxLights Maximum number of lights.
+	/// @param[in] _maxIndices Maximum number of light references in all clusters.
+	/// @param[in] _createGpuResources When false only CPU binning is available.
+	/// @param[in] _allocator Allocator.
+	///
+	bool init(
+		  uint16_t _tilesX
+		, uint16_t _tilesY
+		, uint16_t _slices
+		, uint32_t _maxLights
+		, uint32_t _maxIndices
+		, bool _createGpuResources = true
+		, bx::AllocatorI* _allocator = NULL
+		);
+
+	///
+	void shutdown();
+
+	/// Bin lights into clusters.
+	///
+	/// @param[in] _view View matrix.
+	/// @param[in] _proj Projection matrix.
+	/// @param[in] _near Near plane distance used for depth slices.
+	/// @param[in] _far Far plane distance used for depth slices.
+	/// @param[in] _lights Lights. Must stay valid until `upload` is called.
+	/// @param[in] _numLights Number of lights, clamped to maximum number of lights.
+	///
+	void bin(
+		  const float* _view
+		, const float* _proj
+		, float _near
+		, float _far
+		, const LightCullLight* _lights
+		, uint32_t _numLights
+		);
+
+	/// Upload result of last `bin` call to GPU resources.
+	void upload();
+
+	/// Set grid texture, light buffers and uniforms for next draw or dispatch.
+	///
+	/// @param[in] _gridStage Stage of grid texture (`LIGHTCULL_GRID_STAGE` in shader).
+	/// @param[in] _indexStage Stage of light index buffer (`LIGHTCULL_INDEX_STAGE` in shader).
+	/// @param[in] _lightStage Stage of light buffer (`LIGHTCULL_LIGHT_STAGE` in shader).
+	///
+	void setBindings(uint8_t _gridStage, uint8_t _indexStage, uint8_t _lightStage) const;
+
+	/// Returns number of clusters.
+	uint32_t getNumClusters() const { return m_numClusters; }
+
+	/// Returns cluster index.
+	uint32_t getClusterIndex(uint16_t _x, uint16_t _y, uint16_t _slice) const
+	{
+		return (uint32_t(_slice)*m_tilesY + _y)*m_tilesX + _x;
+	}
+
+	/// Returns offset of cluster light list inside light index list.
+	uint32_t getClusterOffset(uint32_t _cluster) const { return uint32_t(m_grid[_cluster*2+0]); }
+
+	/// Returns number of lights in cluster.
+	uint32_t getClusterCount(uint32_t _cluster) const { return uint32_t(m_grid[_cluster*2+1]); }
+
+	/// Returns light index list of all clusters.
+	const uint32_t* getLightIndices() const { return m_indices; }
+
+	/// Returns number of used entries in light index list.
+	uint32_t getNumIndices() const { return m_numIndices; }
+
+	/// Returns number of lights that were visible in at least one cluster.
+	uint32_t getNumVisibleLights() const { return m_numVisible; }
+
+	/// Returns number of light references dropped because light index list
+	/// was full.
+	uint32_t getNumDropped() const { return m_numDropped; }
+
+	/// Returns index of visible light, as passed to `bin`.
+	///
+	/// @param[in] _idx Visible light index, less than `getNumVisibleLights`.
+	///
+	uint32_t getVisibleLight(uint32_t _idx) const { return m_visible[_idx]; }
+
+	/// Returns inclusive range of screen tiles overlapped by visible light.
+	/// Tile y axis points up, as NDC y.
+	///
+	/// @param[in] _idx Visible light index, less than `getNumVisibleLights`.
+	/// @param[out] _rect Tile range, x0, y0, x1, y1.
+	///
+	void getVisibleLightTiles(uint32_t _idx, uint16_t _rect[4]) const
+	{
+		const LightRange& range = m_range[_idx];
+		_rect[0] = range.m_x0;
+		_rect[1] = range.m_y0;
+		_rect[2] = range.m_x1;
+		_rect[3] = range.m_y1;
+	}
+
+	/// Returns number of horizontal screen tiles.
+	uint16_t getTilesX() const { return m_tilesX; }
+
+	/// Returns number of vertical screen tiles.
+	uint16_t getTilesY() const { return m_tilesY; }
+
+private:
+	struct LightRange
+	{
+		uint8_t  m_x0, m_x1;
+		uint8_t  m_y0, m_y1;
+		uint16_t m_z0, m_z1;
+	};
+
+	bx::AllocatorI* m_allocator;
+
+	float*      m_grid;
+	uint32_t*   m_indices;
+	uint32_t*   m_count;
+	LightRange* m_range;
+	uint32_t*   m_visible;
+
+	uint32_t m_maxLights;
+	uint32_t m_maxIndices;
+	uint32_t m_numClusters;
+	uint32_t m_numLights;
+	uint32_t m_numVisible;
+	uint32_t m_numIndices;
+	uint32_t m_numDropped;
+
+	uint16_t m_tilesX;
+	uint16_t m_tilesY;
+	uint16_t m_slices;
+	uint16_t m_gridHeight;
+
+	float m_sliceScale;
+	float m_sliceBias;
+
+	const LightCullLight* m_lights;
+
+	bgfx::TextureHandle             m_gridTexture;
+	bgfx::DynamicIndexBufferHandle  m_indexBuffer;
+	bgfx::DynamicVertexBufferHandle m_lightBuffer;
+	bgfx::UniformHandle             s_grid;
+	bgfx::UniformHandle             u_params;
+};
+
+#endif // LIGHTCULL_H_HEADER_GUARD
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef __LIGHTCULL_SH__
+#define __LIGHTCULL_SH__
+
+// Shader side of LightCull (lightcull.h). Stages must match ones passed to
+// LightCull::setBindings:
+//
+//   #define LIGHTCULL_GRID_STAGE  0
+//   #define LIGHTCULL_INDEX_STAGE 1
+//   #define LIGHTCULL_LIGHT_STAGE 2
+//   #include "../common/lightcull/lightcull.sh"
+//
+//   vec2 cluster = lightCullGetCluster(ndc.xy, viewPos.z);
+//   for (int ii = 0; ii < int(cluster.y); ++ii)
+//   {
+//       uint light = lightCullGetLightIndex(cluster, ii);
+//       vec4 posRadius = lightCullGetLightPosRadius(light);
+//       vec4 rgbInner  = lightCullGetLightRgbInner(light);
+//       ...
+//   }
+
+#include <bgfx_compute.sh>
+
+#ifndef LIGHTCULL_GRID_STAGE
+#	define LIGHTCULL_GRID_STAGE 0
+#endif // LIGHTCULL_GRID_STAGE
+
+#ifndef LIGHTCULL_INDEX_STAGE
+#	define LIGHTCULL_INDEX_STAGE 1
+#endif // LIGHTCULL_INDEX_STAGE
+
+#ifndef LIGHTCULL_LIGHT_STAGE
+#	define LIGHTCULL_LIGHT_STAGE 2
+#endif // LIGHTCULL_LIGHT_STAGE
+
+SAMPLER2D(s_lightCullGrid, LIGHTCULL_GRID_STAGE);
+BUFFER_RO(b_lightCullIndices, uint, LIGHTCULL_INDEX_STAGE);
+BUFFER_RO(b_lightCullLights,  vec4, LIGHTCULL_LIGHT_STAGE);
+
+uniform vec4 u_lightCullParams[2];
+#define u_lightCullTiles      u_lightCullParams[0].xyz
+#define u_lightCullNumLights  u_lightCullParams[0].w
+#define u_lightCullSliceScale u_lightCullParams[1].x
+#define u_lightCullSliceBias  u_lightCullParams[1].y
+
+// Returns offset into light index list, and number of lights in cluster
+// containing point with NDC xy coordinate (y up), and view space depth.
+vec2 lightCullGetCluster(vec2 _ndc, float _viewZ)
+{
+	vec2  tile  = clamp(floor( (_ndc*0.5 + 0.5) * u_lightCullTiles.xy), vec2_splat(0.0), u_lightCullTiles.xy - 1.0);
+	float slice = clamp(floor(log(max(_viewZ, 1e-6) ) * u_lightCullSliceScale + u_lightCullSliceBias), 0.0, u_lightCullTiles.z - 1.0);
+
+	return texelFetch(s_lightCullGrid, ivec2(int(tile.x), int(slice*u_lightCullTiles.y + tile.y) ), 0).xy;
+}
+
+uint lightCullGetLightIndex(vec2 _cluster, int _idx)
+{
+	return b_lightCullIndices[int(_cluster.x) + _idx];
+}
+
+vec4 lightCullGetLightPosRadius(uint _light)
+{
+	return b_lightCullLights[_light*2u];
+}
+
+vec4 lightCullGetLightRgbInner(uint _light)
+{
+	return b_lightCullLights[_light*2u + 1u];
+}
+
+#endif // __LIGHTCULL_SH__
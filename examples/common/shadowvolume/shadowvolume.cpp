@@ -0,0 +1,660 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/debug.h>
+#include <bx/hash.h>
+#include <bx/math.h>
+#include <bx/simd_t.h>
+#include <bx/sort.h>
+#include <bx/timer.h>
+#include <bx/uint32_t.h>
+
+#include "shadowvolume.h"
+
+static uint16_t weldVertices(uint16_t* _output, const float* _positions, uint16_t _num, float _epsilon, bx::AllocatorI* _allocator)
+{
+	const uint32_t hashSize = bx::uint32_nextpow2(_num);
+	const uint32_t hashMask = hashSize-1;
+	const float epsilonSq = _epsilon*_epsilon;
+
+	uint16_t numVertices = 0;
+
+	const uint32_t size = sizeof(uint16_t)*(hashSize + _num);
+	uint16_t* hashTable = (uint16_t*)bx::alloc(_allocator, size);
+	bx::memSet(hashTable, 0xff, size);
+
+	uint16_t* next = hashTable + hashSize;
+
+	for (uint16_t ii = 0; ii < _num; ++ii)
+	{
+		const bx::Vec3 pos = bx::load<bx::Vec3>(&_positions[ii*3]);
+		const uint32_t hashValue = bx::hash<bx::HashMurmur2A>(&_positions[ii*3], 3*sizeof(float) ) & hashMask;
+
+		uint16_t offset = hashTable[hashValue];
+		for (; UINT16_MAX != offset; offset = next[offset])
+		{
+			const bx::Vec3 diff = bx::sub(pos, bx::load<bx::Vec3>(&_positions[offset*3]) );
+
+			if (bx::dot(diff, diff) < epsilonSq)
+			{
+				_output[ii] = _output[offset];
+				break;
+			}
+		}
+
+		if (UINT16_MAX == offset)
+		{
+			_output[ii] = ii;
+			next[ii] = hashTable[hashValue];
+			hashTable[hashValue] = ii;
+			numVertices++;
+		}
+	}
+
+	bx::free(_allocator, hashTable);
+
+	return numVertices;
+}
+
+ShadowVolumeMesh::ShadowVolumeMesh()
+	: m_allocator(NULL)
+	, m_positions(NULL)
+	, m_indices(NULL)
+	, m_planes(NULL)
+	, m_edges(NULL)
+	, m_numVertices(0)
+	, m_numFaces(0)
+	, m_numEdges(0)
+{
+}
+
+ShadowVolumeMesh::~ShadowVolumeMesh()
+{
+	shutdown();
+}
+
+bool ShadowVolumeMesh::init(
+	  const void* _vertices
+	, uint16_t _numVertices
+	, uint16_t _stride
+	, const uint16_t* _indices
+	, uint32_t _numIndices
+	, float _weldEpsilon
+	, bx::AllocatorI* _allocator
+	)
+{
+	BX_ASSERT(NULL == m_edges, "ShadowVolumeMesh is already initialized.");
+
+	if (NULL == _allocator)
+	{
+		static bx::DefaultAllocator allocator;
+		_allocator = &allocator;
+	}
+
+	m_allocator   = _allocator;
+	m_numVertices = _numVertices;
+	m_numFaces    = _numIndices/3;
+	m_numEdges    = 0;
+
+	const uint32_t numHalfEdges = m_numFaces*3;
+	const uint32_t numBlocks    = (m_numFaces+3)/4;
+
+	m_positions = (float*   )bx::alloc(m_allocator, m_numVertices*3*sizeof(float) );
+	m_indices   = (uint16_t*)bx::alloc(m_allocator, numHalfEdges*sizeof(uint16_t) );
+	m_planes    = (float*   )bx::alloc(m_allocator, numBlocks*16*sizeof(float), 16);
+	m_edges     = (Edge*    )bx::alloc(m_allocator, numHalfEdges*sizeof(Edge) );
+
+	const uint8_t* vertices = (const uint8_t*)_vertices;
+	for (uint32_t ii = 0; ii < m_numVertices; ++ii)
+	{
+		bx::memCopy(&m_positions[ii*3], &vertices[ii*_stride], 3*sizeof(float) );
+	}
+
+	bx::memCopy(m_indices, _indices, numHalfEdges*sizeof(uint16_t) );
+
+	// Face planes, padding faces get zero plane which is never facing light.
+	bx::memSet(m_planes, 0, numBlocks*16*sizeof(float) );
+
+	for (uint32_t ii = 0; ii < m_numFaces; ++ii)
+	{
+		const bx::Vec3 v0 = bx::load<bx::Vec3>(&m_positions[m_indices[ii*3+0]*3]);
+		const bx::Vec3 v1 = bx::load<bx::Vec3>(&m_positions[m_indices[ii*3+1]*3]);
+		const bx::Vec3 v2 = bx::load<bx::Vec3>(&m_positions[m_indices[ii*3+2]*3]);
+
+		const bx::Vec3 normal = bx::normalize(bx::cross(bx::sub(v2, v0), bx::sub(v1, v2) ) );
+
+		float* block = &m_planes[(ii/4)*16 + (ii%4)];
+		block[ 0] = normal.x;
+		block[ 4] = normal.y;
+		block[ 8] = normal.z;
+		block[12] = -bx::dot(normal, v0);
+	}
+
+	// Edge adjacency is found on welded vertices, so that faces on both sides
+	// of UV or normal seam are still connected. Every half-edge gets undirected
+	// key, and after sorting both halves of the same edge are next to each
+	// other, in face order.
+	uint16_t* welded = (uint16_t*)bx::alloc(m_allocator, m_numVertices*sizeof(uint16_t) );
+	weldVertices(welded, m_positions, _numVertices, _weldEpsilon, m_allocator);
+
+	uint32_t* keys       = (uint32_t*)bx::alloc(m_allocator, numHalfEdges*4*sizeof(uint32_t) );
+	uint32_t* tempKeys   = keys     + numHalfEdges;
+	uint32_t* values     = tempKeys + numHalfEdges;
+	uint32_t* tempValues = values   + numHalfEdges;
+
+	uint32_t num = 0;
+	for (uint32_t ii = 0; ii < m_numFaces; ++ii)
+	{
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			const uint16_t i0 = welded[m_indices[ii*3 + jj] ];
+			const uint16_t i1 = welded[m_indices[ii*3 + (jj+1)%3] ];
+
+			if (i0 != i1)
+			{
+				keys[num]   = i0 < i1 ? (uint32_t(i0)<<16)|i1 : (uint32_t(i1)<<16)|i0;
+				values[num] = (ii<<1) | uint32_t(i0 > i1);
+				++num;
+			}
+		}
+	}
+
+	bx::radixSort(keys, tempKeys, values, tempValues, num);
+
+	for (uint32_t ii = 0; ii < num;)
+	{
+		const uint32_t key = keys[ii];
+
+		uint32_t end = ii+1;
+		for (; end < num && keys[end] == key; ++end)
+		{
+		}
+
+		for (uint32_t jj = ii; jj < end; ++jj)
+		{
+			if (UINT32_MAX == values[jj])
+			{
+				continue;
+			}
+
+			const bool reverse = 0 != (values[jj] & 1);
+
+			Edge& edge = m_edges[m_numEdges++];
+			edge.m_i0      = uint16_t(reverse ? key&0xffff : key>>16);
+			edge.m_i1      = uint16_t(reverse ? key>>16    : key&0xffff);
+			edge.m_face[0] = values[jj]>>1;
+			edge.m_face[1] = UINT32_MAX;
+
+			// Pair with first half-edge going in opposite direction,
+			// non-manifold edges end up as multiple edges.
+			for (uint32_t kk = jj+1; kk < end; ++kk)
+			{
+				if (UINT32_MAX != values[kk]
+				&&  reverse    != (0 != (values[kk] & 1) ) )
+				{
+					edge.m_face[1] = values[kk]>>1;
+					values[kk] = UINT32_MAX;
+					break;
+				}
+			}
+		}
+
+		ii = end;
+	}
+
+	bx::free(m_allocator, keys);
+	bx::free(m_allocator, welded);
+
+	return true;
+}
+
+void ShadowVolumeMesh::shutdown()
+{
+	if (NULL == m_edges)
+	{
+		return;
+	}
+
+	bx::free(m_allocator, m_edges);
+	bx::free(m_allocator, m_planes, 16);
+	bx::free(m_allocator, m_indices);
+	bx::free(m_allocator, m_positions);
+
+	m_positions   = NULL;
+	m_indices     = NULL;
+	m_planes      = NULL;
+	m_edges       = NULL;
+	m_numVertices = 0;
+	m_numFaces    = 0;
+	m_numEdges    = 0;
+}
+
+void ShadowVolumeMesh::classify(uint8_t* _outFacing, const float* _light) const
+{
+	using namespace bx;
+
+	const simd128_t lx   = simd_splat(_light[0]);
+	const simd128_t ly   = simd_splat(_light[1]);
+	const simd128_t lz   = simd_splat(_light[2]);
+	const simd128_t zero = simd_zero();
+
+	const float* block = m_planes;
+
+	for (uint32_t ii = 0; ii < m_numFaces; ii += 4, block += 16)
+	{
+		const simd128_t px = simd_ld(&block[ 0]);
+		const simd128_t py = simd_ld(&block[ 4]);
+		const simd128_t pz = simd_ld(&block[ 8]);
+		const simd128_t pw = simd_ld(&block[12]);
+
+		const simd128_t dot  = simd_add(simd_add(simd_mul(px, lx), simd_mul(py, ly) ), simd_mul(pz, lz) );
+		const simd128_t mask = simd_cmpgt(simd_add(dot, pw), zero);
+
+		BX_ALIGN_DECL_16(uint32_t res[4]);
+		simd_st(res, mask);
+
+		for (uint32_t jj = 0, num = bx::min<uint32_t>(4, m_numFaces-ii); jj < num; ++jj)
+		{
+			_outFacing[ii+jj] = uint8_t(res[jj] & 1);
+		}
+	}
+}
+
+int32_t ShadowVolumeMesh::calcSideMultiplier(const Edge& _edge, const uint8_t* _facing) const
+{
+	// Face on missing side of boundary edge is treated as facing away from
+	// light, so boundary of front facing faces is silhouette.
+	const int32_t s0 = _facing[_edge.m_face[0] ];
+	const int32_t s1 = UINT32_MAX == _edge.m_face[1] ? 1 : 1 - _facing[_edge.m_face[1] ];
+
+	return (s0 + s1)*2 - 2;
+}
+
+void ShadowVolumeMesh::calcSize(
+	  ShadowVolumeSize& _outSize
+	, const uint8_t* _facing
+	, ShadowVolumeType::Enum _type
+	, bool _cap
+	, bool _textureAsStencil
+	) const
+{
+	const bool single = ShadowVolumeType::FaceBased == _type || _textureAsStencil;
+
+	uint32_t numSides   = 0;
+	uint32_t numIndices = 0;
+
+	for (uint32_t ii = 0; ii < m_numEdges; ++ii)
+	{
+		const int32_t kk = calcSideMultiplier(m_edges[ii], _facing);
+
+		if (0 != kk)
+		{
+			numSides   += 1;
+			numIndices += single ? 6 : 6*uint32_t(kk < 0 ? -kk : kk);
+		}
+	}
+
+	_outSize.m_numSideVertices    = numSides*4;
+	_outSize.m_numSideIndices     = numIndices;
+	_outSize.m_numFrontCapIndices = 0;
+	_outSize.m_numBackCapIndices  = 0;
+
+	if (_cap)
+	{
+		uint32_t numFront = 0;
+		for (uint32_t ii = 0; ii < m_numFaces; ++ii)
+		{
+			numFront += _facing[ii];
+		}
+
+		const uint32_t numCopies = ShadowVolumeType::EdgeBased == _type && !_textureAsStencil ? 2 : 1;
+
+		_outSize.m_numFrontCapIndices = numCopies*3*numFront;
+		_outSize.m_numBackCapIndices  = numCopies*3*(m_numFaces - numFront);
+	}
+}
+
+void ShadowVolumeMesh::write(
+	  ShadowVolumeVertex* _sideVertices
+	, uint16_t* _sideIndices
+	, uint16_t* _frontCapIndices
+	, uint16_t* _backCapIndices
+	, const uint8_t* _facing
+	, ShadowVolumeType::Enum _type
+	, bool _textureAsStencil
+	) const
+{
+	ShadowVolumeVertex* vertex = _sideVertices;
+	uint16_t* index = _sideIndices;
+	uint32_t base = 0;
+
+	for (uint32_t ii = 0; ii < m_numEdges; ++ii)
+	{
+		const Edge& edge = m_edges[ii];
+
+		const int32_t kk = calcSideMultiplier(edge, _facing);
+
+		if (0 == kk)
+		{
+			continue;
+		}
+
+		uint16_t i0      = edge.m_i0;
+		uint16_t i1      = edge.m_i1;
+		float    k       = float(kk);
+		uint32_t num     = uint32_t(kk < 0 ? -kk : kk);
+		uint16_t winding = uint16_t(kk > 0);
+
+		if (ShadowVolumeType::FaceBased == _type)
+		{
+			// Side follows winding of front facing face.
+			if (0 == _facing[edge.m_face[0] ])
+			{
+				bx::swap(i0, i1);
+			}
+
+			k       = 1.0f;
+			num     = 1;
+			winding = 1;
+		}
+		else if (_textureAsStencil)
+		{
+			num     = 1;
+			winding = 1;
+		}
+
+		BX_ASSERT(base + 4 <= UINT16_MAX+1, "Shadow volume sides don't fit 16-bit indices.");
+
+		const float* v0 = &m_positions[i0*3];
+		const float* v1 = &m_positions[i1*3];
+
+		for (uint32_t jj = 0; jj < 4; ++jj)
+		{
+			bx::memCopy(vertex[jj].m_pos, jj < 2 ? v0 : v1, 3*sizeof(float) );
+			vertex[jj].m_extrude = float(jj & 1);
+			vertex[jj].m_k       = k;
+		}
+		vertex += 4;
+
+		const uint16_t idx = uint16_t(base);
+
+		for (uint32_t jj = 0; jj < num; ++jj)
+		{
+			index[0] = idx;
+			index[1] = idx + 2 - winding;
+			index[2] = idx + 1 + winding;
+
+			index[3] = idx + 2;
+			index[4] = idx + 3 - winding*2;
+			index[5] = idx + 1 + winding*2;
+			index += 6;
+		}
+
+		base += 4;
+	}
+
+	if (NULL != _frontCapIndices
+	&&  NULL != _backCapIndices)
+	{
+		const uint32_t numCopies = ShadowVolumeType::EdgeBased == _type && !_textureAsStencil ? 2 : 1;
+
+		for (uint32_t ii = 0; ii < m_numFaces; ++ii)
+		{
+			uint16_t*& dst = _facing[ii] ? _frontCapIndices : _backCapIndices;
+
+			for (uint32_t jj = 0; jj < numCopies; ++jj)
+			{
+				bx::memCopy(dst, &m_indices[ii*3], 3*sizeof(uint16_t) );
+				dst += 3;
+			}
+		}
+	}
+}
+
+ShadowVolumeExtractor::ShadowVolumeExtractor()
+	: m_allocator(NULL)
+	, m_facing(NULL)
+	, m_maxFacing(0)
+	, m_jobs(NULL)
+	, m_numJobs(0)
+	, m_nextJob(0)
+	, m_phase(Phase::CalcSize)
+{
+}
+
+ShadowVolumeExtractor::~ShadowVolumeExtractor()
+{
+	shutdown();
+}
+
+bool ShadowVolumeExtractor::init(uint8_t _numThreads, bx::AllocatorI* _allocator)
+{
+	BX_ASSERT(NULL == m_allocator, "ShadowVolumeExtractor is already initialized.");
+
+	if (NULL == _allocator)
+	{
+		static bx::DefaultAllocator allocator;
+		_allocator = &allocator;
+	}
+
+	m_allocator = _allocator;
+	m_pool.init(_numThreads, workFn, this, "ShadowVolumeExtractor");
+
+	return true;
+}
+
+void ShadowVolumeExtractor::shutdown()
+{
+	if (NULL == m_allocator)
+	{
+		return;
+	}
+
+	m_pool.shutdown();
+
+	bx::free(m_allocator, m_facing);
+
+	m_facing    = NULL;
+	m_maxFacing = 0;
+	m_allocator = NULL;
+}
+
+void ShadowVolumeExtractor::calcSize(ShadowVolumeJob* _jobs, uint32_t _num)
+{
+	uint32_t numFaces = 0;
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		numFaces += _jobs[ii].m_mesh->getNumFaces();
+	}
+
+	if (numFaces > m_maxFacing)
+	{
+		m_maxFacing = bx::max(numFaces, m_maxFacing*2);
+		m_facing    = (uint8_t*)bx::realloc(m_allocator, m_facing, m_maxFacing);
+	}
+
+	// Every job classifies its faces into its own range of face buffer.
+	uint32_t offset = 0;
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		_jobs[ii].m_facing = &m_facing[offset];
+		offset += _jobs[ii].m_mesh->getNumFaces();
+	}
+
+	dispatch(Phase::CalcSize, _jobs, _num);
+}
+
+void ShadowVolumeExtractor::write(ShadowVolumeJob* _jobs, uint32_t _num)
+{
+	dispatch(Phase::Write, _jobs, _num);
+}
+
+void ShadowVolumeExtractor::dispatch(Phase::Enum _phase, ShadowVolumeJob* _jobs, uint32_t _num)
+{
+	m_phase   = _phase;
+	m_jobs    = _jobs;
+	m_numJobs = _num;
+	m_nextJob = 0;
+
+	m_pool.dispatch();
+}
+
+void ShadowVolumeExtractor::runJobs()
+{
+	for (;;)
+	{
+		uint32_t jobIdx;
+
+		{
+			bx::MutexScope lock(m_mutex);
+
+			if (m_nextJob >= m_numJobs)
+			{
+				break;
+			}
+
+			jobIdx = m_nextJob++;
+		}
+
+		ShadowVolumeJob& job = m_jobs[jobIdx];
+		const ShadowVolumeMesh& mesh = *job.m_mesh;
+
+		if (Phase::CalcSize == m_phase)
+		{
+			mesh.classify(job.m_facing, job.m_light);
+			mesh.calcSize(job.m_size, job.m_facing, job.m_type, job.m_cap, job.m_textureAsStencil);
+		}
+		else if (NULL != job.m_sideIndices)
+		{
+			mesh.write(
+				  job.m_sideVertices
+				, job.m_sideIndices
+				, job.m_frontCapIndices
+				, job.m_backCapIndices
+				, job.m_facing
+				, job.m_type
+				, job.m_textureAsStencil
+				);
+		}
+	}
+}
+
+void ShadowVolumeExtractor::workFn(void* _userData)
+{
+	ShadowVolumeExtractor* extractor = static_cast<ShadowVolumeExtractor*>(_userData);
+	extractor->runJobs();
+}
+
+bool shadowVolumeBenchmark(
+	  ShadowVolumeBenchmark& _result
+	, ShadowVolumeJob* _jobs
+	, uint32_t _num
+	, uint8_t _numThreads
+	, uint32_t _numIterations
+	, bx::AllocatorI* _allocator
+	)
+{
+	bx::memSet(&_result, 0, sizeof(_result) );
+
+	if (0 == _num
+	||  0 == _numIterations)
+	{
+		return false;
+	}
+
+	if (NULL == _allocator)
+	{
+		static bx::DefaultAllocator allocator;
+		_allocator = &allocator;
+	}
+
+	ShadowVolumeExtractor extractor;
+	extractor.init(_numThreads, _allocator);
+	extractor.calcSize(_jobs, _num);
+
+	uint32_t numFaces    = 0;
+	uint32_t numVertices = 0;
+	uint32_t numIndices  = 0;
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		const ShadowVolumeSize& size = _jobs[ii].m_size;
+		numFaces    += _jobs[ii].m_mesh->getNumFaces();
+		numVertices += size.m_numSideVertices;
+		numIndices  += size.m_numSideIndices + size.m_numFrontCapIndices + size.m_numBackCapIndices;
+	}
+
+	ShadowVolumeVertex* vertices = (ShadowVolumeVertex*)bx::alloc(_allocator, bx::max<uint32_t>(numVertices, 1)*sizeof(ShadowVolumeVertex) );
+	uint16_t* indices = (uint16_t*)bx::alloc(_allocator, bx::max<uint32_t>(numIndices, 1)*sizeof(uint16_t) );
+	uint8_t*  facing  = (uint8_t* )bx::alloc(_allocator, numFaces);
+
+	ShadowVolumeVertex* vertex = vertices;
+	uint16_t* index = indices;
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		ShadowVolumeJob& job = _jobs[ii];
+		const ShadowVolumeSize& size = job.m_size;
+
+		job.m_sideVertices    = vertex;
+		job.m_sideIndices     = index;
+		job.m_frontCapIndices = job.m_cap ? index + size.m_numSideIndices : NULL;
+		job.m_backCapIndices  = job.m_cap ? index + size.m_numSideIndices + size.m_numFrontCapIndices : NULL;
+
+		vertex += size.m_numSideVertices;
+		index  += size.m_numSideIndices + size.m_numFrontCapIndices + size.m_numBackCapIndices;
+	}
+
+	int64_t serial = bx::getHPCounter();
+
+	for (uint32_t iter = 0; iter < _numIterations; ++iter)
+	{
+		for (uint32_t ii = 0; ii < _num; ++ii)
+		{
+			const ShadowVolumeJob& job = _jobs[ii];
+			const ShadowVolumeMesh& mesh = *job.m_mesh;
+
+			ShadowVolumeSize size;
+			mesh.classify(facing, job.m_light);
+			mesh.calcSize(size, facing, job.m_type, job.m_cap, job.m_textureAsStencil);
+			mesh.write(
+				  job.m_sideVertices
+				, job.m_sideIndices
+				, job.m_frontCapIndices
+				, job.m_backCapIndices
+				, facing
+				, job.m_type
+				, job.m_textureAsStencil
+				);
+		}
+	}
+
+	serial = bx::getHPCounter() - serial;
+
+	int64_t threaded = bx::getHPCounter();
+
+	for (uint32_t iter = 0; iter < _numIterations; ++iter)
+	{
+		extractor.calcSize(_jobs, _num);
+		extractor.write(_jobs, _num);
+	}
+
+	threaded = bx::getHPCounter() - threaded;
+
+	extractor.shutdown();
+
+	bx::free(_allocator, facing);
+	bx::free(_allocator, indices);
+	bx::free(_allocator, vertices);
+
+	const double toMs = 1000.0/double(bx::getHPFrequency()*_numIterations);
+
+	_result.m_serialMs        = double(serial)*toMs;
+	_result.m_threadedMs      = double(threaded)*toMs;
+	_result.m_numSideVertices = numVertices;
+	_result.m_numIndices      = numIndices;
+
+	return true;
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef SHADOWVOLUME_H_HEADER_GUARD
+#define SHADOWVOLUME_H_HEADER_GUARD
+
+#include <bx/allocator.h>
+#include <bx/mutex.h>
+
+#include "../workerpool/workerpool.h"
+
+/// Shadow volume side vertex.
+struct ShadowVolumeVertex
+{
+	float m_pos[3];  //!< Model space position.
+	float m_extrude; //!< 0 for vertex on silhouette, 1 for extruded vertex.
+	float m_k;       //!< Stencil multiplier, number of times side is drawn with winding sign.
+};
+
+///
+struct ShadowVolumeType
+{
+	/// Shadow volume side generation.
+	enum Enum
+	{
+		FaceBased, //!< Side is drawn once per silhouette edge, winding follows front facing face.
+		EdgeBased, //!< Side is drawn as many times as stencil needs to change, caps are doubled.
+
+		Count
+	};
+};
+
+/// Number of vertices and indices needed for shadow volume.
+struct ShadowVolumeSize
+{
+	uint32_t m_numSideVertices;
+	uint32_t m_numSideIndices;
+	uint32_t m_numFrontCapIndices;
+	uint32_t m_numBackCapIndices;
+};
+
+/// Shadow volume geometry of single mesh.
+///
+/// Edge adjacency is built once. Vertices with the same position are welded,
+/// every edge is stored once, with the face on each side of it.
+///
+/// Per light:
+///  - `classify` faces against light.
+///  - `calcSize`, allocate buffers (usually transient) of returned size.
+///  - `write` sides and caps.
+///
+/// All per light functions are const, they can be called concurrently for
+/// different lights and meshes.
+///
+class ShadowVolumeMesh
+{
+public:
+	///
+	ShadowVolumeMesh();
+
+	///
+	~ShadowVolumeMesh();
+
+	/// Build edge adjacency.
+	///
+	/// @param[in] _vertices Vertex data, position must be 3 floats at the
+	///   start of vertex.
+	/// @param[in] _numVertices Number of vertices.
+	/// @param[in] _stride Vertex stride.
+	/// @param[in] _indices Triangle list indices.
+	/// @param[in] _numIndices Number of indices.
+	/// @param[in] _weldEpsilon Vertices closer than this are welded.
+	/// @param[in] _allocator Allocator.
+	///
+	bool init(
+		  const void* _vertices
+		, uint16_t _numVertices
+		, uint16_t _stride
+		, const uint16_t* _indices
+		, uint32_t _numIndices
+		, float _weldEpsilon = 0.0001f
+		, bx::AllocatorI* _allocator = NULL
+		);
+
+	///
+	void shutdown();
+
+	/// Classify faces against light, four faces at a time.
+	///
+	/// @param[out] _outFacing One byte per face, 1 if face is facing light.
+	/// @param[in] _light Model space light position.
+	///
+	void classify(uint8_t* _outFacing, const float* _light) const;
+
+	/// Calculate size of shadow volume.
+	///
+	/// @param[out] _outSize Size.
+	/// @param[in] _facing Result of `classify`.
+	/// @param[in] _type Side generation.
+	/// @param[in] _cap True if front and back caps are needed (depth fail).
+	/// @param[in] _textureAsStencil True if sides are drawn into stencil
+	///   texture instead of stencil buffer, every side is drawn once.
+	///
+	void calcSize(
+		  ShadowVolumeSize& _outSize
+		, const uint8_t* _facing
+		, ShadowVolumeType::Enum _type
+		, bool _cap
+		, bool _textureAsStencil
+		) const;
+
+	/// Write shadow volume. Cap indices index vertices passed to `init`.
+	///
+	/// @param[out] _sideVertices Side vertices.
+	/// @param[out] _sideIndices Side indices.
+	/// @param[out] _frontCapIndices Front cap indices, can be NULL if caps are not needed.
+	/// @param[out] _backCapIndices Back cap indices, can be NULL if caps are not needed.
+	/// @param[in] _facing Result of `classify`.
+	/// @param[in] _type Side generation.
+	/// @param[in] _textureAsStencil See `calcSize`.
+	///
+	void write(
+		  ShadowVolumeVertex* _sideVertices
+		, uint16_t* _sideIndices
+		, uint16_t* _frontCapIndices
+		, uint16_t* _backCapIndices
+		, const uint8_t* _facing
+		, ShadowVolumeType::Enum _type
+		, bool _textureAsStencil
+		) const;
+
+	///
+	uint32_t getNumFaces() const { return m_numFaces; }
+
+	///
+	uint32_t getNumEdges() const { return m_numEdges; }
+
+private:
+	struct Edge
+	{
+		uint16_t m_i0;      //!< First vertex, in winding order of first face.
+		uint16_t m_i1;      //!< Second vertex.
+		uint32_t m_face[2]; //!< Face with edge i0-i1, face with edge i1-i0 or `UINT32_MAX`.
+	};
+
+	int32_t calcSideMultiplier(const Edge& _edge, const uint8_t* _facing) const;
+
+	bx::AllocatorI* m_allocator;
+
+	float*    m_positions; //!< xyz per vertex.
+	uint16_t* m_indices;   //!< Triangle indices as passed to `init`.
+	float*    m_planes;    //!< Face planes, SoA in blocks of four faces, 16 bytes aligned.
+	Edge*     m_edges;
+
+	uint32_t m_numVertices;
+	uint32_t m_numFaces;
+	uint32_t m_numEdges;
+};
+
+/// Shadow volume of single mesh and light, processed by `ShadowVolumeExtractor`.
+struct ShadowVolumeJob
+{
+	const ShadowVolumeMesh* m_mesh;  //!< Mesh.
+	float m_light[3];                //!< Model space light position.
+	ShadowVolumeType::Enum m_type;   //!< Side generation.
+	bool m_cap;                      //!< See `ShadowVolumeMesh::calcSize`.
+	bool m_textureAsStencil;         //!< See `ShadowVolumeMesh::calcSize`.
+
+	ShadowVolumeSize m_size;         //!< Written by `ShadowVolumeExtractor::calcSize`.
+	uint8_t*         m_facing;       //!< Written by `ShadowVolumeExtractor::calcSize`, valid until next `calcSize`.
+
+	ShadowVolumeVertex* m_sideVertices; //!< Set by caller before `ShadowVolumeExtractor::write`.
+	uint16_t* m_sideIndices;            //!< Set by caller, job is skipped if NULL.
+	uint16_t* m_frontCapIndices;        //!< Set by caller, NULL if caps are not needed.
+	uint16_t* m_backCapIndices;         //!< Set by caller, NULL if caps are not needed.
+};
+
+/// Extracts shadow volumes of many meshes and lights on worker threads.
+///
+/// Usage:
+///  - Fill mesh, light and options of jobs.
+///  - `calcSize`, allocate buffers of returned size for every job.
+///  - `write`.
+///
+/// Jobs are processed by worker threads and calling thread, functions return
+/// when all jobs are done.
+///
+class ShadowVolumeExtractor
+{
+public:
+	///
+	ShadowVolumeExtractor();
+
+	///
+	~ShadowVolumeExtractor();
+
+	/// Start worker threads.
+	///
+	/// @param[in] _numThreads Number of worker threads, clamped to `WorkerPool::kMaxThreads`.
+	///   With zero, jobs are processed on calling thread.
+	/// @param[in] _allocator Allocator.
+	///
+	bool init(uint8_t _numThreads, bx::AllocatorI* _allocator = NULL);
+
+	///
+	void shutdown();
+
+	/// Classify faces and calculate size of every job.
+	///
+	/// @param[in, out] _jobs Jobs.
+	/// @param[in] _num Number of jobs.
+	///
+	void calcSize(ShadowVolumeJob* _jobs, uint32_t _num);
+
+	/// Write sides and caps of every job, after `calcSize`.
+	///
+	/// @param[in] _jobs Jobs.
+	/// @param[in] _num Number of jobs.
+	///
+	void write(ShadowVolumeJob* _jobs, uint32_t _num);
+
+private:
+	struct Phase
+	{
+		enum Enum
+		{
+			CalcSize,
+			Write,
+		};
+	};
+
+	void dispatch(Phase::Enum _phase, ShadowVolumeJob* _jobs, uint32_t _num);
+	void runJobs();
+
+	static void workFn(void* _userData);
+
+	bx::AllocatorI* m_allocator;
+
+	WorkerPool m_pool;
+	bx::Mutex  m_mutex;
+
+	uint8_t* m_facing;
+	uint32_t m_maxFacing;
+
+	// Work shared with worker threads, written before workers are woken up.
+	ShadowVolumeJob* m_jobs;
+	uint32_t    m_numJobs;
+	uint32_t    m_nextJob;
+	Phase::Enum m_phase;
+};
+
+/// Result of `shadowVolumeBenchmark`.
+struct ShadowVolumeBenchmark
+{
+	double   m_serialMs;        //!< Time per iteration with all jobs processed on calling thread, in milliseconds.
+	double   m_threadedMs;      //!< Time per iteration with `ShadowVolumeExtractor`, in milliseconds.
+	uint32_t m_numSideVertices; //!< Side vertices of all jobs.
+	uint32_t m_numIndices;      //!< Side and cap indices of all jobs.
+};
+
+/// Extract shadow volumes of all jobs into memory allocated by benchmark,
+/// once on calling thread and once with `ShadowVolumeExtractor`, and measure
+/// time. Doesn't require bgfx to be initialized. Output pointers of jobs are
+/// left pointing to freed memory.
+///
+/// @param[out] _result Benchmark result.
+/// @param[in, out] _jobs Jobs, with mesh, light and options set.
+/// @param[in] _num Number of jobs.
+/// @param[in] _numThreads Number of worker threads of extractor.
+/// @param[in] _numIterations Number of times all jobs are extracted for timing.
+/// @param[in] _allocator Allocator.
+///
+bool shadowVolumeBenchmark(
+	  ShadowVolumeBenchmark& _result
+	, ShadowVolumeJob* _jobs
+	, uint32_t _num
+	, uint8_t _numThreads
+	, uint32_t _numIterations = 1
+	, bx::AllocatorI* _allocator = NULL
+	);
+
+#endif // SHADOWVOLUME_H_HEADER_GUARD
@@ -0,0 +1,536 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/debug.h>
+#include <bx/math.h>
+
+#include "terrainlod.h"
+
+static bool touch(const TerrainRect& _a, const TerrainRect& _b)
+{
+	return true
+		&& _a.m_x <= _b.m_x + _b.m_width
+		&& _b.m_x <= _a.m_x + _a.m_width
+		&& _a.m_y <= _b.m_y + _b.m_height
+		&& _b.m_y <= _a.m_y + _a.m_height
+		;
+}
+
+static TerrainRect merge(const TerrainRect& _a, const TerrainRect& _b)
+{
+	const uint32_t sx = bx::min(_a.m_x, _b.m_x);
+	const uint32_t sy = bx::min(_a.m_y, _b.m_y);
+	const uint32_t ex = bx::max(_a.m_x + _a.m_width,  _b.m_x + _b.m_width);
+	const uint32_t ey = bx::max(_a.m_y + _a.m_height, _b.m_y + _b.m_height);
+
+	TerrainRect result;
+	result.m_x      = uint16_t(sx);
+	result.m_y      = uint16_t(sy);
+	result.m_width  = uint16_t(ex - sx);
+	result.m_height = uint16_t(ey - sy);
+	return result;
+}
+
+static uint32_t area(const TerrainRect& _rect)
+{
+	return uint32_t(_rect.m_width)*_rect.m_height;
+}
+
+TerrainDirtyRects::TerrainDirtyRects()
+	: m_num(0)
+{
+}
+
+void TerrainDirtyRects::add(uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height)
+{
+	if (0 == _width
+	||  0 == _height)
+	{
+		return;
+	}
+
+	TerrainRect rect = { _x, _y, _width, _height };
+
+	for (;;)
+	{
+		// Absorb everything new rectangle touches, repeat because merged
+		// rectangle might touch rectangles that were skipped.
+		for (bool merged = true; merged;)
+		{
+			merged = false;
+
+			for (uint8_t ii = 0; ii < m_num;)
+			{
+				if (touch(rect, m_rect[ii]) )
+				{
+					rect = merge(rect, m_rect[ii]);
+					m_rect[ii] = m_rect[--m_num];
+					merged = true;
+				}
+				else
+				{
+					++ii;
+				}
+			}
+		}
+
+		if (kMaxRects > m_num)
+		{
+			break;
+		}
+
+		// Out of rectangles, merge with the one that adds the least area
+		// that wasn't modified, and try again.
+		uint8_t  best     = 0;
+		uint32_t bestCost = UINT32_MAX;
+
+		for (uint8_t ii = 0; ii < m_num; ++ii)
+		{
+			const uint32_t cost = area(merge(rect, m_rect[ii]) ) - area(m_rect[ii]) - area(rect);
+
+			if (cost < bestCost)
+			{
+				best     = ii;
+				bestCost = cost;
+			}
+		}
+
+		rect = merge(rect, m_rect[best]);
+		m_rect[best] = m_rect[--m_num];
+	}
+
+	m_rect[m_num++] = rect;
+}
+
+void TerrainDirtyRects::reset()
+{
+	m_num = 0;
+}
+
+static void buildFrustumPlanes(float _planes[5][4], const float* _viewProj)
+{
+	// Near plane is skipped, its depth depends on homogeneous depth and
+	// culling against it doesn't remove much terrain.
+	for (uint32_t ii = 0; ii < 4; ++ii)
+	{
+		const float* row = &_viewProj[ii*4];
+		_planes[0][ii] = row[3] + row[0];
+		_planes[1][ii] = row[3] - row[0];
+		_planes[2][ii] = row[3] + row[1];
+		_planes[3][ii] = row[3] - row[1];
+		_planes[4][ii] = row[3] - row[2];
+	}
+}
+
+static bool isInFrustum(const float _planes[5][4], const float* _min, const float* _max)
+{
+	for (uint32_t ii = 0; ii < 5; ++ii)
+	{
+		const float* plane = _planes[ii];
+
+		const float px = 0.0f <= plane[0] ? _max[0] : _min[0];
+		const float py = 0.0f <= plane[1] ? _max[1] : _min[1];
+		const float pz = 0.0f <= plane[2] ? _max[2] : _min[2];
+
+		if (0.0f > plane[0]*px + plane[1]*py + plane[2]*pz + plane[3])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static float distanceSq(const float* _pos, const float* _min, const float* _max)
+{
+	float result = 0.0f;
+
+	for (uint32_t ii = 0; ii < 3; ++ii)
+	{
+		const float dist = 0.0f
+			+ bx::max(_min[ii] - _pos[ii], 0.0f)
+			+ bx::max(_pos[ii] - _max[ii], 0.0f)
+			;
+		result += dist*dist;
+	}
+
+	return result;
+}
+
+TerrainLod::TerrainLod()
+	: m_allocator(NULL)
+	, m_minMax(NULL)
+	, m_patch(NULL)
+	, m_lodMap(NULL)
+	, m_heightScale(1.0f)
+	, m_maxPatches(0)
+	, m_numPatches(0)
+	, m_size(0)
+	, m_leafSize(0)
+	, m_numLeafs(0)
+	, m_numLods(0)
+{
+}
+
+TerrainLod::~TerrainLod()
+{
+	shutdown();
+}
+
+bool TerrainLod::init(
+	  uint16_t _size
+	, uint16_t _leafSize
+	, float _heightScale
+	, const uint8_t* _heightMap
+	, bx::AllocatorI* _allocator
+	)
+{
+	BX_ASSERT(NULL == m_minMax, "TerrainLod is already initialized.");
+
+	const uint32_t numQuads = _size - 1u;
+
+	// Patch is stitched to coarser neighbor by moving vertices between its
+	// corners, leaf of 1 quad has none and would leave T-junctions.
+	if (!bx::isPowerOf2(numQuads)
+	||  !bx::isPowerOf2<uint32_t>(_leafSize)
+	||  2 > _leafSize
+	||  _leafSize > numQuads)
+	{
+		BX_WARN(false
+			, "Height map size must be power of two plus one (%d), and leaf size power of two, at least 2, and not larger than it (%d)."
+			, _size
+			, _leafSize
+			);
+		return false;
+	}
+
+	const uint8_t numLods = uint8_t(bx::uint32_cnttz(numQuads/_leafSize) + 1);
+
+	if (kMaxLods < numLods)
+	{
+		BX_WARN(false, "Too many LODs %d (max: %d).", numLods, kMaxLods);
+		return false;
+	}
+
+	if (NULL == _allocator)
+	{
+		static bx::DefaultAllocator allocator;
+		_allocator = &allocator;
+	}
+
+	m_allocator   = _allocator;
+	m_size        = _size;
+	m_leafSize    = _leafSize;
+	m_numLeafs    = uint16_t(numQuads/_leafSize);
+	m_numLods     = numLods;
+	m_heightScale = _heightScale;
+
+	uint32_t numNodes = 0;
+	for (uint8_t lod = 0; lod < m_numLods; ++lod)
+	{
+		const uint32_t num = m_numLeafs >> lod;
+		m_offset[lod] = numNodes;
+		numNodes += num*num;
+	}
+
+	// Quadrants are never smaller than leaf, there can't be more patches
+	// than leafs.
+	m_maxPatches = uint32_t(m_numLeafs)*m_numLeafs;
+	m_numPatches = 0;
+
+	m_minMax = (uint8_t*)bx::alloc(m_allocator, numNodes*2);
+	m_patch  = (TerrainPatch*)bx::alloc(m_allocator, m_maxPatches*sizeof(TerrainPatch) );
+	m_lodMap = (uint8_t*)bx::alloc(m_allocator, m_maxPatches);
+	bx::memSet(m_lodMap, 0, m_maxPatches);
+
+	const TerrainRect rect = { 0, 0, _size, _size };
+	updateHeights(_heightMap, rect);
+
+	return true;
+}
+
+void TerrainLod::shutdown()
+{
+	if (NULL == m_minMax)
+	{
+		return;
+	}
+
+	bx::free(m_allocator, m_lodMap);
+	bx::free(m_allocator, m_patch);
+	bx::free(m_allocator, m_minMax);
+
+	m_minMax = NULL;
+	m_patch  = NULL;
+	m_lodMap = NULL;
+	m_maxPatches = 0;
+	m_numPatches = 0;
+}
+
+void TerrainLod::updateHeights(const uint8_t* _heightMap, const TerrainRect& _rect)
+{
+	if (0 == _rect.m_width
+	||  0 == _rect.m_height)
+	{
+		return;
+	}
+
+	const uint32_t x0 = _rect.m_x;
+	const uint32_t y0 = _rect.m_y;
+	const uint32_t x1 = bx::min<uint32_t>(_rect.m_x + _rect.m_width,  m_size) - 1;
+	const uint32_t y1 = bx::min<uint32_t>(_rect.m_y + _rect.m_height, m_size) - 1;
+
+	// Edge samples are shared by neighboring leafs.
+	uint32_t nx0 = 0 == x0 ? 0 : (x0 - 1)/m_leafSize;
+	uint32_t ny0 = 0 == y0 ? 0 : (y0 - 1)/m_leafSize;
+	uint32_t nx1 = bx::min<uint32_t>(x1/m_leafSize, m_numLeafs - 1);
+	uint32_t ny1 = bx::min<uint32_t>(y1/m_leafSize, m_numLeafs - 1);
+
+	for (uint32_t ny = ny0; ny <= ny1; ++ny)
+	{
+		for (uint32_t nx = nx0; nx <= nx1; ++nx)
+		{
+			uint8_t min = UINT8_MAX;
+			uint8_t max = 0;
+
+			for (uint32_t yy = ny*m_leafSize, ey = yy + m_leafSize; yy <= ey; ++yy)
+			{
+				const uint8_t* row = &_heightMap[yy*m_size];
+
+				for (uint32_t xx = nx*m_leafSize, ex = xx + m_leafSize; xx <= ex; ++xx)
+				{
+					min = bx::min(min, row[xx]);
+					max = bx::max(max, row[xx]);
+				}
+			}
+
+			uint8_t* minMax = &m_minMax[(m_offset[0] + ny*m_numLeafs + nx)*2];
+			minMax[0] = min;
+			minMax[1] = max;
+		}
+	}
+
+	for (uint8_t lod = 1; lod < m_numLods; ++lod)
+	{
+		nx0 >>= 1;
+		ny0 >>= 1;
+		nx1 >>= 1;
+		ny1 >>= 1;
+
+		const uint32_t num      = m_numLeafs >> lod;
+		const uint32_t numChild = num*2;
+
+		for (uint32_t ny = ny0; ny <= ny1; ++ny)
+		{
+			for (uint32_t nx = nx0; nx <= nx1; ++nx)
+			{
+				const uint8_t* child0 = &m_minMax[(m_offset[lod-1] + (ny*2  )*numChild + nx*2)*2];
+				const uint8_t* child1 = &m_minMax[(m_offset[lod-1] + (ny*2+1)*numChild + nx*2)*2];
+
+				uint8_t* minMax = &m_minMax[(m_offset[lod] + ny*num + nx)*2];
+				minMax[0] = bx::min(child0[0], child0[2], child1[0], child1[2]);
+				minMax[1] = bx::max(child0[1], child0[3], child1[1], child1[3]);
+			}
+		}
+	}
+}
+
+uint32_t TerrainLod::select(const float* _viewProj, const float* _eye, float _lodRange)
+{
+	buildFrustumPlanes(m_planes, _viewProj);
+
+	m_eye[0] = _eye[0];
+	m_eye[1] = _eye[1];
+	m_eye[2] = _eye[2];
+
+	for (uint8_t lod = 0; lod < m_numLods; ++lod)
+	{
+		m_range[lod] = _lodRange * float(1u << lod);
+	}
+
+	m_numPatches = 0;
+	bx::memSet(m_lodMap, 0, m_maxPatches);
+
+	const uint8_t root = m_numLods - 1;
+
+	if (!selectNode(root, 0, 0) )
+	{
+		// Root is visible but out of range of coarsest LOD, render it anyway.
+		addPatch(root, 0, 0, m_leafSize << root);
+	}
+
+	return m_numPatches;
+}
+
+bool TerrainLod::selectNode(uint8_t _lod, uint16_t _x, uint16_t _y)
+{
+	float min[3];
+	float max[3];
+	getBounds(min, max, _lod, _x, _y);
+
+	if (!isInFrustum(m_planes, min, max) )
+	{
+		// Culled, parent must not render it either.
+		return true;
+	}
+
+	const float distSq = distanceSq(m_eye, min, max);
+
+	if (distSq > bx::square(m_range[_lod]) )
+	{
+		return false;
+	}
+
+	const uint16_t size = m_leafSize << _lod;
+
+	if (0 == _lod
+	||  distSq > bx::square(m_range[_lod-1]) )
+	{
+		addPatch(_lod, _x*size, _y*size, size);
+		return true;
+	}
+
+	const uint16_t half = size/2;
+
+	for (uint16_t ii = 0; ii < 4; ++ii)
+	{
+		const uint16_t cx = _x*2 + (ii&1);
+		const uint16_t cy = _y*2 + (ii>>1);
+
+		if (!selectNode(_lod-1, cx, cy) )
+		{
+			addPatch(_lod, cx*half, cy*half, half);
+		}
+	}
+
+	return true;
+}
+
+void TerrainLod::addPatch(uint8_t _lod, uint16_t _x, uint16_t _y, uint16_t _size)
+{
+	BX_ASSERT(m_numPatches < m_maxPatches, "Too many patches.");
+
+	TerrainPatch& patch = m_patch[m_numPatches++];
+	patch.m_x    = _x;
+	patch.m_y    = _y;
+	patch.m_size = _size;
+	patch.m_lod  = _lod;
+
+	for (uint32_t yy = _y/m_leafSize, ey = (_y + _size)/m_leafSize; yy < ey; ++yy)
+	{
+		bx::memSet(&m_lodMap[yy*m_numLeafs + _x/m_leafSize], _lod, _size/m_leafSize);
+	}
+}
+
+void TerrainLod::getBounds(float* _min, float* _max, uint8_t _lod, uint16_t _x, uint16_t _y) const
+{
+	const uint32_t num  = m_numLeafs >> _lod;
+	const float    size = float(m_leafSize << _lod);
+	const uint8_t* minMax = &m_minMax[(m_offset[_lod] + _y*num + _x)*2];
+
+	_min[0] = float(_x)*size;
+	_min[1] = float(minMax[0])*m_heightScale;
+	_min[2] = float(_y)*size;
+	_max[0] = _min[0] + size;
+	_max[1] = float(minMax[1])*m_heightScale;
+	_max[2] = _min[2] + size;
+}
+
+uint32_t TerrainLod::getNumIndices(const TerrainPatch& _patch) const
+{
+	const uint32_t num = _patch.m_size >> _patch.m_lod;
+	return num*num*6;
+}
+
+uint32_t TerrainLod::getNeighborStride(int32_t _x, int32_t _y) const
+{
+	const int32_t numQuads = m_size - 1;
+
+	if (0 > _x || numQuads <= _x
+	||  0 > _y || numQuads <= _y)
+	{
+		return 1;
+	}
+
+	return 1u << m_lodMap[(_y/m_leafSize)*m_numLeafs + _x/m_leafSize];
+}
+
+uint32_t TerrainLod::snap(uint32_t _x, uint32_t _y, const TerrainPatch& _patch) const
+{
+	const uint32_t x0 = _patch.m_x;
+	const uint32_t y0 = _patch.m_y;
+	const uint32_t x1 = x0 + _patch.m_size;
+	const uint32_t y1 = y0 + _patch.m_size;
+	const uint32_t stride = 1u << _patch.m_lod;
+
+	// Vertices on edge next to coarser patch are moved onto neighbor's
+	// vertices, leftover triangles are degenerate. Corners are shared with
+	// neighbors and never move.
+	if ( (y0 == _y || y1 == _y)
+	&&   x0 != _x && x1 != _x)
+	{
+		const uint32_t snap = bx::max(stride, getNeighborStride(int32_t(_x), y0 == _y ? int32_t(_y) - 1 : int32_t(_y) ) );
+		_x = bx::clamp(_x/snap*snap, x0, x1);
+	}
+	else if ( (x0 == _x || x1 == _x)
+	     &&   y0 != _y && y1 != _y)
+	{
+		const uint32_t snap = bx::max(stride, getNeighborStride(x0 == _x ? int32_t(_x) - 1 : int32_t(_x), int32_t(_y) ) );
+		_y = bx::clamp(_y/snap*snap, y0, y1);
+	}
+
+	return _y*m_size + _x;
+}
+
+uint32_t TerrainLod::writeIndices(uint32_t* _dst, const TerrainPatch& _patch) const
+{
+	const uint32_t stride = 1u << _patch.m_lod;
+	const uint32_t num    = _patch.m_size >> _patch.m_lod;
+
+	uint32_t* dst = _dst;
+
+	for (uint32_t qy = 0; qy < num; ++qy)
+	{
+		const uint32_t y0 = _patch.m_y + qy*stride;
+		const uint32_t y1 = y0 + stride;
+
+		for (uint32_t qx = 0; qx < num; ++qx)
+		{
+			const uint32_t x0 = _patch.m_x + qx*stride;
+			const uint32_t x1 = x0 + stride;
+
+			const uint32_t i00 = snap(x0, y0, _patch);
+			const uint32_t i10 = snap(x1, y0, _patch);
+			const uint32_t i01 = snap(x0, y1, _patch);
+			const uint32_t i11 = snap(x1, y1, _patch);
+
+			if (num - 1 == qx
+			&&  num - 1 == qy)
+			{
+				// Diagonal of last quad would pass through its first vertex
+				// when both edges are snapped, it's flipped to avoid T-junction.
+				dst[0] = i00;
+				dst[1] = i10;
+				dst[2] = i11;
+				dst[3] = i00;
+				dst[4] = i11;
+				dst[5] = i01;
+			}
+			else
+			{
+				dst[0] = i10;
+				dst[1] = i01;
+				dst[2] = i00;
+				dst[3] = i11;
+				dst[4] = i01;
+				dst[5] = i10;
+			}
+
+			dst += 6;
+		}
+	}
+
+	return uint32_t(dst - _dst);
+}
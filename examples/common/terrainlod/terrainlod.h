@@ -0,0 +1,173 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef TERRAINLOD_H_HEADER_GUARD
+#define TERRAINLOD_H_HEADER_GUARD
+
+#include <bx/allocator.h>
+
+/// Rectangle of height map samples.
+struct TerrainRect
+{
+	uint16_t m_x;
+	uint16_t m_y;
+	uint16_t m_width;
+	uint16_t m_height;
+};
+
+/// Collects rectangles of height map modified since last upload, so that
+/// only those are uploaded instead of the whole height map.
+///
+/// Overlapping and touching rectangles are merged. When there are more than
+/// `kMaxRects` rectangles, new rectangle is merged with the one that grows
+/// the least.
+///
+class TerrainDirtyRects
+{
+public:
+	static constexpr uint8_t kMaxRects = 16;
+
+	///
+	TerrainDirtyRects();
+
+	/// Add modified rectangle.
+	void add(uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height);
+
+	/// Remove all rectangles, usually after they are uploaded.
+	void reset();
+
+	///
+	uint8_t getNum() const { return m_num; }
+
+	///
+	const TerrainRect& get(uint8_t _idx) const { return m_rect[_idx]; }
+
+private:
+	TerrainRect m_rect[kMaxRects];
+	uint8_t m_num;
+};
+
+/// Patch selected for rendering.
+struct TerrainPatch
+{
+	uint16_t m_x;    //!< First sample column.
+	uint16_t m_y;    //!< First sample row.
+	uint16_t m_size; //!< Size in samples (quads at LOD 0).
+	uint8_t  m_lod;  //!< LOD, distance between vertices is `1<<m_lod` samples.
+};
+
+/// CDLOD quadtree over square height map.
+///
+/// Terrain is in its own space, sample (x, y) is at position
+/// (x, height*heightScale, y). View projection and eye passed to `select`
+/// must be in that space.
+///
+/// Every select:
+///  - Quadtree is traversed from the root, node is split while camera is
+///    within range of the finer LOD, range doubles with every coarser LOD.
+///  - Nodes outside of view frustum are culled, using min/max height of
+///    samples they cover.
+///  - Quadrants of split node whose children are out of their range are
+///    selected at node's LOD.
+///
+/// Library doesn't render anything. Caller keeps vertex grid with one vertex
+/// per sample, and renders it with indices from `writeIndices`. Indices stitch
+/// patch edges to coarser neighbors, so there are no cracks between LODs.
+///
+class TerrainLod
+{
+public:
+	static constexpr uint8_t kMaxLods = 12;
+
+	///
+	TerrainLod();
+
+	///
+	~TerrainLod();
+
+	/// Initialize.
+	///
+	/// @param[in] _size Height map size in samples, power of two plus one.
+	/// @param[in] _leafSize Patch size of finest LOD in quads, power of two,
+	///   at least 2.
+	/// @param[in] _heightScale Height of height map value 1.
+	/// @param[in] _heightMap Height map, `_size*_size` samples.
+	/// @param[in] _allocator Allocator.
+	///
+	bool init(
+		  uint16_t _size
+		, uint16_t _leafSize
+		, float _heightScale
+		, const uint8_t* _heightMap
+		, bx::AllocatorI* _allocator = NULL
+		);
+
+	///
+	void shutdown();
+
+	/// Update min/max heights of nodes covering modified samples.
+	///
+	/// @param[in] _heightMap Height map, `_size*_size` samples.
+	/// @param[in] _rect Modified samples.
+	///
+	void updateHeights(const uint8_t* _heightMap, const TerrainRect& _rect);
+
+	/// Select patches.
+	///
+	/// @param[in] _viewProj View projection matrix.
+	/// @param[in] _eye Camera position.
+	/// @param[in] _lodRange Range of the finest LOD.
+	///
+	/// @returns Number of selected patches.
+	///
+	uint32_t select(const float* _viewProj, const float* _eye, float _lodRange);
+
+	///
+	uint32_t getNumPatches() const { return m_numPatches; }
+
+	///
+	const TerrainPatch& getPatch(uint32_t _idx) const { return m_patch[_idx]; }
+
+	///
+	uint8_t getNumLods() const { return m_numLods; }
+
+	/// Returns number of indices `writeIndices` writes for patch.
+	uint32_t getNumIndices(const TerrainPatch& _patch) const;
+
+	/// Write triangle list indices of patch, vertex of sample (x, y) is
+	/// `y*_size + x`.
+	///
+	/// @returns Number of indices written.
+	///
+	uint32_t writeIndices(uint32_t* _dst, const TerrainPatch& _patch) const;
+
+private:
+	bool selectNode(uint8_t _lod, uint16_t _x, uint16_t _y);
+	void addPatch(uint8_t _lod, uint16_t _x, uint16_t _y, uint16_t _size);
+	void getBounds(float* _min, float* _max, uint8_t _lod, uint16_t _x, uint16_t _y) const;
+	uint32_t getNeighborStride(int32_t _x, int32_t _y) const;
+	uint32_t snap(uint32_t _x, uint32_t _y, const TerrainPatch& _patch) const;
+
+	bx::AllocatorI* m_allocator;
+
+	uint8_t*      m_minMax;       //!< Min/max height pairs, for every node of every LOD.
+	uint32_t      m_offset[kMaxLods];
+	TerrainPatch* m_patch;
+	uint8_t*      m_lodMap;       //!< LOD of patch covering each leaf, for stitching.
+
+	float m_planes[5][4];
+	float m_eye[3];
+	float m_range[kMaxLods];
+	float m_heightScale;
+
+	uint32_t m_maxPatches;
+	uint32_t m_numPatches;
+	uint16_t m_size;
+	uint16_t m_leafSize;
+	uint16_t m_numLeafs;          //!< Leafs per side.
+	uint8_t  m_numLods;
+};
+
+#endif // TERRAINLOD_H_HEADER_GUARD
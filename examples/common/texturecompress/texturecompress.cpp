@@ -0,0 +1,485 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/debug.h>
+#include <bx/error.h>
+#include <bx/math.h>
+#include <bx/timer.h>
+#include <bimg/bimg.h>
+#include <bimg/encode.h>
+
+#include "texturecompress.h"
+
+static const bimg::Quality::Enum s_quality[] =
+{
+	bimg::Quality::Fastest,
+	bimg::Quality::Default,
+	bimg::Quality::Highest,
+};
+BX_STATIC_ASSERT(TextureCompressQuality::Count == BX_COUNTOF(s_quality) );
+
+// Rows per job, large regions are split into bands of this height so that
+// they are encoded in parallel.
+static constexpr uint16_t kBandHeight = 64;
+
+static bool isRegionValid(bgfx::TextureFormat::Enum _format, uint32_t _x, uint32_t _y, uint32_t _width, uint32_t _height)
+{
+	const bimg::TextureFormat::Enum format = bimg::TextureFormat::Enum(_format);
+
+	if (!bimg::isCompressed(format) )
+	{
+		BX_WARN(false, "Texture format %s is not compressed.", bimg::getName(format) );
+		return false;
+	}
+
+	const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(format);
+
+	const bool aligned = true
+		&& 0 != _width
+		&& 0 != _height
+		&& 0 == _x      % blockInfo.blockWidth
+		&& 0 == _y      % blockInfo.blockHeight
+		&& 0 == _width  % blockInfo.blockWidth
+		&& 0 == _height % blockInfo.blockHeight
+		;
+	BX_WARN(aligned
+		, "Region %d, %d, %dx%d is not aligned to %dx%d blocks of %s."
+		, _x
+		, _y
+		, _width
+		, _height
+		, blockInfo.blockWidth
+		, blockInfo.blockHeight
+		, bimg::getName(format)
+		);
+
+	return aligned;
+}
+
+static uint32_t getCompressedSize(bgfx::TextureFormat::Enum _format, uint32_t _width, uint32_t _height)
+{
+	const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(bimg::TextureFormat::Enum(_format) );
+	return (_width/blockInfo.blockWidth) * (_height/blockInfo.blockHeight) * blockInfo.blockSize;
+}
+
+static void releaseCompressed(void* _ptr, void* _userData)
+{
+	bx::free(static_cast<bx::AllocatorI*>(_userData), _ptr);
+}
+
+TextureCompressor::TextureCompressor()
+	: m_allocator(NULL)
+	, m_job(NULL)
+	, m_free(NULL)
+	, m_pending(NULL)
+	, m_done(NULL)
+	, m_maxJobs(0)
+	, m_numFree(0)
+	, m_pendingRead(0)
+	, m_numQueued(0)
+	, m_numDone(0)
+{
+	bx::memSet(&m_stats, 0, sizeof(m_stats) );
+}
+
+TextureCompressor::~TextureCompressor()
+{
+	shutdown();
+}
+
+bool TextureCompressor::init(uint8_t _numThreads, uint16_t _maxJobs, bx::AllocatorI* _allocator)
+{
+	BX_ASSERT(NULL == m_job, "TextureCompressor is already initialized.");
+
+	if (NULL == _allocator)
+	{
+		static bx::DefaultAllocator allocator;
+		_allocator = &allocator;
+	}
+
+	m_allocator = _allocator;
+	m_maxJobs   = bx::max<uint16_t>(_maxJobs, 1);
+
+	m_job     = (Job*)bx::alloc(m_allocator, m_maxJobs*sizeof(Job) );
+	m_free    = (uint16_t*)bx::alloc(m_allocator, m_maxJobs*sizeof(uint16_t) );
+	m_pending = (uint16_t*)bx::alloc(m_allocator, m_maxJobs*sizeof(uint16_t) );
+	m_done    = (uint16_t*)bx::alloc(m_allocator, m_maxJobs*sizeof(uint16_t) );
+
+	for (uint16_t ii = 0; ii < m_maxJobs; ++ii)
+	{
+		m_job[ii].m_src = NULL;
+		m_job[ii].m_dst = NULL;
+		m_free[ii] = m_maxJobs - ii - 1;
+	}
+
+	m_numFree     = m_maxJobs;
+	m_pendingRead = 0;
+	m_numQueued   = 0;
+	m_numDone     = 0;
+	bx::memSet(&m_stats, 0, sizeof(m_stats) );
+
+	m_pool.init(bx::max<uint8_t>(_numThreads, 1), workFn, this, "TextureCompressor");
+
+	return true;
+}
+
+void TextureCompressor::shutdown()
+{
+	if (NULL == m_job)
+	{
+		return;
+	}
+
+	m_pool.shutdown();
+
+	for (uint16_t ii = 0; ii < m_maxJobs; ++ii)
+	{
+		freeJob(ii);
+	}
+
+	bx::free(m_allocator, m_done);
+	bx::free(m_allocator, m_pending);
+	bx::free(m_allocator, m_free);
+	bx::free(m_allocator, m_job);
+
+	m_job     = NULL;
+	m_free    = NULL;
+	m_pending = NULL;
+	m_done    = NULL;
+	m_maxJobs = 0;
+	m_numFree = 0;
+}
+
+bool TextureCompressor::update(
+	  bgfx::TextureHandle _handle
+	, bgfx::TextureFormat::Enum _format
+	, uint16_t _layer
+	, uint8_t _mip
+	, uint16_t _x
+	, uint16_t _y
+	, uint16_t _width
+	, uint16_t _height
+	, const void* _rgba8
+	, uint32_t _pitch
+	, TextureCompressQuality::Enum _quality
+	)
+{
+	BX_ASSERT(NULL != m_job, "TextureCompressor is not initialized.");
+
+	if (!isRegionValid(_format, _x, _y, _width, _height) )
+	{
+		return false;
+	}
+
+	const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(bimg::TextureFormat::Enum(_format) );
+	const uint16_t bandHeight = bx::max<uint16_t>(kBandHeight / blockInfo.blockHeight * blockInfo.blockHeight, blockInfo.blockHeight);
+
+	const uint32_t dstPitch = _width*4;
+	const uint32_t srcPitch = UINT32_MAX == _pitch ? dstPitch : _pitch;
+	const uint8_t* src = (const uint8_t*)_rgba8;
+
+	for (uint32_t yy = 0; yy < _height; yy += bandHeight)
+	{
+		const uint16_t height = uint16_t(bx::min<uint32_t>(bandHeight, _height - yy) );
+
+		const uint16_t jobIdx = allocJob();
+		Job& job = m_job[jobIdx];
+
+		job.m_handle  = _handle;
+		job.m_format  = _format;
+		job.m_quality = _quality;
+		job.m_layer   = _layer;
+		job.m_mip     = _mip;
+		job.m_x       = _x;
+		job.m_y       = uint16_t(_y + yy);
+		job.m_width   = _width;
+		job.m_height  = height;
+		job.m_ok      = false;
+		job.m_dstSize = getCompressedSize(_format, _width, height);
+		job.m_src     = (uint8_t*)bx::alloc(m_allocator, dstPitch*height);
+		job.m_dst     = (uint8_t*)bx::alloc(m_allocator, job.m_dstSize);
+
+		bx::memCopy(job.m_src, src + yy*srcPitch, dstPitch, height, srcPitch, dstPitch);
+
+		{
+			bx::MutexScope lock(m_mutex);
+			m_pending[(m_pendingRead + m_numQueued) % m_maxJobs] = jobIdx;
+			++m_numQueued;
+		}
+
+		m_pool.post();
+	}
+
+	return true;
+}
+
+uint32_t TextureCompressor::flush()
+{
+	uint32_t numUpdates = 0;
+
+	bx::MutexScope lock(m_mutex);
+
+	for (uint16_t ii = 0; ii < m_numDone; ++ii)
+	{
+		const uint16_t jobIdx = m_done[ii];
+		Job& job = m_job[jobIdx];
+
+		if (job.m_ok)
+		{
+			// Ownership of compressed data is passed to bgfx, it's released
+			// once update is consumed by renderer.
+			bgfx::updateTexture2D(
+				  job.m_handle
+				, job.m_layer
+				, job.m_mip
+				, job.m_x
+				, job.m_y
+				, job.m_width
+				, job.m_height
+				, bgfx::makeRef(job.m_dst, job.m_dstSize, releaseCompressed, m_allocator)
+				);
+			job.m_dst = NULL;
+
+			++numUpdates;
+		}
+
+		freeJob(jobIdx);
+		m_free[m_numFree++] = jobIdx;
+	}
+
+	m_numDone = 0;
+
+	return numUpdates;
+}
+
+void TextureCompressor::finish()
+{
+	for (;;)
+	{
+		{
+			bx::MutexScope lock(m_mutex);
+
+			if (m_maxJobs == m_numFree + m_numDone)
+			{
+				break;
+			}
+		}
+
+		m_pool.wait();
+	}
+
+	flush();
+}
+
+TextureCompressStats TextureCompressor::getStats()
+{
+	bx::MutexScope lock(m_mutex);
+
+	TextureCompressStats stats = m_stats;
+	stats.m_numPending = m_maxJobs - m_numFree - m_numDone;
+
+	return stats;
+}
+
+void TextureCompressor::workFn(void* _userData)
+{
+	TextureCompressor* compressor = static_cast<TextureCompressor*>(_userData);
+	compressor->encodeJob();
+}
+
+void TextureCompressor::encodeJob()
+{
+	uint16_t jobIdx;
+
+	{
+		bx::MutexScope lock(m_mutex);
+
+		if (0 == m_numQueued)
+		{
+			return;
+		}
+
+		jobIdx = m_pending[m_pendingRead];
+		m_pendingRead = (m_pendingRead + 1) % m_maxJobs;
+		--m_numQueued;
+	}
+
+	Job& job = m_job[jobIdx];
+
+	const int64_t start = bx::getHPCounter();
+
+	bx::Error err;
+	bimg::imageEncodeFromRgba8(
+		  m_allocator
+		, job.m_dst
+		, job.m_src
+		, job.m_width
+		, job.m_height
+		, 1
+		, bimg::TextureFormat::Enum(job.m_format)
+		, s_quality[job.m_quality]
+		, &err
+		);
+	job.m_ok = err.isOk();
+
+	const int64_t elapsed = bx::getHPCounter() - start;
+
+	{
+		bx::MutexScope lock(m_mutex);
+
+		m_done[m_numDone++] = jobIdx;
+
+		m_stats.m_encodeTime += elapsed;
+
+		if (job.m_ok)
+		{
+			m_stats.m_numEncoded += 1;
+			m_stats.m_srcBytes   += uint64_t(job.m_width)*job.m_height*4;
+			m_stats.m_dstBytes   += job.m_dstSize;
+		}
+		else
+		{
+			m_stats.m_numFailed += 1;
+		}
+	}
+}
+
+uint16_t TextureCompressor::allocJob()
+{
+	for (;;)
+	{
+		{
+			bx::MutexScope lock(m_mutex);
+
+			if (0 < m_numFree)
+			{
+				return m_free[--m_numFree];
+			}
+		}
+
+		// All jobs are in flight, wait for one of them and recycle it.
+		m_pool.wait();
+		flush();
+	}
+}
+
+void TextureCompressor::freeJob(uint16_t _job)
+{
+	Job& job = m_job[_job];
+
+	bx::free(m_allocator, job.m_src);
+	bx::free(m_allocator, job.m_dst);
+	job.m_src = NULL;
+	job.m_dst = NULL;
+}
+
+float textureCompressPsnr(
+	  const void* _ref
+	, const void* _test
+	, uint32_t _width
+	, uint32_t _height
+	, uint32_t _pitch
+	)
+{
+	const uint8_t* ref  = (const uint8_t*)_ref;
+	const uint8_t* test = (const uint8_t*)_test;
+
+	uint64_t sse = 0;
+
+	for (uint32_t yy = 0; yy < _height; ++yy)
+	{
+		const uint8_t* refRow  = &ref [yy*_pitch];
+		const uint8_t* testRow = &test[yy*_pitch];
+
+		for (uint32_t xx = 0, num = _width*4; xx < num; ++xx)
+		{
+			const int32_t diff = int32_t(refRow[xx]) - int32_t(testRow[xx]);
+			sse += uint64_t(diff*diff);
+		}
+	}
+
+	if (0 == sse)
+	{
+		return bx::kFloatInfinity;
+	}
+
+	const double mse = double(sse) / (double(_width)*double(_height)*4.0);
+
+	return 10.0f * bx::log(float(255.0*255.0/mse) ) / bx::kLogNat10;
+}
+
+bool textureCompressBenchmark(
+	  TextureCompressBenchmark& _result
+	, bgfx::TextureFormat::Enum _format
+	, TextureCompressQuality::Enum _quality
+	, const void* _rgba8
+	, uint32_t _width
+	, uint32_t _height
+	, uint32_t _numIterations
+	, bx::AllocatorI* _allocator
+	)
+{
+	_result.m_psnr       = 0.0f;
+	_result.m_mpixPerSec = 0.0;
+
+	if (!isRegionValid(_format, 0, 0, _width, _height) )
+	{
+		return false;
+	}
+
+	if (NULL == _allocator)
+	{
+		static bx::DefaultAllocator allocator;
+		_allocator = &allocator;
+	}
+
+	const bimg::TextureFormat::Enum format = bimg::TextureFormat::Enum(_format);
+	const uint32_t pitch = _width*4;
+	const uint32_t numIterations = bx::max<uint32_t>(_numIterations, 1);
+
+	void* compressed = bx::alloc(_allocator, getCompressedSize(_format, _width, _height) );
+	void* decoded    = bx::alloc(_allocator, pitch*_height);
+
+	bx::Error err;
+
+	const int64_t start = bx::getHPCounter();
+
+	for (uint32_t ii = 0; ii < numIterations && err.isOk(); ++ii)
+	{
+		bimg::imageEncodeFromRgba8(
+			  _allocator
+			, compressed
+			, _rgba8
+			, _width
+			, _height
+			, 1
+			, format
+			, s_quality[_quality]
+			, &err
+			);
+	}
+
+	const int64_t elapsed = bx::getHPCounter() - start;
+
+	const bool ok = err.isOk();
+
+	if (ok)
+	{
+		bimg::imageDecodeToRgba8(_allocator, decoded, compressed, _width, _height, pitch, format);
+
+		const double seconds = double(elapsed)/double(bx::getHPFrequency() );
+
+		_result.m_psnr       = textureCompressPsnr(_rgba8, decoded, _width, _height, pitch);
+		_result.m_mpixPerSec = 0.0 < seconds
+			? double(_width)*double(_height)*double(numIterations)/seconds/1000000.0
+			: 0.0
+			;
+	}
+
+	bx::free(_allocator, decoded);
+	bx::free(_allocator, compressed);
+
+	return ok;
+}
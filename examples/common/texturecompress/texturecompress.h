@@ -0,0 +1,200 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef TEXTURECOMPRESS_H_HEADER_GUARD
+#define TEXTURECOMPRESS_H_HEADER_GUARD
+
+#include <bx/allocator.h>
+#include <bx/mutex.h>
+#include <bgfx/bgfx.h>
+
+#include "../workerpool/workerpool.h"
+
+/// Encoder quality/speed trade-off.
+struct TextureCompressQuality
+{
+	enum Enum
+	{
+		Fastest, //!< Lowest quality, for data regenerated every few frames.
+		Default, //!< Balanced.
+		Highest, //!< Slowest, for data generated once (baked lightmaps, etc.).
+
+		Count
+	};
+};
+
+///
+struct TextureCompressStats
+{
+	uint32_t m_numPending;  //!< Number of queued or running jobs.
+	uint32_t m_numEncoded;  //!< Number of encoded regions.
+	uint32_t m_numFailed;   //!< Number of regions encoder rejected.
+	uint64_t m_srcBytes;    //!< RGBA8 bytes encoded.
+	uint64_t m_dstBytes;    //!< Compressed bytes produced.
+	int64_t  m_encodeTime;  //!< Encode time summed over all worker threads, in `bx::getHPFrequency` units.
+};
+
+/// Result of `textureCompressBenchmark`.
+struct TextureCompressBenchmark
+{
+	float  m_psnr;       //!< PSNR of RGBA channels after encode and decode round trip, in dB.
+	double m_mpixPerSec; //!< Encoder throughput in megapixels per second, single thread.
+};
+
+/// Compresses RGBA8 regions generated at runtime into block compressed
+/// texture formats (BC, ETC, ASTC, ...) on worker threads, and uploads
+/// results with `bgfx::updateTexture2D`.
+///
+/// Usage:
+///  - `update` copies region and queues it. It blocks only when all jobs are
+///    in flight.
+///  - `flush` issues texture updates for regions that finished encoding,
+///    usually it's called once per frame.
+///  - All functions must be called from API thread.
+///
+/// Regions must be aligned to block size of the format. Large regions are
+/// split into bands, so that a single region is spread over all workers.
+///
+class TextureCompressor
+{
+public:
+	///
+	TextureCompressor();
+
+	///
+	~TextureCompressor();
+
+	/// Initialize.
+	///
+	/// @param[in] _numThreads Number of worker threads, clamped to `WorkerPool::kMaxThreads`.
+	/// @param[in] _maxJobs Maximum number of jobs in flight. `update` blocks when it's reached.
+	/// @param[in] _allocator Allocator, it's used from worker threads too.
+	///
+	bool init(uint8_t _numThreads = 2, uint16_t _maxJobs = 64, bx::AllocatorI* _allocator = NULL);
+
+	/// Stop worker threads. Queued regions and results that were not flushed
+	/// are dropped.
+	void shutdown();
+
+	/// Queue RGBA8 region for compression.
+	///
+	/// @param[in] _handle Texture handle.
+	/// @param[in] _format Texture format, must be compressed format texture was created with.
+	/// @param[in] _layer Layer in texture array.
+	/// @param[in] _mip Mip level.
+	/// @param[in] _x X offset in texture, multiple of block width.
+	/// @param[in] _y Y offset in texture, multiple of block height.
+	/// @param[in] _width Width of region, multiple of block width.
+	/// @param[in] _height Height of region, multiple of block height.
+	/// @param[in] _rgba8 RGBA8 source, it's copied and can be released after call.
+	/// @param[in] _pitch Pitch of source in bytes. When UINT32_MAX it's `_width*4`.
+	/// @param[in] _quality Encoder quality.
+	///
+	/// @returns False if region is not block aligned or format is not compressed.
+	///
+	bool update(
+		  bgfx::TextureHandle _handle
+		, bgfx::TextureFormat::Enum _format
+		, uint16_t _layer
+		, uint8_t _mip
+		, uint16_t _x
+		, uint16_t _y
+		, uint16_t _width
+		, uint16_t _height
+		, const void* _rgba8
+		, uint32_t _pitch = UINT32_MAX
+		, TextureCompressQuality::Enum _quality = TextureCompressQuality::Default
+		);
+
+	/// Issue texture updates for finished regions.
+	///
+	/// @returns Number of texture updates issued.
+	///
+	uint32_t flush();
+
+	/// Block until all queued regions are encoded, and flush them.
+	void finish();
+
+	///
+	TextureCompressStats getStats();
+
+private:
+	struct Job
+	{
+		bgfx::TextureHandle m_handle;
+		bgfx::TextureFormat::Enum m_format;
+		TextureCompressQuality::Enum m_quality;
+		uint16_t m_layer;
+		uint16_t m_x;
+		uint16_t m_y;
+		uint16_t m_width;
+		uint16_t m_height;
+		uint8_t  m_mip;
+		bool     m_ok;
+		uint8_t* m_src;
+		uint8_t* m_dst;
+		uint32_t m_dstSize;
+	};
+
+	static void workFn(void* _userData);
+	void encodeJob();
+
+	uint16_t allocJob();
+	void freeJob(uint16_t _job);
+
+	bx::AllocatorI* m_allocator;
+
+	WorkerPool m_pool;
+	bx::Mutex  m_mutex;
+
+	Job*      m_job;
+	uint16_t* m_free;    //!< Free job indices.
+	uint16_t* m_pending; //!< Ring of jobs waiting for worker.
+	uint16_t* m_done;    //!< Jobs waiting for flush.
+
+	uint16_t m_maxJobs;
+	uint16_t m_numFree;
+	uint16_t m_pendingRead;
+	uint16_t m_numQueued;
+	uint16_t m_numDone;
+
+	TextureCompressStats m_stats;
+};
+
+/// Returns PSNR of RGBA channels between two RGBA8 images, in dB. Returns
+/// `bx::kFloatInfinity` when images are identical.
+///
+float textureCompressPsnr(
+	  const void* _ref
+	, const void* _test
+	, uint32_t _width
+	, uint32_t _height
+	, uint32_t _pitch
+	);
+
+/// Encode RGBA8 image on calling thread, decode it back, and measure PSNR and
+/// encoder throughput. Doesn't require bgfx to be initialized.
+///
+/// @param[out] _result Benchmark result.
+/// @param[in] _format Compressed format.
+/// @param[in] _quality Encoder quality.
+/// @param[in] _rgba8 RGBA8 source, tightly packed.
+/// @param[in] _width Width, multiple of block width.
+/// @param[in] _height Height, multiple of block height.
+/// @param[in] _numIterations Number of times image is encoded for timing.
+/// @param[in] _allocator Allocator.
+///
+bool textureCompressBenchmark(
+	  TextureCompressBenchmark& _result
+	, bgfx::TextureFormat::Enum _format
+	, TextureCompressQuality::Enum _quality
+	, const void* _rgba8
+	, uint32_t _width
+	, uint32_t _height
+	, uint32_t _numIterations = 1
+	, bx::AllocatorI* _allocator = NULL
+	);
+
+#endif // TEXTURECOMPRESS_H_HEADER_GUARD
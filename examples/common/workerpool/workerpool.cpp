@@ -0,0 +1,113 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/debug.h>
+#include <bx/math.h>
+
+#include "workerpool.h"
+
+WorkerPool::WorkerPool()
+	: m_fn(NULL)
+	, m_userData(NULL)
+	, m_numThreads(0)
+	, m_exit(false)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+	shutdown();
+}
+
+void WorkerPool::init(uint8_t _numThreads, WorkFn _fn, void* _userData, const char* _name)
+{
+	BX_ASSERT(0 == m_numThreads, "WorkerPool is already initialized.");
+
+	m_fn         = _fn;
+	m_userData   = _userData;
+	m_exit       = false;
+	m_numThreads = bx::min<uint8_t>(_numThreads, kMaxThreads);
+
+	for (uint8_t ii = 0; ii < m_numThreads; ++ii)
+	{
+		m_thread[ii].init(threadFunc, this, 0, _name);
+	}
+}
+
+void WorkerPool::shutdown()
+{
+	if (0 == m_numThreads)
+	{
+		return;
+	}
+
+	{
+		bx::MutexScope lock(m_mutex);
+		m_exit = true;
+	}
+
+	post(m_numThreads);
+
+	for (uint8_t ii = 0; ii < m_numThreads; ++ii)
+	{
+		m_thread[ii].shutdown();
+	}
+
+	m_numThreads = 0;
+}
+
+void WorkerPool::post(uint32_t _num)
+{
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		m_workSem.post();
+	}
+}
+
+void WorkerPool::wait(uint32_t _num)
+{
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		m_doneSem.wait();
+	}
+}
+
+void WorkerPool::dispatch()
+{
+	post(m_numThreads);
+
+	m_fn(m_userData);
+
+	wait(m_numThreads);
+}
+
+int32_t WorkerPool::threadFunc(bx::Thread* /*_thread*/, void* _userData)
+{
+	WorkerPool* pool = static_cast<WorkerPool*>(_userData);
+	return pool->worker();
+}
+
+int32_t WorkerPool::worker()
+{
+	for (;;)
+	{
+		m_workSem.wait();
+
+		{
+			bx::MutexScope lock(m_mutex);
+
+			if (m_exit)
+			{
+				break;
+			}
+		}
+
+		m_fn(m_userData);
+
+		m_doneSem.post();
+	}
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef WORKERPOOL_H_HEADER_GUARD
+#define WORKERPOOL_H_HEADER_GUARD
+
+#include <bx/mutex.h>
+#include <bx/semaphore.h>
+#include <bx/thread.h>
+
+/// Worker threads that sleep until they are woken up, call work function
+/// once, and signal that they are done.
+///
+/// Usage:
+///  - `post` wakes up workers, `wait` blocks until woken workers are done.
+///    Work function picks its own work from state shared by owner, and it
+///    must tolerate being called when there is nothing left to do.
+///  - `dispatch` wakes up all workers, calls work function on calling
+///    thread too, and returns when all workers are done.
+///
+class WorkerPool
+{
+public:
+	static constexpr uint8_t kMaxThreads = 8;
+
+	///
+	typedef void (*WorkFn)(void* _userData);
+
+	///
+	WorkerPool();
+
+	///
+	~WorkerPool();
+
+	/// Start worker threads.
+	///
+	/// @param[in] _numThreads Number of worker threads, clamped to `kMaxThreads`.
+	///   With zero, `dispatch` calls work function on calling thread only.
+	/// @param[in] _fn Work function, called from worker threads.
+	/// @param[in] _userData User data passed to work function.
+	/// @param[in] _name Thread name.
+	///
+	void init(uint8_t _numThreads, WorkFn _fn, void* _userData, const char* _name);
+
+	/// Stop worker threads. Work that was posted and not picked up yet is
+	/// dropped.
+	void shutdown();
+
+	/// Wake up `_num` workers.
+	void post(uint32_t _num = 1);
+
+	/// Block until `_num` woken workers are done.
+	void wait(uint32_t _num = 1);
+
+	/// Wake up all workers, call work function on calling thread, and block
+	/// until all workers are done.
+	void dispatch();
+
+	///
+	uint8_t getNumThreads() const
+	{
+		return m_numThreads;
+	}
+
+private:
+	static int32_t threadFunc(bx::Thread* _thread, void* _userData);
+	int32_t worker();
+
+	bx::Thread    m_thread[kMaxThreads];
+	bx::Mutex     m_mutex;
+	bx::Semaphore m_workSem;
+	bx::Semaphore m_doneSem;
+
+	WorkFn  m_fn;
+	void*   m_userData;
+	uint8_t m_numThreads;
+	bool    m_exit;
+};
+
+#endif // WORKERPOOL_H_HEADER_GUARD
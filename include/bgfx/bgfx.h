@@ -396,6 +396,7 @@ namespace bgfx
 			Sequential,      //!< Sort in the same order in which submit calls were called.
 			DepthAscending,  //!< Sort draw call depth in ascending order.
 			DepthDescending, //!< Sort draw call depth in descending order.
+			Bindings,        //!< Default sort order, draws sharing program and blend are grouped by bindings.
 
 			Count
 		};
@@ -957,6 +958,62 @@ namespace bgfx
 		uint16_t num; //!< Number of matrices.
 	};
 
+	/// Uniform value referenced by `DrawDesc`.
+	///
+	/// @attention C99's equivalent binding is `bgfx_draw_uniform_t`.
+	///
+	struct DrawUniform
+	{
+		const void*   value;  //!< Pointer to uniform data.
+		UniformHandle handle; //!< Uniform.
+		uint16_t      num;    //!< Number of elements. Passing `UINT16_MAX` will
+		                      ///  use the _num passed on uniform creation.
+	};
+
+	/// Texture binding referenced by `DrawDesc`.
+	///
+	/// @attention C99's equivalent binding is `bgfx_draw_texture_t`.
+	///
+	struct DrawTexture
+	{
+		uint32_t      flags;   //!< Texture sampling mode. Default value UINT32_MAX uses
+		                       ///  texture sampling settings from the texture.
+		UniformHandle sampler; //!< Program sampler.
+		TextureHandle handle;  //!< Texture handle.
+		uint8_t       stage;   //!< Texture unit.
+	};
+
+	/// Fully specified draw call for bulk submission.
+	///
+	/// @attention C99's equivalent binding is `bgfx_draw_desc_t`.
+	///
+	struct DrawDesc
+	{
+		uint64_t           state;         //!< State flags. See: `BGFX_STATE_*`.
+		uint32_t           rgba;          //!< Blend factor used by `BGFX_STATE_BLEND_FACTOR` and
+		                                  ///  `BGFX_STATE_BLEND_INV_FACTOR` blend modes.
+		uint32_t           depth;         //!< Depth for sorting.
+		uint32_t           transform;     //!< Index into matrix cache as returned by `setTransform`
+		                                  ///  or `allocTransform`. 0 is identity.
+		uint32_t           startVertex;   //!< First vertex to render.
+		uint32_t           numVertices;   //!< Number of vertices to render.
+		uint32_t           startIndex;    //!< First index to render.
+		uint32_t           numIndices;    //!< Number of indices to render.
+		uint32_t           firstUniform;  //!< First uniform in uniform array.
+		uint32_t           firstTexture;  //!< First texture in texture array.
+		ProgramHandle      program;       //!< Program.
+		VertexBufferHandle vertexBuffer;  //!< Vertex buffer. When invalid, `numVertices` is used
+		                                  ///  as vertex count without vertex buffer.
+		VertexLayoutHandle layout;        //!< Vertex layout for aliasing vertex buffer. If invalid
+		                                  ///  handle is used, vertex layout used for creation
+		                                  ///  of vertex buffer will be used.
+		IndexBufferHandle  indexBuffer;   //!< Index buffer. When invalid, draw is not indexed.
+		uint16_t           numTransforms; //!< Number of matrices from matrix cache.
+		uint16_t           scissor;       //!< Index in scissor cache, UINT16_MAX for no scissor.
+		uint16_t           numUniforms;   //!< Number of uniforms in uniform array.
+		uint8_t            numTextures;   //!< Number of textures in texture array.
+	};
+
 	/// View id.
 	typedef uint16_t ViewId;
 
@@ -975,14 +1032,50 @@ namespace bgfx
 		uint32_t gpuFrameNum;    //!< Frame which generated gpuTimeBegin, gpuTimeEnd.
 	};
 
+	/// GPU timer scope stats.
+	///
+	/// @attention C99's equivalent binding is `bgfx_gpu_timer_stats_t`.
+	///
+	struct GpuTimerStats
+	{
+		char     name[64];       //!< Scope name.
+		ViewId   view;           //!< View id of first render item covered by scope.
+		uint16_t depth;          //!< Scope nesting depth.
+		uint32_t numForeign;     //!< Number of render items submitted outside of scope, but
+		                         //!  measured by it because sort order interleaved them.
+		int64_t  gpuTimeBegin;   //!< GPU begin time.
+		int64_t  gpuTimeEnd;     //!< GPU end time.
+		uint32_t gpuFrameNum;    //!< Frame which generated gpuTimeBegin, gpuTimeEnd.
+	};
+
+	/// GPU memory heap stats.
+	///
+	/// @attention C99's equivalent binding is `bgfx_gpu_memory_heap_stats_t`.
+	///
+	struct GpuMemoryHeapStats
+	{
+		uint32_t memoryType;     //!< Renderer specific memory type index.
+		uint32_t numBlocks;      //!< Number of memory blocks allocated from driver.
+		uint32_t numAllocations; //!< Number of resources placed in memory blocks.
+		uint32_t numDedicated;   //!< Number of resources with dedicated allocation.
+		int64_t  reserved;       //!< Size of memory blocks.
+		int64_t  used;           //!< Size of memory blocks used by resources.
+		int64_t  largestFree;    //!< Largest free range in any memory block. Fragmentation is
+		                         //!  1.0 - largestFree / (reserved - used).
+		int64_t  dedicated;      //!< Size of dedicated allocations.
+	};
+
 	/// Encoder stats.
 	///
 	/// @attention C99's equivalent binding is `bgfx_encoder_stats_t`.
 	///
 	struct EncoderStats
 	{
-		int64_t cpuTimeBegin; //!< Encoder thread CPU submit begin time.
-		int64_t cpuTimeEnd;   //!< Encoder thread CPU submit end time.
+		int64_t  cpuTimeBegin; //!< Encoder thread CPU submit begin time.
+		int64_t  cpuTimeEnd;   //!< Encoder thread CPU submit end time.
+		uint32_t numSubmitted; //!< Number of draw and compute calls submitted.
+		uint32_t numDropped;   //!< Number of draw and compute calls dropped because they were empty,
+		                       ///  or because `BGFX_CONFIG_MAX_DRAW_CALLS` was reached.
 	};
 
 	/// Renderer statistics data.
@@ -1011,6 +1104,10 @@ namespace bgfx
 		uint32_t numBlit;                   //!< Number of blit calls submitted.
 		uint32_t maxGpuLatency;             //!< GPU driver latency.
 		uint32_t gpuFrameNum;               //<! Frame which generated gpuTimeBegin, gpuTimeEnd.
+		uint32_t numBindChanges;            //!< Number of binding changes between draws sharing program and blend in `ViewMode::Bindings` views.
+		uint32_t numBindChangesSaved;       //!< Number of binding changes removed by `ViewMode::Bindings` sorting.
+		uint32_t numUniformsSkipped;        //!< Number of uniform uploads skipped because value didn't change.
+		uint32_t numConditionFallbacks;     //!< Number of GPU predicated draws that used occlusion query result from previous frames.
 
 		uint16_t numDynamicIndexBuffers;    //!< Number of used dynamic index buffers.
 		uint16_t numDynamicVertexBuffers;   //!< Number of used dynamic vertex buffers.
@@ -1026,8 +1123,12 @@ namespace bgfx
 
 		int64_t textureMemoryUsed;          //!< Estimate of texture memory used.
 		int64_t rtMemoryUsed;               //!< Estimate of render target memory used.
+		int64_t textureUploadStaged;        //!< Texture data uploaded through staging buffers during frame.
+		int64_t textureUploadDirect;        //!< Texture data uploaded directly from application memory during frame.
 		int32_t transientVbUsed;            //!< Amount of transient vertex buffer used.
 		int32_t transientIbUsed;            //!< Amount of transient index buffer used.
+		uint32_t frameMemoryUsed;           //!< Amount of frame memory arena used.
+		uint32_t frameMemoryMax;            //!< Frame memory arena high-water mark.
 
 		uint32_t numPrims[Topology::Count]; //!< Number of primitives rendered.
 
@@ -1044,6 +1145,14 @@ namespace bgfx
 
 		uint8_t       numEncoders;          //!< Number of encoders used during frame.
 		EncoderStats* encoderStats;         //!< Array of encoder stats.
+
+		uint16_t       numGpuTimers;        //!< Number of GPU timer scope stats.
+		GpuTimerStats* gpuTimerStats;       //!< Array of GPU timer scope stats from most recent resolved frame.
+
+		uint16_t            numGpuMemoryHeaps;  //!< Number of GPU memory heap stats.
+		GpuMemoryHeapStats* gpuMemoryHeapStats; //!< Array of GPU memory heap stats.
+
+		float resolutionScale;              //!< Dynamic resolution scale applied to scalable views during frame.
 	};
 
 	/// Encoders are used for submitting draw calls from multiple threads. Only one encoder
@@ -1064,6 +1173,33 @@ namespace bgfx
 		///
 		void setMarker(const char* _name, int32_t _len = INT32_MAX);
 
+		/// Begin GPU timer scope. Render items submitted by this encoder until matching
+		/// `endGpuTimer` call are measured with GPU timestamp queries. Results are
+		/// resolved asynchronously, and available a few frames later in
+		/// `Stats::gpuTimerStats`.
+		///
+		/// @param[in] _name Scope name.
+		/// @param[in] _len Scope name length (if length is INT32_MAX, it's expected that _name
+		///   is zero terminated string.
+		///
+		/// @remarks
+		///   Scopes can be nested, and must be closed before the end of the frame.
+		///   Timestamps are taken around sorted render items, scope measures everything
+		///   from its first to its last render item in sort order. In views that are
+		///   not `ViewMode::Sequential`, or when scope spans multiple views, that
+		///   includes render items submitted outside of scope, and they are counted
+		///   in `GpuTimerStats::numForeign`.
+		///
+		/// @attention C99's equivalent binding is `bgfx_encoder_begin_gpu_timer`.
+		///
+		void beginGpuTimer(const char* _name, int32_t _len = INT32_MAX);
+
+		/// End GPU timer scope.
+		///
+		/// @attention C99's equivalent binding is `bgfx_encoder_end_gpu_timer`.
+		///
+		void endGpuTimer();
+
 		/// Set render states for draw primitive.
 		///
 		/// @param[in] _state State flags. Default state for primitive type is
@@ -1101,12 +1237,17 @@ namespace bgfx
 		///
 		/// @param[in] _handle Occlusion query handle.
 		/// @param[in] _visible Render if occlusion query is visible.
+		/// @param[in] _gpu Predicate draw on GPU with query result from current
+		///   frame. Query must be issued before draw in view submission order.
+		///   When `BGFX_CAPS_CONDITIONAL_RENDER` is not supported, or query is
+		///   not issued before draw, result from previous frames is used.
 		///
 		/// @attention C99's equivalent binding is `bgfx_encoder_set_condition`.
 		///
 		void setCondition(
 			  OcclusionQueryHandle _handle
 			, bool _visible
+			, bool _gpu = false
 			);
 
 		/// Set stencil test state.
@@ -1424,6 +1565,63 @@ namespace bgfx
 			, uint32_t _num
 			);
 
+		/// Set instance data buffer for draw primitive. Instance data is described
+		/// by vertex layout and bound as instance rate stream, instead of `i_data0..4`.
+		///
+		/// @param[in] _handle Vertex buffer.
+		/// @param[in] _start First instance data.
+		/// @param[in] _num Number of data instances.
+		/// @param[in] _layoutHandle Vertex layout describing instance data. If invalid handle is
+		///   used, vertex layout used for creation of vertex buffer will be used.
+		///
+		/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+		/// @attention C99's equivalent binding is `bgfx_encoder_set_instance_data_from_vertex_buffer_with_layout`.
+		///
+		void setInstanceDataBuffer(
+			  VertexBufferHandle _handle
+			, uint32_t _start
+			, uint32_t _num
+			, VertexLayoutHandle _layoutHandle
+			);
+
+		/// Set instance data buffer for draw primitive. Instance data is described
+		/// by vertex layout and bound as instance rate stream, instead of `i_data0..4`.
+		///
+		/// @param[in] _handle Dynamic vertex buffer.
+		/// @param[in] _start First instance data.
+		/// @param[in] _num Number of data instances.
+		/// @param[in] _layoutHandle Vertex layout describing instance data. If invalid handle is
+		///   used, vertex layout used for creation of vertex buffer will be used.
+		///
+		/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+		/// @attention C99's equivalent binding is `bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout`.
+		///
+		void setInstanceDataBuffer(
+			  DynamicVertexBufferHandle _handle
+			, uint32_t _start
+			, uint32_t _num
+			, VertexLayoutHandle _layoutHandle
+			);
+
+		/// Set instance data buffer for draw primitive. Instance data is described
+		/// by vertex layout and bound as instance rate stream, instead of `i_data0..4`.
+		///
+		/// @param[in] _tvb Transient vertex buffer.
+		/// @param[in] _start First instance data.
+		/// @param[in] _num Number of data instances.
+		/// @param[in] _layoutHandle Vertex layout describing instance data. If invalid handle is
+		///   used, vertex layout used for creation of transient vertex buffer will be used.
+		///
+		/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+		/// @attention C99's equivalent binding is `bgfx_encoder_set_instance_data_from_transient_vertex_buffer`.
+		///
+		void setInstanceDataBuffer(
+			  const TransientVertexBuffer* _tvb
+			, uint32_t _start
+			, uint32_t _num
+			, VertexLayoutHandle _layoutHandle = BGFX_INVALID_HANDLE
+			);
+
 		/// Set number of instances for auto generated instances use in conjunction
 		/// with gl_InstanceID.
 		///
@@ -1502,6 +1700,29 @@ namespace bgfx
 			, uint8_t _flags  = BGFX_DISCARD_ALL
 			);
 
+		/// Submit array of fully specified draw calls for rendering.
+		///
+		/// @param[in] _id View id.
+		/// @param[in] _draws Draw descriptors.
+		/// @param[in] _num Number of draw descriptors.
+		/// @param[in] _uniforms Uniforms referenced by draw descriptors.
+		/// @param[in] _textures Textures referenced by draw descriptors.
+		///
+		/// @remarks
+		///   Draws reference ranges in shared uniform and texture arrays. Consecutive
+		///   draws referencing the same ranges share uniform data. State set on encoder
+		///   prior to this call is discarded.
+		///
+		/// @attention C99's equivalent binding is `bgfx_encoder_submit_draws`.
+		///
+		void submit(
+			  ViewId _id
+			, const DrawDesc* _draws
+			, uint32_t _num
+			, const DrawUniform* _uniforms
+			, const DrawTexture* _textures
+			);
+
 		/// Submit primitive for rendering with index and instance data info from
 		/// indirect buffer.
 		///
@@ -2140,6 +2361,29 @@ namespace bgfx
 		, uint32_t _size
 		);
 
+	/// Allocate buffer from per-frame memory arena to pass to bgfx calls. Memory
+	/// is reclaimed at once after render thread is done with the frame, and it
+	/// must be passed to bgfx before next `bgfx::frame` call. When arena is
+	/// exhausted allocation falls back to `bgfx::alloc`.
+	///
+	/// @param[in] _size Size to allocate.
+	///
+	/// @attention C99's equivalent binding is `bgfx_alloc_frame`.
+	///
+	const Memory* allocFrame(uint32_t _size);
+
+	/// Allocate buffer from per-frame memory arena and copy data into it.
+	///
+	/// @param[in] _data Pointer to data to be copied.
+	/// @param[in] _size Size of data to be copied.
+	///
+	/// @attention C99's equivalent binding is `bgfx_copy_frame`.
+	///
+	const Memory* copyFrame(
+		  const void* _data
+		, uint32_t _size
+		);
+
 	/// Make reference to data to pass to bgfx. Unlike `bgfx::alloc`, this call
 	/// doesn't allocate memory for data. It just copies the _data pointer. You
 	/// can pass `ReleaseFn` function pointer to release this memory after it's
@@ -3519,6 +3763,46 @@ namespace bgfx
 		, const void* _proj
 		);
 
+	/// Set view dynamic resolution. Rect and scissor of scalable views, and
+	/// scissors of draw calls submitted to them, are scaled by current dynamic
+	/// resolution scale.
+	///
+	/// @param[in] _id View id.
+	/// @param[in] _enabled Enable dynamic resolution scaling for view.
+	///
+	/// @remarks
+	///   Scale used for the frame is reported in `Stats::resolutionScale`.
+	///   Scaled image starts at texture coordinate 0, with bottom-left
+	///   origin (`Caps::originBottomLeft`) rect is scaled toward bottom of
+	///   frame buffer.
+	///
+	/// @attention C99's equivalent binding is `bgfx_set_view_dynamic_resolution`.
+	///
+	void setViewDynamicResolution(
+		  ViewId _id
+		, bool _enabled
+		);
+
+	/// Set dynamic resolution controller parameters. Controller picks render
+	/// scale for views marked with `bgfx::setViewDynamicResolution` from
+	/// recent GPU frame times, trying to keep them within frame time budget.
+	///
+	/// @param[in] _targetMs Target GPU frame time in milliseconds.
+	/// @param[in] _minScale Minimum render scale.
+	/// @param[in] _maxScale Maximum render scale.
+	///
+	/// @remarks
+	///   Passing 0 for target frame time disables controller and resets scale
+	///   to 1.
+	///
+	/// @attention C99's equivalent binding is `bgfx_set_dynamic_resolution`.
+	///
+	void setDynamicResolution(
+		  float _targetMs
+		, float _minScale = 0.5f
+		, float _maxScale = 1.0f
+		);
+
 	/// Post submit view reordering.
 	///
 	/// @param[in] _id First view id.
@@ -3553,6 +3837,32 @@ namespace bgfx
 	///
 	void setMarker(const char* _name, int32_t _len = INT32_MAX);
 
+	/// Begin GPU timer scope. Render items submitted until matching `endGpuTimer`
+	/// call are measured with GPU timestamp queries. Results are resolved
+	/// asynchronously, and available a few frames later in `Stats::gpuTimerStats`.
+	///
+	/// @param[in] _name Scope name.
+	/// @param[in] _len Scope name length (if length is INT32_MAX, it's expected that _name
+	///   is zero terminated string.
+	///
+	/// @remarks
+	///   Scopes can be nested, and must be closed before the end of the frame.
+	///   Timestamps are taken around sorted render items, scope measures everything
+	///   from its first to its last render item in sort order. In views that are
+	///   not `ViewMode::Sequential`, or when scope spans multiple views, that
+	///   includes render items submitted outside of scope, and they are counted
+	///   in `GpuTimerStats::numForeign`.
+	///
+	/// @attention C99's equivalent binding is `bgfx_begin_gpu_timer`.
+	///
+	void beginGpuTimer(const char* _name, int32_t _len = INT32_MAX);
+
+	/// End GPU timer scope.
+	///
+	/// @attention C99's equivalent binding is `bgfx_end_gpu_timer`.
+	///
+	void endGpuTimer();
+
 	/// Set render states for draw primitive.
 	///
 	/// @param[in] _state State flags. Default state for primitive type is
@@ -3590,12 +3900,17 @@ namespace bgfx
 	///
 	/// @param[in] _handle Occlusion query handle.
 	/// @param[in] _visible Render if occlusion query is visible.
+	/// @param[in] _gpu Predicate draw on GPU with query result from current
+	///   frame. Query must be issued before draw in view submission order.
+	///   When `BGFX_CAPS_CONDITIONAL_RENDER` is not supported, or query is
+	///   not issued before draw, result from previous frames is used.
 	///
 	/// @attention C99's equivalent binding is `bgfx_set_condition`.
 	///
 	void setCondition(
 		  OcclusionQueryHandle _handle
 		, bool _visible
+		, bool _gpu = false
 		);
 
 	/// Set stencil test state.
@@ -3913,6 +4228,63 @@ namespace bgfx
 		, uint32_t _num
 		);
 
+	/// Set instance data buffer for draw primitive. Instance data is described
+	/// by vertex layout and bound as instance rate stream, instead of `i_data0..4`.
+	///
+	/// @param[in] _handle Vertex buffer.
+	/// @param[in] _start First instance data.
+	/// @param[in] _num Number of data instances.
+	/// @param[in] _layoutHandle Vertex layout describing instance data. If invalid handle is
+	///   used, vertex layout used for creation of vertex buffer will be used.
+	///
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// @attention C99's equivalent binding is `bgfx_set_instance_data_from_vertex_buffer_with_layout`.
+	///
+	void setInstanceDataBuffer(
+		  VertexBufferHandle _handle
+		, uint32_t _start
+		, uint32_t _num
+		, VertexLayoutHandle _layoutHandle
+		);
+
+	/// Set instance data buffer for draw primitive. Instance data is described
+	/// by vertex layout and bound as instance rate stream, instead of `i_data0..4`.
+	///
+	/// @param[in] _handle Dynamic vertex buffer.
+	/// @param[in] _start First instance data.
+	/// @param[in] _num Number of data instances.
+	/// @param[in] _layoutHandle Vertex layout describing instance data. If invalid handle is
+	///   used, vertex layout used for creation of vertex buffer will be used.
+	///
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// @attention C99's equivalent binding is `bgfx_set_instance_data_from_dynamic_vertex_buffer_with_layout`.
+	///
+	void setInstanceDataBuffer(
+		  DynamicVertexBufferHandle _handle
+		, uint32_t _start
+		, uint32_t _num
+		, VertexLayoutHandle _layoutHandle
+		);
+
+	/// Set instance data buffer for draw primitive. Instance data is described
+	/// by vertex layout and bound as instance rate stream, instead of `i_data0..4`.
+	///
+	/// @param[in] _tvb Transient vertex buffer.
+	/// @param[in] _start First instance data.
+	/// @param[in] _num Number of data instances.
+	/// @param[in] _layoutHandle Vertex layout describing instance data. If invalid handle is
+	///   used, vertex layout used for creation of transient vertex buffer will be used.
+	///
+	/// @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+	/// @attention C99's equivalent binding is `bgfx_set_instance_data_from_transient_vertex_buffer`.
+	///
+	void setInstanceDataBuffer(
+		  const TransientVertexBuffer* _tvb
+		, uint32_t _start
+		, uint32_t _num
+		, VertexLayoutHandle _layoutHandle = BGFX_INVALID_HANDLE
+		);
+
 	/// Set number of instances for auto generated instances use in conjunction
 	/// with gl_InstanceID.
 	///
@@ -3989,6 +4361,29 @@ namespace bgfx
 		, uint8_t _flags  = BGFX_DISCARD_ALL
 		);
 
+	/// Submit array of fully specified draw calls for rendering.
+	///
+	/// @param[in] _id View id.
+	/// @param[in] _draws Draw descriptors.
+	/// @param[in] _num Number of draw descriptors.
+	/// @param[in] _uniforms Uniforms referenced by draw descriptors.
+	/// @param[in] _textures Textures referenced by draw descriptors.
+	///
+	/// @remarks
+	///   Draws reference ranges in shared uniform and texture arrays. Consecutive
+	///   draws referencing the same ranges share uniform data. State set on encoder
+	///   prior to this call is discarded.
+	///
+	/// @attention C99's equivalent binding is `bgfx_submit_draws`.
+	///
+	void submit(
+		  ViewId _id
+		, const DrawDesc* _draws
+		, uint32_t _num
+		, const DrawUniform* _uniforms
+		, const DrawTexture* _textures
+		);
+
 	/// Submit primitive for rendering with index and instance data info from
 	/// indirect buffer.
 	///
@@ -4257,6 +4652,10 @@ namespace bgfx
 	///
 	/// @remarks
 	///   `bgfx::CallbackI::screenShot` must be implemented.
+	///   Noop renderer calls `bgfx::CallbackI::screenShot` with black BGRA8 image, with the same
+	///   frame latency other renderers have. `BGFX_RESET_CAPTURE` is emulated the same way. This
+	///   is done only when callback is passed to `bgfx::init`, default callback would write black
+	///   image to disk.
 	///
 	/// @attention Frame buffer handle must be created with OS' target native window handle.
 	/// @attention C99's equivalent binding is `bgfx_request_screen_shot`.
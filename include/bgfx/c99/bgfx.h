@@ -384,6 +384,7 @@ typedef enum bgfx_view_mode
     BGFX_VIEW_MODE_SEQUENTIAL,                /** ( 1) Sort in the same order in which submit calls were called. */
     BGFX_VIEW_MODE_DEPTH_ASCENDING,           /** ( 2) Sort draw call depth in ascending order. */
     BGFX_VIEW_MODE_DEPTH_DESCENDING,          /** ( 3) Sort draw call depth in descending order. */
+    BGFX_VIEW_MODE_BINDINGS,                  /** ( 4) Default sort order, draws sharing program and blend are grouped by bindings. */
 
     BGFX_VIEW_MODE_COUNT
 
@@ -834,6 +835,89 @@ typedef struct bgfx_transform_s
 
 } bgfx_transform_t;
 
+/**
+ * Uniform value referenced by `DrawDesc`.
+ *
+ */
+typedef struct bgfx_draw_uniform_s
+{
+    const void*          value;              /** Pointer to uniform data.                 */
+    bgfx_uniform_handle_t handle;            /** Uniform.                                 */
+    
+    /**
+     * Number of elements. Passing `UINT16_MAX` will
+     *   use the _num passed on uniform creation.
+     */
+    uint16_t             num;
+
+} bgfx_draw_uniform_t;
+
+/**
+ * Texture binding referenced by `DrawDesc`.
+ *
+ */
+typedef struct bgfx_draw_texture_s
+{
+    
+    /**
+     * Texture sampling mode. Default value UINT32_MAX uses
+     *   texture sampling settings from the texture.
+     */
+    uint32_t             flags;
+    bgfx_uniform_handle_t sampler;           /** Program sampler.                         */
+    bgfx_texture_handle_t handle;            /** Texture handle.                          */
+    uint8_t              stage;              /** Texture unit.                            */
+
+} bgfx_draw_texture_t;
+
+/**
+ * Fully specified draw call for bulk submission.
+ *
+ */
+typedef struct bgfx_draw_desc_s
+{
+    uint64_t             state;              /** State flags. See: `BGFX_STATE_*`.        */
+    
+    /**
+     * Blend factor used by `BGFX_STATE_BLEND_FACTOR` and
+     *   `BGFX_STATE_BLEND_INV_FACTOR` blend modes.
+     */
+    uint32_t             rgba;
+    uint32_t             depth;              /** Depth for sorting.                       */
+    
+    /**
+     * Index into matrix cache as returned by `setTransform`
+     *   or `allocTransform`. 0 is identity.
+     */
+    uint32_t             transform;
+    uint32_t             startVertex;        /** First vertex to render.                  */
+    uint32_t             numVertices;        /** Number of vertices to render.            */
+    uint32_t             startIndex;         /** First index to render.                   */
+    uint32_t             numIndices;         /** Number of indices to render.             */
+    uint32_t             firstUniform;       /** First uniform in uniform array.          */
+    uint32_t             firstTexture;       /** First texture in texture array.          */
+    bgfx_program_handle_t program;           /** Program.                                 */
+    
+    /**
+     * Vertex buffer. When invalid, `numVertices` is used
+     *   as vertex count without vertex buffer.
+     */
+    bgfx_vertex_buffer_handle_t vertexBuffer;
+    
+    /**
+     * Vertex layout for aliasing vertex buffer. If invalid
+     *   handle is used, vertex layout used for creation
+     *   of vertex buffer will be used.
+     */
+    bgfx_vertex_layout_handle_t layout;
+    bgfx_index_buffer_handle_t indexBuffer;  /** Index buffer. When invalid, draw is not indexed. */
+    uint16_t             numTransforms;      /** Number of matrices from matrix cache.    */
+    uint16_t             scissor;            /** Index in scissor cache, UINT16_MAX for no scissor. */
+    uint16_t             numUniforms;        /** Number of uniforms in uniform array.     */
+    uint8_t              numTextures;        /** Number of textures in texture array.     */
+
+} bgfx_draw_desc_t;
+
 /**
  * View stats.
  *
@@ -850,6 +934,39 @@ typedef struct bgfx_view_stats_s
 
 } bgfx_view_stats_t;
 
+/**
+ * GPU timer scope stats.
+ *
+ */
+typedef struct bgfx_gpu_timer_stats_s
+{
+    char                 name[64];           /** Scope name.                              */
+    bgfx_view_id_t       view;               /** View id of first render item covered by scope. */
+    uint16_t             depth;              /** Scope nesting depth.                     */
+    uint32_t             numForeign;         /** Number of render items submitted outside of scope, but measured by it because sort order interleaved them. */
+    int64_t              gpuTimeBegin;       /** GPU begin time.                          */
+    int64_t              gpuTimeEnd;         /** GPU end time.                            */
+    uint32_t             gpuFrameNum;        /** Frame which generated gpuTimeBegin, gpuTimeEnd. */
+
+} bgfx_gpu_timer_stats_t;
+
+/**
+ * GPU memory heap stats.
+ *
+ */
+typedef struct bgfx_gpu_memory_heap_stats_s
+{
+    uint32_t             memoryType;         /** Renderer specific memory type index.     */
+    uint32_t             numBlocks;          /** Number of memory blocks allocated from driver. */
+    uint32_t             numAllocations;     /** Number of resources placed in memory blocks. */
+    uint32_t             numDedicated;       /** Number of resources with dedicated allocation. */
+    int64_t              reserved;           /** Size of memory blocks.                   */
+    int64_t              used;               /** Size of memory blocks used by resources. */
+    int64_t              largestFree;        /** Largest free range in any memory block.  */
+    int64_t              dedicated;          /** Size of dedicated allocations.           */
+
+} bgfx_gpu_memory_heap_stats_t;
+
 /**
  * Encoder stats.
  *
@@ -858,6 +975,8 @@ typedef struct bgfx_encoder_stats_s
 {
     int64_t              cpuTimeBegin;       /** Encoder thread CPU submit begin time.    */
     int64_t              cpuTimeEnd;         /** Encoder thread CPU submit end time.      */
+    uint32_t             numSubmitted;       /** Number of draw and compute calls submitted. */
+    uint32_t             numDropped;         /** Number of draw and compute calls dropped because they were empty, or because `BGFX_CONFIG_MAX_DRAW_CALLS` was reached. */
 
 } bgfx_encoder_stats_t;
 
@@ -883,6 +1002,10 @@ typedef struct bgfx_stats_s
     uint32_t             numBlit;            /** Number of blit calls submitted.          */
     uint32_t             maxGpuLatency;      /** GPU driver latency.                      */
     uint32_t             gpuFrameNum;        /** Frame which generated gpuTimeBegin, gpuTimeEnd. */
+    uint32_t             numBindChanges;     /** Number of binding changes between draws sharing program and blend in `ViewMode::Bindings` views. */
+    uint32_t             numBindChangesSaved; /** Number of binding changes removed by `ViewMode::Bindings` sorting. */
+    uint32_t             numUniformsSkipped; /** Number of uniform uploads skipped because value didn't change. */
+    uint32_t             numConditionFallbacks; /** Number of GPU predicated draws that used occlusion query result from previous frames. */
     uint16_t             numDynamicIndexBuffers; /** Number of used dynamic index buffers.    */
     uint16_t             numDynamicVertexBuffers; /** Number of used dynamic vertex buffers.   */
     uint16_t             numFrameBuffers;    /** Number of used frame buffers.            */
@@ -896,8 +1019,12 @@ typedef struct bgfx_stats_s
     uint16_t             numVertexLayouts;   /** Number of used vertex layouts.           */
     int64_t              textureMemoryUsed;  /** Estimate of texture memory used.         */
     int64_t              rtMemoryUsed;       /** Estimate of render target memory used.   */
+    int64_t              textureUploadStaged; /** Texture data uploaded through staging buffers during frame. */
+    int64_t              textureUploadDirect; /** Texture data uploaded directly from application memory during frame. */
     int32_t              transientVbUsed;    /** Amount of transient vertex buffer used.  */
     int32_t              transientIbUsed;    /** Amount of transient index buffer used.   */
+    uint32_t             frameMemoryUsed;    /** Amount of frame memory arena used.       */
+    uint32_t             frameMemoryMax;     /** Frame memory arena high-water mark.      */
     uint32_t             numPrims[BGFX_TOPOLOGY_COUNT]; /** Number of primitives rendered.           */
     int64_t              gpuMemoryMax;       /** Maximum available GPU memory for application. */
     int64_t              gpuMemoryUsed;      /** Amount of GPU memory used by the application. */
@@ -909,6 +1036,11 @@ typedef struct bgfx_stats_s
     bgfx_view_stats_t*   viewStats;          /** Array of View stats.                     */
     uint8_t              numEncoders;        /** Number of encoders used during frame.    */
     bgfx_encoder_stats_t* encoderStats;      /** Array of encoder stats.                  */
+    uint16_t             numGpuTimers;       /** Number of GPU timer scope stats.         */
+    bgfx_gpu_timer_stats_t* gpuTimerStats;   /** Array of GPU timer scope stats from most recent resolved frame. */
+    uint16_t             numGpuMemoryHeaps;  /** Number of GPU memory heap stats.         */
+    bgfx_gpu_memory_heap_stats_t* gpuMemoryHeapStats; /** Array of GPU memory heap stats.          */
+    float                resolutionScale;    /** Dynamic resolution scale applied to scalable views during frame. */
 
 } bgfx_stats_t;
 
@@ -1235,6 +1367,30 @@ BGFX_C_API const bgfx_memory_t* bgfx_alloc(uint32_t _size);
  */
 BGFX_C_API const bgfx_memory_t* bgfx_copy(const void* _data, uint32_t _size);
 
+/**
+ * Allocate buffer from per-frame memory arena to pass to bgfx calls. Memory
+ * is reclaimed at once after render thread is done with the frame, and it
+ * must be passed to bgfx before next `bgfx::frame` call. When arena is
+ * exhausted allocation falls back to `bgfx::alloc`.
+ *
+ * @param[in] _size Size to allocate.
+ *
+ * @returns Allocated memory.
+ *
+ */
+BGFX_C_API const bgfx_memory_t* bgfx_alloc_frame(uint32_t _size);
+
+/**
+ * Allocate buffer from per-frame memory arena and copy data into it.
+ *
+ * @param[in] _data Pointer to data to be copied.
+ * @param[in] _size Size of data to be copied.
+ *
+ * @returns Allocated memory.
+ *
+ */
+BGFX_C_API const bgfx_memory_t* bgfx_copy_frame(const void* _data, uint32_t _size);
+
 /**
  * Make reference to data to pass to bgfx. Unlike `bgfx::alloc`, this call
  * doesn't allocate memory for data. It just copies the _data pointer. You
@@ -2338,6 +2494,37 @@ BGFX_C_API void bgfx_set_view_frame_buffer(bgfx_view_id_t _id, bgfx_frame_buffer
  */
 BGFX_C_API void bgfx_set_view_transform(bgfx_view_id_t _id, const void* _view, const void* _proj);
 
+/**
+ * Set view dynamic resolution. Rect and scissor of scalable views, and
+ * scissors of draw calls submitted to them, are scaled by current dynamic
+ * resolution scale.
+ * @remarks
+ *   Scale used for the frame is reported in `Stats::resolutionScale`.
+ *   Scaled image starts at texture coordinate 0, with bottom-left
+ *   origin (`Caps::originBottomLeft`) rect is scaled toward bottom of
+ *   frame buffer.
+ *
+ * @param[in] _id View id.
+ * @param[in] _enabled Enable dynamic resolution scaling for view.
+ *
+ */
+BGFX_C_API void bgfx_set_view_dynamic_resolution(bgfx_view_id_t _id, bool _enabled);
+
+/**
+ * Set dynamic resolution controller parameters. Controller picks render
+ * scale for views marked with `bgfx::setViewDynamicResolution` from
+ * recent GPU frame times, trying to keep them within frame time budget.
+ * @remarks
+ *   Passing 0 for target frame time disables controller and resets scale
+ *   to 1.
+ *
+ * @param[in] _targetMs Target GPU frame time in milliseconds.
+ * @param[in] _minScale Minimum render scale.
+ * @param[in] _maxScale Maximum render scale.
+ *
+ */
+BGFX_C_API void bgfx_set_dynamic_resolution(float _targetMs, float _minScale, float _maxScale);
+
 /**
  * Post submit view reordering.
  *
@@ -2386,6 +2573,31 @@ BGFX_C_API void bgfx_encoder_end(bgfx_encoder_t* _encoder);
  */
 BGFX_C_API void bgfx_encoder_set_marker(bgfx_encoder_t* _this, const char* _name, int32_t _len);
 
+/**
+ * Begin GPU timer scope. Render items submitted by this encoder until matching
+ * `endGpuTimer` call are measured with GPU timestamp queries. Results are
+ * resolved asynchronously, and available a few frames later in `Stats::gpuTimerStats`.
+ * @remarks
+ *   Scopes can be nested, and must be closed before the end of the frame.
+ *   Timestamps are taken around sorted render items, scope measures everything
+ *   from its first to its last render item in sort order. In views that are
+ *   not `ViewMode::Sequential`, or when scope spans multiple views, that
+ *   includes render items submitted outside of scope, and they are counted
+ *   in `GpuTimerStats::numForeign`.
+ *
+ * @param[in] _name Scope name.
+ * @param[in] _len Scope name length (if length is INT32_MAX, it's expected
+ *  that _name is zero terminated string.
+ *
+ */
+BGFX_C_API void bgfx_encoder_begin_gpu_timer(bgfx_encoder_t* _this, const char* _name, int32_t _len);
+
+/**
+ * End GPU timer scope.
+ *
+ */
+BGFX_C_API void bgfx_encoder_end_gpu_timer(bgfx_encoder_t* _this);
+
 /**
  * Set render states for draw primitive.
  * @remarks
@@ -2419,9 +2631,10 @@ BGFX_C_API void bgfx_encoder_set_state(bgfx_encoder_t* _this, uint64_t _state, u
  *
  * @param[in] _handle Occlusion query handle.
  * @param[in] _visible Render if occlusion query is visible.
+ * @param[in] _gpu Predicate draw on GPU with query result from current frame, when `BGFX_CAPS_CONDITIONAL_RENDER` is supported.
  *
  */
-BGFX_C_API void bgfx_encoder_set_condition(bgfx_encoder_t* _this, bgfx_occlusion_query_handle_t _handle, bool _visible);
+BGFX_C_API void bgfx_encoder_set_condition(bgfx_encoder_t* _this, bgfx_occlusion_query_handle_t _handle, bool _visible, bool _gpu);
 
 /**
  * Set stencil test state.
@@ -2635,6 +2848,51 @@ BGFX_C_API void bgfx_encoder_set_instance_data_from_vertex_buffer(bgfx_encoder_t
  */
 BGFX_C_API void bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer(bgfx_encoder_t* _this, bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num);
 
+/**
+ * Set instance data buffer for draw primitive. Instance data is described by
+ * vertex layout and bound as instance rate stream.
+ * @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+ *
+ * @param[in] _handle Vertex buffer.
+ * @param[in] _startVertex First instance data.
+ * @param[in] _num Number of data instances.
+ * @param[in] _layoutHandle Vertex layout describing instance data. If invalid
+ *  handle is used, vertex layout used for creation
+ *  of vertex buffer will be used.
+ *
+ */
+BGFX_C_API void bgfx_encoder_set_instance_data_from_vertex_buffer_with_layout(bgfx_encoder_t* _this, bgfx_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
+
+/**
+ * Set instance data buffer for draw primitive. Instance data is described by
+ * vertex layout and bound as instance rate stream.
+ * @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+ *
+ * @param[in] _handle Dynamic vertex buffer.
+ * @param[in] _startVertex First instance data.
+ * @param[in] _num Number of data instances.
+ * @param[in] _layoutHandle Vertex layout describing instance data. If invalid
+ *  handle is used, vertex layout used for creation
+ *  of vertex buffer will be used.
+ *
+ */
+BGFX_C_API void bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout(bgfx_encoder_t* _this, bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
+
+/**
+ * Set instance data buffer for draw primitive. Instance data is described by
+ * vertex layout and bound as instance rate stream.
+ * @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+ *
+ * @param[in] _tvb Transient vertex buffer.
+ * @param[in] _start First instance data.
+ * @param[in] _num Number of data instances.
+ * @param[in] _layoutHandle Vertex layout describing instance data. If invalid
+ *  handle is used, vertex layout used for creation
+ *  of transient vertex buffer will be used.
+ *
+ */
+BGFX_C_API void bgfx_encoder_set_instance_data_from_transient_vertex_buffer(bgfx_encoder_t* _this, const bgfx_transient_vertex_buffer_t* _tvb, uint32_t _start, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
+
 /**
  * Set number of instances for auto generated instances use in conjunction
  * with gl_InstanceID.
@@ -2697,6 +2955,22 @@ BGFX_C_API void bgfx_encoder_submit(bgfx_encoder_t* _this, bgfx_view_id_t _id, b
  */
 BGFX_C_API void bgfx_encoder_submit_occlusion_query(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_occlusion_query_handle_t _occlusionQuery, uint32_t _depth, uint8_t _flags);
 
+/**
+ * Submit array of fully specified draw calls for rendering.
+ * @remarks
+ *   Draws reference ranges in shared uniform and texture arrays. Consecutive
+ *   draws referencing the same ranges share uniform data. State set on encoder
+ *   prior to this call is discarded.
+ *
+ * @param[in] _id View id.
+ * @param[in] _draws Draw descriptors.
+ * @param[in] _num Number of draw descriptors.
+ * @param[in] _uniforms Uniforms referenced by draw descriptors.
+ * @param[in] _textures Textures referenced by draw descriptors.
+ *
+ */
+BGFX_C_API void bgfx_encoder_submit_draws(bgfx_encoder_t* _this, bgfx_view_id_t _id, const bgfx_draw_desc_t* _draws, uint32_t _num, const bgfx_draw_uniform_t* _uniforms, const bgfx_draw_texture_t* _textures);
+
 /**
  * Submit primitive for rendering with index and instance data info from
  * indirect buffer.
@@ -2860,6 +3134,9 @@ BGFX_C_API void bgfx_encoder_blit(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgf
  * Request screen shot of window back buffer.
  * @remarks
  *   `bgfx::CallbackI::screenShot` must be implemented.
+ *   Noop renderer calls `bgfx::CallbackI::screenShot` with black BGRA8 image, with the same frame
+ *   latency other renderers have. `BGFX_RESET_CAPTURE` is emulated the same way. This is done only
+ *   when callback is passed to `bgfx::init`, default callback would write black image to disk.
  * @attention Frame buffer handle must be created with OS' target native window handle.
  *
  * @param[in] _handle Frame buffer handle. If handle is `BGFX_INVALID_HANDLE` request will be
@@ -2958,6 +3235,31 @@ BGFX_C_API uintptr_t bgfx_override_internal_texture(bgfx_texture_handle_t _handl
  */
 BGFX_C_API void bgfx_set_marker(const char* _name, int32_t _len);
 
+/**
+ * Begin GPU timer scope. Render items submitted until matching `endGpuTimer`
+ * call are measured with GPU timestamp queries. Results are resolved
+ * asynchronously, and available a few frames later in `Stats::gpuTimerStats`.
+ * @remarks
+ *   Scopes can be nested, and must be closed before the end of the frame.
+ *   Timestamps are taken around sorted render items, scope measures everything
+ *   from its first to its last render item in sort order. In views that are
+ *   not `ViewMode::Sequential`, or when scope spans multiple views, that
+ *   includes render items submitted outside of scope, and they are counted
+ *   in `GpuTimerStats::numForeign`.
+ *
+ * @param[in] _name Scope name.
+ * @param[in] _len Scope name length (if length is INT32_MAX, it's expected
+ *  that _name is zero terminated string.
+ *
+ */
+BGFX_C_API void bgfx_begin_gpu_timer(const char* _name, int32_t _len);
+
+/**
+ * End GPU timer scope.
+ *
+ */
+BGFX_C_API void bgfx_end_gpu_timer(void);
+
 /**
  * Set render states for draw primitive.
  * @remarks
@@ -2991,9 +3293,10 @@ BGFX_C_API void bgfx_set_state(uint64_t _state, uint32_t _rgba);
  *
  * @param[in] _handle Occlusion query handle.
  * @param[in] _visible Render if occlusion query is visible.
+ * @param[in] _gpu Predicate draw on GPU with query result from current frame, when `BGFX_CAPS_CONDITIONAL_RENDER` is supported.
  *
  */
-BGFX_C_API void bgfx_set_condition(bgfx_occlusion_query_handle_t _handle, bool _visible);
+BGFX_C_API void bgfx_set_condition(bgfx_occlusion_query_handle_t _handle, bool _visible, bool _gpu);
 
 /**
  * Set stencil test state.
@@ -3220,6 +3523,51 @@ BGFX_C_API void bgfx_set_instance_data_from_vertex_buffer(bgfx_vertex_buffer_han
  */
 BGFX_C_API void bgfx_set_instance_data_from_dynamic_vertex_buffer(bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num);
 
+/**
+ * Set instance data buffer for draw primitive. Instance data is described by
+ * vertex layout and bound as instance rate stream.
+ * @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+ *
+ * @param[in] _handle Vertex buffer.
+ * @param[in] _startVertex First instance data.
+ * @param[in] _num Number of data instances.
+ * @param[in] _layoutHandle Vertex layout describing instance data. If invalid
+ *  handle is used, vertex layout used for creation
+ *  of vertex buffer will be used.
+ *
+ */
+BGFX_C_API void bgfx_set_instance_data_from_vertex_buffer_with_layout(bgfx_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
+
+/**
+ * Set instance data buffer for draw primitive. Instance data is described by
+ * vertex layout and bound as instance rate stream.
+ * @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+ *
+ * @param[in] _handle Dynamic vertex buffer.
+ * @param[in] _startVertex First instance data.
+ * @param[in] _num Number of data instances.
+ * @param[in] _layoutHandle Vertex layout describing instance data. If invalid
+ *  handle is used, vertex layout used for creation
+ *  of vertex buffer will be used.
+ *
+ */
+BGFX_C_API void bgfx_set_instance_data_from_dynamic_vertex_buffer_with_layout(bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
+
+/**
+ * Set instance data buffer for draw primitive. Instance data is described by
+ * vertex layout and bound as instance rate stream.
+ * @attention Availability depends on: `BGFX_CAPS_INSTANCING_LAYOUT`.
+ *
+ * @param[in] _tvb Transient vertex buffer.
+ * @param[in] _start First instance data.
+ * @param[in] _num Number of data instances.
+ * @param[in] _layoutHandle Vertex layout describing instance data. If invalid
+ *  handle is used, vertex layout used for creation
+ *  of transient vertex buffer will be used.
+ *
+ */
+BGFX_C_API void bgfx_set_instance_data_from_transient_vertex_buffer(const bgfx_transient_vertex_buffer_t* _tvb, uint32_t _start, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
+
 /**
  * Set number of instances for auto generated instances use in conjunction
  * with gl_InstanceID.
@@ -3280,6 +3628,22 @@ BGFX_C_API void bgfx_submit(bgfx_view_id_t _id, bgfx_program_handle_t _program,
  */
 BGFX_C_API void bgfx_submit_occlusion_query(bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_occlusion_query_handle_t _occlusionQuery, uint32_t _depth, uint8_t _flags);
 
+/**
+ * Submit array of fully specified draw calls for rendering.
+ * @remarks
+ *   Draws reference ranges in shared uniform and texture arrays. Consecutive
+ *   draws referencing the same ranges share uniform data. State set on encoder
+ *   prior to this call is discarded.
+ *
+ * @param[in] _id View id.
+ * @param[in] _draws Draw descriptors.
+ * @param[in] _num Number of draw descriptors.
+ * @param[in] _uniforms Uniforms referenced by draw descriptors.
+ * @param[in] _textures Textures referenced by draw descriptors.
+ *
+ */
+BGFX_C_API void bgfx_submit_draws(bgfx_view_id_t _id, const bgfx_draw_desc_t* _draws, uint32_t _num, const bgfx_draw_uniform_t* _uniforms, const bgfx_draw_texture_t* _textures);
+
 /**
  * Submit primitive for rendering with index and instance data info from
  * indirect buffer.
@@ -3467,6 +3831,8 @@ typedef enum bgfx_function_id
     BGFX_FUNCTION_ID_GET_STATS,
     BGFX_FUNCTION_ID_ALLOC,
     BGFX_FUNCTION_ID_COPY,
+    BGFX_FUNCTION_ID_ALLOC_FRAME,
+    BGFX_FUNCTION_ID_COPY_FRAME,
     BGFX_FUNCTION_ID_MAKE_REF,
     BGFX_FUNCTION_ID_MAKE_REF_RELEASE,
     BGFX_FUNCTION_ID_SET_DEBUG,
@@ -3546,11 +3912,15 @@ typedef enum bgfx_function_id
     BGFX_FUNCTION_ID_SET_VIEW_MODE,
     BGFX_FUNCTION_ID_SET_VIEW_FRAME_BUFFER,
     BGFX_FUNCTION_ID_SET_VIEW_TRANSFORM,
+    BGFX_FUNCTION_ID_SET_VIEW_DYNAMIC_RESOLUTION,
+    BGFX_FUNCTION_ID_SET_DYNAMIC_RESOLUTION,
     BGFX_FUNCTION_ID_SET_VIEW_ORDER,
     BGFX_FUNCTION_ID_RESET_VIEW,
     BGFX_FUNCTION_ID_ENCODER_BEGIN,
     BGFX_FUNCTION_ID_ENCODER_END,
     BGFX_FUNCTION_ID_ENCODER_SET_MARKER,
+    BGFX_FUNCTION_ID_ENCODER_BEGIN_GPU_TIMER,
+    BGFX_FUNCTION_ID_ENCODER_END_GPU_TIMER,
     BGFX_FUNCTION_ID_ENCODER_SET_STATE,
     BGFX_FUNCTION_ID_ENCODER_SET_CONDITION,
     BGFX_FUNCTION_ID_ENCODER_SET_STENCIL,
@@ -3573,11 +3943,15 @@ typedef enum bgfx_function_id
     BGFX_FUNCTION_ID_ENCODER_SET_INSTANCE_DATA_BUFFER,
     BGFX_FUNCTION_ID_ENCODER_SET_INSTANCE_DATA_FROM_VERTEX_BUFFER,
     BGFX_FUNCTION_ID_ENCODER_SET_INSTANCE_DATA_FROM_DYNAMIC_VERTEX_BUFFER,
+    BGFX_FUNCTION_ID_ENCODER_SET_INSTANCE_DATA_FROM_VERTEX_BUFFER_WITH_LAYOUT,
+    BGFX_FUNCTION_ID_ENCODER_SET_INSTANCE_DATA_FROM_DYNAMIC_VERTEX_BUFFER_WITH_LAYOUT,
+    BGFX_FUNCTION_ID_ENCODER_SET_INSTANCE_DATA_FROM_TRANSIENT_VERTEX_BUFFER,
     BGFX_FUNCTION_ID_ENCODER_SET_INSTANCE_COUNT,
     BGFX_FUNCTION_ID_ENCODER_SET_TEXTURE,
     BGFX_FUNCTION_ID_ENCODER_TOUCH,
     BGFX_FUNCTION_ID_ENCODER_SUBMIT,
     BGFX_FUNCTION_ID_ENCODER_SUBMIT_OCCLUSION_QUERY,
+    BGFX_FUNCTION_ID_ENCODER_SUBMIT_DRAWS,
     BGFX_FUNCTION_ID_ENCODER_SUBMIT_INDIRECT,
     BGFX_FUNCTION_ID_ENCODER_SUBMIT_INDIRECT_COUNT,
     BGFX_FUNCTION_ID_ENCODER_SET_COMPUTE_INDEX_BUFFER,
@@ -3597,6 +3971,8 @@ typedef enum bgfx_function_id
     BGFX_FUNCTION_ID_OVERRIDE_INTERNAL_TEXTURE_PTR,
     BGFX_FUNCTION_ID_OVERRIDE_INTERNAL_TEXTURE,
     BGFX_FUNCTION_ID_SET_MARKER,
+    BGFX_FUNCTION_ID_BEGIN_GPU_TIMER,
+    BGFX_FUNCTION_ID_END_GPU_TIMER,
     BGFX_FUNCTION_ID_SET_STATE,
     BGFX_FUNCTION_ID_SET_CONDITION,
     BGFX_FUNCTION_ID_SET_STENCIL,
@@ -3619,11 +3995,15 @@ typedef enum bgfx_function_id
     BGFX_FUNCTION_ID_SET_INSTANCE_DATA_BUFFER,
     BGFX_FUNCTION_ID_SET_INSTANCE_DATA_FROM_VERTEX_BUFFER,
     BGFX_FUNCTION_ID_SET_INSTANCE_DATA_FROM_DYNAMIC_VERTEX_BUFFER,
+    BGFX_FUNCTION_ID_SET_INSTANCE_DATA_FROM_VERTEX_BUFFER_WITH_LAYOUT,
+    BGFX_FUNCTION_ID_SET_INSTANCE_DATA_FROM_DYNAMIC_VERTEX_BUFFER_WITH_LAYOUT,
+    BGFX_FUNCTION_ID_SET_INSTANCE_DATA_FROM_TRANSIENT_VERTEX_BUFFER,
     BGFX_FUNCTION_ID_SET_INSTANCE_COUNT,
     BGFX_FUNCTION_ID_SET_TEXTURE,
     BGFX_FUNCTION_ID_TOUCH,
     BGFX_FUNCTION_ID_SUBMIT,
     BGFX_FUNCTION_ID_SUBMIT_OCCLUSION_QUERY,
+    BGFX_FUNCTION_ID_SUBMIT_DRAWS,
     BGFX_FUNCTION_ID_SUBMIT_INDIRECT,
     BGFX_FUNCTION_ID_SUBMIT_INDIRECT_COUNT,
     BGFX_FUNCTION_ID_SET_COMPUTE_INDEX_BUFFER,
@@ -3669,6 +4049,8 @@ struct bgfx_interface_vtbl
     const bgfx_stats_t* (*get_stats)(void);
     const bgfx_memory_t* (*alloc)(uint32_t _size);
     const bgfx_memory_t* (*copy)(const void* _data, uint32_t _size);
+    const bgfx_memory_t* (*alloc_frame)(uint32_t _size);
+    const bgfx_memory_t* (*copy_frame)(const void* _data, uint32_t _size);
     const bgfx_memory_t* (*make_ref)(const void* _data, uint32_t _size);
     const bgfx_memory_t* (*make_ref_release)(const void* _data, uint32_t _size, bgfx_release_fn_t _releaseFn, void* _userData);
     void (*set_debug)(uint32_t _debug);
@@ -3748,13 +4130,17 @@ struct bgfx_interface_vtbl
     void (*set_view_mode)(bgfx_view_id_t _id, bgfx_view_mode_t _mode);
     void (*set_view_frame_buffer)(bgfx_view_id_t _id, bgfx_frame_buffer_handle_t _handle);
     void (*set_view_transform)(bgfx_view_id_t _id, const void* _view, const void* _proj);
+    void (*set_view_dynamic_resolution)(bgfx_view_id_t _id, bool _enabled);
+    void (*set_dynamic_resolution)(float _targetMs, float _minScale, float _maxScale);
     void (*set_view_order)(bgfx_view_id_t _id, uint16_t _num, const bgfx_view_id_t* _order);
     void (*reset_view)(bgfx_view_id_t _id);
     bgfx_encoder_t* (*encoder_begin)(bool _forThread);
     void (*encoder_end)(bgfx_encoder_t* _encoder);
     void (*encoder_set_marker)(bgfx_encoder_t* _this, const char* _name, int32_t _len);
+    void (*encoder_begin_gpu_timer)(bgfx_encoder_t* _this, const char* _name, int32_t _len);
+    void (*encoder_end_gpu_timer)(bgfx_encoder_t* _this);
     void (*encoder_set_state)(bgfx_encoder_t* _this, uint64_t _state, uint32_t _rgba);
-    void (*encoder_set_condition)(bgfx_encoder_t* _this, bgfx_occlusion_query_handle_t _handle, bool _visible);
+    void (*encoder_set_condition)(bgfx_encoder_t* _this, bgfx_occlusion_query_handle_t _handle, bool _visible, bool _gpu);
     void (*encoder_set_stencil)(bgfx_encoder_t* _this, uint32_t _fstencil, uint32_t _bstencil);
     uint16_t (*encoder_set_scissor)(bgfx_encoder_t* _this, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height);
     void (*encoder_set_scissor_cached)(bgfx_encoder_t* _this, uint16_t _cache);
@@ -3775,11 +4161,15 @@ struct bgfx_interface_vtbl
     void (*encoder_set_instance_data_buffer)(bgfx_encoder_t* _this, const bgfx_instance_data_buffer_t* _idb, uint32_t _start, uint32_t _num);
     void (*encoder_set_instance_data_from_vertex_buffer)(bgfx_encoder_t* _this, bgfx_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num);
     void (*encoder_set_instance_data_from_dynamic_vertex_buffer)(bgfx_encoder_t* _this, bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num);
+    void (*encoder_set_instance_data_from_vertex_buffer_with_layout)(bgfx_encoder_t* _this, bgfx_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
+    void (*encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout)(bgfx_encoder_t* _this, bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
+    void (*encoder_set_instance_data_from_transient_vertex_buffer)(bgfx_encoder_t* _this, const bgfx_transient_vertex_buffer_t* _tvb, uint32_t _start, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
     void (*encoder_set_instance_count)(bgfx_encoder_t* _this, uint32_t _numInstances);
     void (*encoder_set_texture)(bgfx_encoder_t* _this, uint8_t _stage, bgfx_uniform_handle_t _sampler, bgfx_texture_handle_t _handle, uint32_t _flags);
     void (*encoder_touch)(bgfx_encoder_t* _this, bgfx_view_id_t _id);
     void (*encoder_submit)(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, uint32_t _depth, uint8_t _flags);
     void (*encoder_submit_occlusion_query)(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_occlusion_query_handle_t _occlusionQuery, uint32_t _depth, uint8_t _flags);
+    void (*encoder_submit_draws)(bgfx_encoder_t* _this, bgfx_view_id_t _id, const bgfx_draw_desc_t* _draws, uint32_t _num, const bgfx_draw_uniform_t* _uniforms, const bgfx_draw_texture_t* _textures);
     void (*encoder_submit_indirect)(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags);
     void (*encoder_submit_indirect_count)(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, bgfx_index_buffer_handle_t _numHandle, uint32_t _numIndex, uint32_t _numMax, uint32_t _depth, uint8_t _flags);
     void (*encoder_set_compute_index_buffer)(bgfx_encoder_t* _this, uint8_t _stage, bgfx_index_buffer_handle_t _handle, bgfx_access_t _access);
@@ -3799,8 +4189,10 @@ struct bgfx_interface_vtbl
     uintptr_t (*override_internal_texture_ptr)(bgfx_texture_handle_t _handle, uintptr_t _ptr);
     uintptr_t (*override_internal_texture)(bgfx_texture_handle_t _handle, uint16_t _width, uint16_t _height, uint8_t _numMips, bgfx_texture_format_t _format, uint64_t _flags);
     void (*set_marker)(const char* _name, int32_t _len);
+    void (*begin_gpu_timer)(const char* _name, int32_t _len);
+    void (*end_gpu_timer)(void);
     void (*set_state)(uint64_t _state, uint32_t _rgba);
-    void (*set_condition)(bgfx_occlusion_query_handle_t _handle, bool _visible);
+    void (*set_condition)(bgfx_occlusion_query_handle_t _handle, bool _visible, bool _gpu);
     void (*set_stencil)(uint32_t _fstencil, uint32_t _bstencil);
     uint16_t (*set_scissor)(uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height);
     void (*set_scissor_cached)(uint16_t _cache);
@@ -3821,11 +4213,15 @@ struct bgfx_interface_vtbl
     void (*set_instance_data_buffer)(const bgfx_instance_data_buffer_t* _idb, uint32_t _start, uint32_t _num);
     void (*set_instance_data_from_vertex_buffer)(bgfx_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num);
     void (*set_instance_data_from_dynamic_vertex_buffer)(bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num);
+    void (*set_instance_data_from_vertex_buffer_with_layout)(bgfx_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
+    void (*set_instance_data_from_dynamic_vertex_buffer_with_layout)(bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
+    void (*set_instance_data_from_transient_vertex_buffer)(const bgfx_transient_vertex_buffer_t* _tvb, uint32_t _start, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle);
     void (*set_instance_count)(uint32_t _numInstances);
     void (*set_texture)(uint8_t _stage, bgfx_uniform_handle_t _sampler, bgfx_texture_handle_t _handle, uint32_t _flags);
     void (*touch)(bgfx_view_id_t _id);
     void (*submit)(bgfx_view_id_t _id, bgfx_program_handle_t _program, uint32_t _depth, uint8_t _flags);
     void (*submit_occlusion_query)(bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_occlusion_query_handle_t _occlusionQuery, uint32_t _depth, uint8_t _flags);
+    void (*submit_draws)(bgfx_view_id_t _id, const bgfx_draw_desc_t* _draws, uint32_t _num, const bgfx_draw_uniform_t* _uniforms, const bgfx_draw_texture_t* _textures);
     void (*submit_indirect)(bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags);
     void (*submit_indirect_count)(bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, bgfx_index_buffer_handle_t _numHandle, uint32_t _numIndex, uint32_t _numMax, uint32_t _depth, uint8_t _flags);
     void (*set_compute_index_buffer)(uint8_t _stage, bgfx_index_buffer_handle_t _handle, bgfx_access_t _access);
@@ -15,7 +15,7 @@
 #ifndef BGFX_DEFINES_H_HEADER_GUARD
 #define BGFX_DEFINES_H_HEADER_GUARD
 
-#define BGFX_API_VERSION UINT32_C(127)
+#define BGFX_API_VERSION UINT32_C(140)
 
 /**
  * Color RGB/alpha/depth write. When it's not specified write will be disabled.
@@ -493,6 +493,8 @@
 #define BGFX_CAPS_PRIMITIVE_ID                    UINT64_C(0x0000000010000000) //!< PrimitiveID is available in fragment shader.
 #define BGFX_CAPS_VIEWPORT_LAYER_ARRAY            UINT64_C(0x0000000020000000) //!< Viewport layer is available in vertex shader.
 #define BGFX_CAPS_DRAW_INDIRECT_COUNT             UINT64_C(0x0000000040000000) //!< Draw indirect with indirect count is supported.
+#define BGFX_CAPS_CONDITIONAL_RENDER              UINT64_C(0x0000000080000000) //!< Draw can be predicated on occlusion query result on GPU.
+#define BGFX_CAPS_INSTANCING_LAYOUT               UINT64_C(0x0000000100000000) //!< Instance data described by vertex layout is supported.
 /// All texture compare modes are supported.
 #define BGFX_CAPS_TEXTURE_COMPARE_ALL (0 \
 	| BGFX_CAPS_TEXTURE_COMPARE_RESERVED \
@@ -188,6 +188,7 @@ function bgfxProjectBase(_kind, _defines)
 	if _OPTIONS["with-amalgamated"] then
 		excludes {
 			path.join(BGFX_DIR, "src/bgfx.cpp"),
+			path.join(BGFX_DIR, "src/blockallocator.cpp"),
 			path.join(BGFX_DIR, "src/debug_**.cpp"),
 			path.join(BGFX_DIR, "src/dxgi.cpp"),
 			path.join(BGFX_DIR, "src/glcontext_**.cpp"),
@@ -58,6 +58,8 @@ project ("example-common")
 
 	removefiles {
 		path.join(BGFX_DIR, "examples/common/example-glue.cpp"),
+		-- Requires bimg_encode, it's compiled into projects that use it.
+		path.join(BGFX_DIR, "examples/common/texturecompress/**.cpp"),
 	}
 
 	if _OPTIONS["with-sdl"] then
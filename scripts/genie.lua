@@ -50,6 +50,11 @@ newoption {
 	description = "Enable building examples.",
 }
 
+newoption {
+	trigger = "with-tests",
+	description = "Enable building tests.",
+}
+
 newaction {
 	trigger = "idl",
 	description = "Generate bgfx interface source code",
@@ -514,7 +519,8 @@ if _OPTIONS["with-shared-lib"] then
 	bgfxProject("-shared-lib", "SharedLib", BGFX_CONFIG)
 end
 
-if _OPTIONS["with-tools"] then
+if _OPTIONS["with-tools"]
+or _OPTIONS["with-tests"] then
 	group "libs"
 	dofile(path.join(BIMG_DIR, "scripts/bimg_encode.lua"))
 end
@@ -600,3 +606,75 @@ if _OPTIONS["with-tools"] then
 	dofile "geometryc.lua"
 	dofile "geometryv.lua"
 end
+
+if _OPTIONS["with-tests"] then
+	group "tests"
+	project "bgfx.test"
+		kind "ConsoleApp"
+
+		debugdir (path.join(BGFX_DIR, "tests") )
+
+		removeflags {
+			"NoExceptions",
+		}
+
+		includedirs {
+			path.join(BIMG_DIR, "include"),
+			path.join(BGFX_DIR, "include"),
+			path.join(BGFX_DIR, "3rdparty"),
+			path.join(BGFX_DIR, "examples/common"),
+			path.join(BX_DIR,   "3rdparty"),
+		}
+
+		files {
+			path.join(BX_DIR,   "3rdparty/catch/catch_amalgamated.cpp"),
+			path.join(BGFX_DIR, "tests/*_test.cpp"),
+			path.join(BGFX_DIR, "tests/*.h"),
+			path.join(BGFX_DIR, "tests/run_test.cpp"),
+			path.join(BGFX_DIR, "examples/common/cascadedshadowmap/cascadedshadowmap.cpp"),
+			path.join(BGFX_DIR, "examples/common/lightcull/lightcull.cpp"),
+			path.join(BGFX_DIR, "examples/common/hizcull/hizcull_reference.cpp"),
+			path.join(BGFX_DIR, "examples/common/imgui/imgui.cpp"),
+			path.join(BGFX_DIR, "examples/common/isosurface/isosurface.cpp"),
+			path.join(BGFX_DIR, "examples/common/shadowvolume/shadowvolume.cpp"),
+			path.join(BGFX_DIR, "examples/common/terrainlod/terrainlod.cpp"),
+			path.join(BGFX_DIR, "examples/common/texturecompress/texturecompress.cpp"),
+			path.join(BGFX_DIR, "examples/common/workerpool/workerpool.cpp"),
+			path.join(BGFX_DIR, "3rdparty/dear-imgui/**.cpp"),
+		}
+
+		links {
+			"bgfx",
+			"bimg_encode",
+			"bimg_decode",
+			"bimg",
+		}
+
+		using_bx()
+
+		configuration { "vs* or mingw*" }
+			links {
+				"gdi32",
+				"psapi",
+			}
+
+		configuration { "linux-* or freebsd" }
+			links {
+				"X11",
+				"GL",
+				"pthread",
+			}
+
+		configuration { "osx*" }
+			linkoptions {
+				"-framework Cocoa",
+				"-framework IOKit",
+				"-framework Metal",
+				"-framework OpenGL",
+				"-framework QuartzCore",
+			}
+
+		configuration {}
+
+		strip()
+end
@@ -4,6 +4,7 @@
  */
 
 #include "bgfx.cpp"
+#include "blockallocator.cpp"
 #include "debug_renderdoc.cpp"
 #include "dxgi.cpp"
 #include "glcontext_egl.cpp"
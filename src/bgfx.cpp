@@ -425,6 +425,13 @@ namespace bgfx
 		return s_graphicsDebuggerPresent;
 	}
 
+	bool isCallbackUserProvided()
+	{
+		return NULL != g_callback
+			&& s_callbackStub != g_callback
+			;
+	}
+
 	void fatal(const char* _filePath, uint16_t _line, Fatal::Enum _code, const char* _format, ...)
 	{
 		va_list argList;
@@ -634,6 +641,8 @@ namespace bgfx
 			va_copy(argListCopy, _argList);
 			num = bx::vsnprintf(temp, num, _format, argListCopy);
 
+			setDirty(_y);
+
 			uint8_t attr = _attr;
 			MemSlot* mem = &m_mem[_y*m_width+_x];
 			for (uint32_t ii = 0, xx = _x; ii < num && xx < m_width; ++ii)
@@ -701,6 +710,20 @@ namespace bgfx
 		m_vb = s_ctx->createTransientVertexBuffer(numBatchVertices*m_layout.m_stride, &m_layout);
 		m_ib = s_ctx->createTransientIndexBuffer(numBatchIndices*2);
 		m_scale = bx::max<uint8_t>(scale, 1);
+
+		// Every character is a quad, index buffer is the same for every batch.
+		uint16_t* indices = (uint16_t*)m_ib->data;
+		for (uint32_t ii = 0; ii < numCharsPerBatch; ++ii)
+		{
+			const uint32_t startVertex = ii*4;
+			indices[0] = uint16_t(startVertex+0);
+			indices[1] = uint16_t(startVertex+1);
+			indices[2] = uint16_t(startVertex+2);
+			indices[3] = uint16_t(startVertex+2);
+			indices[4] = uint16_t(startVertex+3);
+			indices[5] = uint16_t(startVertex+0);
+			indices += 6;
+		}
 	}
 
 	void TextVideoMemBlitter::shutdown()
@@ -759,52 +782,56 @@ namespace bgfx
 	};
 	BX_STATIC_ASSERT(BX_COUNTOF(s_paletteLinear) == 16);
 
-	void blit(RendererContextI* _renderCtx, TextVideoMemBlitter& _blitter, const TextVideoMem& _mem)
+	uint32_t TextVideoMem::updateBlitCache(uint8_t _scale, bool _srgb)
 	{
-		struct Vertex
-		{
-			float m_x;
-			float m_y;
-			float m_z;
-			uint32_t m_fg;
-			uint32_t m_bg;
-			float m_u;
-			float m_v;
-		};
-
-		uint32_t yy = 0;
-		uint32_t xx = 0;
+		typedef BlitVertex Vertex;
 
 		const float texelWidth  = 1.0f/2048.0f;
 		const float texelHeight = 1.0f/24.0f;
-		const float utop        = (_mem.m_small ? 0.0f :  8.0f)*texelHeight;
-		const float ubottom     = (_mem.m_small ? 8.0f : 24.0f)*texelHeight;
-		const float fontHeight  = (_mem.m_small ? 8.0f : 16.0f)*_blitter.m_scale;
-		const float fontWidth   = 8.0f * _blitter.m_scale;
-
-		_renderCtx->blitSetup(_blitter);
+		const float utop        = (m_small ? 0.0f :  8.0f)*texelHeight;
+		const float ubottom     = (m_small ? 8.0f : 24.0f)*texelHeight;
+		const float fontHeight  = (m_small ? 8.0f : 16.0f)*_scale;
+		const float fontWidth   = 8.0f * _scale;
 
-		const uint32_t* palette = 0 != (s_ctx->m_init.resolution.reset & BGFX_RESET_SRGB_BACKBUFFER)
+		const uint32_t* palette = _srgb
 			? s_paletteLinear
 			: s_paletteSrgb
 			;
 
-		for (;yy < _mem.m_height;)
+		const uint32_t width  = m_width;
+		const uint32_t height = m_height;
+
+		const uint32_t blitKey = uint32_t(_scale) | (_srgb ? 0x100 : 0);
+		bool invalidate = false;
+
+		if (NULL == m_blitVertices
+		||  blitKey != m_blitKey)
+		{
+			releaseBlitCache();
+			m_blitMem      = (MemSlot*)bx::alloc(g_allocator, m_size*sizeof(MemSlot) );
+			m_blitNum      = (uint16_t*)bx::alloc(g_allocator, height*sizeof(uint16_t) );
+			m_blitVertices = bx::alloc(g_allocator, m_size*4*sizeof(Vertex) );
+			m_blitKey      = blitKey;
+			invalidate = true;
+		}
+
+		uint32_t numRows = 0;
+
+		for (uint32_t yy = 0; yy < height; ++yy)
 		{
-			Vertex* vertex = (Vertex*)_blitter.m_vb->data;
-			uint16_t* indices = (uint16_t*)_blitter.m_ib->data;
-			uint32_t startVertex = 0;
-			uint32_t numIndices = 0;
+			const MemSlot* line = &m_mem[yy*width];
+			MemSlot* blitLine   = &m_blitMem[yy*width];
 
-			for (; yy < _mem.m_height && numIndices < numBatchIndices; ++yy)
+			if (invalidate
+			|| (m_dirty[yy] && 0 != bx::memCmp(line, blitLine, width*sizeof(MemSlot) ) ) )
 			{
-				xx = xx < _mem.m_width ? xx : 0;
-				const TextVideoMem::MemSlot* line = &_mem.m_mem[yy*_mem.m_width+xx];
+				Vertex* rowVertices = &( (Vertex*)m_blitVertices)[yy*width*4];
+				Vertex* rowVertex   = rowVertices;
 
-				for (; xx < _mem.m_width && numIndices < numBatchIndices; ++xx)
+				for (uint32_t xx = 0; xx < width; ++xx)
 				{
-					uint32_t ch = line->character;
-					const uint8_t attr = line->attribute;
+					uint32_t ch = line[xx].character;
+					const uint8_t attr = line[xx].attribute;
 
 					if (ch > 0xff)
 					{
@@ -825,32 +852,59 @@ namespace bgfx
 							{ (xx  )*fontWidth, (yy+1)*fontHeight, 0.0f, fg, bg, (ch  )*8.0f*texelWidth, ubottom },
 						};
 
-						bx::memCopy(vertex, vert, sizeof(vert) );
-						vertex += 4;
+						bx::memCopy(rowVertex, vert, sizeof(vert) );
+						rowVertex += 4;
+					}
+				}
 
-						indices[0] = uint16_t(startVertex+0);
-						indices[1] = uint16_t(startVertex+1);
-						indices[2] = uint16_t(startVertex+2);
-						indices[3] = uint16_t(startVertex+2);
-						indices[4] = uint16_t(startVertex+3);
-						indices[5] = uint16_t(startVertex+0);
+				m_blitNum[yy] = uint16_t( (rowVertex - rowVertices)/4);
+				bx::memCopy(blitLine, line, width*sizeof(MemSlot) );
+				++numRows;
+			}
 
-						startVertex += 4;
-						indices += 6;
+			m_dirty[yy] = false;
+		}
 
-						numIndices += 6;
-					}
+		return numRows;
+	}
 
-					line++;
-				}
+	void blit(RendererContextI* _renderCtx, TextVideoMemBlitter& _blitter, TextVideoMem& _mem)
+	{
+		typedef TextVideoMem::BlitVertex Vertex;
+
+		const bool srgb = 0 != (s_ctx->m_init.resolution.reset & BGFX_RESET_SRGB_BACKBUFFER);
+		_mem.updateBlitCache(_blitter.m_scale, srgb);
+
+		_renderCtx->blitSetup(_blitter);
+
+		const uint32_t width  = _mem.m_width;
+		const uint32_t height = _mem.m_height;
+
+		Vertex* vertex = (Vertex*)_blitter.m_vb->data;
+		uint32_t numChars = 0;
 
-				if (numIndices >= numBatchIndices)
+		for (uint32_t yy = 0; yy < height; ++yy)
+		{
+			const Vertex* rowVertices = &( (const Vertex*)_mem.m_blitVertices)[yy*width*4];
+
+			for (uint32_t ii = 0, num = _mem.m_blitNum[yy]; ii < num;)
+			{
+				const uint32_t count = bx::min(num-ii, numCharsPerBatch-numChars);
+				bx::memCopy(&vertex[numChars*4], &rowVertices[ii*4], count*4*sizeof(Vertex) );
+				numChars += count;
+				ii       += count;
+
+				if (numCharsPerBatch == numChars)
 				{
-					break;
+					_renderCtx->blitRender(_blitter, numChars*6);
+					numChars = 0;
 				}
 			}
+		}
 
-			_renderCtx->blitRender(_blitter, numIndices);
+		if (0 < numChars)
+		{
+			_renderCtx->blitRender(_blitter, numChars*6);
 		}
 	}
 
@@ -1235,6 +1289,19 @@ namespace bgfx
 			return;
 		}
 
+		if (BX_ENABLED(BGFX_CONFIG_DEBUG)
+		&&  isValid(m_draw.m_instanceDataLayout)
+		&&  isValid(_program) )
+		{
+			const ProgramRef& pr = s_ctx->m_programRef[_program.idx];
+			const uint32_t usedMask = s_ctx->m_shaderRef[pr.m_vsh.idx].m_attribMask;
+			BX_ASSERT(0 != (usedMask & s_ctx->m_vertexLayoutRef.m_attribMask[m_draw.m_instanceDataLayout.idx])
+				, "Instance data layout %d doesn't provide any attribute used by program %d."
+				, m_draw.m_instanceDataLayout.idx
+				, _program.idx
+				);
+		}
+
 		if (0 == m_draw.m_numVertices
 		&&  0 == m_draw.m_numIndices)
 		{
@@ -1306,10 +1373,17 @@ namespace bgfx
 		{
 			m_draw.m_stateFlags |= BGFX_STATE_INTERNAL_OCCLUSION_QUERY;
 			m_draw.m_occlusionQuery = _occlusionQuery;
+			m_draw.m_submitFlags &= ~BGFX_SUBMIT_INTERNAL_OCCLUSION_GPU;
+		}
+		else if (0 != (m_draw.m_submitFlags & BGFX_SUBMIT_INTERNAL_OCCLUSION_GPU) )
+		{
+			bx::atomicFetchAndAdd<uint32_t>(&m_frame->m_numConditionGpu, 1);
 		}
 
 		m_frame->m_renderItem[renderItemIdx].draw = m_draw;
+		m_frame->m_renderItem[renderItemIdx].draw.m_scissor = scaleScissor(_id, m_draw.m_scissor);
 		m_frame->m_renderItemBind[renderItemIdx]  = m_bind;
+		m_frame->m_renderItemGpuTimer[renderItemIdx] = m_gpuTimerCurrent;
 
 		m_draw.clear(_flags);
 		m_bind.clear(_flags);
@@ -1319,6 +1393,227 @@ namespace bgfx
 		}
 	}
 
+	static Rect getFrameBufferRect(FrameBufferHandle _handle, const Resolution& _resolution)
+	{
+		Rect rect(0, 0, uint16_t(_resolution.width), uint16_t(_resolution.height) );
+
+		if (isValid(_handle) )
+		{
+			const FrameBufferRef& fbr = s_ctx->m_frameBufferRef[_handle.idx];
+			const BackbufferRatio::Enum bbRatio = fbr.m_window
+				? BackbufferRatio::Count
+				: BackbufferRatio::Enum(s_ctx->m_textureRef[fbr.un.m_th[0].idx].m_bbRatio)
+				;
+
+			if (BackbufferRatio::Count != bbRatio)
+			{
+				getTextureSizeFromRatio(bbRatio, rect.m_width, rect.m_height);
+			}
+			else
+			{
+				rect.m_width  = fbr.m_width;
+				rect.m_height = fbr.m_height;
+			}
+		}
+
+		return rect;
+	}
+
+	// With bottom-left origin, rect is scaled toward bottom of frame buffer, so
+	// that scaled image starts at texture coordinate 0 on every renderer.
+	static void scaleViewRect(Rect& _rect, float _scale, FrameBufferHandle _handle, const Resolution& _resolution)
+	{
+		if (_rect.isZero() )
+		{
+			return;
+		}
+
+		if (g_caps.originBottomLeft)
+		{
+			const int32_t height = getFrameBufferRect(_handle, _resolution).m_height;
+
+			_rect.m_y = uint16_t(bx::max<int32_t>(height - _rect.m_y - _rect.m_height, 0) );
+			_rect.scale(_scale);
+			_rect.m_y = uint16_t(bx::max<int32_t>(height - _rect.m_y - _rect.m_height, 0) );
+		}
+		else
+		{
+			_rect.scale(_scale);
+		}
+	}
+
+	uint16_t EncoderImpl::scaleScissor(ViewId _id, uint16_t _scissor)
+	{
+		const float scale = m_frame->m_resolutionScale;
+
+		if (UINT16_MAX == _scissor
+		||  1.0f == scale
+		|| !s_ctx->isViewScalable(_id) )
+		{
+			return _scissor;
+		}
+
+		// Consecutive draws usually share scissor, scaled rect is added to
+		// rect cache only once for them.
+		if (m_scissorScaleSrc != _scissor)
+		{
+			Rect rect = m_frame->m_frameCache.m_rectCache.m_cache[_scissor];
+			scaleViewRect(rect, scale, s_ctx->m_view[_id].m_fbh, s_ctx->m_init.resolution);
+
+			m_scissorScaleSrc = _scissor;
+			m_scissorScaled   = bx::narrowCast<uint16_t>(m_frame->m_frameCache.m_rectCache.add(rect.m_x, rect.m_y, rect.m_width, rect.m_height) );
+		}
+
+		return m_scissorScaled;
+	}
+
+	static bool isDrawValid(const DrawDesc& _draw)
+	{
+		return 0 != _draw.numVertices
+			|| (isValid(_draw.indexBuffer) && 0 != _draw.numIndices)
+			;
+	}
+
+	void EncoderImpl::submit(ViewId _id, const DrawDesc* _draws, uint32_t _num, const DrawUniform* _uniforms, const DrawTexture* _textures)
+	{
+		discard(BGFX_DISCARD_ALL);
+
+		UniformBuffer* uniformBuffer = m_frame->m_uniformBuffer[m_uniformIdx];
+		m_uniformBegin = uniformBuffer->getPos();
+		m_uniformEnd   = m_uniformBegin;
+
+		uint32_t numValid = 0;
+		for (uint32_t ii = 0; ii < _num; ++ii)
+		{
+			numValid += isDrawValid(_draws[ii]);
+		}
+
+		// Reserve render items for the whole batch with single atomic.
+		const uint32_t first = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, numValid, BGFX_CONFIG_MAX_DRAW_CALLS);
+		const uint32_t num   = bx::min(numValid, BGFX_CONFIG_MAX_DRAW_CALLS-first);
+
+		m_numSubmitted += num;
+		m_numDropped   += _num - num;
+
+		const ViewMode::Enum mode = s_ctx->m_view[_id].m_mode;
+		const UniformHandle invalidSampler = BGFX_INVALID_HANDLE;
+
+		m_key.m_view = _id;
+
+		const DrawDesc* prev = NULL;
+
+		for (uint32_t ii = 0, renderItemIdx = first, end = first+num; renderItemIdx < end; ++ii)
+		{
+			const DrawDesc& draw = _draws[ii];
+
+			if (!isDrawValid(draw) )
+			{
+				continue;
+			}
+
+			const bool sameTextures = true
+				&& NULL != prev
+				&& prev->firstTexture == draw.firstTexture
+				&& prev->numTextures  == draw.numTextures
+				;
+			const bool sameUniforms = true
+				&& sameTextures
+				&& prev->firstUniform == draw.firstUniform
+				&& prev->numUniforms  == draw.numUniforms
+				;
+			prev = &draw;
+
+			m_draw.clear(BGFX_DISCARD_ALL);
+
+			setState(draw.state, draw.rgba);
+			setTransform(draw.transform, draw.numTransforms);
+			m_draw.m_scissor = scaleScissor(_id, draw.scissor);
+
+			if (isValid(draw.indexBuffer) )
+			{
+				const IndexBuffer& ib = s_ctx->m_indexBuffers[draw.indexBuffer.idx];
+				setIndexBuffer(draw.indexBuffer, ib, draw.startIndex, draw.numIndices);
+			}
+
+			if (isValid(draw.vertexBuffer) )
+			{
+				setVertexBuffer(0, draw.vertexBuffer, draw.startVertex, draw.numVertices, draw.layout);
+			}
+			else
+			{
+				setVertexCount(draw.numVertices);
+			}
+
+			if (!sameTextures)
+			{
+				m_bind.clear(BGFX_DISCARD_BINDINGS);
+
+				for (uint32_t jj = 0; jj < draw.numTextures; ++jj)
+				{
+					const DrawTexture& texture = _textures[draw.firstTexture + jj];
+					setTexture(texture.stage, invalidSampler, texture.handle, texture.flags);
+				}
+			}
+
+			if (!sameUniforms)
+			{
+				m_uniformBegin = m_frame->m_uniformBuffer[m_uniformIdx]->getPos();
+
+				for (uint32_t jj = 0; jj < draw.numUniforms; ++jj)
+				{
+					const DrawUniform& uniform = _uniforms[draw.firstUniform + jj];
+					const UniformRef& ref = s_ctx->m_uniformRef[uniform.handle.idx];
+					setUniform(ref.m_type, uniform.handle, uniform.value, UINT16_MAX != uniform.num ? uniform.num : ref.m_num);
+				}
+
+				for (uint32_t jj = 0; jj < draw.numTextures; ++jj)
+				{
+					const DrawTexture& texture = _textures[draw.firstTexture + jj];
+
+					if (isValid(texture.sampler) )
+					{
+						uint32_t stage = texture.stage;
+						setUniform(UniformType::Sampler, texture.sampler, &stage, 1);
+					}
+				}
+
+				m_uniformEnd = m_frame->m_uniformBuffer[m_uniformIdx]->getPos();
+			}
+
+			m_key.m_program = isValid(draw.program)
+				? draw.program
+				: ProgramHandle{0}
+				;
+
+			SortKey::Enum type;
+			switch (mode)
+			{
+			case ViewMode::Sequential:      m_key.m_seq   = s_ctx->getSeqIncr(_id); type = SortKey::SortSequence; break;
+			case ViewMode::DepthAscending:  m_key.m_depth =            draw.depth;  type = SortKey::SortDepth;    break;
+			case ViewMode::DepthDescending: m_key.m_depth = UINT32_MAX-draw.depth;  type = SortKey::SortDepth;    break;
+			default:                        m_key.m_depth =            draw.depth;  type = SortKey::SortProgram;  break;
+			}
+
+			m_frame->m_sortKeys[renderItemIdx]   = m_key.encodeDraw(type);
+			m_frame->m_sortValues[renderItemIdx] = RenderItemCount(renderItemIdx);
+
+			m_draw.m_uniformIdx   = m_uniformIdx;
+			m_draw.m_uniformBegin = m_uniformBegin;
+			m_draw.m_uniformEnd   = m_uniformEnd;
+			m_draw.m_numVertices  = m_numVertices[0];
+
+			m_frame->m_renderItem[renderItemIdx].draw = m_draw;
+			m_frame->m_renderItemBind[renderItemIdx]  = m_bind;
+			m_frame->m_renderItemGpuTimer[renderItemIdx] = m_gpuTimerCurrent;
+
+			++renderItemIdx;
+		}
+
+		discard(BGFX_DISCARD_ALL);
+		m_uniformBegin = m_frame->m_uniformBuffer[m_uniformIdx]->getPos();
+		m_uniformEnd   = m_uniformBegin;
+	}
+
 	void EncoderImpl::dispatch(ViewId _id, ProgramHandle _handle, uint32_t _numX, uint32_t _numY, uint32_t _numZ, uint8_t _flags)
 	{
 		if (BX_ENABLED(BGFX_CONFIG_DEBUG_UNIFORM) )
@@ -1365,6 +1660,7 @@ namespace bgfx
 		m_compute.m_uniformEnd   = m_uniformEnd;
 		m_frame->m_renderItem[renderItemIdx].compute = m_compute;
 		m_frame->m_renderItemBind[renderItemIdx]     = m_bind;
+		m_frame->m_renderItemGpuTimer[renderItemIdx] = m_gpuTimerCurrent;
 
 		m_compute.clear(_flags);
 		m_bind.clear(_flags);
@@ -1407,117 +1703,367 @@ namespace bgfx
 	{
 		BGFX_PROFILER_SCOPE("bgfx/Sort", 0xff2040ff);
 
-		ViewId viewRemap[BGFX_CONFIG_MAX_VIEWS];
-		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
+		uint32_t viewUsed[(BGFX_CONFIG_MAX_VIEWS+31)/32];
+		bx::memSet(viewUsed, 0, sizeof(viewUsed) );
+
+		// View 0 rect is used by renderers as default viewport.
+		viewUsed[0] = 1;
+
+		for (uint32_t ii = 0, num = m_numRenderItems; ii < num; ++ii)
+		{
+			const ViewId view = SortKey::decodeView(m_sortKeys[ii]);
+			viewUsed[view/32] |= UINT32_C(1) << (view%32);
+
+			m_sortKeys[ii] = SortKey::remapView(m_sortKeys[ii], m_viewRemapInv);
+		}
+
+		for (uint32_t ii = 0, num = m_numBlitItems; ii < num; ++ii)
 		{
-			viewRemap[m_viewRemap[ii] ] = ViewId(ii);
+			BlitKey key;
+			key.decode(m_blitKeys[ii]);
+			viewUsed[key.m_view/32] |= UINT32_C(1) << (key.m_view%32);
+
+			m_blitKeys[ii] = BlitKey::remapView(m_blitKeys[ii], m_viewRemapInv);
+		}
 
-			View& view = m_view[ii];
-			Rect rect(0, 0, uint16_t(m_resolution.width), uint16_t(m_resolution.height) );
+		m_numActiveViews = 0;
 
-			if (isValid(view.m_fbh) )
+		for (uint32_t word = 0; word < BX_COUNTOF(viewUsed); ++word)
+		{
+			for (uint32_t bits = viewUsed[word]; 0 != bits; bits &= bits - 1)
 			{
-				const FrameBufferRef& fbr = s_ctx->m_frameBufferRef[view.m_fbh.idx];
-				const BackbufferRatio::Enum bbRatio = fbr.m_window
-					? BackbufferRatio::Count
-					: BackbufferRatio::Enum(s_ctx->m_textureRef[fbr.un.m_th[0].idx].m_bbRatio)
-					;
+				const ViewId id = ViewId(word*32 + bx::uint32_cnttz(bits) );
+				m_activeView[m_numActiveViews++] = id;
 
-				if (BackbufferRatio::Count != bbRatio)
-				{
-					getTextureSizeFromRatio(bbRatio, rect.m_width, rect.m_height);
-				}
-				else
+				View& view = m_view[id];
+				const Rect rect = getFrameBufferRect(view.m_fbh, m_resolution);
+
+				view.m_rect.intersect(rect);
+
+				if (!view.m_scissor.isZero() )
 				{
-					rect.m_width  = fbr.m_width;
-					rect.m_height = fbr.m_height;
+					view.m_scissor.intersect(rect);
 				}
 			}
+		}
+
+		bx::radixSort(m_sortKeys, s_ctx->m_tempKeys, m_sortValues, s_ctx->m_tempValues, m_numRenderItems);
+
+		bx::radixSort(m_blitKeys, (uint32_t*)&s_ctx->m_tempKeys, m_numBlitItems);
 
-			view.m_rect.intersect(rect);
+		m_perfStats.numBindChanges      = 0;
+		m_perfStats.numBindChangesSaved = 0;
 
-			if (!view.m_scissor.isZero() )
+		for (uint32_t ii = 0, num = m_numActiveViews; ii < num; ++ii)
+		{
+			if (ViewMode::Bindings == m_view[m_activeView[ii] ].m_mode)
 			{
-				view.m_scissor.intersect(rect);
+				sortBindings();
+				break;
 			}
 		}
 
-		for (uint32_t ii = 0, num = m_numRenderItems; ii < num; ++ii)
+		sortConditions();
+
+		sortGpuTimers();
+	}
+
+	static uint32_t hashBindings(const RenderDraw& _draw, const RenderBind& _bind)
+	{
+		bx::HashMurmur2A murmur;
+		murmur.begin();
+
+		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_TEXTURE_SAMPLERS; ++ii)
 		{
-			m_sortKeys[ii] = SortKey::remapView(m_sortKeys[ii], viewRemap);
+			const Binding& bind = _bind.m_bind[ii];
+			murmur.add(bind.m_idx);
+
+			if (kInvalidHandle != bind.m_idx)
+			{
+				murmur.add(bind.m_type);
+				murmur.add(bind.m_samplerFlags);
+			}
 		}
 
-		bx::radixSort(m_sortKeys, s_ctx->m_tempKeys, m_sortValues, s_ctx->m_tempValues, m_numRenderItems);
+		murmur.add(_draw.m_streamMask);
 
-		for (uint32_t ii = 0, num = m_numBlitItems; ii < num; ++ii)
+		for (uint32_t streamMask = _draw.m_streamMask; 0 != streamMask; streamMask &= streamMask - 1)
 		{
-			m_blitKeys[ii] = BlitKey::remapView(m_blitKeys[ii], viewRemap);
+			const Stream& stream = _draw.m_stream[bx::uint32_cnttz(streamMask)];
+			murmur.add(stream.m_handle.idx);
+			murmur.add(stream.m_layoutHandle.idx);
 		}
 
-		bx::radixSort(m_blitKeys, (uint32_t*)&s_ctx->m_tempKeys, m_numBlitItems);
+		murmur.add(_draw.m_indexBuffer.idx);
+		murmur.add(_draw.m_instanceDataBuffer.idx);
+		murmur.add(_draw.m_instanceDataLayout.idx);
+
+		return murmur.end();
 	}
 
-	RenderFrame::Enum renderFrame(int32_t _msecs)
+	void Frame::sortBindings()
 	{
-		if (BX_ENABLED(BGFX_CONFIG_MULTITHREADED) )
+		BGFX_PROFILER_SCOPE("bgfx/SortBindings", 0xff2040ff);
+
+		constexpr uint64_t kDrawProgramMask = kSortKeyDrawBit|kSortKeyDrawTypeMask;
+		constexpr uint64_t kDrawProgram     = kSortKeyDrawBit|kSortKeyDrawTypeProgram;
+		constexpr uint64_t kRunMask         = kSortKeyViewMask|kDrawProgramMask|kSortKeyDraw0BlendMask|kSortKeyDraw0ProgramMask;
+
+		uint64_t* tempKeys = s_ctx->m_tempKeys;
+		RenderItemCount* tempValues = s_ctx->m_tempValues;
+
+		uint32_t numBefore = 0;
+		uint32_t numAfter  = 0;
+
+		for (uint32_t begin = 0, num = m_numRenderItems; begin < num;)
 		{
-			if (s_renderFrameCalled)
-			{
-				BGFX_CHECK_RENDER_THREAD();
-			}
+			const uint64_t runKey = m_sortKeys[begin] & kRunMask;
 
-			if (NULL == s_ctx)
+			uint32_t end = begin + 1;
+
+			if (kDrawProgram == (runKey & kDrawProgramMask)
+			&&  ViewMode::Bindings == m_view[m_viewRemap[SortKey::decodeView(runKey)] ].m_mode)
 			{
-				s_renderFrameCalled = true;
-				s_threadIndex = ~BGFX_API_THREAD_MAGIC;
-				return RenderFrame::NoContext;
+				for (; end < num && runKey == (m_sortKeys[end] & kRunMask); ++end)
+				{
+				}
 			}
 
-			int32_t msecs = -1 == _msecs
-				? BGFX_CONFIG_API_SEMAPHORE_TIMEOUT
-				: _msecs
-				;
-			RenderFrame::Enum result = s_ctx->renderFrame(msecs);
-			if (RenderFrame::Exiting == result)
+			const uint32_t count = end - begin;
+
+			if (1 < count)
 			{
-				Context* ctx = s_ctx;
-				ctx->apiSemWait();
-				s_ctx = NULL;
-				ctx->renderSemPost();
+				// Item position inside run is in low bits, which keeps sort stable
+				// for draws with identical bindings.
+				for (uint32_t ii = 0; ii < count; ++ii)
+				{
+					const RenderItemCount itemIdx = m_sortValues[begin + ii];
+					const uint32_t hash = hashBindings(m_renderItem[itemIdx].draw, m_renderItemBind[itemIdx]);
+					tempKeys[ii] = (uint64_t(hash) << 32) | ii;
+
+					numBefore += 0 != ii && hash != uint32_t(tempKeys[ii-1] >> 32);
+				}
+
+				bx::quickSort(tempKeys, count, bx::compareAscending<uint64_t>);
+
+				for (uint32_t ii = 0; ii < count; ++ii)
+				{
+					numAfter += 0 != ii && uint32_t(tempKeys[ii] >> 32) != uint32_t(tempKeys[ii-1] >> 32);
+					tempValues[ii] = RenderItemCount(uint32_t(tempKeys[ii]) );
+				}
+
+				for (uint32_t ii = 0; ii < count; ++ii)
+				{
+					const uint32_t src = begin + tempValues[ii];
+					tempKeys[ii]   = m_sortKeys[src];
+					tempValues[ii] = m_sortValues[src];
+				}
+
+				bx::memCopy(&m_sortKeys[begin],   tempKeys,   count*sizeof(uint64_t) );
+				bx::memCopy(&m_sortValues[begin], tempValues, count*sizeof(RenderItemCount) );
 			}
 
-			return result;
+			begin = end;
 		}
 
-		BX_ASSERT(false, "This call only makes sense if used with multi-threaded renderer.");
-		return RenderFrame::NoContext;
+		m_perfStats.numBindChanges      = numAfter;
+		m_perfStats.numBindChangesSaved = numBefore - numAfter;
 	}
 
-	const uint32_t g_uniformTypeSize[UniformType::Count+1] =
-	{
-		sizeof(int32_t),
-		0,
-		4*sizeof(float),
-		3*3*sizeof(float),
-		4*4*sizeof(float),
-		1,
-	};
-
-	void UniformBuffer::writeUniform(UniformType::Enum _type, uint16_t _loc, const void* _value, uint16_t _num)
+	void Frame::sortGpuTimers()
 	{
-		const uint32_t opcode = encodeOpcode(_type, _loc, _num, true);
-		write(opcode);
-		write(_value, g_uniformTypeSize[_type]*_num);
-	}
+		m_numGpuTimerScopes = 0;
 
-	void UniformBuffer::writeUniformHandle(UniformType::Enum _type, uint16_t _loc, UniformHandle _handle, uint16_t _num)
-	{
-		const uint32_t opcode = encodeOpcode(_type, _loc, _num, false);
-		write(opcode);
-		write(&_handle, sizeof(UniformHandle) );
-	}
+		const uint32_t numGpuTimers = bx::min<uint32_t>(m_numGpuTimers, BGFX_CONFIG_MAX_GPU_TIMERS);
 
-	void UniformBuffer::writeMarker(const bx::StringView& _name)
+		if (0 == numGpuTimers)
+		{
+			return;
+		}
+
+		for (uint32_t ii = 0; ii < numGpuTimers; ++ii)
+		{
+			GpuTimerScope& scope = m_gpuTimer[ii];
+			scope.m_begin = UINT32_MAX;
+			scope.m_end   = 0;
+			scope.m_num   = 0;
+			scope.m_view  = 0;
+		}
+
+		// Find sorted range of render items covered by each scope. Parent scope
+		// covers render items of all its children. Range is not contiguous when
+		// sort order interleaves scope with render items submitted outside of it.
+		for (uint32_t ii = 0, num = m_numRenderItems; ii < num; ++ii)
+		{
+			const uint32_t itemIdx = m_sortValues[ii];
+
+			for (uint16_t idx = m_renderItemGpuTimer[itemIdx]; UINT16_MAX != idx; idx = m_gpuTimer[idx].m_parent)
+			{
+				GpuTimerScope& scope = m_gpuTimer[idx];
+
+				if (UINT32_MAX == scope.m_begin)
+				{
+					scope.m_begin = ii;
+					scope.m_view  = m_viewRemap[SortKey::decodeView(m_sortKeys[ii])];
+				}
+
+				scope.m_end = ii+1;
+				++scope.m_num;
+			}
+		}
+
+		// Scopes that don't cover any render item are not measured.
+		for (uint32_t ii = 0; ii < numGpuTimers; ++ii)
+		{
+			if (UINT32_MAX != m_gpuTimer[ii].m_begin)
+			{
+				m_gpuTimerBegin[m_numGpuTimerScopes] = uint16_t(ii);
+				m_gpuTimerEnd[m_numGpuTimerScopes]   = uint16_t(ii);
+				++m_numGpuTimerScopes;
+			}
+		}
+
+		// Order of events in which backend opens and closes timer queries. When
+		// scopes start at the same position parent is opened first, and when they
+		// end at the same position child is closed first. Parent scope is always
+		// allocated before its children.
+		for (uint32_t ii = 1, num = m_numGpuTimerScopes; ii < num; ++ii)
+		{
+			const uint16_t idx   = m_gpuTimerBegin[ii];
+			const uint32_t begin = m_gpuTimer[idx].m_begin;
+
+			uint32_t jj = ii;
+			for (; 0 < jj && m_gpuTimer[m_gpuTimerBegin[jj-1] ].m_begin > begin; --jj)
+			{
+				m_gpuTimerBegin[jj] = m_gpuTimerBegin[jj-1];
+			}
+
+			m_gpuTimerBegin[jj] = idx;
+		}
+
+		for (uint32_t ii = 1, num = m_numGpuTimerScopes; ii < num; ++ii)
+		{
+			const uint16_t idx = m_gpuTimerEnd[ii];
+			const uint32_t end = m_gpuTimer[idx].m_end;
+
+			uint32_t jj = ii;
+			for (; 0 < jj && m_gpuTimer[m_gpuTimerEnd[jj-1] ].m_end >= end; --jj)
+			{
+				m_gpuTimerEnd[jj] = m_gpuTimerEnd[jj-1];
+			}
+
+			m_gpuTimerEnd[jj] = idx;
+		}
+	}
+
+	void Frame::sortConditions()
+	{
+		m_perfStats.numConditionFallbacks = 0;
+
+		if (0 == m_numConditionGpu)
+		{
+			return;
+		}
+
+		BGFX_PROFILER_SCOPE("bgfx/SortConditions", 0xff2040ff);
+
+		uint32_t issued[(BGFX_CONFIG_MAX_OCCLUSION_QUERIES+31)/32];
+		bx::memSet(issued, 0, sizeof(issued) );
+
+		// GPU predicated draw must come after draw issuing its query in order
+		// in which backend executes render items. Otherwise draw falls back to
+		// query result from previous frames.
+		for (uint32_t ii = 0, num = m_numRenderItems; ii < num; ++ii)
+		{
+			if (0 == (m_sortKeys[ii] & kSortKeyDrawBit) )
+			{
+				continue;
+			}
+
+			RenderDraw& draw = m_renderItem[m_sortValues[ii] ].draw;
+
+			if (!isValid(draw.m_occlusionQuery) )
+			{
+				continue;
+			}
+
+			const uint16_t idx = draw.m_occlusionQuery.idx;
+
+			if (0 != (draw.m_stateFlags & BGFX_STATE_INTERNAL_OCCLUSION_QUERY) )
+			{
+				issued[idx/32] |= UINT32_C(1) << (idx%32);
+			}
+			else if (0 != (draw.m_submitFlags & BGFX_SUBMIT_INTERNAL_OCCLUSION_GPU)
+				 &&  0 == (issued[idx/32] & (UINT32_C(1) << (idx%32) ) ) )
+			{
+				BX_TRACE("Occlusion query %d is not issued before draw conditioned on it, using CPU fallback.", idx);
+				draw.m_submitFlags &= ~BGFX_SUBMIT_INTERNAL_OCCLUSION_GPU;
+				++m_perfStats.numConditionFallbacks;
+			}
+		}
+	}
+
+	RenderFrame::Enum renderFrame(int32_t _msecs)
+	{
+		if (BX_ENABLED(BGFX_CONFIG_MULTITHREADED) )
+		{
+			if (s_renderFrameCalled)
+			{
+				BGFX_CHECK_RENDER_THREAD();
+			}
+
+			if (NULL == s_ctx)
+			{
+				s_renderFrameCalled = true;
+				s_threadIndex = ~BGFX_API_THREAD_MAGIC;
+				return RenderFrame::NoContext;
+			}
+
+			int32_t msecs = -1 == _msecs
+				? BGFX_CONFIG_API_SEMAPHORE_TIMEOUT
+				: _msecs
+				;
+			RenderFrame::Enum result = s_ctx->renderFrame(msecs);
+			if (RenderFrame::Exiting == result)
+			{
+				Context* ctx = s_ctx;
+				ctx->apiSemWait();
+				s_ctx = NULL;
+				ctx->renderSemPost();
+			}
+
+			return result;
+		}
+
+		BX_ASSERT(false, "This call only makes sense if used with multi-threaded renderer.");
+		return RenderFrame::NoContext;
+	}
+
+	const uint32_t g_uniformTypeSize[UniformType::Count+1] =
+	{
+		sizeof(int32_t),
+		0,
+		4*sizeof(float),
+		3*3*sizeof(float),
+		4*4*sizeof(float),
+		1,
+	};
+
+	void UniformBuffer::writeUniform(UniformType::Enum _type, uint16_t _loc, const void* _value, uint16_t _num)
+	{
+		const uint32_t opcode = encodeOpcode(_type, _loc, _num, true);
+		write(opcode);
+		write(_value, g_uniformTypeSize[_type]*_num);
+	}
+
+	void UniformBuffer::writeUniformHandle(UniformType::Enum _type, uint16_t _loc, UniformHandle _handle, uint16_t _num)
+	{
+		const uint32_t opcode = encodeOpcode(_type, _loc, _num, false);
+		write(opcode);
+		write(&_handle, sizeof(UniformHandle) );
+	}
+
+	void UniformBuffer::writeMarker(const bx::StringView& _name)
 	{
 		const uint16_t num = bx::narrowCast<uint16_t>(_name.getLength()+1);
 		const uint32_t opcode = encodeOpcode(bgfx::UniformType::Count, 0, num, true);
@@ -1566,6 +2112,8 @@ namespace bgfx
 		CAPS_FLAGS(BGFX_CAPS_VERTEX_ID),
 		CAPS_FLAGS(BGFX_CAPS_PRIMITIVE_ID),
 		CAPS_FLAGS(BGFX_CAPS_VIEWPORT_LAYER_ARRAY),
+		CAPS_FLAGS(BGFX_CAPS_CONDITIONAL_RENDER),
+		CAPS_FLAGS(BGFX_CAPS_INSTANCING_LAYOUT),
 #undef CAPS_FLAGS
 	};
 
@@ -1791,6 +2339,170 @@ namespace bgfx
 		return TextureFormat::Enum(_imageContainer.m_format);
 	}
 
+	static void decodeToBgra8(void* _dst, uint32_t _dstPitch, uint32_t _width, uint32_t _height, const void* _src, uint32_t _srcWidth, uint32_t _srcHeight, TextureFormat::Enum _format)
+	{
+		if (_width  == _srcWidth
+		&&  _height == _srcHeight)
+		{
+			bimg::imageDecodeToBgra8(g_allocator, _dst, _src, _width, _height, _dstPitch, bimg::TextureFormat::Enum(_format) );
+			return;
+		}
+
+		// Block compressed source is decoded in whole blocks, and then cropped.
+		const uint32_t pitch = _srcWidth*4;
+		void* temp = bx::alloc(g_allocator, pitch*_srcHeight);
+		bimg::imageDecodeToBgra8(g_allocator, temp, _src, _srcWidth, _srcHeight, pitch, bimg::TextureFormat::Enum(_format) );
+		bx::memCopy(_dst, _dstPitch, temp, pitch, _width*4, _height);
+		bx::free(g_allocator, temp);
+	}
+
+	const Memory* textureDecodeToBgra8(const Memory* _mem, const bimg::ImageContainer& _imageContainer)
+	{
+		BGFX_PROFILER_SCOPE("bgfx/Decode texture", 0xff2040ff);
+
+		const uint16_t numSides = uint16_t(_imageContainer.m_numLayers * (_imageContainer.m_cubeMap ? 6 : 1) );
+		const uint8_t  numMips  = _imageContainer.m_numMips;
+
+		bx::MemoryReader reader(_mem->data, _mem->size);
+		bx::Error err;
+
+		uint32_t magic;
+		bx::read(&reader, magic, &err);
+
+		TextureCreate src;
+		src.m_mem = NULL;
+
+		const bool texCreate = BGFX_CHUNK_MAGIC_TEX == magic;
+		if (texCreate)
+		{
+			bx::read(&reader, src, &err);
+		}
+
+		const Memory* data = NULL;
+
+		if (!texCreate
+		||  NULL != src.m_mem)
+		{
+			uint32_t size = 0;
+
+			for (uint16_t side = 0; side < numSides; ++side)
+			{
+				for (uint8_t lod = 0; lod < numMips; ++lod)
+				{
+					const uint32_t width  = bx::max<uint32_t>(1, _imageContainer.m_width  >> lod);
+					const uint32_t height = bx::max<uint32_t>(1, _imageContainer.m_height >> lod);
+					const uint32_t depth  = bx::max<uint32_t>(1, _imageContainer.m_depth  >> lod);
+					size += width*height*depth*4;
+				}
+			}
+
+			data = alloc(size);
+			uint8_t* dst = data->data;
+
+			for (uint16_t side = 0; side < numSides; ++side)
+			{
+				for (uint8_t lod = 0; lod < numMips; ++lod)
+				{
+					const uint32_t width  = bx::max<uint32_t>(1, _imageContainer.m_width  >> lod);
+					const uint32_t height = bx::max<uint32_t>(1, _imageContainer.m_height >> lod);
+					const uint32_t depth  = bx::max<uint32_t>(1, _imageContainer.m_depth  >> lod);
+					const uint32_t pitch  = width*4;
+
+					bimg::ImageMip mip;
+					if (bimg::imageGetRawData(_imageContainer, side, lod, _mem->data, _mem->size, mip) )
+					{
+						const uint32_t srcSlice = mip.m_size / bx::max<uint32_t>(1, mip.m_depth);
+
+						for (uint32_t zz = 0; zz < depth; ++zz)
+						{
+							decodeToBgra8(
+								  &dst[zz*pitch*height]
+								, pitch
+								, width
+								, height
+								, &mip.m_data[zz*srcSlice]
+								, mip.m_width
+								, mip.m_height
+								, TextureFormat::Enum(mip.m_format)
+								);
+						}
+					}
+
+					dst += pitch*height*depth;
+				}
+			}
+		}
+
+		const Memory* mem = alloc(sizeof(uint32_t)+sizeof(TextureCreate) );
+
+		bx::StaticMemoryBlockWriter writer(mem->data, mem->size);
+		bx::write(&writer, uint32_t(BGFX_CHUNK_MAGIC_TEX), bx::ErrorAssert{});
+
+		TextureCreate tc;
+		tc.m_width     = uint16_t(_imageContainer.m_width);
+		tc.m_height    = uint16_t(_imageContainer.m_height);
+		tc.m_depth     = _imageContainer.m_depth > 1 ? uint16_t(_imageContainer.m_depth) : 0;
+		tc.m_numLayers = _imageContainer.m_numLayers;
+		tc.m_numMips   = numMips;
+		tc.m_format    = TextureFormat::BGRA8;
+		tc.m_cubeMap   = _imageContainer.m_cubeMap;
+		tc.m_mem       = data;
+		bx::write(&writer, tc, bx::ErrorAssert{});
+
+		if (NULL != src.m_mem)
+		{
+			release(src.m_mem);
+		}
+
+		release(_mem);
+
+		return mem;
+	}
+
+	const Memory* textureDecodeToBgra8(const Memory* _mem, TextureFormat::Enum _format, uint16_t _width, uint16_t _height, uint16_t _depth, uint16_t _pitch)
+	{
+		BGFX_PROFILER_SCOPE("bgfx/Decode texture", 0xff2040ff);
+
+		const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(bimg::TextureFormat::Enum(_format) );
+		const uint32_t srcWidth  = bx::strideAlign(_width,  blockInfo.blockWidth);
+		const uint32_t srcHeight = bx::strideAlign(_height, blockInfo.blockHeight);
+		const uint32_t srcPitch  = (srcWidth / blockInfo.blockWidth) * blockInfo.blockSize;
+		const uint32_t numRows   = srcHeight / blockInfo.blockHeight;
+		const uint32_t pitch     = UINT16_MAX == _pitch ? srcPitch : _pitch;
+		const uint32_t depth     = bx::max<uint16_t>(1, _depth);
+
+		const uint32_t dstPitch = _width*4;
+		const uint32_t dstSlice = dstPitch*_height;
+		const Memory* mem = alloc(dstSlice*depth);
+
+		uint8_t* temp = pitch == srcPitch
+			? NULL
+			: (uint8_t*)bx::alloc(g_allocator, srcPitch*numRows)
+			;
+
+		for (uint32_t zz = 0; zz < depth; ++zz)
+		{
+			const uint8_t* src = &_mem->data[zz*pitch*numRows];
+
+			if (NULL != temp)
+			{
+				bx::memCopy(temp, srcPitch, src, pitch, srcPitch, numRows);
+				src = temp;
+			}
+
+			decodeToBgra8(&mem->data[zz*dstSlice], dstPitch, _width, _height, src, srcWidth, srcHeight, _format);
+		}
+
+		if (NULL != temp)
+		{
+			bx::free(g_allocator, temp);
+		}
+
+		release(_mem);
+
+		return mem;
+	}
+
 	const char* getName(TextureFormat::Enum _fmt)
 	{
 		return bimg::getName(bimg::TextureFormat::Enum(_fmt));
@@ -1954,6 +2666,13 @@ namespace bgfx
 			m_viewRemap[ii] = ViewId(ii);
 		}
 
+		bx::memSet(m_seq, 0, sizeof(m_seq) );
+		m_numSeqViews = 0;
+
+		bx::memSet(m_viewScalable, 0, sizeof(m_viewScalable) );
+		m_dynamicResolution.reset(0.0f, 1.0f, 1.0f);
+		m_dynamicResolutionGpuFrameNum = UINT32_MAX;
+
 		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
 		{
 			resetView(ViewId(ii) );
@@ -2346,8 +3065,50 @@ namespace bgfx
 		m_submit->m_debug = m_debug;
 		m_submit->m_perfStats.numViews = 0;
 
-		bx::memCopy(m_submit->m_viewRemap, m_viewRemap, sizeof(m_viewRemap) );
-		bx::memCopy(m_submit->m_view, m_view, sizeof(m_view) );
+		if (m_submit->m_viewRemapDirty)
+		{
+			m_submit->m_viewRemapDirty = false;
+			bx::memCopy(m_submit->m_viewRemap, m_viewRemap, sizeof(m_viewRemap) );
+
+			for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
+			{
+				m_submit->m_viewRemapInv[m_viewRemap[ii] ] = ViewId(ii);
+			}
+		}
+
+		// Frame::sort clips rect and scissor of views it used, those must be
+		// copied again even if they were not modified.
+		for (uint32_t ii = 0, num = m_submit->m_numActiveViews; ii < num; ++ii)
+		{
+			m_submit->setViewDirty(m_submit->m_activeView[ii]);
+		}
+
+		m_submit->m_numActiveViews = 0;
+
+		const float resolutionScale = m_submit->m_resolutionScale;
+
+		for (uint32_t word = 0; word < BX_COUNTOF(m_submit->m_viewDirty); ++word)
+		{
+			// Scale might change without scalable view being modified, those
+			// are copied every frame.
+			m_submit->m_viewDirty[word] |= m_viewScalable[word];
+
+			for (uint32_t bits = m_submit->m_viewDirty[word]; 0 != bits; bits &= bits - 1)
+			{
+				const uint32_t id = word*32 + bx::uint32_cnttz(bits);
+				View& view = m_submit->m_view[id];
+				bx::memCopy(&view, &m_view[id], sizeof(View) );
+
+				if (1.0f != resolutionScale
+				&&  isViewScalable(ViewId(id) ) )
+				{
+					scaleViewRect(view.m_rect,    resolutionScale, view.m_fbh, m_submit->m_resolution);
+					scaleViewRect(view.m_scissor, resolutionScale, view.m_fbh, m_submit->m_resolution);
+				}
+			}
+
+			m_submit->m_viewDirty[word] = 0;
+		}
 
 		if (m_colorPaletteDirty > 0)
 		{
@@ -2360,6 +3121,23 @@ namespace bgfx
 
 		m_submit->finish();
 
+		// Render frame has finished at this point, its GPU time drives scale
+		// of the next submitted frame.
+		{
+			const Stats& stats = m_render->m_perfStats;
+			float gpuTimeMs = 0.0f;
+
+			if (0 != stats.gpuTimerFreq
+			&&  stats.gpuTimeEnd > stats.gpuTimeBegin
+			&&  stats.gpuFrameNum != m_dynamicResolutionGpuFrameNum)
+			{
+				m_dynamicResolutionGpuFrameNum = stats.gpuFrameNum;
+				gpuTimeMs = float(double(stats.gpuTimeEnd - stats.gpuTimeBegin)*1000.0/double(stats.gpuTimerFreq) );
+			}
+
+			m_dynamicResolution.update(gpuTimeMs);
+		}
+
 		bx::swap(m_render, m_submit);
 
 		bx::memCopy(m_render->m_occlusion, m_submit->m_occlusion, sizeof(m_submit->m_occlusion) );
@@ -2372,8 +3150,14 @@ namespace bgfx
 
 		uint32_t nextFrameNum = m_render->m_frameNum + 1;
 		m_submit->start(nextFrameNum);
+		m_submit->m_resolutionScale = m_dynamicResolution.m_scale;
 
-		bx::memSet(m_seq, 0, sizeof(m_seq) );
+		for (uint32_t ii = 0, num = m_numSeqViews; ii < num; ++ii)
+		{
+			m_seq[m_seqView[ii] ] = 0;
+		}
+
+		m_numSeqViews = 0;
 
 		m_submit->m_textVideoMem->resize(
 			  m_render->m_textVideoMem->m_small
@@ -2403,11 +3187,13 @@ namespace bgfx
 			if (m_renderCtx->isDeviceRemoved() )
 			{
 				// Something horribly went wrong, fallback to noop renderer.
+				m_renderWorkerPool.shutdown();
 				rendererDestroy(m_renderCtx);
 
 				Init init;
 				init.type = RendererType::Noop;
 				m_renderCtx = rendererCreate(init);
+				m_renderWorkerPool.init(m_renderCtx, m_singleThreaded ? 0 : BGFX_CONFIG_RENDER_WORKER_THREADS);
 				g_caps.rendererType = RendererType::Noop;
 			}
 		}
@@ -2689,107 +3475,309 @@ namespace bgfx
 #endif // BX_PLATFORM_WINDOWS
 	}
 
-	RendererContextI* rendererCreate(const Init& _init)
+	RendererContextI* rendererCreate(const Init& _init)
+	{
+		int32_t scores[RendererType::Count];
+		uint32_t numScores = 0;
+
+		for (uint32_t ii = 0; ii < RendererType::Count; ++ii)
+		{
+			RendererType::Enum renderer = RendererType::Enum(ii);
+			if (s_rendererCreator[ii].supported)
+			{
+				int32_t score = 0;
+				if (_init.type == renderer)
+				{
+					score += 1000;
+				}
+
+				score += RendererType::Noop != renderer ? 1 : 0;
+
+				if (BX_ENABLED(BX_PLATFORM_WINDOWS) )
+				{
+					if (windowsVersionIs(Condition::GreaterEqual, 0x0602) )
+					{
+						score += RendererType::Direct3D11 == renderer ? 20 : 0;
+						score += RendererType::Direct3D12 == renderer ? 10 : 0;
+					}
+					else if (windowsVersionIs(Condition::GreaterEqual, 0x0601) )
+					{
+						score += RendererType::Direct3D11 == renderer ?   20 : 0;
+						score += RendererType::Direct3D12 == renderer ? -100 : 0;
+					}
+					else
+					{
+						score += RendererType::Direct3D12 == renderer ? -100 : 0;
+					}
+				}
+				else if (BX_ENABLED(BX_PLATFORM_LINUX) )
+				{
+					score += RendererType::Vulkan     == renderer ? 50 : 0;
+					score += RendererType::OpenGL     == renderer ? 40 : 0;
+					score += RendererType::OpenGLES   == renderer ? 30 : 0;
+					score += RendererType::Direct3D12 == renderer ? 20 : 0;
+					score += RendererType::Direct3D11 == renderer ? 10 : 0;
+				}
+				else if (BX_ENABLED(BX_PLATFORM_OSX) )
+				{
+					score += RendererType::Metal    == renderer ? 20 : 0;
+					score += RendererType::Vulkan   == renderer ? 10 : 0;
+				}
+				else if (BX_ENABLED(BX_PLATFORM_IOS) || BX_ENABLED(BX_PLATFORM_VISIONOS))
+				{
+					score += RendererType::Metal    == renderer ? 20 : 0;
+				}
+				else if (BX_ENABLED(0
+					 ||  BX_PLATFORM_ANDROID
+					 ||  BX_PLATFORM_EMSCRIPTEN
+					 ||  BX_PLATFORM_RPI
+					 ) )
+				{
+					score += RendererType::OpenGLES == renderer ? 20 : 0;
+				}
+				else if (BX_ENABLED(BX_PLATFORM_PS4) )
+				{
+					score += RendererType::Gnm      == renderer ? 20 : 0;
+				}
+				else if (BX_ENABLED(0
+					 ||  BX_PLATFORM_XBOXONE
+					 ||  BX_PLATFORM_WINRT
+					 ) )
+				{
+					score += RendererType::Direct3D12 == renderer ? 20 : 0;
+					score += RendererType::Direct3D11 == renderer ? 10 : 0;
+				}
+
+				scores[numScores++] = (score<<8) | uint8_t(renderer);
+			}
+		}
+
+		bx::quickSort(scores, numScores, bx::compareDescending<int32_t>);
+
+		RendererContextI* renderCtx = NULL;
+		for (uint32_t ii = 0; ii < numScores; ++ii)
+		{
+			RendererType::Enum renderer = RendererType::Enum(scores[ii] & 0xff);
+			renderCtx = s_rendererCreator[renderer].createFn(_init);
+			if (NULL != renderCtx)
+			{
+				break;
+			}
+
+			s_rendererCreator[renderer].supported = false;
+		}
+
+		return renderCtx;
+	}
+
+	void rendererDestroy(RendererContextI* _renderCtx)
+	{
+		if (NULL != _renderCtx)
+		{
+			s_rendererCreator[_renderCtx->getRendererType()].destroyFn();
+		}
+	}
+
+	RenderWorkerPool::RenderWorkerPool()
+		: m_renderCtx(NULL)
+		, m_numThreads(0)
+		, m_numJobs(0)
+		, m_numStarted(0)
+		, m_numDoneWaits(0)
+		, m_exit(false)
+	{
+		bx::memSet(m_shaderJob, 0, sizeof(m_shaderJob) );
+	}
+
+	void RenderWorkerPool::init(RendererContextI* _renderCtx, uint32_t _numThreads)
+	{
+		m_renderCtx  = _renderCtx;
+		m_numThreads = BX_ENABLED(BGFX_CONFIG_MULTITHREADED)
+			? bx::min<uint32_t>(_numThreads, BX_COUNTOF(m_thread) )
+			: 0
+			;
+		m_exit = false;
+
+		for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+		{
+			m_thread[ii].init(threadFunc, this, 0, "bgfx - render worker thread");
+		}
+	}
+
+	void RenderWorkerPool::shutdown()
+	{
+		waitAll();
+
+		{
+			bx::MutexScope lock(m_mutex);
+			m_exit = true;
+		}
+
+		for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+		{
+			m_workSem.post();
+		}
+
+		for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+		{
+			m_thread[ii].shutdown();
+		}
+
+		m_numThreads = 0;
+		m_renderCtx  = NULL;
+	}
+
+	void RenderWorkerPool::createShader(ShaderHandle _handle, const Memory* _mem)
+	{
+		// Shader handle can be recreated only after DestroyShader, which waits
+		// for previous job with the same handle.
+		BX_ASSERT(0 == m_shaderJob[_handle.idx], "Shader %d is already queued.", _handle.idx);
+		m_shaderJob[_handle.idx] = uint16_t(m_numJobs+1);
+		push(CommandBuffer::CreateShader, _handle.idx, _mem);
+	}
+
+	void RenderWorkerPool::wait(ShaderHandle _handle)
+	{
+		if (isValid(_handle)
+		&&  0 != m_shaderJob[_handle.idx])
+		{
+			wait(m_shaderJob[_handle.idx]-1);
+		}
+	}
+
+	void RenderWorkerPool::waitAll()
+	{
+		if (0 == m_numJobs)
+		{
+			return;
+		}
+
+		BGFX_PROFILER_SCOPE("bgfx/Render worker wait", 0xff2040ff);
+
+		// Every job posts done semaphore exactly once. Consuming all posts that
+		// were not consumed by waiting on individual jobs means all jobs are
+		// done, and no post is left over for the next batch.
+		for (; m_numDoneWaits < m_numJobs; ++m_numDoneWaits)
+		{
+			m_doneSem.wait();
+		}
+
+		uint32_t numJobs;
+
+		{
+			bx::MutexScope lock(m_mutex);
+			numJobs        = m_numJobs;
+			m_numJobs      = 0;
+			m_numStarted   = 0;
+			m_numDoneWaits = 0;
+		}
+
+		// Memory is released on render thread, release callback provided by user
+		// is not required to be thread safe.
+		for (uint32_t ii = 0; ii < numJobs; ++ii)
+		{
+			Job& job = m_job[ii];
+			release(job.m_mem);
+			job.m_mem = NULL;
+
+			if (CommandBuffer::CreateShader == job.m_command)
+			{
+				m_shaderJob[job.m_handle] = 0;
+			}
+		}
+	}
+
+	void RenderWorkerPool::push(CommandBuffer::Enum _command, uint16_t _handle, const Memory* _mem)
+	{
+		Job& job = m_job[m_numJobs];
+		job.m_mem     = _mem;
+		job.m_handle  = _handle;
+		job.m_command = uint8_t(_command);
+		job.m_done    = false;
+
+		{
+			bx::MutexScope lock(m_mutex);
+			++m_numJobs;
+		}
+
+		m_workSem.post();
+
+		if (BX_COUNTOF(m_job) == m_numJobs)
+		{
+			waitAll();
+		}
+	}
+
+	void RenderWorkerPool::wait(uint32_t _jobIdx)
 	{
-		int32_t scores[RendererType::Count];
-		uint32_t numScores = 0;
+		BGFX_PROFILER_SCOPE("bgfx/Render worker wait", 0xff2040ff);
 
-		for (uint32_t ii = 0; ii < RendererType::Count; ++ii)
+		for (;;)
 		{
-			RendererType::Enum renderer = RendererType::Enum(ii);
-			if (s_rendererCreator[ii].supported)
 			{
-				int32_t score = 0;
-				if (_init.type == renderer)
+				bx::MutexScope lock(m_mutex);
+				if (m_job[_jobIdx].m_done)
 				{
-					score += 1000;
+					break;
 				}
+			}
 
-				score += RendererType::Noop != renderer ? 1 : 0;
+			m_doneSem.wait();
+			++m_numDoneWaits;
+		}
+	}
 
-				if (BX_ENABLED(BX_PLATFORM_WINDOWS) )
-				{
-					if (windowsVersionIs(Condition::GreaterEqual, 0x0602) )
-					{
-						score += RendererType::Direct3D11 == renderer ? 20 : 0;
-						score += RendererType::Direct3D12 == renderer ? 10 : 0;
-					}
-					else if (windowsVersionIs(Condition::GreaterEqual, 0x0601) )
-					{
-						score += RendererType::Direct3D11 == renderer ?   20 : 0;
-						score += RendererType::Direct3D12 == renderer ? -100 : 0;
-					}
-					else
-					{
-						score += RendererType::Direct3D12 == renderer ? -100 : 0;
-					}
-				}
-				else if (BX_ENABLED(BX_PLATFORM_LINUX) )
-				{
-					score += RendererType::Vulkan     == renderer ? 50 : 0;
-					score += RendererType::OpenGL     == renderer ? 40 : 0;
-					score += RendererType::OpenGLES   == renderer ? 30 : 0;
-					score += RendererType::Direct3D12 == renderer ? 20 : 0;
-					score += RendererType::Direct3D11 == renderer ? 10 : 0;
-				}
-				else if (BX_ENABLED(BX_PLATFORM_OSX) )
-				{
-					score += RendererType::Metal    == renderer ? 20 : 0;
-					score += RendererType::Vulkan   == renderer ? 10 : 0;
-				}
-				else if (BX_ENABLED(BX_PLATFORM_IOS) || BX_ENABLED(BX_PLATFORM_VISIONOS))
-				{
-					score += RendererType::Metal    == renderer ? 20 : 0;
-				}
-				else if (BX_ENABLED(0
-					 ||  BX_PLATFORM_ANDROID
-					 ||  BX_PLATFORM_EMSCRIPTEN
-					 ||  BX_PLATFORM_RPI
-					 ) )
-				{
-					score += RendererType::OpenGLES == renderer ? 20 : 0;
-				}
-				else if (BX_ENABLED(BX_PLATFORM_PS4) )
+	int32_t RenderWorkerPool::threadFunc(bx::Thread* /*_thread*/, void* _userData)
+	{
+		RenderWorkerPool* pool = static_cast<RenderWorkerPool*>(_userData);
+		return pool->worker();
+	}
+
+	int32_t RenderWorkerPool::worker()
+	{
+		for (;;)
+		{
+			m_workSem.wait();
+
+			Job* job;
+
+			{
+				bx::MutexScope lock(m_mutex);
+
+				if (m_exit)
 				{
-					score += RendererType::Gnm      == renderer ? 20 : 0;
+					break;
 				}
-				else if (BX_ENABLED(0
-					 ||  BX_PLATFORM_XBOXONE
-					 ||  BX_PLATFORM_WINRT
-					 ) )
+
+				job = &m_job[m_numStarted];
+				++m_numStarted;
+			}
+
+			switch (job->m_command)
+			{
+			case CommandBuffer::CreateShader:
 				{
-					score += RendererType::Direct3D12 == renderer ? 20 : 0;
-					score += RendererType::Direct3D11 == renderer ? 10 : 0;
+					BGFX_PROFILER_SCOPE("CreateShader", 0xff2040ff);
+
+					const ShaderHandle handle = { job->m_handle };
+					m_renderCtx->createShader(handle, job->m_mem);
 				}
+				break;
 
-				scores[numScores++] = (score<<8) | uint8_t(renderer);
+			default:
+				BX_ASSERT(false, "Invalid render worker command: %d", job->m_command);
+				break;
 			}
-		}
-
-		bx::quickSort(scores, numScores, bx::compareDescending<int32_t>);
 
-		RendererContextI* renderCtx = NULL;
-		for (uint32_t ii = 0; ii < numScores; ++ii)
-		{
-			RendererType::Enum renderer = RendererType::Enum(scores[ii] & 0xff);
-			renderCtx = s_rendererCreator[renderer].createFn(_init);
-			if (NULL != renderCtx)
 			{
-				break;
+				bx::MutexScope lock(m_mutex);
+				job->m_done = true;
 			}
 
-			s_rendererCreator[renderer].supported = false;
+			m_doneSem.post();
 		}
 
-		return renderCtx;
-	}
-
-	void rendererDestroy(RendererContextI* _renderCtx)
-	{
-		if (NULL != _renderCtx)
-		{
-			s_rendererCreator[_renderCtx->getRendererType()].destroyFn();
-		}
+		return bx::kExitSuccess;
 	}
 
 	void Context::rendererExecCommands(CommandBuffer& _cmdbuf)
@@ -2835,6 +3823,8 @@ namespace bgfx
 							);
 						return;
 					}
+
+					m_renderWorkerPool.init(m_renderCtx, m_singleThreaded ? 0 : BGFX_CONFIG_RENDER_WORKER_THREADS);
 				}
 				break;
 			}
@@ -2858,6 +3848,7 @@ namespace bgfx
 				{
 					BX_ASSERT(!m_rendererInitialized && !m_exit, "This shouldn't happen! Bad synchronization?");
 
+					m_renderWorkerPool.shutdown();
 					rendererDestroy(m_renderCtx);
 					m_renderCtx = NULL;
 
@@ -3067,9 +4058,17 @@ namespace bgfx
 					const Memory* mem;
 					_cmdbuf.read(mem);
 
-					m_renderCtx->createShader(handle, mem);
+					if (m_renderWorkerPool.isEnabled(CommandBuffer::CreateShader) )
+					{
+						// Memory is released once job is completed.
+						m_renderWorkerPool.createShader(handle, mem);
+					}
+					else
+					{
+						m_renderCtx->createShader(handle, mem);
 
-					release(mem);
+						release(mem);
+					}
 				}
 				break;
 
@@ -3080,6 +4079,7 @@ namespace bgfx
 					ShaderHandle handle;
 					_cmdbuf.read(handle);
 
+					m_renderWorkerPool.wait(handle);
 					m_renderCtx->destroyShader(handle);
 				}
 				break;
@@ -3097,6 +4097,8 @@ namespace bgfx
 					ShaderHandle fsh;
 					_cmdbuf.read(fsh);
 
+					m_renderWorkerPool.wait(vsh);
+					m_renderWorkerPool.wait(fsh);
 					m_renderCtx->createProgram(handle, vsh, fsh);
 				}
 				break;
@@ -3312,6 +4314,8 @@ namespace bgfx
 
 					const char* name = (const char*)_cmdbuf.skip(len);
 
+					// Shader creation reads uniform registry.
+					m_renderWorkerPool.waitAll();
 					m_renderCtx->createUniform(handle, type, num, name);
 				}
 				break;
@@ -3323,6 +4327,7 @@ namespace bgfx
 					UniformHandle handle;
 					_cmdbuf.read(handle);
 
+					m_renderWorkerPool.waitAll();
 					m_renderCtx->destroyUniform(handle);
 				}
 				break;
@@ -3366,6 +4371,11 @@ namespace bgfx
 
 					const char* name = (const char*)_cmdbuf.skip(len);
 
+					if (Handle::Shader == handle.getType() )
+					{
+						m_renderWorkerPool.wait(handle.to<ShaderHandle>() );
+					}
+
 					m_renderCtx->setName(handle, name, len-1);
 				}
 				break;
@@ -3376,6 +4386,8 @@ namespace bgfx
 			}
 		} while (!end);
 
+		m_renderWorkerPool.waitAll();
+
 		flushTextureUpdateBatch(_cmdbuf);
 	}
 
@@ -3660,16 +4672,26 @@ namespace bgfx
 		BGFX_ENCODER(setMarker(bx::StringView(_name, _len) ) );
 	}
 
+	void Encoder::beginGpuTimer(const char* _name, int32_t _len)
+	{
+		BGFX_ENCODER(beginGpuTimer(bx::StringView(_name, _len) ) );
+	}
+
+	void Encoder::endGpuTimer()
+	{
+		BGFX_ENCODER(endGpuTimer() );
+	}
+
 	void Encoder::setState(uint64_t _state, uint32_t _rgba)
 	{
 		BX_ASSERT(0 == (_state&BGFX_STATE_RESERVED_MASK), "Do not set state reserved flags!");
 		BGFX_ENCODER(setState(_state, _rgba) );
 	}
 
-	void Encoder::setCondition(OcclusionQueryHandle _handle, bool _visible)
+	void Encoder::setCondition(OcclusionQueryHandle _handle, bool _visible, bool _gpu)
 	{
 		BGFX_CHECK_CAPS(BGFX_CAPS_OCCLUSION_QUERY, "Occlusion query is not supported!");
-		BGFX_ENCODER(setCondition(_handle, _visible) );
+		BGFX_ENCODER(setCondition(_handle, _visible, _gpu && 0 != (g_caps.supported & BGFX_CAPS_CONDITIONAL_RENDER) ) );
 	}
 
 	void Encoder::setStencil(uint32_t _fstencil, uint32_t _bstencil)
@@ -3824,18 +4846,87 @@ namespace bgfx
 	{
 		BGFX_CHECK_HANDLE("setInstanceDataBuffer", s_ctx->m_vertexBufferHandle, _handle);
 		const VertexBuffer& vb = s_ctx->m_vertexBuffers[_handle.idx];
-		BGFX_ENCODER(setInstanceDataBuffer(_handle, _startVertex, _num, vb.m_stride) );
+		uint32_t offset;
+		const uint32_t num = calcInstanceDataRange(offset, 0, vb.m_size, vb.m_stride, _startVertex, _num);
+		BGFX_ENCODER(setInstanceDataBuffer(_handle, offset, num, vb.m_stride) );
 	}
 
 	void Encoder::setInstanceDataBuffer(DynamicVertexBufferHandle _handle, uint32_t _startVertex, uint32_t _num)
 	{
 		BGFX_CHECK_HANDLE("setInstanceDataBuffer", s_ctx->m_dynamicVertexBufferHandle, _handle);
 		const DynamicVertexBuffer& dvb = s_ctx->m_dynamicVertexBuffers[_handle.idx];
-		BGFX_ENCODER(setInstanceDataBuffer(dvb.m_handle
-			, dvb.m_startVertex + _startVertex
-			, _num
+		uint32_t offset;
+		const uint32_t num = calcInstanceDataRange(offset
+			, dvb.m_startVertex*dvb.m_stride
+			, dvb.m_size
 			, dvb.m_stride
-			) );
+			, _startVertex
+			, _num
+			);
+		BGFX_ENCODER(setInstanceDataBuffer(dvb.m_handle, offset, num, dvb.m_stride) );
+	}
+
+	void Encoder::setInstanceDataBuffer(VertexBufferHandle _handle, uint32_t _startVertex, uint32_t _num, VertexLayoutHandle _layoutHandle)
+	{
+		BGFX_CHECK_CAPS(BGFX_CAPS_INSTANCING_LAYOUT, "Instance data with vertex layout is not supported!");
+		BGFX_CHECK_HANDLE("setInstanceDataBuffer", s_ctx->m_vertexBufferHandle, _handle);
+		BGFX_CHECK_HANDLE_INVALID_OK("setInstanceDataBuffer", s_ctx->m_layoutHandle, _layoutHandle);
+		const VertexBuffer& vb = s_ctx->m_vertexBuffers[_handle.idx];
+		const VertexLayoutHandle layoutHandle = isValid(_layoutHandle)
+			? _layoutHandle
+			: s_ctx->m_vertexLayoutRef.m_vertexBufferRef[_handle.idx]
+			;
+
+		// Instances are layout stride apart, buffer stride is only used to
+		// address buffer's own vertices.
+		const uint16_t stride = s_ctx->m_vertexLayoutRef.m_stride[layoutHandle.idx];
+		uint32_t offset;
+		const uint32_t num = calcInstanceDataRange(offset, 0, vb.m_size, stride, _startVertex, _num);
+		BGFX_ENCODER(setInstanceDataBuffer(_handle, offset, num, stride, layoutHandle) );
+	}
+
+	void Encoder::setInstanceDataBuffer(DynamicVertexBufferHandle _handle, uint32_t _startVertex, uint32_t _num, VertexLayoutHandle _layoutHandle)
+	{
+		BGFX_CHECK_CAPS(BGFX_CAPS_INSTANCING_LAYOUT, "Instance data with vertex layout is not supported!");
+		BGFX_CHECK_HANDLE("setInstanceDataBuffer", s_ctx->m_dynamicVertexBufferHandle, _handle);
+		BGFX_CHECK_HANDLE_INVALID_OK("setInstanceDataBuffer", s_ctx->m_layoutHandle, _layoutHandle);
+		const DynamicVertexBuffer& dvb = s_ctx->m_dynamicVertexBuffers[_handle.idx];
+		const VertexLayoutHandle layoutHandle = isValid(_layoutHandle)
+			? _layoutHandle
+			: dvb.m_layoutHandle
+			;
+		const uint16_t stride = s_ctx->m_vertexLayoutRef.m_stride[layoutHandle.idx];
+		uint32_t offset;
+		const uint32_t num = calcInstanceDataRange(offset
+			, dvb.m_startVertex*dvb.m_stride
+			, dvb.m_size
+			, stride
+			, _startVertex
+			, _num
+			);
+		BGFX_ENCODER(setInstanceDataBuffer(dvb.m_handle, offset, num, stride, layoutHandle) );
+	}
+
+	void Encoder::setInstanceDataBuffer(const TransientVertexBuffer* _tvb, uint32_t _start, uint32_t _num, VertexLayoutHandle _layoutHandle)
+	{
+		BGFX_CHECK_CAPS(BGFX_CAPS_INSTANCING_LAYOUT, "Instance data with vertex layout is not supported!");
+		BX_ASSERT(NULL != _tvb, "_tvb can't be NULL");
+		BGFX_CHECK_HANDLE("setInstanceDataBuffer", s_ctx->m_vertexBufferHandle, _tvb->handle);
+		BGFX_CHECK_HANDLE_INVALID_OK("setInstanceDataBuffer", s_ctx->m_layoutHandle, _layoutHandle);
+		const VertexLayoutHandle layoutHandle = isValid(_layoutHandle)
+			? _layoutHandle
+			: _tvb->layoutHandle
+			;
+		const uint16_t stride = s_ctx->m_vertexLayoutRef.m_stride[layoutHandle.idx];
+		uint32_t offset;
+		const uint32_t num = calcInstanceDataRange(offset
+			, _tvb->startVertex*_tvb->stride
+			, _tvb->size
+			, stride
+			, _start
+			, _num
+			);
+		BGFX_ENCODER(setInstanceDataBuffer(_tvb->handle, offset, num, stride, layoutHandle) );
 	}
 
 	void Encoder::setInstanceCount(uint32_t _numInstances)
@@ -3886,6 +4977,38 @@ namespace bgfx
 		BGFX_ENCODER(submit(_id, _program, _occlusionQuery, _depth, _flags) );
 	}
 
+	void Encoder::submit(ViewId _id, const DrawDesc* _draws, uint32_t _num, const DrawUniform* _uniforms, const DrawTexture* _textures)
+	{
+		BX_ASSERT(NULL != _draws || 0 == _num, "Draw descriptors must not be NULL!");
+
+		if (BX_ENABLED(BGFX_CONFIG_DEBUG) )
+		{
+			for (uint32_t ii = 0; ii < _num; ++ii)
+			{
+				const DrawDesc& draw = _draws[ii];
+				BGFX_CHECK_HANDLE_INVALID_OK("submit", s_ctx->m_programHandle, draw.program);
+				BGFX_CHECK_HANDLE_INVALID_OK("submit", s_ctx->m_vertexBufferHandle, draw.vertexBuffer);
+				BGFX_CHECK_HANDLE_INVALID_OK("submit", s_ctx->m_layoutHandle, draw.layout);
+				BGFX_CHECK_HANDLE_INVALID_OK("submit", s_ctx->m_indexBufferHandle, draw.indexBuffer);
+
+				for (uint32_t jj = 0; jj < draw.numUniforms; ++jj)
+				{
+					BGFX_CHECK_HANDLE("submit", s_ctx->m_uniformHandle, _uniforms[draw.firstUniform + jj].handle);
+				}
+
+				for (uint32_t jj = 0; jj < draw.numTextures; ++jj)
+				{
+					const DrawTexture& texture = _textures[draw.firstTexture + jj];
+					BGFX_CHECK_HANDLE_INVALID_OK("submit", s_ctx->m_uniformHandle, texture.sampler);
+					BGFX_CHECK_HANDLE_INVALID_OK("submit", s_ctx->m_textureHandle, texture.handle);
+					BX_ASSERT(texture.stage < g_caps.limits.maxTextureSamplers, "Invalid stage %d (max %d).", texture.stage, g_caps.limits.maxTextureSamplers);
+				}
+			}
+		}
+
+		BGFX_ENCODER(submit(_id, _draws, _num, _uniforms, _textures) );
+	}
+
 	void Encoder::submit(ViewId _id, ProgramHandle _program, IndirectBufferHandle _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags)
 	{
 		BGFX_CHECK_HANDLE_INVALID_OK("submit", s_ctx->m_programHandle, _program);
@@ -4102,6 +5225,113 @@ namespace bgfx
 		void* userData;
 	};
 
+	static void frameMemoryRelease(void* /*_ptr*/, void* /*_userData*/)
+	{
+	}
+
+	void FrameMemory::create(uint32_t _size)
+	{
+		m_data   = 0 < _size ? (uint8_t*)bx::alignedAlloc(g_allocator, _size, 16) : NULL;
+		m_size   = _size;
+		m_offset = 0;
+	}
+
+	void FrameMemory::destroy()
+	{
+		if (NULL != m_data)
+		{
+			bx::alignedFree(g_allocator, m_data, 16);
+			m_data = NULL;
+		}
+
+		m_size = 0;
+	}
+
+	void FrameMemory::reset()
+	{
+		// Offset keeps counting past the end of arena, requests that didn't fit were served
+		// from heap. Grow arena so that the same demand fits next time.
+		m_used = m_offset;
+		m_max  = bx::max(m_max, m_used);
+
+		if (m_used > m_size)
+		{
+			constexpr uint32_t kGranularity = 64<<10;
+
+			destroy();
+			create(m_used > UINT32_MAX - kGranularity
+				? m_used
+				: bx::alignUp(m_used, kGranularity)
+				);
+		}
+
+		m_offset = 0;
+	}
+
+	const Memory* FrameMemory::alloc(uint32_t _size)
+	{
+		constexpr uint32_t kMaxSize = UINT32_MAX - uint32_t(sizeof(MemoryRef) ) - 15;
+
+		if (_size > kMaxSize)
+		{
+			return NULL;
+		}
+
+		const uint32_t size = bx::alignUp(uint32_t(sizeof(MemoryRef) ) + _size, 16);
+
+		// Offset saturates instead of wrapping around, wrapped offset would hand out
+		// memory that is already in use.
+		uint32_t offset = m_offset;
+		for (;;)
+		{
+			const uint32_t next = offset > UINT32_MAX - size ? UINT32_MAX : offset + size;
+			const uint32_t prev = bx::atomicCompareAndSwap<uint32_t>(&m_offset, offset, next);
+
+			if (prev == offset)
+			{
+				break;
+			}
+
+			offset = prev;
+		}
+
+		if (size   > m_size
+		||  offset > m_size - size)
+		{
+			return NULL;
+		}
+
+		// Frame memory is tagged as reference with no-op release function, it's reclaimed
+		// all at once when frame is reused.
+		MemoryRef* memRef = (MemoryRef*)&m_data[offset];
+		memRef->mem.size  = _size;
+		memRef->mem.data  = (uint8_t*)memRef + sizeof(MemoryRef);
+		memRef->releaseFn = frameMemoryRelease;
+		memRef->userData  = NULL;
+		return &memRef->mem;
+	}
+
+	const Memory* allocFrame(uint32_t _size)
+	{
+		BX_ASSERT(0 < _size, "Invalid memory operation. _size is 0.");
+		const Memory* mem = s_ctx->m_submit->m_frameMemory.alloc(_size);
+
+		if (NULL == mem)
+		{
+			mem = alloc(_size);
+		}
+
+		return mem;
+	}
+
+	const Memory* copyFrame(const void* _data, uint32_t _size)
+	{
+		BX_ASSERT(0 < _size, "Invalid memory operation. _size is 0.");
+		const Memory* mem = allocFrame(_size);
+		bx::memCopy(mem->data, _data, _size);
+		return mem;
+	}
+
 	const Memory* makeRef(const void* _data, uint32_t _size, ReleaseFn _releaseFn, void* _userData)
 	{
 		MemoryRef* memRef = (MemoryRef*)bx::alloc(g_allocator, sizeof(MemoryRef) );
@@ -4124,6 +5354,11 @@ namespace bgfx
 		if (isMemoryRef(mem) )
 		{
 			MemoryRef* memRef = reinterpret_cast<MemoryRef*>(mem);
+			if (frameMemoryRelease == memRef->releaseFn)
+			{
+				return;
+			}
+
 			if (NULL != memRef->releaseFn)
 			{
 				memRef->releaseFn(mem->data, memRef->userData);
@@ -5267,6 +6502,17 @@ namespace bgfx
 		s_ctx->setViewTransform(_id, _view, _proj);
 	}
 
+	void setViewDynamicResolution(ViewId _id, bool _enabled)
+	{
+		BX_ASSERT(checkView(_id), "Invalid view id: %d", _id);
+		s_ctx->setViewDynamicResolution(_id, _enabled);
+	}
+
+	void setDynamicResolution(float _targetMs, float _minScale, float _maxScale)
+	{
+		s_ctx->setDynamicResolution(_targetMs, _minScale, _maxScale);
+	}
+
 	void setViewOrder(ViewId _id, uint16_t _num, const ViewId* _order)
 	{
 		BX_ASSERT(checkView(_id), "Invalid view id: %d", _id);
@@ -5290,16 +6536,28 @@ namespace bgfx
 		s_ctx->m_encoder0->setMarker(_name, _len);
 	}
 
+	void beginGpuTimer(const char* _name, int32_t _len)
+	{
+		BGFX_CHECK_ENCODER0();
+		s_ctx->m_encoder0->beginGpuTimer(_name, _len);
+	}
+
+	void endGpuTimer()
+	{
+		BGFX_CHECK_ENCODER0();
+		s_ctx->m_encoder0->endGpuTimer();
+	}
+
 	void setState(uint64_t _state, uint32_t _rgba)
 	{
 		BGFX_CHECK_ENCODER0();
 		s_ctx->m_encoder0->setState(_state, _rgba);
 	}
 
-	void setCondition(OcclusionQueryHandle _handle, bool _visible)
+	void setCondition(OcclusionQueryHandle _handle, bool _visible, bool _gpu)
 	{
 		BGFX_CHECK_ENCODER0();
-		s_ctx->m_encoder0->setCondition(_handle, _visible);
+		s_ctx->m_encoder0->setCondition(_handle, _visible, _gpu);
 	}
 
 	void setStencil(uint32_t _fstencil, uint32_t _bstencil)
@@ -5464,6 +6722,24 @@ namespace bgfx
 		s_ctx->m_encoder0->setInstanceDataBuffer(_handle, _startVertex, _num);
 	}
 
+	void setInstanceDataBuffer(VertexBufferHandle _handle, uint32_t _startVertex, uint32_t _num, VertexLayoutHandle _layoutHandle)
+	{
+		BGFX_CHECK_ENCODER0();
+		s_ctx->m_encoder0->setInstanceDataBuffer(_handle, _startVertex, _num, _layoutHandle);
+	}
+
+	void setInstanceDataBuffer(DynamicVertexBufferHandle _handle, uint32_t _startVertex, uint32_t _num, VertexLayoutHandle _layoutHandle)
+	{
+		BGFX_CHECK_ENCODER0();
+		s_ctx->m_encoder0->setInstanceDataBuffer(_handle, _startVertex, _num, _layoutHandle);
+	}
+
+	void setInstanceDataBuffer(const TransientVertexBuffer* _tvb, uint32_t _start, uint32_t _num, VertexLayoutHandle _layoutHandle)
+	{
+		BGFX_CHECK_ENCODER0();
+		s_ctx->m_encoder0->setInstanceDataBuffer(_tvb, _start, _num, _layoutHandle);
+	}
+
 	void setInstanceCount(uint32_t _numInstances)
 	{
 		BGFX_CHECK_ENCODER0();
@@ -5494,6 +6770,12 @@ namespace bgfx
 		s_ctx->m_encoder0->submit(_id, _program, _occlusionQuery, _depth, _flags);
 	}
 
+	void submit(ViewId _id, const DrawDesc* _draws, uint32_t _num, const DrawUniform* _uniforms, const DrawTexture* _textures)
+	{
+		BGFX_CHECK_ENCODER0();
+		s_ctx->m_encoder0->submit(_id, _draws, _num, _uniforms, _textures);
+	}
+
 	void submit(ViewId _id, ProgramHandle _program, IndirectBufferHandle _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags)
 	{
 		BGFX_CHECK_ENCODER0();
@@ -5793,6 +7075,8 @@ BX_STATIC_ASSERT( (0
 	| BGFX_CAPS_PRIMITIVE_ID
 	| BGFX_CAPS_VIEWPORT_LAYER_ARRAY
 	| BGFX_CAPS_DRAW_INDIRECT_COUNT
+	| BGFX_CAPS_CONDITIONAL_RENDER
+	| BGFX_CAPS_INSTANCING_LAYOUT
 	) == (0
 	^ BGFX_CAPS_ALPHA_TO_COVERAGE
 	^ BGFX_CAPS_BLEND_INDEPENDENT
@@ -5821,6 +7105,8 @@ BX_STATIC_ASSERT( (0
 	^ BGFX_CAPS_PRIMITIVE_ID
 	^ BGFX_CAPS_VIEWPORT_LAYER_ARRAY
 	^ BGFX_CAPS_DRAW_INDIRECT_COUNT
+	^ BGFX_CAPS_CONDITIONAL_RENDER
+	^ BGFX_CAPS_INSTANCING_LAYOUT
 	) );
 
 #undef FLAGS_MASK_TEST
@@ -184,6 +184,16 @@ BGFX_C_API const bgfx_memory_t* bgfx_copy(const void* _data, uint32_t _size)
 	return (const bgfx_memory_t*)bgfx::copy(_data, _size);
 }
 
+BGFX_C_API const bgfx_memory_t* bgfx_alloc_frame(uint32_t _size)
+{
+	return (const bgfx_memory_t*)bgfx::allocFrame(_size);
+}
+
+BGFX_C_API const bgfx_memory_t* bgfx_copy_frame(const void* _data, uint32_t _size)
+{
+	return (const bgfx_memory_t*)bgfx::copyFrame(_data, _size);
+}
+
 BGFX_C_API const bgfx_memory_t* bgfx_make_ref(const void* _data, uint32_t _size)
 {
 	return (const bgfx_memory_t*)bgfx::makeRef(_data, _size);
@@ -671,6 +681,16 @@ BGFX_C_API void bgfx_set_view_transform(bgfx_view_id_t _id, const void* _view, c
 	bgfx::setViewTransform((bgfx::ViewId)_id, _view, _proj);
 }
 
+BGFX_C_API void bgfx_set_view_dynamic_resolution(bgfx_view_id_t _id, bool _enabled)
+{
+	bgfx::setViewDynamicResolution((bgfx::ViewId)_id, _enabled);
+}
+
+BGFX_C_API void bgfx_set_dynamic_resolution(float _targetMs, float _minScale, float _maxScale)
+{
+	bgfx::setDynamicResolution(_targetMs, _minScale, _maxScale);
+}
+
 BGFX_C_API void bgfx_set_view_order(bgfx_view_id_t _id, uint16_t _num, const bgfx_view_id_t* _order)
 {
 	bgfx::setViewOrder((bgfx::ViewId)_id, _num, (const bgfx::ViewId*)_order);
@@ -697,17 +717,29 @@ BGFX_C_API void bgfx_encoder_set_marker(bgfx_encoder_t* _this, const char* _name
 	This->setMarker(_name, _len);
 }
 
+BGFX_C_API void bgfx_encoder_begin_gpu_timer(bgfx_encoder_t* _this, const char* _name, int32_t _len)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	This->beginGpuTimer(_name, _len);
+}
+
+BGFX_C_API void bgfx_encoder_end_gpu_timer(bgfx_encoder_t* _this)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	This->endGpuTimer();
+}
+
 BGFX_C_API void bgfx_encoder_set_state(bgfx_encoder_t* _this, uint64_t _state, uint32_t _rgba)
 {
 	bgfx::Encoder* This = (bgfx::Encoder*)_this;
 	This->setState(_state, _rgba);
 }
 
-BGFX_C_API void bgfx_encoder_set_condition(bgfx_encoder_t* _this, bgfx_occlusion_query_handle_t _handle, bool _visible)
+BGFX_C_API void bgfx_encoder_set_condition(bgfx_encoder_t* _this, bgfx_occlusion_query_handle_t _handle, bool _visible, bool _gpu)
 {
 	bgfx::Encoder* This = (bgfx::Encoder*)_this;
 	union { bgfx_occlusion_query_handle_t c; bgfx::OcclusionQueryHandle cpp; } handle = { _handle };
-	This->setCondition(handle.cpp, _visible);
+	This->setCondition(handle.cpp, _visible, _gpu);
 }
 
 BGFX_C_API void bgfx_encoder_set_stencil(bgfx_encoder_t* _this, uint32_t _fstencil, uint32_t _bstencil)
@@ -842,6 +874,29 @@ BGFX_C_API void bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer(bgfx_e
 	This->setInstanceDataBuffer(handle.cpp, _startVertex, _num);
 }
 
+BGFX_C_API void bgfx_encoder_set_instance_data_from_vertex_buffer_with_layout(bgfx_encoder_t* _this, bgfx_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	union { bgfx_vertex_buffer_handle_t c; bgfx::VertexBufferHandle cpp; } handle = { _handle };
+	union { bgfx_vertex_layout_handle_t c; bgfx::VertexLayoutHandle cpp; } layoutHandle = { _layoutHandle };
+	This->setInstanceDataBuffer(handle.cpp, _startVertex, _num, layoutHandle.cpp);
+}
+
+BGFX_C_API void bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout(bgfx_encoder_t* _this, bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	union { bgfx_dynamic_vertex_buffer_handle_t c; bgfx::DynamicVertexBufferHandle cpp; } handle = { _handle };
+	union { bgfx_vertex_layout_handle_t c; bgfx::VertexLayoutHandle cpp; } layoutHandle = { _layoutHandle };
+	This->setInstanceDataBuffer(handle.cpp, _startVertex, _num, layoutHandle.cpp);
+}
+
+BGFX_C_API void bgfx_encoder_set_instance_data_from_transient_vertex_buffer(bgfx_encoder_t* _this, const bgfx_transient_vertex_buffer_t* _tvb, uint32_t _start, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	union { bgfx_vertex_layout_handle_t c; bgfx::VertexLayoutHandle cpp; } layoutHandle = { _layoutHandle };
+	This->setInstanceDataBuffer((const bgfx::TransientVertexBuffer*)_tvb, _start, _num, layoutHandle.cpp);
+}
+
 BGFX_C_API void bgfx_encoder_set_instance_count(bgfx_encoder_t* _this, uint32_t _numInstances)
 {
 	bgfx::Encoder* This = (bgfx::Encoder*)_this;
@@ -877,6 +932,12 @@ BGFX_C_API void bgfx_encoder_submit_occlusion_query(bgfx_encoder_t* _this, bgfx_
 	This->submit((bgfx::ViewId)_id, program.cpp, occlusionQuery.cpp, _depth, _flags);
 }
 
+BGFX_C_API void bgfx_encoder_submit_draws(bgfx_encoder_t* _this, bgfx_view_id_t _id, const bgfx_draw_desc_t* _draws, uint32_t _num, const bgfx_draw_uniform_t* _uniforms, const bgfx_draw_texture_t* _textures)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	This->submit((bgfx::ViewId)_id, (const bgfx::DrawDesc*)_draws, _num, (const bgfx::DrawUniform*)_uniforms, (const bgfx::DrawTexture*)_textures);
+}
+
 BGFX_C_API void bgfx_encoder_submit_indirect(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags)
 {
 	bgfx::Encoder* This = (bgfx::Encoder*)_this;
@@ -1004,15 +1065,25 @@ BGFX_C_API void bgfx_set_marker(const char* _name, int32_t _len)
 	bgfx::setMarker(_name, _len);
 }
 
+BGFX_C_API void bgfx_begin_gpu_timer(const char* _name, int32_t _len)
+{
+	bgfx::beginGpuTimer(_name, _len);
+}
+
+BGFX_C_API void bgfx_end_gpu_timer(void)
+{
+	bgfx::endGpuTimer();
+}
+
 BGFX_C_API void bgfx_set_state(uint64_t _state, uint32_t _rgba)
 {
 	bgfx::setState(_state, _rgba);
 }
 
-BGFX_C_API void bgfx_set_condition(bgfx_occlusion_query_handle_t _handle, bool _visible)
+BGFX_C_API void bgfx_set_condition(bgfx_occlusion_query_handle_t _handle, bool _visible, bool _gpu)
 {
 	union { bgfx_occlusion_query_handle_t c; bgfx::OcclusionQueryHandle cpp; } handle = { _handle };
-	bgfx::setCondition(handle.cpp, _visible);
+	bgfx::setCondition(handle.cpp, _visible, _gpu);
 }
 
 BGFX_C_API void bgfx_set_stencil(uint32_t _fstencil, uint32_t _bstencil)
@@ -1127,6 +1198,26 @@ BGFX_C_API void bgfx_set_instance_data_from_dynamic_vertex_buffer(bgfx_dynamic_v
 	bgfx::setInstanceDataBuffer(handle.cpp, _startVertex, _num);
 }
 
+BGFX_C_API void bgfx_set_instance_data_from_vertex_buffer_with_layout(bgfx_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle)
+{
+	union { bgfx_vertex_buffer_handle_t c; bgfx::VertexBufferHandle cpp; } handle = { _handle };
+	union { bgfx_vertex_layout_handle_t c; bgfx::VertexLayoutHandle cpp; } layoutHandle = { _layoutHandle };
+	bgfx::setInstanceDataBuffer(handle.cpp, _startVertex, _num, layoutHandle.cpp);
+}
+
+BGFX_C_API void bgfx_set_instance_data_from_dynamic_vertex_buffer_with_layout(bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle)
+{
+	union { bgfx_dynamic_vertex_buffer_handle_t c; bgfx::DynamicVertexBufferHandle cpp; } handle = { _handle };
+	union { bgfx_vertex_layout_handle_t c; bgfx::VertexLayoutHandle cpp; } layoutHandle = { _layoutHandle };
+	bgfx::setInstanceDataBuffer(handle.cpp, _startVertex, _num, layoutHandle.cpp);
+}
+
+BGFX_C_API void bgfx_set_instance_data_from_transient_vertex_buffer(const bgfx_transient_vertex_buffer_t* _tvb, uint32_t _start, uint32_t _num, bgfx_vertex_layout_handle_t _layoutHandle)
+{
+	union { bgfx_vertex_layout_handle_t c; bgfx::VertexLayoutHandle cpp; } layoutHandle = { _layoutHandle };
+	bgfx::setInstanceDataBuffer((const bgfx::TransientVertexBuffer*)_tvb, _start, _num, layoutHandle.cpp);
+}
+
 BGFX_C_API void bgfx_set_instance_count(uint32_t _numInstances)
 {
 	bgfx::setInstanceCount(_numInstances);
@@ -1157,6 +1248,11 @@ BGFX_C_API void bgfx_submit_occlusion_query(bgfx_view_id_t _id, bgfx_program_han
 	bgfx::submit((bgfx::ViewId)_id, program.cpp, occlusionQuery.cpp, _depth, _flags);
 }
 
+BGFX_C_API void bgfx_submit_draws(bgfx_view_id_t _id, const bgfx_draw_desc_t* _draws, uint32_t _num, const bgfx_draw_uniform_t* _uniforms, const bgfx_draw_texture_t* _textures)
+{
+	bgfx::submit((bgfx::ViewId)_id, (const bgfx::DrawDesc*)_draws, _num, (const bgfx::DrawUniform*)_uniforms, (const bgfx::DrawTexture*)_textures);
+}
+
 BGFX_C_API void bgfx_submit_indirect(bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags)
 {
 	union { bgfx_program_handle_t c; bgfx::ProgramHandle cpp; } program = { _program };
@@ -1298,6 +1394,8 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_get_stats,
 			bgfx_alloc,
 			bgfx_copy,
+			bgfx_alloc_frame,
+			bgfx_copy_frame,
 			bgfx_make_ref,
 			bgfx_make_ref_release,
 			bgfx_set_debug,
@@ -1377,11 +1475,15 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_set_view_mode,
 			bgfx_set_view_frame_buffer,
 			bgfx_set_view_transform,
+			bgfx_set_view_dynamic_resolution,
+			bgfx_set_dynamic_resolution,
 			bgfx_set_view_order,
 			bgfx_reset_view,
 			bgfx_encoder_begin,
 			bgfx_encoder_end,
 			bgfx_encoder_set_marker,
+			bgfx_encoder_begin_gpu_timer,
+			bgfx_encoder_end_gpu_timer,
 			bgfx_encoder_set_state,
 			bgfx_encoder_set_condition,
 			bgfx_encoder_set_stencil,
@@ -1404,11 +1506,15 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_encoder_set_instance_data_buffer,
 			bgfx_encoder_set_instance_data_from_vertex_buffer,
 			bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer,
+			bgfx_encoder_set_instance_data_from_vertex_buffer_with_layout,
+			bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer_with_layout,
+			bgfx_encoder_set_instance_data_from_transient_vertex_buffer,
 			bgfx_encoder_set_instance_count,
 			bgfx_encoder_set_texture,
 			bgfx_encoder_touch,
 			bgfx_encoder_submit,
 			bgfx_encoder_submit_occlusion_query,
+			bgfx_encoder_submit_draws,
 			bgfx_encoder_submit_indirect,
 			bgfx_encoder_submit_indirect_count,
 			bgfx_encoder_set_compute_index_buffer,
@@ -1428,6 +1534,8 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_override_internal_texture_ptr,
 			bgfx_override_internal_texture,
 			bgfx_set_marker,
+			bgfx_begin_gpu_timer,
+			bgfx_end_gpu_timer,
 			bgfx_set_state,
 			bgfx_set_condition,
 			bgfx_set_stencil,
@@ -1450,11 +1558,15 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_set_instance_data_buffer,
 			bgfx_set_instance_data_from_vertex_buffer,
 			bgfx_set_instance_data_from_dynamic_vertex_buffer,
+			bgfx_set_instance_data_from_vertex_buffer_with_layout,
+			bgfx_set_instance_data_from_dynamic_vertex_buffer_with_layout,
+			bgfx_set_instance_data_from_transient_vertex_buffer,
 			bgfx_set_instance_count,
 			bgfx_set_texture,
 			bgfx_touch,
 			bgfx_submit,
 			bgfx_submit_occlusion_query,
+			bgfx_submit_draws,
 			bgfx_submit_indirect,
 			bgfx_submit_indirect_count,
 			bgfx_set_compute_index_buffer,
@@ -144,6 +144,7 @@ namespace bgfx
 
 #include <bgfx/platform.h>
 #include <bimg/bimg.h>
+#include "dynamicresolution.h"
 #include "shader.h"
 #include "vertexlayout.h"
 #include "version.h"
@@ -230,6 +231,7 @@ namespace stl = std;
 #define BGFX_STATE_INTERNAL_OCCLUSION_QUERY UINT64_C(0x4000000000000000)
 
 #define BGFX_SUBMIT_INTERNAL_NONE              UINT8_C(0x00)
+#define BGFX_SUBMIT_INTERNAL_OCCLUSION_GPU     UINT8_C(0x20)
 #define BGFX_SUBMIT_INTERNAL_INDEX32           UINT8_C(0x40)
 #define BGFX_SUBMIT_INTERNAL_OCCLUSION_VISIBLE UINT8_C(0x80)
 #define BGFX_SUBMIT_INTERNAL_RESERVED_MASK     UINT8_C(0xff)
@@ -544,6 +546,18 @@ namespace bgfx
 			setIntersect(*this, _a);
 		}
 
+		void scale(float _scale)
+		{
+			const uint16_t sx = uint16_t(float(m_x)*_scale + 0.5f);
+			const uint16_t sy = uint16_t(float(m_y)*_scale + 0.5f);
+			const uint16_t ex = uint16_t(float(m_x + m_width )*_scale + 0.5f);
+			const uint16_t ey = uint16_t(float(m_y + m_height)*_scale + 0.5f);
+			m_x = sx;
+			m_y = sy;
+			m_width  = 0 == m_width  ? 0 : bx::max<uint16_t>(ex - sx, 1);
+			m_height = 0 == m_height ? 0 : bx::max<uint16_t>(ey - sy, 1);
+		}
+
 		uint16_t m_x;
 		uint16_t m_y;
 		uint16_t m_width;
@@ -584,11 +598,14 @@ namespace bgfx
 
 	void setGraphicsDebuggerPresent(bool _present);
 	bool isGraphicsDebuggerPresent();
+	bool isCallbackUserProvided();
 	void release(const Memory* _mem);
 	const char* getAttribName(Attrib::Enum _attr);
 	const char* getAttribNameShort(Attrib::Enum _attr);
 	void getTextureSizeFromRatio(BackbufferRatio::Enum _ratio, uint16_t& _width, uint16_t& _height);
 	TextureFormat::Enum getViableTextureFormat(const bimg::ImageContainer& _imageContainer);
+	const Memory* textureDecodeToBgra8(const Memory* _mem, const bimg::ImageContainer& _imageContainer);
+	const Memory* textureDecodeToBgra8(const Memory* _mem, TextureFormat::Enum _format, uint16_t _width, uint16_t _height, uint16_t _depth, uint16_t _pitch);
 	const char* getName(TextureFormat::Enum _fmt);
 	const char* getName(UniformHandle _handle);
 	const char* getName(ShaderHandle _handle);
@@ -646,6 +663,12 @@ namespace bgfx
 	{
 		TextVideoMem()
 			: m_mem(NULL)
+			, m_dirty(NULL)
+			, m_clearAttr(NULL)
+			, m_blitMem(NULL)
+			, m_blitNum(NULL)
+			, m_blitVertices(NULL)
+			, m_blitKey(0)
 			, m_size(0)
 			, m_width(0)
 			, m_height(0)
@@ -657,6 +680,9 @@ namespace bgfx
 
 		~TextVideoMem()
 		{
+			releaseBlitCache();
+			bx::free(g_allocator, m_clearAttr);
+			bx::free(g_allocator, m_dirty);
 			bx::free(g_allocator, m_mem);
 		}
 
@@ -683,22 +709,47 @@ namespace bgfx
 				{
 					bx::memSet(&m_mem[size], 0, (m_size-size) * sizeof(MemSlot) );
 				}
+
+				m_dirty = (bool*)bx::realloc(g_allocator, m_dirty, m_height * sizeof(bool) );
+				bx::memSet(m_dirty, true, m_height * sizeof(bool) );
+
+				m_clearAttr = (int16_t*)bx::realloc(g_allocator, m_clearAttr, m_height * sizeof(int16_t) );
+				bx::memSet(m_clearAttr, 0xff, m_height * sizeof(int16_t) );
+
+				releaseBlitCache();
 			}
 		}
 
 		void clear(uint8_t _attr = 0)
 		{
-			MemSlot* mem = m_mem;
-			bx::memSet(mem, 0, m_size * sizeof(MemSlot) );
-			if (_attr != 0)
+			// Rows that were not written since they were cleared with the same
+			// attribute are skipped, they are not scanned.
+			for (uint32_t yy = 0, height = m_height; yy < height; ++yy)
 			{
-				for (uint32_t ii = 0, num = m_size; ii < num; ++ii)
+				if (_attr == m_clearAttr[yy])
+				{
+					continue;
+				}
+
+				MemSlot* mem = &m_mem[yy*m_width];
+
+				for (uint32_t xx = 0, width = m_width; xx < width; ++xx)
 				{
-					mem[ii].attribute = _attr;
+					mem[xx].character = 0;
+					mem[xx].attribute = _attr;
 				}
+
+				m_dirty[yy]     = true;
+				m_clearAttr[yy] = _attr;
 			}
 		}
 
+		void setDirty(uint32_t _y)
+		{
+			m_dirty[_y]     = true;
+			m_clearAttr[_y] = -1;
+		}
+
 		void printfVargs(uint16_t _x, uint16_t _y, uint8_t _attr, const char* _format, va_list _argList);
 
 		void printf(uint16_t _x, uint16_t _y, uint8_t _attr, const char* _format, ...)
@@ -727,19 +778,60 @@ namespace bgfx
 						dst[jj].attribute = src[jj*2+1];
 					}
 
+					setDirty(_y+ii);
+
 					src += _pitch;
 					dst += dstPitch;
 				}
 			}
 		}
 
+		/// Regenerate glyph quads of rows that were written since last call,
+		/// and whose contents differ from ones quads were generated from. All
+		/// rows are regenerated when scale or palette changes.
+		///
+		/// @returns Number of regenerated rows.
+		///
+		uint32_t updateBlitCache(uint8_t _scale, bool _srgb);
+
+		void releaseBlitCache()
+		{
+			bx::free(g_allocator, m_blitMem);
+			bx::free(g_allocator, m_blitNum);
+			bx::free(g_allocator, m_blitVertices);
+			m_blitMem      = NULL;
+			m_blitNum      = NULL;
+			m_blitVertices = NULL;
+		}
+
 		struct MemSlot
 		{
 			uint8_t attribute;
 			uint8_t character;
 		};
 
+		struct BlitVertex
+		{
+			float m_x;
+			float m_y;
+			float m_z;
+			uint32_t m_fg;
+			uint32_t m_bg;
+			float m_u;
+			float m_v;
+		};
+
 		MemSlot* m_mem;
+		bool*    m_dirty;        //!< Row was written since last blit.
+		int16_t* m_clearAttr;    //!< Attribute row was cleared with, -1 if it was written since.
+
+		// Glyph quads generated by last blit, per row. Row is regenerated
+		// only when it's dirty and its contents differ from `m_blitMem`.
+		MemSlot*  m_blitMem;      //!< Row contents quads were generated from.
+		uint16_t* m_blitNum;      //!< Number of quads per row.
+		void*     m_blitVertices; //!< Quad vertices, room for every cell of row.
+		uint32_t  m_blitKey;      //!< Scale and palette quads were generated with.
+
 		uint32_t m_size;
 		uint16_t m_width;
 		uint16_t m_height;
@@ -761,9 +853,9 @@ namespace bgfx
 
 	struct RendererContextI;
 
-	extern void blit(RendererContextI* _renderCtx, TextVideoMemBlitter& _blitter, const TextVideoMem& _mem);
+	extern void blit(RendererContextI* _renderCtx, TextVideoMemBlitter& _blitter, TextVideoMem& _mem);
 
-	inline void blit(RendererContextI* _renderCtx, TextVideoMemBlitter& _blitter, const TextVideoMem* _mem)
+	inline void blit(RendererContextI* _renderCtx, TextVideoMemBlitter& _blitter, TextVideoMem* _mem)
 	{
 		blit(_renderCtx, _blitter, *_mem);
 	}
@@ -1735,6 +1827,7 @@ namespace bgfx
 				m_instanceDataStride = 0;
 				m_numInstances       = 1;
 				m_instanceDataBuffer.idx = kInvalidHandle;
+				m_instanceDataLayout.idx = kInvalidHandle;
 			}
 
 			if (0 != (_flags & BGFX_DISCARD_VERTEX_STREAMS) )
@@ -1802,6 +1895,7 @@ namespace bgfx
 
 		IndexBufferHandle    m_indexBuffer;
 		VertexBufferHandle   m_instanceDataBuffer;
+		VertexLayoutHandle   m_instanceDataLayout; //!< When valid, instance data is bound by layout instead of as i_data.
 		IndirectBufferHandle m_indirectBuffer;
 		IndexBufferHandle    m_numIndirectBuffer;
 		OcclusionQueryHandle m_occlusionQuery;
@@ -1933,6 +2027,7 @@ namespace bgfx
 		String   m_name;
 		uint32_t m_hashIn;
 		uint32_t m_hashOut;
+		uint32_t m_attribMask; //!< Attributes used by vertex shader, UINT32_MAX when binary doesn't list them.
 		uint16_t m_num;
 		int16_t  m_refCount;
 	};
@@ -1969,21 +2064,22 @@ namespace bgfx
 			, uint64_t _flags
 			)
 		{
-			m_ptr         = _ptrPending ? (void*)UINTPTR_MAX : NULL;
-			m_storageSize = _storageSize;
-			m_refCount    = 1;
-			m_bbRatio     = uint8_t(_ratio);
-			m_width       = _width;
-			m_height      = _height;
-			m_depth       = _depth;
-			m_format      = uint8_t(_format);
-			m_numSamples  = 1 << bx::uint32_satsub( (_flags & BGFX_TEXTURE_RT_MSAA_MASK) >> BGFX_TEXTURE_RT_MSAA_SHIFT, 1);
-			m_numMips     = _numMips;
-			m_numLayers   = _numLayers;
-			m_owned       = false;
-			m_immutable   = _immutable;
-			m_cubeMap     = _cubeMap;
-			m_flags       = _flags;
+			m_ptr          = _ptrPending ? (void*)UINTPTR_MAX : NULL;
+			m_storageSize  = _storageSize;
+			m_refCount     = 1;
+			m_bbRatio      = uint8_t(_ratio);
+			m_width        = _width;
+			m_height       = _height;
+			m_depth        = _depth;
+			m_format       = uint8_t(_format);
+			m_viableFormat = uint8_t(_format);
+			m_numSamples   = 1 << bx::uint32_satsub( (_flags & BGFX_TEXTURE_RT_MSAA_MASK) >> BGFX_TEXTURE_RT_MSAA_SHIFT, 1);
+			m_numMips      = _numMips;
+			m_numLayers    = _numLayers;
+			m_owned        = false;
+			m_immutable    = _immutable;
+			m_cubeMap      = _cubeMap;
+			m_flags        = _flags;
 		}
 
 		bool isRt() const
@@ -2021,6 +2117,7 @@ namespace bgfx
 		uint16_t m_height;
 		uint16_t m_depth;
 		uint8_t  m_format;
+		uint8_t  m_viableFormat;
 		uint8_t  m_numSamples;
 		uint8_t  m_numMips;
 		uint16_t m_numLayers;
@@ -2152,12 +2249,47 @@ namespace bgfx
 		FrameBufferHandle handle;
 	};
 
+	struct GpuTimerScope
+	{
+		char     m_name[64];
+		uint32_t m_begin;  //!< Sorted position of first render item covered by scope.
+		uint32_t m_end;    //!< Sorted position after last render item covered by scope.
+		uint32_t m_num;    //!< Number of render items submitted inside scope.
+		ViewId   m_view;
+		uint16_t m_parent;
+		uint16_t m_depth;
+	};
+
+	struct FrameMemory
+	{
+		FrameMemory()
+			: m_data(NULL)
+			, m_size(0)
+			, m_offset(0)
+			, m_used(0)
+			, m_max(0)
+		{
+		}
+
+		void create(uint32_t _size);
+		void destroy();
+		void reset();
+		const Memory* alloc(uint32_t _size);
+
+		uint8_t* m_data;
+		uint32_t m_size;
+		uint32_t m_offset;
+		uint32_t m_used;
+		uint32_t m_max;
+	};
+
 	BX_ALIGN_DECL_CACHE_LINE(struct) Frame
 	{
 		Frame()
 			: m_waitSubmit(0)
 			, m_waitRender(0)
 			, m_frameNum(0)
+			, m_resolutionScale(1.0f)
 			, m_capture(false)
 		{
 			SortKey term;
@@ -2167,7 +2299,18 @@ namespace bgfx
 			m_sortValues[BGFX_CONFIG_MAX_DRAW_CALLS] = BGFX_CONFIG_MAX_DRAW_CALLS;
 			bx::memSet(m_occlusion, 0xff, sizeof(m_occlusion) );
 
-			m_perfStats.viewStats = m_viewStats;
+			m_perfStats.viewStats     = m_viewStats;
+			m_perfStats.numGpuTimers  = 0;
+			m_perfStats.gpuTimerStats = m_gpuTimerStats;
+
+			m_perfStats.numGpuMemoryHeaps  = 0;
+			m_perfStats.numUniformsSkipped = 0;
+			m_perfStats.textureUploadStaged = 0;
+			m_perfStats.textureUploadDirect = 0;
+			m_perfStats.gpuMemoryHeapStats = m_gpuMemoryHeapStats;
+
+			setViewDirtyAll();
+			m_numActiveViews = 0;
 		}
 
 		~Frame()
@@ -2190,6 +2333,8 @@ namespace bgfx
 				}
 			}
 
+			m_frameMemory.create(BGFX_CONFIG_FRAME_MEMORY_SIZE);
+
 			reset();
 			start(0);
 			m_textVideoMem = BX_NEW(g_allocator, TextVideoMem);
@@ -2204,6 +2349,8 @@ namespace bgfx
 
 			bx::free(g_allocator, m_uniformBuffer);
 			bx::deleteObject(g_allocator, m_textVideoMem);
+
+			m_frameMemory.destroy();
 		}
 
 		void reset()
@@ -2218,9 +2365,15 @@ namespace bgfx
 			m_perfStats.transientVbUsed = m_vboffset;
 			m_perfStats.transientIbUsed = m_iboffset;
 
+			m_frameMemory.reset();
+			m_perfStats.frameMemoryUsed = m_frameMemory.m_used;
+			m_perfStats.frameMemoryMax  = m_frameMemory.m_max;
+
 			m_frameCache.reset();
-			m_numRenderItems = 0;
-			m_numBlitItems   = 0;
+			m_numRenderItems  = 0;
+			m_numBlitItems    = 0;
+			m_numGpuTimers    = 0;
+			m_numConditionGpu = 0;
 			m_iboffset = 0;
 			m_vboffset = 0;
 			m_cmdPre.start();
@@ -2237,6 +2390,9 @@ namespace bgfx
 		}
 
 		void sort();
+		void sortBindings();
+		void sortGpuTimers();
+		void sortConditions();
 
 		uint32_t getAvailTransientIndexBuffer(uint32_t _num, uint16_t _indexSize)
 		{
@@ -2316,6 +2472,17 @@ namespace bgfx
 			return m_freeUniform.queue(_handle);
 		}
 
+		void setViewDirty(ViewId _id)
+		{
+			m_viewDirty[_id/32] |= UINT32_C(1) << (_id%32);
+		}
+
+		void setViewDirtyAll()
+		{
+			bx::memSet(m_viewDirty, 0xff, sizeof(m_viewDirty) );
+			m_viewRemapDirty = true;
+		}
+
 		void resetFreeHandles()
 		{
 			m_freeIndexBuffer.reset();
@@ -2329,10 +2496,16 @@ namespace bgfx
 		}
 
 		ViewId m_viewRemap[BGFX_CONFIG_MAX_VIEWS];
+		ViewId m_viewRemapInv[BGFX_CONFIG_MAX_VIEWS];
 		float m_colorPalette[BGFX_CONFIG_MAX_COLOR_PALETTE][4];
 
 		View m_view[BGFX_CONFIG_MAX_VIEWS];
 
+		uint32_t m_viewDirty[(BGFX_CONFIG_MAX_VIEWS+31)/32]; //!< Views modified since last copied into this frame.
+		ViewId   m_activeView[BGFX_CONFIG_MAX_VIEWS];        //!< Views referenced by this frame, collected by sort.
+		uint32_t m_numActiveViews;
+		bool     m_viewRemapDirty;
+
 		int32_t m_occlusion[BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
 
 		uint64_t m_sortKeys[BGFX_CONFIG_MAX_DRAW_CALLS+1];
@@ -2343,11 +2516,19 @@ namespace bgfx
 		uint32_t m_blitKeys[BGFX_CONFIG_MAX_BLIT_ITEMS+1];
 		BlitItem m_blitItem[BGFX_CONFIG_MAX_BLIT_ITEMS+1];
 
+		uint16_t      m_renderItemGpuTimer[BGFX_CONFIG_MAX_DRAW_CALLS+1];
+		GpuTimerScope m_gpuTimer[BGFX_CONFIG_MAX_GPU_TIMERS];
+		uint16_t      m_gpuTimerBegin[BGFX_CONFIG_MAX_GPU_TIMERS]; //!< Non-empty scopes ordered by begin position.
+		uint16_t      m_gpuTimerEnd[BGFX_CONFIG_MAX_GPU_TIMERS];   //!< Non-empty scopes ordered by end position.
+
 		FrameCache m_frameCache;
 		UniformBuffer** m_uniformBuffer;
 
 		uint32_t m_numRenderItems;
 		uint16_t m_numBlitItems;
+		uint32_t m_numGpuTimers;
+		uint16_t m_numGpuTimerScopes;
+		uint32_t m_numConditionGpu;
 
 		uint32_t m_iboffset;
 		uint32_t m_vboffset;
@@ -2362,6 +2543,7 @@ namespace bgfx
 
 		CommandBuffer m_cmdPre;
 		CommandBuffer m_cmdPost;
+		FrameMemory m_frameMemory;
 
 		template<typename Ty, uint32_t Max>
 		struct FreeHandle
@@ -2432,11 +2614,14 @@ namespace bgfx
 
 		Stats     m_perfStats;
 		ViewStats m_viewStats[BGFX_CONFIG_MAX_VIEWS];
+		GpuTimerStats m_gpuTimerStats[BGFX_CONFIG_MAX_GPU_TIMERS];
+		GpuMemoryHeapStats m_gpuMemoryHeapStats[BGFX_CONFIG_MAX_GPU_MEMORY_HEAPS];
 
 		int64_t m_waitSubmit;
 		int64_t m_waitRender;
 
 		uint32_t m_frameNum;
+		float    m_resolutionScale; //!< Dynamic resolution scale of scalable views, picked when frame started.
 
 		bool m_capture;
 	};
@@ -2463,6 +2648,11 @@ namespace bgfx
 
 			m_numSubmitted = 0;
 			m_numDropped   = 0;
+
+			m_gpuTimerDepth   = 0;
+			m_gpuTimerCurrent = UINT16_MAX;
+
+			m_scissorScaleSrc = UINT16_MAX;
 		}
 
 		void end(bool _finalize)
@@ -2473,6 +2663,11 @@ namespace bgfx
 				uniformBuffer->finish();
 
 				m_cpuTimeEnd = bx::getHPCounter();
+
+				BX_WARN(0 == m_gpuTimerDepth
+					, "GPU timer scope is not closed before the end of the frame (depth %d)."
+					, m_gpuTimerDepth
+					);
 			}
 
 			if (BX_ENABLED(BGFX_CONFIG_DEBUG_OCCLUSION) )
@@ -2493,6 +2688,56 @@ namespace bgfx
 			uniformBuffer->writeMarker(_name);
 		}
 
+		void beginGpuTimer(const bx::StringView& _name)
+		{
+			uint16_t idx = UINT16_MAX;
+
+			if (m_gpuTimerDepth < BGFX_CONFIG_MAX_GPU_TIMER_DEPTH)
+			{
+				const uint32_t num = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numGpuTimers, 1, BGFX_CONFIG_MAX_GPU_TIMERS);
+
+				if (BGFX_CONFIG_MAX_GPU_TIMERS > num)
+				{
+					idx = uint16_t(num);
+
+					GpuTimerScope& scope = m_frame->m_gpuTimer[idx];
+					bx::strCopy(scope.m_name, BX_COUNTOF(scope.m_name), _name);
+					scope.m_parent = m_gpuTimerCurrent;
+					scope.m_depth  = m_gpuTimerDepth;
+				}
+
+				BX_WARN(UINT16_MAX != idx, "Too many GPU timer scopes (max: %d).", BGFX_CONFIG_MAX_GPU_TIMERS);
+
+				m_gpuTimerStack[m_gpuTimerDepth] = idx;
+			}
+
+			++m_gpuTimerDepth;
+
+			// Render items of scope that couldn't be allocated are accounted to parent.
+			m_gpuTimerCurrent = UINT16_MAX != idx ? idx : m_gpuTimerCurrent;
+		}
+
+		void endGpuTimer()
+		{
+			BX_ASSERT(0 < m_gpuTimerDepth, "endGpuTimer called without matching beginGpuTimer.");
+
+			if (0 < m_gpuTimerDepth)
+			{
+				--m_gpuTimerDepth;
+
+				m_gpuTimerCurrent = UINT16_MAX;
+
+				for (uint16_t ii = bx::min<uint16_t>(m_gpuTimerDepth, BGFX_CONFIG_MAX_GPU_TIMER_DEPTH); 0 < ii; --ii)
+				{
+					if (UINT16_MAX != m_gpuTimerStack[ii-1])
+					{
+						m_gpuTimerCurrent = m_gpuTimerStack[ii-1];
+						break;
+					}
+				}
+			}
+		}
+
 		void setUniform(UniformType::Enum _type, UniformHandle _handle, const void* _value, uint16_t _num)
 		{
 			if (BX_ENABLED(BGFX_CONFIG_DEBUG_UNIFORM) )
@@ -2538,10 +2783,11 @@ namespace bgfx
 			m_draw.m_rgba       = _rgba;
 		}
 
-		void setCondition(OcclusionQueryHandle _handle, bool _visible)
+		void setCondition(OcclusionQueryHandle _handle, bool _visible, bool _gpu)
 		{
 			m_draw.m_occlusionQuery = _handle;
 			m_draw.m_submitFlags   |= _visible ? BGFX_SUBMIT_INTERNAL_OCCLUSION_VISIBLE : 0;
+			m_draw.m_submitFlags   |= _gpu     ? BGFX_SUBMIT_INTERNAL_OCCLUSION_GPU     : 0;
 		}
 
 		void setStencil(uint32_t _fstencil, uint32_t _bstencil)
@@ -2561,6 +2807,8 @@ namespace bgfx
 			m_draw.m_scissor = _cache;
 		}
 
+		uint16_t scaleScissor(ViewId _id, uint16_t _scissor);
+
 		uint32_t setTransform(const void* _mtx, uint16_t _num)
 		{
 			m_draw.m_startMatrix = m_frame->m_frameCache.m_matrixCache.add(_mtx, _num);
@@ -2700,14 +2948,16 @@ namespace bgfx
 			m_draw.m_instanceDataStride = _idb->stride;
 			m_draw.m_numInstances       = num;
 			m_draw.m_instanceDataBuffer = _idb->handle;
+			m_draw.m_instanceDataLayout.idx = kInvalidHandle;
 		}
 
-		void setInstanceDataBuffer(VertexBufferHandle _handle, uint32_t _startVertex, uint32_t _num, uint16_t _stride)
+		void setInstanceDataBuffer(VertexBufferHandle _handle, uint32_t _offset, uint32_t _num, uint16_t _stride, VertexLayoutHandle _layoutHandle = BGFX_INVALID_HANDLE)
 		{
-			m_draw.m_instanceDataOffset = _startVertex * _stride;
+			m_draw.m_instanceDataOffset = _offset;
 			m_draw.m_instanceDataStride = _stride;
 			m_draw.m_numInstances       = _num;
 			m_draw.m_instanceDataBuffer = _handle;
+			m_draw.m_instanceDataLayout = _layoutHandle;
 		}
 
 		void setInstanceCount(uint32_t _numInstances)
@@ -2778,6 +3028,8 @@ namespace bgfx
 
 		void submit(ViewId _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint32_t _depth, uint8_t _flags);
 
+		void submit(ViewId _id, const DrawDesc* _draws, uint32_t _num, const DrawUniform* _uniforms, const DrawTexture* _textures);
+
 		void submit(ViewId _id, ProgramHandle _program, IndirectBufferHandle _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags)
 		{
 			m_draw.m_startIndirect  = _start;
@@ -2817,6 +3069,13 @@ namespace bgfx
 		uint32_t m_numSubmitted;
 		uint32_t m_numDropped;
 
+		uint16_t m_gpuTimerStack[BGFX_CONFIG_MAX_GPU_TIMER_DEPTH];
+		uint16_t m_gpuTimerDepth;
+		uint16_t m_gpuTimerCurrent;
+
+		uint16_t m_scissorScaleSrc; //!< Last scissor scaled for dynamic resolution.
+		uint16_t m_scissorScaled;
+
 		uint32_t m_uniformBegin;
 		uint32_t m_uniformEnd;
 		uint32_t m_numVertices[BGFX_CONFIG_MAX_VERTEX_STREAMS];
@@ -2840,6 +3099,8 @@ namespace bgfx
 		void init()
 		{
 			bx::memSet(m_refCount,                  0, sizeof(m_refCount)               );
+			bx::memSet(m_stride,                    0, sizeof(m_stride)                 );
+			bx::memSet(m_attribMask,                0, sizeof(m_attribMask)             );
 			bx::memSet(m_vertexBufferRef,        0xff, sizeof(m_vertexBufferRef)        );
 			bx::memSet(m_dynamicVertexBufferRef, 0xff, sizeof(m_dynamicVertexBufferRef) );
 		}
@@ -2924,6 +3185,8 @@ namespace bgfx
 		VertexLayoutMap m_vertexLayoutMap;
 
 		uint16_t m_refCount[BGFX_CONFIG_MAX_VERTEX_LAYOUTS];
+		uint16_t m_stride[BGFX_CONFIG_MAX_VERTEX_LAYOUTS];
+		uint32_t m_attribMask[BGFX_CONFIG_MAX_VERTEX_LAYOUTS];
 		VertexLayoutHandle m_vertexBufferRef[BGFX_CONFIG_MAX_VERTEX_BUFFERS];
 		VertexLayoutHandle m_dynamicVertexBufferRef[BGFX_CONFIG_MAX_DYNAMIC_VERTEX_BUFFERS];
 	};
@@ -3099,6 +3362,7 @@ namespace bgfx
 		virtual void submit(Frame* _render, ClearQuad& _clearQuad, TextVideoMemBlitter& _textVideoMemBlitter) = 0;
 		virtual void blitSetup(TextVideoMemBlitter& _blitter) = 0;
 		virtual void blitRender(TextVideoMemBlitter& _blitter, uint32_t _numIndices) = 0;
+		virtual bool isThreadSafe(CommandBuffer::Enum _command) const = 0;
 	};
 
 	inline RendererContextI::~RendererContextI()
@@ -3107,6 +3371,65 @@ namespace bgfx
 
 	void rendererUpdateUniforms(RendererContextI* _renderCtx, UniformBuffer* _uniformBuffer, uint32_t _begin, uint32_t _end);
 
+	// Executes resource commands that backend reports as thread safe on worker
+	// threads, while the rest of the command buffer is executed in order on the
+	// render thread. Commands that depend on queued work by handle must wait for
+	// it before executing.
+	class RenderWorkerPool
+	{
+		BX_CLASS(RenderWorkerPool
+			, NO_COPY
+			);
+
+	public:
+		RenderWorkerPool();
+
+		void init(RendererContextI* _renderCtx, uint32_t _numThreads);
+		void shutdown();
+
+		bool isEnabled(CommandBuffer::Enum _command) const
+		{
+			return 0 != m_numThreads
+				&& m_renderCtx->isThreadSafe(_command)
+				;
+		}
+
+		void createShader(ShaderHandle _handle, const Memory* _mem);
+		void wait(ShaderHandle _handle);
+		void waitAll();
+
+	private:
+		struct Job
+		{
+			const Memory* m_mem;
+			uint16_t m_handle;
+			uint8_t  m_command;
+			bool     m_done;
+		};
+
+		void push(CommandBuffer::Enum _command, uint16_t _handle, const Memory* _mem);
+		void wait(uint32_t _jobIdx);
+
+		static int32_t threadFunc(bx::Thread* _thread, void* _userData);
+		int32_t worker();
+
+		RendererContextI* m_renderCtx;
+
+		bx::Thread    m_thread[BGFX_CONFIG_RENDER_WORKER_THREADS > 0 ? BGFX_CONFIG_RENDER_WORKER_THREADS : 1];
+		bx::Mutex     m_mutex;
+		bx::Semaphore m_workSem;
+		bx::Semaphore m_doneSem;
+
+		Job      m_job[BGFX_CONFIG_MAX_SHADERS];
+		uint16_t m_shaderJob[BGFX_CONFIG_MAX_SHADERS];
+
+		uint32_t m_numThreads;
+		uint32_t m_numJobs;
+		uint32_t m_numStarted;
+		uint32_t m_numDoneWaits; //!< Done semaphore posts consumed by render thread.
+		bool     m_exit;
+	};
+
 #if BGFX_CONFIG_DEBUG
 #	define BGFX_API_FUNC(_func) BX_NO_INLINE _func
 #else
@@ -3230,6 +3553,11 @@ namespace bgfx
 				m_view[ii].setFrameBuffer(BGFX_INVALID_HANDLE);
 			}
 
+			for (uint32_t ii = 0; ii < BX_COUNTOF(m_frame); ++ii)
+			{
+				m_frame[ii].setViewDirtyAll();
+			}
+
 			for (uint16_t ii = 0, num = m_textureHandle.getNumHandles(); ii < num; ++ii)
 			{
 				uint16_t textureIdx = m_textureHandle.getHandleAt(ii);
@@ -3308,6 +3636,8 @@ namespace bgfx
 			stats.textureMemoryUsed = m_textureMemoryUsed;
 			stats.rtMemoryUsed      = m_rtMemoryUsed;
 
+			stats.resolutionScale = m_submit->m_resolutionScale;
+
 			return &stats;
 		}
 
@@ -3382,6 +3712,16 @@ namespace bgfx
 				return BGFX_INVALID_HANDLE;
 			}
 
+			m_vertexLayoutRef.m_stride[layoutHandle.idx] = _layout.m_stride;
+
+			uint32_t attribMask = 0;
+			for (uint32_t ii = 0; ii < Attrib::Count; ++ii)
+			{
+				attribMask |= _layout.has(Attrib::Enum(ii) ) ? UINT32_C(1)<<ii : 0;
+			}
+
+			m_vertexLayoutRef.m_attribMask[layoutHandle.idx] = attribMask;
+
 			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::CreateVertexLayout);
 			cmdbuf.write(layoutHandle);
 			cmdbuf.write(_layout);
@@ -4172,11 +4512,12 @@ namespace bgfx
 			BX_ASSERT(ok, "Shader already exists!"); BX_UNUSED(ok);
 
 			ShaderRef& sr = m_shaderRef[handle.idx];
-			sr.m_refCount = 1;
-			sr.m_hashIn   = hashIn;
-			sr.m_hashOut  = hashOut;
-			sr.m_num      = 0;
-			sr.m_uniforms = NULL;
+			sr.m_refCount   = 1;
+			sr.m_hashIn     = hashIn;
+			sr.m_hashOut    = hashOut;
+			sr.m_attribMask = UINT32_MAX;
+			sr.m_num        = 0;
+			sr.m_uniforms   = NULL;
 
 			UniformHandle* uniforms = (UniformHandle*)alloca(count*sizeof(UniformHandle) );
 
@@ -4229,6 +4570,39 @@ namespace bgfx
 				bx::memCopy(sr.m_uniforms, uniforms, size);
 			}
 
+			if (isShaderType(magic, 'V') )
+			{
+				// Attributes are listed after shader code. GLSL binaries
+				// don't list them, attributes are known only once renderer
+				// links program.
+				bx::Error attrErr;
+
+				uint32_t shaderSize = 0;
+				bx::read(&reader, shaderSize, &attrErr);
+				bx::skip(&reader, shaderSize+1);
+
+				uint8_t numAttrs = 0;
+				bx::read(&reader, numAttrs, &attrErr);
+
+				if (attrErr.isOk() )
+				{
+					sr.m_attribMask = 0;
+
+					for (uint32_t ii = 0; ii < numAttrs; ++ii)
+					{
+						uint16_t id = 0;
+						bx::read(&reader, id, &attrErr);
+
+						const Attrib::Enum attr = idToAttrib(id);
+
+						if (Attrib::Count != attr)
+						{
+							sr.m_attribMask |= UINT32_C(1)<<attr;
+						}
+					}
+				}
+			}
+
 			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::CreateShader);
 			cmdbuf.write(handle);
 			cmdbuf.write(_mem);
@@ -4488,8 +4862,6 @@ namespace bgfx
 
 		BGFX_API_FUNC(TextureHandle createTexture(const Memory* _mem, uint64_t _flags, uint8_t _skip, TextureInfo* _info, BackbufferRatio::Enum _ratio, bool _immutable) )
 		{
-			BGFX_MUTEX_SCOPE(m_resourceApiLock);
-
 			TextureInfo ti;
 			if (NULL == _info)
 			{
@@ -4525,6 +4897,17 @@ namespace bgfx
 
 			_flags |= imageContainer.m_srgb ? BGFX_TEXTURE_SRGB : 0;
 
+			// Formats not supported by renderer are decoded on the calling thread,
+			// before taking resource lock, so that render thread only receives data
+			// it can upload as is.
+			const TextureFormat::Enum viableFormat = getViableTextureFormat(imageContainer);
+			if (viableFormat != TextureFormat::Enum(imageContainer.m_format) )
+			{
+				_mem = textureDecodeToBgra8(_mem, imageContainer);
+			}
+
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
 			TextureHandle handle = { m_textureHandle.alloc() };
 			BX_WARN(isValid(handle), "Failed to allocate texture handle.");
 
@@ -4549,6 +4932,7 @@ namespace bgfx
 				, imageContainer.m_cubeMap
 				, _flags
 				);
+			ref.m_viableFormat = uint8_t(viableFormat);
 
 			if (ref.isRt() )
 			{
@@ -4707,16 +5091,36 @@ namespace bgfx
 			, const Memory* _mem
 		) )
 		{
-			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+			bool immutable;
+			TextureFormat::Enum format;
+			TextureFormat::Enum viableFormat;
 
-			const TextureRef& ref = m_textureRef[_handle.idx];
-			if (ref.m_immutable)
+			{
+				// Texture ref is read under resource lock because texture might be
+				// destroyed on another thread, lock is released for decoding.
+				BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+				const TextureRef& ref = m_textureRef[_handle.idx];
+				immutable    = ref.m_immutable;
+				format       = TextureFormat::Enum(ref.m_format);
+				viableFormat = TextureFormat::Enum(ref.m_viableFormat);
+			}
+
+			if (immutable)
 			{
 				BX_WARN(false, "Can't update immutable texture.");
 				release(_mem);
 				return;
 			}
 
+			if (format != viableFormat)
+			{
+				_mem   = textureDecodeToBgra8(_mem, format, _width, _height, _depth, _pitch);
+				_pitch = UINT16_MAX;
+			}
+
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
 			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::UpdateTexture);
 			cmdbuf.write(_handle);
 			cmdbuf.write(_side);
@@ -5095,11 +5499,13 @@ namespace bgfx
 		BGFX_API_FUNC(void setViewRect(ViewId _id, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height) )
 		{
 			m_view[_id].setRect(_x, _y, _width, _height);
+			setViewDirty(_id);
 		}
 
 		BGFX_API_FUNC(void setViewScissor(ViewId _id, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height) )
 		{
 			m_view[_id].setScissor(_x, _y, _width, _height);
+			setViewDirty(_id);
 		}
 
 		BGFX_API_FUNC(void setViewClear(ViewId _id, uint16_t _flags, uint32_t _rgba, float _depth, uint8_t _stencil) )
@@ -5110,6 +5516,7 @@ namespace bgfx
 				);
 
 			m_view[_id].setClear(_flags, _rgba, _depth, _stencil);
+			setViewDirty(_id);
 		}
 
 		BGFX_API_FUNC(void setViewClear(ViewId _id, uint16_t _flags, float _depth, uint8_t _stencil, uint8_t _0, uint8_t _1, uint8_t _2, uint8_t _3, uint8_t _4, uint8_t _5, uint8_t _6, uint8_t _7) )
@@ -5120,27 +5527,59 @@ namespace bgfx
 				);
 
 			m_view[_id].setClear(_flags, _depth, _stencil, _0, _1, _2, _3, _4, _5, _6, _7);
+			setViewDirty(_id);
 		}
 
 		BGFX_API_FUNC(void setViewMode(ViewId _id, ViewMode::Enum _mode) )
 		{
 			m_view[_id].setMode(_mode);
+			setViewDirty(_id);
 		}
 
 		BGFX_API_FUNC(void setViewFrameBuffer(ViewId _id, FrameBufferHandle _handle) )
 		{
 			BGFX_CHECK_HANDLE_INVALID_OK("setViewFrameBuffer", m_frameBufferHandle, _handle);
 			m_view[_id].setFrameBuffer(_handle);
+			setViewDirty(_id);
 		}
 
 		BGFX_API_FUNC(void setViewTransform(ViewId _id, const void* _view, const void* _proj) )
 		{
 			m_view[_id].setTransform(_view, _proj);
+			setViewDirty(_id);
+		}
+
+		BGFX_API_FUNC(void setViewDynamicResolution(ViewId _id, bool _enabled) )
+		{
+			const uint32_t mask = UINT32_C(1) << (_id%32);
+			m_viewScalable[_id/32] = _enabled
+				? m_viewScalable[_id/32] |  mask
+				: m_viewScalable[_id/32] & ~mask
+				;
+			setViewDirty(_id);
+		}
+
+		bool isViewScalable(ViewId _id) const
+		{
+			return 0 != (m_viewScalable[_id/32] & (UINT32_C(1) << (_id%32) ) );
+		}
+
+		BGFX_API_FUNC(void setDynamicResolution(float _targetMs, float _minScale, float _maxScale) )
+		{
+			BX_ASSERT(_minScale <= _maxScale
+				, "Minimum scale must not be greater than maximum scale (min %f, max %f)."
+				, _minScale
+				, _maxScale
+				);
+
+			m_dynamicResolution.reset(_targetMs, _minScale, _maxScale);
 		}
 
 		BGFX_API_FUNC(void resetView(ViewId _id) )
 		{
 			m_view[_id].reset();
+			m_viewScalable[_id/32] &= ~(UINT32_C(1) << (_id%32) );
+			setViewDirty(_id);
 		}
 
 		BGFX_API_FUNC(void setViewOrder(ViewId _id, uint16_t _num, const ViewId* _order) )
@@ -5158,6 +5597,11 @@ namespace bgfx
 			{
 				bx::memCopy(&m_viewRemap[_id], _order, num*sizeof(ViewId) );
 			}
+
+			for (uint32_t ii = 0; ii < BX_COUNTOF(m_frame); ++ii)
+			{
+				m_frame[ii].m_viewRemapDirty = true;
+			}
 		}
 
 		BGFX_API_FUNC(Encoder* begin(bool _forThread) );
@@ -5168,7 +5612,23 @@ namespace bgfx
 
 		uint32_t getSeqIncr(ViewId _id)
 		{
-			return bx::atomicFetchAndAdd<uint32_t>(&m_seq[_id], 1);
+			const uint32_t seq = bx::atomicFetchAndAdd<uint32_t>(&m_seq[_id], 1);
+
+			if (0 == seq)
+			{
+				// Remember which views were used, so that only those are reset in swap.
+				m_seqView[bx::atomicFetchAndAdd<uint32_t>(&m_numSeqViews, 1)] = _id;
+			}
+
+			return seq;
+		}
+
+		void setViewDirty(ViewId _id)
+		{
+			for (uint32_t ii = 0; ii < BX_COUNTOF(m_frame); ++ii)
+			{
+				m_frame[ii].setViewDirty(_id);
+			}
 		}
 
 		void dumpViewStats();
@@ -5247,6 +5707,8 @@ namespace bgfx
 				uint16_t idx = m_encoderHandle->getHandleAt(ii);
 				m_encoderStats[ii].cpuTimeBegin = m_encoder[idx].m_cpuTimeBegin;
 				m_encoderStats[ii].cpuTimeEnd   = m_encoder[idx].m_cpuTimeEnd;
+				m_encoderStats[ii].numSubmitted = m_encoder[idx].m_numSubmitted;
+				m_encoderStats[ii].numDropped   = m_encoder[idx].m_numDropped;
 			}
 
 			m_submit->m_perfStats.numEncoders = uint8_t(numEncoders);
@@ -5285,6 +5747,8 @@ namespace bgfx
 		{
 			m_encoderStats[0].cpuTimeBegin = m_encoder[0].m_cpuTimeBegin;
 			m_encoderStats[0].cpuTimeEnd   = m_encoder[0].m_cpuTimeEnd;
+			m_encoderStats[0].numSubmitted = m_encoder[0].m_numSubmitted;
+			m_encoderStats[0].numDropped   = m_encoder[0].m_numDropped;
 			m_submit->m_perfStats.numEncoders = 1;
 		}
 #endif // BGFX_CONFIG_MULTITHREADED
@@ -5349,12 +5813,18 @@ namespace bgfx
 
 		ViewId m_viewRemap[BGFX_CONFIG_MAX_VIEWS];
 		uint32_t m_seq[BGFX_CONFIG_MAX_VIEWS];
+		ViewId   m_seqView[BGFX_CONFIG_MAX_VIEWS];
+		uint32_t m_numSeqViews;
 		View m_view[BGFX_CONFIG_MAX_VIEWS];
 
 		float m_clearColor[BGFX_CONFIG_MAX_COLOR_PALETTE][4];
 
 		uint8_t m_colorPaletteDirty;
 
+		uint32_t m_viewScalable[(BGFX_CONFIG_MAX_VIEWS+31)/32]; //!< Views with dynamic resolution enabled.
+		DynamicResolution m_dynamicResolution;
+		uint32_t m_dynamicResolutionGpuFrameNum; //!< GPU frame whose timing was last fed to controller.
+
 		Init     m_init;
 		int64_t  m_frameTimeLast;
 		uint32_t m_frames;
@@ -5367,6 +5837,7 @@ namespace bgfx
 		ClearQuad m_clearQuad;
 
 		RendererContextI* m_renderCtx;
+		RenderWorkerPool  m_renderWorkerPool;
 
 		bool m_headless;
 		bool m_rendererInitialized;
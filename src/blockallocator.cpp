@@ -0,0 +1,164 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/debug.h>
+#include <bx/math.h>
+#include <bx/uint32_t.h>
+
+#include <inttypes.h>
+
+#include "blockallocator.h"
+
+namespace bgfx
+{
+	BuddyAllocator::BuddyAllocator()
+		: m_allocator(NULL)
+		, m_longest(NULL)
+		, m_size(0)
+		, m_minSize(0)
+		, m_used(0)
+		, m_numAllocations(0)
+		, m_minSizeShift(0)
+		, m_maxOrder(0)
+	{
+	}
+
+	BuddyAllocator::~BuddyAllocator()
+	{
+		shutdown();
+	}
+
+	bool BuddyAllocator::init(bx::AllocatorI* _allocator, uint64_t _size, uint64_t _minSize)
+	{
+		BX_ASSERT(NULL == m_longest, "Buddy allocator is already initialized.");
+
+		if (!bx::isPowerOf2(_size)
+		||  !bx::isPowerOf2(_minSize)
+		||  _minSize > _size)
+		{
+			return false;
+		}
+
+		m_allocator      = _allocator;
+		m_size           = _size;
+		m_minSize        = _minSize;
+		m_used           = 0;
+		m_numAllocations = 0;
+		m_minSizeShift   = uint8_t(bx::uint64_cnttz(_minSize) );
+		m_maxOrder       = uint8_t(bx::uint64_cnttz(_size) - m_minSizeShift);
+
+		const uint32_t numLeaves = UINT32_C(1) << m_maxOrder;
+		const uint32_t numNodes  = numLeaves*2 - 1;
+
+		m_longest = (uint8_t*)bx::alloc(m_allocator, numNodes);
+
+		for (uint32_t order = m_maxOrder+1, first = 0, num = 1; 0 < order; --order, first += num, num *= 2)
+		{
+			bx::memSet(&m_longest[first], uint8_t(order), num);
+		}
+
+		return true;
+	}
+
+	void BuddyAllocator::shutdown()
+	{
+		if (NULL != m_longest)
+		{
+			BX_WARN(0 == m_numAllocations, "Buddy allocator shutdown with %d live allocations.", m_numAllocations);
+
+			bx::free(m_allocator, m_longest);
+			m_longest = NULL;
+		}
+	}
+
+	uint64_t BuddyAllocator::alloc(uint64_t _size, uint64_t _align)
+	{
+		BX_ASSERT(bx::isPowerOf2(_align), "Alignment must be power of 2 (_align: %" PRIu64 ").", _align);
+
+		// Ranges are aligned to their own size.
+		const uint64_t size   = bx::max(_size, _align, m_minSize);
+		const uint64_t leaves = (size + m_minSize - 1) >> m_minSizeShift;
+
+		uint32_t order = 0;
+		for (; (uint64_t(1) << order) < leaves; ++order)
+		{
+		}
+
+		if (order > m_maxOrder
+		||  m_longest[0] < order+1)
+		{
+			return kInvalidOffset;
+		}
+
+		uint32_t node = 0;
+		for (uint32_t nodeOrder = m_maxOrder; nodeOrder != order; --nodeOrder)
+		{
+			const uint32_t left = node*2 + 1;
+			node = m_longest[left] >= order+1 ? left : left + 1;
+		}
+
+		m_longest[node] = 0;
+
+		const uint32_t firstAtLevel = (UINT32_C(1) << (m_maxOrder - order) ) - 1;
+		const uint64_t offset = uint64_t(node - firstAtLevel) << (order + m_minSizeShift);
+
+		while (0 != node)
+		{
+			node = (node - 1) / 2;
+			m_longest[node] = bx::max(m_longest[node*2 + 1], m_longest[node*2 + 2]);
+		}
+
+		m_used += uint64_t(1) << (order + m_minSizeShift);
+		++m_numAllocations;
+
+		return offset;
+	}
+
+	void BuddyAllocator::free(uint64_t _offset)
+	{
+		BX_ASSERT(_offset < m_size, "Invalid offset %" PRIu64 ".", _offset);
+
+		const uint32_t numLeaves = UINT32_C(1) << m_maxOrder;
+
+		uint32_t node  = uint32_t(_offset >> m_minSizeShift) + numLeaves - 1;
+		uint32_t order = 0;
+
+		// Walk up until node that was allocated is found.
+		for (; 0 != m_longest[node]; ++order)
+		{
+			BX_ASSERT(0 != node, "Offset %" PRIu64 " is not allocated.", _offset);
+			node = (node - 1) / 2;
+		}
+
+		m_longest[node] = uint8_t(order+1);
+
+		m_used -= uint64_t(1) << (order + m_minSizeShift);
+		--m_numAllocations;
+
+		// Merge with buddy when both halves are free.
+		while (0 != node)
+		{
+			node = (node - 1) / 2;
+			++order;
+
+			const uint8_t left  = m_longest[node*2 + 1];
+			const uint8_t right = m_longest[node*2 + 2];
+
+			m_longest[node] = left == order && right == order
+				? uint8_t(order+1)
+				: bx::max(left, right)
+				;
+		}
+	}
+
+	uint64_t BuddyAllocator::getLargestFree() const
+	{
+		return 0 == m_longest[0]
+			? 0
+			: uint64_t(1) << (m_longest[0] - 1 + m_minSizeShift)
+			;
+	}
+
+} // namespace bgfx
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef BGFX_BLOCKALLOCATOR_H_HEADER_GUARD
+#define BGFX_BLOCKALLOCATOR_H_HEADER_GUARD
+
+#include <bx/allocator.h>
+
+namespace bgfx
+{
+	/// Buddy allocator placing sub-ranges inside single memory block. It
+	/// doesn't touch memory it manages, it only tracks offsets, so it can be
+	/// used for GPU memory, and tested without GPU device.
+	///
+	/// Every allocation is rounded up to power of 2 multiple of minimum
+	/// allocation size, and it's aligned to its own size.
+	///
+	class BuddyAllocator
+	{
+	public:
+		static constexpr uint64_t kInvalidOffset = UINT64_MAX;
+
+		///
+		BuddyAllocator();
+
+		///
+		~BuddyAllocator();
+
+		/// Initialize allocator.
+		///
+		/// @param[in] _allocator Allocator for internal state.
+		/// @param[in] _size Block size. Must be power of 2.
+		/// @param[in] _minSize Minimum allocation size. Must be power of 2.
+		///
+		bool init(bx::AllocatorI* _allocator, uint64_t _size, uint64_t _minSize);
+
+		///
+		void shutdown();
+
+		/// Allocate range.
+		///
+		/// @param[in] _size Size in bytes.
+		/// @param[in] _align Alignment in bytes. Must be power of 2.
+		///
+		/// @returns Offset from beginning of block, or `kInvalidOffset` if
+		///   there is no free range large enough.
+		///
+		uint64_t alloc(uint64_t _size, uint64_t _align);
+
+		/// Free range previously returned by `alloc`.
+		void free(uint64_t _offset);
+
+		/// Returns block size.
+		uint64_t getSize() const { return m_size; }
+
+		/// Returns sum of allocated range sizes, including rounding.
+		uint64_t getUsed() const { return m_used; }
+
+		/// Returns size of largest range that can be allocated.
+		uint64_t getLargestFree() const;
+
+		/// Returns number of live allocations.
+		uint32_t getNumAllocations() const { return m_numAllocations; }
+
+		/// Returns true if there are no live allocations.
+		bool isEmpty() const { return 0 == m_numAllocations; }
+
+	private:
+		bx::AllocatorI* m_allocator;
+
+		// Binary tree stored as array, root at index 0. Each node stores
+		// order+1 of largest free range inside its subtree, 0 when fully
+		// allocated.
+		uint8_t* m_longest;
+
+		uint64_t m_size;
+		uint64_t m_minSize;
+		uint64_t m_used;
+		uint32_t m_numAllocations;
+		uint8_t  m_minSizeShift;
+		uint8_t  m_maxOrder;
+	};
+
+} // namespace bgfx
+
+#endif // BGFX_BLOCKALLOCATOR_H_HEADER_GUARD
@@ -209,6 +209,14 @@
 #	define BGFX_CONFIG_MULTITHREADED ( (0 == BX_PLATFORM_EMSCRIPTEN) ? 1 : 0)
 #endif // BGFX_CONFIG_MULTITHREADED
 
+/// Number of render worker threads used to execute independent resource
+/// commands (shader creation) in parallel with the rest of the command buffer.
+/// Backend decides which commands are thread safe. 0 disables worker threads.
+/// Worker threads are not used when bgfx runs single threaded.
+#ifndef BGFX_CONFIG_RENDER_WORKER_THREADS
+#	define BGFX_CONFIG_RENDER_WORKER_THREADS ( (0 != BGFX_CONFIG_MULTITHREADED) ? 3 : 0)
+#endif // BGFX_CONFIG_RENDER_WORKER_THREADS
+
 #ifndef BGFX_CONFIG_MAX_DRAW_CALLS
 #	define BGFX_CONFIG_MAX_DRAW_CALLS ( (64<<10)-1)
 #endif // BGFX_CONFIG_MAX_DRAW_CALLS
@@ -312,6 +320,36 @@ BX_STATIC_ASSERT(bx::isPowerOf2(BGFX_CONFIG_MAX_VIEWS), "BGFX_CONFIG_MAX_VIEWS m
 #	define BGFX_CONFIG_MAX_OCCLUSION_QUERIES 256
 #endif // BGFX_CONFIG_MAX_OCCLUSION_QUERIES
 
+/// Maximum number of GPU timer scopes per frame.
+#ifndef BGFX_CONFIG_MAX_GPU_TIMERS
+#	define BGFX_CONFIG_MAX_GPU_TIMERS 64
+#endif // BGFX_CONFIG_MAX_GPU_TIMERS
+
+/// Maximum nesting depth of GPU timer scopes within encoder.
+#ifndef BGFX_CONFIG_MAX_GPU_TIMER_DEPTH
+#	define BGFX_CONFIG_MAX_GPU_TIMER_DEPTH 16
+#endif // BGFX_CONFIG_MAX_GPU_TIMER_DEPTH
+
+/// Maximum number of vertex array objects cached by OpenGL renderer.
+#ifndef BGFX_CONFIG_MAX_VAO_CACHE
+#	define BGFX_CONFIG_MAX_VAO_CACHE 1024
+#endif // BGFX_CONFIG_MAX_VAO_CACHE
+
+#ifndef BGFX_CONFIG_MAX_GPU_MEMORY_HEAPS
+#	define BGFX_CONFIG_MAX_GPU_MEMORY_HEAPS 32
+#endif // BGFX_CONFIG_MAX_GPU_MEMORY_HEAPS
+
+/// Size of device memory blocks used to suballocate buffers and textures.
+/// Resources larger than half of block size get dedicated allocation.
+#ifndef BGFX_CONFIG_GPU_MEMORY_BLOCK_SIZE
+#	define BGFX_CONFIG_GPU_MEMORY_BLOCK_SIZE (64<<20)
+#endif // BGFX_CONFIG_GPU_MEMORY_BLOCK_SIZE
+
+/// Minimum suballocation size. Must be power of 2.
+#ifndef BGFX_CONFIG_GPU_MEMORY_MIN_ALLOC_SIZE
+#	define BGFX_CONFIG_GPU_MEMORY_MIN_ALLOC_SIZE (1<<10)
+#endif // BGFX_CONFIG_GPU_MEMORY_MIN_ALLOC_SIZE
+
 #ifndef BGFX_CONFIG_MIN_RESOURCE_COMMAND_BUFFER_SIZE
 #	define BGFX_CONFIG_MIN_RESOURCE_COMMAND_BUFFER_SIZE (64<<10)
 #endif // BGFX_CONFIG_MIN_RESOURCE_COMMAND_BUFFER_SIZE
@@ -324,6 +362,14 @@ BX_STATIC_ASSERT(bx::isPowerOf2(BGFX_CONFIG_MAX_VIEWS), "BGFX_CONFIG_MAX_VIEWS m
 #	define BGFX_CONFIG_TRANSIENT_INDEX_BUFFER_SIZE (2<<20)
 #endif // BGFX_CONFIG_TRANSIENT_INDEX_BUFFER_SIZE
 
+#ifndef BGFX_CONFIG_STAGING_BUFFER_CHUNK_SIZE
+#	define BGFX_CONFIG_STAGING_BUFFER_CHUNK_SIZE (4<<20)
+#endif // BGFX_CONFIG_STAGING_BUFFER_CHUNK_SIZE
+
+#ifndef BGFX_CONFIG_FRAME_MEMORY_SIZE
+#	define BGFX_CONFIG_FRAME_MEMORY_SIZE 0
+#endif // BGFX_CONFIG_FRAME_MEMORY_SIZE
+
 #ifndef BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT
 #	define BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT 5
 #endif // BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT
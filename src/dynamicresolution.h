@@ -0,0 +1,84 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef BGFX_DYNAMICRESOLUTION_H_HEADER_GUARD
+#define BGFX_DYNAMICRESOLUTION_H_HEADER_GUARD
+
+#include <bx/math.h>
+
+namespace bgfx
+{
+	constexpr float kDynamicResolutionMinScale = 0.1f;
+	constexpr float kDynamicResolutionFilter   = 0.25f; //!< Weight of the newest GPU frame time.
+	constexpr float kDynamicResolutionKp       = 0.2f;
+	constexpr float kDynamicResolutionKi       = 0.05f;
+	constexpr float kDynamicResolutionKd       = 0.05f;
+
+	/// PID controller picking render scale of scalable views from GPU frame
+	/// times. It doesn't touch any renderer state, so it can be driven by
+	/// synthetic timings.
+	struct DynamicResolution
+	{
+		DynamicResolution()
+		{
+			reset(0.0f, 1.0f, 1.0f);
+		}
+
+		void reset(float _targetMs, float _minScale, float _maxScale)
+		{
+			m_targetMs = bx::max(_targetMs, 0.0f);
+			m_minScale = bx::clamp(_minScale, kDynamicResolutionMinScale, 1.0f);
+			m_maxScale = bx::clamp(_maxScale, m_minScale, 1.0f);
+			m_scale    = isEnabled() ? m_maxScale : 1.0f;
+			m_filteredMs = m_targetMs;
+			m_error[0] = 0.0f;
+			m_error[1] = 0.0f;
+		}
+
+		bool isEnabled() const
+		{
+			return 0.0f < m_targetMs;
+		}
+
+		/// Returns scale for next frame. GPU time of 0 means timing is not
+		/// available and scale is kept.
+		float update(float _gpuTimeMs)
+		{
+			if (isEnabled()
+			&&  0.0f < _gpuTimeMs)
+			{
+				m_filteredMs = bx::lerp(m_filteredMs, _gpuTimeMs, kDynamicResolutionFilter);
+
+				// Positive error is headroom, negative is overrun, relative to target.
+				const float error = 1.0f - m_filteredMs/m_targetMs;
+
+				// Velocity form, output is change of scale. While scale is clamped
+				// there is no integral term to wind up.
+				const float delta = 0.0f
+					+ kDynamicResolutionKp * (error - m_error[0])
+					+ kDynamicResolutionKi *  error
+					+ kDynamicResolutionKd * (error - 2.0f*m_error[0] + m_error[1])
+					;
+
+				m_error[1] = m_error[0];
+				m_error[0] = error;
+
+				m_scale = bx::clamp(m_scale + delta, m_minScale, m_maxScale);
+			}
+
+			return m_scale;
+		}
+
+		float m_targetMs;
+		float m_minScale;
+		float m_maxScale;
+		float m_scale;
+		float m_filteredMs;
+		float m_error[2];
+	};
+
+} // namespace bgfx
+
+#endif // BGFX_DYNAMICRESOLUTION_H_HEADER_GUARD
@@ -452,7 +452,8 @@ namespace bgfx
 		if (_current.m_streamMask             != _new.m_streamMask
 		||  _current.m_instanceDataBuffer.idx != _new.m_instanceDataBuffer.idx
 		||  _current.m_instanceDataOffset     != _new.m_instanceDataOffset
-		||  _current.m_instanceDataStride     != _new.m_instanceDataStride)
+		||  _current.m_instanceDataStride     != _new.m_instanceDataStride
+		||  _current.m_instanceDataLayout.idx != _new.m_instanceDataLayout.idx)
 		{
 			return true;
 		}
@@ -539,6 +540,209 @@ namespace bgfx
 		bool     m_enabled;
 	};
 
+	/// Issues timer queries for GPU timer scopes, and publishes results of most
+	/// recent frame which had all of its timer queries resolved.
+	///
+	/// Ty must provide `begin(resultIdx, frameNum)`, `end(queryIdx)`, and
+	/// `m_result` array, same as timer query used by Profiler.
+	///
+	template<typename Ty>
+	struct GpuTimerScopes
+	{
+		GpuTimerScopes()
+			: m_frame(NULL)
+			, m_gpuTimer(NULL)
+			, m_resultOffset(0)
+			, m_num(0)
+			, m_beginIdx(0)
+			, m_endIdx(0)
+			, m_read(0)
+			, m_numPending(0)
+			, m_numResolved(0)
+		{
+		}
+
+		void begin(Frame* _frame, Ty* _gpuTimer, uint32_t _resultOffset)
+		{
+			m_frame        = _frame;
+			m_gpuTimer     = _gpuTimer;
+			m_resultOffset = _resultOffset;
+			m_num          = NULL != _gpuTimer ? _frame->m_numGpuTimerScopes : 0;
+			m_beginIdx     = 0;
+			m_endIdx       = 0;
+
+			if (0 == m_num)
+			{
+				return;
+			}
+
+			if (BX_COUNTOF(m_pending) == m_numPending)
+			{
+				// GPU is too far behind, oldest frame is dropped.
+				m_read = (m_read + 1) % BX_COUNTOF(m_pending);
+				--m_numPending;
+			}
+
+			Pending& pending = m_pending[(m_read + m_numPending) % BX_COUNTOF(m_pending)];
+			++m_numPending;
+
+			pending.m_frameNum = _frame->m_frameNum;
+			pending.m_num      = m_num;
+
+			for (uint16_t ii = 0; ii < m_num; ++ii)
+			{
+				const uint16_t idx = _frame->m_gpuTimerBegin[ii];
+				const GpuTimerScope& scope = _frame->m_gpuTimer[idx];
+
+				GpuTimerStats& stats = pending.m_stats[ii];
+				bx::strCopy(stats.name, BX_COUNTOF(stats.name), scope.m_name);
+				stats.view         = scope.m_view;
+				stats.depth        = scope.m_depth;
+				stats.numForeign   = scope.m_end - scope.m_begin - scope.m_num;
+				stats.gpuTimeBegin = 0;
+				stats.gpuTimeEnd   = 0;
+				stats.gpuFrameNum  = _frame->m_frameNum;
+
+				pending.m_idx[ii] = idx;
+			}
+		}
+
+		/// Returns true if timer queries are issued before render item at sorted
+		/// position `_item`.
+		bool hasEvent(uint32_t _item) const
+		{
+			return false
+				|| (m_endIdx   < m_num && m_frame->m_gpuTimer[m_frame->m_gpuTimerEnd[m_endIdx]    ].m_end   <= _item)
+				|| (m_beginIdx < m_num && m_frame->m_gpuTimer[m_frame->m_gpuTimerBegin[m_beginIdx]].m_begin <= _item)
+				;
+		}
+
+		/// Must be called before submitting render item at sorted position `_item`.
+		void update(uint32_t _item)
+		{
+			if (m_endIdx < m_num)
+			{
+				close(_item);
+				open(_item);
+			}
+		}
+
+		void end()
+		{
+			open(UINT32_MAX);
+			close(UINT32_MAX);
+
+			resolve();
+
+			m_frame->m_perfStats.numGpuTimers = m_numResolved;
+
+			if (0 != m_numResolved)
+			{
+				bx::memCopy(m_frame->m_gpuTimerStats, m_resolved, m_numResolved*sizeof(GpuTimerStats) );
+			}
+		}
+
+	private:
+		void open(uint32_t _item)
+		{
+			for (; m_beginIdx < m_num; ++m_beginIdx)
+			{
+				const uint16_t idx = m_frame->m_gpuTimerBegin[m_beginIdx];
+
+				if (m_frame->m_gpuTimer[idx].m_begin > _item)
+				{
+					break;
+				}
+
+				m_queryIdx[idx] = m_gpuTimer->begin(m_resultOffset + idx, m_frame->m_frameNum);
+			}
+		}
+
+		void close(uint32_t _item)
+		{
+			for (; m_endIdx < m_num; ++m_endIdx)
+			{
+				const uint16_t idx = m_frame->m_gpuTimerEnd[m_endIdx];
+
+				if (m_frame->m_gpuTimer[idx].m_end > _item)
+				{
+					break;
+				}
+
+				m_gpuTimer->end(m_queryIdx[idx]);
+			}
+		}
+
+		void resolve()
+		{
+			while (0 != m_numPending)
+			{
+				Pending& pending = m_pending[m_read];
+
+				bool resolved = true;
+				bool lost     = false;
+
+				for (uint16_t ii = 0; ii < pending.m_num; ++ii)
+				{
+					const typename Ty::Result& result = m_gpuTimer->m_result[m_resultOffset + pending.m_idx[ii] ];
+
+					if (result.m_frameNum != pending.m_frameNum)
+					{
+						resolved = false;
+
+						// Result slot was already overwritten by newer frame.
+						lost |= int32_t(result.m_frameNum - pending.m_frameNum) > 0;
+					}
+				}
+
+				if (!resolved
+				&&  !lost)
+				{
+					break;
+				}
+
+				if (resolved)
+				{
+					for (uint16_t ii = 0; ii < pending.m_num; ++ii)
+					{
+						const typename Ty::Result& result = m_gpuTimer->m_result[m_resultOffset + pending.m_idx[ii] ];
+						pending.m_stats[ii].gpuTimeBegin = result.m_begin;
+						pending.m_stats[ii].gpuTimeEnd   = result.m_end;
+					}
+
+					bx::memCopy(m_resolved, pending.m_stats, pending.m_num*sizeof(GpuTimerStats) );
+					m_numResolved = pending.m_num;
+				}
+
+				m_read = (m_read + 1) % BX_COUNTOF(m_pending);
+				--m_numPending;
+			}
+		}
+
+		struct Pending
+		{
+			GpuTimerStats m_stats[BGFX_CONFIG_MAX_GPU_TIMERS];
+			uint16_t      m_idx[BGFX_CONFIG_MAX_GPU_TIMERS];
+			uint32_t      m_frameNum;
+			uint16_t      m_num;
+		};
+
+		Frame*   m_frame;
+		Ty*      m_gpuTimer;
+		uint32_t m_resultOffset;
+		uint16_t m_num;
+		uint16_t m_beginIdx;
+		uint16_t m_endIdx;
+		uint32_t m_queryIdx[BGFX_CONFIG_MAX_GPU_TIMERS];
+
+		Pending  m_pending[BGFX_CONFIG_MAX_FRAME_LATENCY+2];
+		uint32_t m_read;
+		uint32_t m_numPending;
+
+		GpuTimerStats m_resolved[BGFX_CONFIG_MAX_GPU_TIMERS];
+		uint16_t      m_numResolved;
+	};
+
 } // namespace bgfx
 
 #endif // BGFX_RENDERER_H_HEADER_GUARD
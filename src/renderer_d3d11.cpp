@@ -922,7 +922,8 @@ namespace bgfx { namespace d3d11
 				for (;;)
 				{
 					uint32_t flags = 0
-						| D3D11_CREATE_DEVICE_SINGLETHREADED
+						// Render worker threads create shaders, device must be free-threaded.
+						| (0 == BGFX_CONFIG_RENDER_WORKER_THREADS ? D3D11_CREATE_DEVICE_SINGLETHREADED : 0)
 						| D3D11_CREATE_DEVICE_BGRA_SUPPORT
 //						| D3D11_CREATE_DEVICE_PREVENT_INTERNAL_THREADING_OPTIMIZATIONS
 						| (_init.debug ? D3D11_CREATE_DEVICE_DEBUG : 0)
@@ -1320,7 +1321,10 @@ namespace bgfx { namespace d3d11
 				// Instancing fully supported on 9_3+, optionally partially supported at lower levels.
 				if (m_featureLevel >= D3D_FEATURE_LEVEL_9_3)
 				{
-					g_caps.supported |= BGFX_CAPS_INSTANCING;
+					g_caps.supported |= 0
+						| BGFX_CAPS_INSTANCING
+						| BGFX_CAPS_INSTANCING_LAYOUT
+						;
 				}
 				else
 				{
@@ -2298,6 +2302,13 @@ namespace bgfx { namespace d3d11
 			return m_lost;
 		}
 
+		bool isThreadSafe(CommandBuffer::Enum _command) const override
+		{
+			// Device is created without D3D11_CREATE_DEVICE_SINGLETHREADED when worker threads
+			// are enabled, shader creation only reads uniform registry.
+			return CommandBuffer::CreateShader == _command;
+		}
+
 		void flip() override
 		{
 			if (!m_lost)
@@ -2676,7 +2687,7 @@ namespace bgfx { namespace d3d11
 			}
 		}
 
-		void setInputLayout(uint8_t _numStreams, const VertexLayout** _layouts, const ProgramD3D11& _program, uint16_t _numInstanceData)
+		void setInputLayout(uint8_t _numStreams, const VertexLayout** _layouts, const ProgramD3D11& _program, uint16_t _numInstanceData, const VertexLayout* _instanceLayout = NULL)
 		{
 			bx::HashMurmur2A murmur;
 			murmur.begin();
@@ -2685,6 +2696,10 @@ namespace bgfx { namespace d3d11
 			{
 				murmur.add(_layouts[stream]->m_hash);
 			}
+			if (NULL != _instanceLayout)
+			{
+				murmur.add(_instanceLayout->m_hash);
+			}
 			uint64_t layoutHash = (uint64_t(_program.m_vsh->m_hash)<<32) | murmur.end();
 
 			ID3D11InputLayout* inputLayout = m_inputLayoutCache.find(layoutHash);
@@ -2696,6 +2711,26 @@ namespace bgfx { namespace d3d11
 				uint16_t attrMask[Attrib::Count];
 				bx::memCopy(attrMask, _program.m_vsh->m_attrMask, sizeof(attrMask) );
 
+				// Attributes provided by instance data layout take precedence over vertex streams.
+				VertexLayout instanceLayout;
+				if (NULL != _instanceLayout)
+				{
+					bx::memCopy(&instanceLayout, _instanceLayout, sizeof(VertexLayout) );
+
+					for (uint32_t ii = 0; ii < Attrib::Count; ++ii)
+					{
+						if (0          != attrMask[ii]
+						&&  UINT16_MAX != instanceLayout.m_attributes[ii])
+						{
+							attrMask[ii] = 0;
+						}
+						else
+						{
+							instanceLayout.m_attributes[ii] = UINT16_MAX;
+						}
+					}
+				}
+
 				for (uint8_t stream = 0; stream < _numStreams; ++stream)
 				{
 					VertexLayout layout;
@@ -2721,6 +2756,20 @@ namespace bgfx { namespace d3d11
 					elem = fillVertexLayout(stream, elem, layout);
 				}
 
+				if (NULL != _instanceLayout)
+				{
+					D3D11_INPUT_ELEMENT_DESC* first = elem;
+					elem = fillVertexLayout(_numStreams, elem, instanceLayout);
+
+					BX_WARN(first != elem, "Instance data layout doesn't provide any attribute used by program.");
+
+					for (D3D11_INPUT_ELEMENT_DESC* curr = first; curr != elem; ++curr)
+					{
+						curr->InputSlotClass       = D3D11_INPUT_PER_INSTANCE_DATA;
+						curr->InstanceDataStepRate = 1;
+					}
+				}
+
 				uint32_t num = uint32_t(elem-vertexElements);
 
 				const D3D11_INPUT_ELEMENT_DESC inst = { "TEXCOORD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 };
@@ -3583,6 +3632,7 @@ namespace bgfx { namespace d3d11
 		ID3D11InfoQueue*           m_infoQueue;
 
 		TimerQueryD3D11     m_gpuTimer;
+		GpuTimerScopes<TimerQueryD3D11> m_gpuTimerScopes;
 		OcclusionQueryD3D11 m_occlusionQuery;
 
 		uint32_t m_deviceInterfaceVersion;
@@ -5665,6 +5715,8 @@ namespace bgfx { namespace d3d11
 			, m_timerQuerySupport
 			);
 
+		m_gpuTimerScopes.begin(_render, m_timerQuerySupport ? &m_gpuTimer : NULL, BGFX_CONFIG_MAX_VIEWS+1);
+
 		m_occlusionQuery.resolve(_render);
 
 		if (0 == (_render->m_debug&BGFX_DEBUG_IFH) )
@@ -5678,6 +5730,8 @@ namespace bgfx { namespace d3d11
 
 			for (int32_t item = 0; item < numItems;)
 			{
+				m_gpuTimerScopes.update(item);
+
 				const uint64_t encodedKey = _render->m_sortKeys[item];
 				const bool isCompute = key.decode(encodedKey, _render->m_viewRemap);
 				statsKeyType[isCompute]++;
@@ -6208,6 +6262,16 @@ namespace bgfx { namespace d3d11
 					currentState.m_instanceDataBuffer.idx = draw.m_instanceDataBuffer.idx;
 					currentState.m_instanceDataOffset     = draw.m_instanceDataOffset;
 					currentState.m_instanceDataStride     = draw.m_instanceDataStride;
+					currentState.m_instanceDataLayout.idx = draw.m_instanceDataLayout.idx;
+
+					const VertexLayout* instanceLayout = isValid(draw.m_instanceDataLayout)
+						? &m_vertexLayouts[draw.m_instanceDataLayout.idx]
+						: NULL
+						;
+					const uint16_t numInstanceData = NULL == instanceLayout
+						? uint16_t(draw.m_instanceDataStride/16)
+						: 0
+						;
 
 					ID3D11Buffer* buffers[BGFX_CONFIG_MAX_VERTEX_STREAMS];
 					uint32_t strides[BGFX_CONFIG_MAX_VERTEX_STREAMS];
@@ -6262,9 +6326,9 @@ namespace bgfx { namespace d3d11
 						if (isValid(draw.m_instanceDataBuffer) )
 						{
 							const VertexBufferD3D11& inst = m_vertexBuffers[draw.m_instanceDataBuffer.idx];
-							const uint32_t instStride = draw.m_instanceDataStride;
+							const uint32_t instStride = NULL != instanceLayout ? instanceLayout->m_stride : draw.m_instanceDataStride;
 							deviceCtx->IASetVertexBuffers(numStreams, 1, &inst.m_ptr, &instStride, &draw.m_instanceDataOffset);
-							setInputLayout(numStreams, layouts, m_program[currentProgram.idx], uint16_t(instStride/16) );
+							setInputLayout(numStreams, layouts, m_program[currentProgram.idx], numInstanceData, instanceLayout);
 						}
 						else
 						{
@@ -6279,9 +6343,9 @@ namespace bgfx { namespace d3d11
 						if (isValid(draw.m_instanceDataBuffer) )
 						{
 							const VertexBufferD3D11& inst = m_vertexBuffers[draw.m_instanceDataBuffer.idx];
-							const uint32_t instStride = draw.m_instanceDataStride;
+							const uint32_t instStride = NULL != instanceLayout ? instanceLayout->m_stride : draw.m_instanceDataStride;
 							deviceCtx->IASetVertexBuffers(0, 1, &inst.m_ptr, &instStride, &draw.m_instanceDataOffset);
-							setInputLayout(0, NULL, m_program[currentProgram.idx], uint16_t(instStride/16) );
+							setInputLayout(0, NULL, m_program[currentProgram.idx], numInstanceData, instanceLayout);
 						}
 						else
 						{
@@ -6450,6 +6514,8 @@ namespace bgfx { namespace d3d11
 				}
 			}
 
+			m_gpuTimerScopes.update(numItems);
+
 			if (wasCompute)
 			{
 				setViewType(view, "C");
@@ -6476,6 +6542,8 @@ namespace bgfx { namespace d3d11
 			}
 		}
 
+		m_gpuTimerScopes.end();
+
 		BGFX_D3D11_PROFILER_END();
 
 		int64_t timeEnd = bx::getHPCounter();
@@ -405,9 +405,9 @@ namespace bgfx { namespace d3d11
 			uint32_t m_frameNum;
 		};
 
-		Result m_result[BGFX_CONFIG_MAX_VIEWS+1];
+		Result m_result[BGFX_CONFIG_MAX_VIEWS+1+BGFX_CONFIG_MAX_GPU_TIMERS];
 
-		Query m_query[BGFX_CONFIG_MAX_VIEWS*4];
+		Query m_query[(BGFX_CONFIG_MAX_VIEWS+BGFX_CONFIG_MAX_GPU_TIMERS)*4];
 		bx::RingBufferControl m_control;
 	};
 
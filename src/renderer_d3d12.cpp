@@ -1353,6 +1353,7 @@ namespace bgfx { namespace d3d12
 					| BGFX_CAPS_TEXTURE_COMPARE_ALL
 					| BGFX_CAPS_INDEX32
 					| BGFX_CAPS_INSTANCING
+					| BGFX_CAPS_INSTANCING_LAYOUT
 					| BGFX_CAPS_DRAW_INDIRECT
 					| BGFX_CAPS_VERTEX_ATTRIB_HALF
 					| BGFX_CAPS_VERTEX_ATTRIB_UINT10
@@ -1712,6 +1713,13 @@ namespace bgfx { namespace d3d12
 			return m_lost;
 		}
 
+		bool isThreadSafe(CommandBuffer::Enum _command) const override
+		{
+			// Shader creation only parses bytecode and reads uniform registry, pipeline state
+			// objects are created on render thread.
+			return CommandBuffer::CreateShader == _command;
+		}
+
 		void flip() override
 		{
 			if (!m_lost)
@@ -2877,13 +2885,33 @@ namespace bgfx { namespace d3d12
 			_desc.BackFace.StencilFunc         = s_cmpFunc[(bstencil&BGFX_STENCIL_TEST_MASK) >> BGFX_STENCIL_TEST_SHIFT];
 		}
 
-		uint32_t setInputLayout(D3D12_INPUT_ELEMENT_DESC* _vertexElements, uint8_t _numStreams, const VertexLayout** _layouts, const ProgramD3D12& _program, uint16_t _numInstanceData)
+		uint32_t setInputLayout(D3D12_INPUT_ELEMENT_DESC* _vertexElements, uint8_t _numStreams, const VertexLayout** _layouts, const ProgramD3D12& _program, uint16_t _numInstanceData, const VertexLayout* _instanceLayout = NULL)
 		{
 			uint16_t attrMask[Attrib::Count];
 			bx::memCopy(attrMask, _program.m_vsh->m_attrMask, sizeof(attrMask));
 
 			D3D12_INPUT_ELEMENT_DESC* elem = _vertexElements;
 
+			// Attributes provided by instance data layout take precedence over vertex streams.
+			VertexLayout instanceLayout;
+			if (NULL != _instanceLayout)
+			{
+				bx::memCopy(&instanceLayout, _instanceLayout, sizeof(VertexLayout) );
+
+				for (uint32_t ii = 0; ii < Attrib::Count; ++ii)
+				{
+					if (0          != attrMask[ii]
+					&&  UINT16_MAX != instanceLayout.m_attributes[ii])
+					{
+						attrMask[ii] = 0;
+					}
+					else
+					{
+						instanceLayout.m_attributes[ii] = UINT16_MAX;
+					}
+				}
+			}
+
 			for (uint8_t stream = 0; stream < _numStreams; ++stream)
 			{
 				VertexLayout layout;
@@ -2909,6 +2937,20 @@ namespace bgfx { namespace d3d12
 				elem = fillVertexLayout(stream, elem, layout);
 			}
 
+			if (NULL != _instanceLayout)
+			{
+				D3D12_INPUT_ELEMENT_DESC* first = elem;
+				elem = fillVertexLayout(_numStreams, elem, instanceLayout);
+
+				BX_WARN(first != elem, "Instance data layout doesn't provide any attribute used by program.");
+
+				for (D3D12_INPUT_ELEMENT_DESC* curr = first; curr != elem; ++curr)
+				{
+					curr->InputSlotClass       = D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA;
+					curr->InstanceDataStepRate = 1;
+				}
+			}
+
 			uint32_t num = uint32_t(elem-_vertexElements);
 
 			const D3D12_INPUT_ELEMENT_DESC inst = { "TEXCOORD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 };
@@ -3068,6 +3110,7 @@ namespace bgfx { namespace d3d12
 			, const VertexLayout** _layouts
 			, ProgramHandle _program
 			, uint8_t _numInstanceData
+			, const VertexLayout* _instanceLayout = NULL
 			)
 		{
 			ProgramD3D12& program = m_program[_program.idx];
@@ -3125,6 +3168,12 @@ namespace bgfx { namespace d3d12
 			murmur.add(layout.m_attributes, sizeof(layout.m_attributes) );
 			murmur.add(m_fbh.idx);
 			murmur.add(_numInstanceData);
+
+			if (NULL != _instanceLayout)
+			{
+				murmur.add(_instanceLayout->m_hash);
+			}
+
 			const uint32_t hash = murmur.end();
 
 			ID3D12PipelineState* pso = m_pipelineStateCache.find(hash);
@@ -3238,7 +3287,7 @@ namespace bgfx { namespace d3d12
 			setDepthStencilState(desc.DepthStencilState, _state, _stencil);
 
 			D3D12_INPUT_ELEMENT_DESC vertexElements[Attrib::Count + 1 + BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT];
-			desc.InputLayout.NumElements = setInputLayout(vertexElements, _numStreams, _layouts, program, _numInstanceData);
+			desc.InputLayout.NumElements = setInputLayout(vertexElements, _numStreams, _layouts, program, _numInstanceData, _instanceLayout);
 			desc.InputLayout.pInputElementDescs = 0 == desc.InputLayout.NumElements
 				? NULL
 				: vertexElements
@@ -3594,6 +3643,7 @@ namespace bgfx { namespace d3d12
 
 		ID3D12Device*       m_device;
 		TimerQueryD3D12     m_gpuTimer;
+		GpuTimerScopes<TimerQueryD3D12> m_gpuTimerScopes;
 		OcclusionQueryD3D12 m_occlusionQuery;
 
 		uint32_t m_deviceInterfaceVersion;
@@ -4273,6 +4323,14 @@ namespace bgfx { namespace d3d12
 		return numStreams;
 	}
 
+	static uint32_t getInstanceDataStride(const RenderDraw& _draw)
+	{
+		return isValid(_draw.m_instanceDataLayout)
+			? s_renderD3D12->m_vertexLayouts[_draw.m_instanceDataLayout.idx].m_stride
+			: _draw.m_instanceDataStride
+			;
+	}
+
 	uint32_t BatchD3D12::draw(ID3D12GraphicsCommandList* _commandList, D3D12_GPU_VIRTUAL_ADDRESS _cbv, const RenderDraw& _draw)
 	{
 		if (isValid(_draw.m_indirectBuffer) )
@@ -4290,8 +4348,8 @@ namespace bgfx { namespace d3d12
 				inst.setState(_commandList, D3D12_RESOURCE_STATE_GENERIC_READ);
 				D3D12_VERTEX_BUFFER_VIEW& vbv = vbvs[numStreams++];
 				vbv.BufferLocation = inst.m_gpuVA + _draw.m_instanceDataOffset;
-				vbv.StrideInBytes  = _draw.m_instanceDataStride;
-				vbv.SizeInBytes    = _draw.m_numInstances * _draw.m_instanceDataStride;
+				vbv.StrideInBytes  = getInstanceDataStride(_draw);
+				vbv.SizeInBytes    = _draw.m_numInstances * vbv.StrideInBytes;
 			}
 
 			_commandList->IASetVertexBuffers(0
@@ -4379,8 +4437,8 @@ namespace bgfx { namespace d3d12
 				inst.setState(_commandList, D3D12_RESOURCE_STATE_GENERIC_READ);
 				D3D12_VERTEX_BUFFER_VIEW& vbv = cmd.vbv[numStreams++];
 				vbv.BufferLocation = inst.m_gpuVA + _draw.m_instanceDataOffset;
-				vbv.StrideInBytes  = _draw.m_instanceDataStride;
-				vbv.SizeInBytes    = _draw.m_numInstances * _draw.m_instanceDataStride;
+				vbv.StrideInBytes  = getInstanceDataStride(_draw);
+				vbv.SizeInBytes    = _draw.m_numInstances * vbv.StrideInBytes;
 			}
 
 			for (; numStreams < BX_COUNTOF(cmd.vbv); ++numStreams)
@@ -4423,8 +4481,8 @@ namespace bgfx { namespace d3d12
 				inst.setState(_commandList, D3D12_RESOURCE_STATE_GENERIC_READ);
 				D3D12_VERTEX_BUFFER_VIEW& vbv = cmd.vbv[numStreams++];
 				vbv.BufferLocation = inst.m_gpuVA + _draw.m_instanceDataOffset;
-				vbv.StrideInBytes  = _draw.m_instanceDataStride;
-				vbv.SizeInBytes    = _draw.m_numInstances * _draw.m_instanceDataStride;
+				vbv.StrideInBytes  = getInstanceDataStride(_draw);
+				vbv.SizeInBytes    = _draw.m_numInstances * vbv.StrideInBytes;
 			}
 
 			for (; numStreams < BX_COUNTOF(cmd.vbv); ++numStreams)
@@ -6437,6 +6495,8 @@ namespace bgfx { namespace d3d12
 			, s_viewName
 			);
 
+		m_gpuTimerScopes.begin(_render, &m_gpuTimer, BGFX_CONFIG_MAX_VIEWS+1);
+
 #if BX_PLATFORM_WINDOWS
 		if (NULL != m_swapChain)
 		{
@@ -6497,6 +6557,13 @@ namespace bgfx { namespace d3d12
 
 			for (int32_t item = 0; item < numItems;)
 			{
+				if (m_gpuTimerScopes.hasEvent(item) )
+				{
+					// Batched draws must be recorded before timestamp.
+					m_batch.flush(m_commandList);
+					m_gpuTimerScopes.update(item);
+				}
+
 				const uint64_t encodedKey = _render->m_sortKeys[item];
 				const bool isCompute = key.decode(encodedKey, _render->m_viewRemap);
 				statsKeyType[isCompute]++;
@@ -6861,6 +6928,7 @@ namespace bgfx { namespace d3d12
 					currentState.m_instanceDataBuffer.idx = draw.m_instanceDataBuffer.idx;
 					currentState.m_instanceDataOffset     = draw.m_instanceDataOffset;
 					currentState.m_instanceDataStride     = draw.m_instanceDataStride;
+					currentState.m_instanceDataLayout.idx = draw.m_instanceDataLayout.idx;
 
 					const uint64_t state = draw.m_stateFlags;
 					bool hasFactor = 0
@@ -6899,13 +6967,19 @@ namespace bgfx { namespace d3d12
 						}
 					}
 
+					const VertexLayout* instanceLayout = isValid(draw.m_instanceDataLayout)
+						? &m_vertexLayouts[draw.m_instanceDataLayout.idx]
+						: NULL
+						;
+
 					ID3D12PipelineState* pso = getPipelineState(
 						  state
 						, draw.m_stencil
 						, numStreams
 						, layouts
 						, key.m_program
-						, uint8_t(draw.m_instanceDataStride/16)
+						, NULL == instanceLayout ? uint8_t(draw.m_instanceDataStride/16) : 0
+						, instanceLayout
 						);
 
 					const uint32_t bindHash = bx::hash<bx::HashMurmur2A>(renderBind.m_bind, sizeof(renderBind.m_bind) );
@@ -7160,6 +7234,7 @@ namespace bgfx { namespace d3d12
 			}
 
 			m_batch.end(m_commandList);
+			m_gpuTimerScopes.update(numItems);
 			kick();
 
 			if (wasCompute)
@@ -7186,6 +7261,8 @@ namespace bgfx { namespace d3d12
 			}
 		}
 
+		m_gpuTimerScopes.end();
+
 		BGFX_D3D12_PROFILER_END();
 
 		int64_t timeEnd   = bx::getHPCounter();
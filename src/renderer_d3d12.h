@@ -547,8 +547,8 @@ namespace bgfx { namespace d3d12
 
 		uint64_t m_frequency;
 
-		Result m_result[BGFX_CONFIG_MAX_VIEWS+1];
-		Query m_query[BGFX_CONFIG_MAX_VIEWS*4];
+		Result m_result[BGFX_CONFIG_MAX_VIEWS+1+BGFX_CONFIG_MAX_GPU_TIMERS];
+		Query m_query[(BGFX_CONFIG_MAX_VIEWS+BGFX_CONFIG_MAX_GPU_TIMERS)*4];
 
 		ID3D12Resource*  m_readback;
 		ID3D12QueryHeap* m_queryHeap;
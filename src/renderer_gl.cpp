@@ -546,8 +546,10 @@ namespace bgfx { namespace gl
 			APPLE_texture_format_BGRA8888,
 			APPLE_texture_max_level,
 
+			ARB_buffer_storage,
 			ARB_clip_control,
 			ARB_compute_shader,
+			ARB_conditional_render_inverted,
 			ARB_conservative_depth,
 			ARB_copy_image,
 			ARB_debug_label,
@@ -582,6 +584,7 @@ namespace bgfx { namespace gl
 			ARB_shader_storage_buffer_object,
 			ARB_shader_texture_lod,
 			ARB_shader_viewport_layer_array,
+			ARB_sync,
 			ARB_texture_compression_bptc,
 			ARB_texture_compression_rgtc,
 			ARB_texture_cube_map_array,
@@ -595,6 +598,7 @@ namespace bgfx { namespace gl
 			ARB_timer_query,
 			ARB_uniform_buffer_object,
 			ARB_vertex_array_object,
+			ARB_vertex_attrib_binding,
 			ARB_vertex_type_2_10_10_10_rev,
 
 			ATI_meminfo,
@@ -610,6 +614,7 @@ namespace bgfx { namespace gl
 			EXT_blend_color,
 			EXT_blend_minmax,
 			EXT_blend_subtract,
+			EXT_buffer_storage,
 			EXT_color_buffer_half_float,
 			EXT_color_buffer_float,
 			EXT_copy_image,
@@ -672,6 +677,7 @@ namespace bgfx { namespace gl
 			MOZ_WEBGL_compressed_texture_s3tc,
 			MOZ_WEBGL_depth_texture,
 
+			NV_conditional_render,
 			NV_conservative_raster,
 			NV_copy_image,
 			NV_draw_buffers,
@@ -764,8 +770,10 @@ namespace bgfx { namespace gl
 		{ "APPLE_texture_format_BGRA8888",            false,                             true  },
 		{ "APPLE_texture_max_level",                  false,                             true  },
 
+		{ "ARB_buffer_storage",                       BGFX_CONFIG_RENDERER_OPENGL >= 44, true  },
 		{ "ARB_clip_control",                         BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
 		{ "ARB_compute_shader",                       BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
+		{ "ARB_conditional_render_inverted",          BGFX_CONFIG_RENDERER_OPENGL >= 45, true  },
 		{ "ARB_conservative_depth",                   BGFX_CONFIG_RENDERER_OPENGL >= 42, true  },
 		{ "ARB_copy_image",                           BGFX_CONFIG_RENDERER_OPENGL >= 42, true  },
 		{ "ARB_debug_label",                          false,                             true  },
@@ -800,6 +808,7 @@ namespace bgfx { namespace gl
 		{ "ARB_shader_storage_buffer_object",         BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
 		{ "ARB_shader_texture_lod",                   BGFX_CONFIG_RENDERER_OPENGL >= 30, true  },
 		{ "ARB_shader_viewport_layer_array",          false,                             true  },
+		{ "ARB_sync",                                 BGFX_CONFIG_RENDERER_OPENGL >= 32, true  },
 		{ "ARB_texture_compression_bptc",             BGFX_CONFIG_RENDERER_OPENGL >= 44, true  },
 		{ "ARB_texture_compression_rgtc",             BGFX_CONFIG_RENDERER_OPENGL >= 30, true  },
 		{ "ARB_texture_cube_map_array",               BGFX_CONFIG_RENDERER_OPENGL >= 40, true  },
@@ -813,6 +822,7 @@ namespace bgfx { namespace gl
 		{ "ARB_timer_query",                          BGFX_CONFIG_RENDERER_OPENGL >= 33, true  },
 		{ "ARB_uniform_buffer_object",                BGFX_CONFIG_RENDERER_OPENGL >= 31, true  },
 		{ "ARB_vertex_array_object",                  BGFX_CONFIG_RENDERER_OPENGL >= 30, true  },
+		{ "ARB_vertex_attrib_binding",                BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
 		{ "ARB_vertex_type_2_10_10_10_rev",           false,                             true  },
 
 		{ "ATI_meminfo",                              false,                             true  },
@@ -828,6 +838,7 @@ namespace bgfx { namespace gl
 		{ "EXT_blend_color",                          BGFX_CONFIG_RENDERER_OPENGL >= 31, true  },
 		{ "EXT_blend_minmax",                         BGFX_CONFIG_RENDERER_OPENGL >= 14, true  },
 		{ "EXT_blend_subtract",                       BGFX_CONFIG_RENDERER_OPENGL >= 14, true  },
+		{ "EXT_buffer_storage",                       false,                             true  }, // GLES3.1 extension.
 		{ "EXT_color_buffer_half_float",              false,                             true  }, // GLES2 extension.
 		{ "EXT_color_buffer_float",                   false,                             true  }, // GLES2 extension.
 		{ "EXT_copy_image",                           false,                             true  }, // GLES2 extension.
@@ -890,6 +901,7 @@ namespace bgfx { namespace gl
 		{ "MOZ_WEBGL_compressed_texture_s3tc",        false,                             true  },
 		{ "MOZ_WEBGL_depth_texture",                  false,                             true  },
 
+		{ "NV_conditional_render",                    BGFX_CONFIG_RENDERER_OPENGL >= 30, true  },
 		{ "NV_conservative_raster",                   false,                             true  },
 		{ "NV_copy_image",                            false,                             true  },
 		{ "NV_draw_buffers",                          false,                             true  }, // GLES2 extension.
@@ -1281,6 +1293,20 @@ namespace bgfx { namespace gl
 		s_vertexAttribArraysPendingEnable    = 0;
 	}
 
+	uint64_t getLazyEnabledVertexAttributes()
+	{
+		return s_currentlyEnabledVertexAttribArrays;
+	}
+
+	void setLazyEnabledVertexAttributes(uint64_t _enabled)
+	{
+		// Enabled attributes are vertex array object state, tracking is switched
+		// together with vertex array object.
+		s_currentlyEnabledVertexAttribArrays = _enabled;
+		s_vertexAttribArraysPendingDisable   = 0;
+		s_vertexAttribArraysPendingEnable    = 0;
+	}
+
 	void lazyEnableVertexAttribArray(GLuint index)
 	{
 		if (BX_ENABLED(BX_PLATFORM_EMSCRIPTEN) )
@@ -1379,11 +1405,7 @@ namespace bgfx { namespace gl
 		, const GLvoid* _data
 	)
 	{
-		if (NULL == _data)
-		{
-			return;
-		}
-
+		// _data can be NULL when it's offset 0 into bound pixel unpack buffer.
 		if (_target == GL_TEXTURE_3D
 		||  _target == GL_TEXTURE_2D_ARRAY
 		||  _target == GL_TEXTURE_CUBE_MAP_ARRAY)
@@ -1454,19 +1476,22 @@ namespace bgfx { namespace gl
 		else if (_target == GL_TEXTURE_2D_ARRAY
 			 ||  _target == GL_TEXTURE_CUBE_MAP_ARRAY)
 		{
-			texSubImage(
-				  _target
-				, _level
-				, 0
-				, 0
-				, _depth
-				, _width
-				, _height
-				, 1
-				, _format
-				, _type
-				, _data
-				);
+			if (NULL != _data)
+			{
+				texSubImage(
+					  _target
+					, _level
+					, 0
+					, 0
+					, _depth
+					, _width
+					, _height
+					, 1
+					, _format
+					, _type
+					, _data
+					);
+			}
 		}
 		else if (_target == GL_TEXTURE_2D_MULTISAMPLE_ARRAY)
 		{
@@ -2223,6 +2248,8 @@ namespace bgfx { namespace gl
 	{
 		RendererContextGL()
 			: m_numWindows(1)
+			, m_currentProgram(NULL)
+			, m_numUniformsSkipped(0)
 			, m_rtMsaa(false)
 			, m_fbDiscard(BGFX_CLEAR_NONE)
 			, m_capture(NULL)
@@ -2231,9 +2258,12 @@ namespace bgfx { namespace gl
 			, m_maxAnisotropyDefault(0.0f)
 			, m_maxMsaa(0)
 			, m_vao(0)
+			, m_vaoEnabledAttribs(0)
 			, m_blitSupported(false)
 			, m_readBackSupported(BX_ENABLED(BGFX_CONFIG_RENDERER_OPENGL) )
 			, m_vaoSupport(false)
+			, m_vaoCacheEnabled(false)
+			, m_vertexAttribBindingSupport(false)
 			, m_samplerObjectSupport(false)
 			, m_shadowSamplersSupport(false)
 			, m_srgbWriteControlSupport(BX_ENABLED(BGFX_CONFIG_RENDERER_OPENGL) )
@@ -2243,8 +2273,11 @@ namespace bgfx { namespace gl
 			, m_depthTextureSupport(false)
 			, m_timerQuerySupport(false)
 			, m_occlusionQuerySupport(false)
+			, m_conditionalRenderSupport(false)
+			, m_conditionalRenderInvertedSupport(false)
 			, m_atocSupport(false)
 			, m_conservativeRasterSupport(false)
+			, m_uploadRingSupport(false)
 			, m_flip(false)
 			, m_hash( (BX_PLATFORM_WINDOWS<<1) | BX_ARCH_64BIT)
 			, m_backBufferFbo(0)
@@ -2959,6 +2992,19 @@ namespace bgfx { namespace gl
 					GL_CHECK(glBindVertexArray(m_vao) );
 				}
 
+				m_vaoCacheEnabled = m_vaoSupport;
+
+				m_vertexAttribBindingSupport = m_vaoSupport
+					&& (!!(BGFX_CONFIG_RENDERER_OPENGLES >= 31)
+						|| s_extension[Extension::ARB_vertex_attrib_binding].m_supported
+						)
+					&& NULL != glBindVertexBuffer
+					&& NULL != glVertexAttribBinding
+					&& NULL != glVertexAttribFormat
+					&& NULL != glVertexAttribIFormat
+					&& NULL != glVertexBindingDivisor
+					;
+
 				m_samplerObjectSupport = false
 					|| m_gles3
 					|| s_extension[Extension::ARB_sampler_objects].m_supported
@@ -3017,6 +3063,18 @@ namespace bgfx { namespace gl
 					&& NULL != glEndQuery
 					;
 
+				m_conditionalRenderSupport = true
+					&& m_occlusionQuerySupport
+					&& s_extension[Extension::NV_conditional_render].m_supported
+					&& NULL != glBeginConditionalRender
+					&& NULL != glEndConditionalRender
+					;
+
+				m_conditionalRenderInvertedSupport = true
+					&& m_conditionalRenderSupport
+					&& s_extension[Extension::ARB_conditional_render_inverted].m_supported
+					;
+
 				m_atocSupport = s_extension[Extension::ARB_multisample].m_supported;
 				m_conservativeRasterSupport = s_extension[Extension::NV_conservative_raster].m_supported;
 
@@ -3025,10 +3083,25 @@ namespace bgfx { namespace gl
 					|| s_extension[Extension::EXT_shader_image_load_store].m_supported
 					;
 
+				m_uploadRingSupport = true
+					&& 0 < BGFX_GL_CONFIG_UPLOAD_BUFFER_SIZE
+					&& (false
+						|| s_extension[Extension::ARB_buffer_storage].m_supported
+						|| s_extension[Extension::EXT_buffer_storage].m_supported
+						)
+					&& NULL != glBufferStorage
+					&& NULL != glMapBufferRange
+					&& NULL != glUnmapBuffer
+					&& NULL != glFenceSync
+					&& NULL != glClientWaitSync
+					&& NULL != glDeleteSync
+					;
+
 				g_caps.supported |= 0
 					| (m_atocSupport               ? BGFX_CAPS_ALPHA_TO_COVERAGE      : 0)
 					| (m_conservativeRasterSupport ? BGFX_CAPS_CONSERVATIVE_RASTER    : 0)
 					| (m_occlusionQuerySupport     ? BGFX_CAPS_OCCLUSION_QUERY        : 0)
+					| (m_conditionalRenderSupport  ? BGFX_CAPS_CONDITIONAL_RENDER     : 0)
 					| (m_depthTextureSupport       ? BGFX_CAPS_TEXTURE_COMPARE_LEQUAL : 0)
 					| (computeSupport              ? BGFX_CAPS_COMPUTE                : 0)
 					| (m_imageLoadStoreSupport     ? BGFX_CAPS_IMAGE_RW               : 0)
@@ -3113,6 +3186,11 @@ namespace bgfx { namespace gl
 					}
 				}
 
+				g_caps.supported |= 0 != (g_caps.supported & BGFX_CAPS_INSTANCING)
+					? BGFX_CAPS_INSTANCING_LAYOUT
+					: 0
+					;
+
 				g_caps.supported |= s_extension[Extension::ARB_shader_viewport_layer_array].m_supported
 					? BGFX_CAPS_VIEWPORT_LAYER_ARRAY
 					: 0
@@ -3192,6 +3270,11 @@ namespace bgfx { namespace gl
 					m_occlusionQuery.create();
 				}
 
+				if (m_uploadRingSupport)
+				{
+					m_uploadRingSupport = m_uploadRing.create(BGFX_GL_CONFIG_UPLOAD_BUFFER_SIZE);
+				}
+
 				// Init reserved part of view name.
 				for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
 				{
@@ -3223,6 +3306,8 @@ namespace bgfx { namespace gl
 				GL_CHECK(glBindVertexArray(0) );
 				GL_CHECK(glDeleteVertexArrays(1, &m_vao) );
 				m_vao = 0;
+
+				m_vaoStateCache.invalidate();
 			}
 
 			captureFinish();
@@ -3239,6 +3324,11 @@ namespace bgfx { namespace gl
 				m_occlusionQuery.destroy();
 			}
 
+			if (m_uploadRingSupport)
+			{
+				m_uploadRing.destroy();
+			}
+
 			destroyMsaaFbo();
 			m_glctx.destroy();
 
@@ -3267,6 +3357,11 @@ namespace bgfx { namespace gl
 			return false;
 		}
 
+		bool isThreadSafe(CommandBuffer::Enum /*_command*/) const override
+		{
+			return false;
+		}
+
 		void flip() override
 		{
 			if (m_flip)
@@ -3687,7 +3782,7 @@ namespace bgfx { namespace gl
 			GL_CHECK(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE) );
 
 			ProgramGL& program = m_program[_blitter.m_program.idx];
-			setProgram(program.m_id);
+			setProgram(&program);
 			setUniform1i(program.m_sampler[0], 0);
 
 			float proj[16];
@@ -3822,6 +3917,7 @@ namespace bgfx { namespace gl
 			}
 
 			m_glctx.makeCurrent(NULL);
+			m_vaoCacheEnabled = m_vaoSupport;
 
 			if (!isValid(_fbh) )
 			{
@@ -3835,6 +3931,11 @@ namespace bgfx { namespace gl
 				_height = frameBuffer.m_height;
 				if (UINT16_MAX != frameBuffer.m_denseIdx)
 				{
+					// Vertex array objects are not shared between contexts. Cached ones
+					// belong to main context and stay valid, they are just not used
+					// while swap chain context is current.
+					m_vaoCacheEnabled = false;
+
 					m_glctx.makeCurrent(frameBuffer.m_swapChain);
 					GL_CHECK(glFrontFace(GL_CW) );
 
@@ -4125,6 +4226,9 @@ namespace bgfx { namespace gl
 
 				if (m_gles3)
 				{
+					// Blit program has no uniform shadow, unbind shadow of previously
+					// used program so that its uniforms are not skipped later.
+					m_currentProgram = NULL;
 					GL_CHECK(glUseProgram(m_msaaBlitProgram) );
 					GL_CHECK(glActiveTexture(GL_TEXTURE0) );
 					GL_CHECK(glBindTexture(GL_TEXTURE_2D, m_msaaBackBufferTextures[0]) );
@@ -4179,6 +4283,257 @@ namespace bgfx { namespace gl
 			}
 		}
 
+		void invalidateVaoCache(VaoCacheRef& _vcref)
+		{
+			// Cached vertex array objects are owned by main context.
+			m_glctx.makeCurrent(NULL);
+			_vcref.invalidate(m_vaoStateCache);
+		}
+
+		void restoreVertexArray()
+		{
+			GL_CHECK(glBindVertexArray(m_vao) );
+			setLazyEnabledVertexAttributes(m_vaoEnabledAttribs);
+		}
+
+		GLuint setVertexArray(ProgramHandle _program, const RenderDraw& _draw, GLuint _currentVao)
+		{
+			ProgramGL& program = m_program[_program.idx];
+			const uint8_t streamMask = UINT8_MAX != _draw.m_streamMask ? _draw.m_streamMask : 0;
+
+			if (0 == _currentVao)
+			{
+				m_vaoEnabledAttribs = getLazyEnabledVertexAttributes();
+			}
+
+			// With vertex attrib binding, vertex array object holds only attribute formats, and
+			// buffers are bound per draw. Otherwise buffers are part of the key. Offsets are never
+			// part of the key, transient and dynamic buffers change them every frame.
+			VaoKey key;
+			key.clear();
+			key.m_program      = _program.idx;
+			key.m_streamMask   = streamMask;
+			key.m_instanceData = isValid(_draw.m_instanceDataBuffer);
+
+			for (uint32_t idx = 0, mask = streamMask
+				; 0 != mask
+				; mask >>= 1, idx += 1
+				)
+			{
+				const uint32_t ntz = bx::uint32_cnttz(mask);
+				mask >>= ntz;
+				idx  += ntz;
+
+				const Stream& stream = _draw.m_stream[idx];
+				const uint16_t decl = isValid(stream.m_layoutHandle)
+					? stream.m_layoutHandle.idx
+					: m_vertexBuffers[stream.m_handle.idx].m_layoutHandle.idx;
+				key.m_layoutHash[idx] = m_vertexLayouts[decl].m_hash;
+
+				if (!m_vertexAttribBindingSupport)
+				{
+					key.m_stream[idx] = stream.m_handle.idx;
+				}
+			}
+
+			if (isValid(_draw.m_instanceDataLayout) )
+			{
+				key.m_layoutHash[BGFX_CONFIG_MAX_VERTEX_STREAMS] = m_vertexLayouts[_draw.m_instanceDataLayout.idx].m_hash;
+			}
+
+			if (!m_vertexAttribBindingSupport)
+			{
+				key.m_instanceDataBuffer = _draw.m_instanceDataBuffer.idx;
+				key.m_indexBuffer        = _draw.m_indexBuffer.idx;
+			}
+
+			const uint32_t hash = bx::hash<bx::HashMurmur2A>(&key, sizeof(key) );
+
+			VaoGL* vao = m_vaoStateCache.find(hash, key);
+			if (NULL == vao)
+			{
+				vao = m_vaoStateCache.add(hash, key);
+				m_vaoStateCache.addRef(vao, hash, program.m_vcref);
+
+				// New vertex array object has all attributes disabled.
+				setLazyEnabledVertexAttributes(0);
+
+				if (m_vertexAttribBindingSupport)
+				{
+					for (uint32_t idx = 0, mask = streamMask
+						; 0 != mask
+						; mask >>= 1, idx += 1
+						)
+					{
+						const uint32_t ntz = bx::uint32_cnttz(mask);
+						mask >>= ntz;
+						idx  += ntz;
+
+						const Stream& stream = _draw.m_stream[idx];
+						const uint16_t decl = isValid(stream.m_layoutHandle)
+							? stream.m_layoutHandle.idx
+							: m_vertexBuffers[stream.m_handle.idx].m_layoutHandle.idx;
+						program.bindAttributeFormat(m_vertexLayouts[decl], idx);
+					}
+
+					if (isValid(_draw.m_instanceDataLayout) )
+					{
+						program.bindAttributeFormat(m_vertexLayouts[_draw.m_instanceDataLayout.idx], BGFX_CONFIG_MAX_VERTEX_STREAMS);
+						GL_CHECK(glVertexBindingDivisor(BGFX_CONFIG_MAX_VERTEX_STREAMS, 1) );
+					}
+					else if (isValid(_draw.m_instanceDataBuffer) )
+					{
+						program.bindInstanceDataFormat(BGFX_CONFIG_MAX_VERTEX_STREAMS);
+					}
+				}
+				else
+				{
+					for (uint32_t idx = 0, mask = streamMask
+						; 0 != mask
+						; mask >>= 1, idx += 1
+						)
+					{
+						const uint32_t ntz = bx::uint32_cnttz(mask);
+						mask >>= ntz;
+						idx  += ntz;
+
+						m_vaoStateCache.addRef(vao, hash, m_vertexBuffers[_draw.m_stream[idx].m_handle.idx].m_vcref);
+					}
+
+					if (isValid(_draw.m_instanceDataBuffer) )
+					{
+						m_vaoStateCache.addRef(vao, hash, m_vertexBuffers[_draw.m_instanceDataBuffer.idx].m_vcref);
+					}
+
+					if (isValid(_draw.m_indexBuffer) )
+					{
+						IndexBufferGL& ib = m_indexBuffers[_draw.m_indexBuffer.idx];
+						m_vaoStateCache.addRef(vao, hash, ib.m_vcref);
+
+						GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ib.m_id) );
+					}
+				}
+			}
+			else if (vao->m_id != _currentVao)
+			{
+				GL_CHECK(glBindVertexArray(vao->m_id) );
+				setLazyEnabledVertexAttributes(vao->m_enabledAttribs);
+			}
+
+			if (m_vertexAttribBindingSupport)
+			{
+				for (uint32_t idx = 0, mask = streamMask
+					; 0 != mask
+					; mask >>= 1, idx += 1
+					)
+				{
+					const uint32_t ntz = bx::uint32_cnttz(mask);
+					mask >>= ntz;
+					idx  += ntz;
+
+					const Stream& stream = _draw.m_stream[idx];
+					const VertexBufferGL& vb = m_vertexBuffers[stream.m_handle.idx];
+					const uint16_t decl = isValid(stream.m_layoutHandle)
+						? stream.m_layoutHandle.idx
+						: vb.m_layoutHandle.idx;
+					const uint16_t stride = m_vertexLayouts[decl].m_stride;
+					GL_CHECK(glBindVertexBuffer(idx, vb.m_id, GLintptr(stream.m_startVertex)*stride, stride) );
+				}
+
+				if (isValid(_draw.m_instanceDataBuffer) )
+				{
+					const VertexBufferGL& vb = m_vertexBuffers[_draw.m_instanceDataBuffer.idx];
+					const uint16_t stride = isValid(_draw.m_instanceDataLayout)
+						? m_vertexLayouts[_draw.m_instanceDataLayout.idx].m_stride
+						: _draw.m_instanceDataStride
+						;
+					GL_CHECK(glBindVertexBuffer(BGFX_CONFIG_MAX_VERTEX_STREAMS
+						, vb.m_id
+						, _draw.m_instanceDataOffset
+						, stride
+						) );
+				}
+
+				const GLuint ibId = isValid(_draw.m_indexBuffer)
+					? m_indexBuffers[_draw.m_indexBuffer.idx].m_id
+					: 0
+					;
+				GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibId) );
+			}
+			else
+			{
+				// Attribute pointers include offsets, they are specified again only when
+				// offsets differ from the ones vertex array object was last used with.
+				bool bind = !vao->m_bound;
+
+				for (uint32_t idx = 0, mask = streamMask
+					; 0 != mask && !bind
+					; mask >>= 1, idx += 1
+					)
+				{
+					const uint32_t ntz = bx::uint32_cnttz(mask);
+					mask >>= ntz;
+					idx  += ntz;
+
+					bind = vao->m_startVertex[idx] != _draw.m_stream[idx].m_startVertex;
+				}
+
+				bind |= isValid(_draw.m_instanceDataBuffer)
+					&& (vao->m_instanceDataOffset != _draw.m_instanceDataOffset || vao->m_instanceDataStride != _draw.m_instanceDataStride)
+					;
+
+				if (bind)
+				{
+					program.bindAttributesBegin();
+
+					for (uint32_t idx = 0, mask = streamMask
+						; 0 != mask
+						; mask >>= 1, idx += 1
+						)
+					{
+						const uint32_t ntz = bx::uint32_cnttz(mask);
+						mask >>= ntz;
+						idx  += ntz;
+
+						const Stream& stream = _draw.m_stream[idx];
+						const VertexBufferGL& vb = m_vertexBuffers[stream.m_handle.idx];
+						const uint16_t decl = isValid(stream.m_layoutHandle)
+							? stream.m_layoutHandle.idx
+							: vb.m_layoutHandle.idx;
+						GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, vb.m_id) );
+						program.bindAttributes(m_vertexLayouts[decl], stream.m_startVertex);
+
+						vao->m_startVertex[idx] = stream.m_startVertex;
+					}
+
+					if (isValid(_draw.m_instanceDataBuffer) )
+					{
+						const VertexBufferGL& vb = m_vertexBuffers[_draw.m_instanceDataBuffer.idx];
+						GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, vb.m_id) );
+
+						if (isValid(_draw.m_instanceDataLayout) )
+						{
+							program.bindInstanceAttributes(m_vertexLayouts[_draw.m_instanceDataLayout.idx], _draw.m_instanceDataOffset);
+						}
+						else
+						{
+							program.bindInstanceData(_draw.m_instanceDataStride, _draw.m_instanceDataOffset);
+						}
+
+						vao->m_instanceDataOffset = _draw.m_instanceDataOffset;
+						vao->m_instanceDataStride = _draw.m_instanceDataStride;
+					}
+
+					program.bindAttributesEnd();
+
+					vao->m_enabledAttribs = getLazyEnabledVertexAttributes();
+					vao->m_bound          = true;
+				}
+			}
+
+			return vao->m_id;
+		}
+
 		void setSamplerState(uint32_t _stage, uint32_t _numMips, uint32_t _flags, const float _rgba[4])
 		{
 			BX_ASSERT(m_samplerObjectSupport, "Cannot use Sampler Objects");
@@ -4596,7 +4951,7 @@ namespace bgfx { namespace gl
 				GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, vb.m_id) );
 
 				ProgramGL& program = m_program[_clearQuad.m_program[numMrt-1].idx];
-				setProgram(program.m_id);
+				setProgram(&program);
 				program.bindAttributesBegin();
 				program.bindAttributes(layout, 0);
 				program.bindAttributesEnd();
@@ -4659,17 +5014,29 @@ namespace bgfx { namespace gl
 			}
 		}
 
-		void setProgram(GLuint program)
+		void setProgram(ProgramGL* _program)
 		{
-			m_uniformStateCache.saveCurrentProgram(program);
-			GL_CHECK(glUseProgram(program) );
+			m_currentProgram = _program;
+			GL_CHECK(glUseProgram(NULL == _program ? 0 : _program->m_id) );
+		}
+
+		// Skip uniform uploads when value is the same as one already stored
+		// in currently bound program.
+		bool updateUniformShadow(uint32_t _loc, const void* _data, uint32_t _size)
+		{
+			if (NULL == m_currentProgram
+			||  m_currentProgram->m_uniformShadow.update(GLint(_loc), _data, _size) )
+			{
+				return true;
+			}
+
+			++m_numUniformsSkipped;
+			return false;
 		}
 
-		// Cache uniform uploads to avoid redundant uploading of state that is
-		// already set to a shader program
 		void setUniform1i(uint32_t loc, int value)
 		{
-			if (m_uniformStateCache.updateUniformCache(loc, value) )
+			if (updateUniformShadow(loc, &value, sizeof(int) ) )
 			{
 				GL_CHECK(glUniform1i(loc, value) );
 			}
@@ -4677,15 +5044,7 @@ namespace bgfx { namespace gl
 
 		void setUniform1iv(uint32_t loc, int num, const int *data)
 		{
-			bool changed = false;
-			for(int i = 0; i < num; ++i)
-			{
-				if (m_uniformStateCache.updateUniformCache(loc+i, data[i]) )
-				{
-					changed = true;
-				}
-			}
-			if (changed)
+			if (updateUniformShadow(loc, data, num*sizeof(int) ) )
 			{
 				GL_CHECK(glUniform1iv(loc, num, data) );
 			}
@@ -4693,8 +5052,8 @@ namespace bgfx { namespace gl
 
 		void setUniform4f(uint32_t loc, float x, float y, float z, float w)
 		{
-			UniformStateCache::f4 f; f.val[0] = x; f.val[1] = y; f.val[2] = z; f.val[3] = w;
-			if (m_uniformStateCache.updateUniformCache(loc, f) )
+			const float data[4] = { x, y, z, w };
+			if (updateUniformShadow(loc, data, sizeof(data) ) )
 			{
 				GL_CHECK(glUniform4f(loc, x, y, z, w) );
 			}
@@ -4702,15 +5061,7 @@ namespace bgfx { namespace gl
 
 		void setUniform4fv(uint32_t loc, int num, const float *data)
 		{
-			bool changed = false;
-			for(int i = 0; i < num; ++i)
-			{
-				if (m_uniformStateCache.updateUniformCache(loc+i, *(const UniformStateCache::f4*)&data[4*i]) )
-				{
-					changed = true;
-				}
-			}
-			if (changed)
+			if (updateUniformShadow(loc, data, num*4*sizeof(float) ) )
 			{
 				GL_CHECK(glUniform4fv(loc, num, data) );
 			}
@@ -4718,15 +5069,7 @@ namespace bgfx { namespace gl
 
 		void setUniformMatrix3fv(uint32_t loc, int num, GLboolean transpose, const float *data)
 		{
-			bool changed = false;
-			for(int i = 0; i < num; ++i)
-			{
-				if (m_uniformStateCache.updateUniformCache(loc+i, *(const UniformStateCache::f3x3*)&data[9*i]) )
-				{
-					changed = true;
-				}
-			}
-			if (changed)
+			if (updateUniformShadow(loc, data, num*9*sizeof(float) ) )
 			{
 				GL_CHECK(glUniformMatrix3fv(loc, num, transpose, data) );
 			}
@@ -4734,15 +5077,7 @@ namespace bgfx { namespace gl
 
 		void setUniformMatrix4fv(uint32_t loc, int num, GLboolean transpose, const float *data)
 		{
-			bool changed = false;
-			for(int i = 0; i < num; ++i)
-			{
-				if (m_uniformStateCache.updateUniformCache(loc+i, *(const UniformStateCache::f4x4*)&data[16*i]) )
-				{
-					changed = true;
-				}
-			}
-			if (changed)
+			if (updateUniformShadow(loc, data, num*16*sizeof(float) ) )
 			{
 				GL_CHECK(glUniformMatrix4fv(loc, num, transpose, data) );
 			}
@@ -4764,10 +5099,14 @@ namespace bgfx { namespace gl
 		void* m_uniforms[BGFX_CONFIG_MAX_UNIFORMS];
 
 		TimerQueryGL m_gpuTimer;
+		GpuTimerScopes<TimerQueryGL> m_gpuTimerScopes;
 		OcclusionQueryGL m_occlusionQuery;
+		UploadRingGL m_uploadRing;
 
 		SamplerStateCache m_samplerStateCache;
-		UniformStateCache m_uniformStateCache;
+		VaoStateCache m_vaoStateCache;
+		ProgramGL* m_currentProgram;
+		uint32_t m_numUniformsSkipped;
 
 		TextVideoMem m_textVideoMem;
 		bool m_rtMsaa;
@@ -4782,10 +5121,13 @@ namespace bgfx { namespace gl
 		float m_maxAnisotropyDefault;
 		int32_t m_maxMsaa;
 		GLuint m_vao;
+		uint64_t m_vaoEnabledAttribs;
 		uint16_t m_maxLabelLen;
 		bool m_blitSupported;
 		bool m_readBackSupported;
 		bool m_vaoSupport;
+		bool m_vaoCacheEnabled;
+		bool m_vertexAttribBindingSupport;
 		bool m_samplerObjectSupport;
 		bool m_shadowSamplersSupport;
 		bool m_srgbWriteControlSupport;
@@ -4795,9 +5137,12 @@ namespace bgfx { namespace gl
 		bool m_depthTextureSupport;
 		bool m_timerQuerySupport;
 		bool m_occlusionQuerySupport;
+		bool m_conditionalRenderSupport;
+		bool m_conditionalRenderInvertedSupport;
 		bool m_atocSupport;
 		bool m_conservativeRasterSupport;
 		bool m_imageLoadStoreSupport;
+		bool m_uploadRingSupport;
 		bool m_flip;
 
 		uint64_t m_hash;
@@ -5095,10 +5440,14 @@ namespace bgfx { namespace gl
 
 		if (0 != m_id)
 		{
-			s_renderGL->setProgram(0);
+			s_renderGL->setProgram(NULL);
 			GL_CHECK(glDeleteProgram(m_id) );
 			m_id = 0;
 		}
+
+		m_uniformShadow.clear();
+
+		s_renderGL->invalidateVaoCache(m_vcref);
 	}
 
 	void ProgramGL::init()
@@ -5173,6 +5522,7 @@ namespace bgfx { namespace gl
 
 		m_numPredefined = 0;
 		m_numSamplers = 0;
+		m_uniformShadow.clear();
 
 		BX_TRACE("Uniforms (%d):", activeUniforms);
 		for (int32_t ii = 0; ii < activeUniforms; ++ii)
@@ -5277,6 +5627,8 @@ namespace bgfx { namespace gl
 					BX_TRACE("Sampler #%d at location %d.", m_numSamplers, loc);
 					m_sampler[m_numSamplers] = loc;
 					m_numSamplers++;
+
+					m_uniformShadow.add(loc, sizeof(int32_t)*num);
 				}
 				else
 				{
@@ -5298,6 +5650,8 @@ namespace bgfx { namespace gl
 				m_predefined[m_numPredefined].m_count = uint16_t(num);
 				m_predefined[m_numPredefined].m_type  = uint8_t(predefined);
 				m_numPredefined++;
+
+				m_uniformShadow.add(loc, g_uniformTypeSize[convertGlType(gltype)]*num);
 			}
 			else
 			{
@@ -5315,6 +5669,8 @@ namespace bgfx { namespace gl
 					m_constantBuffer->writeUniformHandle(type, 0, info->m_handle, uint16_t(num) );
 					m_constantBuffer->write(loc);
 					BX_TRACE("store %s %d", name, info->m_handle);
+
+					m_uniformShadow.add(loc, g_uniformTypeSize[type]*num);
 				}
 			}
 
@@ -5475,6 +5831,60 @@ namespace bgfx { namespace gl
 		}
 	}
 
+	void ProgramGL::bindInstanceAttributes(const VertexLayout& _layout, uint32_t _offset)
+	{
+		uint32_t numBound = 0;
+
+		for (uint32_t ii = 0, iiEnd = m_usedCount; ii < iiEnd; ++ii)
+		{
+			Attrib::Enum attr = Attrib::Enum(m_used[ii]);
+			GLint loc = m_attributes[attr];
+
+			if (-1 != loc
+			&&  UINT16_MAX != _layout.m_attributes[attr])
+			{
+				uint8_t num;
+				AttribType::Enum type;
+				bool normalized;
+				bool asInt;
+				_layout.decode(attr, num, type, normalized, asInt);
+
+				lazyEnableVertexAttribArray(loc);
+
+				const uint32_t offset = _offset + _layout.m_offset[attr];
+				if ( (BX_ENABLED(BGFX_CONFIG_RENDERER_OPENGL >= 30) || s_renderGL->m_gles3)
+				&&  !isFloat(type)
+				&&  !normalized)
+				{
+					GL_CHECK(glVertexAttribIPointer(loc
+						, num
+						, s_attribType[type]
+						, _layout.m_stride
+						, (void*)(uintptr_t)offset)
+						);
+				}
+				else
+				{
+					GL_CHECK(glVertexAttribPointer(loc
+						, num
+						, s_attribType[type]
+						, normalized
+						, _layout.m_stride
+						, (void*)(uintptr_t)offset)
+						);
+				}
+
+				GL_CHECK(glVertexAttribDivisor(loc, 1) );
+
+				m_unboundUsedAttrib[ii] = Attrib::Count;
+				++numBound;
+			}
+		}
+
+		BX_WARN(0 != numBound, "Instance data layout doesn't provide any attribute used by program.");
+		BX_UNUSED(numBound);
+	}
+
 	void ProgramGL::bindAttributesEnd()
 	{
 		for (uint32_t ii = 0, iiEnd = m_usedCount; ii < iiEnd; ++ii)
@@ -5512,14 +5922,73 @@ namespace bgfx { namespace gl
 		}
 	}
 
+	void ProgramGL::bindAttributeFormat(const VertexLayout& _layout, uint32_t _binding) const
+	{
+		for (uint32_t ii = 0, iiEnd = m_usedCount; ii < iiEnd; ++ii)
+		{
+			Attrib::Enum attr = Attrib::Enum(m_used[ii]);
+			GLint loc = m_attributes[attr];
+
+			if (-1 != loc
+			&&  UINT16_MAX != _layout.m_attributes[attr])
+			{
+				uint8_t num;
+				AttribType::Enum type;
+				bool normalized;
+				bool asInt;
+				_layout.decode(attr, num, type, normalized, asInt);
+
+				GL_CHECK(glEnableVertexAttribArray(loc) );
+
+				if (!isFloat(type)
+				&&  !normalized)
+				{
+					GL_CHECK(glVertexAttribIFormat(loc
+						, num
+						, s_attribType[type]
+						, _layout.m_offset[attr])
+						);
+				}
+				else
+				{
+					GL_CHECK(glVertexAttribFormat(loc
+						, num
+						, s_attribType[type]
+						, normalized
+						, _layout.m_offset[attr])
+						);
+				}
+
+				GL_CHECK(glVertexAttribBinding(loc, _binding) );
+			}
+		}
+	}
+
+	void ProgramGL::bindInstanceDataFormat(uint32_t _binding) const
+	{
+		for (uint32_t ii = 0; -1 != m_instanceData[ii]; ++ii)
+		{
+			GLint loc = m_instanceData[ii];
+			GL_CHECK(glEnableVertexAttribArray(loc) );
+			GL_CHECK(glVertexAttribFormat(loc, 4, GL_FLOAT, GL_FALSE, m_instanceOffset[ii]) );
+			GL_CHECK(glVertexAttribBinding(loc, _binding) );
+		}
+
+		GL_CHECK(glVertexBindingDivisor(_binding, 1) );
+	}
+
 	void IndexBufferGL::destroy()
 	{
+		s_renderGL->invalidateVaoCache(m_vcref);
+
 		GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
 		GL_CHECK(glDeleteBuffers(1, &m_id) );
 	}
 
 	void VertexBufferGL::destroy()
 	{
+		s_renderGL->invalidateVaoCache(m_vcref);
+
 		GL_CHECK(glBindBuffer(m_target, 0) );
 		GL_CHECK(glDeleteBuffers(1, &m_id) );
 	}
@@ -5957,6 +6426,29 @@ namespace bgfx { namespace gl
 		m_id = (GLuint)_ptr;
 	}
 
+	static const void* stageUpload(const uint8_t* _data, uint32_t _size)
+	{
+		if (s_renderGL->m_uploadRingSupport)
+		{
+			uint32_t offset;
+			uint8_t* dst = s_renderGL->m_uploadRing.alloc(_size, offset);
+
+			if (NULL != dst)
+			{
+				bx::memCopy(dst, _data, _size);
+				GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s_renderGL->m_uploadRing.getBuffer() ) );
+
+				// With pixel unpack buffer bound, pointer is offset into buffer.
+				return (const void*)uintptr_t(offset);
+			}
+
+			return _data;
+		}
+
+		s_renderGL->m_uploadRing.m_ring.direct(_size);
+		return _data;
+	}
+
 	void TextureGL::update(uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem)
 	{
 		const uint32_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(m_textureFormat) );
@@ -6019,6 +6511,9 @@ namespace bgfx { namespace gl
 				? s_textureFormat[m_textureFormat].m_internalFmtSrgb
 				: s_textureFormat[m_textureFormat].m_internalFmt
 				;
+			const uint32_t size   = data == _mem->data ? _mem->size : rectpitch*height;
+			const void*    pixels = stageUpload(data, size);
+
 			GL_CHECK(compressedTexSubImage(target+_side
 				, _mip
 				, rect.m_x
@@ -6028,9 +6523,14 @@ namespace bgfx { namespace gl
 				, rect.m_height
 				, _depth
 				, internalFmt
-				, _mem->size
-				, data
+				, size
+				, pixels
 				) );
+
+			if (pixels != data)
+			{
+				GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0) );
+			}
 		}
 		else
 		{
@@ -6051,6 +6551,9 @@ namespace bgfx { namespace gl
 				data = temp;
 			}
 
+			const uint32_t size   = data == _mem->data ? _mem->size : rectpitch*height;
+			const void*    pixels = stageUpload(data, size);
+
 			GL_CHECK(texSubImage(target+_side
 				, _mip
 				, rect.m_x
@@ -6061,8 +6564,13 @@ namespace bgfx { namespace gl
 				, _depth
 				, m_fmt
 				, m_type
-				, data
+				, pixels
 				) );
+
+			if (pixels != data)
+			{
+				GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0) );
+			}
 		}
 
 		if (!convert
@@ -7309,6 +7817,8 @@ namespace bgfx { namespace gl
 			Query& query = m_query[ii];
 			GL_CHECK(glGenQueries(1, &query.m_id) );
 		}
+
+		bx::memSet(m_issued, 0, sizeof(m_issued) );
 	}
 
 	void OcclusionQueryGL::destroy()
@@ -7330,6 +7840,7 @@ namespace bgfx { namespace gl
 		Query& query = m_query[m_control.m_current];
 		GL_CHECK(glBeginQuery(GL_SAMPLES_PASSED, query.m_id) );
 		query.m_handle = _handle;
+		m_issued[_handle.idx] = query.m_id;
 	}
 
 	void OcclusionQueryGL::end()
@@ -7378,6 +7889,122 @@ namespace bgfx { namespace gl
 				query.m_handle.idx = bgfx::kInvalidHandle;
 			}
 		}
+
+		m_issued[_handle.idx] = 0;
+	}
+
+	bool UploadRingGL::create(uint32_t _size)
+	{
+		m_ring.reset(_size, BX_COUNTOF(m_slot) );
+
+		bool mapped = true;
+
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_slot); ++ii)
+		{
+			Slot& slot = m_slot[ii];
+			slot.m_fence = NULL;
+
+			GL_CHECK(glGenBuffers(1, &slot.m_id) );
+			GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.m_id) );
+			GL_CHECK(glBufferStorage(GL_PIXEL_UNPACK_BUFFER
+				, _size
+				, NULL
+				, GL_MAP_WRITE_BIT|GL_MAP_PERSISTENT_BIT|GL_MAP_COHERENT_BIT
+				) );
+			slot.m_data = (uint8_t*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER
+				, 0
+				, _size
+				, GL_MAP_WRITE_BIT|GL_MAP_PERSISTENT_BIT|GL_MAP_COHERENT_BIT
+				);
+			BX_WARN(NULL != slot.m_data, "Failed to map upload buffer %d.", ii);
+			mapped &= NULL != slot.m_data;
+		}
+
+		GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0) );
+
+		if (!mapped)
+		{
+			// Texture updates go directly from client memory.
+			destroy();
+		}
+
+		return mapped;
+	}
+
+	void UploadRingGL::destroy()
+	{
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_slot); ++ii)
+		{
+			Slot& slot = m_slot[ii];
+
+			if (NULL != slot.m_fence)
+			{
+				GL_CHECK(glDeleteSync(slot.m_fence) );
+				slot.m_fence = NULL;
+			}
+
+			if (NULL != slot.m_data)
+			{
+				GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.m_id) );
+				GL_CHECK(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) );
+				slot.m_data = NULL;
+			}
+
+			GL_CHECK(glDeleteBuffers(1, &slot.m_id) );
+			slot.m_id = 0;
+		}
+
+		GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0) );
+		m_ring.reset(0, BX_COUNTOF(m_slot) );
+	}
+
+	uint8_t* UploadRingGL::alloc(uint32_t _size, uint32_t& _outOffset)
+	{
+		bool moved;
+		const uint32_t offset = m_ring.alloc(_size, moved);
+
+		if (moved)
+		{
+			next();
+		}
+
+		if (UploadRing::kInvalidOffset == offset)
+		{
+			return NULL;
+		}
+
+		_outOffset = offset;
+		return &m_slot[m_ring.getCurrent()].m_data[offset];
+	}
+
+	void UploadRingGL::frame()
+	{
+		if (m_ring.frame() )
+		{
+			next();
+		}
+	}
+
+	void UploadRingGL::next()
+	{
+		Slot& retired = m_slot[m_ring.getRetired()];
+		retired.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		Slot& slot = m_slot[m_ring.getCurrent()];
+		if (NULL != slot.m_fence)
+		{
+			GLenum result;
+			do
+			{
+				result = glClientWaitSync(slot.m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_C(1000000) );
+			}
+			while (GL_TIMEOUT_EXPIRED == result);
+
+			BX_WARN(GL_WAIT_FAILED != result, "Waiting on upload buffer fence failed.");
+
+			GL_CHECK(glDeleteSync(slot.m_fence) );
+			slot.m_fence = NULL;
+		}
 	}
 
 	void RendererContextGL::submitBlit(BlitState& _bs, uint16_t _view)
@@ -7504,6 +8131,8 @@ namespace bgfx { namespace gl
 
 		_render->sort();
 
+		m_vaoStateCache.frame();
+
 		RenderDraw currentState;
 		currentState.clear();
 		currentState.m_stateFlags = BGFX_STATE_NONE;
@@ -7517,6 +8146,7 @@ namespace bgfx { namespace gl
 
 		ProgramHandle currentProgram = BGFX_INVALID_HANDLE;
 		ProgramHandle boundProgram   = BGFX_INVALID_HANDLE;
+		GLuint currentVao = 0;
 		SortKey key;
 		uint16_t view = UINT16_MAX;
 		FrameBufferHandle fbh = { BGFX_CONFIG_MAX_FRAME_BUFFERS };
@@ -7565,9 +8195,14 @@ namespace bgfx { namespace gl
 			, m_timerQuerySupport
 			);
 
+		m_gpuTimerScopes.begin(_render, m_timerQuerySupport ? &m_gpuTimer : NULL, BGFX_CONFIG_MAX_VIEWS+1);
+
 		if (m_occlusionQuerySupport)
 		{
 			m_occlusionQuery.resolve(_render);
+
+			// Draws are predicated only on queries issued in this frame.
+			bx::memSet(m_occlusionQuery.m_issued, 0, sizeof(m_occlusionQuery.m_issued) );
 		}
 
 		if (0 == (_render->m_debug&BGFX_DEBUG_IFH) )
@@ -7579,6 +8214,8 @@ namespace bgfx { namespace gl
 
 			for (int32_t item = 0; item < numItems;)
 			{
+				m_gpuTimerScopes.update(item);
+
 				const uint64_t encodedKey = _render->m_sortKeys[item];
 				const bool isCompute = key.decode(encodedKey, _render->m_viewRemap);
 				statsKeyType[isCompute]++;
@@ -7598,6 +8235,13 @@ namespace bgfx { namespace gl
 					view = key.m_view;
 					currentProgram = BGFX_INVALID_HANDLE;
 
+					if (0 != currentVao)
+					{
+						// Clear quad and blits must not modify cached vertex array objects.
+						restoreVertexArray();
+						currentVao = 0;
+					}
+
 					if (item > 1)
 					{
 						profiler.end();
@@ -7662,7 +8306,7 @@ namespace bgfx { namespace gl
 						const RenderCompute& compute = renderItem.compute;
 
 						ProgramGL& program = m_program[key.m_program.idx];
-						setProgram(program.m_id);
+						setProgram(&program);
 
 						GLbitfield barrier = 0;
 						for (uint32_t ii = 0; ii < maxComputeBindings; ++ii)
@@ -7780,11 +8424,24 @@ namespace bgfx { namespace gl
 				const RenderDraw& draw = renderItem.draw;
 
 				const bool hasOcclusionQuery = 0 != (draw.m_stateFlags & BGFX_STATE_INTERNAL_OCCLUSION_QUERY);
+				const bool occlusionVisible  = 0 != (draw.m_submitFlags & BGFX_SUBMIT_INTERNAL_OCCLUSION_VISIBLE);
+
+				// Query issued earlier in this frame predicates draw on GPU,
+				// inverted condition requires GL 4.5 or ARB_conditional_render_inverted.
+				const GLuint conditionQuery = true
+					&& isValid(draw.m_occlusionQuery)
+					&& !hasOcclusionQuery
+					&& 0 != (draw.m_submitFlags & BGFX_SUBMIT_INTERNAL_OCCLUSION_GPU)
+					&& (occlusionVisible || m_conditionalRenderInvertedSupport)
+					? m_occlusionQuery.getId(draw.m_occlusionQuery)
+					: 0
+					;
 				{
 					const bool occluded = true
 						&& isValid(draw.m_occlusionQuery)
 						&& !hasOcclusionQuery
-						&& !isVisible(_render, draw.m_occlusionQuery, 0 != (draw.m_submitFlags&BGFX_SUBMIT_INTERNAL_OCCLUSION_VISIBLE) )
+						&& 0 == conditionQuery
+						&& !isVisible(_render, draw.m_occlusionQuery, occlusionVisible)
 						;
 
 					if (occluded
@@ -8161,7 +8818,7 @@ namespace bgfx { namespace gl
 					// Skip rendering if program index is valid, but program is invalid.
 					currentProgram = 0 == id ? ProgramHandle{kInvalidHandle} : currentProgram;
 
-					setProgram(id);
+					setProgram(isValid(currentProgram) ? &m_program[currentProgram.idx] : NULL);
 					programChanged =
 						constantsChanged =
 						bindAttribs = true;
@@ -8269,12 +8926,14 @@ namespace bgfx { namespace gl
 						||  currentState.m_streamMask             != draw.m_streamMask
 						||  currentState.m_instanceDataBuffer.idx != draw.m_instanceDataBuffer.idx
 						||  currentState.m_instanceDataOffset     != draw.m_instanceDataOffset
-						||  currentState.m_instanceDataStride     != draw.m_instanceDataStride)
+						||  currentState.m_instanceDataStride     != draw.m_instanceDataStride
+						||  currentState.m_instanceDataLayout.idx != draw.m_instanceDataLayout.idx)
 						{
 							currentState.m_streamMask         = draw.m_streamMask;
 							currentState.m_instanceDataBuffer = draw.m_instanceDataBuffer;
 							currentState.m_instanceDataOffset = draw.m_instanceDataOffset;
 							currentState.m_instanceDataStride = draw.m_instanceDataStride;
+							currentState.m_instanceDataLayout = draw.m_instanceDataLayout;
 
 							bindAttribs = true;
 						}
@@ -8283,7 +8942,11 @@ namespace bgfx { namespace gl
 						{
 							currentState.m_indexBuffer = draw.m_indexBuffer;
 
-							if (isValid(draw.m_indexBuffer) )
+							if (m_vaoCacheEnabled)
+							{
+								bindAttribs = true;
+							}
+							else if (isValid(draw.m_indexBuffer) )
 							{
 								IndexBufferGL& ib = m_indexBuffers[draw.m_indexBuffer.idx];
 								GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ib.m_id) );
@@ -8299,7 +8962,15 @@ namespace bgfx { namespace gl
 							currentState.m_startIndex = draw.m_startIndex;
 						}
 
-						if (0 != currentState.m_streamMask)
+						if (m_vaoCacheEnabled)
+						{
+							if (bindAttribs)
+							{
+								boundProgram = BGFX_INVALID_HANDLE;
+								currentVao   = setVertexArray(currentProgram, draw, currentVao);
+							}
+						}
+						else if (0 != currentState.m_streamMask)
 						{
 							if (bindAttribs)
 							{
@@ -8336,7 +9007,15 @@ namespace bgfx { namespace gl
 								if (isValid(draw.m_instanceDataBuffer) )
 								{
 									GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffers[draw.m_instanceDataBuffer.idx].m_id) );
-									program.bindInstanceData(draw.m_instanceDataStride, draw.m_instanceDataOffset);
+
+									if (isValid(draw.m_instanceDataLayout) )
+									{
+										program.bindInstanceAttributes(m_vertexLayouts[draw.m_instanceDataLayout.idx], draw.m_instanceDataOffset);
+									}
+									else
+									{
+										program.bindInstanceData(draw.m_instanceDataStride, draw.m_instanceDataOffset);
+									}
 								}
 
 								program.bindAttributesEnd();
@@ -8377,6 +9056,11 @@ namespace bgfx { namespace gl
 							m_occlusionQuery.begin(_render, draw.m_occlusionQuery);
 						}
 
+						if (0 != conditionQuery)
+						{
+							GL_CHECK(glBeginConditionalRender(conditionQuery, occlusionVisible ? GL_QUERY_WAIT : GL_QUERY_WAIT_INVERTED) );
+						}
+
 						if (isValid(draw.m_indirectBuffer) )
 						{
 							const VertexBufferGL& vb = m_vertexBuffers[draw.m_indirectBuffer.idx];
@@ -8528,6 +9212,11 @@ namespace bgfx { namespace gl
 							}
 						}
 
+						if (0 != conditionQuery)
+						{
+							GL_CHECK(glEndConditionalRender() );
+						}
+
 						if (hasOcclusionQuery)
 						{
 							m_occlusionQuery.end();
@@ -8541,12 +9230,20 @@ namespace bgfx { namespace gl
 				}
 			}
 
+			m_gpuTimerScopes.update(numItems);
+
 			if (isValid(boundProgram) )
 			{
 				m_program[boundProgram.idx].unbindAttributes();
 				boundProgram = BGFX_INVALID_HANDLE;
 			}
 
+			if (0 != currentVao)
+			{
+				restoreVertexArray();
+				currentVao = 0;
+			}
+
 			if (wasCompute)
 			{
 				setViewType(view, "C");
@@ -8579,6 +9276,14 @@ namespace bgfx { namespace gl
 			}
 		}
 
+		m_gpuTimerScopes.end();
+
+		if (m_uploadRingSupport)
+		{
+			// Fence texture updates staged this frame.
+			m_uploadRing.frame();
+		}
+
 		BGFX_GL_PROFILER_END();
 
 		m_glctx.makeCurrent(NULL);
@@ -8621,6 +9326,9 @@ namespace bgfx { namespace gl
 		perfStats.numBlit       = _render->m_numBlitItems;
 		perfStats.maxGpuLatency = maxGpuLatency;
 		perfStats.gpuFrameNum   = result.m_frameNum;
+		perfStats.numUniformsSkipped = m_numUniformsSkipped;
+		m_numUniformsSkipped = 0;
+		m_uploadRing.m_ring.getStats(perfStats.textureUploadStaged, perfStats.textureUploadDirect);
 		bx::memCopy(perfStats.numPrims, statsNumPrimsRendered, sizeof(perfStats.numPrims) );
 		perfStats.gpuMemoryMax  = -INT64_MAX;
 		perfStats.gpuMemoryUsed = -INT64_MAX;
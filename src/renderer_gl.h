@@ -26,9 +26,11 @@
 	|| BX_PLATFORM_WINDOWS         \
 	)
 
-// Keep a state cache of GL uniform values to avoid redundant uploads
-// on the following platforms.
-#define BGFX_GL_CONFIG_UNIFORM_CACHE BX_PLATFORM_EMSCRIPTEN
+// Keep shadow copy of GL uniform values per program to avoid redundant
+// uploads.
+#ifndef BGFX_GL_CONFIG_UNIFORM_CACHE
+#	define BGFX_GL_CONFIG_UNIFORM_CACHE 1
+#endif // BGFX_GL_CONFIG_UNIFORM_CACHE
 
 #ifndef BGFX_GL_CONFIG_BLIT_EMULATION
 #	define BGFX_GL_CONFIG_BLIT_EMULATION 0
@@ -38,6 +40,17 @@
 #	define BGFX_GL_CONFIG_TEXTURE_READ_BACK_EMULATION 0
 #endif // BGFX_GL_CONFIG_TEXTURE_READ_BACK_EMULATION
 
+// Size of each persistently mapped pixel unpack buffer used to stage texture
+// updates. Set to 0 to always upload directly from application memory.
+#ifndef BGFX_GL_CONFIG_UPLOAD_BUFFER_SIZE
+#	define BGFX_GL_CONFIG_UPLOAD_BUFFER_SIZE (4<<20)
+#endif // BGFX_GL_CONFIG_UPLOAD_BUFFER_SIZE
+
+// Number of staging buffers in flight.
+#ifndef BGFX_GL_CONFIG_UPLOAD_BUFFER_COUNT
+#	define BGFX_GL_CONFIG_UPLOAD_BUFFER_COUNT (BGFX_CONFIG_MAX_FRAME_LATENCY+1)
+#endif // BGFX_GL_CONFIG_UPLOAD_BUFFER_COUNT
+
 #define BGFX_GL_PROFILER_BEGIN(_view, _abgr)                                               \
 	BX_MACRO_BLOCK_BEGIN                                                                   \
 		GL_CHECK(glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, s_viewName[view]) ); \
@@ -86,6 +99,7 @@ typedef double GLdouble;
 #		include <GLES2/gl2ext.h>
 typedef int64_t  GLint64;
 typedef uint64_t GLuint64;
+typedef struct __GLsync* GLsync;
 #		define GL_PROGRAM_BINARY_LENGTH GL_PROGRAM_BINARY_LENGTH_OES
 #		define GL_HALF_FLOAT GL_HALF_FLOAT_OES
 #		define GL_RGBA8 GL_RGBA8_OES
@@ -122,6 +136,7 @@ typedef uint64_t GLuint64;
 #include "renderer.h"
 #include "debug_renderdoc.h"
 #include "emscripten.h"
+#include "uploadring.h"
 
 #ifndef GL_LUMINANCE
 #	define GL_LUMINANCE 0x1909
@@ -699,6 +714,14 @@ typedef uint64_t GLuint64;
 #	define GL_ANY_SAMPLES_PASSED 0x8C2F
 #endif // GL_ANY_SAMPLES_PASSED
 
+#ifndef GL_QUERY_WAIT
+#	define GL_QUERY_WAIT 0x8E13
+#endif // GL_QUERY_WAIT
+
+#ifndef GL_QUERY_WAIT_INVERTED
+#	define GL_QUERY_WAIT_INVERTED 0x8E17
+#endif // GL_QUERY_WAIT_INVERTED
+
 #ifndef GL_READ_FRAMEBUFFER
 #	define GL_READ_FRAMEBUFFER 0x8CA8
 #endif /// GL_READ_FRAMEBUFFER
@@ -752,6 +775,46 @@ typedef uint64_t GLuint64;
 #	define GL_UNPACK_ROW_LENGTH 0x0CF2
 #endif // GL_UNPACK_ROW_LENGTH
 
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#	define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif // GL_PIXEL_UNPACK_BUFFER
+
+#ifndef GL_MAP_WRITE_BIT
+#	define GL_MAP_WRITE_BIT 0x0002
+#endif // GL_MAP_WRITE_BIT
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#	define GL_MAP_PERSISTENT_BIT 0x0040
+#endif // GL_MAP_PERSISTENT_BIT
+
+#ifndef GL_MAP_COHERENT_BIT
+#	define GL_MAP_COHERENT_BIT 0x0080
+#endif // GL_MAP_COHERENT_BIT
+
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#	define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif // GL_SYNC_GPU_COMMANDS_COMPLETE
+
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#	define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif // GL_SYNC_FLUSH_COMMANDS_BIT
+
+#ifndef GL_ALREADY_SIGNALED
+#	define GL_ALREADY_SIGNALED 0x911A
+#endif // GL_ALREADY_SIGNALED
+
+#ifndef GL_TIMEOUT_EXPIRED
+#	define GL_TIMEOUT_EXPIRED 0x911B
+#endif // GL_TIMEOUT_EXPIRED
+
+#ifndef GL_CONDITION_SATISFIED
+#	define GL_CONDITION_SATISFIED 0x911C
+#endif // GL_CONDITION_SATISFIED
+
+#ifndef GL_WAIT_FAILED
+#	define GL_WAIT_FAILED 0x911D
+#endif // GL_WAIT_FAILED
+
 #ifndef GL_DEPTH_STENCIL
 #	define GL_DEPTH_STENCIL 0x84F9
 #endif // GL_DEPTH_STENCIL
@@ -1184,87 +1247,95 @@ namespace bgfx { namespace gl
 #define GL_IMPORT(_optional, _proto, _func, _import) extern _proto _func
 #include "glimports.h"
 
-	class UniformStateCache
+	/// Shadow copy of uniform values stored in GL program object. GL keeps
+	/// uniform values per program, so upload can be skipped when value is
+	/// the same as the one last uploaded to that program.
+	class UniformShadowGL
 	{
 	public:
-		struct f4   { float val[ 4]; bool operator ==(const f4   &rhs) { const uint64_t *a = (const uint64_t *)this; const uint64_t *b = (const uint64_t *)&rhs; return a[0] == b[0] && a[1] == b[1]; }};
-		struct f3x3 { float val[ 9]; bool operator ==(const f3x3 &rhs) { const uint64_t *a = (const uint64_t *)this; const uint64_t *b = (const uint64_t *)&rhs; return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3] && ((const uint32_t*)a)[8] == ((const uint32_t*)b)[8]; }};
-		struct f4x4 { float val[16]; bool operator ==(const f4x4 &rhs) { const uint64_t *a = (const uint64_t *)this; const uint64_t *b = (const uint64_t *)&rhs; return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3] && a[4] == b[4] && a[5] == b[5] && a[6] == b[6] && a[7] == b[7]; }};
-
-		typedef stl::unordered_map<uint64_t, int>  IMap;
-		typedef stl::unordered_map<uint64_t, f4>   F4Map;
-		typedef stl::unordered_map<uint64_t, f3x3> F3x3Map;
-		typedef stl::unordered_map<uint64_t, f4x4> F4x4Map;
-
-		UniformStateCache()
-			: m_currentProgram(0)
+		void clear()
 		{
+			m_index.clear();
+			m_entry.clear();
+			m_data.clear();
 		}
 
-		// Inserts the new value into the uniform cache, and returns true
-		// if the old value was different than the new one.
-		template<typename T>
-		bool updateUniformCache(uint32_t loc, const T &value)
+		// Registers uniform at location with storage for _size bytes. Only
+		// first registration of location is kept, and locations above
+		// kMaxLocation are not shadowed.
+		void add(GLint _loc, uint32_t _size)
 		{
-			if (BX_ENABLED(BGFX_GL_CONFIG_UNIFORM_CACHE) )
+			if (!BX_ENABLED(BGFX_GL_CONFIG_UNIFORM_CACHE)
+			||  0 > _loc
+			||  kMaxLocation < _loc
+			||  0 == _size)
 			{
-				// Uniform state cache for various types.
-				stl::unordered_map<uint64_t, T>& uniformCacheMap = getUniformCache<T>();
-
-				uint64_t key = (uint64_t(m_currentProgram) << 32) | loc;
-
-				auto iter = uniformCacheMap.find(key);
-
-				// Not found in the cache? Add it.
-				if (iter == uniformCacheMap.end())
-				{
-					uniformCacheMap[key] = value;
-					return true;
-				}
-
-				// Value in the cache was the same as new state? Skip reuploading this state.
-				if (iter->second == value)
-				{
-					return false;
-				}
+				return;
+			}
 
-				iter->second = value;
+			if (uint32_t(_loc) >= m_index.size() )
+			{
+				m_index.resize(_loc+1, 0);
+			}
+			else if (0 != m_index[_loc])
+			{
+				return;
 			}
 
-			return true;
+			Entry entry;
+			entry.m_offset = uint32_t(m_data.size() );
+			entry.m_size   = _size;
+			entry.m_valid  = false;
+			m_entry.push_back(entry);
+			m_data.resize(m_data.size() + _size);
+
+			m_index[_loc] = uint16_t(m_entry.size() );
 		}
 
-		void saveCurrentProgram(GLuint program)
+		// Stores new value, and returns true if value is different from the
+		// one previously uploaded, or if location is not shadowed.
+		bool update(GLint _loc, const void* _data, uint32_t _size)
 		{
-			if (BX_ENABLED(BGFX_GL_CONFIG_UNIFORM_CACHE) )
+			if (0 > _loc
+			||  uint32_t(_loc) >= m_index.size()
+			||  0 == m_index[_loc])
 			{
-				m_currentProgram = program;
+				return true;
 			}
-		}
 
-	private:
-		GLuint m_currentProgram;
+			Entry& entry = m_entry[m_index[_loc]-1];
+			if (_size > entry.m_size)
+			{
+				return true;
+			}
 
-		IMap    m_uniformiCacheMap;
-		F4Map   m_uniformf4CacheMap;
-		F3x3Map m_uniformf3x3CacheMap;
-		F4x4Map m_uniformf4x4CacheMap;
+			uint8_t* shadow = &m_data[entry.m_offset];
+			if (entry.m_valid
+			&&  0 == bx::memCmp(shadow, _data, _size) )
+			{
+				return false;
+			}
 
-		template<typename T>
-		stl::unordered_map<uint64_t, T>& getUniformCache();
-	};
+			bx::memCopy(shadow, _data, _size);
+			entry.m_valid = true;
 
-	template<>
-	inline UniformStateCache::IMap& UniformStateCache::getUniformCache() { return m_uniformiCacheMap; }
+			return true;
+		}
 
-	template<>
-	inline UniformStateCache::F4Map& UniformStateCache::getUniformCache() { return m_uniformf4CacheMap; }
+	private:
+		static constexpr GLint kMaxLocation = 4095;
 
-	template<>
-	inline UniformStateCache::F3x3Map& UniformStateCache::getUniformCache() { return m_uniformf3x3CacheMap; }
+		struct Entry
+		{
+			uint32_t m_offset;
+			uint32_t m_size;
+			bool     m_valid;
+		};
 
-	template<>
-	inline UniformStateCache::F4x4Map& UniformStateCache::getUniformCache() { return m_uniformf4x4CacheMap; }
+		stl::vector<uint16_t> m_index; // Location to entry index + 1, 0 if not shadowed.
+		stl::vector<Entry>    m_entry;
+		stl::vector<uint8_t>  m_data;
+	};
 
 	class SamplerStateCache
 	{
@@ -1321,6 +1392,201 @@ namespace bgfx { namespace gl
 		HashMap m_hashMap;
 	};
 
+	/// Vertex array object cache key. Vertex and instance data offsets are not
+	/// part of the key, they are applied per draw.
+	struct VaoKey
+	{
+		void clear()
+		{
+			bx::memSet(this, 0, sizeof(VaoKey) );
+		}
+
+		bool operator==(const VaoKey& _other) const
+		{
+			return 0 == bx::memCmp(this, &_other, sizeof(VaoKey) );
+		}
+
+		uint32_t m_layoutHash[BGFX_CONFIG_MAX_VERTEX_STREAMS+1];
+		uint16_t m_stream[BGFX_CONFIG_MAX_VERTEX_STREAMS];
+		uint16_t m_program;
+		uint16_t m_instanceDataBuffer;
+		uint16_t m_indexBuffer;
+		uint8_t  m_streamMask;
+		uint8_t  m_instanceData;
+	};
+
+	class VaoStateCache;
+
+	class VaoCacheRef
+	{
+	public:
+		void add(uint32_t _hash)
+		{
+			m_vaoSet.insert(_hash);
+		}
+
+		void remove(uint32_t _hash)
+		{
+			m_vaoSet.erase(_hash);
+		}
+
+		void invalidate(VaoStateCache& _vaoCache);
+
+	private:
+		typedef stl::unordered_set<uint32_t> VaoSet;
+		VaoSet m_vaoSet;
+	};
+
+	struct VaoGL
+	{
+		// Program, vertex streams, instance data buffer and index buffer.
+		static constexpr uint32_t kMaxRefs = BGFX_CONFIG_MAX_VERTEX_STREAMS + 3;
+
+		VaoKey       m_key;
+		GLuint       m_id;
+		uint32_t     m_lastUsed;
+		uint64_t     m_enabledAttribs;                             //!< Lazy enabled attributes, only tracked on WebGL.
+		uint32_t     m_startVertex[BGFX_CONFIG_MAX_VERTEX_STREAMS];
+		uint32_t     m_instanceDataOffset;
+		uint16_t     m_instanceDataStride;
+		bool         m_bound;                                      //!< Attribute pointers are specified.
+		uint8_t      m_numRefs;
+		VaoCacheRef* m_ref[kMaxRefs];                              //!< Resources referencing this entry.
+	};
+
+	class VaoStateCache
+	{
+	public:
+		VaoStateCache()
+			: m_frame(0)
+		{
+		}
+
+		VaoGL* add(uint32_t _hash, const VaoKey& _key)
+		{
+			invalidate(_hash);
+
+			if (BGFX_CONFIG_MAX_VAO_CACHE <= m_hashMap.size() )
+			{
+				evict();
+			}
+
+			VaoGL vao;
+			vao.m_key            = _key;
+			vao.m_lastUsed       = m_frame;
+			vao.m_enabledAttribs = 0;
+			vao.m_bound          = false;
+			vao.m_numRefs        = 0;
+			GL_CHECK(glGenVertexArrays(1, &vao.m_id) );
+			GL_CHECK(glBindVertexArray(vao.m_id) );
+
+			return &m_hashMap.insert(stl::make_pair(_hash, vao) ).first->second;
+		}
+
+		VaoGL* find(uint32_t _hash, const VaoKey& _key)
+		{
+			HashMap::iterator it = m_hashMap.find(_hash);
+			if (it != m_hashMap.end()
+			&&  it->second.m_key == _key)
+			{
+				it->second.m_lastUsed = m_frame;
+				return &it->second;
+			}
+
+			return NULL;
+		}
+
+		void addRef(VaoGL* _vao, uint32_t _hash, VaoCacheRef& _ref)
+		{
+			BX_ASSERT(VaoGL::kMaxRefs > _vao->m_numRefs, "Too many references to vertex array object.");
+			_vao->m_ref[_vao->m_numRefs++] = &_ref;
+			_ref.add(_hash);
+		}
+
+		void invalidate(uint32_t _hash)
+		{
+			HashMap::iterator it = m_hashMap.find(_hash);
+			if (it != m_hashMap.end() )
+			{
+				release(it);
+				m_hashMap.erase(it);
+			}
+		}
+
+		void invalidate()
+		{
+			for (HashMap::iterator it = m_hashMap.begin(), itEnd = m_hashMap.end(); it != itEnd; ++it)
+			{
+				release(it);
+			}
+			m_hashMap.clear();
+		}
+
+		void frame()
+		{
+			++m_frame;
+		}
+
+		uint32_t getCount() const
+		{
+			return uint32_t(m_hashMap.size() );
+		}
+
+	private:
+		typedef stl::unordered_map<uint32_t, VaoGL> HashMap;
+
+		void release(HashMap::iterator _it)
+		{
+			// Evicted entry must not stay in resource references, otherwise they
+			// grow without bound.
+			VaoGL& vao = _it->second;
+			for (uint32_t ii = 0; ii < vao.m_numRefs; ++ii)
+			{
+				vao.m_ref[ii]->remove(_it->first);
+			}
+
+			GL_CHECK(glDeleteVertexArrays(1, &vao.m_id) );
+		}
+
+		void evict()
+		{
+			// Release vertex array objects not used in this frame, or everything
+			// when all of them are in use.
+			for (HashMap::iterator it = m_hashMap.begin(); it != m_hashMap.end();)
+			{
+				if (it->second.m_lastUsed != m_frame)
+				{
+					release(it);
+					it = m_hashMap.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+
+			if (BGFX_CONFIG_MAX_VAO_CACHE <= m_hashMap.size() )
+			{
+				invalidate();
+			}
+		}
+
+		HashMap m_hashMap;
+		uint32_t m_frame;
+	};
+
+	inline void VaoCacheRef::invalidate(VaoStateCache& _vaoCache)
+	{
+		// Invalidating entry removes it from this set, iterate over a copy.
+		VaoSet vaoSet;
+		vaoSet.swap(m_vaoSet);
+
+		for (VaoSet::iterator it = vaoSet.begin(), itEnd = vaoSet.end(); it != itEnd; ++it)
+		{
+			_vaoCache.invalidate(*it);
+		}
+	}
+
 	struct IndexBufferGL
 	{
 		void create(uint32_t _size, void* _data, uint16_t _flags)
@@ -1364,6 +1630,7 @@ namespace bgfx { namespace gl
 		GLuint m_id;
 		uint32_t m_size;
 		uint16_t m_flags;
+		VaoCacheRef m_vcref;
 	};
 
 	struct VertexBufferGL
@@ -1413,6 +1680,7 @@ namespace bgfx { namespace gl
 		GLenum m_target;
 		uint32_t m_size;
 		VertexLayoutHandle m_layoutHandle;
+		VaoCacheRef m_vcref;
 	};
 
 	struct TextureGL
@@ -1525,10 +1793,14 @@ namespace bgfx { namespace gl
 		void bindAttributesBegin();
 		void bindAttributes(const VertexLayout& _layout, uint32_t _baseVertex = 0);
 		void bindInstanceData(uint32_t _stride, uint32_t _baseVertex = 0) const;
+		void bindInstanceAttributes(const VertexLayout& _layout, uint32_t _offset);
 		void bindAttributesEnd();
 		void unbindInstanceData() const;
 		void unbindAttributes();
 
+		void bindAttributeFormat(const VertexLayout& _layout, uint32_t _binding) const;
+		void bindInstanceDataFormat(uint32_t _binding) const;
+
 		GLuint m_id;
 
 		uint8_t m_unboundUsedAttrib[Attrib::Count]; // For tracking unbound used attributes between begin()/end().
@@ -1545,6 +1817,10 @@ namespace bgfx { namespace gl
 		UniformBuffer* m_constantBuffer;
 		PredefinedUniform m_predefined[PredefinedUniform::Count];
 		uint8_t m_numPredefined;
+
+		UniformShadowGL m_uniformShadow;
+
+		VaoCacheRef m_vcref;
 	};
 
 	struct TimerQueryGL
@@ -1688,9 +1964,9 @@ namespace bgfx { namespace gl
 			bool     m_ready;
 		};
 
-		Result m_result[BGFX_CONFIG_MAX_VIEWS+1];
+		Result m_result[BGFX_CONFIG_MAX_VIEWS+1+BGFX_CONFIG_MAX_GPU_TIMERS];
 
-		Query m_query[BGFX_CONFIG_MAX_VIEWS*4];
+		Query m_query[(BGFX_CONFIG_MAX_VIEWS+BGFX_CONFIG_MAX_GPU_TIMERS)*4];
 		bx::RingBufferControl m_control;
 	};
 
@@ -1708,6 +1984,11 @@ namespace bgfx { namespace gl
 		void resolve(Frame* _render, bool _wait = false);
 		void invalidate(OcclusionQueryHandle _handle);
 
+		GLuint getId(OcclusionQueryHandle _handle) const
+		{
+			return m_issued[_handle.idx];
+		}
+
 		struct Query
 		{
 			GLuint m_id;
@@ -1715,9 +1996,39 @@ namespace bgfx { namespace gl
 		};
 
 		Query m_query[BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
+		GLuint m_issued[BGFX_CONFIG_MAX_OCCLUSION_QUERIES]; //!< Query object last issued for handle, used as conditional render predicate.
 		bx::RingBufferControl m_control;
 	};
 
+	/// Ring of persistently mapped pixel unpack buffers used to stage texture
+	/// updates. Each slot is fenced when retired, and the fence is waited on
+	/// only when the ring wraps around to that slot again. Offset and slot
+	/// accounting is done by `UploadRing`.
+	struct UploadRingGL
+	{
+		bool create(uint32_t _size);
+		void destroy();
+		uint8_t* alloc(uint32_t _size, uint32_t& _outOffset);
+		void frame();
+
+		GLuint getBuffer() const
+		{
+			return m_slot[m_ring.getCurrent()].m_id;
+		}
+
+		struct Slot
+		{
+			GLuint   m_id;
+			GLsync   m_fence;
+			uint8_t* m_data;
+		};
+
+		void next();
+
+		Slot       m_slot[BGFX_GL_CONFIG_UPLOAD_BUFFER_COUNT];
+		UploadRing m_ring;
+	};
+
 } /* namespace gl */ } // namespace bgfx
 
 #endif // BGFX_RENDERER_GL_H_HEADER_GUARD
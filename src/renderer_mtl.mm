@@ -1403,6 +1403,11 @@ BX_STATIC_ASSERT(BX_COUNTOF(s_accessNames) == Access::Count, "Invalid s_accessNa
 			return false;
 		}
 
+		bool isThreadSafe(CommandBuffer::Enum /*_command*/) const override
+		{
+			return false;
+		}
+
 		void flip() override
 		{
 			if (NULL == m_commandBuffer)
@@ -4,18 +4,95 @@
  */
 
 #include "bgfx_p.h"
+#include "renderer.h"
 
 namespace bgfx { namespace noop
 {
+	// Timer query with synthetic timestamps. Timestamp is sorted position of
+	// render item, so duration of GPU timer scope is number of render items it
+	// covers. Queries are resolved with the same latency as on GPU.
+	struct TimerQueryNOOP
+	{
+		TimerQueryNOOP()
+			: m_timestamp(0)
+			, m_current(0)
+		{
+			bx::memSet(m_result, 0, sizeof(m_result) );
+			bx::memSet(m_num,    0, sizeof(m_num) );
+		}
+
+		void frame()
+		{
+			m_current = (m_current + 1) % BGFX_CONFIG_MAX_FRAME_LATENCY;
+
+			for (uint32_t ii = 0, num = m_num[m_current]; ii < num; ++ii)
+			{
+				const Query& query = m_query[m_current][ii];
+
+				Result& result = m_result[query.m_resultIdx];
+				result.m_begin    = query.m_begin;
+				result.m_end      = query.m_end;
+				result.m_frameNum = query.m_frameNum;
+			}
+
+			m_num[m_current] = 0;
+		}
+
+		uint32_t begin(uint32_t _resultIdx, uint32_t _frameNum)
+		{
+			const uint32_t idx = m_num[m_current]++;
+
+			Query& query = m_query[m_current][idx];
+			query.m_begin     = m_timestamp;
+			query.m_end       = m_timestamp;
+			query.m_resultIdx = _resultIdx;
+			query.m_frameNum  = _frameNum;
+
+			return idx;
+		}
+
+		void end(uint32_t _idx)
+		{
+			m_query[m_current][_idx].m_end = m_timestamp;
+		}
+
+		struct Result
+		{
+			uint64_t m_begin;
+			uint64_t m_end;
+			uint32_t m_frameNum;
+		};
+
+		struct Query
+		{
+			uint64_t m_begin;
+			uint64_t m_end;
+			uint32_t m_resultIdx;
+			uint32_t m_frameNum;
+		};
+
+		Result   m_result[BGFX_CONFIG_MAX_GPU_TIMERS];
+		Query    m_query[BGFX_CONFIG_MAX_FRAME_LATENCY][BGFX_CONFIG_MAX_GPU_TIMERS];
+		uint32_t m_num[BGFX_CONFIG_MAX_FRAME_LATENCY];
+		uint64_t m_timestamp;
+		uint32_t m_current;
+	};
+
 	struct RendererContextNOOP : public RendererContextI
 	{
 		RendererContextNOOP()
+			: m_readbackData(NULL)
+			, m_readbackSize(0)
+			, m_captureWidth(0)
+			, m_captureHeight(0)
+			, m_capture(false)
 		{
 			// Pretend all features are available.
 			g_caps.supported = 0
 				| BGFX_CAPS_ALPHA_TO_COVERAGE
 				| BGFX_CAPS_BLEND_INDEPENDENT
 				| BGFX_CAPS_COMPUTE
+				| BGFX_CAPS_CONDITIONAL_RENDER
 				| BGFX_CAPS_CONSERVATIVE_RASTER
 				| BGFX_CAPS_DRAW_INDIRECT
 				| BGFX_CAPS_FRAGMENT_DEPTH
@@ -24,6 +101,7 @@ namespace bgfx { namespace noop
 				| BGFX_CAPS_HIDPI
 				| BGFX_CAPS_INDEX32
 				| BGFX_CAPS_INSTANCING
+				| BGFX_CAPS_INSTANCING_LAYOUT
 				| BGFX_CAPS_OCCLUSION_QUERY
 				| BGFX_CAPS_RENDERER_MULTITHREADED
 				| BGFX_CAPS_SWAP_CHAIN
@@ -72,6 +150,10 @@ namespace bgfx { namespace noop
 
 		~RendererContextNOOP()
 		{
+			processReadback(true);
+			captureEnd();
+
+			bx::free(g_allocator, m_readbackData);
 		}
 
 		RendererType::Enum getRendererType() const override
@@ -89,6 +171,11 @@ namespace bgfx { namespace noop
 			return false;
 		}
 
+		bool isThreadSafe(CommandBuffer::Enum _command) const override
+		{
+			return CommandBuffer::CreateShader == _command;
+		}
+
 		void flip() override
 		{
 		}
@@ -215,8 +302,22 @@ namespace bgfx { namespace noop
 		{
 		}
 
-		void requestScreenShot(FrameBufferHandle /*_handle*/, const char* /*_filePath*/) override
+		void requestScreenShot(FrameBufferHandle /*_handle*/, const char* _filePath) override
 		{
+			// Default callback writes screen shot to disk, black image is delivered
+			// only to application provided callback.
+			if (!isCallbackUserProvided() )
+			{
+				return;
+			}
+
+			PendingReadback readback;
+			readback.m_filePath.set(_filePath);
+			readback.m_width     = m_resolution.width;
+			readback.m_height    = m_resolution.height;
+			readback.m_numFrames = BGFX_CONFIG_MAX_FRAME_LATENCY;
+			readback.m_capture   = false;
+			m_pendingReadback.push_back(readback);
 		}
 
 		void updateViewName(ViewId /*_id*/, const char* /*_name*/) override
@@ -244,6 +345,11 @@ namespace bgfx { namespace noop
 			const int64_t timerFreq = bx::getHPFrequency();
 			const int64_t timeBegin = bx::getHPCounter();
 
+			// Sorting is backend independent, running it keeps frontend state
+			// (GPU timer scopes, conditional render fallbacks) observable
+			// without GPU.
+			_render->sort();
+
 			Stats& perfStats = _render->m_perfStats;
 			perfStats.cpuTimeBegin  = timeBegin;
 			perfStats.cpuTimeEnd    = timeBegin;
@@ -256,8 +362,136 @@ namespace bgfx { namespace noop
 
 			bx::memSet(perfStats.numPrims, 0, sizeof(perfStats.numPrims) );
 
+			uint32_t statsKeyType[2] = {};
+
+			for (uint32_t item = 0, numItems = _render->m_numRenderItems; item < numItems; ++item)
+			{
+				SortKey key;
+				const bool isCompute = key.decode(_render->m_sortKeys[item], _render->m_viewRemap);
+				statsKeyType[isCompute]++;
+			}
+
+			perfStats.numDraw    = statsKeyType[0];
+			perfStats.numCompute = statsKeyType[1];
+			perfStats.numBlit    = _render->m_numBlitItems;
+
 			perfStats.gpuMemoryMax  = -INT64_MAX;
 			perfStats.gpuMemoryUsed = -INT64_MAX;
+
+			m_gpuTimer.frame();
+			m_gpuTimerScopes.begin(_render, &m_gpuTimer, 0);
+
+			if (0 != _render->m_numGpuTimerScopes)
+			{
+				for (uint32_t item = 0, numItems = _render->m_numRenderItems; item <= numItems; ++item)
+				{
+					m_gpuTimer.m_timestamp = item;
+					m_gpuTimerScopes.update(item);
+				}
+			}
+
+			m_gpuTimerScopes.end();
+
+			updateCapture(_render->m_resolution);
+			processReadback(false);
+
+			if (m_capture)
+			{
+				PendingReadback readback;
+				readback.m_width     = m_captureWidth;
+				readback.m_height    = m_captureHeight;
+				readback.m_numFrames = BGFX_CONFIG_MAX_FRAME_LATENCY;
+				readback.m_capture   = true;
+				m_pendingReadback.push_back(readback);
+			}
+		}
+
+		void updateCapture(const Resolution& _resolution)
+		{
+			const bool capture = true
+				&& !!(_resolution.reset & BGFX_RESET_CAPTURE)
+				&& isCallbackUserProvided()
+				;
+
+			if (m_capture != capture
+			||  m_resolution.width  != _resolution.width
+			||  m_resolution.height != _resolution.height)
+			{
+				processReadback(true);
+				captureEnd();
+
+				m_resolution = _resolution;
+
+				if (capture)
+				{
+					m_captureWidth  = _resolution.width;
+					m_captureHeight = _resolution.height;
+					m_capture       = true;
+					g_callback->captureBegin(m_captureWidth, m_captureHeight, m_captureWidth*4, TextureFormat::BGRA8, false);
+				}
+			}
+		}
+
+		void captureEnd()
+		{
+			if (m_capture)
+			{
+				g_callback->captureEnd();
+				m_capture = false;
+			}
+		}
+
+		// Fake readback, delivers black BGRA8 image with the same latency
+		// GPU backends have, so capture paths can be exercised headless.
+		void processReadback(bool _finishAll)
+		{
+			uint32_t numCompleted = 0;
+
+			for (PendingReadback& readback : m_pendingReadback)
+			{
+				if (!_finishAll
+				&&  0 < readback.m_numFrames)
+				{
+					// All requests have the same latency, completed ones are
+					// always at the front.
+					--readback.m_numFrames;
+					continue;
+				}
+
+				++numCompleted;
+
+				const uint32_t pitch = readback.m_width*4;
+				const uint32_t size  = readback.m_height*pitch;
+
+				if (size > m_readbackSize)
+				{
+					m_readbackSize = size;
+					m_readbackData = bx::realloc(g_allocator, m_readbackData, size);
+					bx::memSet(m_readbackData, 0, size);
+				}
+
+				if (readback.m_capture)
+				{
+					if (m_capture)
+					{
+						g_callback->captureFrame(m_readbackData, size);
+					}
+				}
+				else
+				{
+					g_callback->screenShot(
+						  readback.m_filePath.getCPtr()
+						, readback.m_width
+						, readback.m_height
+						, pitch
+						, m_readbackData
+						, size
+						, false
+						);
+				}
+			}
+
+			m_pendingReadback.erase(m_pendingReadback.begin(), m_pendingReadback.begin() + numCompleted);
 		}
 
 		void blitSetup(TextVideoMemBlitter& /*_blitter*/) override
@@ -267,6 +501,27 @@ namespace bgfx { namespace noop
 		void blitRender(TextVideoMemBlitter& /*_blitter*/, uint32_t /*_numIndices*/) override
 		{
 		}
+
+		struct PendingReadback
+		{
+			bx::FilePath m_filePath;
+			uint32_t     m_width;
+			uint32_t     m_height;
+			uint32_t     m_numFrames;
+			bool         m_capture;
+		};
+
+		typedef stl::vector<PendingReadback> PendingReadbackArray;
+
+		PendingReadbackArray m_pendingReadback;
+		TimerQueryNOOP m_gpuTimer;
+		GpuTimerScopes<TimerQueryNOOP> m_gpuTimerScopes;
+		Resolution m_resolution;
+		void*      m_readbackData;
+		uint32_t   m_readbackSize;
+		uint32_t   m_captureWidth;
+		uint32_t   m_captureHeight;
+		bool       m_capture;
 	};
 
 	static RendererContextNOOP* s_renderNOOP;
@@ -356,6 +356,7 @@ VK_IMPORT_DEVICE
 	{
 		enum Enum
 		{
+			EXT_conditional_rendering,
 			EXT_conservative_rasterization,
 			EXT_custom_border_color,
 			EXT_debug_report,
@@ -381,6 +382,7 @@ VK_IMPORT_DEVICE
 	//
 	static Extension s_extension[] =
 	{
+		{ "VK_EXT_conditional_rendering",           1, false, false, true,                                                          Layer::Count },
 		{ "VK_EXT_conservative_rasterization",      1, false, false, true,                                                          Layer::Count },
 		{ "VK_EXT_custom_border_color",             1, false, false, true,                                                          Layer::Count },
 		{ "VK_EXT_debug_report",                    1, false, false, false,                                                         Layer::Count },
@@ -461,7 +463,7 @@ VK_IMPORT_DEVICE
 	};
 	BX_STATIC_ASSERT(AttribType::Count == BX_COUNTOF(s_attribType) );
 
-	void fillVertexLayout(const ShaderVK* _vsh, VkPipelineVertexInputStateCreateInfo& _vertexInputState, const VertexLayout& _layout)
+	void fillVertexLayout(const ShaderVK* _vsh, VkPipelineVertexInputStateCreateInfo& _vertexInputState, const VertexLayout& _layout, VkVertexInputRate _inputRate = VK_VERTEX_INPUT_RATE_VERTEX)
 	{
 		uint32_t numBindings = _vertexInputState.vertexBindingDescriptionCount;
 		uint32_t numAttribs  = _vertexInputState.vertexAttributeDescriptionCount;
@@ -470,7 +472,7 @@ VK_IMPORT_DEVICE
 
 		inputBinding->binding   = numBindings;
 		inputBinding->stride    = _layout.m_stride;
-		inputBinding->inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+		inputBinding->inputRate = _inputRate;
 
 		for (uint32_t attr = 0; attr < Attrib::Count; ++attr)
 		{
@@ -1113,13 +1115,13 @@ VK_IMPORT_DEVICE
 	{
 		RendererContextVK()
 			: m_allocatorCb(NULL)
+			, m_updateTexture({ kInvalidHandle })
+			, m_updateStagingBuffer(VK_NULL_HANDLE)
 			, m_renderDocDll(NULL)
 			, m_vulkan1Dll(NULL)
 			, m_maxAnisotropy(1.0f)
 			, m_depthClamp(false)
 			, m_wireframe(false)
-			, m_captureBuffer(VK_NULL_HANDLE)
-			, m_captureMemory(VK_NULL_HANDLE)
 			, m_captureSize(0)
 		{
 		}
@@ -1152,9 +1154,11 @@ VK_IMPORT_DEVICE
 			const void* nextFeatures = NULL;
 			VkPhysicalDeviceLineRasterizationFeaturesEXT lineRasterizationFeatures;
 			VkPhysicalDeviceCustomBorderColorFeaturesEXT customBorderColorFeatures;
+			VkPhysicalDeviceConditionalRenderingFeaturesEXT conditionalRenderingFeatures;
 
 			bx::memSet(&lineRasterizationFeatures, 0, sizeof(lineRasterizationFeatures) );
 			bx::memSet(&customBorderColorFeatures, 0, sizeof(customBorderColorFeatures) );
+			bx::memSet(&conditionalRenderingFeatures, 0, sizeof(conditionalRenderingFeatures) );
 
 			m_fbh.idx = kInvalidHandle;
 			bx::memSet(m_uniforms, 0, sizeof(m_uniforms) );
@@ -1547,6 +1551,14 @@ VK_IMPORT_INSTANCE
 						customBorderColorFeatures.pNext = NULL;
 					}
 
+					if (s_extension[Extension::EXT_conditional_rendering].m_supported)
+					{
+						next->pNext = (VkBaseOutStructure*)&conditionalRenderingFeatures;
+						next = (VkBaseOutStructure*)&conditionalRenderingFeatures;
+						conditionalRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+						conditionalRenderingFeatures.pNext = NULL;
+					}
+
 					nextFeatures = deviceFeatures2.pNext;
 
 					vkGetPhysicalDeviceFeatures2KHR(m_physicalDevice, &deviceFeatures2);
@@ -1589,6 +1601,11 @@ VK_IMPORT_INSTANCE
 					&& customBorderColorFeatures.customBorderColors
 					;
 
+				m_conditionalRenderSupport = true
+					&& s_extension[Extension::EXT_conditional_rendering].m_supported
+					&& conditionalRenderingFeatures.conditionalRendering
+					;
+
 				m_timerQuerySupport = m_deviceProperties.limits.timestampComputeAndGraphics;
 
 				const bool indirectDrawSupport = true
@@ -1605,6 +1622,7 @@ VK_IMPORT_INSTANCE
 					| BGFX_CAPS_IMAGE_RW
 					| (m_deviceFeatures.fullDrawIndexUint32 ? BGFX_CAPS_INDEX32 : 0)
 					| BGFX_CAPS_INSTANCING
+					| BGFX_CAPS_INSTANCING_LAYOUT
 					| BGFX_CAPS_OCCLUSION_QUERY
 					| (!headless ? BGFX_CAPS_SWAP_CHAIN : 0)
 					| BGFX_CAPS_TEXTURE_2D_ARRAY
@@ -1623,6 +1641,7 @@ VK_IMPORT_INSTANCE
 					| (s_extension[Extension::EXT_conservative_rasterization ].m_supported ? BGFX_CAPS_CONSERVATIVE_RASTER  : 0)
 					| (s_extension[Extension::EXT_shader_viewport_index_layer].m_supported ? BGFX_CAPS_VIEWPORT_LAYER_ARRAY : 0)
 					| (s_extension[Extension::KHR_draw_indirect_count        ].m_supported && indirectDrawSupport ? BGFX_CAPS_DRAW_INDIRECT_COUNT : 0)
+					| (m_conditionalRenderSupport ? BGFX_CAPS_CONDITIONAL_RENDER : 0)
 					;
 
 				const uint32_t maxAttachments = bx::min<uint32_t>(m_deviceProperties.limits.maxFragmentOutputAttachments, m_deviceProperties.limits.maxColorAttachments);
@@ -1890,6 +1909,11 @@ VK_IMPORT_DEVICE
 					goto error;
 				}
 
+				m_memoryAllocator.init(
+					  BGFX_CONFIG_GPU_MEMORY_BLOCK_SIZE
+					, m_deviceProperties.limits.bufferImageGranularity
+					);
+
 				result = m_cmd.alloc(&m_commandBuffer);
 
 				if (VK_SUCCESS != result)
@@ -1984,6 +2008,7 @@ VK_IMPORT_DEVICE
 				{
 					BX_TRACE("Create scratch buffer %d", ii);
 					m_scratchBuffer[ii].create(size, count);
+					m_stagingBuffer[ii].create(BGFX_CONFIG_STAGING_BUFFER_CHUNK_SIZE);
 				}
 			}
 
@@ -2021,6 +2046,15 @@ VK_IMPORT_DEVICE
 					BX_TRACE("Init error: creating GPU timer failed %d: %s.", result, getName(result) );
 					goto error;
 				}
+
+				result = m_gpuTimerScopeQuery.init();
+
+				if (VK_SUCCESS != result)
+				{
+					BX_TRACE("Init error: creating GPU timer scope query failed %d: %s.", result, getName(result) );
+					m_gpuTimer.shutdown();
+					goto error;
+				}
 			}
 
 			errorState = ErrorState::TimerQueryCreated;
@@ -2043,6 +2077,7 @@ VK_IMPORT_DEVICE
 			case ErrorState::TimerQueryCreated:
 				if (m_timerQuerySupport)
 				{
+					m_gpuTimerScopeQuery.shutdown();
 					m_gpuTimer.shutdown();
 				}
 				[[fallthrough]];
@@ -2051,6 +2086,7 @@ VK_IMPORT_DEVICE
 				for (uint32_t ii = 0; ii < m_numFramesInFlight; ++ii)
 				{
 					m_scratchBuffer[ii].destroy();
+					m_stagingBuffer[ii].destroy();
 				}
 				vkDestroy(m_pipelineCache);
 				vkDestroy(m_descriptorPool);
@@ -2062,6 +2098,7 @@ VK_IMPORT_DEVICE
 
 			case ErrorState::CommandQueueCreated:
 				m_cmd.shutdown();
+				m_memoryAllocator.shutdown();
 				[[fallthrough]];
 
 			case ErrorState::DeviceCreated:
@@ -2097,6 +2134,7 @@ VK_IMPORT_DEVICE
 
 			if (m_timerQuerySupport)
 			{
+				m_gpuTimerScopeQuery.shutdown();
 				m_gpuTimer.shutdown();
 			}
 			m_occlusionQuery.shutdown();
@@ -2113,6 +2151,7 @@ VK_IMPORT_DEVICE
 			for (uint32_t ii = 0; ii < m_numFramesInFlight; ++ii)
 			{
 				m_scratchBuffer[ii].destroy();
+				m_stagingBuffer[ii].destroy();
 			}
 
 			for (uint32_t ii = 0; ii < BX_COUNTOF(m_frameBuffers); ++ii)
@@ -2143,6 +2182,7 @@ VK_IMPORT_DEVICE
 			m_backBuffer.destroy();
 
 			m_cmd.shutdown();
+			m_memoryAllocator.shutdown();
 
 			vkDestroy(m_pipelineCache);
 			vkDestroy(m_descriptorPool);
@@ -2177,6 +2217,12 @@ VK_IMPORT_DEVICE
 			return false;
 		}
 
+		bool isThreadSafe(CommandBuffer::Enum _command) const override
+		{
+			// Shader module creation is free-threaded, and it only reads uniform registry.
+			return CommandBuffer::CreateShader == _command;
+		}
+
 		void flip() override
 		{
 			int64_t start = bx::getHPCounter();
@@ -2283,17 +2329,70 @@ VK_IMPORT_DEVICE
 			return m_textures[_handle.idx].create(m_commandBuffer, _mem, _flags, _skip);
 		}
 
-		void updateTextureBegin(TextureHandle /*_handle*/, uint8_t /*_side*/, uint8_t /*_mip*/) override
+		void updateTextureBegin(TextureHandle _handle, uint8_t /*_side*/, uint8_t /*_mip*/) override
 		{
+			m_updateTexture = _handle;
 		}
 
 		void updateTexture(TextureHandle _handle, uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem) override
 		{
-			m_textures[_handle.idx].update(m_commandBuffer, _side, _mip, _rect, _z, _depth, _pitch, _mem);
+			BX_ASSERT(m_updateTexture.idx == _handle.idx, "updateTexture must be called between updateTextureBegin/End.");
+
+			VkBufferImageCopy region;
+			const VkBuffer stagingBuffer = m_textures[_handle.idx].update(_side, _mip, _rect, _z, _depth, _pitch, _mem, region);
+
+			if (stagingBuffer != m_updateStagingBuffer
+			||  overlapsTextureUpdate(region) )
+			{
+				flushTextureUpdate();
+				m_updateStagingBuffer = stagingBuffer;
+			}
+
+			m_updateRegions.push_back(region);
 		}
 
 		void updateTextureEnd() override
 		{
+			flushTextureUpdate();
+			m_updateTexture.idx = kInvalidHandle;
+		}
+
+		bool overlapsTextureUpdate(const VkBufferImageCopy& _region) const
+		{
+			// Destination regions of single vkCmdCopyBufferToImage must not overlap.
+			for (const VkBufferImageCopy& region : m_updateRegions)
+			{
+				if (region.imageSubresource.mipLevel       == _region.imageSubresource.mipLevel
+				&&  region.imageSubresource.baseArrayLayer == _region.imageSubresource.baseArrayLayer
+				&&  region.imageOffset.x < _region.imageOffset.x + int32_t(_region.imageExtent.width)
+				&&  region.imageOffset.y < _region.imageOffset.y + int32_t(_region.imageExtent.height)
+				&&  region.imageOffset.z < _region.imageOffset.z + int32_t(_region.imageExtent.depth)
+				&&  _region.imageOffset.x < region.imageOffset.x + int32_t(region.imageExtent.width)
+				&&  _region.imageOffset.y < region.imageOffset.y + int32_t(region.imageExtent.height)
+				&&  _region.imageOffset.z < region.imageOffset.z + int32_t(region.imageExtent.depth) )
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void flushTextureUpdate()
+		{
+			if (!m_updateRegions.empty() )
+			{
+				m_textures[m_updateTexture.idx].copyBufferToTexture(
+					  m_commandBuffer
+					, m_updateStagingBuffer
+					, uint32_t(m_updateRegions.size() )
+					, m_updateRegions.data()
+					);
+
+				m_updateRegions.clear();
+			}
+
+			m_updateStagingBuffer = VK_NULL_HANDLE;
 		}
 
 		void readTexture(TextureHandle _handle, void* _data, uint8_t _mip) override
@@ -2452,31 +2551,20 @@ VK_IMPORT_DEVICE
 				return;
 			}
 
-			auto callback = [](void* _src, uint32_t _width, uint32_t _height, uint32_t _pitch, const void* _userData)
-			{
-				const char* filePath = (const char*)_userData;
-				g_callback->screenShot(
-					  filePath
-					, _width
-					, _height
-					, _pitch
-					, _src
-					, _height * _pitch
-					, false
-					);
-			};
-
 			const uint8_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(swapChain.m_colorFormat) );
 			const uint32_t size = frameBuffer.m_width * frameBuffer.m_height * bpp / 8;
 
-			VkDeviceMemory stagingMemory;
-			VkBuffer stagingBuffer;
-			VK_CHECK(createReadbackBuffer(size, &stagingBuffer, &stagingMemory) );
+			SwapChainReadback readback;
+			readback.m_filePath.set(_filePath);
+			readback.m_capture = false;
+			VK_CHECK(createReadbackBuffer(size, &readback.m_buffer, &readback.m_memory) );
 
-			readSwapChain(swapChain, stagingBuffer, stagingMemory, callback, _filePath);
+			copySwapChain(swapChain, readback);
 
-			vkDestroy(stagingBuffer);
-			vkDestroy(stagingMemory);
+			// Swap chain image is presented before next frame's command buffer
+			// executes, submit copy now. Result is delivered from submit once GPU
+			// is done with it, without waiting here.
+			kick();
 		}
 
 		void updateViewName(ViewId _id, const char* _name) override
@@ -2559,6 +2647,15 @@ VK_IMPORT_DEVICE
 			}
 		}
 
+		void release(DeviceMemoryAllocationVK& _allocation)
+		{
+			if (VK_NULL_HANDLE != _allocation.m_memory)
+			{
+				m_cmd.release(_allocation);
+				_allocation = DeviceMemoryAllocationVK();
+			}
+		}
+
 		void submitBlit(BlitState& _bs, uint16_t _view);
 
 		void submit(Frame* _render, ClearQuad& _clearQuad, TextVideoMemBlitter& _textVideoMemBlitter) override;
@@ -2689,14 +2786,25 @@ VK_IMPORT_DEVICE
 				m_frameBuffers[ii].preReset();
 			}
 
+			if (!m_swapChainReadback.empty() )
+			{
+				VK_CHECK(vkQueueWaitIdle(m_cmd.m_queue) );
+				processSwapChainReadback(true);
+			}
+
 			if (m_captureSize > 0)
 			{
 				g_callback->captureEnd();
-
-				release(m_captureBuffer);
-				release(m_captureMemory);
 				m_captureSize = 0;
 			}
+
+			for (CaptureBuffer& buffer : m_captureBuffer)
+			{
+				release(buffer.m_buffer);
+				release(buffer.m_memory);
+			}
+
+			m_captureBuffer.clear();
 		}
 
 		void postReset()
@@ -2714,14 +2822,7 @@ VK_IMPORT_DEVICE
 				const uint8_t dstBpp = bimg::getBitsPerPixel(bimg::TextureFormat::BGRA8);
 				const uint32_t dstPitch = m_backBuffer.m_width * dstBpp / 8;
 
-				if (captureSize > m_captureSize)
-				{
-					release(m_captureBuffer);
-					release(m_captureMemory);
-
-					m_captureSize = captureSize;
-					VK_CHECK(createReadbackBuffer(m_captureSize, &m_captureBuffer, &m_captureMemory) );
-				}
+				m_captureSize = captureSize;
 
 				g_callback->captureBegin(m_resolution.width, m_resolution.height, dstPitch, TextureFormat::BGRA8, false);
 			}
@@ -3092,7 +3193,7 @@ VK_IMPORT_DEVICE
 			_desc.maxDepthBounds = 1.0f;
 		}
 
-		void setInputLayout(VkPipelineVertexInputStateCreateInfo& _vertexInputState, uint8_t _numStream, const VertexLayout** _layout, const ProgramVK& _program, uint8_t _numInstanceData)
+		void setInputLayout(VkPipelineVertexInputStateCreateInfo& _vertexInputState, uint8_t _numStream, const VertexLayout** _layout, const ProgramVK& _program, uint8_t _numInstanceData, const VertexLayout* _instanceLayout = NULL)
 		{
 			_vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 			_vertexInputState.pNext = NULL;
@@ -3104,11 +3205,37 @@ VK_IMPORT_DEVICE
 			uint16_t unsettedAttr[Attrib::Count];
 			bx::memCopy(unsettedAttr, _program.m_vsh->m_attrMask, sizeof(uint16_t) * Attrib::Count);
 
+			uint16_t attrMask[Attrib::Count];
+			bx::memCopy(attrMask, _program.m_vsh->m_attrMask, sizeof(attrMask) );
+
+			VertexLayout instanceLayout;
+			if (NULL != _instanceLayout)
+			{
+				// Attributes provided by the instance layout take precedence
+				// over vertex streams.
+				bx::memCopy(&instanceLayout, _instanceLayout, sizeof(VertexLayout) );
+
+				bool bound = false;
+				for (uint32_t ii = 0; ii < Attrib::Count; ++ii)
+				{
+					uint16_t attr = instanceLayout.m_attributes[ii] & attrMask[ii];
+					instanceLayout.m_attributes[ii] = attr == 0 || attr == UINT16_MAX ? UINT16_MAX : attr;
+
+					if (UINT16_MAX != instanceLayout.m_attributes[ii])
+					{
+						attrMask[ii]     = 0;
+						unsettedAttr[ii] = 0;
+						bound = true;
+					}
+				}
+
+				BX_WARN(bound, "Instance data layout doesn't provide any attribute used by the program.");
+			}
+
 			for (uint8_t stream = 0; stream < _numStream; ++stream)
 			{
 				VertexLayout layout;
 				bx::memCopy(&layout, _layout[stream], sizeof(VertexLayout) );
-				const uint16_t* attrMask = _program.m_vsh->m_attrMask;
 
 				for (uint32_t ii = 0; ii < Attrib::Count; ++ii)
 				{
@@ -3139,7 +3266,11 @@ VK_IMPORT_DEVICE
 				}
 			}
 
-			if (0 < _numInstanceData)
+			if (NULL != _instanceLayout)
+			{
+				fillVertexLayout(_program.m_vsh, _vertexInputState, instanceLayout, VK_VERTEX_INPUT_RATE_INSTANCE);
+			}
+			else if (0 < _numInstanceData)
 			{
 				fillInstanceBinding(_program.m_vsh, _vertexInputState, _numInstanceData);
 			}
@@ -3529,7 +3660,7 @@ VK_IMPORT_DEVICE
 			return pipeline;
 		}
 
-		VkPipeline getPipeline(uint64_t _state, uint64_t _stencil, uint8_t _numStreams, const VertexLayout** _layouts, ProgramHandle _program, uint8_t _numInstanceData)
+		VkPipeline getPipeline(uint64_t _state, uint64_t _stencil, uint8_t _numStreams, const VertexLayout** _layouts, ProgramHandle _program, uint8_t _numInstanceData, const VertexLayout* _instanceLayout = NULL)
 		{
 			ProgramVK& program = m_program[_program.idx];
 
@@ -3588,6 +3719,7 @@ VK_IMPORT_DEVICE
 
 			murmur.add(layout.m_attributes, sizeof(layout.m_attributes) );
 			murmur.add(_numInstanceData);
+			murmur.add(NULL != _instanceLayout ? _instanceLayout->m_hash : 0);
 			murmur.add(frameBuffer.m_renderPass);
 			const uint32_t hash = murmur.end();
 
@@ -3640,7 +3772,7 @@ VK_IMPORT_DEVICE
 			VkPipelineVertexInputStateCreateInfo vertexInputState;
 			vertexInputState.pVertexBindingDescriptions   = inputBinding;
 			vertexInputState.pVertexAttributeDescriptions = inputAttrib;
-			setInputLayout(vertexInputState, _numStreams, _layouts, program, _numInstanceData);
+			setInputLayout(vertexInputState, _numStreams, _layouts, program, _numInstanceData, _instanceLayout);
 
 			const VkDynamicState dynamicStates[] =
 			{
@@ -4016,39 +4148,59 @@ VK_IMPORT_DEVICE
 				;
 		}
 
-		typedef void (*SwapChainReadFunc)(void* /*src*/, uint32_t /*width*/, uint32_t /*height*/, uint32_t /*pitch*/, const void* /*userData*/);
-
-		bool readSwapChain(const SwapChainVK& _swapChain, VkBuffer _buffer, VkDeviceMemory _memory, SwapChainReadFunc _func, const void* _userData = NULL)
+		void copySwapChain(const SwapChainVK& _swapChain, SwapChainReadback& _readback)
 		{
-			if (isSwapChainReadable(_swapChain) )
-			{
-				// source for the copy is the last rendered swapchain image
-				const VkImage image = _swapChain.m_backBufferColorImage[_swapChain.m_backBufferColorIdx];
-				const VkImageLayout layout = _swapChain.m_backBufferColorImageLayout[_swapChain.m_backBufferColorIdx];
+			// source for the copy is the last rendered swapchain image
+			const VkImage image = _swapChain.m_backBufferColorImage[_swapChain.m_backBufferColorIdx];
+			const VkImageLayout layout = _swapChain.m_backBufferColorImageLayout[_swapChain.m_backBufferColorIdx];
 
-				const uint32_t width  = _swapChain.m_sci.imageExtent.width;
-				const uint32_t height = _swapChain.m_sci.imageExtent.height;
+			const uint32_t width  = _swapChain.m_sci.imageExtent.width;
+			const uint32_t height = _swapChain.m_sci.imageExtent.height;
 
-				ReadbackVK readback;
-				readback.create(image, width, height, _swapChain.m_colorFormat);
-				const uint32_t pitch = readback.pitch();
+			ReadbackVK readback;
+			readback.create(image, width, height, _swapChain.m_colorFormat);
+			readback.copyImageToBuffer(m_commandBuffer, _readback.m_buffer, layout, VK_IMAGE_ASPECT_COLOR_BIT);
 
-				readback.copyImageToBuffer(m_commandBuffer, _buffer, layout, VK_IMAGE_ASPECT_COLOR_BIT);
+			_readback.m_width     = width;
+			_readback.m_height    = height;
+			_readback.m_pitch     = readback.pitch();
+			_readback.m_format    = _swapChain.m_colorFormat;
+			_readback.m_completed = m_cmd.m_submitted + m_cmd.m_numFramesInFlight;
 
-				// stall for commandbuffer to finish
-				kick(true);
+			readback.destroy();
+
+			m_swapChainReadback.push_back(_readback);
+		}
+
+		void processSwapChainReadback(bool _finishAll)
+		{
+			uint32_t numCompleted = 0;
+
+			for (SwapChainReadback& readback : m_swapChainReadback)
+			{
+				if (!_finishAll
+				&&  readback.m_completed > m_cmd.m_submitted)
+				{
+					break;
+				}
+
+				++numCompleted;
 
 				uint8_t* src;
-				VK_CHECK(vkMapMemory(m_device, _memory, 0, VK_WHOLE_SIZE, 0, (void**)&src) );
+				VK_CHECK(vkMapMemory(m_device, readback.m_memory, 0, VK_WHOLE_SIZE, 0, (void**)&src) );
+
+				const uint32_t width  = readback.m_width;
+				const uint32_t height = readback.m_height;
+				const uint32_t pitch  = readback.m_pitch;
 
-				if (_swapChain.m_colorFormat == TextureFormat::RGBA8)
+				if (readback.m_format == TextureFormat::RGBA8)
 				{
 					bimg::imageSwizzleBgra8(src, pitch, width, height, src, pitch);
-					_func(src, width, height, pitch, _userData);
+					deliverSwapChainReadback(readback, src, pitch);
 				}
-				else if (_swapChain.m_colorFormat == TextureFormat::BGRA8)
+				else if (readback.m_format == TextureFormat::BGRA8)
 				{
-					_func(src, width, height, pitch, _userData);
+					deliverSwapChainReadback(readback, src, pitch);
 				}
 				else
 				{
@@ -4058,36 +4210,80 @@ VK_IMPORT_DEVICE
 
 					void* dst = bx::alloc(g_allocator, dstSize);
 
-					bimg::imageConvert(g_allocator, dst, bimg::TextureFormat::BGRA8, src, bimg::TextureFormat::Enum(_swapChain.m_colorFormat), width, height, 1);
+					bimg::imageConvert(g_allocator, dst, bimg::TextureFormat::BGRA8, src, bimg::TextureFormat::Enum(readback.m_format), width, height, 1);
 
-					_func(dst, width, height, dstPitch, _userData);
+					deliverSwapChainReadback(readback, dst, dstPitch);
 
 					bx::free(g_allocator, dst);
 				}
 
-				vkUnmapMemory(m_device, _memory);
+				vkUnmapMemory(m_device, readback.m_memory);
 
-				readback.destroy();
-
-				return true;
+				if (readback.m_capture)
+				{
+					CaptureBuffer buffer;
+					buffer.m_buffer = readback.m_buffer;
+					buffer.m_memory = readback.m_memory;
+					m_captureBuffer.push_back(buffer);
+				}
+				else
+				{
+					vkDestroy(readback.m_buffer);
+					vkDestroy(readback.m_memory);
+				}
 			}
 
-			return false;
+			m_swapChainReadback.erase(m_swapChainReadback.begin(), m_swapChainReadback.begin() + numCompleted);
+		}
+
+		void deliverSwapChainReadback(const SwapChainReadback& _readback, void* _data, uint32_t _pitch)
+		{
+			const uint32_t size = _readback.m_height * _pitch;
+
+			if (_readback.m_capture)
+			{
+				if (m_captureSize > 0)
+				{
+					g_callback->captureFrame(_data, size);
+				}
+			}
+			else
+			{
+				g_callback->screenShot(
+					  _readback.m_filePath.getCPtr()
+					, _readback.m_width
+					, _readback.m_height
+					, _pitch
+					, _data
+					, size
+					, false
+					);
+			}
 		}
 
 		void capture()
 		{
-			if (m_captureSize > 0)
+			if (m_captureSize > 0
+			&&  isSwapChainReadable(m_backBuffer.m_swapChain) )
 			{
 				m_backBuffer.resolve();
 
-				auto callback = [](void* _src, uint32_t /*_width*/, uint32_t _height, uint32_t _pitch, const void* /*_userData*/)
+				SwapChainReadback readback;
+				readback.m_capture = true;
+
+				if (m_captureBuffer.empty() )
 				{
-					const uint32_t size = _height * _pitch;
-					g_callback->captureFrame(_src, size);
-				};
+					VK_CHECK(createReadbackBuffer(m_captureSize, &readback.m_buffer, &readback.m_memory) );
+				}
+				else
+				{
+					const CaptureBuffer& buffer = m_captureBuffer.back();
+					readback.m_buffer = buffer.m_buffer;
+					readback.m_memory = buffer.m_memory;
+					m_captureBuffer.pop_back();
+				}
 
-				readSwapChain(m_backBuffer.m_swapChain, m_captureBuffer, m_captureMemory, callback);
+				copySwapChain(m_backBuffer.m_swapChain, readback);
 			}
 		}
 
@@ -4291,6 +4487,15 @@ VK_IMPORT_DEVICE
 			m_cmd.kick(_finishAll);
 			VK_CHECK(m_cmd.alloc(&m_commandBuffer) );
 			m_cmd.finish(_finishAll);
+
+			// Fence for this frame in flight was waited on in alloc, GPU is done
+			// reading from its staging memory.
+			m_stagingBuffer[m_cmd.m_currentFrameInFlight].reset();
+		}
+
+		StagingAllocVK allocStaging(uint32_t _size, uint32_t _align)
+		{
+			return m_stagingBuffer[m_cmd.m_currentFrameInFlight].alloc(_size, _align);
 		}
 
 		int32_t selectMemoryType(uint32_t _memoryTypeBits, uint32_t _propertyFlags, int32_t _startIndex = 0) const
@@ -4428,6 +4633,7 @@ VK_IMPORT_DEVICE
 
 		bool m_lineAASupport;
 		bool m_borderColorSupport;
+		bool m_conditionalRenderSupport;
 		bool m_timerQuerySupport;
 
 		FrameBufferVK m_backBuffer;
@@ -4438,11 +4644,18 @@ VK_IMPORT_DEVICE
 		int64_t m_presentElapsed;
 
 		ScratchBufferVK m_scratchBuffer[BGFX_CONFIG_MAX_FRAME_LATENCY];
+		StagingBufferVK m_stagingBuffer[BGFX_CONFIG_MAX_FRAME_LATENCY];
+
+		TextureHandle m_updateTexture;
+		VkBuffer m_updateStagingBuffer;
+		stl::vector<VkBufferImageCopy> m_updateRegions;
 
 		uint32_t        m_numFramesInFlight;
 		CommandQueueVK  m_cmd;
 		VkCommandBuffer m_commandBuffer;
 
+		MemoryAllocatorVK m_memoryAllocator;
+
 		VkDevice m_device;
 		uint32_t m_globalQueueFamily;
 		VkQueue  m_globalQueue;
@@ -4450,6 +4663,8 @@ VK_IMPORT_DEVICE
 		VkPipelineCache  m_pipelineCache;
 
 		TimerQueryVK m_gpuTimer;
+		TimerScopeQueryVK m_gpuTimerScopeQuery;
+		GpuTimerScopes<TimerScopeQueryVK> m_gpuTimerScopes;
 		OcclusionQueryVK m_occlusionQuery;
 
 		void* m_renderDocDll;
@@ -4479,9 +4694,31 @@ VK_IMPORT_DEVICE
 		bool m_depthClamp;
 		bool m_wireframe;
 
-		VkBuffer m_captureBuffer;
-		VkDeviceMemory m_captureMemory;
-		uint32_t m_captureSize;
+		struct SwapChainReadback
+		{
+			bx::FilePath        m_filePath;
+			VkBuffer            m_buffer;
+			VkDeviceMemory      m_memory;
+			uint64_t            m_completed;
+			uint32_t            m_width;
+			uint32_t            m_height;
+			uint32_t            m_pitch;
+			TextureFormat::Enum m_format;
+			bool                m_capture;
+		};
+
+		struct CaptureBuffer
+		{
+			VkBuffer       m_buffer;
+			VkDeviceMemory m_memory;
+		};
+
+		typedef stl::vector<SwapChainReadback> SwapChainReadbackArray;
+		typedef stl::vector<CaptureBuffer>     CaptureBufferArray;
+
+		SwapChainReadbackArray m_swapChainReadback;
+		CaptureBufferArray     m_captureBuffer;
+		uint32_t               m_captureSize;
 
 		TextVideoMem m_textVideoMem;
 
@@ -4569,6 +4806,220 @@ VK_DESTROY
 		s_renderVK->release(_obj);
 	}
 
+	void MemoryAllocatorVK::init(VkDeviceSize _blockSize, VkDeviceSize _bufferImageGranularity)
+	{
+		m_blockSize = _blockSize;
+		m_bufferImageGranularity = bx::max<VkDeviceSize>(_bufferImageGranularity, 1);
+
+		bx::memSet(m_numDedicated,  0, sizeof(m_numDedicated)  );
+		bx::memSet(m_dedicatedSize, 0, sizeof(m_dedicatedSize) );
+	}
+
+	void MemoryAllocatorVK::shutdown()
+	{
+		for (Block* block : m_blocks)
+		{
+			if (NULL != block)
+			{
+				vkDestroy(block->m_memory);
+				block->m_allocator.shutdown();
+				bx::deleteObject(g_allocator, block);
+			}
+		}
+
+		m_blocks.clear();
+	}
+
+	VkResult MemoryAllocatorVK::alloc(const VkMemoryRequirements& _requirements, VkMemoryPropertyFlags _flags, bool _linear, DeviceMemoryAllocationVK* _allocation)
+	{
+		// Suballocations are aligned to minimum allocation size. When it's
+		// not smaller than bufferImageGranularity, linear and optimal
+		// resources never share page and can be placed in same block.
+		const bool linear = _linear || m_bufferImageGranularity <= BGFX_CONFIG_GPU_MEMORY_MIN_ALLOC_SIZE;
+
+		VkResult result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+		int32_t memoryType = s_renderVK->selectMemoryType(_requirements.memoryTypeBits, _flags);
+		while (0 <= memoryType)
+		{
+			result = alloc(uint32_t(memoryType), _requirements, linear, _allocation);
+
+			if (VK_SUCCESS == result)
+			{
+				break;
+			}
+
+			memoryType = s_renderVK->selectMemoryType(_requirements.memoryTypeBits, _flags, memoryType + 1);
+		}
+
+		return result;
+	}
+
+	VkResult MemoryAllocatorVK::alloc(uint32_t _memoryType, const VkMemoryRequirements& _requirements, bool _linear, DeviceMemoryAllocationVK* _allocation)
+	{
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+		const VkDevice device = s_renderVK->m_device;
+
+		VkMemoryAllocateInfo ma;
+		ma.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		ma.pNext = NULL;
+		ma.memoryTypeIndex = _memoryType;
+
+		_allocation->m_memoryType = uint8_t(_memoryType);
+		_allocation->m_size       = _requirements.size;
+
+		if (_requirements.size      <= m_blockSize/2
+		&&  _requirements.alignment <= m_blockSize/2)
+		{
+			uint32_t freeSlot = UINT32_MAX;
+
+			for (uint32_t ii = 0, num = uint32_t(m_blocks.size() ); ii < num; ++ii)
+			{
+				Block* block = m_blocks[ii];
+
+				if (NULL == block)
+				{
+					freeSlot = bx::min(freeSlot, ii);
+				}
+				else if (block->m_memoryType == _memoryType
+				&&       block->m_linear     == _linear)
+				{
+					const uint64_t offset = block->m_allocator.alloc(_requirements.size, _requirements.alignment);
+
+					if (BuddyAllocator::kInvalidOffset != offset)
+					{
+						_allocation->m_memory = block->m_memory;
+						_allocation->m_offset = offset;
+						_allocation->m_block  = uint16_t(ii);
+						return VK_SUCCESS;
+					}
+				}
+			}
+
+			const uint32_t blockIdx = UINT32_MAX == freeSlot
+				? uint32_t(m_blocks.size() )
+				: freeSlot
+				;
+
+			ma.allocationSize = m_blockSize;
+
+			::VkDeviceMemory memory;
+			if (UINT16_MAX > blockIdx
+			&&  VK_SUCCESS == vkAllocateMemory(device, &ma, allocatorCb, &memory) )
+			{
+				Block* block = BX_NEW(g_allocator, Block);
+				block->m_memory     = memory;
+				block->m_memoryType = _memoryType;
+				block->m_linear     = _linear;
+				block->m_allocator.init(g_allocator, m_blockSize, BGFX_CONFIG_GPU_MEMORY_MIN_ALLOC_SIZE);
+
+				if (blockIdx == m_blocks.size() )
+				{
+					m_blocks.push_back(block);
+				}
+				else
+				{
+					m_blocks[blockIdx] = block;
+				}
+
+				_allocation->m_memory = memory;
+				_allocation->m_offset = block->m_allocator.alloc(_requirements.size, _requirements.alignment);
+				_allocation->m_block  = uint16_t(blockIdx);
+				return VK_SUCCESS;
+			}
+
+			// Block couldn't be allocated, try to allocate only what's needed.
+		}
+
+		ma.allocationSize = _requirements.size;
+
+		VkResult result = vkAllocateMemory(device, &ma, allocatorCb, &_allocation->m_memory);
+
+		if (VK_SUCCESS == result)
+		{
+			_allocation->m_offset = 0;
+			_allocation->m_block  = UINT16_MAX;
+
+			++m_numDedicated[_memoryType];
+			m_dedicatedSize[_memoryType] += _requirements.size;
+		}
+
+		return result;
+	}
+
+	void MemoryAllocatorVK::free(const DeviceMemoryAllocationVK& _allocation)
+	{
+		if (UINT16_MAX == _allocation.m_block)
+		{
+			--m_numDedicated[_allocation.m_memoryType];
+			m_dedicatedSize[_allocation.m_memoryType] -= _allocation.m_size;
+
+			VkDeviceMemory memory = _allocation.m_memory;
+			vkDestroy(memory);
+			return;
+		}
+
+		Block* block = m_blocks[_allocation.m_block];
+		block->m_allocator.free(_allocation.m_offset);
+
+		if (block->m_allocator.isEmpty() )
+		{
+			// Keep one empty block per memory type, so that recreating single
+			// resource doesn't allocate and free device memory every time.
+			for (const Block* other : m_blocks)
+			{
+				if (NULL  != other
+				&&  block != other
+				&&  other->m_memoryType == block->m_memoryType
+				&&  other->m_linear     == block->m_linear
+				&&  other->m_allocator.isEmpty() )
+				{
+					vkDestroy(block->m_memory);
+					block->m_allocator.shutdown();
+					bx::deleteObject(g_allocator, block);
+					m_blocks[_allocation.m_block] = NULL;
+					break;
+				}
+			}
+		}
+	}
+
+	uint16_t MemoryAllocatorVK::getStats(GpuMemoryHeapStats* _stats, uint16_t _max) const
+	{
+		uint16_t num = 0;
+
+		for (uint32_t memoryType = 0; memoryType < VK_MAX_MEMORY_TYPES && num < _max; ++memoryType)
+		{
+			GpuMemoryHeapStats stats;
+			bx::memSet(&stats, 0, sizeof(stats) );
+			stats.memoryType   = memoryType;
+			stats.numDedicated = m_numDedicated[memoryType];
+			stats.dedicated    = int64_t(m_dedicatedSize[memoryType]);
+
+			for (const Block* block : m_blocks)
+			{
+				if (NULL != block
+				&&  memoryType == block->m_memoryType)
+				{
+					const BuddyAllocator& allocator = block->m_allocator;
+					stats.numBlocks      += 1;
+					stats.numAllocations += allocator.getNumAllocations();
+					stats.reserved       += int64_t(allocator.getSize() );
+					stats.used           += int64_t(allocator.getUsed() );
+					stats.largestFree     = bx::max<int64_t>(stats.largestFree, int64_t(allocator.getLargestFree() ) );
+				}
+			}
+
+			if (0 != stats.numBlocks
+			||  0 != stats.numDedicated)
+			{
+				_stats[num++] = stats;
+			}
+		}
+
+		return num;
+	}
+
 	void ScratchBufferVK::create(uint32_t _size, uint32_t _count)
 	{
 		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
@@ -4672,6 +5123,89 @@ VK_DESTROY
 		VK_CHECK(vkFlushMappedMemoryRanges(device, 1, &range) );
 	}
 
+	void StagingBufferVK::create(uint32_t _chunkSize)
+	{
+		m_chunkSize = _chunkSize;
+		m_chunkIdx  = 0;
+		m_pos       = 0;
+	}
+
+	void StagingBufferVK::destroy()
+	{
+		for (Chunk& chunk : m_chunks)
+		{
+			destroy(chunk);
+		}
+
+		m_chunks.clear();
+
+		m_chunkIdx = 0;
+		m_pos      = 0;
+	}
+
+	void StagingBufferVK::destroy(Chunk& _chunk)
+	{
+		vkUnmapMemory(s_renderVK->m_device, _chunk.m_deviceMem);
+
+		s_renderVK->release(_chunk.m_buffer);
+		s_renderVK->release(_chunk.m_deviceMem);
+	}
+
+	void StagingBufferVK::reset()
+	{
+		// Oversized chunks are created for one-off large uploads (e.g. whole
+		// texture creation), don't keep them around.
+		for (uint32_t ii = uint32_t(m_chunks.size() ); 0 < ii; --ii)
+		{
+			Chunk& chunk = m_chunks[ii-1];
+			if (chunk.m_size > m_chunkSize)
+			{
+				destroy(chunk);
+				m_chunks.erase(m_chunks.begin() + (ii-1) );
+			}
+		}
+
+		m_chunkIdx = 0;
+		m_pos      = 0;
+	}
+
+	StagingAllocVK StagingBufferVK::alloc(uint32_t _size, uint32_t _align)
+	{
+		BGFX_PROFILER_SCOPE("StagingBufferVK::alloc", kColorResource);
+
+		for (uint32_t num = uint32_t(m_chunks.size() ); m_chunkIdx < num; ++m_chunkIdx, m_pos = 0)
+		{
+			Chunk& chunk = m_chunks[m_chunkIdx];
+
+			const uint32_t offset = bx::strideAlign(m_pos, _align);
+			if (offset + _size <= chunk.m_size)
+			{
+				m_pos = offset + _size;
+
+				StagingAllocVK result;
+				result.m_buffer = chunk.m_buffer;
+				result.m_offset = offset;
+				result.m_data   = &chunk.m_data[offset];
+				return result;
+			}
+		}
+
+		Chunk chunk;
+		chunk.m_size = bx::max(_size, m_chunkSize);
+		VK_CHECK(s_renderVK->createStagingBuffer(chunk.m_size, &chunk.m_buffer, &chunk.m_deviceMem) );
+		VK_CHECK(vkMapMemory(s_renderVK->m_device, chunk.m_deviceMem, 0, chunk.m_size, 0, (void**)&chunk.m_data) );
+
+		m_chunkIdx = uint32_t(m_chunks.size() );
+		m_pos      = _size;
+		m_chunks.push_back(chunk);
+
+		StagingAllocVK result;
+		result.m_buffer = chunk.m_buffer;
+		result.m_offset = 0;
+		result.m_data   = chunk.m_data;
+		return result;
+	}
+
 	void BufferVK::create(VkCommandBuffer _commandBuffer, uint32_t _size, void* _data, uint16_t _flags, bool _vertex, uint32_t _stride)
 	{
 		BX_UNUSED(_stride);
@@ -4705,9 +5239,9 @@ VK_DESTROY
 		VkMemoryRequirements mr;
 		vkGetBufferMemoryRequirements(device, m_buffer, &mr);
 
-		VK_CHECK(s_renderVK->allocateMemory(&mr, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &m_deviceMem) );
+		VK_CHECK(s_renderVK->m_memoryAllocator.alloc(mr, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true, &m_deviceMem) );
 
-		VK_CHECK(vkBindBufferMemory(device, m_buffer, m_deviceMem, 0) );
+		VK_CHECK(vkBindBufferMemory(device, m_buffer, m_deviceMem.m_memory, m_deviceMem.m_offset) );
 
 		if (!m_dynamic)
 		{
@@ -4720,24 +5254,20 @@ VK_DESTROY
 		BGFX_PROFILER_SCOPE("BufferVK::update", kColorFrame);
 		BX_UNUSED(_discard);
 
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingMem;
-		VK_CHECK(s_renderVK->createStagingBuffer(_size, &stagingBuffer, &stagingMem, _data) );
+		const StagingAllocVK staging = s_renderVK->allocStaging(_size, 4);
+		bx::memCopy(staging.m_data, _data, _size);
 
 		VkBufferCopy region;
-		region.srcOffset = 0;
+		region.srcOffset = staging.m_offset;
 		region.dstOffset = _offset;
 		region.size      = _size;
-		vkCmdCopyBuffer(_commandBuffer, stagingBuffer, m_buffer, 1, &region);
+		vkCmdCopyBuffer(_commandBuffer, staging.m_buffer, m_buffer, 1, &region);
 
 		setMemoryBarrier(
 			  _commandBuffer
 			, VK_PIPELINE_STAGE_TRANSFER_BIT
 			, VK_PIPELINE_STAGE_TRANSFER_BIT
 			);
-
-		s_renderVK->release(stagingBuffer);
-		s_renderVK->release(stagingMem);
 	}
 
 	void BufferVK::destroy()
@@ -5273,40 +5803,195 @@ VK_DESTROY
 			}
 		}
 
-		VkPipelineLayoutCreateInfo plci;
-		plci.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		plci.pNext = NULL;
-		plci.flags = 0;
-		plci.pushConstantRangeCount = 0;
-		plci.pPushConstantRanges = NULL;
-		plci.setLayoutCount = (m_descriptorSetLayout == VK_NULL_HANDLE ? 0 : 1);
-		plci.pSetLayouts = &m_descriptorSetLayout;
+		VkPipelineLayoutCreateInfo plci;
+		plci.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		plci.pNext = NULL;
+		plci.flags = 0;
+		plci.pushConstantRangeCount = 0;
+		plci.pPushConstantRanges = NULL;
+		plci.setLayoutCount = (m_descriptorSetLayout == VK_NULL_HANDLE ? 0 : 1);
+		plci.pSetLayouts = &m_descriptorSetLayout;
+
+		VK_CHECK(vkCreatePipelineLayout(
+			  s_renderVK->m_device
+			, &plci
+			, s_renderVK->m_allocatorCb
+			, &m_pipelineLayout
+			) );
+	}
+
+	void ProgramVK::destroy()
+	{
+		s_renderVK->release(m_pipelineLayout);
+		m_numPredefined = 0;
+		m_vsh = NULL;
+		m_fsh = NULL;
+	}
+
+	VkResult TimerQueryVK::init()
+	{
+		BGFX_PROFILER_SCOPE("TimerQueryVK::init", kColorFrame);
+		VkResult result = VK_SUCCESS;
+
+		const VkDevice device = s_renderVK->m_device;
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+
+		const uint32_t count = m_control.m_size * 2;
+
+		VkQueryPoolCreateInfo qpci;
+		qpci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		qpci.pNext = NULL;
+		qpci.flags = 0;
+		qpci.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		qpci.queryCount = count;
+		qpci.pipelineStatistics = 0;
+
+		result = vkCreateQueryPool(device, &qpci, s_renderVK->m_allocatorCb, &m_queryPool);
+
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create timer query error: vkCreateQueryPool failed %d: %s.", result, getName(result) );
+			return result;
+		}
+
+		vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, count);
+
+		const uint32_t size = count * sizeof(uint64_t);
+		result = s_renderVK->createReadbackBuffer(size, &m_readback, &m_readbackMemory);
+
+		if (VK_SUCCESS != result)
+		{
+			return result;
+		}
+
+		result = vkMapMemory(device, m_readbackMemory, 0, VK_WHOLE_SIZE, 0, (void**)&m_queryResult);
+
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create timer query error: vkMapMemory failed %d: %s.", result, getName(result) );
+			return result;
+		}
+
+		m_frequency = uint64_t(1000000000.0 / double(s_renderVK->m_deviceProperties.limits.timestampPeriod) );
+
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_result); ++ii)
+		{
+			m_result[ii].reset();
+		}
+
+		m_control.reset();
+
+		return result;
+	}
+
+	void TimerQueryVK::shutdown()
+	{
+		vkDestroy(m_queryPool);
+		vkDestroy(m_readback);
+		vkUnmapMemory(s_renderVK->m_device, m_readbackMemory);
+		vkDestroy(m_readbackMemory);
+	}
+
+	uint32_t TimerQueryVK::begin(uint32_t _resultIdx, uint32_t _frameNum)
+	{
+		BGFX_PROFILER_SCOPE("TimerQueryVK::begin", kColorFrame);
+		while (0 == m_control.reserve(1) )
+		{
+			m_control.consume(1);
+		}
+
+		Result& result = m_result[_resultIdx];
+		++result.m_pending;
+
+		const uint32_t idx = m_control.m_current;
+		Query& query = m_query[idx];
+		query.m_resultIdx = _resultIdx;
+		query.m_ready     = false;
+		query.m_frameNum  = _frameNum;
+
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+		const uint32_t offset = idx * 2 + 0;
+
+		vkCmdResetQueryPool(commandBuffer, m_queryPool, offset, 2);
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, offset + 0);
+
+		m_control.commit(1);
+
+		return idx;
+	}
+
+	void TimerQueryVK::end(uint32_t _idx)
+	{
+		BGFX_PROFILER_SCOPE("TimerQueryVK::end", kColorFrame);
+		Query& query = m_query[_idx];
+		query.m_ready = true;
+		query.m_completed = s_renderVK->m_cmd.m_submitted + s_renderVK->m_cmd.m_numFramesInFlight;
+
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+		const uint32_t offset = _idx * 2 + 0;
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, offset + 1);
+
+		vkCmdCopyQueryPoolResults(
+			  commandBuffer
+			, m_queryPool
+			, offset
+			, 2
+			, m_readback
+			, offset * sizeof(uint64_t)
+			, sizeof(uint64_t)
+			, VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT
+			);
+
+		setMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+
+		while (update() )
+		{
+		}
+	}
+
+	bool TimerQueryVK::update()
+	{
+		if (0 != m_control.available() )
+		{
+			uint32_t idx = m_control.m_read;
+			Query& query = m_query[idx];
+
+			if (!query.m_ready)
+			{
+				return false;
+			}
+
+			if (query.m_completed > s_renderVK->m_cmd.m_submitted)
+			{
+				return false;
+			}
+
+			m_control.consume(1);
+
+			Result& result = m_result[query.m_resultIdx];
+			--result.m_pending;
+			result.m_frameNum = query.m_frameNum;
 
-		VK_CHECK(vkCreatePipelineLayout(
-			  s_renderVK->m_device
-			, &plci
-			, s_renderVK->m_allocatorCb
-			, &m_pipelineLayout
-			) );
-	}
+			uint32_t offset = idx * 2;
+			result.m_begin  = m_queryResult[offset+0];
+			result.m_end    = m_queryResult[offset+1];
 
-	void ProgramVK::destroy()
-	{
-		s_renderVK->release(m_pipelineLayout);
-		m_numPredefined = 0;
-		m_vsh = NULL;
-		m_fsh = NULL;
+			return true;
+		}
+
+		return false;
 	}
 
-	VkResult TimerQueryVK::init()
+	VkResult TimerScopeQueryVK::init()
 	{
-		BGFX_PROFILER_SCOPE("TimerQueryVK::init", kColorFrame);
+		BGFX_PROFILER_SCOPE("TimerScopeQueryVK::init", kColorFrame);
 		VkResult result = VK_SUCCESS;
 
 		const VkDevice device = s_renderVK->m_device;
 		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
 
-		const uint32_t count = m_control.m_size * 2;
+		const uint32_t count = BX_COUNTOF(m_slot) * BGFX_CONFIG_MAX_GPU_TIMERS * 2;
 
 		VkQueryPoolCreateInfo qpci;
 		qpci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
@@ -5320,7 +6005,7 @@ VK_DESTROY
 
 		if (VK_SUCCESS != result)
 		{
-			BX_TRACE("Create timer query error: vkCreateQueryPool failed %d: %s.", result, getName(result) );
+			BX_TRACE("Create timer scope query error: vkCreateQueryPool failed %d: %s.", result, getName(result) );
 			return result;
 		}
 
@@ -5338,23 +6023,24 @@ VK_DESTROY
 
 		if (VK_SUCCESS != result)
 		{
-			BX_TRACE("Create timer query error: vkMapMemory failed %d: %s.", result, getName(result) );
+			BX_TRACE("Create timer scope query error: vkMapMemory failed %d: %s.", result, getName(result) );
 			return result;
 		}
 
-		m_frequency = uint64_t(1000000000.0 / double(s_renderVK->m_deviceProperties.limits.timestampPeriod) );
+		bx::memSet(m_result, 0, sizeof(m_result) );
 
-		for (uint32_t ii = 0; ii < BX_COUNTOF(m_result); ++ii)
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_slot); ++ii)
 		{
-			m_result[ii].reset();
+			m_slot[ii].m_num     = 0;
+			m_slot[ii].m_pending = false;
 		}
 
-		m_control.reset();
+		m_current = 0;
 
 		return result;
 	}
 
-	void TimerQueryVK::shutdown()
+	void TimerScopeQueryVK::shutdown()
 	{
 		vkDestroy(m_queryPool);
 		vkDestroy(m_readback);
@@ -5362,51 +6048,67 @@ VK_DESTROY
 		vkDestroy(m_readbackMemory);
 	}
 
-	uint32_t TimerQueryVK::begin(uint32_t _resultIdx, uint32_t _frameNum)
+	void TimerScopeQueryVK::reset()
 	{
-		BGFX_PROFILER_SCOPE("TimerQueryVK::begin", kColorFrame);
-		while (0 == m_control.reserve(1) )
-		{
-			m_control.consume(1);
-		}
+		update();
 
-		Result& result = m_result[_resultIdx];
-		++result.m_pending;
+		m_current = s_renderVK->m_cmd.m_currentFrameInFlight;
 
-		const uint32_t idx = m_control.m_current;
-		Query& query = m_query[idx];
-		query.m_resultIdx = _resultIdx;
-		query.m_ready     = false;
-		query.m_frameNum  = _frameNum;
+		// Slot is reused only after frame which used it is completed, so results
+		// are already resolved by update.
+		Slot& slot = m_slot[m_current];
+		slot.m_num     = 0;
+		slot.m_pending = false;
 
 		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
-		const uint32_t offset = idx * 2 + 0;
+		const uint32_t offset = m_current * BGFX_CONFIG_MAX_GPU_TIMERS * 2;
 
-		vkCmdResetQueryPool(commandBuffer, m_queryPool, offset, 2);
-		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, offset + 0);
+		vkCmdResetQueryPool(commandBuffer, m_queryPool, offset, BGFX_CONFIG_MAX_GPU_TIMERS * 2);
+	}
 
-		m_control.commit(1);
+	uint32_t TimerScopeQueryVK::begin(uint32_t _resultIdx, uint32_t _frameNum)
+	{
+		Slot& slot = m_slot[m_current];
+
+		const uint32_t idx = slot.m_num;
+		slot.m_resultIdx[idx] = uint16_t(_resultIdx);
+		slot.m_frameNum       = _frameNum;
+		++slot.m_num;
+
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+		const uint32_t offset = (m_current * BGFX_CONFIG_MAX_GPU_TIMERS + idx) * 2;
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, offset + 0);
 
 		return idx;
 	}
 
-	void TimerQueryVK::end(uint32_t _idx)
+	void TimerScopeQueryVK::end(uint32_t _idx)
 	{
-		BGFX_PROFILER_SCOPE("TimerQueryVK::end", kColorFrame);
-		Query& query = m_query[_idx];
-		query.m_ready = true;
-		query.m_completed = s_renderVK->m_cmd.m_submitted + s_renderVK->m_cmd.m_numFramesInFlight;
-
 		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
-		const uint32_t offset = _idx * 2 + 0;
+		const uint32_t offset = (m_current * BGFX_CONFIG_MAX_GPU_TIMERS + _idx) * 2;
 
 		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, offset + 1);
+	}
+
+	void TimerScopeQueryVK::flush()
+	{
+		Slot& slot = m_slot[m_current];
+
+		if (0 == slot.m_num
+		||  slot.m_pending)
+		{
+			return;
+		}
+
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+		const uint32_t offset = m_current * BGFX_CONFIG_MAX_GPU_TIMERS * 2;
 
 		vkCmdCopyQueryPoolResults(
 			  commandBuffer
 			, m_queryPool
 			, offset
-			, 2
+			, slot.m_num * 2
 			, m_readback
 			, offset * sizeof(uint64_t)
 			, sizeof(uint64_t)
@@ -5415,42 +6117,34 @@ VK_DESTROY
 
 		setMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
 
-		while (update() )
-		{
-		}
+		slot.m_pending   = true;
+		slot.m_completed = s_renderVK->m_cmd.m_submitted + s_renderVK->m_cmd.m_numFramesInFlight;
 	}
 
-	bool TimerQueryVK::update()
+	void TimerScopeQueryVK::update()
 	{
-		if (0 != m_control.available() )
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_slot); ++ii)
 		{
-			uint32_t idx = m_control.m_read;
-			Query& query = m_query[idx];
+			Slot& slot = m_slot[ii];
 
-			if (!query.m_ready)
+			if (!slot.m_pending
+			||  slot.m_completed > s_renderVK->m_cmd.m_submitted)
 			{
-				return false;
+				continue;
 			}
 
-			if (query.m_completed > s_renderVK->m_cmd.m_submitted)
+			const uint32_t offset = ii * BGFX_CONFIG_MAX_GPU_TIMERS * 2;
+
+			for (uint32_t jj = 0, num = slot.m_num; jj < num; ++jj)
 			{
-				return false;
+				Result& result = m_result[slot.m_resultIdx[jj] ];
+				result.m_begin    = m_queryResult[offset + jj*2 + 0];
+				result.m_end      = m_queryResult[offset + jj*2 + 1];
+				result.m_frameNum = slot.m_frameNum;
 			}
 
-			m_control.consume(1);
-
-			Result& result = m_result[query.m_resultIdx];
-			--result.m_pending;
-			result.m_frameNum = query.m_frameNum;
-
-			uint32_t offset = idx * 2;
-			result.m_begin  = m_queryResult[offset+0];
-			result.m_end    = m_queryResult[offset+1];
-
-			return true;
+			slot.m_pending = false;
 		}
-
-		return false;
 	}
 
 	VkResult OcclusionQueryVK::init()
@@ -5499,6 +6193,53 @@ VK_DESTROY
 
 		m_control.reset();
 
+		m_predicate       = VK_NULL_HANDLE;
+		m_predicateMemory = VK_NULL_HANDLE;
+		m_numPending      = 0;
+		bx::memSet(m_predicateReady, 0, sizeof(m_predicateReady) );
+
+		if (s_renderVK->m_conditionalRenderSupport)
+		{
+			VkBufferCreateInfo bci;
+			bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			bci.pNext = NULL;
+			bci.flags = 0;
+			bci.size  = size;
+			bci.usage = 0
+				| VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT
+				| VK_BUFFER_USAGE_TRANSFER_DST_BIT
+				;
+			bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			bci.queueFamilyIndexCount = 0;
+			bci.pQueueFamilyIndices   = NULL;
+
+			VkResult predicateResult = vkCreateBuffer(device, &bci, s_renderVK->m_allocatorCb, &m_predicate);
+
+			if (VK_SUCCESS == predicateResult)
+			{
+				VkMemoryRequirements mr;
+				vkGetBufferMemoryRequirements(device, m_predicate, &mr);
+
+				predicateResult = s_renderVK->allocateMemory(&mr, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &m_predicateMemory);
+			}
+
+			if (VK_SUCCESS == predicateResult)
+			{
+				predicateResult = vkBindBufferMemory(device, m_predicate, m_predicateMemory, 0);
+			}
+
+			if (VK_SUCCESS != predicateResult)
+			{
+				// Conditional rendering is optional, draws fall back to CPU
+				// side occlusion results.
+				BX_TRACE("Create occlusion query predicate buffer failed %d: %s.", predicateResult, getName(predicateResult) );
+				vkDestroy(m_predicate);
+				vkDestroy(m_predicateMemory);
+				s_renderVK->m_conditionalRenderSupport = false;
+				g_caps.supported &= ~BGFX_CAPS_CONDITIONAL_RENDER;
+			}
+		}
+
 		return result;
 	}
 
@@ -5508,6 +6249,8 @@ VK_DESTROY
 		vkDestroy(m_readback);
 		vkUnmapMemory(s_renderVK->m_device, m_readbackMemory);
 		vkDestroy(m_readbackMemory);
+		vkDestroy(m_predicate);
+		vkDestroy(m_predicateMemory);
 	}
 
 	void OcclusionQueryVK::begin(OcclusionQueryHandle _handle)
@@ -5529,12 +6272,87 @@ VK_DESTROY
 		const OcclusionQueryHandle handle = m_handle[m_control.m_current];
 		vkCmdEndQuery(commandBuffer, m_queryPool, handle.idx);
 
+		if (VK_NULL_HANDLE != m_predicate
+		&&  m_numPending < BX_COUNTOF(m_pending) )
+		{
+			m_pending[m_numPending++] = handle;
+		}
+
 		m_control.commit(1);
 	}
 
+	void OcclusionQueryVK::copyPredicates()
+	{
+		if (0 == m_numPending)
+		{
+			return;
+		}
+
+		BGFX_PROFILER_SCOPE("OcclusionQueryVK::copyPredicates", kColorFrame);
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+
+		// Previously submitted draws might still read predicates.
+		vkCmdPipelineBarrier(
+			  commandBuffer
+			, VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT
+			, VK_PIPELINE_STAGE_TRANSFER_BIT
+			, 0
+			, 0
+			, NULL
+			, 0
+			, NULL
+			, 0
+			, NULL
+			);
+
+		for (uint32_t ii = 0; ii < m_numPending; ++ii)
+		{
+			const OcclusionQueryHandle handle = m_pending[ii];
+
+			vkCmdCopyQueryPoolResults(
+				  commandBuffer
+				, m_queryPool
+				, handle.idx
+				, 1
+				, m_predicate
+				, handle.idx * sizeof(uint32_t)
+				, sizeof(uint32_t)
+				, VK_QUERY_RESULT_WAIT_BIT
+				);
+
+			m_predicateReady[handle.idx/32] |= UINT32_C(1) << (handle.idx%32);
+		}
+
+		m_numPending = 0;
+
+		VkMemoryBarrier mb;
+		mb.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		mb.pNext = NULL;
+		mb.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		mb.dstAccessMask = VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT;
+
+		vkCmdPipelineBarrier(
+			  commandBuffer
+			, VK_PIPELINE_STAGE_TRANSFER_BIT
+			, VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT
+			, 0
+			, 1
+			, &mb
+			, 0
+			, NULL
+			, 0
+			, NULL
+			);
+	}
+
 	void OcclusionQueryVK::flush(Frame* _render)
 	{
 		BGFX_PROFILER_SCOPE("OcclusionQueryVK::flush", kColorFrame);
+
+		// Predicates are valid only for queries issued in current frame.
+		m_numPending = 0;
+		bx::memSet(m_predicateReady, 0, sizeof(m_predicateReady) );
+
 		if (0 < m_control.available() )
 		{
 			VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
@@ -5599,6 +6417,8 @@ VK_DESTROY
 				handle.idx = bgfx::kInvalidHandle;
 			}
 		}
+
+		m_predicateReady[_handle.idx/32] &= ~(UINT32_C(1) << (_handle.idx%32) );
 	}
 
 	void ReadbackVK::create(VkImage _image, uint32_t _width, uint32_t _height, TextureFormat::Enum _format)
@@ -5804,14 +6624,14 @@ VK_DESTROY
 		VkMemoryRequirements imageMemReq;
 		vkGetImageMemoryRequirements(device, m_textureImage, &imageMemReq);
 
-		result = s_renderVK->allocateMemory(&imageMemReq, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &m_textureDeviceMem);
+		result = s_renderVK->m_memoryAllocator.alloc(imageMemReq, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false, &m_textureDeviceMem);
 		if (VK_SUCCESS != result)
 		{
 			BX_TRACE("Create texture image error: allocateMemory failed %d: %s.", result, getName(result) );
 			return result;
 		}
 
-		result = vkBindImageMemory(device, m_textureImage, m_textureDeviceMem, 0);
+		result = vkBindImageMemory(device, m_textureImage, m_textureDeviceMem.m_memory, m_textureDeviceMem.m_offset);
 		if (VK_SUCCESS != result)
 		{
 			BX_TRACE("Create texture image error: vkBindImageMemory failed %d: %s.", result, getName(result) );
@@ -5847,14 +6667,14 @@ VK_DESTROY
 			VkMemoryRequirements imageMemReq_resolve;
 			vkGetImageMemoryRequirements(device, m_singleMsaaImage, &imageMemReq_resolve);
 
-			result = s_renderVK->allocateMemory(&imageMemReq_resolve, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &m_singleMsaaDeviceMem);
+			result = s_renderVK->m_memoryAllocator.alloc(imageMemReq_resolve, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false, &m_singleMsaaDeviceMem);
 			if (VK_SUCCESS != result)
 			{
 				BX_TRACE("Create texture image error: allocateMemory failed %d: %s.", result, getName(result) );
 				return result;
 			}
 
-			result = vkBindImageMemory(device, m_singleMsaaImage, m_singleMsaaDeviceMem, 0);
+			result = vkBindImageMemory(device, m_singleMsaaImage, m_singleMsaaDeviceMem.m_memory, m_singleMsaaDeviceMem.m_offset);
 			if (VK_SUCCESS != result)
 			{
 				BX_TRACE("Create texture image error: vkBindImageMemory failed %d: %s.", result, getName(result) );
@@ -5966,13 +6786,11 @@ VK_DESTROY
 			// decode images
 			struct ImageInfo
 			{
-				uint8_t* data;
-				uint32_t width;
-				uint32_t height;
-				uint32_t depth;
+				bimg::ImageMip mip;
 				uint32_t pitch;
 				uint32_t slice;
 				uint32_t size;
+				uint32_t offset;
 				uint32_t mipLevel;
 				uint32_t layer;
 			};
@@ -5980,162 +6798,137 @@ VK_DESTROY
 			ImageInfo* imageInfos = (ImageInfo*)bx::alloc(g_allocator, sizeof(ImageInfo) * numSrd);
 			bx::memSet(imageInfos, 0, sizeof(ImageInfo) * numSrd);
 			uint32_t alignment = 1; // tightly aligned buffer
+			uint32_t totalMemSize = 0;
 
 			for (uint16_t side = 0; side < numSides; ++side)
 			{
 				for (uint8_t lod = 0; lod < ti.numMips; ++lod)
 				{
-					bimg::ImageMip mip;
+					bimg::ImageMip& mip = imageInfos[kk].mip;
 
 					if (bimg::imageGetRawData(imageContainer, side, lod + startLod, _mem->data, _mem->size, mip) )
 					{
+						uint32_t pitch;
+						uint32_t slice;
+
 						if (convert)
 						{
-							const uint32_t pitch = bx::strideAlign(bx::max<uint32_t>(mip.m_width, 4) * bpp / 8, alignment);
-							const uint32_t slice = bx::strideAlign(bx::max<uint32_t>(mip.m_height, 4) * pitch, alignment);
-							const uint32_t size  = slice * mip.m_depth;
-
-							uint8_t* temp = (uint8_t*)bx::alloc(g_allocator, size);
-							bimg::imageDecodeToBgra8(
-								  g_allocator
-								, temp
-								, mip.m_data
-								, mip.m_width
-								, mip.m_height
-								, pitch
-								, mip.m_format
-								);
-
-							imageInfos[kk].data     = temp;
-							imageInfos[kk].width    = mip.m_width;
-							imageInfos[kk].height   = mip.m_height;
-							imageInfos[kk].depth    = mip.m_depth;
-							imageInfos[kk].pitch    = pitch;
-							imageInfos[kk].slice    = slice;
-							imageInfos[kk].size     = size;
-							imageInfos[kk].mipLevel = lod;
-							imageInfos[kk].layer    = side;
+							pitch = bx::strideAlign(bx::max<uint32_t>(mip.m_width, 4) * bpp / 8, alignment);
+							slice = bx::strideAlign(bx::max<uint32_t>(mip.m_height, 4) * pitch, alignment);
 						}
 						else if (compressed)
 						{
-							const uint32_t pitch = bx::strideAlign( (mip.m_width / blockInfo.blockWidth) * mip.m_blockSize, alignment);
-							const uint32_t slice = bx::strideAlign( (mip.m_height / blockInfo.blockHeight) * pitch, alignment);
-							const uint32_t size  = slice * mip.m_depth;
-
-							uint8_t* temp = (uint8_t*)bx::alloc(g_allocator, size);
-							bimg::imageCopy(
-								  temp
-								, mip.m_height / blockInfo.blockHeight
-								, (mip.m_width / blockInfo.blockWidth) * mip.m_blockSize
-								, mip.m_depth
-								, mip.m_data
-								, pitch
-								);
-
-							imageInfos[kk].data     = temp;
-							imageInfos[kk].width    = mip.m_width;
-							imageInfos[kk].height   = mip.m_height;
-							imageInfos[kk].depth    = mip.m_depth;
-							imageInfos[kk].pitch    = pitch;
-							imageInfos[kk].slice    = slice;
-							imageInfos[kk].size     = size;
-							imageInfos[kk].mipLevel = lod;
-							imageInfos[kk].layer    = side;
+							pitch = bx::strideAlign( (mip.m_width / blockInfo.blockWidth) * mip.m_blockSize, alignment);
+							slice = bx::strideAlign( (mip.m_height / blockInfo.blockHeight) * pitch, alignment);
 						}
 						else
 						{
-							const uint32_t pitch = bx::strideAlign(mip.m_width * mip.m_bpp / 8, alignment);
-							const uint32_t slice = bx::strideAlign(mip.m_height * pitch, alignment);
-							const uint32_t size  = slice * mip.m_depth;
-
-							uint8_t* temp = (uint8_t*)bx::alloc(g_allocator, size);
-							bimg::imageCopy(
-								  temp
-								, mip.m_height
-								, mip.m_width * mip.m_bpp / 8
-								, mip.m_depth
-								, mip.m_data
-								, pitch
-								);
-
-							imageInfos[kk].data     = temp;
-							imageInfos[kk].width    = mip.m_width;
-							imageInfos[kk].height   = mip.m_height;
-							imageInfos[kk].depth    = mip.m_depth;
-							imageInfos[kk].pitch    = pitch;
-							imageInfos[kk].slice    = slice;
-							imageInfos[kk].size     = size;
-							imageInfos[kk].mipLevel = lod;
-							imageInfos[kk].layer    = side;
+							pitch = bx::strideAlign(mip.m_width * mip.m_bpp / 8, alignment);
+							slice = bx::strideAlign(mip.m_height * pitch, alignment);
 						}
+
+						imageInfos[kk].pitch    = pitch;
+						imageInfos[kk].slice    = slice;
+						imageInfos[kk].size     = slice * mip.m_depth;
+						imageInfos[kk].offset   = totalMemSize;
+						imageInfos[kk].mipLevel = lod;
+						imageInfos[kk].layer    = side;
+
+						totalMemSize += imageInfos[kk].size;
 					}
 					++kk;
 				}
 			}
 
-			uint32_t totalMemSize = 0;
-			VkBufferImageCopy* bufferCopyInfo = (VkBufferImageCopy*)bx::alloc(g_allocator, sizeof(VkBufferImageCopy) * numSrd);
-
-			for (uint32_t ii = 0; ii < numSrd; ++ii)
-			{
-				const uint32_t idealWidth  = bx::max<uint32_t>(1, m_width  >> imageInfos[ii].mipLevel);
-				const uint32_t idealHeight = bx::max<uint32_t>(1, m_height >> imageInfos[ii].mipLevel);
-				bufferCopyInfo[ii].bufferOffset      = totalMemSize;
-				bufferCopyInfo[ii].bufferRowLength   = 0; // assume that image data are tightly aligned
-				bufferCopyInfo[ii].bufferImageHeight = 0; // assume that image data are tightly aligned
-				bufferCopyInfo[ii].imageSubresource.aspectMask     = m_aspectMask;
-				bufferCopyInfo[ii].imageSubresource.mipLevel       = imageInfos[ii].mipLevel;
-				bufferCopyInfo[ii].imageSubresource.baseArrayLayer = imageInfos[ii].layer;
-				bufferCopyInfo[ii].imageSubresource.layerCount     = 1;
-				bufferCopyInfo[ii].imageOffset = { 0, 0, 0 };
-				bufferCopyInfo[ii].imageExtent = { idealWidth, idealHeight, imageInfos[ii].depth };
-				totalMemSize += imageInfos[ii].size;
-			}
-
 			if (totalMemSize > 0)
 			{
-				const VkDevice device = s_renderVK->m_device;
+				const uint32_t texelSize = compressed
+					? blockInfo.blockSize
+					: bx::max<uint32_t>(1, bpp / 8)
+					;
 
-				VkBuffer stagingBuffer;
-				VkDeviceMemory stagingDeviceMem;
-				VK_CHECK(s_renderVK->createStagingBuffer(totalMemSize, &stagingBuffer, &stagingDeviceMem) );
+				// Buffer offset must be multiple of both texel block size and 4. All
+				// subresources are tightly packed multiples of texel block size.
+				const StagingAllocVK staging = s_renderVK->allocStaging(
+					  totalMemSize
+					, 0 == texelSize % 4 ? texelSize : texelSize * 4
+					);
 
-				uint8_t* mappedMemory;
-				VK_CHECK(vkMapMemory(
-					  device
-					, stagingDeviceMem
-					, 0
-					, totalMemSize
-					, 0
-					, (void**)&mappedMemory
-					) );
+				VkBufferImageCopy* bufferCopyInfo = (VkBufferImageCopy*)bx::alloc(g_allocator, sizeof(VkBufferImageCopy) * numSrd);
+				uint32_t numCopies = 0;
 
-				// copy image to staging buffer
+				// decode or copy image directly into staging buffer
 				for (uint32_t ii = 0; ii < numSrd; ++ii)
 				{
-					bx::memCopy(mappedMemory, imageInfos[ii].data, imageInfos[ii].size);
-					mappedMemory += imageInfos[ii].size;
-				}
+					const ImageInfo& info = imageInfos[ii];
+
+					if (0 == info.size)
+					{
+						continue;
+					}
+
+					const bimg::ImageMip& mip = info.mip;
+					uint8_t* dst = &staging.m_data[info.offset];
+
+					if (convert)
+					{
+						bimg::imageDecodeToBgra8(
+							  g_allocator
+							, dst
+							, mip.m_data
+							, mip.m_width
+							, mip.m_height
+							, info.pitch
+							, mip.m_format
+							);
+					}
+					else if (compressed)
+					{
+						bimg::imageCopy(
+							  dst
+							, mip.m_height / blockInfo.blockHeight
+							, (mip.m_width / blockInfo.blockWidth) * mip.m_blockSize
+							, mip.m_depth
+							, mip.m_data
+							, info.pitch
+							);
+					}
+					else
+					{
+						bimg::imageCopy(
+							  dst
+							, mip.m_height
+							, mip.m_width * mip.m_bpp / 8
+							, mip.m_depth
+							, mip.m_data
+							, info.pitch
+							);
+					}
 
-				vkUnmapMemory(device, stagingDeviceMem);
+					const uint32_t idealWidth  = bx::max<uint32_t>(1, m_width  >> info.mipLevel);
+					const uint32_t idealHeight = bx::max<uint32_t>(1, m_height >> info.mipLevel);
+
+					VkBufferImageCopy& region = bufferCopyInfo[numCopies++];
+					region.bufferOffset      = staging.m_offset + info.offset;
+					region.bufferRowLength   = 0; // assume that image data are tightly aligned
+					region.bufferImageHeight = 0; // assume that image data are tightly aligned
+					region.imageSubresource.aspectMask     = m_aspectMask;
+					region.imageSubresource.mipLevel       = info.mipLevel;
+					region.imageSubresource.baseArrayLayer = info.layer;
+					region.imageSubresource.layerCount     = 1;
+					region.imageOffset = { 0, 0, 0 };
+					region.imageExtent = { idealWidth, idealHeight, mip.m_depth };
+				}
 
-				copyBufferToTexture(_commandBuffer, stagingBuffer, numSrd, bufferCopyInfo);
+				copyBufferToTexture(_commandBuffer, staging.m_buffer, numCopies, bufferCopyInfo);
 
-				s_renderVK->release(stagingBuffer);
-				s_renderVK->release(stagingDeviceMem);
+				bx::free(g_allocator, bufferCopyInfo);
 			}
 			else
 			{
 				setImageMemoryBarrier(_commandBuffer, m_sampledLayout);
 			}
 
-			bx::free(g_allocator, bufferCopyInfo);
-
-			for (uint32_t ii = 0; ii < numSrd; ++ii)
-			{
-				bx::free(g_allocator, imageInfos[ii].data);
-			}
-
 			bx::free(g_allocator, imageInfos);
 
 			m_readback.create(m_textureImage, m_width, m_height, TextureFormat::Enum(m_textureFormat) );
@@ -6164,76 +6957,73 @@ VK_DESTROY
 		m_currentSingleMsaaImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	}
 
-	void TextureVK::update(VkCommandBuffer _commandBuffer, uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem)
+	VkBuffer TextureVK::update(uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem, VkBufferImageCopy& _region)
 	{
 		const uint32_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(m_textureFormat) );
 		uint32_t rectpitch = _rect.m_width * bpp / 8;
 		uint32_t slicepitch = rectpitch * _rect.m_height;
+		uint32_t texelSize = bx::max<uint32_t>(1, bpp / 8);
 		if (bimg::isCompressed(bimg::TextureFormat::Enum(m_textureFormat) ) )
 		{
 			const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(bimg::TextureFormat::Enum(m_textureFormat) );
 			rectpitch  = (_rect.m_width  / blockInfo.blockWidth ) * blockInfo.blockSize;
 			slicepitch = (_rect.m_height / blockInfo.blockHeight) * rectpitch;
+			texelSize  = blockInfo.blockSize;
 		}
 		const uint32_t srcpitch = UINT16_MAX == _pitch ? rectpitch : _pitch;
 		const uint32_t size     = UINT16_MAX == _pitch ? slicepitch  * _depth: _rect.m_height * _pitch * _depth;
 		const bool convert = m_textureFormat != m_requestedFormat;
 
-		VkBufferImageCopy region;
-		region.bufferOffset      = 0;
-		region.bufferRowLength   = (_pitch == UINT16_MAX ? 0 : _pitch * 8 / bpp);
-		region.bufferImageHeight = 0;
-		region.imageSubresource.aspectMask     = m_aspectMask;
-		region.imageSubresource.mipLevel       = _mip;
-		region.imageSubresource.baseArrayLayer = 0;
-		region.imageSubresource.layerCount     = 1;
-		region.imageOffset = { _rect.m_x,     _rect.m_y,      0      };
-		region.imageExtent = { _rect.m_width, _rect.m_height, _depth };
+		// Buffer offset must be multiple of both texel block size and 4.
+		const uint32_t align = 0 == texelSize % 4 ? texelSize : texelSize * 4;
+
+		_region.bufferOffset      = 0;
+		_region.bufferRowLength   = (_pitch == UINT16_MAX ? 0 : _pitch * 8 / bpp);
+		_region.bufferImageHeight = 0;
+		_region.imageSubresource.aspectMask     = m_aspectMask;
+		_region.imageSubresource.mipLevel       = _mip;
+		_region.imageSubresource.baseArrayLayer = 0;
+		_region.imageSubresource.layerCount     = 1;
+		_region.imageOffset = { _rect.m_x,     _rect.m_y,      0      };
+		_region.imageExtent = { _rect.m_width, _rect.m_height, _depth };
 
-		uint8_t* data = _mem->data;
-		uint8_t* temp = NULL;
+		StagingAllocVK staging;
 
 		if (convert)
 		{
-			temp = (uint8_t*)bx::alloc(g_allocator, slicepitch);
-			bimg::imageDecodeToBgra8(g_allocator, temp, data, _rect.m_width, _rect.m_height, srcpitch, bimg::TextureFormat::Enum(m_requestedFormat));
-			data = temp;
+			staging = s_renderVK->allocStaging(slicepitch, align);
+			bimg::imageDecodeToBgra8(g_allocator, staging.m_data, _mem->data, _rect.m_width, _rect.m_height, srcpitch, bimg::TextureFormat::Enum(m_requestedFormat));
 
-			region.imageExtent =
+			_region.imageExtent =
 			{
 				bx::max(1u, m_width  >> _mip),
 				bx::max(1u, m_height >> _mip),
 				_depth,
 			};
 		}
+		else
+		{
+			staging = s_renderVK->allocStaging(size, align);
+			bx::memCopy(staging.m_data, _mem->data, size);
+		}
 
-		VkBuffer stagingBuffer = VK_NULL_HANDLE;
-		VkDeviceMemory stagingDeviceMem = VK_NULL_HANDLE;
-		VK_CHECK(s_renderVK->createStagingBuffer(size, &stagingBuffer, &stagingDeviceMem, data) );
+		_region.bufferOffset = staging.m_offset;
 
 		if (VK_IMAGE_VIEW_TYPE_3D == m_type)
 		{
-			region.imageOffset.z = _z;
+			_region.imageOffset.z = _z;
 		}
 		else if (VK_IMAGE_VIEW_TYPE_CUBE == m_type
 		||       VK_IMAGE_VIEW_TYPE_CUBE_ARRAY == m_type)
 		{
-			region.imageSubresource.baseArrayLayer = _z * 6 + _side;
+			_region.imageSubresource.baseArrayLayer = _z * 6 + _side;
 		}
 		else
 		{
-			region.imageSubresource.baseArrayLayer = _z;
+			_region.imageSubresource.baseArrayLayer = _z;
 		}
 
-		copyBufferToTexture(_commandBuffer, stagingBuffer, 1, &region);
-
-		s_renderVK->release(stagingBuffer);
-		s_renderVK->release(stagingDeviceMem);
-
-		if (NULL != temp)
-		{
-			bx::free(g_allocator, temp);
-		}
+		return staging.m_buffer;
 	}
 
 	void TextureVK::resolve(VkCommandBuffer _commandBuffer, uint8_t _resolve, uint32_t _layer, uint32_t _numLayers, uint32_t _mip)
@@ -7993,6 +8783,11 @@ VK_DESTROY
 		m_release[m_currentFrameInFlight].push_back(resource);
 	}
 
+	void CommandQueueVK::release(const DeviceMemoryAllocationVK& _allocation)
+	{
+		m_releaseMemory[m_currentFrameInFlight].push_back(_allocation);
+	}
+
 	void CommandQueueVK::consume()
 	{
 		m_consumeIndex = (m_consumeIndex + 1) % m_numFramesInFlight;
@@ -8022,6 +8817,13 @@ VK_DESTROY
 		}
 
 		m_release[m_consumeIndex].clear();
+
+		for (const DeviceMemoryAllocationVK& allocation : m_releaseMemory[m_consumeIndex])
+		{
+			s_renderVK->m_memoryAllocator.free(allocation);
+		}
+
+		m_releaseMemory[m_consumeIndex].clear();
 	}
 
 	void RendererContextVK::submitBlit(BlitState& _bs, uint16_t _view)
@@ -8153,6 +8955,8 @@ VK_DESTROY
 			return;
 		}
 
+		processSwapChainReadback(false);
+
 		if (_render->m_capture)
 		{
 			renderDocTriggerCapture();
@@ -8168,8 +8972,11 @@ VK_DESTROY
 		if (m_timerQuerySupport)
 		{
 			frameQueryIdx = m_gpuTimer.begin(BGFX_CONFIG_MAX_VIEWS, _render->m_frameNum);
+			m_gpuTimerScopeQuery.reset();
 		}
 
+		m_gpuTimerScopes.begin(_render, m_timerQuerySupport ? &m_gpuTimerScopeQuery : NULL, 0);
+
 		if (0 < _render->m_iboffset)
 		{
 			BGFX_PROFILER_SCOPE("bgfx/Update transient index buffer", kColorResource);
@@ -8264,6 +9071,8 @@ VK_DESTROY
 			int32_t numItems = _render->m_numRenderItems;
 			for (int32_t item = 0; item < numItems;)
 			{
+				m_gpuTimerScopes.update(item);
+
 				const uint64_t encodedKey = _render->m_sortKeys[item];
 				const bool isCompute = key.decode(encodedKey, _render->m_viewRemap);
 				statsKeyType[isCompute]++;
@@ -8284,6 +9093,8 @@ VK_DESTROY
 					{
 						vkCmdEndRenderPass(m_commandBuffer);
 						beginRenderPass = false;
+
+						m_occlusionQuery.copyPredicates();
 					}
 
 					view = key.m_view;
@@ -8500,11 +9311,22 @@ VK_DESTROY
 				rendererUpdateUniforms(this, _render->m_uniformBuffer[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
 
 				const bool hasOcclusionQuery = 0 != (draw.m_stateFlags & BGFX_STATE_INTERNAL_OCCLUSION_QUERY);
+				const bool occlusionVisible  = 0 != (draw.m_submitFlags & BGFX_SUBMIT_INTERNAL_OCCLUSION_VISIBLE);
+
+				// Query results are copied into predicate buffer at the end of
+				// render pass, so only queries from earlier views can be used.
+				const bool hasCondition = true
+					&& isValid(draw.m_occlusionQuery)
+					&& !hasOcclusionQuery
+					&& 0 != (draw.m_submitFlags & BGFX_SUBMIT_INTERNAL_OCCLUSION_GPU)
+					&& m_occlusionQuery.isPredicateReady(draw.m_occlusionQuery)
+					;
 				{
 					const bool occluded = true
 						&& isValid(draw.m_occlusionQuery)
 						&& !hasOcclusionQuery
-						&& !isVisible(_render, draw.m_occlusionQuery, 0 != (draw.m_submitFlags & BGFX_SUBMIT_INTERNAL_OCCLUSION_VISIBLE) )
+						&& !hasCondition
+						&& !isVisible(_render, draw.m_occlusionQuery, occlusionVisible)
 						;
 
 					if (occluded
@@ -8546,6 +9368,12 @@ VK_DESTROY
 					currentState.m_instanceDataBuffer = draw.m_instanceDataBuffer;
 					currentState.m_instanceDataOffset = draw.m_instanceDataOffset;
 					currentState.m_instanceDataStride = draw.m_instanceDataStride;
+					currentState.m_instanceDataLayout = draw.m_instanceDataLayout;
+
+					const VertexLayout* instanceLayout = isValid(draw.m_instanceDataLayout)
+						? &m_vertexLayouts[draw.m_instanceDataLayout.idx]
+						: NULL
+						;
 
 					const VertexLayout* layouts[BGFX_CONFIG_MAX_VERTEX_STREAMS];
 					VkBuffer streamBuffers[BGFX_CONFIG_MAX_VERTEX_STREAMS + 1];
@@ -8615,7 +9443,8 @@ VK_DESTROY
 							, numStreams
 							, layouts
 							, key.m_program
-							, uint8_t(draw.m_instanceDataStride/16)
+							, NULL == instanceLayout ? uint8_t(draw.m_instanceDataStride/16) : 0
+							, instanceLayout
 							);
 
 					if (currentPipeline != pipeline)
@@ -8809,6 +9638,18 @@ VK_DESTROY
 						m_occlusionQuery.begin(draw.m_occlusionQuery);
 					}
 
+					if (hasCondition)
+					{
+						VkConditionalRenderingBeginInfoEXT crbi;
+						crbi.sType  = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT;
+						crbi.pNext  = NULL;
+						crbi.buffer = m_occlusionQuery.m_predicate;
+						crbi.offset = draw.m_occlusionQuery.idx * sizeof(uint32_t);
+						crbi.flags  = occlusionVisible ? 0 : VK_CONDITIONAL_RENDERING_INVERTED_BIT_EXT;
+
+						vkCmdBeginConditionalRenderingEXT(m_commandBuffer, &crbi);
+					}
+
 					const uint8_t primIndex = uint8_t((draw.m_stateFlags & BGFX_STATE_PT_MASK) >> BGFX_STATE_PT_SHIFT);
 					const PrimInfo& prim = s_primInfo[primIndex];
 
@@ -8928,6 +9769,11 @@ VK_DESTROY
 					statsNumInstances[primIndex]      += draw.m_numInstances;
 					statsNumIndices                   += numIndices;
 
+					if (hasCondition)
+					{
+						vkCmdEndConditionalRenderingEXT(m_commandBuffer);
+					}
+
 					if (hasOcclusionQuery)
 					{
 						m_occlusionQuery.end();
@@ -8939,6 +9785,15 @@ VK_DESTROY
 			{
 				vkCmdEndRenderPass(m_commandBuffer);
 				beginRenderPass = false;
+
+				m_occlusionQuery.copyPredicates();
+			}
+
+			m_gpuTimerScopes.update(numItems);
+
+			if (m_timerQuerySupport)
+			{
+				m_gpuTimerScopeQuery.flush();
 			}
 
 			if (wasCompute)
@@ -8960,6 +9815,8 @@ VK_DESTROY
 			}
 		}
 
+		m_gpuTimerScopes.end();
+
 		BGFX_VK_PROFILER_END();
 
 		int64_t timeEnd = bx::getHPCounter();
@@ -9039,6 +9896,7 @@ VK_DESTROY
 		bx::memCopy(perfStats.numPrims, statsNumPrimsRendered, sizeof(perfStats.numPrims) );
 		perfStats.gpuMemoryMax  = gpuMemoryAvailable;
 		perfStats.gpuMemoryUsed = gpuMemoryUsed;
+		perfStats.numGpuMemoryHeaps = m_memoryAllocator.getStats(_render->m_gpuMemoryHeapStats, BGFX_CONFIG_MAX_GPU_MEMORY_HEAPS);
 
 		if (_render->m_debug & (BGFX_DEBUG_IFH|BGFX_DEBUG_STATS) )
 		{
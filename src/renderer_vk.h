@@ -55,6 +55,7 @@
 #endif // defined(Status)
 
 #include "renderer.h"
+#include "blockallocator.h"
 #include "debug_renderdoc.h"
 
 #define VK_IMPORT                                                          \
@@ -129,113 +130,116 @@
 			VK_IMPORT_INSTANCE_FUNC(true,  vkDestroyDebugReportCallbackEXT);           \
 			VK_IMPORT_INSTANCE_PLATFORM
 
-#define VK_IMPORT_DEVICE                                                    \
-			VK_IMPORT_DEVICE_FUNC(false, vkGetDeviceQueue);                 \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateFence);                    \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyFence);                   \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateSemaphore);                \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroySemaphore);               \
-			VK_IMPORT_DEVICE_FUNC(false, vkResetFences);                    \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateCommandPool);              \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyCommandPool);             \
-			VK_IMPORT_DEVICE_FUNC(false, vkResetCommandPool);               \
-			VK_IMPORT_DEVICE_FUNC(false, vkAllocateCommandBuffers);         \
-			VK_IMPORT_DEVICE_FUNC(false, vkFreeCommandBuffers);             \
-			VK_IMPORT_DEVICE_FUNC(false, vkGetBufferMemoryRequirements);    \
-			VK_IMPORT_DEVICE_FUNC(false, vkGetImageMemoryRequirements);     \
-			VK_IMPORT_DEVICE_FUNC(false, vkGetImageSubresourceLayout);      \
-			VK_IMPORT_DEVICE_FUNC(false, vkAllocateMemory);                 \
-			VK_IMPORT_DEVICE_FUNC(false, vkFreeMemory);                     \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateImage);                    \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyImage);                   \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateImageView);                \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyImageView);               \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateBuffer);                   \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyBuffer);                  \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateFramebuffer);              \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyFramebuffer);             \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateRenderPass);               \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyRenderPass);              \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateShaderModule);             \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyShaderModule);            \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreatePipelineCache);            \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyPipelineCache);           \
-			VK_IMPORT_DEVICE_FUNC(false, vkGetPipelineCacheData);           \
-			VK_IMPORT_DEVICE_FUNC(false, vkMergePipelineCaches);            \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateGraphicsPipelines);        \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateComputePipelines);         \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyPipeline);                \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreatePipelineLayout);           \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyPipelineLayout);          \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateSampler);                  \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroySampler);                 \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateDescriptorSetLayout);      \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyDescriptorSetLayout);     \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateDescriptorPool);           \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyDescriptorPool);          \
-			VK_IMPORT_DEVICE_FUNC(false, vkResetDescriptorPool);            \
-			VK_IMPORT_DEVICE_FUNC(false, vkAllocateDescriptorSets);         \
-			VK_IMPORT_DEVICE_FUNC(false, vkFreeDescriptorSets);             \
-			VK_IMPORT_DEVICE_FUNC(false, vkUpdateDescriptorSets);           \
-			VK_IMPORT_DEVICE_FUNC(false, vkCreateQueryPool);                \
-			VK_IMPORT_DEVICE_FUNC(false, vkDestroyQueryPool);               \
-			VK_IMPORT_DEVICE_FUNC(false, vkQueueSubmit);                    \
-			VK_IMPORT_DEVICE_FUNC(false, vkQueueWaitIdle);                  \
-			VK_IMPORT_DEVICE_FUNC(false, vkDeviceWaitIdle);                 \
-			VK_IMPORT_DEVICE_FUNC(false, vkWaitForFences);                  \
-			VK_IMPORT_DEVICE_FUNC(false, vkBeginCommandBuffer);             \
-			VK_IMPORT_DEVICE_FUNC(false, vkEndCommandBuffer);               \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdPipelineBarrier);             \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdBeginRenderPass);             \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdEndRenderPass);               \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetViewport);                 \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdDraw);                        \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdDrawIndexed);                 \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdDrawIndirect);                \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdDrawIndexedIndirect);         \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdDispatch);                    \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdDispatchIndirect);            \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindPipeline);                \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetStencilReference);         \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetBlendConstants);           \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetScissor);                  \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindDescriptorSets);          \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindIndexBuffer);             \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindVertexBuffers);           \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdClearColorImage);             \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdClearDepthStencilImage);      \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdClearAttachments);            \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdResolveImage);                \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdCopyBuffer);                  \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdCopyBufferToImage);           \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdCopyImage);                   \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdCopyImageToBuffer);           \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdBlitImage);                   \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdResetQueryPool);              \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdWriteTimestamp);              \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdBeginQuery);                  \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdEndQuery);                    \
-			VK_IMPORT_DEVICE_FUNC(false, vkCmdCopyQueryPoolResults);        \
-			VK_IMPORT_DEVICE_FUNC(false, vkMapMemory);                      \
-			VK_IMPORT_DEVICE_FUNC(false, vkUnmapMemory);                    \
-			VK_IMPORT_DEVICE_FUNC(false, vkFlushMappedMemoryRanges);        \
-			VK_IMPORT_DEVICE_FUNC(false, vkInvalidateMappedMemoryRanges);   \
-			VK_IMPORT_DEVICE_FUNC(false, vkBindBufferMemory);               \
-			VK_IMPORT_DEVICE_FUNC(false, vkBindImageMemory);                \
-			/* VK_KHR_swapchain */                                          \
-			VK_IMPORT_DEVICE_FUNC(true,  vkCreateSwapchainKHR);             \
-			VK_IMPORT_DEVICE_FUNC(true,  vkDestroySwapchainKHR);            \
-			VK_IMPORT_DEVICE_FUNC(true,  vkGetSwapchainImagesKHR);          \
-			VK_IMPORT_DEVICE_FUNC(true,  vkAcquireNextImageKHR);            \
-			VK_IMPORT_DEVICE_FUNC(true,  vkQueuePresentKHR);                \
-			/* VK_EXT_debug_utils */                                        \
-			VK_IMPORT_DEVICE_FUNC(true,  vkSetDebugUtilsObjectNameEXT);     \
-			VK_IMPORT_DEVICE_FUNC(true,  vkCmdBeginDebugUtilsLabelEXT);     \
-			VK_IMPORT_DEVICE_FUNC(true,  vkCmdEndDebugUtilsLabelEXT);       \
-			VK_IMPORT_DEVICE_FUNC(true,  vkCmdInsertDebugUtilsLabelEXT);    \
-			/* VK_KHR_draw_indirect_count */                                \
-			VK_IMPORT_DEVICE_FUNC(true,  vkCmdDrawIndirectCountKHR);        \
-			VK_IMPORT_DEVICE_FUNC(true,  vkCmdDrawIndexedIndirectCountKHR); \
+#define VK_IMPORT_DEVICE                                                     \
+			VK_IMPORT_DEVICE_FUNC(false, vkGetDeviceQueue);                  \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateFence);                     \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyFence);                    \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateSemaphore);                 \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroySemaphore);                \
+			VK_IMPORT_DEVICE_FUNC(false, vkResetFences);                     \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateCommandPool);               \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyCommandPool);              \
+			VK_IMPORT_DEVICE_FUNC(false, vkResetCommandPool);                \
+			VK_IMPORT_DEVICE_FUNC(false, vkAllocateCommandBuffers);          \
+			VK_IMPORT_DEVICE_FUNC(false, vkFreeCommandBuffers);              \
+			VK_IMPORT_DEVICE_FUNC(false, vkGetBufferMemoryRequirements);     \
+			VK_IMPORT_DEVICE_FUNC(false, vkGetImageMemoryRequirements);      \
+			VK_IMPORT_DEVICE_FUNC(false, vkGetImageSubresourceLayout);       \
+			VK_IMPORT_DEVICE_FUNC(false, vkAllocateMemory);                  \
+			VK_IMPORT_DEVICE_FUNC(false, vkFreeMemory);                      \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateImage);                     \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyImage);                    \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateImageView);                 \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyImageView);                \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateBuffer);                    \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyBuffer);                   \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateFramebuffer);               \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyFramebuffer);              \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateRenderPass);                \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyRenderPass);               \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateShaderModule);              \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyShaderModule);             \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreatePipelineCache);             \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyPipelineCache);            \
+			VK_IMPORT_DEVICE_FUNC(false, vkGetPipelineCacheData);            \
+			VK_IMPORT_DEVICE_FUNC(false, vkMergePipelineCaches);             \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateGraphicsPipelines);         \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateComputePipelines);          \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyPipeline);                 \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreatePipelineLayout);            \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyPipelineLayout);           \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateSampler);                   \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroySampler);                  \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateDescriptorSetLayout);       \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyDescriptorSetLayout);      \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateDescriptorPool);            \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyDescriptorPool);           \
+			VK_IMPORT_DEVICE_FUNC(false, vkResetDescriptorPool);             \
+			VK_IMPORT_DEVICE_FUNC(false, vkAllocateDescriptorSets);          \
+			VK_IMPORT_DEVICE_FUNC(false, vkFreeDescriptorSets);              \
+			VK_IMPORT_DEVICE_FUNC(false, vkUpdateDescriptorSets);            \
+			VK_IMPORT_DEVICE_FUNC(false, vkCreateQueryPool);                 \
+			VK_IMPORT_DEVICE_FUNC(false, vkDestroyQueryPool);                \
+			VK_IMPORT_DEVICE_FUNC(false, vkQueueSubmit);                     \
+			VK_IMPORT_DEVICE_FUNC(false, vkQueueWaitIdle);                   \
+			VK_IMPORT_DEVICE_FUNC(false, vkDeviceWaitIdle);                  \
+			VK_IMPORT_DEVICE_FUNC(false, vkWaitForFences);                   \
+			VK_IMPORT_DEVICE_FUNC(false, vkBeginCommandBuffer);              \
+			VK_IMPORT_DEVICE_FUNC(false, vkEndCommandBuffer);                \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdPipelineBarrier);              \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdBeginRenderPass);              \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdEndRenderPass);                \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetViewport);                  \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdDraw);                         \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdDrawIndexed);                  \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdDrawIndirect);                 \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdDrawIndexedIndirect);          \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdDispatch);                     \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdDispatchIndirect);             \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindPipeline);                 \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetStencilReference);          \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetBlendConstants);            \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetScissor);                   \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindDescriptorSets);           \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindIndexBuffer);              \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindVertexBuffers);            \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdClearColorImage);              \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdClearDepthStencilImage);       \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdClearAttachments);             \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdResolveImage);                 \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdCopyBuffer);                   \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdCopyBufferToImage);            \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdCopyImage);                    \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdCopyImageToBuffer);            \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdBlitImage);                    \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdResetQueryPool);               \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdWriteTimestamp);               \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdBeginQuery);                   \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdEndQuery);                     \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdCopyQueryPoolResults);         \
+			VK_IMPORT_DEVICE_FUNC(false, vkMapMemory);                       \
+			VK_IMPORT_DEVICE_FUNC(false, vkUnmapMemory);                     \
+			VK_IMPORT_DEVICE_FUNC(false, vkFlushMappedMemoryRanges);         \
+			VK_IMPORT_DEVICE_FUNC(false, vkInvalidateMappedMemoryRanges);    \
+			VK_IMPORT_DEVICE_FUNC(false, vkBindBufferMemory);                \
+			VK_IMPORT_DEVICE_FUNC(false, vkBindImageMemory);                 \
+			/* VK_KHR_swapchain */                                           \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCreateSwapchainKHR);              \
+			VK_IMPORT_DEVICE_FUNC(true,  vkDestroySwapchainKHR);             \
+			VK_IMPORT_DEVICE_FUNC(true,  vkGetSwapchainImagesKHR);           \
+			VK_IMPORT_DEVICE_FUNC(true,  vkAcquireNextImageKHR);             \
+			VK_IMPORT_DEVICE_FUNC(true,  vkQueuePresentKHR);                 \
+			/* VK_EXT_debug_utils */                                         \
+			VK_IMPORT_DEVICE_FUNC(true,  vkSetDebugUtilsObjectNameEXT);      \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdBeginDebugUtilsLabelEXT);      \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdEndDebugUtilsLabelEXT);        \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdInsertDebugUtilsLabelEXT);     \
+			/* VK_KHR_draw_indirect_count */                                 \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdDrawIndirectCountKHR);         \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdDrawIndexedIndirectCountKHR);  \
+			/* VK_EXT_conditional_rendering */                               \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdBeginConditionalRenderingEXT); \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdEndConditionalRenderingEXT);   \
 
 #define VK_DESTROY                                \
 			VK_DESTROY_FUNC(Buffer);              \
@@ -389,6 +393,67 @@ VK_DESTROY_FUNC(DescriptorSet);
 		HashMap m_hashMap;
 	};
 
+	struct DeviceMemoryAllocationVK
+	{
+		DeviceMemoryAllocationVK()
+			: m_memory(VK_NULL_HANDLE)
+			, m_offset(0)
+			, m_size(0)
+			, m_block(UINT16_MAX)
+			, m_memoryType(0)
+		{
+		}
+
+		VkDeviceMemory m_memory;
+		VkDeviceSize   m_offset;
+		VkDeviceSize   m_size;
+		uint16_t       m_block; //!< Block index, UINT16_MAX for dedicated allocation.
+		uint8_t        m_memoryType;
+	};
+
+	/// Suballocates device local memory from large per memory type blocks, so
+	/// that every buffer and image doesn't need its own vkAllocateMemory.
+	class MemoryAllocatorVK
+	{
+	public:
+		MemoryAllocatorVK()
+			: m_blockSize(0)
+			, m_bufferImageGranularity(1)
+		{
+		}
+
+		void init(VkDeviceSize _blockSize, VkDeviceSize _bufferImageGranularity);
+		void shutdown();
+
+		/// Allocate memory for resource. Linear is true for buffers and
+		/// linear images, false for optimal tiling images.
+		VkResult alloc(const VkMemoryRequirements& _requirements, VkMemoryPropertyFlags _flags, bool _linear, DeviceMemoryAllocationVK* _allocation);
+
+		/// Free memory immediately, GPU must not use it anymore.
+		void free(const DeviceMemoryAllocationVK& _allocation);
+
+		uint16_t getStats(GpuMemoryHeapStats* _stats, uint16_t _max) const;
+
+	private:
+		struct Block
+		{
+			VkDeviceMemory m_memory;
+			BuddyAllocator m_allocator;
+			uint32_t       m_memoryType;
+			bool           m_linear;
+		};
+
+		VkResult alloc(uint32_t _memoryType, const VkMemoryRequirements& _requirements, bool _linear, DeviceMemoryAllocationVK* _allocation);
+
+		typedef stl::vector<Block*> BlockArray;
+		BlockArray m_blocks;
+
+		VkDeviceSize m_blockSize;
+		VkDeviceSize m_bufferImageGranularity;
+		uint32_t     m_numDedicated[VK_MAX_MEMORY_TYPES];
+		VkDeviceSize m_dedicatedSize[VK_MAX_MEMORY_TYPES];
+	};
+
 	class ScratchBufferVK
 	{
 	public:
@@ -413,11 +478,55 @@ VK_DESTROY_FUNC(DescriptorSet);
 		uint32_t m_pos;
 	};
 
+	struct StagingAllocVK
+	{
+		VkBuffer m_buffer;
+		uint32_t m_offset;
+		uint8_t* m_data;
+	};
+
+	class StagingBufferVK
+	{
+	public:
+		StagingBufferVK()
+			: m_chunkSize(0)
+			, m_chunkIdx(0)
+			, m_pos(0)
+		{
+		}
+
+		~StagingBufferVK()
+		{
+		}
+
+		void create(uint32_t _chunkSize);
+		void destroy();
+		void reset();
+		StagingAllocVK alloc(uint32_t _size, uint32_t _align);
+
+		struct Chunk
+		{
+			VkBuffer m_buffer;
+			VkDeviceMemory m_deviceMem;
+			uint8_t* m_data;
+			uint32_t m_size;
+		};
+
+		typedef stl::vector<Chunk> ChunkArray;
+		ChunkArray m_chunks;
+
+		uint32_t m_chunkSize;
+		uint32_t m_chunkIdx;
+		uint32_t m_pos;
+
+	private:
+		void destroy(Chunk& _chunk);
+	};
+
 	struct BufferVK
 	{
 		BufferVK()
 			: m_buffer(VK_NULL_HANDLE)
-			, m_deviceMem(VK_NULL_HANDLE)
 			, m_size(0)
 			, m_flags(BGFX_BUFFER_NONE)
 			, m_dynamic(false)
@@ -429,7 +538,7 @@ VK_DESTROY_FUNC(DescriptorSet);
 		void destroy();
 
 		VkBuffer m_buffer;
-		VkDeviceMemory m_deviceMem;
+		DeviceMemoryAllocationVK m_deviceMem;
 		uint32_t m_size;
 		uint16_t m_flags;
 		bool m_dynamic;
@@ -597,6 +706,45 @@ VK_DESTROY_FUNC(DescriptorSet);
 		bx::RingBufferControl m_control;
 	};
 
+	/// Timestamp queries for GPU timer scopes. Unlike TimerQueryVK, timestamps can
+	/// be written inside render pass, since queries are reset at the start of the
+	/// frame and results are copied once all render passes are finished.
+	struct TimerScopeQueryVK
+	{
+		VkResult init();
+		void shutdown();
+		void reset();
+		uint32_t begin(uint32_t _resultIdx, uint32_t _frameNum);
+		void end(uint32_t _idx);
+		void flush();
+		void update();
+
+		struct Result
+		{
+			uint64_t m_begin;
+			uint64_t m_end;
+			uint32_t m_frameNum;
+		};
+
+		struct Slot
+		{
+			uint64_t m_completed;
+			uint32_t m_frameNum;
+			uint16_t m_resultIdx[BGFX_CONFIG_MAX_GPU_TIMERS];
+			uint16_t m_num;
+			bool     m_pending;
+		};
+
+		Result m_result[BGFX_CONFIG_MAX_GPU_TIMERS];
+		Slot   m_slot[BGFX_CONFIG_MAX_FRAME_LATENCY];
+		uint32_t m_current;
+
+		VkBuffer m_readback;
+		VkDeviceMemory m_readbackMemory;
+		VkQueryPool m_queryPool;
+		const uint64_t* m_queryResult;
+	};
+
 	struct OcclusionQueryVK
 	{
 		OcclusionQueryVK()
@@ -612,6 +760,15 @@ VK_DESTROY_FUNC(DescriptorSet);
 		void resolve(Frame* _render);
 		void invalidate(OcclusionQueryHandle _handle);
 
+		/// Copy results of queries ended since last call into predicate
+		/// buffer. Must be called outside of render pass.
+		void copyPredicates();
+
+		bool isPredicateReady(OcclusionQueryHandle _handle) const
+		{
+			return 0 != (m_predicateReady[_handle.idx/32] & (UINT32_C(1) << (_handle.idx%32) ) );
+		}
+
 		OcclusionQueryHandle m_handle[BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
 
 		VkBuffer m_readback;
@@ -619,6 +776,12 @@ VK_DESTROY_FUNC(DescriptorSet);
 		VkQueryPool m_queryPool;
 		const uint32_t* m_queryResult;
 		bx::RingBufferControl m_control;
+
+		VkBuffer m_predicate;
+		VkDeviceMemory m_predicateMemory;
+		OcclusionQueryHandle m_pending[BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
+		uint32_t m_numPending;
+		uint32_t m_predicateReady[(BGFX_CONFIG_MAX_OCCLUSION_QUERIES+31)/32];
 	};
 
 	struct ReadbackVK
@@ -642,10 +805,8 @@ VK_DESTROY_FUNC(DescriptorSet);
 			, m_sampler({ 1, VK_SAMPLE_COUNT_1_BIT })
 			, m_format(VK_FORMAT_UNDEFINED)
 			, m_textureImage(VK_NULL_HANDLE)
-			, m_textureDeviceMem(VK_NULL_HANDLE)
 			, m_currentImageLayout(VK_IMAGE_LAYOUT_UNDEFINED)
 			, m_singleMsaaImage(VK_NULL_HANDLE)
-			, m_singleMsaaDeviceMem(VK_NULL_HANDLE)
 			, m_currentSingleMsaaImageLayout(VK_IMAGE_LAYOUT_UNDEFINED)
 		{
 		}
@@ -656,7 +817,7 @@ VK_DESTROY_FUNC(DescriptorSet);
 
 		void destroy();
 
-		void update(VkCommandBuffer _commandBuffer, uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem);
+		VkBuffer update(uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem, VkBufferImageCopy& _region);
 		void resolve(VkCommandBuffer _commandBuffer, uint8_t _resolve, uint32_t _layer, uint32_t _numLayers, uint32_t _mip);
 
 		void copyBufferToTexture(VkCommandBuffer _commandBuffer, VkBuffer _stagingBuffer, uint32_t _bufferImageCopyCount, VkBufferImageCopy* _bufferImageCopy);
@@ -683,11 +844,11 @@ VK_DESTROY_FUNC(DescriptorSet);
 		VkImageAspectFlags m_aspectMask;
 
 		VkImage        m_textureImage;
-		VkDeviceMemory m_textureDeviceMem;
+		DeviceMemoryAllocationVK m_textureDeviceMem;
 		VkImageLayout  m_currentImageLayout;
 
 		VkImage        m_singleMsaaImage;
-		VkDeviceMemory m_singleMsaaDeviceMem;
+		DeviceMemoryAllocationVK m_singleMsaaDeviceMem;
 		VkImageLayout  m_currentSingleMsaaImageLayout;
 
 		VkImageLayout m_sampledLayout;
@@ -843,6 +1004,7 @@ VK_DESTROY_FUNC(DescriptorSet);
 		void finish(bool _finishAll = false);
 
 		void release(uint64_t _handle, VkObjectType _type);
+		void release(const DeviceMemoryAllocationVK& _allocation);
 		void consume();
 
 		uint32_t m_queueFamily;
@@ -884,6 +1046,9 @@ VK_DESTROY_FUNC(DescriptorSet);
 		typedef stl::vector<Resource> ResourceArray;
 		ResourceArray m_release[BGFX_CONFIG_MAX_FRAME_LATENCY];
 
+		typedef stl::vector<DeviceMemoryAllocationVK> MemoryAllocationArray;
+		MemoryAllocationArray m_releaseMemory[BGFX_CONFIG_MAX_FRAME_LATENCY];
+
 	private:
 		template<typename Ty>
 		void destroy(uint64_t _handle)
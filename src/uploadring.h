@@ -0,0 +1,147 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef BGFX_UPLOADRING_H_HEADER_GUARD
+#define BGFX_UPLOADRING_H_HEADER_GUARD
+
+#include <bx/bx.h>
+#include <bx/uint32_t.h>
+
+namespace bgfx
+{
+	/// Offset and slot accounting for ring of staging buffers used for
+	/// texture uploads. It doesn't touch memory, backend owns buffers and
+	/// fences, so it can be tested without GPU device.
+	///
+	/// Each allocation is placed in current slot. When it doesn't fit into
+	/// what's left of current slot, ring moves to next slot, and backend must
+	/// fence retired slot, and wait on fence of slot it moved to.
+	///
+	class UploadRing
+	{
+	public:
+		static constexpr uint32_t kInvalidOffset = UINT32_MAX;
+		static constexpr uint32_t kAlign         = 16;
+
+		///
+		UploadRing()
+			: m_size(0)
+			, m_numSlots(0)
+			, m_current(0)
+			, m_offset(0)
+			, m_staged(0)
+			, m_direct(0)
+		{
+		}
+
+		/// Reset ring.
+		///
+		/// @param[in] _size Slot size in bytes.
+		/// @param[in] _numSlots Number of slots.
+		///
+		void reset(uint32_t _size, uint32_t _numSlots)
+		{
+			BX_ASSERT(0 < _numSlots, "Upload ring must have at least one slot.");
+			m_size     = _size;
+			m_numSlots = _numSlots;
+			m_current  = 0;
+			m_offset   = 0;
+		}
+
+		/// Allocate range in current slot, and account it as staged upload.
+		/// Upload that is larger than slot is accounted as direct upload.
+		///
+		/// @param[in] _size Size in bytes.
+		/// @param[out] _outNext Set to true if ring moved to next slot.
+		///
+		/// @returns Offset in current slot, or `kInvalidOffset` if `_size` is
+		///   larger than slot.
+		///
+		uint32_t alloc(uint32_t _size, bool& _outNext)
+		{
+			_outNext = false;
+
+			if (_size > m_size)
+			{
+				direct(_size);
+				return kInvalidOffset;
+			}
+
+			uint32_t offset = bx::strideAlign(m_offset, kAlign);
+			if (offset + _size > m_size)
+			{
+				next();
+				_outNext = true;
+				offset   = 0;
+			}
+
+			m_offset  = offset + _size;
+			m_staged += _size;
+
+			return offset;
+		}
+
+		/// Account upload that didn't go through ring.
+		void direct(uint32_t _size)
+		{
+			m_direct += _size;
+		}
+
+		/// End of frame. Moves to next slot if anything was placed in current
+		/// slot.
+		///
+		/// @returns True if ring moved to next slot.
+		///
+		bool frame()
+		{
+			if (0 != m_offset)
+			{
+				next();
+				return true;
+			}
+
+			return false;
+		}
+
+		/// Returns number of bytes staged and uploaded directly since last
+		/// call, and resets counters.
+		void getStats(int64_t& _outStaged, int64_t& _outDirect)
+		{
+			_outStaged = m_staged;
+			_outDirect = m_direct;
+			m_staged   = 0;
+			m_direct   = 0;
+		}
+
+		/// Returns current slot index.
+		uint32_t getCurrent() const { return m_current; }
+
+		/// Returns slot that was current before last move to next slot.
+		uint32_t getRetired() const { return (m_current + m_numSlots - 1) % m_numSlots; }
+
+		/// Returns slot size.
+		uint32_t getSize() const { return m_size; }
+
+		/// Returns used part of current slot.
+		uint32_t getOffset() const { return m_offset; }
+
+	private:
+		void next()
+		{
+			m_current = (m_current + 1) % m_numSlots;
+			m_offset  = 0;
+		}
+
+		uint32_t m_size;
+		uint32_t m_numSlots;
+		uint32_t m_current;
+		uint32_t m_offset;
+		int64_t  m_staged;
+		int64_t  m_direct;
+	};
+
+} // namespace bgfx
+
+#endif // BGFX_UPLOADRING_H_HEADER_GUARD
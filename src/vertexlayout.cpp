@@ -706,6 +706,17 @@ namespace bgfx
 		}
 	}
 
+	uint32_t calcInstanceDataRange(uint32_t& _outOffset, uint32_t _offset, uint32_t _size, uint16_t _stride, uint32_t _start, uint32_t _num)
+	{
+		BX_ASSERT(0 < _stride, "Instance data stride must not be zero.");
+
+		const uint32_t numInstances = 0 == _stride ? 0 : _size/_stride;
+		const uint32_t start = bx::min(_start, numInstances);
+		_outOffset = _offset + start*_stride;
+
+		return bx::min(numInstances - start, _num);
+	}
+
 	inline float sqLength(const float _a[3], const float _b[3])
 	{
 		const float xx = _a[0] - _b[0];
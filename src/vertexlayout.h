@@ -38,6 +38,23 @@ namespace bgfx
 	///
 	int32_t read(bx::ReaderI* _reader, bgfx::VertexLayout& _layout, bx::Error* _err = NULL);
 
+	/// Calculate range of instance data stream inside vertex buffer.
+	/// Instances are `_stride` bytes apart, where stride is stride of
+	/// instance data layout, and it can be different from vertex buffer
+	/// stride.
+	///
+	/// @param[out] _outOffset Byte offset of first instance.
+	/// @param[in] _offset Byte offset of data available for instances.
+	/// @param[in] _size Size of data available for instances in bytes.
+	/// @param[in] _stride Instance data stride.
+	/// @param[in] _start First instance.
+	/// @param[in] _num Number of instances.
+	///
+	/// @returns Number of instances, clamped to instances that fit inside
+	///   `_size`.
+	///
+	uint32_t calcInstanceDataRange(uint32_t& _outOffset, uint32_t _offset, uint32_t _size, uint16_t _stride, uint32_t _start, uint32_t _num);
+
 	///
 	uint32_t weldVertices(void* _output, const VertexLayout& _layout, const void* _data, uint32_t _num, bool _index32, float _epsilon, bx::AllocatorI* _allocator);
 
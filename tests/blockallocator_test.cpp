@@ -0,0 +1,157 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/allocator.h>
+#include <bx/rng.h>
+
+#include "../src/blockallocator.h"
+
+static bx::DefaultAllocator s_allocator;
+
+TEST_CASE("BuddyAllocator init validation.", "[blockallocator]")
+{
+	bgfx::BuddyAllocator ba;
+	REQUIRE(!ba.init(&s_allocator, 1000, 16) );
+	REQUIRE(!ba.init(&s_allocator, 1024, 24) );
+	REQUIRE(!ba.init(&s_allocator, 16,   32) );
+	REQUIRE( ba.init(&s_allocator, 1024, 16) );
+	REQUIRE(ba.isEmpty() );
+	REQUIRE(1024 == ba.getLargestFree() );
+}
+
+TEST_CASE("BuddyAllocator placement.", "[blockallocator]")
+{
+	constexpr uint64_t kInvalid = bgfx::BuddyAllocator::kInvalidOffset;
+
+	bgfx::BuddyAllocator ba;
+	REQUIRE(ba.init(&s_allocator, 1024, 16) );
+
+	// Rounded up to minimum size.
+	const uint64_t a = ba.alloc(1, 1);
+	REQUIRE(0  == a);
+	REQUIRE(16 == ba.getUsed() );
+
+	// Rounded up to power of 2, and aligned to its own size.
+	const uint64_t b = ba.alloc(100, 1);
+	REQUIRE(128 == b);
+	REQUIRE(16+128 == ba.getUsed() );
+
+	// Takes buddy of first allocation.
+	const uint64_t c = ba.alloc(16, 16);
+	REQUIRE(16 == c);
+
+	// Alignment larger than size, range is as large as alignment.
+	const uint64_t d = ba.alloc(16, 256);
+	REQUIRE(256 == d);
+	REQUIRE(16+128+16+256 == ba.getUsed() );
+
+	REQUIRE(512 == ba.getLargestFree() );
+	REQUIRE(4   == ba.getNumAllocations() );
+
+	REQUIRE(kInvalid == ba.alloc(1025, 1) );
+	REQUIRE(kInvalid == ba.alloc(16, 2048) );
+
+	const uint64_t e = ba.alloc(512, 1);
+	REQUIRE(512 == e);
+	REQUIRE(64 == ba.getLargestFree() );
+	REQUIRE(kInvalid == ba.alloc(65, 1) );
+
+	// Freed buddies are merged back.
+	ba.free(a);
+	ba.free(c);
+
+	const uint64_t f = ba.alloc(32, 1);
+	REQUIRE(0 == f);
+	ba.free(f);
+
+	ba.free(b);
+	ba.free(d);
+	ba.free(e);
+
+	REQUIRE(ba.isEmpty() );
+	REQUIRE(0    == ba.getUsed() );
+	REQUIRE(1024 == ba.getLargestFree() );
+}
+
+TEST_CASE("BuddyAllocator random alloc/free.", "[blockallocator]")
+{
+	constexpr uint64_t kSize    = 1<<20;
+	constexpr uint64_t kMinSize = 256;
+	constexpr uint32_t kMaxLive = 256;
+
+	bgfx::BuddyAllocator ba;
+	REQUIRE(ba.init(&s_allocator, kSize, kMinSize) );
+
+	struct Range
+	{
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	Range live[kMaxLive];
+	uint32_t numLive = 0;
+
+	bx::RngMwc rng;
+
+	for (uint32_t iter = 0; iter < 20000; ++iter)
+	{
+		if (numLive < kMaxLive
+		&&  0 != rng.gen() % 3)
+		{
+			const uint64_t size  = 1 + rng.gen() % (kSize/16);
+			const uint64_t align = uint64_t(1) << (rng.gen() % 12);
+
+			const uint64_t offset = ba.alloc(size, align);
+			if (bgfx::BuddyAllocator::kInvalidOffset == offset)
+			{
+				continue;
+			}
+
+			uint64_t rounded = kMinSize;
+			for (; rounded < size || rounded < align; rounded *= 2)
+			{
+			}
+
+			// Inside block, aligned, and doesn't overlap any live range.
+			REQUIRE(offset + rounded <= kSize);
+			REQUIRE(0 == offset % align);
+			REQUIRE(0 == offset % rounded);
+
+			for (uint32_t ii = 0; ii < numLive; ++ii)
+			{
+				REQUIRE( (offset + rounded <= live[ii].offset || live[ii].offset + live[ii].size <= offset) );
+			}
+
+			live[numLive].offset = offset;
+			live[numLive].size   = rounded;
+			++numLive;
+		}
+		else if (0 < numLive)
+		{
+			const uint32_t idx = rng.gen() % numLive;
+			ba.free(live[idx].offset);
+			live[idx] = live[--numLive];
+		}
+
+		uint64_t used = 0;
+		for (uint32_t ii = 0; ii < numLive; ++ii)
+		{
+			used += live[ii].size;
+		}
+
+		REQUIRE(used    == ba.getUsed() );
+		REQUIRE(numLive == ba.getNumAllocations() );
+		REQUIRE(ba.getLargestFree() <= kSize - used);
+	}
+
+	while (0 < numLive)
+	{
+		ba.free(live[--numLive].offset);
+	}
+
+	REQUIRE(ba.isEmpty() );
+	REQUIRE(kSize == ba.getLargestFree() );
+}
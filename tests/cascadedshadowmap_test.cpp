@@ -0,0 +1,238 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/math.h>
+
+#include "cascadedshadowmap/cascadedshadowmap.h"
+
+struct CascadedShadowMapScene
+{
+	CascadedShadowMapScene()
+	{
+		m_settings.m_near             = 1.0f;
+		m_settings.m_far              = 100.0f;
+		m_settings.m_splitWeight      = 0.75f;
+		m_settings.m_depthRange       = 200.0f;
+		m_settings.m_shadowMapSize    = 1024;
+		m_settings.m_numCascades      = 4;
+		m_settings.m_stabilize        = true;
+		m_settings.m_homogeneousDepth = false;
+
+		bx::mtxLookAt(m_view, { 0.0f, 5.0f, -10.0f }, { 0.0f, 0.0f, 20.0f });
+
+		m_lightDir[0] = 0.3f;
+		m_lightDir[1] = -1.0f;
+		m_lightDir[2] = 0.2f;
+
+		// Casters spread along view direction, so that every cascade has
+		// some of them.
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_casters); ++ii)
+		{
+			CascadedShadowMapCaster& caster = m_casters[ii];
+			const float zz = float(ii*ii)*0.9f;
+
+			caster.m_min[0] = -1.0f;
+			caster.m_min[1] =  0.0f;
+			caster.m_min[2] = zz - 1.0f;
+			caster.m_max[0] =  1.0f;
+			caster.m_max[1] =  2.0f;
+			caster.m_max[2] = zz + 1.0f;
+			caster.m_version = 0;
+		}
+	}
+
+	void update(CascadedShadowMap& _csm) const
+	{
+		_csm.update(m_settings, m_view, 60.0f, 16.0f/9.0f, m_lightDir, m_casters, BX_COUNTOF(m_casters) );
+	}
+
+	CascadedShadowMapSettings m_settings;
+	CascadedShadowMapCaster m_casters[10];
+	float m_view[16];
+	float m_lightDir[3];
+};
+
+static uint8_t dirtyMask(const CascadedShadowMap& _csm)
+{
+	uint8_t mask = 0;
+
+	for (uint8_t ii = 0; ii < _csm.getNumCascades(); ++ii)
+	{
+		mask |= _csm.getCascade(ii).m_dirty ? uint8_t(1<<ii) : 0;
+	}
+
+	return mask;
+}
+
+static void markAllRendered(CascadedShadowMap& _csm)
+{
+	for (uint8_t ii = 0; ii < _csm.getNumCascades(); ++ii)
+	{
+		_csm.markRendered(ii);
+	}
+}
+
+TEST_CASE("CascadedShadowMap cascade is clean only after it's marked rendered.", "[cascadedshadowmap]")
+{
+	CascadedShadowMapScene scene;
+
+	CascadedShadowMap csm;
+	REQUIRE(csm.init(BX_COUNTOF(scene.m_casters) ) );
+
+	scene.update(csm);
+	REQUIRE(4 == csm.getNumCascades() );
+	REQUIRE(0xf == dirtyMask(csm) );
+	REQUIRE(csm.isDirty() );
+
+	SECTION("Cascade not rendered stays dirty when nothing changed.")
+	{
+		scene.update(csm);
+		REQUIRE(0xf == dirtyMask(csm) );
+
+		csm.markRendered(1);
+		csm.markRendered(3);
+		REQUIRE(0x5 == dirtyMask(csm) );
+
+		scene.update(csm);
+		REQUIRE(0x5 == dirtyMask(csm) );
+
+		markAllRendered(csm);
+		REQUIRE(!csm.isDirty() );
+
+		scene.update(csm);
+		REQUIRE(0 == dirtyMask(csm) );
+		REQUIRE(!csm.isDirty() );
+	}
+
+	SECTION("Change of caster dirties only cascades it was or is inside.")
+	{
+		markAllRendered(csm);
+
+		for (uint32_t caster = 0; caster < BX_COUNTOF(scene.m_casters); ++caster)
+		{
+			const uint8_t before = csm.getCascadeMask(caster);
+
+			scene.m_casters[caster].m_min[0] += 0.5f;
+			scene.m_casters[caster].m_max[0] += 0.5f;
+			scene.update(csm);
+
+			const uint8_t after = csm.getCascadeMask(caster);
+			REQUIRE( (before|after) == dirtyMask(csm) );
+
+			markAllRendered(csm);
+
+			scene.m_casters[caster].m_version++;
+			scene.update(csm);
+			REQUIRE(after == dirtyMask(csm) );
+
+			markAllRendered(csm);
+		}
+	}
+
+	SECTION("Dirty cascade change is kept until rendered.")
+	{
+		markAllRendered(csm);
+
+		scene.m_casters[0].m_version++;
+		scene.update(csm);
+
+		const uint8_t dirty = dirtyMask(csm);
+		REQUIRE(0 != dirty);
+
+		// Caster goes back to version that was rendered, but frame with
+		// changed caster was never rendered.
+		scene.m_casters[0].m_version--;
+		scene.update(csm);
+		REQUIRE(0 == dirtyMask(csm) );
+
+		scene.m_casters[0].m_version++;
+		scene.update(csm);
+		REQUIRE(dirty == dirtyMask(csm) );
+
+		scene.update(csm);
+		REQUIRE(dirty == dirtyMask(csm) );
+	}
+
+	SECTION("Light and settings change dirty all cascades.")
+	{
+		markAllRendered(csm);
+
+		scene.m_lightDir[0] += 0.1f;
+		scene.update(csm);
+		REQUIRE(0xf == dirtyMask(csm) );
+
+		markAllRendered(csm);
+
+		scene.m_settings.m_shadowMapSize = 2048;
+		scene.update(csm);
+		REQUIRE(0xf == dirtyMask(csm) );
+	}
+
+	SECTION("Invalidate dirties all cascades.")
+	{
+		markAllRendered(csm);
+
+		csm.invalidate();
+		REQUIRE(0xf == dirtyMask(csm) );
+
+		scene.update(csm);
+		REQUIRE(0xf == dirtyMask(csm) );
+	}
+
+	SECTION("Cascade that was disabled is dirty when enabled again.")
+	{
+		markAllRendered(csm);
+
+		scene.m_settings.m_numCascades = 2;
+		scene.update(csm);
+		REQUIRE(2 == csm.getNumCascades() );
+
+		scene.m_settings.m_numCascades = 4;
+		scene.update(csm);
+		REQUIRE(0 != (dirtyMask(csm) & 0xc) );
+	}
+
+	csm.shutdown();
+}
+
+TEST_CASE("CascadedShadowMap casters are culled against cascades.", "[cascadedshadowmap]")
+{
+	CascadedShadowMapScene scene;
+
+	CascadedShadowMap csm;
+	REQUIRE(csm.init(BX_COUNTOF(scene.m_casters) ) );
+	scene.update(csm);
+
+	uint8_t all = 0;
+
+	for (uint32_t ii = 0; ii < BX_COUNTOF(scene.m_casters); ++ii)
+	{
+		all |= csm.getCascadeMask(ii);
+	}
+
+	REQUIRE(0xf == all);
+
+	for (uint8_t ii = 0; ii < csm.getNumCascades(); ++ii)
+	{
+		const CascadedShadowMapCascade& cascade = csm.getCascade(ii);
+		REQUIRE(0 < cascade.m_numCasters);
+		REQUIRE(cascade.m_near < cascade.m_far);
+
+		if (0 < ii)
+		{
+			// Splits overlap slightly.
+			REQUIRE(csm.getCascade(ii-1).m_far >= cascade.m_near);
+		}
+	}
+
+	// Caster far outside of light depth range is not inside any cascade.
+	scene.m_casters[0].m_min[1] = 1000.0f;
+	scene.m_casters[0].m_max[1] = 1002.0f;
+	scene.update(csm);
+	REQUIRE(0 == csm.getCascadeMask(0) );
+
+	csm.shutdown();
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+
+static void submitQuery(bgfx::ViewId _view, bgfx::OcclusionQueryHandle _query)
+{
+	bgfx::submit(_view, BGFX_INVALID_HANDLE, _query);
+}
+
+static void submitConditional(bgfx::ViewId _view, bgfx::OcclusionQueryHandle _query, bool _gpu)
+{
+	bgfx::setCondition(_query, true, _gpu);
+	bgfx::touch(_view);
+}
+
+TEST_CASE("GPU conditional render falls back when query is not issued before draw.", "[condition]")
+{
+	REQUIRE(initNoop() );
+
+	// Noop renderer reports conditional render, and sorts frame as other
+	// renderers do.
+	REQUIRE(0 != (bgfx::getCaps()->supported & BGFX_CAPS_CONDITIONAL_RENDER) );
+
+	bgfx::OcclusionQueryHandle query[4];
+	for (uint32_t ii = 0; ii < BX_COUNTOF(query); ++ii)
+	{
+		query[ii] = bgfx::createOcclusionQuery();
+		REQUIRE(bgfx::isValid(query[ii]) );
+	}
+
+	SECTION("Query issued in earlier view.")
+	{
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			submitQuery(0, query[0]);
+			submitConditional(1, query[0], true);
+			bgfx::frame();
+		}
+
+		REQUIRE(0 == bgfx::getStats()->numConditionFallbacks );
+	}
+
+	SECTION("Query issued in later view.")
+	{
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			submitConditional(0, query[0], true);
+			submitQuery(1, query[0]);
+			bgfx::frame();
+		}
+
+		REQUIRE(1 == bgfx::getStats()->numConditionFallbacks );
+	}
+
+	SECTION("Order is sorted view order, not submission order.")
+	{
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			// Conditional draw is submitted first, but its view is later.
+			submitConditional(1, query[0], true);
+			submitQuery(0, query[0]);
+
+			// Query is submitted first, but its view is later.
+			submitQuery(3, query[1]);
+			submitConditional(2, query[1], true);
+			bgfx::frame();
+		}
+
+		REQUIRE(1 == bgfx::getStats()->numConditionFallbacks );
+	}
+
+	SECTION("View order remaps views.")
+	{
+		const bgfx::ViewId order[] = { 1, 0 };
+		bgfx::setViewOrder(0, BX_COUNTOF(order), order);
+
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			submitQuery(0, query[0]);
+			submitConditional(1, query[0], true);
+			bgfx::frame();
+		}
+
+		REQUIRE(1 == bgfx::getStats()->numConditionFallbacks );
+	}
+
+	SECTION("Sequential view keeps submission order.")
+	{
+		bgfx::setViewMode(0, bgfx::ViewMode::Sequential);
+
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			submitConditional(0, query[0], true);
+			submitQuery(0, query[0]);
+			submitQuery(0, query[1]);
+			submitConditional(0, query[1], true);
+			bgfx::frame();
+		}
+
+		REQUIRE(1 == bgfx::getStats()->numConditionFallbacks );
+	}
+
+	SECTION("CPU conditions are not counted.")
+	{
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			submitConditional(0, query[0], false);
+			submitQuery(1, query[0]);
+			bgfx::frame();
+		}
+
+		REQUIRE(0 == bgfx::getStats()->numConditionFallbacks );
+	}
+
+	SECTION("Fallbacks are counted per draw.")
+	{
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			submitConditional(0, query[0], true);
+			submitConditional(0, query[1], true);
+			submitConditional(0, query[2], false);
+			submitQuery(1, query[0]);
+			submitQuery(1, query[1]);
+			submitQuery(1, query[2]);
+			submitConditional(2, query[0], true);
+			submitConditional(2, query[3], true);
+			bgfx::frame();
+		}
+
+		// Query 3 is never issued.
+		REQUIRE(3 == bgfx::getStats()->numConditionFallbacks );
+	}
+
+	for (uint32_t ii = 0; ii < BX_COUNTOF(query); ++ii)
+	{
+		bgfx::destroy(query[ii]);
+	}
+
+	bgfx::shutdown();
+}
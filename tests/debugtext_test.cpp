@@ -0,0 +1,125 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "../src/bgfx_p.h"
+#include "test.h"
+
+// 80x4 characters, 8x16 pixel font.
+static void resizeText(bgfx::TextVideoMem& _mem)
+{
+	_mem.resize(false, 80*8, 4*16);
+	REQUIRE(80 == _mem.m_width);
+	REQUIRE(4  == _mem.m_height);
+}
+
+static uint32_t numDirtyRows(const bgfx::TextVideoMem& _mem)
+{
+	uint32_t num = 0;
+
+	for (uint32_t yy = 0; yy < _mem.m_height; ++yy)
+	{
+		num += _mem.m_dirty[yy];
+	}
+
+	return num;
+}
+
+TEST_CASE("Debug text regenerates only rows that changed.", "[debugtext]")
+{
+	REQUIRE(initNoop() );
+
+	{
+		bgfx::TextVideoMem mem;
+		resizeText(mem);
+		mem.clear();
+
+		// First blit generates every row.
+		REQUIRE(4 == mem.updateBlitCache(1, false) );
+		REQUIRE(0 == mem.updateBlitCache(1, false) );
+
+		// Clearing rows that are already clear doesn't mark them dirty.
+		mem.clear();
+		REQUIRE(0 == numDirtyRows(mem) );
+		REQUIRE(0 == mem.updateBlitCache(1, false) );
+
+		mem.printf(0, 1, 0x0f, "hello");
+		REQUIRE(1 == numDirtyRows(mem) );
+		REQUIRE(1 == mem.updateBlitCache(1, false) );
+		REQUIRE(5 == mem.m_blitNum[1]);
+
+		// Only row that was written is cleared.
+		mem.clear();
+		REQUIRE(1 == numDirtyRows(mem) );
+		REQUIRE(mem.m_dirty[1]);
+		REQUIRE(1 == mem.updateBlitCache(1, false) );
+		REQUIRE(0 == mem.m_blitNum[1]);
+
+		SECTION("Row rewritten with same contents is not regenerated.")
+		{
+			mem.printf(0, 1, 0x0f, "hello");
+			REQUIRE(1 == mem.updateBlitCache(1, false) );
+
+			mem.clear();
+			mem.printf(0, 1, 0x0f, "hello");
+			REQUIRE(1 == numDirtyRows(mem) );
+			REQUIRE(0 == mem.updateBlitCache(1, false) );
+			REQUIRE(5 == mem.m_blitNum[1]);
+		}
+
+		SECTION("Clear with different attribute rewrites every row.")
+		{
+			mem.clear(0x10);
+			REQUIRE(4 == numDirtyRows(mem) );
+			REQUIRE(4 == mem.updateBlitCache(1, false) );
+
+			// Background color is drawn for every cell.
+			REQUIRE(80 == mem.m_blitNum[0]);
+		}
+	}
+
+	bgfx::shutdown();
+}
+
+TEST_CASE("Debug text cache is invalidated by scale, palette and resize.", "[debugtext]")
+{
+	REQUIRE(initNoop() );
+
+	{
+		typedef bgfx::TextVideoMem::BlitVertex Vertex;
+
+		bgfx::TextVideoMem mem;
+		resizeText(mem);
+		mem.clear();
+		mem.printf(0, 1, 0x0f, "x");
+
+		REQUIRE(4 == mem.updateBlitCache(1, false) );
+		REQUIRE(0 == mem.updateBlitCache(1, false) );
+
+		const Vertex* vertex = &( (const Vertex*)mem.m_blitVertices)[1*80*4];
+		REQUIRE(16.0f == vertex[0].m_y);
+
+		// Scale changes glyph quad positions.
+		REQUIRE(4 == mem.updateBlitCache(2, false) );
+		vertex = &( (const Vertex*)mem.m_blitVertices)[1*80*4];
+		REQUIRE(32.0f == vertex[0].m_y);
+		REQUIRE(1 == mem.m_blitNum[1]);
+
+		// sRGB back buffer changes palette.
+		const uint32_t fg = vertex[0].m_fg;
+		REQUIRE(4 == mem.updateBlitCache(2, true) );
+		vertex = &( (const Vertex*)mem.m_blitVertices)[1*80*4];
+		REQUIRE(fg != vertex[0].m_fg);
+		REQUIRE(0 == mem.updateBlitCache(2, true) );
+
+		// Resize releases cache, and rows of new size are generated.
+		mem.resize(false, 40*8, 2*16);
+		mem.clear();
+		mem.printf(0, 1, 0x0f, "x");
+		REQUIRE(2 == mem.updateBlitCache(2, true) );
+		REQUIRE(1 == mem.m_blitNum[1]);
+	}
+
+	bgfx::shutdown();
+}
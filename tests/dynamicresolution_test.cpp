@@ -0,0 +1,182 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/math.h>
+
+#include "../src/dynamicresolution.h"
+
+// Synthetic GPU that is pixel bound, frame time is proportional to number of
+// pixels rendered, plus fixed cost that doesn't scale with resolution.
+struct SyntheticGpu
+{
+	SyntheticGpu(float _fullMs, float _fixedMs)
+		: m_fullMs(_fullMs)
+		, m_fixedMs(_fixedMs)
+	{
+	}
+
+	float frame(float _scale) const
+	{
+		return m_fixedMs + m_fullMs*_scale*_scale;
+	}
+
+	float equilibrium(float _targetMs) const
+	{
+		return bx::sqrt( (_targetMs - m_fixedMs) / m_fullMs);
+	}
+
+	float m_fullMs;
+	float m_fixedMs;
+};
+
+static float run(bgfx::DynamicResolution& _dr, const SyntheticGpu& _gpu, uint32_t _numFrames)
+{
+	float scale = _dr.m_scale;
+
+	for (uint32_t ii = 0; ii < _numFrames; ++ii)
+	{
+		scale = _dr.update(_gpu.frame(scale) );
+		REQUIRE(scale >= _dr.m_minScale);
+		REQUIRE(scale <= _dr.m_maxScale);
+	}
+
+	return scale;
+}
+
+TEST_CASE("DynamicResolution converges to scale that meets target frame time.", "[dynamicresolution]")
+{
+	bgfx::DynamicResolution dr;
+	dr.reset(16.0f, 0.25f, 1.0f);
+	REQUIRE(dr.isEnabled() );
+	REQUIRE(1.0f == dr.m_scale);
+
+	const SyntheticGpu gpu(24.0f, 2.0f);
+	const float expected = gpu.equilibrium(16.0f);
+
+	run(dr, gpu, 200);
+	REQUIRE(bx::abs(dr.m_scale - expected) < 0.01f);
+
+	// Settled, scale doesn't oscillate.
+	float minScale = dr.m_scale;
+	float maxScale = dr.m_scale;
+
+	for (uint32_t ii = 0; ii < 100; ++ii)
+	{
+		const float scale = dr.update(gpu.frame(dr.m_scale) );
+		minScale = bx::min(minScale, scale);
+		maxScale = bx::max(maxScale, scale);
+	}
+
+	REQUIRE(maxScale - minScale < 0.005f);
+	REQUIRE(bx::abs(gpu.frame(dr.m_scale) - 16.0f) < 0.25f);
+
+	SECTION("Load drops, scale goes back up.")
+	{
+		const SyntheticGpu lighter(18.0f, 2.0f);
+		run(dr, lighter, 200);
+		REQUIRE(bx::abs(dr.m_scale - lighter.equilibrium(16.0f) ) < 0.01f);
+	}
+}
+
+TEST_CASE("DynamicResolution scale is clamped, and recovers from clamp without wind up.", "[dynamicresolution]")
+{
+	bgfx::DynamicResolution dr;
+	dr.reset(16.0f, 0.5f, 0.9f);
+	REQUIRE(0.9f == dr.m_scale);
+
+	// Target can't be met even at minimum scale.
+	const SyntheticGpu heavy(200.0f, 2.0f);
+	REQUIRE(run(dr, heavy, 500) == 0.5f);
+
+	// Target is met even at maximum scale.
+	const SyntheticGpu light(4.0f, 1.0f);
+	REQUIRE(run(dr, light, 200) == 0.9f);
+
+	// Long time at maximum doesn't delay reaction to overrun.
+	run(dr, light, 1000);
+
+	const SyntheticGpu medium(24.0f, 2.0f);
+	run(dr, medium, 20);
+	REQUIRE(dr.m_scale < 0.9f);
+
+	run(dr, medium, 200);
+	REQUIRE(bx::abs(dr.m_scale - medium.equilibrium(16.0f) ) < 0.01f);
+}
+
+TEST_CASE("DynamicResolution missing GPU timing keeps scale.", "[dynamicresolution]")
+{
+	bgfx::DynamicResolution dr;
+	dr.reset(16.0f, 0.25f, 1.0f);
+
+	const SyntheticGpu gpu(24.0f, 2.0f);
+	run(dr, gpu, 10);
+
+	const float scale = dr.m_scale;
+	REQUIRE(scale < 1.0f);
+	REQUIRE(scale == dr.update(0.0f) );
+	REQUIRE(scale == dr.update(0.0f) );
+}
+
+TEST_CASE("DynamicResolution disabled.", "[dynamicresolution]")
+{
+	bgfx::DynamicResolution dr;
+	REQUIRE(!dr.isEnabled() );
+	REQUIRE(1.0f == dr.m_scale);
+	REQUIRE(1.0f == dr.update(100.0f) );
+
+	// Disabling resets scale.
+	dr.reset(16.0f, 0.25f, 1.0f);
+	dr.update(100.0f);
+	REQUIRE(1.0f > dr.m_scale);
+
+	dr.reset(0.0f, 0.25f, 1.0f);
+	REQUIRE(!dr.isEnabled() );
+	REQUIRE(1.0f == dr.m_scale);
+	REQUIRE(1.0f == dr.update(100.0f) );
+	REQUIRE(1.0f == dr.update(1.0f) );
+}
+
+TEST_CASE("DynamicResolution parameters are clamped.", "[dynamicresolution]")
+{
+	bgfx::DynamicResolution dr;
+
+	dr.reset(16.0f, 0.0f, 2.0f);
+	REQUIRE(bgfx::kDynamicResolutionMinScale == dr.m_minScale);
+	REQUIRE(1.0f == dr.m_maxScale);
+
+	dr.reset(16.0f, 0.75f, 0.5f);
+	REQUIRE(0.75f == dr.m_minScale);
+	REQUIRE(0.75f == dr.m_maxScale);
+	REQUIRE(0.75f == dr.update(100.0f) );
+	REQUIRE(0.75f == dr.update(1.0f) );
+
+	// Negative target disables controller.
+	dr.reset(-1.0f, 0.5f, 1.0f);
+	REQUIRE(!dr.isEnabled() );
+	REQUIRE(1.0f == dr.m_scale);
+}
+
+TEST_CASE("Noop dynamic resolution scale is reported in stats.", "[dynamicresolution]")
+{
+	REQUIRE(initNoop() );
+
+	bgfx::frame();
+	REQUIRE(1.0f == bgfx::getStats()->resolutionScale);
+
+	// Noop renderer doesn't report GPU time, controller stays at maximum
+	// scale.
+	bgfx::setDynamicResolution(16.0f, 0.5f, 0.75f);
+	bgfx::frame();
+	bgfx::frame();
+	REQUIRE(0.75f == bgfx::getStats()->resolutionScale);
+
+	bgfx::setDynamicResolution(0.0f, 0.5f, 0.75f);
+	bgfx::frame();
+	bgfx::frame();
+	REQUIRE(1.0f == bgfx::getStats()->resolutionScale);
+
+	bgfx::shutdown();
+}
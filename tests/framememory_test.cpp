@@ -0,0 +1,116 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+
+// Arena blocks are memory references, their data doesn't follow Memory
+// header directly like it does for blocks allocated with bgfx::alloc.
+static bool isArena(const bgfx::Memory* _mem)
+{
+	return _mem->data != (const uint8_t*)_mem + sizeof(bgfx::Memory);
+}
+
+// Allocates frame memory and hands it over to bgfx, like it must be before
+// next bgfx::frame call. Returns true if it was served from arena.
+static bool submitFrameMemory(uint32_t _size)
+{
+	const bgfx::Memory* mem = bgfx::allocFrame(_size);
+	REQUIRE(NULL != mem);
+	REQUIRE(_size == mem->size);
+	bx::memSet(mem->data, 0xcd, mem->size);
+
+	const bool arena = isArena(mem);
+
+	bgfx::IndexBufferHandle ibh = bgfx::createIndexBuffer(mem);
+	REQUIRE(bgfx::isValid(ibh) );
+	bgfx::destroy(ibh);
+
+	return arena;
+}
+
+TEST_CASE("Noop frame memory falls back to heap, and arena grows to demand.", "[framememory]")
+{
+	REQUIRE(initNoop() );
+
+	// Arena is empty until demand is known, first frame is served from heap.
+	REQUIRE(!submitFrameMemory(1000) );
+	REQUIRE(!submitFrameMemory(3000) );
+	bgfx::frame();
+
+	// Each frame that was used sees demand when it's restarted, and grows
+	// its arena.
+	uint32_t used = 0;
+
+	for (uint32_t ii = 0; ii < 4; ++ii)
+	{
+		submitFrameMemory(1000);
+		submitFrameMemory(3000);
+		bgfx::frame();
+
+		const bgfx::Stats* stats = bgfx::getStats();
+		used = bx::max(used, stats->frameMemoryUsed);
+		REQUIRE(stats->frameMemoryMax >= stats->frameMemoryUsed);
+	}
+
+	// Demand includes per block header and alignment.
+	REQUIRE(4000 <  used);
+	REQUIRE(4256 >= used);
+
+	// Demand fits into arena now.
+	REQUIRE(submitFrameMemory(1000) );
+	REQUIRE(submitFrameMemory(3000) );
+	bgfx::frame();
+
+	SECTION("High-water mark is kept when demand drops.")
+	{
+		for (uint32_t ii = 0; ii < 4; ++ii)
+		{
+			REQUIRE(submitFrameMemory(100) );
+			bgfx::frame();
+		}
+
+		const bgfx::Stats* stats = bgfx::getStats();
+		REQUIRE(100   <  stats->frameMemoryUsed);
+		REQUIRE(used  >  stats->frameMemoryUsed);
+		REQUIRE(used  == stats->frameMemoryMax);
+
+		bgfx::frame();
+		bgfx::frame();
+
+		stats = bgfx::getStats();
+		REQUIRE(0    == stats->frameMemoryUsed);
+		REQUIRE(used == stats->frameMemoryMax);
+
+		// Arena doesn't shrink.
+		REQUIRE(submitFrameMemory(1000) );
+		REQUIRE(submitFrameMemory(3000) );
+	}
+
+	SECTION("Demand past arena falls back to heap, and arena grows again.")
+	{
+		REQUIRE(submitFrameMemory(1000) );
+		REQUIRE(!submitFrameMemory(128<<10) );
+		bgfx::frame();
+
+		uint32_t maxUsed = 0;
+
+		for (uint32_t ii = 0; ii < 4; ++ii)
+		{
+			submitFrameMemory(1000);
+			submitFrameMemory(128<<10);
+			bgfx::frame();
+			maxUsed = bx::max(maxUsed, bgfx::getStats()->frameMemoryMax);
+		}
+
+		REQUIRE( (128<<10) + 1000 < maxUsed);
+
+		REQUIRE(submitFrameMemory(1000) );
+		REQUIRE(submitFrameMemory(128<<10) );
+	}
+
+	bgfx::frame();
+
+	bgfx::shutdown();
+}
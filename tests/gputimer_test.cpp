@@ -0,0 +1,113 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/string.h>
+
+static const bgfx::GpuTimerStats* findGpuTimer(const bgfx::Stats* _stats, const char* _name)
+{
+	for (uint32_t ii = 0; ii < _stats->numGpuTimers; ++ii)
+	{
+		if (0 == bx::strCmp(_stats->gpuTimerStats[ii].name, _name) )
+		{
+			return &_stats->gpuTimerStats[ii];
+		}
+	}
+
+	return NULL;
+}
+
+TEST_CASE("Noop GPU timer scopes cover submitted render items.", "[gputimer]")
+{
+	REQUIRE(initNoop() );
+
+	// Noop renderer timestamp is sorted render item position, so scope
+	// duration is the number of render items it covers.
+	bgfx::setViewMode(0, bgfx::ViewMode::Sequential);
+	bgfx::setViewMode(1, bgfx::ViewMode::Sequential);
+
+	bgfx::beginGpuTimer("outer");
+		bgfx::touch(0);
+		bgfx::beginGpuTimer("inner");
+			bgfx::touch(0);
+			bgfx::touch(0);
+		bgfx::endGpuTimer();
+		bgfx::touch(1);
+	bgfx::endGpuTimer();
+
+	bgfx::beginGpuTimer("empty");
+	bgfx::endGpuTimer();
+
+	bgfx::frame();
+
+	const bgfx::Stats* stats = bgfx::getStats();
+
+	// Results are available asynchronously.
+	REQUIRE(0 == stats->numGpuTimers);
+
+	for (uint32_t ii = 0; 0 == stats->numGpuTimers && ii < 16; ++ii)
+	{
+		bgfx::frame();
+		stats = bgfx::getStats();
+	}
+
+	// Scope that doesn't cover any render item is not measured.
+	REQUIRE(2 == stats->numGpuTimers);
+	REQUIRE(NULL == findGpuTimer(stats, "empty") );
+
+	const bgfx::GpuTimerStats* outer = findGpuTimer(stats, "outer");
+	const bgfx::GpuTimerStats* inner = findGpuTimer(stats, "inner");
+	REQUIRE(NULL != outer);
+	REQUIRE(NULL != inner);
+
+	REQUIRE(0 == outer->depth);
+	REQUIRE(1 == inner->depth);
+	REQUIRE(0 == outer->view);
+	REQUIRE(0 == inner->view);
+	REQUIRE(0 == outer->numForeign);
+	REQUIRE(0 == inner->numForeign);
+
+	REQUIRE(4 == outer->gpuTimeEnd - outer->gpuTimeBegin);
+	REQUIRE(2 == inner->gpuTimeEnd - inner->gpuTimeBegin);
+	REQUIRE(outer->gpuTimeBegin <= inner->gpuTimeBegin);
+	REQUIRE(outer->gpuTimeEnd   >= inner->gpuTimeEnd);
+	REQUIRE(outer->gpuFrameNum  == inner->gpuFrameNum);
+
+	bgfx::shutdown();
+}
+
+TEST_CASE("Noop GPU timer scope counts interleaved render items.", "[gputimer]")
+{
+	REQUIRE(initNoop() );
+
+	bgfx::setViewMode(0, bgfx::ViewMode::Sequential);
+	bgfx::setViewMode(1, bgfx::ViewMode::Sequential);
+
+	// Scope spans two views, render item submitted after it in view 0 is
+	// sorted between scope render items.
+	bgfx::beginGpuTimer("views");
+		bgfx::touch(0);
+		bgfx::touch(1);
+	bgfx::endGpuTimer();
+	bgfx::touch(0);
+
+	const bgfx::Stats* stats = bgfx::getStats();
+
+	for (uint32_t ii = 0; 0 == stats->numGpuTimers && ii < 16; ++ii)
+	{
+		bgfx::frame();
+		stats = bgfx::getStats();
+	}
+
+	REQUIRE(1 == stats->numGpuTimers);
+
+	const bgfx::GpuTimerStats* views = findGpuTimer(stats, "views");
+	REQUIRE(NULL != views);
+	REQUIRE(0 == views->view);
+	REQUIRE(1 == views->numForeign);
+	REQUIRE(3 == views->gpuTimeEnd - views->gpuTimeBegin);
+
+	bgfx::shutdown();
+}
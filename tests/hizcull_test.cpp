@@ -0,0 +1,302 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/math.h>
+#include <bx/rng.h>
+
+#include "hizcull/hizcull.h"
+
+static constexpr uint16_t kWidth  = 64;
+static constexpr uint16_t kHeight = 32;
+
+// Occluder depth, far plane with number of random rectangles in front of it.
+static void fillDepth(float* _depth, uint32_t _numRects, bx::RngMwc& _rng)
+{
+	for (uint32_t ii = 0; ii < kWidth*kHeight; ++ii)
+	{
+		_depth[ii] = 1.0f;
+	}
+
+	for (uint32_t ii = 0; ii < _numRects; ++ii)
+	{
+		const uint32_t x0 = _rng.gen() % kWidth;
+		const uint32_t y0 = _rng.gen() % kHeight;
+		const uint32_t x1 = bx::min<uint32_t>(x0 + 1 + _rng.gen() % 32, kWidth);
+		const uint32_t y1 = bx::min<uint32_t>(y0 + 1 + _rng.gen() % 16, kHeight);
+		const float depth = 0.9f + bx::frnd(&_rng)*0.1f;
+
+		for (uint32_t yy = y0; yy < y1; ++yy)
+		{
+			for (uint32_t xx = x0; xx < x1; ++xx)
+			{
+				_depth[yy*kWidth + xx] = bx::min(_depth[yy*kWidth + xx], depth);
+			}
+		}
+	}
+}
+
+// Returns true if any texel of occluder depth under screen space bounding
+// rectangle of box is behind nearest point of box. Optionally returns max
+// number of texels rectangle touches in either dimension.
+static bool isVisibleBruteForce(const HiZCullReference& _ref, const float* _min, const float* _max, const float* _viewProj, int32_t* _outNumTexels = NULL)
+{
+	float minZ = 1.0f;
+	float minXY[2] = { 1.0f, 1.0f };
+	float maxXY[2] = { 0.0f, 0.0f };
+
+	for (uint32_t ii = 0; ii < 8; ++ii)
+	{
+		const float corner[4] =
+		{
+			ii&1 ? _max[0] : _min[0],
+			ii&2 ? _max[1] : _min[1],
+			ii&4 ? _max[2] : _min[2],
+			1.0f,
+		};
+
+		float clip[4];
+		bx::vec4MulMtx(clip, corner, _viewProj);
+
+		const float xx = bx::clamp(clip[0]/clip[3], -1.0f, 1.0f) *  0.5f + 0.5f;
+		const float yy = bx::clamp(clip[1]/clip[3], -1.0f, 1.0f) * -0.5f + 0.5f;
+		const float zz = bx::max(clip[2], 0.0f)/clip[3];
+
+		minXY[0] = bx::min(minXY[0], xx);
+		minXY[1] = bx::min(minXY[1], yy);
+		maxXY[0] = bx::max(maxXY[0], xx);
+		maxXY[1] = bx::max(maxXY[1], yy);
+		minZ = bx::clamp(bx::min(minZ, zz), 0.0f, 1.0f);
+	}
+
+	const int32_t x0 = int32_t(bx::floor(minXY[0]*kWidth) );
+	const int32_t y0 = int32_t(bx::floor(minXY[1]*kHeight) );
+	const int32_t x1 = int32_t(bx::floor(maxXY[0]*kWidth) );
+	const int32_t y1 = int32_t(bx::floor(maxXY[1]*kHeight) );
+
+	if (NULL != _outNumTexels)
+	{
+		*_outNumTexels = bx::max(x1 - x0, y1 - y0) + 1;
+	}
+
+	for (int32_t yy = y0; yy <= y1; ++yy)
+	{
+		for (int32_t xx = x0; xx <= x1; ++xx)
+		{
+			if (minZ <= _ref.getDepth(0, xx, yy) )
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+static void makeViewProj(float* _viewProj)
+{
+	float view[16];
+	bx::mtxLookAt(view, { 0.0f, 0.0f, -10.0f }, { 0.0f, 0.0f, 0.0f });
+
+	float proj[16];
+	bx::mtxProj(proj, 60.0f, float(kWidth)/float(kHeight), 0.1f, 100.0f, false);
+
+	bx::mtxMul(_viewProj, view, proj);
+}
+
+static void makeInstance(HiZCullInstance& _instance, uint16_t _group, bx::RngMwc& _rng)
+{
+	const float cx = (bx::frnd(&_rng)*2.0f - 1.0f)*10.0f;
+	const float cy = (bx::frnd(&_rng)*2.0f - 1.0f)*5.0f;
+	const float cz = bx::frnd(&_rng)*60.0f;
+	const float hs = 0.05f + bx::frnd(&_rng)*2.0f;
+
+	_instance.m_min[0] = cx - hs;
+	_instance.m_min[1] = cy - hs;
+	_instance.m_min[2] = cz - hs;
+	_instance.m_max[0] = cx + hs;
+	_instance.m_max[1] = cy + hs;
+	_instance.m_max[2] = cz + hs;
+	_instance.m_group  = _group;
+}
+
+TEST_CASE("HiZCullReference mip chain keeps max depth.", "[hizcull]")
+{
+	bx::RngMwc rng;
+
+	float depth[kWidth*kHeight];
+	for (uint32_t ii = 0; ii < BX_COUNTOF(depth); ++ii)
+	{
+		depth[ii] = bx::frnd(&rng);
+	}
+
+	HiZCullReference ref;
+	ref.build(depth, kWidth, kHeight);
+
+	REQUIRE(7 == ref.getNumMips() );
+
+	float maxDepth = 0.0f;
+	for (uint32_t ii = 0; ii < BX_COUNTOF(depth); ++ii)
+	{
+		maxDepth = bx::max(maxDepth, depth[ii]);
+	}
+
+	for (uint8_t mip = 1; mip < ref.getNumMips(); ++mip)
+	{
+		const int32_t width  = bx::max(kWidth  >> mip, 1);
+		const int32_t height = bx::max(kHeight >> mip, 1);
+		const int32_t srcHeight = bx::max(kHeight >> (mip-1), 1);
+
+		for (int32_t yy = 0; yy < height; ++yy)
+		{
+			for (int32_t xx = 0; xx < width; ++xx)
+			{
+				float expected = bx::max(ref.getDepth(mip-1, xx*2, yy*2), ref.getDepth(mip-1, xx*2+1, yy*2) );
+
+				if (yy*2+1 < srcHeight)
+				{
+					expected = bx::max(expected, ref.getDepth(mip-1, xx*2, yy*2+1), ref.getDepth(mip-1, xx*2+1, yy*2+1) );
+				}
+
+				REQUIRE(expected == ref.getDepth(mip, xx, yy) );
+			}
+		}
+	}
+
+	REQUIRE(maxDepth == ref.getDepth(ref.getNumMips()-1, 0, 0) );
+}
+
+TEST_CASE("HiZCullReference doesn't cull visible box that touches up to 2x2 texels.", "[hizcull]")
+{
+	bx::RngMwc rng;
+
+	float viewProj[16];
+	makeViewProj(viewProj);
+
+	float depth[kWidth*kHeight];
+	uint32_t numVisible = 0;
+	uint32_t numOccluded = 0;
+
+	for (uint32_t pass = 0; pass < 16; ++pass)
+	{
+		fillDepth(depth, 8, rng);
+
+		HiZCullReference ref;
+		ref.build(depth, kWidth, kHeight);
+
+		for (uint32_t ii = 0; ii < 256; ++ii)
+		{
+			HiZCullInstance instance;
+			makeInstance(instance, 0, rng);
+
+			const bool visible = ref.isVisible(instance.m_min, instance.m_max, viewProj, false, false);
+
+			// Box that touches up to 2x2 texels at mip 0 touches up to 2x2
+			// texels at any mip, and corner samples cover all of them. Larger
+			// boxes can be culled by mistake, same as in shader.
+			int32_t numTexels;
+			if (isVisibleBruteForce(ref, instance.m_min, instance.m_max, viewProj, &numTexels)
+			&&  2 >= numTexels)
+			{
+				REQUIRE(visible);
+			}
+
+			numVisible  += visible;
+			numOccluded += !visible;
+		}
+	}
+
+	// Scene must exercise both outcomes.
+	REQUIRE(0 < numVisible);
+	REQUIRE(0 < numOccluded);
+}
+
+TEST_CASE("HiZCullReference full screen occluder.", "[hizcull]")
+{
+	float viewProj[16];
+	makeViewProj(viewProj);
+
+	// Occluder at view depth ~10.
+	float depth[kWidth*kHeight];
+	const float occluderZ = (100.0f/(100.0f - 0.1f) ) * (1.0f - 0.1f/10.0f);
+	for (uint32_t ii = 0; ii < BX_COUNTOF(depth); ++ii)
+	{
+		depth[ii] = occluderZ;
+	}
+
+	HiZCullReference ref;
+	ref.build(depth, kWidth, kHeight);
+
+	const float behindMin[3] = { -1.0f, -1.0f, 20.0f };
+	const float behindMax[3] = {  1.0f,  1.0f, 22.0f };
+	REQUIRE(!ref.isVisible(behindMin, behindMax, viewProj, false, false) );
+	REQUIRE(!ref.isVisible(behindMin, behindMax, viewProj, false, true) );
+
+	const float frontMin[3] = { -1.0f, -1.0f, -5.0f };
+	const float frontMax[3] = {  1.0f,  1.0f, -3.0f };
+	REQUIRE(ref.isVisible(frontMin, frontMax, viewProj, false, false) );
+	REQUIRE(ref.isVisible(frontMin, frontMax, viewProj, false, true) );
+}
+
+TEST_CASE("HiZCullReference cull counts visible instances per group.", "[hizcull]")
+{
+	bx::RngMwc rng;
+
+	float viewProj[16];
+	makeViewProj(viewProj);
+
+	float depth[kWidth*kHeight];
+	fillDepth(depth, 8, rng);
+
+	HiZCullReference ref;
+	ref.build(depth, kWidth, kHeight);
+
+	// More instances than single batch of HiZCull, and some with invalid group.
+	constexpr uint32_t kNumInstances = HiZCull::kBatchSize + 100;
+	constexpr uint16_t kNumGroups    = 5;
+
+	HiZCullInstance* instances = new HiZCullInstance[kNumInstances];
+	bool* visible = new bool[kNumInstances];
+
+	for (uint32_t ii = 0; ii < kNumInstances; ++ii)
+	{
+		makeInstance(instances[ii], uint16_t(ii % (kNumGroups+1) ), rng);
+	}
+
+	uint32_t groupCount[kNumGroups];
+	const uint32_t numVisible = ref.cull(instances, kNumInstances, viewProj, false, false, visible, groupCount, kNumGroups);
+
+	uint32_t expected[kNumGroups] = {};
+	uint32_t total = 0;
+
+	for (uint32_t ii = 0; ii < kNumInstances; ++ii)
+	{
+		const HiZCullInstance& instance = instances[ii];
+
+		if (instance.m_group >= kNumGroups)
+		{
+			REQUIRE(!visible[ii]);
+			continue;
+		}
+
+		REQUIRE(visible[ii] == ref.isVisible(instance.m_min, instance.m_max, viewProj, false, false) );
+
+		if (visible[ii])
+		{
+			++expected[instance.m_group];
+			++total;
+		}
+	}
+
+	REQUIRE(total == numVisible);
+
+	for (uint16_t ii = 0; ii < kNumGroups; ++ii)
+	{
+		REQUIRE(expected[ii] == groupCount[ii]);
+	}
+
+	delete [] visible;
+	delete [] instances;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <dear-imgui/imgui.h>
+
+#include "imgui/imgui.h"
+
+static constexpr uint16_t kWidth  = 64;
+static constexpr uint16_t kHeight = 32;
+
+typedef void (*UiFn)();
+
+static void runUi(UiFn _ui, uint32_t& _outNumCommands, uint32_t& _outNumSubmits)
+{
+	// Second frame is measured, first one can contain one-off work.
+	for (uint32_t ii = 0; ii < 2; ++ii)
+	{
+		imguiBeginFrame(0, 0, 0, 0, kWidth, kHeight);
+		_ui();
+		imguiEndFrame();
+
+		imguiGetStats(_outNumCommands, _outNumSubmits);
+
+		bgfx::frame();
+	}
+}
+
+static void uiSameState()
+{
+	// Background and foreground draw lists both use font texture and full
+	// screen clip rect.
+	ImGui::GetBackgroundDrawList()->AddRectFilled(ImVec2(0.0f, 0.0f), ImVec2( 8.0f,  8.0f), 0xff0000ff);
+	ImGui::GetForegroundDrawList()->AddRectFilled(ImVec2(8.0f, 8.0f), ImVec2(16.0f, 16.0f), 0xff00ff00);
+}
+
+static void uiClipRect()
+{
+	ImGui::GetBackgroundDrawList()->AddRectFilled(ImVec2(0.0f, 0.0f), ImVec2(8.0f, 8.0f), 0xff0000ff);
+
+	ImDrawList* drawList = ImGui::GetForegroundDrawList();
+	drawList->PushClipRect(ImVec2(0.0f, 0.0f), ImVec2(32.0f, 16.0f) );
+	drawList->AddRectFilled(ImVec2(8.0f, 8.0f), ImVec2(16.0f, 16.0f), 0xff00ff00);
+	drawList->PopClipRect();
+}
+
+static void uiCallback()
+{
+	ImGui::GetBackgroundDrawList()->AddRectFilled(ImVec2(0.0f, 0.0f), ImVec2(8.0f, 8.0f), 0xff0000ff);
+
+	// Callback splits batch, draws before it must be submitted before it.
+	ImDrawList* drawList = ImGui::GetForegroundDrawList();
+	drawList->AddCallback(ImDrawCallback_ResetRenderState, NULL);
+	drawList->AddRectFilled(ImVec2(8.0f, 8.0f), ImVec2(16.0f, 16.0f), 0xff00ff00);
+}
+
+static void uiWindow()
+{
+	ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f) );
+	ImGui::SetNextWindowSize(ImVec2(float(kWidth), float(kHeight) ) );
+	ImGui::Begin("Test");
+	ImGui::Text("Hello");
+	ImGui::Button("Button");
+	ImGui::End();
+}
+
+TEST_CASE("ImGui commands with the same state are merged into single draw.", "[imgui]")
+{
+	REQUIRE(initNoop() );
+
+	imguiCreate();
+
+	uint32_t numCommands = 0;
+	uint32_t numSubmits  = 0;
+
+	SECTION("Same state.")
+	{
+		runUi(uiSameState, numCommands, numSubmits);
+		REQUIRE(2 == numCommands);
+		REQUIRE(1 == numSubmits);
+	}
+
+	SECTION("Different clip rect.")
+	{
+		runUi(uiClipRect, numCommands, numSubmits);
+		REQUIRE(2 == numCommands);
+		REQUIRE(2 == numSubmits);
+	}
+
+	SECTION("Callback.")
+	{
+		runUi(uiCallback, numCommands, numSubmits);
+		REQUIRE(3 == numCommands);
+		REQUIRE(2 == numSubmits);
+	}
+
+	SECTION("Window.")
+	{
+		runUi(uiWindow, numCommands, numSubmits);
+		REQUIRE(0 <  numSubmits);
+		REQUIRE(numSubmits <= numCommands);
+	}
+
+	imguiDestroy();
+
+	bgfx::shutdown();
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+
+#include <bx/readerwriter.h>
+
+#include "../src/vertexlayout.h"
+
+TEST_CASE("Instance data layout stride.", "[instancedata]")
+{
+	// Packed position, quaternion and color.
+	bgfx::VertexLayout packed;
+	packed.begin(bgfx::RendererType::Noop)
+		.add(bgfx::Attrib::TexCoord7, 3, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::TexCoord6, 4, bgfx::AttribType::Half)
+		.add(bgfx::Attrib::TexCoord5, 4, bgfx::AttribType::Uint8, true)
+		.end();
+
+	REQUIRE(24 == packed.getStride() );
+	REQUIRE(0  == packed.getOffset(bgfx::Attrib::TexCoord7) );
+	REQUIRE(12 == packed.getOffset(bgfx::Attrib::TexCoord6) );
+	REQUIRE(20 == packed.getOffset(bgfx::Attrib::TexCoord5) );
+
+	// Same data as fixed i_data rows.
+	bgfx::VertexLayout rows;
+	rows.begin(bgfx::RendererType::Noop)
+		.add(bgfx::Attrib::TexCoord7, 4, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::TexCoord6, 4, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::TexCoord5, 4, bgfx::AttribType::Float)
+		.end();
+
+	REQUIRE(48 == rows.getStride() );
+	REQUIRE(packed.m_hash != rows.m_hash);
+}
+
+TEST_CASE("Instance data range uses instance layout stride.", "[instancedata]")
+{
+	uint32_t offset;
+
+	SECTION("Layout stride matches buffer stride.")
+	{
+		REQUIRE(10 == bgfx::calcInstanceDataRange(offset, 0, 10*32, 32, 0, UINT32_MAX) );
+		REQUIRE(0  == offset);
+
+		REQUIRE(3 == bgfx::calcInstanceDataRange(offset, 0, 10*32, 32, 2, 3) );
+		REQUIRE(2*32 == offset);
+	}
+
+	SECTION("Layout stride is smaller than buffer stride.")
+	{
+		// 10 vertices with 32 byte stride hold 13 instances with 24 byte
+		// stride, and instance start is in layout stride units.
+		REQUIRE(13 == bgfx::calcInstanceDataRange(offset, 0, 10*32, 24, 0, UINT32_MAX) );
+		REQUIRE(0  == offset);
+
+		REQUIRE(8 == bgfx::calcInstanceDataRange(offset, 0, 10*32, 24, 5, UINT32_MAX) );
+		REQUIRE(5*24 == offset);
+	}
+
+	SECTION("Layout stride is larger than buffer stride.")
+	{
+		REQUIRE(5 == bgfx::calcInstanceDataRange(offset, 0, 10*16, 32, 0, UINT32_MAX) );
+		REQUIRE(2 == bgfx::calcInstanceDataRange(offset, 0, 10*16, 32, 3, UINT32_MAX) );
+		REQUIRE(3*32 == offset);
+	}
+
+	SECTION("Range starts inside buffer.")
+	{
+		// Dynamic and transient buffers start at vertex in buffer stride
+		// units.
+		REQUIRE(4 == bgfx::calcInstanceDataRange(offset, 7*32, 4*24, 24, 0, UINT32_MAX) );
+		REQUIRE(7*32 == offset);
+
+		REQUIRE(1 == bgfx::calcInstanceDataRange(offset, 7*32, 4*24, 24, 1, 1) );
+		REQUIRE(7*32+24 == offset);
+	}
+
+	SECTION("Partial instance at the end is not used.")
+	{
+		REQUIRE(3 == bgfx::calcInstanceDataRange(offset, 0, 3*24+23, 24, 0, UINT32_MAX) );
+	}
+
+	SECTION("Start past the end.")
+	{
+		REQUIRE(0 == bgfx::calcInstanceDataRange(offset, 64, 4*24, 24, 10, UINT32_MAX) );
+		REQUIRE(64+4*24 == offset);
+	}
+}
+
+// Counts debug checks instead of failing test.
+struct DebugCheckCallback : public TestCallback
+{
+	DebugCheckCallback()
+		: m_numDebugChecks(0)
+	{
+	}
+
+	virtual void fatal(const char* _filePath, uint16_t _line, bgfx::Fatal::Enum _code, const char* _str) override
+	{
+		if (bgfx::Fatal::DebugCheck == _code)
+		{
+			++m_numDebugChecks;
+			return;
+		}
+
+		TestCallback::fatal(_filePath, _line, _code, _str);
+	}
+
+	uint32_t m_numDebugChecks;
+};
+
+// Minimal shader binary, noop renderer never compiles shader code. GLSL
+// binaries end after shader code, other binaries list used attributes.
+static const bgfx::Memory* makeShader(char _type, uint32_t _code, const bgfx::Attrib::Enum* _attrs, uint8_t _numAttrs, bool _listAttrs = true)
+{
+	uint8_t data[256];
+	bx::StaticMemoryBlockWriter writer(data, sizeof(data) );
+
+	bx::Error err;
+	bx::write(&writer, uint32_t(BX_MAKEFOURCC(_type, 'S', 'H', 11) ), &err);
+	bx::write(&writer, uint32_t(0x1234), &err); // Input hash.
+	bx::write(&writer, uint32_t(0x1234), &err); // Output hash.
+	bx::write(&writer, uint16_t(0), &err);      // Number of uniforms.
+	bx::write(&writer, uint32_t(sizeof(_code) ), &err);
+	bx::write(&writer, _code, &err);
+	bx::write(&writer, uint8_t(0), &err);
+
+	if (_listAttrs)
+	{
+		bx::write(&writer, _numAttrs, &err);
+
+		for (uint32_t ii = 0; ii < _numAttrs; ++ii)
+		{
+			bx::write(&writer, bgfx::attribToId(_attrs[ii]), &err);
+		}
+
+		bx::write(&writer, uint16_t(0), &err);  // Constant buffer size.
+	}
+
+	REQUIRE(err.isOk() );
+
+	return bgfx::copy(data, uint32_t(bx::seek(&writer) ) );
+}
+
+TEST_CASE("Instance data layout is validated against program attributes.", "[instancedata]")
+{
+	DebugCheckCallback callback;
+	REQUIRE(initNoop(&callback) );
+
+	bgfx::VertexLayout vertexLayout;
+	vertexLayout.begin()
+		.add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
+		.end();
+
+	bgfx::VertexLayout usedLayout;
+	usedLayout.begin()
+		.add(bgfx::Attrib::TexCoord7, 4, bgfx::AttribType::Float)
+		.end();
+
+	bgfx::VertexLayout unusedLayout;
+	unusedLayout.begin()
+		.add(bgfx::Attrib::TexCoord3, 4, bgfx::AttribType::Float)
+		.end();
+
+	const float vertices[3*3] = {};
+	const float instances[2*4] = {};
+
+	bgfx::VertexBufferHandle vbh = bgfx::createVertexBuffer(bgfx::copy(vertices, sizeof(vertices) ), vertexLayout);
+	bgfx::VertexBufferHandle ibh = bgfx::createVertexBuffer(bgfx::copy(instances, sizeof(instances) ), usedLayout);
+	bgfx::VertexLayoutHandle unusedHandle = bgfx::createVertexLayout(unusedLayout);
+
+	const bgfx::Attrib::Enum attrs[] = { bgfx::Attrib::Position, bgfx::Attrib::TexCoord7 };
+	bgfx::ShaderHandle fsh = bgfx::createShader(makeShader('F', 0, NULL, 0) );
+
+	// Debug checks are compiled only into debug build.
+	const uint32_t numExpected = BX_ENABLED(BX_CONFIG_DEBUG) ? 1 : 0;
+
+	SECTION("Layout without used attributes is reported.")
+	{
+		bgfx::ShaderHandle vsh = bgfx::createShader(makeShader('V', 1, attrs, BX_COUNTOF(attrs) ) );
+		bgfx::ProgramHandle program = bgfx::createProgram(vsh, fsh);
+		REQUIRE(bgfx::isValid(program) );
+
+		bgfx::setVertexBuffer(0, vbh);
+		bgfx::setInstanceDataBuffer(ibh, 0, 2, BGFX_INVALID_HANDLE);
+		bgfx::submit(0, program);
+		REQUIRE(0 == callback.m_numDebugChecks);
+
+		bgfx::setVertexBuffer(0, vbh);
+		bgfx::setInstanceDataBuffer(ibh, 0, 2, unusedHandle);
+		bgfx::submit(0, program);
+		REQUIRE(numExpected == callback.m_numDebugChecks);
+
+		bgfx::destroy(program);
+		bgfx::destroy(vsh);
+	}
+
+	SECTION("Shader without attribute list is not validated.")
+	{
+		bgfx::ShaderHandle vsh = bgfx::createShader(makeShader('V', 2, attrs, BX_COUNTOF(attrs), false) );
+		bgfx::ProgramHandle program = bgfx::createProgram(vsh, fsh);
+		REQUIRE(bgfx::isValid(program) );
+
+		bgfx::setVertexBuffer(0, vbh);
+		bgfx::setInstanceDataBuffer(ibh, 0, 2, unusedHandle);
+		bgfx::submit(0, program);
+		REQUIRE(0 == callback.m_numDebugChecks);
+
+		bgfx::destroy(program);
+		bgfx::destroy(vsh);
+	}
+
+	bgfx::frame();
+
+	bgfx::destroy(fsh);
+	bgfx::destroy(unusedHandle);
+	bgfx::destroy(ibh);
+	bgfx::destroy(vbh);
+
+	bgfx::shutdown();
+}
@@ -0,0 +1,365 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/math.h>
+#include <bx/rng.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "isosurface/isosurface.h"
+
+static constexpr uint32_t kDims            = 24;
+static constexpr uint32_t kMaxSlabVertices = 8<<10;
+static constexpr uint32_t kMaxSlabIndices  = 32<<10;
+static constexpr float    kIso             = 0.75f;
+
+static const float s_origin[3] = { -11.5f, -11.5f, -11.5f };
+
+struct IsoSurfaceScene
+{
+	IsoSurfaceScene(uint32_t _numBalls, uint32_t _seed)
+		: m_numBalls(_numBalls)
+	{
+		bx::RngMwc rng(_seed);
+
+		for (uint32_t ii = 0; ii < m_numBalls; ++ii)
+		{
+			IsoSurfaceMetaball& ball = m_ball[ii];
+			ball.m_pos[0]    = bx::frnd(&rng)*8.0f - 4.0f;
+			ball.m_pos[1]    = bx::frnd(&rng)*8.0f - 4.0f;
+			ball.m_pos[2]    = bx::frnd(&rng)*8.0f - 4.0f;
+			ball.m_invRadius = 1.0f/(2.0f + bx::frnd(&rng) );
+		}
+	}
+
+	float field(float _x, float _y, float _z) const
+	{
+		float sum = 0.0f;
+
+		for (uint32_t ii = 0; ii < m_numBalls; ++ii)
+		{
+			const IsoSurfaceMetaball& ball = m_ball[ii];
+			const float dx = ball.m_pos[0] - _x;
+			const float dy = ball.m_pos[1] - _y;
+			const float dz = ball.m_pos[2] - _z;
+			const float invR = ball.m_invRadius;
+			sum += 1.0f/( (dx*dx + dy*dy + dz*dz)*invR*invR);
+		}
+
+		return sum - 1.0f;
+	}
+
+	IsoSurfaceMetaball m_ball[8];
+	uint32_t m_numBalls;
+};
+
+struct Pos
+{
+	float x, y, z;
+};
+
+static bool operator<(const Pos& _a, const Pos& _b)
+{
+	if (_a.x != _b.x) { return _a.x < _b.x; }
+	if (_a.y != _b.y) { return _a.y < _b.y; }
+	return _a.z < _b.z;
+}
+
+// Reference polygonizer vertices: every grid edge adjacent to cells of slab
+// whose end points are on opposite sides of iso value, with vertex linearly
+// interpolated along the edge.
+static std::vector<Pos> referenceVertices(IsoSurface& _isoSurface, uint32_t _begin, uint32_t _end)
+{
+	const uint32_t dims = _isoSurface.getDims();
+	const float* field = _isoSurface.getField();
+
+	std::vector<Pos> result;
+
+	for (uint32_t axis = 0; axis < 3; ++axis)
+	{
+		const uint32_t zend = 2 == axis ? _end : _end+1;
+
+		for (uint32_t zz = _begin; zz < zend; ++zz)
+		{
+			for (uint32_t yy = 0; yy < dims - (1 == axis); ++yy)
+			{
+				for (uint32_t xx = 0; xx < dims - (0 == axis); ++xx)
+				{
+					const uint32_t x1 = xx + (0 == axis);
+					const uint32_t y1 = yy + (1 == axis);
+					const uint32_t z1 = zz + (2 == axis);
+
+					const float v0 = field[(zz*dims + yy)*dims + xx];
+					const float v1 = field[(z1*dims + y1)*dims + x1];
+
+					if ( (v0 < kIso) == (v1 < kIso) )
+					{
+						continue;
+					}
+
+					const float lerp = (kIso - v0) / (v1 - v0);
+
+					Pos pos;
+					pos.x = s_origin[0] + float(xx) + (0 == axis ? lerp : 0.0f);
+					pos.y = s_origin[1] + float(yy) + (1 == axis ? lerp : 0.0f);
+					pos.z = s_origin[2] + float(zz) + (2 == axis ? lerp : 0.0f);
+					result.push_back(pos);
+				}
+			}
+		}
+	}
+
+	std::sort(result.begin(), result.end() );
+
+	return result;
+}
+
+struct IsoSurfaceOutput
+{
+	IsoSurfaceOutput()
+		: m_vertices(kNumSlabs*kMaxSlabVertices)
+		, m_indices(kNumSlabs*kMaxSlabIndices)
+	{
+	}
+
+	static constexpr uint32_t kNumSlabs = 5;
+
+	std::vector<IsoSurfaceVertex> m_vertices;
+	std::vector<uint16_t> m_indices;
+};
+
+TEST_CASE("IsoSurface field and vertices match reference polygonizer.", "[isosurface]")
+{
+	const IsoSurfaceScene scene(4, 1337);
+
+	IsoSurface isoSurface;
+	REQUIRE(isoSurface.init(32, IsoSurfaceOutput::kNumSlabs) );
+	isoSurface.setGrid(kDims, IsoSurfaceOutput::kNumSlabs, s_origin, 1.0f);
+
+	const uint32_t numSlabs = isoSurface.getNumSlabs();
+	REQUIRE(IsoSurfaceOutput::kNumSlabs == numSlabs);
+
+	for (uint32_t ii = 0; ii < numSlabs; ++ii)
+	{
+		isoSurface.evaluate(ii, scene.m_ball, scene.m_numBalls);
+	}
+
+	const float* field = isoSurface.getField();
+
+	for (uint32_t zz = 0; zz < kDims; ++zz)
+	{
+		for (uint32_t yy = 0; yy < kDims; ++yy)
+		{
+			for (uint32_t xx = 0; xx < kDims; ++xx)
+			{
+				const float expected = scene.field(s_origin[0] + xx, s_origin[1] + yy, s_origin[2] + zz);
+				const float actual   = field[(zz*kDims + yy)*kDims + xx];
+				REQUIRE(bx::abs(expected - actual) <= 1e-4f*bx::max(1.0f, bx::abs(expected) ) );
+			}
+		}
+	}
+
+	IsoSurfaceOutput output;
+
+	// Slabs are polygonized independently, vertices at slab boundary are
+	// emitted by both slabs.
+	std::map<Pos, uint32_t> merged;
+	std::map<std::pair<uint32_t, uint32_t>, int32_t> halfEdges;
+	uint32_t numTriangles = 0;
+
+	for (uint32_t slab = 0; slab < numSlabs; ++slab)
+	{
+		IsoSurfaceVertex* vertices = &output.m_vertices[slab*kMaxSlabVertices];
+		uint16_t* indices = &output.m_indices[slab*kMaxSlabIndices];
+
+		isoSurface.extract(slab, kIso, vertices, kMaxSlabVertices, indices, kMaxSlabIndices);
+
+		REQUIRE(!isoSurface.isTruncated(slab) );
+
+		const uint32_t numVertices = isoSurface.getNumVertices(slab);
+		const uint32_t numIndices  = isoSurface.getNumIndices(slab);
+		REQUIRE(0 == numIndices%3);
+
+		// Slab cell layers cover grid without gaps.
+		const uint32_t layers = kDims-1;
+		const uint32_t begin  = slab*( (layers + numSlabs - 1)/numSlabs);
+		const uint32_t end    = bx::min(begin + (layers + numSlabs - 1)/numSlabs, layers);
+
+		const std::vector<Pos> expected = referenceVertices(isoSurface, begin, end);
+		REQUIRE(expected.size() == numVertices);
+
+		std::vector<Pos> actual(numVertices);
+		for (uint32_t ii = 0; ii < numVertices; ++ii)
+		{
+			actual[ii] = { vertices[ii].m_pos[0], vertices[ii].m_pos[1], vertices[ii].m_pos[2] };
+		}
+		std::sort(actual.begin(), actual.end() );
+
+		for (uint32_t ii = 0; ii < numVertices; ++ii)
+		{
+			REQUIRE(bx::abs(expected[ii].x - actual[ii].x) < 1e-4f);
+			REQUIRE(bx::abs(expected[ii].y - actual[ii].y) < 1e-4f);
+			REQUIRE(bx::abs(expected[ii].z - actual[ii].z) < 1e-4f);
+		}
+
+		std::vector<uint32_t> remap(numVertices);
+		for (uint32_t ii = 0; ii < numVertices; ++ii)
+		{
+			const Pos pos = { vertices[ii].m_pos[0], vertices[ii].m_pos[1], vertices[ii].m_pos[2] };
+			remap[ii] = merged.insert(std::make_pair(pos, uint32_t(merged.size() ) ) ).first->second;
+		}
+
+		for (uint32_t ii = 0; ii < numIndices; ii += 3)
+		{
+			REQUIRE(indices[ii+0] < numVertices);
+			REQUIRE(indices[ii+1] < numVertices);
+			REQUIRE(indices[ii+2] < numVertices);
+
+			const uint32_t tri[3] = { remap[indices[ii]], remap[indices[ii+1]], remap[indices[ii+2]] };
+
+			for (uint32_t jj = 0; jj < 3; ++jj)
+			{
+				const uint32_t a = tri[jj];
+				const uint32_t b = tri[(jj+1)%3];
+				REQUIRE(a != b);
+
+				// Opposite half edges cancel out in closed surface.
+				if (a < b)
+				{
+					++halfEdges[std::make_pair(a, b)];
+				}
+				else
+				{
+					--halfEdges[std::make_pair(b, a)];
+				}
+			}
+
+			++numTriangles;
+		}
+	}
+
+	REQUIRE(0 < numTriangles);
+
+	// Surface is inside grid, merged mesh must be closed and consistently
+	// wound.
+	for (const auto& it : halfEdges)
+	{
+		REQUIRE(0 == it.second);
+	}
+}
+
+TEST_CASE("IsoSurface normals point out of single metaball.", "[isosurface]")
+{
+	IsoSurfaceMetaball ball = { { 0.3f, -0.2f, 0.1f }, 1.0f/4.0f };
+
+	IsoSurface isoSurface;
+	REQUIRE(isoSurface.init(32, 2) );
+	isoSurface.setGrid(kDims, 2, s_origin, 1.0f);
+
+	IsoSurfaceOutput output;
+	isoSurface.update(&ball, 1, kIso, output.m_vertices.data(), kMaxSlabVertices, output.m_indices.data(), kMaxSlabIndices);
+
+	// Surface of single metaball is sphere where 1/(d^2/r^2) - 1 = iso.
+	const float radius = 4.0f/bx::sqrt(1.0f + kIso);
+
+	for (uint32_t slab = 0; slab < isoSurface.getNumSlabs(); ++slab)
+	{
+		REQUIRE(0 < isoSurface.getNumVertices(slab) );
+
+		for (uint32_t ii = 0; ii < isoSurface.getNumVertices(slab); ++ii)
+		{
+			const IsoSurfaceVertex& vertex = output.m_vertices[slab*kMaxSlabVertices + ii];
+			const bx::Vec3 dir = bx::sub(bx::load<bx::Vec3>(vertex.m_pos), bx::load<bx::Vec3>(ball.m_pos) );
+
+			REQUIRE(bx::abs(bx::length(dir) - radius) < 0.25f);
+			REQUIRE(0.9f < bx::dot(bx::normalize(dir), bx::load<bx::Vec3>(vertex.m_normal) ) );
+		}
+	}
+}
+
+TEST_CASE("IsoSurface update on worker threads matches serial extraction.", "[isosurface]")
+{
+	IsoSurface serial;
+	IsoSurface threaded;
+	REQUIRE(serial.init(32, IsoSurfaceOutput::kNumSlabs) );
+	REQUIRE(threaded.init(32, IsoSurfaceOutput::kNumSlabs, 3) );
+
+	IsoSurfaceOutput expected;
+	IsoSurfaceOutput actual;
+
+	for (uint32_t frame = 0; frame < 8; ++frame)
+	{
+		const IsoSurfaceScene scene(1 + frame%8, 1 + frame);
+
+		// Number of slabs changes between frames, and is not multiple of
+		// number of threads.
+		const uint32_t numSlabs = 1 + frame%IsoSurfaceOutput::kNumSlabs;
+		serial.setGrid(kDims, numSlabs, s_origin, 1.0f);
+		threaded.setGrid(kDims, numSlabs, s_origin, 1.0f);
+
+		for (uint32_t ii = 0; ii < numSlabs; ++ii)
+		{
+			serial.evaluate(ii, scene.m_ball, scene.m_numBalls);
+		}
+
+		for (uint32_t ii = 0; ii < numSlabs; ++ii)
+		{
+			serial.extract(
+				  ii
+				, kIso
+				, &expected.m_vertices[ii*kMaxSlabVertices]
+				, kMaxSlabVertices
+				, &expected.m_indices[ii*kMaxSlabIndices]
+				, kMaxSlabIndices
+				);
+		}
+
+		threaded.update(
+			  scene.m_ball
+			, scene.m_numBalls
+			, kIso
+			, actual.m_vertices.data()
+			, kMaxSlabVertices
+			, actual.m_indices.data()
+			, kMaxSlabIndices
+			);
+
+		REQUIRE(numSlabs == threaded.getNumSlabs() );
+
+		for (uint32_t ii = 0; ii < numSlabs; ++ii)
+		{
+			const uint32_t numVertices = serial.getNumVertices(ii);
+			const uint32_t numIndices  = serial.getNumIndices(ii);
+
+			REQUIRE(numVertices == threaded.getNumVertices(ii) );
+			REQUIRE(numIndices  == threaded.getNumIndices(ii) );
+			REQUIRE(0 == bx::memCmp(&expected.m_vertices[ii*kMaxSlabVertices], &actual.m_vertices[ii*kMaxSlabVertices], numVertices*sizeof(IsoSurfaceVertex) ) );
+			REQUIRE(0 == bx::memCmp(&expected.m_indices[ii*kMaxSlabIndices], &actual.m_indices[ii*kMaxSlabIndices], numIndices*sizeof(uint16_t) ) );
+		}
+	}
+
+	threaded.shutdown();
+	serial.shutdown();
+}
+
+TEST_CASE("IsoSurface reports truncated slab.", "[isosurface]")
+{
+	const IsoSurfaceScene scene(4, 1337);
+
+	IsoSurface isoSurface;
+	REQUIRE(isoSurface.init(32, 1, 2) );
+	isoSurface.setGrid(kDims, 1, s_origin, 1.0f);
+
+	IsoSurfaceVertex vertices[64];
+	uint16_t indices[256];
+	isoSurface.update(scene.m_ball, scene.m_numBalls, kIso, vertices, BX_COUNTOF(vertices), indices, BX_COUNTOF(indices) );
+
+	REQUIRE(isoSurface.isTruncated(0) );
+	REQUIRE(isoSurface.getNumVertices(0) <= BX_COUNTOF(vertices) );
+	REQUIRE(isoSurface.getNumIndices(0)  <= BX_COUNTOF(indices) );
+}
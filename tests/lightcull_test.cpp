@@ -0,0 +1,221 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/math.h>
+#include <bx/rng.h>
+
+#include "lightcull/lightcull.h"
+
+static constexpr float kNear = 0.1f;
+static constexpr float kFar  = 100.0f;
+
+struct LightCullScene
+{
+	LightCullScene(uint32_t _numLights, bool _aroundEye)
+		: m_numLights(_numLights)
+	{
+		bx::mtxLookAt(m_view, { 3.0f, 2.0f, -12.0f }, { 0.0f, 0.0f, 0.0f });
+		bx::mtxProj(m_proj, 60.0f, 16.0f/9.0f, kNear, kFar, true);
+
+		bx::RngMwc rng;
+
+		for (uint32_t ii = 0; ii < m_numLights; ++ii)
+		{
+			LightCullLight& light = m_light[ii];
+
+			if (_aroundEye)
+			{
+				light.m_posRadius[0] =   3.0f + (bx::frnd(&rng)*2.0f - 1.0f);
+				light.m_posRadius[1] =   2.0f + (bx::frnd(&rng)*2.0f - 1.0f);
+				light.m_posRadius[2] = -12.0f + (bx::frnd(&rng)*2.0f - 1.0f);
+			}
+			else
+			{
+				light.m_posRadius[0] = (bx::frnd(&rng)*2.0f - 1.0f)*20.0f;
+				light.m_posRadius[1] = (bx::frnd(&rng)*2.0f - 1.0f)*20.0f;
+				light.m_posRadius[2] = (bx::frnd(&rng)*2.0f - 1.0f)*20.0f;
+			}
+
+			// Lights around eye are large enough to always cross plane of the eye.
+			light.m_posRadius[3] = (_aroundEye ? 2.0f : 0.5f) + bx::frnd(&rng)*4.0f;
+			light.m_rgbInner[0]  = 1.0f;
+			light.m_rgbInner[1]  = 1.0f;
+			light.m_rgbInner[2]  = 1.0f;
+			light.m_rgbInner[3]  = 0.5f;
+		}
+	}
+
+	float m_view[16];
+	float m_proj[16];
+	LightCullLight m_light[512];
+	uint32_t m_numLights;
+};
+
+// Returns cluster of world space point, the same way lightcull.sh does it.
+static bool findCluster(uint32_t& _outCluster, const LightCull& _lc, const LightCullScene& _scene, uint16_t _slices, const bx::Vec3& _pos)
+{
+	const bx::Vec3 viewPos = bx::mul(_pos, _scene.m_view);
+
+	if (viewPos.z < kNear
+	||  viewPos.z > kFar)
+	{
+		return false;
+	}
+
+	const bx::Vec3 ndc = bx::mulH(viewPos, _scene.m_proj);
+
+	if (bx::abs(ndc.x) > 1.0f
+	||  bx::abs(ndc.y) > 1.0f)
+	{
+		return false;
+	}
+
+	const float tilesX = float(_lc.getTilesX() );
+	const float tilesY = float(_lc.getTilesY() );
+	const float logRange   = bx::log(kFar/kNear);
+	const float sliceScale = float(_slices)/logRange;
+	const float sliceBias  = -float(_slices)*bx::log(kNear)/logRange;
+
+	const float tx    = bx::clamp(bx::floor( (ndc.x*0.5f + 0.5f)*tilesX), 0.0f, tilesX - 1.0f);
+	const float ty    = bx::clamp(bx::floor( (ndc.y*0.5f + 0.5f)*tilesY), 0.0f, tilesY - 1.0f);
+	const float slice = bx::clamp(bx::floor(bx::log(viewPos.z)*sliceScale + sliceBias), 0.0f, float(_slices - 1) );
+
+	_outCluster = _lc.getClusterIndex(uint16_t(tx), uint16_t(ty), uint16_t(slice) );
+
+	return true;
+}
+
+static bool isLightInCluster(const LightCull& _lc, uint32_t _cluster, uint32_t _light)
+{
+	const uint32_t* indices = &_lc.getLightIndices()[_lc.getClusterOffset(_cluster)];
+
+	for (uint32_t ii = 0, num = _lc.getClusterCount(_cluster); ii < num; ++ii)
+	{
+		if (_light == indices[ii])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void checkBinning(const LightCullScene& _scene, uint16_t _tilesX, uint16_t _tilesY, uint16_t _slices)
+{
+	LightCull lc;
+	REQUIRE(lc.init(_tilesX, _tilesY, _slices, BX_COUNTOF(_scene.m_light), 1<<20, false) );
+
+	lc.bin(_scene.m_view, _scene.m_proj, kNear, kFar, _scene.m_light, _scene.m_numLights);
+
+	REQUIRE(0 == lc.getNumDropped() );
+	REQUIRE(0 <  lc.getNumVisibleLights() );
+
+	// Lists are in light order, every light is referenced at most once.
+	for (uint32_t cluster = 0, num = lc.getNumClusters(); cluster < num; ++cluster)
+	{
+		const uint32_t* indices = &lc.getLightIndices()[lc.getClusterOffset(cluster)];
+
+		for (uint32_t ii = 1, count = lc.getClusterCount(cluster); ii < count; ++ii)
+		{
+			REQUIRE(indices[ii-1] < indices[ii]);
+		}
+	}
+
+	// Every point inside light sphere must find that light in its cluster.
+	bx::RngMwc rng;
+	uint32_t numTested = 0;
+
+	for (uint32_t light = 0; light < _scene.m_numLights; ++light)
+	{
+		const float* posRadius = _scene.m_light[light].m_posRadius;
+
+		for (uint32_t ii = 0; ii < 256; ++ii)
+		{
+			const bx::Vec3 dir =
+			{
+				bx::frnd(&rng)*2.0f - 1.0f,
+				bx::frnd(&rng)*2.0f - 1.0f,
+				bx::frnd(&rng)*2.0f - 1.0f,
+			};
+
+			if (bx::length(dir) > 1.0f)
+			{
+				continue;
+			}
+
+			// Stay slightly inside to avoid testing precision of tile edges.
+			const bx::Vec3 pos = bx::mad(dir, bx::Vec3(posRadius[3]*0.999f), { posRadius[0], posRadius[1], posRadius[2] });
+
+			uint32_t cluster;
+			if (findCluster(cluster, lc, _scene, _slices, pos) )
+			{
+				REQUIRE(isLightInCluster(lc, cluster, light) );
+				++numTested;
+			}
+		}
+	}
+
+	REQUIRE(0 < numTested);
+}
+
+TEST_CASE("LightCull init validation.", "[lightcull]")
+{
+	LightCull lc;
+	REQUIRE(!lc.init( 0, 8,   16, 16, 16, false) );
+	REQUIRE(!lc.init(64, 8,   16, 16, 16, false) );
+	REQUIRE(!lc.init(16, 8,    0, 16, 16, false) );
+	REQUIRE(!lc.init(16, 8,   16,  0, 16, false) );
+
+	// Grid texture height would not fit 16-bit texture size.
+	REQUIRE(!lc.init(16, 63, 2048, 16, 16, false) );
+
+	REQUIRE( lc.init(16, 8,   16, 16, 16, false) );
+}
+
+TEST_CASE("LightCull binning is conservative.", "[lightcull]")
+{
+	const LightCullScene scene(512, false);
+
+	checkBinning(scene, 16,  9, 16);
+	checkBinning(scene, 63, 63,  1);
+	checkBinning(scene,  1,  1, 64);
+	checkBinning(scene,  7,  5,  3);
+}
+
+TEST_CASE("LightCull lights around eye cover all tiles.", "[lightcull]")
+{
+	const LightCullScene scene(16, true);
+
+	checkBinning(scene, 16, 9, 16);
+
+	LightCull lc;
+	REQUIRE(lc.init(16, 9, 16, 16, 1<<16, false) );
+	lc.bin(scene.m_view, scene.m_proj, kNear, kFar, scene.m_light, scene.m_numLights);
+
+	REQUIRE(scene.m_numLights == lc.getNumVisibleLights() );
+
+	for (uint32_t ii = 0, num = lc.getNumVisibleLights(); ii < num; ++ii)
+	{
+		uint16_t rect[4];
+		lc.getVisibleLightTiles(ii, rect);
+		REQUIRE( 0 == rect[0]);
+		REQUIRE( 0 == rect[1]);
+		REQUIRE(15 == rect[2]);
+		REQUIRE( 8 == rect[3]);
+	}
+}
+
+TEST_CASE("LightCull index list overflow is reported.", "[lightcull]")
+{
+	const LightCullScene scene(512, false);
+
+	LightCull lc;
+	REQUIRE(lc.init(16, 9, 16, 512, 64, false) );
+	lc.bin(scene.m_view, scene.m_proj, kNear, kFar, scene.m_light, scene.m_numLights);
+
+	REQUIRE(64 == lc.getNumIndices() );
+	REQUIRE(0  <  lc.getNumDropped() );
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/file.h>
+
+TEST_CASE("Noop screen shot is delivered with frame latency.", "[readback]")
+{
+	TestCallback callback;
+	REQUIRE(initNoop(&callback) );
+
+	bgfx::frame();
+
+	bgfx::requestScreenShot(BGFX_INVALID_HANDLE, "test");
+	bgfx::frame();
+
+	// Readback must not block the frame it was requested in.
+	REQUIRE(0 == callback.m_numScreenShots);
+
+	uint32_t numFrames = 1;
+	for (; 0 == callback.m_numScreenShots && numFrames < 16; ++numFrames)
+	{
+		bgfx::frame();
+	}
+
+	REQUIRE(1 == callback.m_numScreenShots);
+	REQUIRE(1 < numFrames);
+	REQUIRE(64    == callback.m_width);
+	REQUIRE(32    == callback.m_height);
+	REQUIRE(64*4  == callback.m_pitch);
+	REQUIRE(64*32*4 == callback.m_size);
+	REQUIRE(callback.m_black);
+
+	bgfx::shutdown();
+
+	REQUIRE(1 == callback.m_numScreenShots);
+}
+
+TEST_CASE("Noop pending screen shot is flushed on shutdown.", "[readback]")
+{
+	TestCallback callback;
+	REQUIRE(initNoop(&callback) );
+
+	bgfx::requestScreenShot(BGFX_INVALID_HANDLE, "test");
+	bgfx::frame();
+	REQUIRE(0 == callback.m_numScreenShots);
+
+	bgfx::shutdown();
+	REQUIRE(1 == callback.m_numScreenShots);
+}
+
+TEST_CASE("Noop capture delivers one frame per frame.", "[readback]")
+{
+	TestCallback callback;
+	REQUIRE(initNoop(&callback, BGFX_RESET_CAPTURE) );
+
+	constexpr uint32_t kNumFrames = 10;
+	for (uint32_t ii = 0; ii < kNumFrames; ++ii)
+	{
+		bgfx::frame();
+	}
+
+	REQUIRE(1 == callback.m_numCaptureBegin);
+	REQUIRE(0 == callback.m_numCaptureEnd);
+	REQUIRE(0 <  callback.m_numCaptureFrames);
+	REQUIRE(kNumFrames > callback.m_numCaptureFrames);
+	REQUIRE(64*4    == callback.m_pitch);
+
+	bgfx::shutdown();
+
+	// Frames in flight are delivered before capture ends.
+	REQUIRE(1 == callback.m_numCaptureEnd);
+	REQUIRE(kNumFrames <= callback.m_numCaptureFrames);
+	REQUIRE(64*32*4 == callback.m_size);
+	REQUIRE(callback.m_black);
+}
+
+TEST_CASE("Noop readback with default callback doesn't write files.", "[readback]")
+{
+	REQUIRE(initNoop(NULL, BGFX_RESET_CAPTURE) );
+
+	bgfx::requestScreenShot(BGFX_INVALID_HANDLE, "noop-default-callback");
+
+	for (uint32_t ii = 0; ii < 8; ++ii)
+	{
+		bgfx::frame();
+	}
+
+	bgfx::shutdown();
+
+	// Default callback writes screen shot as .tga file.
+	bx::FileReader reader;
+	const bool exists = bx::open(&reader, "noop-default-callback.tga");
+	if (exists)
+	{
+		bx::close(&reader);
+	}
+
+	REQUIRE(!exists);
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#define CATCH_AMALGAMATED_CUSTOM_MAIN
+#include "test.h"
+
+int main(int _argc, const char* _argv[])
+{
+	Catch::Session session;
+
+	int32_t result = session.applyCommandLine(_argc, _argv);
+	if (0 != result)
+	{
+		return result;
+	}
+
+	return session.run();
+}
@@ -0,0 +1,587 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/math.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "shadowvolume/shadowvolume.h"
+
+struct ShadowVolumeTestVertex
+{
+	float m_pos[3];
+	float m_normal[3];
+	float m_uv[2];
+};
+
+struct ShadowVolumeTestMesh
+{
+	// UV sphere. Seam and pole vertices are duplicated like in textured
+	// mesh, and have to be welded to find adjacency.
+	void sphere(uint16_t _rings, uint16_t _segments, float _radius)
+	{
+		for (uint16_t rr = 0; rr <= _rings; ++rr)
+		{
+			const float theta = bx::kPi*float(rr)/float(_rings);
+
+			for (uint16_t ss = 0; ss <= _segments; ++ss)
+			{
+				const float phi = bx::kPi2*float(ss % _segments)/float(_segments);
+
+				ShadowVolumeTestVertex vertex;
+				vertex.m_normal[0] = bx::sin(theta)*bx::cos(phi);
+				vertex.m_normal[1] = bx::cos(theta);
+				vertex.m_normal[2] = bx::sin(theta)*bx::sin(phi);
+
+				if (0 == rr || _rings == rr)
+				{
+					vertex.m_normal[0] = 0.0f;
+					vertex.m_normal[2] = 0.0f;
+				}
+
+				vertex.m_pos[0] = vertex.m_normal[0]*_radius;
+				vertex.m_pos[1] = vertex.m_normal[1]*_radius;
+				vertex.m_pos[2] = vertex.m_normal[2]*_radius;
+				vertex.m_uv[0]  = float(ss)/float(_segments);
+				vertex.m_uv[1]  = float(rr)/float(_rings);
+				m_vertices.push_back(vertex);
+			}
+		}
+
+		const uint16_t pitch = _segments+1;
+
+		for (uint16_t rr = 0; rr < _rings; ++rr)
+		{
+			for (uint16_t ss = 0; ss < _segments; ++ss)
+			{
+				const uint16_t i0 = rr*pitch + ss;
+				const uint16_t i1 = i0 + 1;
+				const uint16_t i2 = i0 + pitch;
+				const uint16_t i3 = i2 + 1;
+
+				if (0 != rr)
+				{
+					triangle(i0, i1, i2);
+				}
+
+				if (_rings-1 != rr)
+				{
+					triangle(i1, i3, i2);
+				}
+			}
+		}
+	}
+
+	// Flat grid in XZ plane, every edge at border is boundary edge.
+	void grid(uint16_t _dim)
+	{
+		for (uint16_t zz = 0; zz <= _dim; ++zz)
+		{
+			for (uint16_t xx = 0; xx <= _dim; ++xx)
+			{
+				ShadowVolumeTestVertex vertex = {};
+				vertex.m_pos[0]    = float(xx) - float(_dim)*0.5f;
+				vertex.m_pos[2]    = float(zz) - float(_dim)*0.5f;
+				vertex.m_normal[1] = 1.0f;
+				m_vertices.push_back(vertex);
+			}
+		}
+
+		const uint16_t pitch = _dim+1;
+
+		for (uint16_t zz = 0; zz < _dim; ++zz)
+		{
+			for (uint16_t xx = 0; xx < _dim; ++xx)
+			{
+				const uint16_t i0 = zz*pitch + xx;
+				triangle(i0, i0+pitch, i0+1);
+				triangle(i0+1, i0+pitch, i0+pitch+1);
+			}
+		}
+	}
+
+	void triangle(uint16_t _i0, uint16_t _i1, uint16_t _i2)
+	{
+		m_indices.push_back(_i0);
+		m_indices.push_back(_i1);
+		m_indices.push_back(_i2);
+	}
+
+	bool init(ShadowVolumeMesh& _mesh) const
+	{
+		return _mesh.init(
+			  m_vertices.data()
+			, uint16_t(m_vertices.size() )
+			, uint16_t(sizeof(ShadowVolumeTestVertex) )
+			, m_indices.data()
+			, uint32_t(m_indices.size() )
+			);
+	}
+
+	std::vector<ShadowVolumeTestVertex> m_vertices;
+	std::vector<uint16_t> m_indices;
+};
+
+// Reference shadow volume, brute force adjacency search and scalar plane
+// test, same rules as 14-shadowvolumes before it used the library.
+struct ShadowVolumeReference
+{
+	ShadowVolumeReference(const ShadowVolumeTestMesh& _mesh, const float* _light)
+	{
+		const uint32_t numVertices = uint32_t(_mesh.m_vertices.size() );
+		const uint32_t numFaces    = uint32_t(_mesh.m_indices.size()/3);
+
+		for (uint32_t ii = 0; ii < numVertices; ++ii)
+		{
+			uint32_t weld = ii;
+			for (uint32_t jj = 0; jj < ii; ++jj)
+			{
+				if (0 == bx::memCmp(_mesh.m_vertices[ii].m_pos, _mesh.m_vertices[jj].m_pos, 3*sizeof(float) ) )
+				{
+					weld = jj;
+					break;
+				}
+			}
+
+			m_weld.push_back(weld);
+		}
+
+		for (uint32_t ii = 0; ii < numFaces; ++ii)
+		{
+			const bx::Vec3 v0 = bx::load<bx::Vec3>(_mesh.m_vertices[_mesh.m_indices[ii*3+0] ].m_pos);
+			const bx::Vec3 v1 = bx::load<bx::Vec3>(_mesh.m_vertices[_mesh.m_indices[ii*3+1] ].m_pos);
+			const bx::Vec3 v2 = bx::load<bx::Vec3>(_mesh.m_vertices[_mesh.m_indices[ii*3+2] ].m_pos);
+
+			const bx::Vec3 normal = bx::normalize(bx::cross(bx::sub(v2, v0), bx::sub(v1, v2) ) );
+			const float dist = bx::dot(normal, bx::load<bx::Vec3>(_light) ) - bx::dot(normal, v0);
+
+			m_facing.push_back(dist > 0.0f);
+			m_ambiguous = m_ambiguous || bx::abs(dist) < 0.0001f;
+		}
+
+		for (uint32_t ii = 0; ii < numFaces; ++ii)
+		{
+			for (uint32_t jj = 0; jj < 3; ++jj)
+			{
+				const uint32_t i0 = m_weld[_mesh.m_indices[ii*3 + jj] ];
+				const uint32_t i1 = m_weld[_mesh.m_indices[ii*3 + (jj+1)%3] ];
+
+				// Find face on the other side of the edge.
+				int32_t other = -1;
+				for (uint32_t kk = 0; kk < numFaces && -1 == other; ++kk)
+				{
+					for (uint32_t ll = 0; ll < 3; ++ll)
+					{
+						if (i1 == m_weld[_mesh.m_indices[kk*3 + ll] ]
+						&&  i0 == m_weld[_mesh.m_indices[kk*3 + (ll+1)%3] ])
+						{
+							other = int32_t(kk);
+							break;
+						}
+					}
+				}
+
+				// Silhouette is edge of facing face whose neighbour is not
+				// facing, or is missing.
+				if (m_facing[ii]
+				&&  (-1 == other || !m_facing[other]) )
+				{
+					m_silhouette.push_back(std::make_pair(i0, i1) );
+				}
+			}
+
+			std::vector<uint16_t>& cap = m_facing[ii] ? m_frontCap : m_backCap;
+			cap.insert(cap.end(), &_mesh.m_indices[ii*3], &_mesh.m_indices[ii*3+3]);
+		}
+
+		std::sort(m_silhouette.begin(), m_silhouette.end() );
+	}
+
+	std::vector<uint32_t> m_weld;
+	std::vector<bool> m_facing;
+	std::vector<std::pair<uint32_t, uint32_t> > m_silhouette;
+	std::vector<uint16_t> m_frontCap;
+	std::vector<uint16_t> m_backCap;
+	bool m_ambiguous = false;
+};
+
+struct ShadowVolumeOutput
+{
+	void extract(const ShadowVolumeMesh& _mesh, const float* _light, ShadowVolumeType::Enum _type, bool _textureAsStencil)
+	{
+		m_facing.resize(_mesh.getNumFaces() );
+		_mesh.classify(m_facing.data(), _light);
+		_mesh.calcSize(m_size, m_facing.data(), _type, true, _textureAsStencil);
+
+		const uint32_t numSide  = m_size.m_numSideIndices;
+		const uint32_t numFront = m_size.m_numFrontCapIndices;
+		const uint32_t numBack  = m_size.m_numBackCapIndices;
+
+		// Single index buffer like in example, cap pointers are not NULL
+		// even when one of caps is empty.
+		std::vector<uint16_t> indices(numSide + numFront + numBack + 1);
+		m_vertices.resize(m_size.m_numSideVertices + 1);
+
+		_mesh.write(
+			  m_vertices.data()
+			, indices.data()
+			, &indices[numSide]
+			, &indices[numSide + numFront]
+			, m_facing.data()
+			, _type
+			, _textureAsStencil
+			);
+
+		m_vertices.resize(m_size.m_numSideVertices);
+		m_sideIndices.assign(indices.begin(), indices.begin() + numSide);
+		m_frontCap.assign(indices.begin() + numSide, indices.begin() + numSide + numFront);
+		m_backCap.assign(indices.begin() + numSide + numFront, indices.end() - 1);
+	}
+
+	std::vector<uint8_t> m_facing;
+	ShadowVolumeSize m_size;
+	std::vector<ShadowVolumeVertex> m_vertices;
+	std::vector<uint16_t> m_sideIndices;
+	std::vector<uint16_t> m_frontCap;
+	std::vector<uint16_t> m_backCap;
+};
+
+static uint32_t findVertex(const ShadowVolumeTestMesh& _mesh, const ShadowVolumeReference& _ref, const float* _pos)
+{
+	for (uint32_t ii = 0, num = uint32_t(_mesh.m_vertices.size() ); ii < num; ++ii)
+	{
+		if (0 == bx::memCmp(_mesh.m_vertices[ii].m_pos, _pos, 3*sizeof(float) ) )
+		{
+			return _ref.m_weld[ii];
+		}
+	}
+
+	return UINT32_MAX;
+}
+
+static void checkShadowVolume(const ShadowVolumeTestMesh& _testMesh, const float* _light, bool _closed)
+{
+	ShadowVolumeMesh mesh;
+	REQUIRE(_testMesh.init(mesh) );
+	REQUIRE(_testMesh.m_indices.size()/3 == mesh.getNumFaces() );
+
+	const ShadowVolumeReference ref(_testMesh, _light);
+	REQUIRE(!ref.m_ambiguous);
+
+	for (uint32_t type = 0; type < ShadowVolumeType::Count; ++type)
+	{
+		for (uint32_t textureAsStencil = 0; textureAsStencil < 2; ++textureAsStencil)
+		{
+			ShadowVolumeOutput output;
+			output.extract(mesh, _light, ShadowVolumeType::Enum(type), 0 != textureAsStencil);
+
+			const bool single = ShadowVolumeType::FaceBased == type || 0 != textureAsStencil;
+			const uint32_t numCopies = single ? 1 : 2;
+
+			for (uint32_t ii = 0; ii < mesh.getNumFaces(); ++ii)
+			{
+				REQUIRE(ref.m_facing[ii] == (0 != output.m_facing[ii]) );
+			}
+
+			// Caps are faces split by facing, in face order, doubled for edge
+			// based stencil buffer.
+			REQUIRE(numCopies*ref.m_frontCap.size() == output.m_frontCap.size() );
+			REQUIRE(numCopies*ref.m_backCap.size()  == output.m_backCap.size() );
+
+			for (uint32_t ii = 0; ii < output.m_frontCap.size(); ++ii)
+			{
+				REQUIRE(ref.m_frontCap[(ii/(3*numCopies) )*3 + ii%3] == output.m_frontCap[ii]);
+			}
+
+			for (uint32_t ii = 0; ii < output.m_backCap.size(); ++ii)
+			{
+				REQUIRE(ref.m_backCap[(ii/(3*numCopies) )*3 + ii%3] == output.m_backCap[ii]);
+			}
+
+			// Every side is quad, silhouette vertex followed by extruded one.
+			const uint32_t numSides = output.m_size.m_numSideVertices/4;
+			REQUIRE(ref.m_silhouette.size() == numSides);
+			REQUIRE(0 == output.m_size.m_numSideVertices%4);
+
+			std::vector<std::pair<uint32_t, uint32_t> > silhouette;
+			uint32_t numIndices = 0;
+
+			for (uint32_t ii = 0; ii < numSides; ++ii)
+			{
+				const ShadowVolumeVertex* side = &output.m_vertices[ii*4];
+
+				REQUIRE(0.0f == side[0].m_extrude);
+				REQUIRE(1.0f == side[1].m_extrude);
+				REQUIRE(0.0f == side[2].m_extrude);
+				REQUIRE(1.0f == side[3].m_extrude);
+				REQUIRE(0 == bx::memCmp(side[0].m_pos, side[1].m_pos, 3*sizeof(float) ) );
+				REQUIRE(0 == bx::memCmp(side[2].m_pos, side[3].m_pos, 3*sizeof(float) ) );
+
+				const uint32_t i0 = findVertex(_testMesh, ref, side[0].m_pos);
+				const uint32_t i1 = findVertex(_testMesh, ref, side[2].m_pos);
+				REQUIRE(UINT32_MAX != i0);
+				REQUIRE(UINT32_MAX != i1);
+
+				const float k = side[0].m_k;
+				REQUIRE(k == side[3].m_k);
+
+				if (ShadowVolumeType::FaceBased == type)
+				{
+					REQUIRE(1.0f == k);
+				}
+				else
+				{
+					REQUIRE( (2.0f == k || -2.0f == k) );
+				}
+
+				numIndices += single ? 6 : 12;
+
+				// Edge based side keeps winding of first face, and negative
+				// multiplier when that face is not facing the light.
+				silhouette.push_back(k < 0.0f ? std::make_pair(i1, i0) : std::make_pair(i0, i1) );
+			}
+
+			REQUIRE(numIndices == output.m_size.m_numSideIndices);
+
+			std::sort(silhouette.begin(), silhouette.end() );
+			REQUIRE(ref.m_silhouette == silhouette);
+
+			// Edge based sides drawn into stencil texture are all wound the
+			// same way, sign of multiplier is applied in shader.
+			if (!_closed
+			|| (ShadowVolumeType::EdgeBased == type && 0 != textureAsStencil) )
+			{
+				continue;
+			}
+
+			// Depth fail volume of closed mesh must be closed: sides, front
+			// cap, and extruded back cap. Vertex is welded index and extrusion.
+			std::map<std::pair<uint32_t, uint32_t>, int32_t> halfEdges;
+
+			auto addTriangle = [&](const uint32_t* _tri)
+			{
+				for (uint32_t jj = 0; jj < 3; ++jj)
+				{
+					const uint32_t a = _tri[jj];
+					const uint32_t b = _tri[(jj+1)%3];
+
+					if (a < b)
+					{
+						++halfEdges[std::make_pair(a, b)];
+					}
+					else
+					{
+						--halfEdges[std::make_pair(b, a)];
+					}
+				}
+			};
+
+			for (uint32_t ii = 0; ii < output.m_sideIndices.size(); ii += 3)
+			{
+				uint32_t tri[3];
+				for (uint32_t jj = 0; jj < 3; ++jj)
+				{
+					const ShadowVolumeVertex& vertex = output.m_vertices[output.m_sideIndices[ii+jj] ];
+					tri[jj] = findVertex(_testMesh, ref, vertex.m_pos)*2 + uint32_t(vertex.m_extrude);
+				}
+
+				addTriangle(tri);
+			}
+
+			for (uint32_t ii = 0; ii < output.m_frontCap.size(); ii += 3)
+			{
+				const uint32_t tri[3] =
+				{
+					ref.m_weld[output.m_frontCap[ii+0] ]*2,
+					ref.m_weld[output.m_frontCap[ii+1] ]*2,
+					ref.m_weld[output.m_frontCap[ii+2] ]*2,
+				};
+				addTriangle(tri);
+			}
+
+			for (uint32_t ii = 0; ii < output.m_backCap.size(); ii += 3)
+			{
+				const uint32_t tri[3] =
+				{
+					ref.m_weld[output.m_backCap[ii+0] ]*2 + 1,
+					ref.m_weld[output.m_backCap[ii+1] ]*2 + 1,
+					ref.m_weld[output.m_backCap[ii+2] ]*2 + 1,
+				};
+				addTriangle(tri);
+			}
+
+			for (const auto& it : halfEdges)
+			{
+				REQUIRE(0 == it.second);
+			}
+		}
+	}
+}
+
+TEST_CASE("Shadow volume matches reference silhouette and caps.", "[shadowvolume]")
+{
+	static const float s_lights[][3] =
+	{
+		{  5.1f,  3.3f, -4.7f },
+		{ -0.3f, 20.1f,  0.7f },
+		{  0.2f, -3.1f,  0.1f },
+		{ 40.3f,  0.4f, 17.9f },
+	};
+
+	SECTION("Closed sphere with seams.")
+	{
+		ShadowVolumeTestMesh sphere;
+		sphere.sphere(9, 14, 2.0f);
+
+		for (uint32_t ii = 0; ii < BX_COUNTOF(s_lights); ++ii)
+		{
+			checkShadowVolume(sphere, s_lights[ii], true);
+		}
+	}
+
+	SECTION("Open grid.")
+	{
+		ShadowVolumeTestMesh grid;
+		grid.grid(6);
+
+		for (uint32_t ii = 0; ii < BX_COUNTOF(s_lights); ++ii)
+		{
+			checkShadowVolume(grid, s_lights[ii], false);
+		}
+	}
+}
+
+TEST_CASE("Shadow volume extractor matches serial extraction.", "[shadowvolume]")
+{
+	ShadowVolumeTestMesh sphere;
+	sphere.sphere(12, 20, 1.5f);
+
+	ShadowVolumeTestMesh grid;
+	grid.grid(8);
+
+	ShadowVolumeMesh meshes[2];
+	REQUIRE(sphere.init(meshes[0]) );
+	REQUIRE(grid.init(meshes[1]) );
+
+	std::vector<ShadowVolumeJob> jobs;
+
+	for (uint32_t ii = 0; ii < 37; ++ii)
+	{
+		ShadowVolumeJob job = {};
+		job.m_mesh             = &meshes[ii%2];
+		job.m_light[0]         = bx::sin(float(ii)*0.7f)*6.0f;
+		job.m_light[1]         = 3.0f + bx::cos(float(ii)*1.3f);
+		job.m_light[2]         = bx::cos(float(ii)*0.7f)*6.0f;
+		job.m_type             = ShadowVolumeType::Enum(ii%ShadowVolumeType::Count);
+		job.m_cap              = 0 != ii%3;
+		job.m_textureAsStencil = 0 == ii%5;
+		jobs.push_back(job);
+	}
+
+	ShadowVolumeExtractor extractor;
+	REQUIRE(extractor.init(3) );
+
+	for (uint32_t frame = 0; frame < 2; ++frame)
+	{
+		const uint32_t num = uint32_t(jobs.size() ) - frame*11;
+		extractor.calcSize(jobs.data(), num);
+
+		std::vector<ShadowVolumeVertex> vertices;
+		std::vector<uint16_t> indices;
+		std::vector<uint32_t> vertexOffset;
+		std::vector<uint32_t> indexOffset;
+
+		for (uint32_t ii = 0; ii < num; ++ii)
+		{
+			const ShadowVolumeSize& size = jobs[ii].m_size;
+			vertexOffset.push_back(uint32_t(vertices.size() ) );
+			indexOffset.push_back(uint32_t(indices.size() ) );
+			vertices.resize(vertices.size() + size.m_numSideVertices);
+			indices.resize(indices.size() + size.m_numSideIndices + size.m_numFrontCapIndices + size.m_numBackCapIndices);
+		}
+
+		for (uint32_t ii = 0; ii < num; ++ii)
+		{
+			ShadowVolumeJob& job = jobs[ii];
+			const ShadowVolumeSize& size = job.m_size;
+			uint16_t* index = &indices[indexOffset[ii] ];
+
+			job.m_sideVertices    = &vertices[vertexOffset[ii] ];
+			job.m_sideIndices     = index;
+			job.m_frontCapIndices = job.m_cap ? index + size.m_numSideIndices : NULL;
+			job.m_backCapIndices  = job.m_cap ? index + size.m_numSideIndices + size.m_numFrontCapIndices : NULL;
+		}
+
+		extractor.write(jobs.data(), num);
+
+		for (uint32_t ii = 0; ii < num; ++ii)
+		{
+			const ShadowVolumeJob& job = jobs[ii];
+			const ShadowVolumeMesh& mesh = *job.m_mesh;
+
+			std::vector<uint8_t> facing(mesh.getNumFaces() );
+			mesh.classify(facing.data(), job.m_light);
+
+			ShadowVolumeSize size;
+			mesh.calcSize(size, facing.data(), job.m_type, job.m_cap, job.m_textureAsStencil);
+			REQUIRE(0 == bx::memCmp(&size, &job.m_size, sizeof(size) ) );
+
+			const uint32_t numIndices = size.m_numSideIndices + size.m_numFrontCapIndices + size.m_numBackCapIndices;
+			std::vector<ShadowVolumeVertex> expectedVertices(size.m_numSideVertices + 1);
+			std::vector<uint16_t> expectedIndices(numIndices + 1);
+
+			mesh.write(
+				  expectedVertices.data()
+				, expectedIndices.data()
+				, job.m_cap ? &expectedIndices[size.m_numSideIndices] : NULL
+				, job.m_cap ? &expectedIndices[size.m_numSideIndices + size.m_numFrontCapIndices] : NULL
+				, facing.data()
+				, job.m_type
+				, job.m_textureAsStencil
+				);
+
+			REQUIRE(0 == bx::memCmp(expectedVertices.data(), job.m_sideVertices, size.m_numSideVertices*sizeof(ShadowVolumeVertex) ) );
+			REQUIRE(0 == bx::memCmp(expectedIndices.data(), job.m_sideIndices, numIndices*sizeof(uint16_t) ) );
+		}
+	}
+
+	extractor.shutdown();
+}
+
+TEST_CASE("Shadow volume benchmark.", "[shadowvolume][.benchmark]")
+{
+	ShadowVolumeTestMesh sphere;
+	sphere.sphere(64, 128, 1.0f);
+
+	ShadowVolumeMesh mesh;
+	REQUIRE(sphere.init(mesh) );
+
+	std::vector<ShadowVolumeJob> jobs;
+
+	for (uint32_t ii = 0; ii < 64; ++ii)
+	{
+		ShadowVolumeJob job = {};
+		job.m_mesh     = &mesh;
+		job.m_light[0] = bx::sin(float(ii) )*4.0f;
+		job.m_light[1] = 2.0f;
+		job.m_light[2] = bx::cos(float(ii) )*4.0f;
+		job.m_type     = ShadowVolumeType::EdgeBased;
+		job.m_cap      = true;
+		jobs.push_back(job);
+	}
+
+	ShadowVolumeBenchmark result;
+	REQUIRE(shadowVolumeBenchmark(result, jobs.data(), uint32_t(jobs.size() ), 3, 8) );
+	REQUIRE(0 < result.m_numSideVertices);
+
+	WARN("Faces " << mesh.getNumFaces()
+		<< ", jobs " << jobs.size()
+		<< ", serial " << result.m_serialMs << " ms"
+		<< ", 3 worker threads " << result.m_threadedMs << " ms"
+		);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+
+static void submitAlternating(bgfx::ViewId _view, const bgfx::VertexBufferHandle* _vbh, uint32_t _num)
+{
+	// Same program and state, vertex buffer bindings alternate between draws.
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		bgfx::setVertexBuffer(0, _vbh[ii%2]);
+		bgfx::submit(_view, BGFX_INVALID_HANDLE, ii);
+	}
+}
+
+TEST_CASE("ViewMode::Bindings groups draws with identical bindings.", "[sort]")
+{
+	REQUIRE(initNoop() );
+
+	bgfx::VertexLayout layout;
+	layout
+		.begin()
+		.add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
+		.end();
+
+	static const float s_vertices[9] = {};
+
+	const bgfx::VertexBufferHandle vbh[2] =
+	{
+		bgfx::createVertexBuffer(bgfx::makeRef(s_vertices, sizeof(s_vertices) ), layout),
+		bgfx::createVertexBuffer(bgfx::makeRef(s_vertices, sizeof(s_vertices) ), layout),
+	};
+
+	constexpr uint32_t kNumDraws = 8;
+
+	SECTION("Default view mode keeps order, and doesn't report binding changes.")
+	{
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			submitAlternating(0, vbh, kNumDraws);
+			bgfx::frame();
+		}
+
+		const bgfx::Stats* stats = bgfx::getStats();
+		REQUIRE(0 == stats->numBindChanges);
+		REQUIRE(0 == stats->numBindChangesSaved);
+	}
+
+	SECTION("Bindings view mode clusters draws.")
+	{
+		bgfx::setViewMode(0, bgfx::ViewMode::Bindings);
+
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			submitAlternating(0, vbh, kNumDraws);
+			bgfx::frame();
+		}
+
+		// Two clusters are left, one change between them.
+		const bgfx::Stats* stats = bgfx::getStats();
+		REQUIRE(1 == stats->numBindChanges);
+		REQUIRE(kNumDraws-2 == stats->numBindChangesSaved);
+	}
+
+	SECTION("Only views in bindings mode are clustered.")
+	{
+		bgfx::setViewMode(1, bgfx::ViewMode::Bindings);
+
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			submitAlternating(0, vbh, kNumDraws);
+			submitAlternating(1, vbh, kNumDraws);
+			bgfx::frame();
+		}
+
+		const bgfx::Stats* stats = bgfx::getStats();
+		REQUIRE(1 == stats->numBindChanges);
+		REQUIRE(kNumDraws-2 == stats->numBindChangesSaved);
+	}
+
+	bgfx::destroy(vbh[0]);
+	bgfx::destroy(vbh[1]);
+
+	bgfx::shutdown();
+}
@@ -0,0 +1,377 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/string.h>
+#include <bx/timer.h>
+#include <vector>
+
+struct SubmitDrawsScene
+{
+	SubmitDrawsScene()
+	{
+		bgfx::VertexLayout layout;
+		layout
+			.begin()
+			.add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
+			.end();
+
+		static const float    s_vertices[9] = {};
+		static const uint16_t s_indices[3]  = { 0, 1, 2 };
+
+		m_vbh = bgfx::createVertexBuffer(bgfx::makeRef(s_vertices, sizeof(s_vertices) ), layout);
+		m_ibh = bgfx::createIndexBuffer(bgfx::makeRef(s_indices, sizeof(s_indices) ) );
+	}
+
+	~SubmitDrawsScene()
+	{
+		bgfx::destroy(m_ibh);
+		bgfx::destroy(m_vbh);
+	}
+
+	// Every 4th draw is indexed, when _invalid is set descriptor has
+	// nothing to draw.
+	bgfx::DrawDesc draw(uint32_t _ii, uint32_t _depth, bool _invalid) const
+	{
+		bgfx::DrawDesc desc;
+		bx::memSet(&desc, 0, sizeof(desc) );
+		desc.state        = BGFX_STATE_DEFAULT;
+		desc.depth        = _depth;
+		desc.program      = BGFX_INVALID_HANDLE;
+		desc.vertexBuffer = BGFX_INVALID_HANDLE;
+		desc.layout       = BGFX_INVALID_HANDLE;
+		desc.indexBuffer  = BGFX_INVALID_HANDLE;
+		desc.scissor      = UINT16_MAX;
+
+		if (!_invalid)
+		{
+			desc.vertexBuffer = m_vbh;
+			desc.numVertices  = 3;
+
+			if (0 == _ii%4)
+			{
+				desc.indexBuffer = m_ibh;
+				desc.numIndices  = 3;
+			}
+		}
+
+		return desc;
+	}
+
+	bgfx::VertexBufferHandle m_vbh;
+	bgfx::IndexBufferHandle  m_ibh;
+};
+
+// Same draw as descriptor, submitted with per-call API.
+static void submitPerCall(bgfx::ViewId _view, const bgfx::DrawDesc& _desc)
+{
+	bgfx::setState(_desc.state, _desc.rgba);
+
+	if (bgfx::isValid(_desc.vertexBuffer) )
+	{
+		bgfx::setVertexBuffer(0, _desc.vertexBuffer, _desc.startVertex, _desc.numVertices, _desc.layout);
+	}
+	else
+	{
+		bgfx::setVertexCount(_desc.numVertices);
+	}
+
+	if (bgfx::isValid(_desc.indexBuffer) )
+	{
+		bgfx::setIndexBuffer(_desc.indexBuffer, _desc.startIndex, _desc.numIndices);
+	}
+
+	bgfx::submit(_view, _desc.program, _desc.depth);
+}
+
+static void submitBulk(bgfx::ViewId _view, const std::vector<bgfx::DrawDesc>& _draws, uint32_t _batch)
+{
+	for (uint32_t ii = 0, num = uint32_t(_draws.size() ); ii < num; ii += _batch)
+	{
+		bgfx::submit(_view, &_draws[ii], bx::min(_batch, num-ii), NULL, NULL);
+	}
+}
+
+struct SubmitDrawsCounts
+{
+	uint32_t m_numDraw;
+	uint32_t m_numSubmitted;
+	uint32_t m_numDropped;
+};
+
+static SubmitDrawsCounts frameCounts()
+{
+	bgfx::frame();
+
+	const bgfx::Stats* stats = bgfx::getStats();
+	REQUIRE(1 == stats->numEncoders);
+
+	const SubmitDrawsCounts counts =
+	{
+		stats->numDraw,
+		stats->encoderStats[0].numSubmitted,
+		stats->encoderStats[0].numDropped,
+	};
+
+	return counts;
+}
+
+TEST_CASE("Bulk submit matches per-call submit render item and drop counts.", "[submit]")
+{
+	REQUIRE(initNoop() );
+
+	{
+		SubmitDrawsScene scene;
+
+		SECTION("Invalid descriptors are dropped.")
+		{
+			std::vector<bgfx::DrawDesc> draws;
+			for (uint32_t ii = 0; ii < 100; ++ii)
+			{
+				draws.push_back(scene.draw(ii, ii, 0 == ii%7) );
+			}
+
+			for (const bgfx::DrawDesc& desc : draws)
+			{
+				submitPerCall(0, desc);
+			}
+
+			const SubmitDrawsCounts perCall = frameCounts();
+			REQUIRE(85 == perCall.m_numDraw);
+			REQUIRE(85 == perCall.m_numSubmitted);
+			REQUIRE(15 == perCall.m_numDropped);
+
+			for (uint32_t batch : { 1u, 7u, 100u })
+			{
+				submitBulk(0, draws, batch);
+
+				const SubmitDrawsCounts bulk = frameCounts();
+				REQUIRE(perCall.m_numDraw      == bulk.m_numDraw);
+				REQUIRE(perCall.m_numSubmitted == bulk.m_numSubmitted);
+				REQUIRE(perCall.m_numDropped   == bulk.m_numDropped);
+			}
+
+			// Empty bulk submit does nothing.
+			bgfx::submit(0, draws.data(), 0, NULL, NULL);
+
+			const SubmitDrawsCounts empty = frameCounts();
+			REQUIRE(0 == empty.m_numDraw);
+			REQUIRE(0 == empty.m_numSubmitted);
+			REQUIRE(0 == empty.m_numDropped);
+		}
+
+		SECTION("Draws past BGFX_CONFIG_MAX_DRAW_CALLS are dropped.")
+		{
+			const uint32_t maxDrawCalls = bgfx::getCaps()->limits.maxDrawCalls;
+			const uint32_t num          = maxDrawCalls + 100;
+
+			std::vector<bgfx::DrawDesc> draws;
+			uint32_t numInvalid = 0;
+
+			for (uint32_t ii = 0; ii < num; ++ii)
+			{
+				const bool invalid = 0 == ii%1000;
+				draws.push_back(scene.draw(ii, ii, invalid) );
+				numInvalid += invalid;
+			}
+
+			for (const bgfx::DrawDesc& desc : draws)
+			{
+				submitPerCall(0, desc);
+			}
+
+			const SubmitDrawsCounts perCall = frameCounts();
+			REQUIRE(maxDrawCalls     == perCall.m_numDraw);
+			REQUIRE(maxDrawCalls     == perCall.m_numSubmitted);
+			REQUIRE(num-maxDrawCalls == perCall.m_numDropped);
+
+			// Batch that crosses the limit, and batches past the limit.
+			for (uint32_t batch : { 1000u, num })
+			{
+				submitBulk(0, draws, batch);
+
+				const SubmitDrawsCounts bulk = frameCounts();
+				REQUIRE(perCall.m_numDraw      == bulk.m_numDraw);
+				REQUIRE(perCall.m_numSubmitted == bulk.m_numSubmitted);
+				REQUIRE(perCall.m_numDropped   == bulk.m_numDropped);
+			}
+
+			REQUIRE(0 < numInvalid);
+		}
+
+		bgfx::frame();
+	}
+
+	bgfx::shutdown();
+}
+
+static const bgfx::GpuTimerStats* findGpuTimer(const bgfx::Stats* _stats, const char* _name)
+{
+	for (uint32_t ii = 0; ii < _stats->numGpuTimers; ++ii)
+	{
+		if (0 == bx::strCmp(_stats->gpuTimerStats[ii].name, _name) )
+		{
+			return &_stats->gpuTimerStats[ii];
+		}
+	}
+
+	return NULL;
+}
+
+TEST_CASE("Bulk submit matches per-call submit sort order.", "[submit]")
+{
+	REQUIRE(initNoop() );
+
+	{
+		SubmitDrawsScene scene;
+
+		static const bgfx::ViewMode::Enum s_modes[] =
+		{
+			bgfx::ViewMode::Default,
+			bgfx::ViewMode::Sequential,
+			bgfx::ViewMode::DepthAscending,
+			bgfx::ViewMode::DepthDescending,
+		};
+
+		// Noop renderer timestamp is sorted render item position. Each draw is
+		// wrapped in its own scope, per-call draws go to view 0 and bulk draws
+		// to view 1, so relative order within each view must be the same.
+		constexpr uint32_t kNumDraws = 16;
+
+		for (uint32_t mode = 0; mode < BX_COUNTOF(s_modes); ++mode)
+		{
+			bgfx::setViewMode(0, s_modes[mode]);
+			bgfx::setViewMode(1, s_modes[mode]);
+
+			bgfx::DrawDesc draws[kNumDraws];
+			for (uint32_t ii = 0; ii < kNumDraws; ++ii)
+			{
+				// Depth has ties, and invalid draws are in between.
+				draws[ii] = scene.draw(ii, (ii*5)%7, 5 == ii%6);
+			}
+
+			char name[64];
+
+			for (uint32_t ii = 0; ii < kNumDraws; ++ii)
+			{
+				bx::snprintf(name, sizeof(name), "call%d-%d", mode, ii);
+				bgfx::beginGpuTimer(name);
+				submitPerCall(0, draws[ii]);
+				bgfx::endGpuTimer();
+
+				bx::snprintf(name, sizeof(name), "bulk%d-%d", mode, ii);
+				bgfx::beginGpuTimer(name);
+				bgfx::submit(1, &draws[ii], 1, NULL, NULL);
+				bgfx::endGpuTimer();
+			}
+
+			bgfx::frame();
+
+			bx::snprintf(name, sizeof(name), "call%d-%d", mode, 0);
+
+			const bgfx::Stats* stats = bgfx::getStats();
+			for (uint32_t ii = 0; NULL == findGpuTimer(stats, name) && ii < 16; ++ii)
+			{
+				bgfx::frame();
+				stats = bgfx::getStats();
+			}
+
+			int64_t callPos[kNumDraws];
+			int64_t bulkPos[kNumDraws];
+
+			for (uint32_t ii = 0; ii < kNumDraws; ++ii)
+			{
+				bx::snprintf(name, sizeof(name), "call%d-%d", mode, ii);
+				const bgfx::GpuTimerStats* call = findGpuTimer(stats, name);
+
+				bx::snprintf(name, sizeof(name), "bulk%d-%d", mode, ii);
+				const bgfx::GpuTimerStats* bulk = findGpuTimer(stats, name);
+
+				// Dropped draws are not in any view.
+				if (5 == ii%6)
+				{
+					REQUIRE(NULL == call);
+					REQUIRE(NULL == bulk);
+					callPos[ii] = -1;
+					bulkPos[ii] = -1;
+					continue;
+				}
+
+				REQUIRE(NULL != call);
+				REQUIRE(NULL != bulk);
+				REQUIRE(0 == call->view);
+				REQUIRE(1 == bulk->view);
+				REQUIRE(1 == call->gpuTimeEnd - call->gpuTimeBegin);
+				REQUIRE(1 == bulk->gpuTimeEnd - bulk->gpuTimeBegin);
+
+				callPos[ii] = call->gpuTimeBegin;
+				bulkPos[ii] = bulk->gpuTimeBegin;
+			}
+
+			for (uint32_t ii = 0; ii < kNumDraws; ++ii)
+			{
+				for (uint32_t jj = 0; jj < kNumDraws; ++jj)
+				{
+					INFO("mode " << mode << ", draws " << ii << " and " << jj);
+					REQUIRE( (callPos[ii] < callPos[jj]) == (bulkPos[ii] < bulkPos[jj]) );
+				}
+			}
+		}
+
+		bgfx::frame();
+	}
+
+	bgfx::shutdown();
+}
+
+TEST_CASE("Bulk submit benchmark.", "[submit][.benchmark]")
+{
+	REQUIRE(initNoop() );
+
+	{
+		SubmitDrawsScene scene;
+
+		constexpr uint32_t kNumDraws  = 50000;
+		constexpr uint32_t kNumFrames = 10;
+		constexpr uint32_t kBatch     = 256;
+
+		std::vector<bgfx::DrawDesc> draws;
+		for (uint32_t ii = 0; ii < kNumDraws; ++ii)
+		{
+			draws.push_back(scene.draw(ii, ii, false) );
+		}
+
+		int64_t perCall = 0;
+		int64_t bulk    = 0;
+
+		for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+		{
+			int64_t start = bx::getHPCounter();
+
+			for (const bgfx::DrawDesc& desc : draws)
+			{
+				submitPerCall(0, desc);
+			}
+
+			perCall += bx::getHPCounter() - start;
+			bgfx::frame();
+
+			start = bx::getHPCounter();
+			submitBulk(0, draws, kBatch);
+			bulk += bx::getHPCounter() - start;
+
+			REQUIRE(kNumDraws == frameCounts().m_numSubmitted);
+		}
+
+		const double toNs = 1.0e9/double(bx::getHPFrequency() )/double(kNumDraws*kNumFrames);
+
+		WARN("Per-call submit: " << double(perCall)*toNs << " ns/draw"
+			<< ", bulk submit (" << kBatch << " per call): " << double(bulk)*toNs << " ns/draw"
+			<< ", speedup " << double(perCall)/double(bulk)
+			);
+	}
+
+	bgfx::shutdown();
+}
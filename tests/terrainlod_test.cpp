@@ -0,0 +1,383 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/math.h>
+#include <bx/rng.h>
+#include <map>
+#include <vector>
+
+#include "terrainlod/terrainlod.h"
+
+static constexpr uint16_t kTerrainSize = 257;
+
+struct TerrainLodScene
+{
+	TerrainLodScene()
+		: m_heightMap(kTerrainSize*kTerrainSize)
+	{
+		for (uint32_t yy = 0; yy < kTerrainSize; ++yy)
+		{
+			for (uint32_t xx = 0; xx < kTerrainSize; ++xx)
+			{
+				m_heightMap[yy*kTerrainSize + xx] = uint8_t(20.0f + 10.0f*bx::sin(float(xx)*0.1f)*bx::cos(float(yy)*0.07f) );
+			}
+		}
+	}
+
+	void camera(const bx::Vec3& _eye, const bx::Vec3& _at, float _fovy, float _aspect)
+	{
+		float view[16];
+		bx::mtxLookAt(view, _eye, _at);
+
+		float proj[16];
+		bx::mtxProj(proj, _fovy, _aspect, 0.1f, 2000.0f, false);
+
+		bx::mtxMul(m_viewProj, view, proj);
+	}
+
+	std::vector<uint8_t> m_heightMap;
+	float m_viewProj[16];
+};
+
+struct TerrainLodMeshCheck
+{
+	uint32_t m_numEdges;     //!< Edges shared by more than two triangles, or open inside of terrain.
+	uint32_t m_numFlipped;   //!< Triangles with flipped winding.
+	double   m_area;         //!< Area covered by non-degenerate triangles, in quads.
+};
+
+// Builds triangles of all selected patches, and checks that every edge is
+// shared by at most two triangles, and that winding is consistent. When
+// whole terrain is selected, only terrain border edges can be open.
+static TerrainLodMeshCheck checkMesh(const TerrainLod& _lod, bool _full)
+{
+	TerrainLodMeshCheck result = { 0, 0, 0.0 };
+
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t> edges;
+	std::vector<uint32_t> indices;
+
+	for (uint32_t ii = 0; ii < _lod.getNumPatches(); ++ii)
+	{
+		const TerrainPatch& patch = _lod.getPatch(ii);
+
+		indices.resize(_lod.getNumIndices(patch) );
+		REQUIRE(indices.size() == _lod.writeIndices(indices.data(), patch) );
+
+		for (uint32_t tri = 0; tri < indices.size(); tri += 3)
+		{
+			const uint32_t vv[3] = { indices[tri], indices[tri+1], indices[tri+2] };
+
+			if (vv[0] == vv[1]
+			||  vv[1] == vv[2]
+			||  vv[0] == vv[2])
+			{
+				continue;
+			}
+
+			const double x0 = vv[0]%kTerrainSize, y0 = vv[0]/kTerrainSize;
+			const double x1 = vv[1]%kTerrainSize, y1 = vv[1]/kTerrainSize;
+			const double x2 = vv[2]%kTerrainSize, y2 = vv[2]/kTerrainSize;
+			const double area = ( (x1-x0)*(y2-y0) - (y1-y0)*(x2-x0) )*0.5;
+
+			if (0.0 == area)
+			{
+				continue;
+			}
+
+			result.m_numFlipped += 0.0 > area;
+			result.m_area       += bx::abs(area);
+
+			for (uint32_t edge = 0; edge < 3; ++edge)
+			{
+				const uint32_t v0 = vv[edge];
+				const uint32_t v1 = vv[(edge+1)%3];
+				edges[std::make_pair(bx::min(v0, v1), bx::max(v0, v1) )]++;
+			}
+		}
+	}
+
+	for (const auto& it : edges)
+	{
+		if (2 < it.second)
+		{
+			++result.m_numEdges;
+		}
+		else if (1 == it.second
+		&&       _full)
+		{
+			const uint32_t v0 = it.first.first;
+			const uint32_t v1 = it.first.second;
+			const uint32_t x0 = v0%kTerrainSize, y0 = v0/kTerrainSize;
+			const uint32_t x1 = v1%kTerrainSize, y1 = v1/kTerrainSize;
+
+			const bool border = false
+				|| (x0 == x1 && (0 == x0 || kTerrainSize-1 == x0) )
+				|| (y0 == y1 && (0 == y0 || kTerrainSize-1 == y0) )
+				;
+			result.m_numEdges += !border;
+		}
+	}
+
+	return result;
+}
+
+static void requireFull(const TerrainLod& _lod)
+{
+	const TerrainLodMeshCheck check = checkMesh(_lod, true);
+	REQUIRE(0 == check.m_numEdges);
+	REQUIRE(0 == check.m_numFlipped);
+	REQUIRE(double( (kTerrainSize-1)*(kTerrainSize-1) ) == check.m_area);
+}
+
+TEST_CASE("TerrainLod init validation.", "[terrainlod]")
+{
+	TerrainLodScene scene;
+
+	TerrainLod lod;
+	REQUIRE(!lod.init(256, 16, 1.0f, scene.m_heightMap.data() ) );
+	REQUIRE(!lod.init(kTerrainSize, 0,   1.0f, scene.m_heightMap.data() ) );
+	REQUIRE(!lod.init(kTerrainSize, 1,   1.0f, scene.m_heightMap.data() ) );
+	REQUIRE(!lod.init(kTerrainSize, 12,  1.0f, scene.m_heightMap.data() ) );
+	REQUIRE(!lod.init(kTerrainSize, 512, 1.0f, scene.m_heightMap.data() ) );
+
+	REQUIRE(lod.init(kTerrainSize, 2, 1.0f, scene.m_heightMap.data() ) );
+	REQUIRE(8 == lod.getNumLods() );
+	lod.shutdown();
+
+	REQUIRE(lod.init(kTerrainSize, 16, 1.0f, scene.m_heightMap.data() ) );
+	REQUIRE(5 == lod.getNumLods() );
+	lod.shutdown();
+}
+
+TEST_CASE("TerrainLod selected patches cover terrain without cracks.", "[terrainlod]")
+{
+	TerrainLodScene scene;
+
+	TerrainLod lod;
+	REQUIRE(lod.init(kTerrainSize, 16, 1.0f, scene.m_heightMap.data() ) );
+
+	// Top-down camera high up sees whole terrain.
+	scene.camera({ 128.0f, 600.0f, 128.5f }, { 128.0f, 0.0f, 128.0f }, 90.0f, 1.0f);
+
+	SECTION("Eye in the middle.")
+	{
+		const float eye[3] = { 128.0f, 600.0f, 128.5f };
+
+		for (float range : { 8.0f, 16.0f, 32.0f, 64.0f, 1000.0f })
+		{
+			REQUIRE(0 < lod.select(scene.m_viewProj, eye, range) );
+			requireFull(lod);
+		}
+
+		// Range covers everything, all patches are at the finest LOD.
+		for (uint32_t ii = 0; ii < lod.getNumPatches(); ++ii)
+		{
+			REQUIRE(0 == lod.getPatch(ii).m_lod);
+		}
+	}
+
+	SECTION("Eye in the corner, strong LOD gradient.")
+	{
+		const float eye[3] = { 5.0f, 30.0f, 5.0f };
+
+		for (float range : { 8.0f, 16.0f, 32.0f })
+		{
+			lod.select(scene.m_viewProj, eye, range);
+			requireFull(lod);
+
+			bool coarse = false;
+			for (uint32_t ii = 0; ii < lod.getNumPatches(); ++ii)
+			{
+				coarse |= 0 < lod.getPatch(ii).m_lod;
+			}
+
+			REQUIRE(coarse);
+		}
+	}
+
+	SECTION("Random eye positions.")
+	{
+		bx::RngMwc rng;
+
+		for (uint32_t ii = 0; ii < 200; ++ii)
+		{
+			const float eye[3] =
+			{
+				float(rng.gen()%kTerrainSize),
+				float(rng.gen()%60),
+				float(rng.gen()%kTerrainSize),
+			};
+
+			lod.select(scene.m_viewProj, eye, float(4 + rng.gen()%40) );
+			requireFull(lod);
+		}
+	}
+
+	lod.shutdown();
+}
+
+TEST_CASE("TerrainLod culls patches outside of view.", "[terrainlod]")
+{
+	TerrainLodScene scene;
+
+	TerrainLod lod;
+	REQUIRE(lod.init(kTerrainSize, 16, 1.0f, scene.m_heightMap.data() ) );
+
+	// Camera inside of terrain looking along +x, everything behind it is
+	// culled.
+	const float eye[3] = { 140.0f, 30.0f, 128.0f };
+
+	scene.camera({ 140.0f, 30.0f, 128.0f }, { 256.0f, 20.0f, 128.0f }, 60.0f, 1.6f);
+
+	for (float range : { 8.0f, 32.0f })
+	{
+		lod.select(scene.m_viewProj, eye, range);
+
+		// Only part of terrain is visible, patches are still stitched.
+		const TerrainLodMeshCheck check = checkMesh(lod, false);
+		REQUIRE(0 == check.m_numEdges);
+		REQUIRE(0 == check.m_numFlipped);
+		REQUIRE(0.0 < check.m_area);
+		REQUIRE(double( (kTerrainSize-1)*(kTerrainSize-1) ) > check.m_area);
+	}
+
+	// Looking away from terrain.
+	scene.camera({ 128.0f, 40.0f, -10.0f }, { 128.0f, 40.0f, -100.0f }, 60.0f, 1.6f);
+	REQUIRE(0 == lod.select(scene.m_viewProj, eye, 32.0f) );
+
+	lod.shutdown();
+}
+
+TEST_CASE("TerrainLod height update matches rebuilt quadtree.", "[terrainlod]")
+{
+	TerrainLodScene scene;
+
+	TerrainLod lod;
+	REQUIRE(lod.init(kTerrainSize, 16, 1.0f, scene.m_heightMap.data() ) );
+
+	for (uint32_t yy = 100; yy < 120; ++yy)
+	{
+		for (uint32_t xx = 100; xx < 120; ++xx)
+		{
+			scene.m_heightMap[yy*kTerrainSize + xx] = 250;
+		}
+	}
+
+	const TerrainRect rect = { 100, 100, 20, 20 };
+	lod.updateHeights(scene.m_heightMap.data(), rect);
+
+	TerrainLod ref;
+	REQUIRE(ref.init(kTerrainSize, 16, 1.0f, scene.m_heightMap.data() ) );
+
+	const float eye[3] = { 128.0f, 300.0f, -50.0f };
+	scene.camera({ 128.0f, 300.0f, -50.0f }, { 128.0f, 0.0f, 128.0f }, 60.0f, 1.6f);
+
+	REQUIRE(ref.select(scene.m_viewProj, eye, 16.0f) == lod.select(scene.m_viewProj, eye, 16.0f) );
+
+	for (uint32_t ii = 0; ii < lod.getNumPatches(); ++ii)
+	{
+		const TerrainPatch& patch = lod.getPatch(ii);
+		const TerrainPatch& expected = ref.getPatch(ii);
+		REQUIRE(expected.m_x    == patch.m_x);
+		REQUIRE(expected.m_y    == patch.m_y);
+		REQUIRE(expected.m_size == patch.m_size);
+		REQUIRE(expected.m_lod  == patch.m_lod);
+	}
+
+	ref.shutdown();
+	lod.shutdown();
+}
+
+TEST_CASE("TerrainDirtyRects merging.", "[terrainlod]")
+{
+	TerrainDirtyRects dirty;
+	REQUIRE(0 == dirty.getNum() );
+
+	SECTION("Overlapping and touching rectangles are merged.")
+	{
+		dirty.add(0, 0, 10, 10);
+		dirty.add(5, 5, 10, 10);
+		REQUIRE(1 == dirty.getNum() );
+
+		// Empty rectangle is ignored.
+		dirty.add(100, 100, 0, 5);
+		REQUIRE(1 == dirty.getNum() );
+
+		// Touches right edge.
+		dirty.add(15, 0, 5, 5);
+		REQUIRE(1 == dirty.getNum() );
+
+		const TerrainRect& rect = dirty.get(0);
+		REQUIRE(0  == rect.m_x);
+		REQUIRE(0  == rect.m_y);
+		REQUIRE(20 == rect.m_width);
+		REQUIRE(15 == rect.m_height);
+	}
+
+	SECTION("Disjoint rectangles are kept apart.")
+	{
+		dirty.add(0,  0,  4, 4);
+		dirty.add(10, 10, 4, 4);
+		dirty.add(20, 0,  4, 4);
+		REQUIRE(3 == dirty.getNum() );
+
+		// Bridges first two.
+		dirty.add(4, 4, 6, 6);
+		REQUIRE(2 == dirty.getNum() );
+	}
+
+	SECTION("Number of rectangles is bounded, and they cover all modified samples.")
+	{
+		std::vector<TerrainRect> added;
+
+		for (uint32_t ii = 0; ii < 40; ++ii)
+		{
+			const TerrainRect rect = { uint16_t(ii*6), uint16_t( (ii*37)%250), 3, 3 };
+			dirty.add(rect.m_x, rect.m_y, rect.m_width, rect.m_height);
+			added.push_back(rect);
+
+			REQUIRE(TerrainDirtyRects::kMaxRects >= dirty.getNum() );
+		}
+
+		for (const TerrainRect& rect : added)
+		{
+			bool covered = false;
+
+			for (uint8_t ii = 0; ii < dirty.getNum() && !covered; ++ii)
+			{
+				const TerrainRect& dr = dirty.get(ii);
+				covered = true
+					&& dr.m_x <= rect.m_x
+					&& dr.m_y <= rect.m_y
+					&& dr.m_x + dr.m_width  >= rect.m_x + rect.m_width
+					&& dr.m_y + dr.m_height >= rect.m_y + rect.m_height
+					;
+			}
+
+			REQUIRE(covered);
+		}
+
+		// Rectangles don't overlap.
+		for (uint8_t ii = 0; ii < dirty.getNum(); ++ii)
+		{
+			for (uint8_t jj = ii + 1; jj < dirty.getNum(); ++jj)
+			{
+				const TerrainRect& aa = dirty.get(ii);
+				const TerrainRect& bb = dirty.get(jj);
+				const bool overlap = true
+					&& aa.m_x < bb.m_x + bb.m_width
+					&& bb.m_x < aa.m_x + aa.m_width
+					&& aa.m_y < bb.m_y + bb.m_height
+					&& bb.m_y < aa.m_y + aa.m_height
+					;
+				REQUIRE(!overlap);
+			}
+		}
+
+		dirty.reset();
+		REQUIRE(0 == dirty.getNum() );
+	}
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef BGFX_TEST_H_HEADER_GUARD
+#define BGFX_TEST_H_HEADER_GUARD
+
+#include <bx/bx.h>
+
+BX_PRAGMA_DIAGNOSTIC_PUSH();
+BX_PRAGMA_DIAGNOSTIC_IGNORED_MSVC(4312); // warning C4312 : 'reinterpret_cast' : conversion from 'int' to 'const char *' of greater size
+#include <catch/catch_amalgamated.hpp>
+BX_PRAGMA_DIAGNOSTIC_POP();
+
+#include <bgfx/bgfx.h>
+
+/// Callback used by headless tests. It counts screen shot and capture
+/// callbacks, everything else is ignored.
+struct TestCallback : public bgfx::CallbackI
+{
+	TestCallback()
+		: m_numScreenShots(0)
+		, m_numCaptureBegin(0)
+		, m_numCaptureEnd(0)
+		, m_numCaptureFrames(0)
+		, m_width(0)
+		, m_height(0)
+		, m_pitch(0)
+		, m_size(0)
+		, m_black(true)
+	{
+	}
+
+	virtual ~TestCallback()
+	{
+	}
+
+	virtual void fatal(const char* _filePath, uint16_t _line, bgfx::Fatal::Enum _code, const char* _str) override
+	{
+		BX_UNUSED(_filePath, _line, _code, _str);
+		FAIL(_str);
+	}
+
+	virtual void traceVargs(const char* _filePath, uint16_t _line, const char* _format, va_list _argList) override
+	{
+		BX_UNUSED(_filePath, _line, _format, _argList);
+	}
+
+	virtual void profilerBegin(const char* _name, uint32_t _abgr, const char* _filePath, uint16_t _line) override
+	{
+		BX_UNUSED(_name, _abgr, _filePath, _line);
+	}
+
+	virtual void profilerBeginLiteral(const char* _name, uint32_t _abgr, const char* _filePath, uint16_t _line) override
+	{
+		BX_UNUSED(_name, _abgr, _filePath, _line);
+	}
+
+	virtual void profilerEnd() override
+	{
+	}
+
+	virtual uint32_t cacheReadSize(uint64_t _id) override
+	{
+		BX_UNUSED(_id);
+		return 0;
+	}
+
+	virtual bool cacheRead(uint64_t _id, void* _data, uint32_t _size) override
+	{
+		BX_UNUSED(_id, _data, _size);
+		return false;
+	}
+
+	virtual void cacheWrite(uint64_t _id, const void* _data, uint32_t _size) override
+	{
+		BX_UNUSED(_id, _data, _size);
+	}
+
+	virtual void screenShot(const char* _filePath, uint32_t _width, uint32_t _height, uint32_t _pitch, const void* _data, uint32_t _size, bool _yflip) override
+	{
+		BX_UNUSED(_filePath, _yflip);
+		++m_numScreenShots;
+		m_width  = _width;
+		m_height = _height;
+		m_pitch  = _pitch;
+		m_size   = _size;
+		checkBlack(_data, _size);
+	}
+
+	virtual void captureBegin(uint32_t _width, uint32_t _height, uint32_t _pitch, bgfx::TextureFormat::Enum _format, bool _yflip) override
+	{
+		BX_UNUSED(_format, _yflip);
+		++m_numCaptureBegin;
+		m_width  = _width;
+		m_height = _height;
+		m_pitch  = _pitch;
+	}
+
+	virtual void captureEnd() override
+	{
+		++m_numCaptureEnd;
+	}
+
+	virtual void captureFrame(const void* _data, uint32_t _size) override
+	{
+		++m_numCaptureFrames;
+		m_size = _size;
+		checkBlack(_data, _size);
+	}
+
+	void checkBlack(const void* _data, uint32_t _size)
+	{
+		const uint8_t* data = (const uint8_t*)_data;
+		for (uint32_t ii = 0; ii < _size; ++ii)
+		{
+			m_black &= 0 == data[ii];
+		}
+	}
+
+	uint32_t m_numScreenShots;
+	uint32_t m_numCaptureBegin;
+	uint32_t m_numCaptureEnd;
+	uint32_t m_numCaptureFrames;
+	uint32_t m_width;
+	uint32_t m_height;
+	uint32_t m_pitch;
+	uint32_t m_size;
+	bool     m_black;
+};
+
+/// Initializes bgfx with noop renderer in single threaded mode, callbacks
+/// are called from `bgfx::frame`.
+inline bool initNoop(bgfx::CallbackI* _callback = NULL, uint32_t _reset = BGFX_RESET_NONE)
+{
+	bgfx::renderFrame();
+
+	bgfx::Init init;
+	init.type     = bgfx::RendererType::Noop;
+	init.callback = _callback;
+	init.resolution.width  = 64;
+	init.resolution.height = 32;
+	init.resolution.reset  = _reset;
+	return bgfx::init(init);
+}
+
+#endif // BGFX_TEST_H_HEADER_GUARD
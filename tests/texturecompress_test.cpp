@@ -0,0 +1,141 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+#include <bx/math.h>
+#include <bimg/bimg.h>
+#include <vector>
+
+#include "texturecompress/texturecompress.h"
+
+// Smooth gradients with low frequency detail, similar to what is generated
+// at runtime (lightmaps, terrain splat maps, ...).
+static void generateImage(std::vector<uint8_t>& _rgba8, uint32_t _width, uint32_t _height)
+{
+	_rgba8.resize(_width*_height*4);
+
+	for (uint32_t yy = 0; yy < _height; ++yy)
+	{
+		for (uint32_t xx = 0; xx < _width; ++xx)
+		{
+			const float uu = float(xx)/float(_width);
+			const float vv = float(yy)/float(_height);
+			const float detail = bx::sin(uu*bx::kPi2*3.0f)*bx::cos(vv*bx::kPi2*2.0f)*0.5f + 0.5f;
+
+			uint8_t* dst = &_rgba8[(yy*_width + xx)*4];
+			dst[0] = uint8_t(uu*255.0f);
+			dst[1] = uint8_t(vv*255.0f);
+			dst[2] = uint8_t(detail*255.0f);
+			dst[3] = 255;
+		}
+	}
+}
+
+static const struct
+{
+	bgfx::TextureFormat::Enum format;
+	float minPsnr;
+}
+s_formats[] =
+{
+	{ bgfx::TextureFormat::BC1,     30.0f },
+	{ bgfx::TextureFormat::BC3,     30.0f },
+	{ bgfx::TextureFormat::BC7,     30.0f },
+	{ bgfx::TextureFormat::ETC2,    30.0f },
+	{ bgfx::TextureFormat::ASTC4x4, 30.0f },
+};
+
+TEST_CASE("Texture compress PSNR.", "[texturecompress]")
+{
+	std::vector<uint8_t> ref;
+	generateImage(ref, 16, 16);
+
+	std::vector<uint8_t> test = ref;
+	REQUIRE(bx::kFloatInfinity == textureCompressPsnr(ref.data(), test.data(), 16, 16, 16*4) );
+
+	// Single channel of single pixel off by 1, MSE is 1/(16*16*4).
+	test[5] ^= 1;
+	const float psnr = textureCompressPsnr(ref.data(), test.data(), 16, 16, 16*4);
+	REQUIRE(bx::abs(psnr - 78.23f) < 0.01f);
+
+	// Pitch is respected, data past row width is ignored.
+	std::vector<uint8_t> padded(32*16*4, 0xaa);
+	for (uint32_t yy = 0; yy < 16; ++yy)
+	{
+		bx::memCopy(&padded[yy*32*4], &ref[yy*16*4], 16*4);
+	}
+
+	std::vector<uint8_t> paddedTest(32*16*4, 0x55);
+	for (uint32_t yy = 0; yy < 16; ++yy)
+	{
+		bx::memCopy(&paddedTest[yy*32*4], &ref[yy*16*4], 16*4);
+	}
+
+	REQUIRE(bx::kFloatInfinity == textureCompressPsnr(padded.data(), paddedTest.data(), 16, 16, 32*4) );
+}
+
+TEST_CASE("Texture compress round trip quality.", "[texturecompress]")
+{
+	const uint32_t width  = 64;
+	const uint32_t height = 64;
+
+	std::vector<uint8_t> rgba8;
+	generateImage(rgba8, width, height);
+
+	for (uint32_t ii = 0; ii < BX_COUNTOF(s_formats); ++ii)
+	{
+		const bgfx::TextureFormat::Enum format = s_formats[ii].format;
+
+		TextureCompressBenchmark result;
+		REQUIRE(textureCompressBenchmark(result, format, TextureCompressQuality::Fastest, rgba8.data(), width, height) );
+
+		INFO(bimg::getName(bimg::TextureFormat::Enum(format) ) );
+		REQUIRE(s_formats[ii].minPsnr < result.m_psnr);
+		REQUIRE(0.0 < result.m_mpixPerSec);
+	}
+
+	TextureCompressBenchmark result;
+
+	// Not block aligned.
+	REQUIRE(!textureCompressBenchmark(result, bgfx::TextureFormat::BC1, TextureCompressQuality::Fastest, rgba8.data(), 6, 8) );
+	REQUIRE(0.0f == result.m_psnr);
+
+	// Not compressed format.
+	REQUIRE(!textureCompressBenchmark(result, bgfx::TextureFormat::RGBA8, TextureCompressQuality::Fastest, rgba8.data(), width, height) );
+}
+
+TEST_CASE("Texture compress benchmark.", "[texturecompress][.benchmark]")
+{
+	const uint32_t width  = 256;
+	const uint32_t height = 256;
+
+	std::vector<uint8_t> rgba8;
+	generateImage(rgba8, width, height);
+
+	static const char* s_qualityName[] = { "fastest", "default", "highest" };
+	BX_STATIC_ASSERT(TextureCompressQuality::Count == BX_COUNTOF(s_qualityName) );
+
+	for (uint32_t ii = 0; ii < BX_COUNTOF(s_formats); ++ii)
+	{
+		for (uint32_t quality = 0; quality < TextureCompressQuality::Count; ++quality)
+		{
+			TextureCompressBenchmark result;
+			REQUIRE(textureCompressBenchmark(result
+				, s_formats[ii].format
+				, TextureCompressQuality::Enum(quality)
+				, rgba8.data()
+				, width
+				, height
+				, 4
+				) );
+
+			WARN(bimg::getName(bimg::TextureFormat::Enum(s_formats[ii].format) )
+				<< " " << s_qualityName[quality]
+				<< ": PSNR " << result.m_psnr << " dB"
+				<< ", " << result.m_mpixPerSec << " Mpix/s"
+				);
+		}
+	}
+}
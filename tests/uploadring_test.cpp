@@ -0,0 +1,141 @@
+/*
+ * Copyright 2011-2024 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include "test.h"
+
+#include "../src/uploadring.h"
+
+TEST_CASE("UploadRing placement and slot rotation.", "[uploadring]")
+{
+	constexpr uint32_t kInvalid = bgfx::UploadRing::kInvalidOffset;
+
+	bgfx::UploadRing ring;
+	ring.reset(256, 3);
+
+	bool next;
+
+	// Allocations are aligned.
+	REQUIRE(0  == ring.alloc(10, next) );
+	REQUIRE(!next);
+	REQUIRE(16 == ring.alloc(100, next) );
+	REQUIRE(!next);
+	REQUIRE(128 == ring.alloc(128, next) );
+	REQUIRE(!next);
+	REQUIRE(0   == ring.getCurrent() );
+	REQUIRE(256 == ring.getOffset() );
+
+	// Doesn't fit into what's left of slot, moves to next slot.
+	REQUIRE(0 == ring.alloc(1, next) );
+	REQUIRE(next);
+	REQUIRE(1 == ring.getCurrent() );
+	REQUIRE(0 == ring.getRetired() );
+
+	// Fills slot to the end after alignment.
+	REQUIRE(16 == ring.alloc(240, next) );
+	REQUIRE(!next);
+	REQUIRE(1 == ring.getCurrent() );
+
+	// Larger than slot, ring stays in place.
+	REQUIRE(kInvalid == ring.alloc(257, next) );
+	REQUIRE(!next);
+	REQUIRE(1   == ring.getCurrent() );
+	REQUIRE(256 == ring.getOffset() );
+
+	// Whole slot.
+	REQUIRE(0 == ring.alloc(256, next) );
+	REQUIRE(next);
+	REQUIRE(2 == ring.getCurrent() );
+	REQUIRE(1 == ring.getRetired() );
+
+	// Wraps around.
+	REQUIRE(ring.frame() );
+	REQUIRE(0 == ring.getCurrent() );
+	REQUIRE(2 == ring.getRetired() );
+	REQUIRE(0 == ring.getOffset() );
+
+	// Nothing was staged in current slot, frame doesn't retire it.
+	REQUIRE(!ring.frame() );
+	REQUIRE(0 == ring.getCurrent() );
+
+	// Zero sized ring stages nothing.
+	ring.reset(0, 3);
+	REQUIRE(kInvalid == ring.alloc(1, next) );
+	REQUIRE(!next);
+}
+
+TEST_CASE("UploadRing single slot ring retires slot it moves to.", "[uploadring]")
+{
+	bgfx::UploadRing ring;
+	ring.reset(64, 1);
+
+	bool next;
+	REQUIRE(0 == ring.alloc(48, next) );
+	REQUIRE(!next);
+	REQUIRE(0 == ring.alloc(32, next) );
+	REQUIRE(next);
+	REQUIRE(0 == ring.getCurrent() );
+	REQUIRE(0 == ring.getRetired() );
+}
+
+TEST_CASE("UploadRing staged and direct upload stats.", "[uploadring]")
+{
+	bgfx::UploadRing ring;
+	ring.reset(256, 2);
+
+	int64_t staged = -1;
+	int64_t direct = -1;
+	ring.getStats(staged, direct);
+	REQUIRE(0 == staged);
+	REQUIRE(0 == direct);
+
+	bool next;
+	ring.alloc(100, next);
+	ring.alloc(200, next);
+	ring.alloc(300, next);
+	ring.direct(7);
+
+	// Alignment padding and slot rotation are not counted.
+	ring.getStats(staged, direct);
+	REQUIRE(300 == staged);
+	REQUIRE(307 == direct);
+
+	// Counters are reset after they are read.
+	ring.getStats(staged, direct);
+	REQUIRE(0 == staged);
+	REQUIRE(0 == direct);
+
+	// Ring without slots counts everything as direct.
+	bgfx::UploadRing none;
+	none.direct(64);
+	none.getStats(staged, direct);
+	REQUIRE(0  == staged);
+	REQUIRE(64 == direct);
+}
+
+TEST_CASE("Noop texture upload stats.", "[uploadring]")
+{
+	REQUIRE(initNoop() );
+
+	bgfx::TextureHandle texture = bgfx::createTexture2D(16, 16, false, 1, bgfx::TextureFormat::RGBA8);
+	REQUIRE(bgfx::isValid(texture) );
+
+	const bgfx::Memory* mem = bgfx::alloc(16*16*4);
+	bx::memSet(mem->data, 0, mem->size);
+	bgfx::updateTexture2D(texture, 0, 0, 0, 0, 16, 16, mem);
+
+	bgfx::frame();
+	bgfx::frame();
+
+	// Noop renderer doesn't upload, stats are reported and reset every
+	// frame.
+	const bgfx::Stats* stats = bgfx::getStats();
+	REQUIRE(0 == stats->textureUploadStaged);
+	REQUIRE(0 == stats->textureUploadDirect);
+
+	bgfx::destroy(texture);
+	bgfx::frame();
+
+	bgfx::shutdown();
+}